@@ -791,7 +791,7 @@ qt_feature_definition("rdseed" "QT_COMPILER_SUPPORTS_RDSEED" VALUE "1")
 qt_feature_config("rdseed" QMAKE_PRIVATE_CONFIG)
 qt_feature("shani"
     LABEL "SHA"
-    CONDITION QT_FEATURE_sse2 AND TEST_subarch_sha
+    CONDITION QT_FEATURE_sse2 AND TEST_subarch_shani
 )
 qt_feature_definition("shani" "QT_COMPILER_SUPPORTS_SHA" VALUE "1")
 qt_feature_config("shani" QMAKE_PRIVATE_CONFIG)
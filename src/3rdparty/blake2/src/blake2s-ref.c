@@ -169,7 +169,13 @@ int blake2s_init_key( blake2s_state *S, size_t outlen, const void *key, size_t k
     G(r,7,v[ 3],v[ 4],v[ 9],v[14]); \
   } while(0)
 
+#ifdef BLAKE2_QT_COMPRESS
+/* Qt: the includer defines blake2s_compress, which may fall back to this one */
+static void blake2s_compress( blake2s_state *S, const uint8_t in[BLAKE2S_BLOCKBYTES] );
+static void blake2s_compress_ref( blake2s_state *S, const uint8_t in[BLAKE2S_BLOCKBYTES] )
+#else
 static void blake2s_compress( blake2s_state *S, const uint8_t in[BLAKE2S_BLOCKBYTES] )
+#endif
 {
   uint32_t m[16];
   uint32_t v[16];
@@ -190,6 +190,24 @@ static inline void sha1ProcessChunk(Sha1State *state, const unsigned char *buffe
 #endif
 }
 
+static inline void sha1ProcessChunks(Sha1State *state, const unsigned char *buffer, qint64 count)
+{
+#ifndef QT_BOOTSTRAPPED
+    // use the CPU's SHA instructions, if it has them
+    quint32 h[5] = { state->h0, state->h1, state->h2, state->h3, state->h4 };
+    if (qt_sha1ProcessBlocks(h, buffer, count)) {
+        state->h0 = h[0];
+        state->h1 = h[1];
+        state->h2 = h[2];
+        state->h3 = h[3];
+        state->h4 = h[4];
+        return;
+    }
+#endif
+    for ( ; count; --count, buffer += 64)
+        sha1ProcessChunk(state, buffer);
+}
+
 static inline void sha1InitState(Sha1State *state)
 {
     state->h0 = 0x67452301;
@@ -214,11 +232,11 @@ static inline void sha1Update(Sha1State *state, const unsigned char *data, qint6
     } else {
         qint64 i = static_cast<qint64>(64 - rest);
         memcpy(&state->buffer[rest], &data[0], static_cast<qint32>(i));
-        sha1ProcessChunk(state, state->buffer);
+        sha1ProcessChunks(state, state->buffer, 1);
 
         qint64 lastI = len - ((len + rest) & Q_INT64_C(63));
-        for( ; i < lastI; i += 64)
-            sha1ProcessChunk(state, &data[i]);
+        sha1ProcessChunks(state, &data[i], (lastI - i) / 64);
+        i = lastI;
 
         memcpy(&state->buffer[0], &data[i], len - i);
     }
@@ -119,6 +119,27 @@ int pipes[2];
 }
 ")
 
+# copy_file_range
+qt_config_compile_test(copy_file_range
+    LABEL "copy_file_range()"
+    CODE
+"#define _GNU_SOURCE 1
+#include <sys/types.h>
+#include <unistd.h>
+
+int main(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    /* BEGIN TEST: */
+loff_t in = 0, out = 0;
+(void) copy_file_range(0, &in, 1, &out, 4096, 0);
+(void) lseek(0, 0, SEEK_DATA);
+(void) lseek(0, 0, SEEK_HOLE);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # special case begin
 # cxx11_future
 if (UNIX AND NOT ANDROID AND NOT QNX)
@@ -181,6 +202,26 @@ std::filesystem::copy(
 "# FIXME: qmake: CONFIG += c++17
 )
 
+# epoll
+qt_config_compile_test(epoll
+    LABEL "epoll"
+    CODE
+"
+#include <sys/epoll.h>
+
+int main(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    /* BEGIN TEST: */
+epoll_event ev = {};
+int fd = epoll_create1(EPOLL_CLOEXEC);
+epoll_ctl(fd, EPOLL_CTL_ADD, 0, &ev);
+epoll_wait(fd, &ev, 1, 0);
+    /* END TEST: */
+    return 0;
+}
+")
+
 # eventfd
 qt_config_compile_test(eventfd
     LABEL "eventfd"
@@ -307,6 +348,30 @@ inotify_rm_watch(0, 1);
 }
 ")
 
+# io_uring
+qt_config_compile_test(io_uring
+    LABEL "io_uring"
+    CODE
+"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+int main(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    /* BEGIN TEST: */
+io_uring_params params = {};
+io_uring_probe *probe = nullptr;
+int fd = syscall(__NR_io_uring_setup, 8, &params);
+syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, 0);
+syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+return IORING_OP_READ + IORING_OP_WRITE + IORING_OP_FSYNC;
+    /* END TEST: */
+    return 0;
+}
+")
+
 # ipc_sysv
 qt_config_compile_test(ipc_sysv
     LABEL "SysV IPC"
@@ -543,6 +608,10 @@ qt_feature("clock-monotonic" PUBLIC
     CONDITION QT_FEATURE_clock_gettime AND TEST_clock_monotonic
 )
 qt_feature_definition("clock-monotonic" "QT_NO_CLOCK_MONOTONIC" NEGATE VALUE "1")
+qt_feature("copy_file_range" PRIVATE
+    LABEL "copy_file_range()"
+    CONDITION LINUX AND TEST_copy_file_range
+)
 qt_feature("doubleconversion" PUBLIC PRIVATE
     LABEL "DoubleConversion"
 )
@@ -561,6 +630,10 @@ qt_feature("cxx17_filesystem" PUBLIC
     LABEL "C++17 <filesystem>"
     CONDITION TEST_cxx17_filesystem
 )
+qt_feature("epoll" PRIVATE
+    LABEL "epoll"
+    CONDITION LINUX AND TEST_epoll
+)
 qt_feature("eventfd" PUBLIC
     LABEL "eventfd"
     CONDITION NOT WASM AND TEST_eventfd
@@ -603,6 +676,10 @@ qt_feature("inotify" PUBLIC PRIVATE
     CONDITION TEST_inotify
 )
 qt_feature_definition("inotify" "QT_NO_INOTIFY" NEGATE VALUE "1")
+qt_feature("io_uring" PRIVATE
+    LABEL "io_uring"
+    CONDITION LINUX AND QT_FEATURE_future AND TEST_io_uring
+)
 qt_feature("ipc_posix"
     LABEL "Using POSIX IPC"
     AUTODETECT NOT WIN32
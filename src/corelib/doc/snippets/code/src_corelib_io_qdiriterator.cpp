@@ -73,3 +73,15 @@ while (it.hasNext()) {
 //! [2]
 QDirIterator audioFileIt(audioPath, {"*.mp3", "*.wav"}, QDir::Files);
 //! [2]
+
+//! [3]
+QDirIterator it("/mnt/share", QDir::Files,
+                QDirIterator::Subdirectories | QDirIterator::ParallelScan
+                | QDirIterator::PrefetchMetaData);
+qint64 total = 0;
+for (QFileInfoList batch = it.nextBatch(); !batch.isEmpty(); batch = it.nextBatch()) {
+    for (const QFileInfo &info : batch)
+        total += info.size();
+    qDebug() << total << "bytes so far";
+}
+//! [3]
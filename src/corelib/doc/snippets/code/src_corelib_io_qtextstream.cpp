@@ -137,3 +137,18 @@ stream << '\n' << Qt::flush;
 QTextStream out(&file);
 out.setEncoding(QStringConverter::Utf8);
 //! [10]
+
+
+//! [11]
+QFile file("server.log");
+if (file.open(QIODevice::ReadOnly)) {
+    QTextStream in(&file);
+    in.setMemoryMappingEnabled(true);
+    qsizetype errors = 0;
+    QByteArrayView line;
+    while (in.readLineView(&line)) {
+        if (line.startsWith("ERROR"))
+            ++errors;
+    }
+}
+//! [11]
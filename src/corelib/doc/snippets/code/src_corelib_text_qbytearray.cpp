@@ -516,4 +516,25 @@ ba.compare(arr);   // returns 0, both have the same size and data
 const char *str = "abc";
 ba.compare(str);   // returns 0, the size is determined by scanning for '\0'
 //! [54]
+
+//! [55]
+QByteArray json;
+json.appendArgs(QLatin1String("{\"name\": \"%1\", \"size\": %2}"), QStringLiteral("Fl\u00fcgel"), 1024);
+// json == "{\"name\": \"Fl\xc3\xbcgel\", \"size\": 1024}"
+//! [55]
+
+//! [56]
+const double samples[] = { 0.1, -2.5, 1e21 };
+QByteArray row("[");
+row.appendNumbers(samples, 3, ", ", 'g', QLocale::FloatingPointShortest).append(']');
+// row == "[0.1, -2.5, 1e+21]"
+//! [56]
+
+//! [57]
+const QByteArrayView line("3, 14, 15, x, 92");
+qlonglong values[8];
+qsizetype end;
+qsizetype count = line.parseNumbers(values, 8, ',', &end);
+// count == 3, values begins with 3, 14, 15 and line.sliced(end) == " x, 92"
+//! [57]
 }
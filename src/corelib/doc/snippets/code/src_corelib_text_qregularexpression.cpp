@@ -364,4 +364,36 @@ for (const QRegularExpressionMatch &match : re.globalMatch(subject)) {
 }
 //! [34]
 }
+
+{
+//! [35]
+QRegularExpressionSet rules({
+    QStringLiteral(R"(^\s*#)"),                    // 0: comment
+    QStringLiteral(R"(\b(?:int|char|void)\b)"),   // 1: type
+    QStringLiteral(R"("[^"]*")"),                  // 2: string literal
+});
+
+QList<qsizetype> matching = rules.matchingPatterns(u"void f() { puts(\"hi\"); }");
+// matching == { 1, 2 }
+qsizetype first = rules.firstMatchingPattern(u"# int x");
+// first == 0
+//! [35]
+}
+
+{
+//! [36]
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // uses QStandardPaths::CacheLocation, which depends on the application name
+    QRegularExpression::loadCompiledPatternCache();
+
+    // ... create and use regular expressions ...
+
+    int result = app.exec();
+    QRegularExpression::saveCompiledPatternCache();
+    return result;
+}
+//! [36]
+}
 }
@@ -124,6 +124,8 @@ public:
 
     void plusEqualOperator();
     void arrayOperator();
+    void appendArgsFunction();
+    void appendNumbersFunction();
 };
 
 Widget::Widget(QWidget *parent)
@@ -956,6 +958,30 @@ void Widget::arrayOperator()
     //! [85]
 }
 
+void Widget::appendArgsFunction()
+{
+    //! [86]
+    QString log;
+    const QString fileName = "report.txt";
+    const int copied = 3;
+    const int total = 4;
+    log.appendArgs(u"%1: copied %2 of %3 files (%4%)\n", fileName, copied, total, 100.0 * copied / total);
+    // log == "report.txt: copied 3 of 4 files (75%)\n"
+    //! [86]
+}
+
+void Widget::appendNumbersFunction()
+{
+    //! [87]
+    const qlonglong ids[] = { 17, -4, 1024 };
+    const double weights[] = { 0.5, 1e-7, 12.25 };
+    QString csv;
+    csv.appendNumbers(ids, 3, u",").append(u'\n');
+    csv.appendNumbers(weights, 3, u",", 'g', QLocale::FloatingPointShortest);
+    // csv == "17,-4,1024\n0.5,1e-07,12.25"
+    //! [87]
+}
+
 
 int main(int argc, char *argv[])
 {
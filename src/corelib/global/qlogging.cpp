@@ -60,6 +60,9 @@
 #include "private/qcoreapplication_p.h"
 #include "private/qsimd_p.h"
 #include <qtcore_tracepoints_p.h>
+#if QT_CONFIG(thread)
+#include "private/qasynclogsink_p.h"
+#endif
 #endif
 #ifdef Q_OS_WIN
 #include <qt_windows.h>
@@ -189,35 +192,73 @@ static int checked_var_value(const char *varname)
     return ok ? value : 1;
 }
 
+static QAtomicInt &fatalCriticals()
+{
+    static QAtomicInt value = checked_var_value("QT_FATAL_CRITICALS");
+    return value;
+}
+
+static QAtomicInt &fatalWarnings()
+{
+    static QAtomicInt value = checked_var_value("QT_FATAL_WARNINGS");
+    return value;
+}
+
 static bool isFatal(QtMsgType msgType)
 {
     if (msgType == QtFatalMsg)
         return true;
 
     if (msgType == QtCriticalMsg) {
-        static QAtomicInt fatalCriticals = checked_var_value("QT_FATAL_CRITICALS");
-
         // it's fatal if the current value is exactly 1,
         // otherwise decrement if it's non-zero
-        return fatalCriticals.loadRelaxed() && fatalCriticals.fetchAndAddRelaxed(-1) == 1;
+        return fatalCriticals().loadRelaxed() && fatalCriticals().fetchAndAddRelaxed(-1) == 1;
     }
 
     if (msgType == QtWarningMsg || msgType == QtCriticalMsg) {
-        static QAtomicInt fatalWarnings = checked_var_value("QT_FATAL_WARNINGS");
-
         // it's fatal if the current value is exactly 1,
         // otherwise decrement if it's non-zero
-        return fatalWarnings.loadRelaxed() && fatalWarnings.fetchAndAddRelaxed(-1) == 1;
+        return fatalWarnings().loadRelaxed() && fatalWarnings().fetchAndAddRelaxed(-1) == 1;
     }
 
     return false;
 }
 
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+// Whether isFatal() may return true for a message of type \a msgType; such
+// messages are not left to QAsyncLogSink, as qt_message_fatal() needs them.
+static bool mayBeFatal(QtMsgType msgType)
+{
+    switch (msgType) {
+    case QtFatalMsg:
+        return true;
+    case QtCriticalMsg:
+        return fatalCriticals().loadRelaxed() || fatalWarnings().loadRelaxed();
+    case QtWarningMsg:
+        return fatalWarnings().loadRelaxed();
+    default:
+        return false;
+    }
+}
+#endif
+
 static bool isDefaultCategory(const char *category)
 {
     return !category || strcmp(category, "default") == 0;
 }
 
+#ifndef QT_BOOTSTRAPPED
+// qDebug, qWarning, ... macros do not check whether category is enabled
+static bool isDisabledInDefaultCategory(QtMsgType msgType, const QMessageLogContext &context)
+{
+    if (msgType != QtFatalMsg && isDefaultCategory(context.category)) {
+        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory())
+            return !defaultCategory->isEnabled(msgType);
+    }
+    return false;
+}
+#endif
+
 /*!
     Returns true if writing to \c stderr is supported.
 
@@ -370,6 +411,16 @@ static inline void convert_to_wchar_t_elided(wchar_t *d, size_t space, const cha
 Q_NEVER_INLINE
 static QString qt_message(QtMsgType msgType, const QMessageLogContext &context, const char *msg, va_list ap)
 {
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+    // let the installed QAsyncLogSink format the message later, if at all
+    if (QAsyncLogSinkPrivate::isActive() && !mayBeFatal(msgType)) {
+        if (isDisabledInDefaultCategory(msgType, context)
+                || QAsyncLogSinkPrivate::record(msgType, context, msg, ap)) {
+            return QString();
+        }
+    }
+#endif
+
     QString buf = QString::vasprintf(msg, ap);
     qt_message_print(msgType, context, buf);
     return buf;
@@ -1799,15 +1850,21 @@ static void ungrabMessageHandler() { }
 static void qt_message_print(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
 {
 #ifndef QT_BOOTSTRAPPED
+#if QT_CONFIG(thread)
+    // Recorded messages come back here on the sink's writer thread, and
+    // are traced there. Messages that the sink does not record (too large,
+    // or that may be fatal) are printed after the recorded ones.
+    if (QAsyncLogSinkPrivate::isActive() && !isDisabledInDefaultCategory(msgType, context)) {
+        if (!mayBeFatal(msgType) && QAsyncLogSinkPrivate::record(msgType, context, message))
+            return;
+        QAsyncLogSinkPrivate::flushInstalled();
+    }
+#endif
+
     Q_TRACE(qt_message_print, msgType, context.category, context.function, context.file, context.line, message);
 
-    // qDebug, qWarning, ... macros do not check whether category is enabledgc
-    if (msgType != QtFatalMsg && isDefaultCategory(context.category)) {
-        if (QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory()) {
-            if (!defaultCategory->isEnabled(msgType))
-                return;
-        }
-    }
+    if (isDisabledInDefaultCategory(msgType, context))
+        return;
 #endif
 
     // prevent recursion in case the message handler generates messages
@@ -1821,6 +1878,11 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
     }
 }
 
+void QtPrivate::printMessage(QtMsgType msgType, const QMessageLogContext &context, const QString &message)
+{
+    qt_message_print(msgType, context, message);
+}
+
 static void qt_message_print(const QString &message)
 {
 #if defined(Q_OS_WIN) && !defined(QT_BOOTSTRAPPED)
@@ -1835,6 +1897,11 @@ static void qt_message_print(const QString &message)
 
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, const QString &message)
 {
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+    // write what was recorded before, e.g. a warning made fatal by QT_FATAL_WARNINGS
+    QAsyncLogSinkPrivate::flushInstalled();
+#endif
+
 #if defined(Q_CC_MSVC) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -53,10 +53,15 @@
 
 QT_BEGIN_NAMESPACE
 
+class QString;
+
 namespace QtPrivate {
 
 Q_CORE_EXPORT bool shouldLogToStderr();
 
+// passes the message to the message handler, skipping the fatal checks
+void printMessage(QtMsgType msgType, const QMessageLogContext &context, const QString &message);
+
 }
 
 QT_END_NAMESPACE
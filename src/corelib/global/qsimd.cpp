@@ -68,9 +68,13 @@
 #define HWCAP_VFPv3D16  16384
 
 // copied from <asm/hwcap.h> (ARM):
+#define HWCAP2_SHA1  (1 << 2)
+#define HWCAP2_SHA2  (1 << 3)
 #define HWCAP2_CRC32 (1 << 4)
 
 // copied from <asm/hwcap.h> (Aarch64)
+#define HWCAP_SHA1              (1 << 5)
+#define HWCAP_SHA2              (1 << 6)
 #define HWCAP_CRC32             (1 << 7)
 
 // copied from <linux/auxvec.h>
@@ -93,12 +97,15 @@ QT_BEGIN_NAMESPACE
 /* Data:
  neon
  crc32
+ sha2
  */
 static const char features_string[] =
+        "\0"
         " neon\0"
         " crc32\0"
+        " sha2\0"
         "\0";
-static const int features_indices[] = { 0, 6 };
+static const int features_indices[] = { 0, 1, 7, 14 };
 #elif defined(Q_PROCESSOR_MIPS)
 /* Data:
  dsp
@@ -132,13 +139,14 @@ static inline quint64 detectProcessorFeatures()
 
 #if defined(Q_OS_LINUX)
 #  if defined(Q_PROCESSOR_ARM_V8) && defined(Q_PROCESSOR_ARM_64)
-    features |= Q_UINT64_C(1) << CpuFeatureNEON; // NEON is always available on ARMv8 64bit.
+    features |= CpuFeatureNEON; // NEON is always available on ARMv8 64bit.
 #  endif
     int auxv = qt_safe_open("/proc/self/auxv", O_RDONLY);
     if (auxv != -1) {
         unsigned long vector[64];
         int nread;
-        while (features == 0) {
+        // read the whole vector: on AArch64, features already has NEON
+        forever {
             nread = qt_safe_read(auxv, (char *)vector, sizeof vector);
             if (nread <= 0) {
                 // EOF or error
@@ -151,17 +159,21 @@ static inline quint64 detectProcessorFeatures()
 #  if defined(Q_PROCESSOR_ARM_V8) && defined(Q_PROCESSOR_ARM_64)
                     // For Aarch64:
                     if (vector[i+1] & HWCAP_CRC32)
-                        features |= Q_UINT64_C(1) << CpuFeatureCRC32;
+                        features |= CpuFeatureCRC32;
+                    if ((vector[i+1] & (HWCAP_SHA1 | HWCAP_SHA2)) == (HWCAP_SHA1 | HWCAP_SHA2))
+                        features |= CpuFeatureSHA2;
 #  endif
                     // Aarch32, or ARMv7 or before:
                     if (vector[i+1] & HWCAP_NEON)
-                        features |= Q_UINT64_C(1) << CpuFeatureNEON;
+                        features |= CpuFeatureNEON;
                 }
 #  if defined(Q_PROCESSOR_ARM_32)
                 // For Aarch32:
                 if (vector[i] == AT_HWCAP2) {
                     if (vector[i+1] & HWCAP2_CRC32)
-                        features |= Q_UINT64_C(1) << CpuFeatureCRC32;
+                        features |= CpuFeatureCRC32;
+                    if ((vector[i+1] & (HWCAP2_SHA1 | HWCAP2_SHA2)) == (HWCAP2_SHA1 | HWCAP2_SHA2))
+                        features |= CpuFeatureSHA2;
                 }
 #  endif
             }
@@ -174,10 +186,13 @@ static inline quint64 detectProcessorFeatures()
 #endif
 
 #if defined(__ARM_NEON__)
-    features |= Q_UINT64_C(1) << CpuFeatureNEON;
+    features |= CpuFeatureNEON;
 #endif
 #if defined(__ARM_FEATURE_CRC32)
-    features |= Q_UINT64_C(1) << CpuFeatureCRC32;
+    features |= CpuFeatureCRC32;
+#endif
+#if defined(__ARM_FEATURE_SHA2)
+    features |= CpuFeatureSHA2;
 #endif
 
     return features;
@@ -283,6 +283,10 @@ QT_END_NAMESPACE
 #endif
 #  include <arm_acle.h>
 #endif
+// ARMv8 SHA-1 and SHA-256 instructions (older compilers only define __ARM_FEATURE_CRYPTO)
+#if defined(Q_PROCESSOR_ARM_V8) && !defined(__ARM_FEATURE_SHA2) && defined(__ARM_FEATURE_CRYPTO)
+#  define __ARM_FEATURE_SHA2            // also support QT_COMPILER_SUPPORTS_HERE(SHA2)
+#endif
 
 #ifdef __cplusplus
 #include <qatomic.h>
@@ -295,6 +299,7 @@ enum CPUFeatures {
     CpuFeatureNEON          = 2,
     CpuFeatureARM_NEON      = CpuFeatureNEON,
     CpuFeatureCRC32         = 4,
+    CpuFeatureSHA2          = 8,    // SHA-1 and SHA-256
 #elif defined(Q_PROCESSOR_MIPS)
     CpuFeatureDSP           = 2,
     CpuFeatureDSPR2         = 4,
@@ -311,6 +316,9 @@ static const quint64 qCompilerCpuFeatures = 0
 #if defined __ARM_FEATURE_CRC32
         | CpuFeatureCRC32
 #endif
+#if defined __ARM_FEATURE_SHA2
+        | CpuFeatureSHA2
+#endif
 #if defined __mips_dsp
         | CpuFeatureDSP
 #endif
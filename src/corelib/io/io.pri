@@ -79,6 +79,30 @@ SOURCES += \
 
 qtConfig(zstd): QMAKE_USE_PRIVATE += zstd
 
+qtConfig(future) {
+    HEADERS += \
+        io/qasyncfile.h \
+        io/qasyncfile_p.h
+    SOURCES += \
+        io/qasyncfile.cpp
+
+    qtConfig(io_uring) {
+        HEADERS += io/qasyncfile_uring_p.h
+        SOURCES += io/qasyncfile_uring.cpp
+    }
+}
+
+qtConfig(thread) {
+    HEADERS += \
+        io/qasynclogsink.h \
+        io/qasynclogsink_p.h \
+        io/qfilecopier.h \
+        io/qfilecopier_p.h
+    SOURCES += \
+        io/qasynclogsink.cpp \
+        io/qfilecopier.cpp
+}
+
 qtConfig(filesystemwatcher) {
     HEADERS += \
         io/qfilesystemwatcher.h \
@@ -120,7 +144,8 @@ qtConfig(processenvironment) {
 
 qtConfig(settings) {
     SOURCES += \
-        io/qsettings.cpp
+        io/qsettings.cpp \
+        io/qsettings_binary.cpp
     HEADERS += \
         io/qsettings.h \
         io/qsettings_p.h
@@ -0,0 +1,721 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+#include "qasyncfile.h"
+#include "qasyncfile_p.h"
+
+#include <qdebug.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qthreadpool.h>
+
+#ifdef Q_OS_UNIX
+#include "private/qcore_unix_p.h"
+#endif
+#if QT_CONFIG(io_uring)
+#include "qasyncfile_uring_p.h"
+#endif
+
+#include <errno.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+class ReadOperation : public QAsyncFileOperation
+{
+public:
+    ReadOperation(QAsyncFilePrivate *d, qint64 offset, qint64 maxSize)
+        : QAsyncFileOperation(d, Read, offset, QByteArray(maxSize, Qt::Uninitialized))
+    {
+        promise.reportStarted();
+    }
+
+    QPromise<QByteArray> promise;
+
+protected:
+    void deliver(qint64 result) override
+    {
+        if (result < 0) {
+            buffer.clear();
+        } else {
+            buffer.truncate(result);
+            d->emitReadFinished(offset, buffer);
+        }
+        promise.addResult(std::move(buffer));
+        promise.reportFinished();
+    }
+};
+
+class WriteOperation : public QAsyncFileOperation
+{
+public:
+    WriteOperation(QAsyncFilePrivate *d, qint64 offset, const QByteArray &data)
+        : QAsyncFileOperation(d, Write, offset, data)
+    {
+        promise.reportStarted();
+    }
+
+    QPromise<qint64> promise;
+
+protected:
+    void deliver(qint64 result) override
+    {
+        if (result >= 0)
+            d->emitWriteFinished(offset, result);
+        promise.addResult(result < 0 ? qint64(-1) : result);
+        promise.reportFinished();
+    }
+};
+
+class SyncOperation : public QAsyncFileOperation
+{
+public:
+    explicit SyncOperation(QAsyncFilePrivate *d)
+        : QAsyncFileOperation(d, Sync, 0, QByteArray())
+    {
+        promise.reportStarted();
+    }
+
+    QPromise<bool> promise;
+
+protected:
+    void deliver(qint64 result) override
+    {
+        if (result >= 0)
+            d->emitSyncFinished();
+        promise.addResult(result >= 0);
+        promise.reportFinished();
+    }
+};
+
+template <typename T>
+QFuture<T> finishedFuture(const T &result)
+{
+    QPromise<T> promise;
+    promise.reportStarted();
+    promise.addResult(result);
+    promise.reportFinished();
+    return promise.future();
+}
+
+} // unnamed namespace
+
+#ifdef Q_OS_UNIX
+QAsyncFileHandle::~QAsyncFileHandle()
+{
+    qt_safe_close(fd);
+}
+#endif
+
+QAsyncFileOperation::QAsyncFileOperation(QAsyncFilePrivate *d, Type type, qint64 offset,
+                                         const QByteArray &buffer)
+    : d(d), handle(d->handle), uring(d->uring), type(type), offset(offset), buffer(buffer)
+{
+}
+
+/*!
+    \internal
+
+    Performs the whole operation on the calling thread. This is the thread
+    pool backend.
+*/
+void QAsyncFileOperation::run()
+{
+#ifdef Q_OS_UNIX
+    const int fd = handle->fd;
+    if (type == Sync) {
+        int ret;
+        EINTR_LOOP(ret, ::fsync(fd));
+        finish(ret == -1 ? -errno : 0);
+        return;
+    }
+
+    while (done < buffer.size()) {
+        const size_t chunk = size_t(chunkSize());
+        const off_t position = off_t(offset + done);
+        ssize_t ret;
+        if (type == Read)
+            EINTR_LOOP(ret, ::pread(fd, buffer.data() + done, chunk, position));
+        else
+            EINTR_LOOP(ret, ::pwrite(fd, buffer.constData() + done, chunk, position));
+        if (ret == -1) {
+            finish(-errno);
+            return;
+        }
+        if (ret == 0)
+            break; // end of file
+        done += ret;
+    }
+    finish(done);
+#else
+    QMutexLocker locker(&handle->mutex);
+    QFile &file = handle->file;
+    bool ok;
+    if (type == Sync) {
+        ok = file.flush();
+    } else {
+        ok = file.seek(offset);
+        if (ok) {
+            const qint64 ret = type == Read ? file.read(buffer.data(), buffer.size())
+                                            : file.write(buffer.constData(), buffer.size());
+            ok = ret != -1;
+            done = qMax(ret, qint64(0));
+        }
+    }
+    if (!ok)
+        errorString = file.errorString();
+    locker.unlock();
+    finish(ok ? done : -1);
+#endif
+}
+
+#if QT_CONFIG(io_uring)
+/*!
+    \internal
+
+    Called by the io_uring backend with the \a result of one request. Issues
+    the next request if the transfer was split or interrupted, and finishes
+    the operation otherwise.
+*/
+void QAsyncFileOperation::complete(qint64 result)
+{
+    if (result == -EINTR || result == -EAGAIN) {
+        uring->submit(this);
+        return;
+    }
+    if (result > 0 && type != Sync) {
+        const qint64 requested = chunkSize();
+        done += result;
+        // a short read means end of file
+        if (done < buffer.size() && (type == Write || result == requested)) {
+            uring->submit(this);
+            return;
+        }
+    }
+    finish(result < 0 ? result : done);
+}
+#endif
+
+/*!
+    \internal
+
+    Reports \a result, which is the number of bytes transferred or a negated
+    \c errno value, and deletes the operation. Called on whichever thread
+    completed it.
+*/
+void QAsyncFileOperation::finish(qint64 result)
+{
+    QAsyncFilePrivate *const d = this->d;
+    if (result < 0) {
+        d->setError(type == Read ? QFileDevice::ReadError : QFileDevice::WriteError,
+                    errorString.isEmpty() ? qt_error_string(int(-result)) : errorString);
+    }
+    deliver(result);
+    delete this;
+    d->operationFinished();
+}
+
+bool QAsyncFilePrivate::checkOpen(const char *function, QIODeviceBase::OpenMode required) const
+{
+    if (openMode & required)
+        return true;
+    const char *message = openMode == QIODeviceBase::NotOpen ? "file not open"
+                        : (required & QIODeviceBase::ReadOnly) ? "WriteOnly file"
+                                                               : "ReadOnly file";
+    qWarning("QAsyncFile::%s (%ls): %s", function, qUtf16Printable(fileName), message);
+    return false;
+}
+
+void QAsyncFilePrivate::start(QAsyncFileOperation *operation)
+{
+    {
+        QMutexLocker locker(&mutex);
+        ++pendingOperations;
+    }
+#if QT_CONFIG(io_uring)
+    if (operation->uring) {
+        operation->uring->submit(operation);
+        return;
+    }
+#endif
+    QThreadPool::globalInstance()->start([operation] { operation->run(); });
+}
+
+void QAsyncFilePrivate::operationFinished()
+{
+    QMutexLocker locker(&mutex);
+    if (--pendingOperations == 0)
+        allFinished.wakeAll();
+}
+
+void QAsyncFilePrivate::setError(QFileDevice::FileError error, const QString &errorString)
+{
+    {
+        QMutexLocker locker(&mutex);
+        this->error = error;
+        this->errorString = errorString;
+    }
+    if (hasReceivers(&QAsyncFile::errorOccurred)) {
+        QAsyncFile *q = q_func();
+        QMetaObject::invokeMethod(q, [q, error] { emit q->errorOccurred(error); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void QAsyncFilePrivate::emitReadFinished(qint64 offset, const QByteArray &data)
+{
+    if (hasReceivers(&QAsyncFile::readFinished)) {
+        QAsyncFile *q = q_func();
+        QMetaObject::invokeMethod(q, [q, offset, data] { emit q->readFinished(offset, data); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void QAsyncFilePrivate::emitWriteFinished(qint64 offset, qint64 written)
+{
+    if (hasReceivers(&QAsyncFile::writeFinished)) {
+        QAsyncFile *q = q_func();
+        QMetaObject::invokeMethod(q, [q, offset, written] { emit q->writeFinished(offset, written); },
+                                  Qt::QueuedConnection);
+    }
+}
+
+void QAsyncFilePrivate::emitSyncFinished()
+{
+    if (hasReceivers(&QAsyncFile::syncFinished)) {
+        QAsyncFile *q = q_func();
+        QMetaObject::invokeMethod(q, [q] { emit q->syncFinished(); }, Qt::QueuedConnection);
+    }
+}
+
+/*!
+    \class QAsyncFile
+    \inmodule QtCore
+    \brief The QAsyncFile class reads and writes files without blocking the calling thread.
+    \ingroup io
+    \since 6.0
+    \reentrant
+
+    QAsyncFile issues positioned reads, writes and flushes to disk on an open
+    file and returns at once. Each request returns a QFuture that finishes
+    when the data has been transferred; wait on it, attach continuations to
+    it or observe it with a QFutureWatcher. The object also emits
+    readFinished(), writeFinished(), syncFinished() and errorOccurred() in the
+    thread it lives in, delivered through that thread's event loop.
+
+    \snippet code/src_corelib_io_qasyncfile.cpp 0
+
+    Requests carry their own offsets and may be issued from any thread while
+    others are in flight; they can complete in any order. There is no
+    current position and no buffering: every read() allocates a buffer of
+    the requested size, and every write() keeps a reference to the data until
+    it is written.
+
+    On Linux 5.6 and later, QAsyncFile submits the requests to the kernel
+    through io_uring, so reading from the page cache costs no thread switch
+    at all, and a single thread reaps the completions of all files. Setting
+    the \c QT_NO_IO_URING environment variable, or running on a kernel
+    without io_uring, falls back to performing each request on
+    QThreadPool::globalInstance(). backend() tells which one is in use.
+
+    Closing the file, or destroying the QAsyncFile, does not cancel requests
+    in flight. The destructor waits for them to finish.
+
+    \sa QFile, QFuture, QFutureWatcher
+*/
+
+/*!
+    \enum QAsyncFile::Backend
+
+    This enum describes how requests are carried out.
+
+    \value ThreadPoolBackend    Each request runs as blocking system calls on
+                                QThreadPool::globalInstance().
+    \value IoUringBackend       Requests are submitted to the Linux io_uring
+                                interface.
+*/
+
+/*!
+    \fn void QAsyncFile::readFinished(qint64 offset, const QByteArray &data)
+
+    This signal is emitted when a read() at \a offset completes successfully
+    with \a data. \a data is shorter than requested if the end of the file
+    was reached.
+*/
+
+/*!
+    \fn void QAsyncFile::writeFinished(qint64 offset, qint64 bytesWritten)
+
+    This signal is emitted when a write() at \a offset completes successfully
+    after writing \a bytesWritten bytes.
+*/
+
+/*!
+    \fn void QAsyncFile::syncFinished()
+
+    This signal is emitted when a sync() completes successfully.
+*/
+
+/*!
+    \fn void QAsyncFile::errorOccurred(QFileDevice::FileError error)
+
+    This signal is emitted when a request fails with \a error. errorString()
+    describes the most recent failure.
+*/
+
+/*!
+    Constructs a QAsyncFile with the given \a parent.
+*/
+QAsyncFile::QAsyncFile(QObject *parent)
+    : QObject(*new QAsyncFilePrivate, parent)
+{
+}
+
+/*!
+    Constructs a QAsyncFile for the file \a name, with the given \a parent.
+*/
+QAsyncFile::QAsyncFile(const QString &name, QObject *parent)
+    : QAsyncFile(parent)
+{
+    d_func()->fileName = name;
+}
+
+/*!
+    Waits for the pending requests to finish, then closes the file and
+    destroys the object. Signals for those requests are no longer emitted.
+*/
+QAsyncFile::~QAsyncFile()
+{
+    waitForPendingOperations();
+}
+
+/*!
+    Returns the name of the file.
+
+    \sa setFileName()
+*/
+QString QAsyncFile::fileName() const
+{
+    Q_D(const QAsyncFile);
+    return d->fileName;
+}
+
+/*!
+    Sets the name of the file to \a name. Closes the file first if it is
+    open.
+
+    \sa fileName()
+*/
+void QAsyncFile::setFileName(const QString &name)
+{
+    Q_D(QAsyncFile);
+    if (isOpen()) {
+        qWarning("QAsyncFile::setFileName: File (%ls) is already opened",
+                 qUtf16Printable(d->fileName));
+        close();
+    }
+    d->fileName = name;
+}
+
+/*!
+    Opens the file with the given \a mode, following the same rules as
+    QFile::open(). QIODevice::Text and QIODevice::Unbuffered have no effect.
+    Returns \c true on success; otherwise returns \c false and sets error().
+
+    In QIODevice::Append mode, writes go to the end of the file regardless of
+    the offset passed to write().
+*/
+bool QAsyncFile::open(QIODeviceBase::OpenMode mode)
+{
+    Q_D(QAsyncFile);
+    if (isOpen()) {
+        qWarning("QAsyncFile::open: File (%ls) already open", qUtf16Printable(d->fileName));
+        return false;
+    }
+    if (mode & (QIODeviceBase::Append | QIODeviceBase::NewOnly))
+        mode |= QIODeviceBase::WriteOnly;
+    if (!(mode & QIODeviceBase::ReadWrite)) {
+        qWarning("QAsyncFile::open: File access not specified");
+        return false;
+    }
+    // WriteOnly implies Truncate when ReadOnly, Append, and NewOnly are not set.
+    if ((mode & QIODeviceBase::WriteOnly)
+            && !(mode & (QIODeviceBase::ReadOnly | QIODeviceBase::Append | QIODeviceBase::NewOnly))) {
+        mode |= QIODeviceBase::Truncate;
+    }
+
+    const auto setOpenError = [d](const QString &errorString) {
+        QMutexLocker locker(&d->mutex);
+        d->error = QFileDevice::OpenError;
+        d->errorString = errorString;
+        return false;
+    };
+    if (d->fileName.isEmpty()) {
+        qWarning("QAsyncFile::open: No file name specified");
+        return setOpenError(QLatin1String("No file name specified"));
+    }
+
+#ifdef Q_OS_UNIX
+    int flags = QT_OPEN_RDONLY;
+    if ((mode & QIODeviceBase::ReadWrite) == QIODeviceBase::ReadWrite)
+        flags = QT_OPEN_RDWR;
+    else if (mode & QIODeviceBase::WriteOnly)
+        flags = QT_OPEN_WRONLY;
+    if ((mode & QIODeviceBase::WriteOnly) && !(mode & QIODeviceBase::ExistingOnly))
+        flags |= QT_OPEN_CREAT;
+    if (mode & QIODeviceBase::Truncate)
+        flags |= QT_OPEN_TRUNC;
+    if (mode & QIODeviceBase::Append)
+        flags |= QT_OPEN_APPEND;
+    if (mode & QIODeviceBase::NewOnly)
+        flags |= QT_OPEN_EXCL;
+
+    const int fd = qt_safe_open(QFile::encodeName(d->fileName).constData(), flags, 0666);
+    if (fd == -1)
+        return setOpenError(qt_error_string(errno));
+    d->handle.reset(new QAsyncFileHandle(fd));
+#else
+    QSharedPointer<QAsyncFileHandle> handle(new QAsyncFileHandle);
+    handle->file.setFileName(d->fileName);
+    if (!handle->file.open(mode | QIODeviceBase::Unbuffered))
+        return setOpenError(handle->file.errorString());
+    d->handle = handle;
+#endif
+
+#if QT_CONFIG(io_uring)
+    d->uring = qEnvironmentVariableIsSet("QT_NO_IO_URING") ? nullptr
+                                                           : QAsyncFileIoUring::instance();
+#endif
+    d->openMode = mode;
+    unsetError();
+    return true;
+}
+
+/*!
+    Returns \c true if the file is open.
+*/
+bool QAsyncFile::isOpen() const
+{
+    Q_D(const QAsyncFile);
+    return d->openMode != QIODeviceBase::NotOpen;
+}
+
+/*!
+    Returns the mode the file was opened with, or QIODevice::NotOpen.
+*/
+QIODeviceBase::OpenMode QAsyncFile::openMode() const
+{
+    Q_D(const QAsyncFile);
+    return d->openMode;
+}
+
+/*!
+    Closes the file. Requests already in flight still complete, and the file
+    descriptor is released once the last of them has.
+*/
+void QAsyncFile::close()
+{
+    Q_D(QAsyncFile);
+    d->handle.reset();
+    d->openMode = QIODeviceBase::NotOpen;
+}
+
+/*!
+    Returns the size of the file, or -1 if it cannot be determined.
+*/
+qint64 QAsyncFile::size() const
+{
+    Q_D(const QAsyncFile);
+    if (!d->handle)
+        return QFileInfo(d->fileName).size();
+#ifdef Q_OS_UNIX
+    QT_STATBUF st;
+    if (QT_FSTAT(d->handle->fd, &st) == -1)
+        return -1;
+    return st.st_size;
+#else
+    QMutexLocker locker(&d->handle->mutex);
+    return d->handle->file.size();
+#endif
+}
+
+/*!
+    Returns the backend that carries out requests for the open file.
+*/
+QAsyncFile::Backend QAsyncFile::backend() const
+{
+    Q_D(const QAsyncFile);
+    return d->uring ? IoUringBackend : ThreadPoolBackend;
+}
+
+/*!
+    Returns the error of the most recent failed open() or request. Requests
+    set it on the thread that completes them, so it is up to date as soon as
+    their future has finished.
+
+    \sa unsetError(), errorString()
+*/
+QFileDevice::FileError QAsyncFile::error() const
+{
+    Q_D(const QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    return d->error;
+}
+
+/*!
+    Returns a human-readable description of error().
+*/
+QString QAsyncFile::errorString() const
+{
+    Q_D(const QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    if (d->errorString.isEmpty())
+        return tr("Unknown error");
+    return d->errorString;
+}
+
+/*!
+    Sets the error to QFileDevice::NoError.
+*/
+void QAsyncFile::unsetError()
+{
+    Q_D(QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    d->error = QFileDevice::NoError;
+    d->errorString.clear();
+}
+
+/*!
+    Reads up to \a maxSize bytes starting at \a offset. The returned future
+    holds the data, which is shorter than \a maxSize if the end of the file
+    was reached, and empty on error.
+
+    A buffer of \a maxSize bytes is allocated up front.
+
+    \sa readAll(), readFinished()
+*/
+QFuture<QByteArray> QAsyncFile::read(qint64 offset, qint64 maxSize)
+{
+    Q_D(QAsyncFile);
+    if (!d->checkOpen("read", QIODeviceBase::ReadOnly))
+        return finishedFuture(QByteArray());
+    if (offset < 0 || maxSize < 0) {
+        qWarning("QAsyncFile::read: Called with negative offset or size");
+        return finishedFuture(QByteArray());
+    }
+    if (maxSize == 0)
+        return finishedFuture(QByteArray());
+
+    auto operation = new ReadOperation(d, offset, maxSize);
+    QFuture<QByteArray> future = operation->promise.future();
+    d->start(operation);
+    return future;
+}
+
+/*!
+    Reads the whole file, as large as it is now.
+
+    \sa read()
+*/
+QFuture<QByteArray> QAsyncFile::readAll()
+{
+    return read(0, isOpen() ? size() : 0);
+}
+
+/*!
+    Writes \a data starting at \a offset. The returned future holds the
+    number of bytes written, which is the size of \a data unless an error
+    occurred, in which case it is -1.
+
+    \sa writeFinished()
+*/
+QFuture<qint64> QAsyncFile::write(qint64 offset, const QByteArray &data)
+{
+    Q_D(QAsyncFile);
+    if (!d->checkOpen("write", QIODeviceBase::WriteOnly))
+        return finishedFuture(qint64(-1));
+    if (offset < 0) {
+        qWarning("QAsyncFile::write: Called with negative offset");
+        return finishedFuture(qint64(-1));
+    }
+    if (data.isEmpty())
+        return finishedFuture(qint64(0));
+
+    auto operation = new WriteOperation(d, offset, data);
+    QFuture<qint64> future = operation->promise.future();
+    d->start(operation);
+    return future;
+}
+
+/*!
+    Flushes the file to the storage device, like \c fsync(). The returned
+    future holds \c true on success. Only writes that have finished before
+    the call are guaranteed to be covered.
+
+    \sa syncFinished()
+*/
+QFuture<bool> QAsyncFile::sync()
+{
+    Q_D(QAsyncFile);
+    if (!d->checkOpen("sync", QIODeviceBase::ReadWrite))
+        return finishedFuture(false);
+
+    auto operation = new SyncOperation(d);
+    QFuture<bool> future = operation->promise.future();
+    d->start(operation);
+    return future;
+}
+
+/*!
+    Blocks until all requests issued so far have finished. Their signals
+    are still delivered through the event loop afterwards.
+*/
+void QAsyncFile::waitForPendingOperations()
+{
+    Q_D(QAsyncFile);
+    QMutexLocker locker(&d->mutex);
+    while (d->pendingOperations)
+        d->allFinished.wait(&d->mutex);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qasyncfile.cpp"
@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QASYNCFILE_H
+#define QASYNCFILE_H
+
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qfuture.h>
+#include <QtCore/qobject.h>
+
+QT_REQUIRE_CONFIG(future);
+
+QT_BEGIN_NAMESPACE
+
+class QAsyncFilePrivate;
+
+class Q_CORE_EXPORT QAsyncFile : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QAsyncFile)
+
+public:
+    enum Backend {
+        ThreadPoolBackend,
+        IoUringBackend
+    };
+    Q_ENUM(Backend)
+
+    explicit QAsyncFile(QObject *parent = nullptr);
+    explicit QAsyncFile(const QString &name, QObject *parent = nullptr);
+    ~QAsyncFile();
+
+    QString fileName() const;
+    void setFileName(const QString &name);
+
+    bool open(QIODeviceBase::OpenMode mode);
+    bool isOpen() const;
+    QIODeviceBase::OpenMode openMode() const;
+    void close();
+
+    qint64 size() const;
+    Backend backend() const;
+
+    QFileDevice::FileError error() const;
+    QString errorString() const;
+    void unsetError();
+
+    QFuture<QByteArray> read(qint64 offset, qint64 maxSize);
+    QFuture<QByteArray> readAll();
+    QFuture<qint64> write(qint64 offset, const QByteArray &data);
+    QFuture<bool> sync();
+
+    void waitForPendingOperations();
+
+Q_SIGNALS:
+    void readFinished(qint64 offset, const QByteArray &data);
+    void writeFinished(qint64 offset, qint64 bytesWritten);
+    void syncFinished();
+    void errorOccurred(QFileDevice::FileError error);
+};
+
+QT_END_NAMESPACE
+
+#endif // QASYNCFILE_H
@@ -0,0 +1,161 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QASYNCFILE_P_H
+#define QASYNCFILE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qasyncfile.h"
+
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpromise.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/private/qobject_p.h>
+
+#ifndef Q_OS_UNIX
+#include <QtCore/qfile.h>
+#endif
+
+QT_REQUIRE_CONFIG(future);
+
+QT_BEGIN_NAMESPACE
+
+class QAsyncFileIoUring;
+class QAsyncFilePrivate;
+
+// Shared by the QAsyncFile and its operations in flight, so that close()
+// does not release the descriptor under them.
+class QAsyncFileHandle
+{
+    Q_DISABLE_COPY_MOVE(QAsyncFileHandle)
+public:
+#ifdef Q_OS_UNIX
+    explicit QAsyncFileHandle(int fd) : fd(fd) {}
+    ~QAsyncFileHandle();
+
+    const int fd;
+#else
+    QAsyncFileHandle() = default;
+
+    QFile file;
+    QMutex mutex; // serializes seek() and read()/write() on file
+#endif
+};
+
+class QAsyncFileOperation
+{
+    Q_DISABLE_COPY_MOVE(QAsyncFileOperation)
+public:
+    enum Type { Read, Write, Sync };
+
+    // the most a single read or write request transfers
+    static constexpr qint64 MaxChunkSize = 1 << 30;
+
+    virtual ~QAsyncFileOperation() = default;
+
+    qint64 chunkSize() const { return qMin(buffer.size() - done, MaxChunkSize); }
+
+    void run();
+#if QT_CONFIG(io_uring)
+    void complete(qint64 result);
+#endif
+    void finish(qint64 result);
+
+    QAsyncFilePrivate *const d;
+    const QSharedPointer<QAsyncFileHandle> handle;
+    QAsyncFileIoUring *const uring;
+    const Type type;
+    const qint64 offset;
+    qint64 done = 0;
+    QByteArray buffer;
+    QString errorString;
+
+protected:
+    QAsyncFileOperation(QAsyncFilePrivate *d, Type type, qint64 offset, const QByteArray &buffer);
+
+    virtual void deliver(qint64 result) = 0;
+};
+
+class QAsyncFilePrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QAsyncFile)
+public:
+    bool checkOpen(const char *function, QIODeviceBase::OpenMode required) const;
+    void start(QAsyncFileOperation *operation);
+    void operationFinished();
+    void setError(QFileDevice::FileError error, const QString &errorString);
+    // queue the signals of finished operations to the thread of the file
+    void emitReadFinished(qint64 offset, const QByteArray &data);
+    void emitWriteFinished(qint64 offset, qint64 written);
+    void emitSyncFinished();
+
+    template <typename Func>
+    bool hasReceivers(Func signal) const
+    {
+        return q_func()->isSignalConnected(QMetaMethod::fromSignal(signal));
+    }
+
+    QString fileName;
+    QSharedPointer<QAsyncFileHandle> handle;
+    QIODeviceBase::OpenMode openMode = QIODeviceBase::NotOpen;
+    QAsyncFileIoUring *uring = nullptr;
+
+    mutable QMutex mutex; // protects the members below
+    QWaitCondition allFinished;
+    qsizetype pendingOperations = 0;
+    QFileDevice::FileError error = QFileDevice::NoError;
+    QString errorString;
+};
+
+QT_END_NAMESPACE
+
+#endif // QASYNCFILE_P_H
@@ -0,0 +1,390 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qasyncfile_uring_p.h"
+
+#include <qdebug.h>
+#include <qglobalstatic.h>
+#include <qvarlengtharray.h>
+#include <private/qcore_unix_p.h>
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+QT_BEGIN_NAMESPACE
+
+// not every libc wraps the io_uring system calls yet
+static int io_uring_setup(unsigned entries, io_uring_params *params)
+{
+    return int(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    return int(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+static int io_uring_register(int fd, unsigned opcode, void *arg, unsigned count)
+{
+    return int(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// the kernel updates the heads and tails concurrently with us
+static inline unsigned loadAcquire(const unsigned *p)
+{
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(unsigned *p, unsigned value)
+{
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+Q_GLOBAL_STATIC(QAsyncFileIoUring, globalRing)
+
+QAsyncFileIoUring::QAsyncFileIoUring()
+    : reaper(this)
+{
+    if (setup()) {
+        reaper.setObjectName(QStringLiteral("QAsyncFile io_uring"));
+        reaper.start();
+    }
+}
+
+QAsyncFileIoUring::~QAsyncFileIoUring()
+{
+    if (reaper.isRunning()) {
+        // a request without an operation tells the reaper to stop
+        {
+            QMutexLocker locker(&mutex);
+            Q_ASSERT(backlog.isEmpty());
+            while (!brokenError && !push(nullptr)) {
+                locker.unlock();
+                QThread::yieldCurrentThread();
+                locker.relock();
+            }
+            if (!flush())
+                wakeReaper();
+        }
+        reaper.wait();
+    }
+
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing)
+        munmap(sqRing, sqRingSize);
+    if (ringFd != -1)
+        ::close(ringFd);
+    if (wakeFd != -1)
+        ::close(wakeFd);
+}
+
+/*!
+    \internal
+
+    Returns the shared ring, or \nullptr if the kernel does not support
+    io_uring or the file operations QAsyncFile needs (Linux 5.6 and later).
+*/
+QAsyncFileIoUring *QAsyncFileIoUring::instance()
+{
+    QAsyncFileIoUring *ring = globalRing();
+    return ring && ring->ringFd != -1 ? ring : nullptr;
+}
+
+bool QAsyncFileIoUring::setup()
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd = io_uring_setup(256, &params);
+    if (ringFd < 0) {
+        // ENOSYS on old kernels, EPERM in sandboxes that disable io_uring
+        ringFd = -1;
+        return false;
+    }
+
+    const auto fail = [this] {
+        ::close(ringFd);
+        ringFd = -1;
+        return false;
+    };
+
+    // IORING_OP_READ and IORING_OP_WRITE appeared in 5.6, together with the probe
+    const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    QByteArray probeBuffer(int(probeSize), '\0');
+    auto probe = reinterpret_cast<io_uring_probe *>(probeBuffer.data());
+    if (io_uring_register(ringFd, IORING_REGISTER_PROBE, probe, 256) < 0)
+        return fail();
+    for (int op : { IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC }) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+            return fail();
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+        sqRingSize = cqRingSize = qMax(sqRingSize, cqRingSize);
+
+    sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                  ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED) {
+        sqRing = nullptr;
+        return fail();
+    }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        cqRing = sqRing;
+    } else {
+        cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFd, IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED) {
+            cqRing = nullptr;
+            return fail();
+        }
+    }
+    sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqeMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ringFd, IORING_OFF_SQES);
+    if (sqeMemory == MAP_FAILED)
+        return fail();
+    sqes = static_cast<io_uring_sqe *>(sqeMemory);
+
+    const auto sqField = [this](quint32 offset) {
+        return reinterpret_cast<unsigned *>(static_cast<char *>(sqRing) + offset);
+    };
+    const auto cqField = [this](quint32 offset) {
+        return reinterpret_cast<unsigned *>(static_cast<char *>(cqRing) + offset);
+    };
+    sqHead = sqField(params.sq_off.head);
+    sqTail = sqField(params.sq_off.tail);
+    sqArray = sqField(params.sq_off.array);
+    sqMask = *sqField(params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    cqHead = cqField(params.cq_off.head);
+    cqTail = cqField(params.cq_off.tail);
+    cqMask = *cqField(params.cq_off.ring_mask);
+    cqEntries = params.cq_entries;
+    cqes = reinterpret_cast<io_uring_cqe *>(static_cast<char *>(cqRing) + params.cq_off.cqes);
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd == -1)
+        return fail();
+    return true;
+}
+
+void QAsyncFileIoUring::submit(QAsyncFileOperation *operation)
+{
+    QMutexLocker locker(&mutex);
+    if (Q_UNLIKELY(brokenError)) {
+        const int error = brokenError;
+        locker.unlock();
+        operation->finish(-error);
+        return;
+    }
+    if (!backlog.isEmpty() || !push(operation))
+        backlog.enqueue(operation);
+    else if (!flush())
+        wakeReaper();
+}
+
+/*!
+    \internal
+
+    Queues a request for \a operation, to be handed to the kernel by
+    flush(). Returns \c false if the ring is full; the caller must hold the
+    mutex.
+*/
+bool QAsyncFileIoUring::push(QAsyncFileOperation *operation)
+{
+    // never have more requests in flight than the completion queue holds
+    if (inFlight >= cqEntries)
+        return false;
+    const unsigned tail = *sqTail;
+    if (tail - loadAcquire(sqHead) >= sqEntries)
+        return false;
+
+    const unsigned index = tail & sqMask;
+    io_uring_sqe *sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    if (!operation) {
+        sqe->opcode = IORING_OP_NOP;
+    } else {
+        sqe->fd = operation->handle->fd;
+        sqe->user_data = quintptr(operation);
+        switch (operation->type) {
+        case QAsyncFileOperation::Read:
+            sqe->opcode = IORING_OP_READ;
+            sqe->addr = quintptr(operation->buffer.data() + operation->done);
+            break;
+        case QAsyncFileOperation::Write:
+            sqe->opcode = IORING_OP_WRITE;
+            sqe->addr = quintptr(operation->buffer.constData() + operation->done);
+            break;
+        case QAsyncFileOperation::Sync:
+            sqe->opcode = IORING_OP_FSYNC;
+            break;
+        }
+        if (operation->type != QAsyncFileOperation::Sync) {
+            sqe->len = quint32(operation->chunkSize());
+            sqe->off = quint64(operation->offset + operation->done);
+        }
+    }
+    sqArray[index] = index;
+    storeRelease(sqTail, tail + 1);
+    ++inFlight;
+    if (operation)
+        submitted.insert(operation);
+    return true;
+}
+
+/*!
+    \internal
+
+    Submits the requests the kernel has not consumed yet. Returns \c false
+    if some are left, because the kernel is short of resources for the
+    moment (EAGAIN) or its completion queue is full (EBUSY); the reaper
+    then retries until they are all submitted. The caller must hold the
+    mutex.
+*/
+bool QAsyncFileIoUring::flush()
+{
+    unsigned pending = *sqTail - loadAcquire(sqHead);
+    while (pending) {
+        const int ret = io_uring_enter(ringFd, pending, 0, 0);
+        if (ret < 0 && errno != EINTR)
+            return false;
+        pending = *sqTail - loadAcquire(sqHead);
+    }
+    return true;
+}
+
+// The reaper may be waiting for completions of requests the kernel has not
+// even been given: make it retry the submission.
+void QAsyncFileIoUring::wakeReaper()
+{
+    eventfd_write(wakeFd, 1);
+}
+
+void QAsyncFileIoUring::reap()
+{
+    struct Completion {
+        QAsyncFileOperation *operation;
+        qint64 result;
+    };
+
+    bool stop = false;
+    while (!stop) {
+        bool stalled;
+        {
+            QMutexLocker locker(&mutex);
+            stalled = !flush();
+        }
+
+        // the ring is readable while completions are pending, wakeFd when a
+        // submitting thread left requests in the queue; while some are
+        // left, retry every millisecond
+        pollfd fds[] = { qt_make_pollfd(ringFd, POLLIN), qt_make_pollfd(wakeFd, POLLIN) };
+        const timespec retry = { 0, 1000 * 1000 };
+        if (qt_safe_poll(fds, 2, stalled ? &retry : nullptr) < 0) {
+            const int error = errno;
+            qErrnoWarning(error, "QAsyncFile: waiting for io_uring completions failed");
+            failPending(error);
+            return;
+        }
+        if (fds[1].revents & POLLIN) {
+            eventfd_t value;
+            eventfd_read(wakeFd, &value);
+        }
+
+        QVarLengthArray<Completion, 64> completions;
+        {
+            QMutexLocker locker(&mutex);
+            unsigned head = *cqHead;
+            const unsigned tail = loadAcquire(cqTail);
+            for ( ; head != tail; ++head) {
+                const io_uring_cqe &cqe = cqes[head & cqMask];
+                if (cqe.user_data) {
+                    const auto operation = reinterpret_cast<QAsyncFileOperation *>(cqe.user_data);
+                    submitted.remove(operation);
+                    completions.append({ operation, cqe.res });
+                } else {
+                    stop = true;
+                }
+                --inFlight;
+            }
+            storeRelease(cqHead, head);
+
+            while (!backlog.isEmpty() && push(backlog.head()))
+                backlog.dequeue();
+        }
+
+        // may resubmit, so call without holding the mutex
+        for (const Completion &completion : completions)
+            completion.operation->complete(completion.result);
+    }
+}
+
+/*!
+    \internal
+
+    Called when the reaper cannot wait for completions any more: finishes
+    every operation that is queued or submitted with \a error, and makes
+    the operations submitted later fail with it right away.
+*/
+void QAsyncFileIoUring::failPending(int error)
+{
+    QList<QAsyncFileOperation *> failed;
+    {
+        QMutexLocker locker(&mutex);
+        brokenError = error;
+        failed = submitted.values();
+        failed += backlog;
+        submitted.clear();
+        backlog.clear();
+    }
+    for (QAsyncFileOperation *operation : qAsConst(failed))
+        operation->finish(-error);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QASYNCFILE_URING_P_H
+#define QASYNCFILE_URING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qasyncfile_p.h"
+
+#include <QtCore/qqueue.h>
+#include <QtCore/qset.h>
+#include <QtCore/qthread.h>
+
+QT_REQUIRE_CONFIG(io_uring);
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+QT_BEGIN_NAMESPACE
+
+// One io_uring instance shared by all QAsyncFile objects. Any thread
+// submits; a dedicated thread reaps the completions, so that futures finish
+// even while their owner blocks on them.
+class QAsyncFileIoUring
+{
+    Q_DISABLE_COPY_MOVE(QAsyncFileIoUring)
+public:
+    QAsyncFileIoUring();
+    ~QAsyncFileIoUring();
+
+    static QAsyncFileIoUring *instance();
+
+    void submit(QAsyncFileOperation *operation);
+
+private:
+    class Reaper : public QThread
+    {
+    public:
+        explicit Reaper(QAsyncFileIoUring *ring) : ring(ring) {}
+        void run() override { ring->reap(); }
+
+    private:
+        QAsyncFileIoUring *ring;
+    };
+
+    bool setup();
+    bool push(QAsyncFileOperation *operation);
+    bool flush();
+    void wakeReaper();
+    void reap();
+    void failPending(int error);
+
+    int ringFd = -1;
+    int wakeFd = -1;
+    void *sqRing = nullptr;
+    void *cqRing = nullptr;
+    size_t sqRingSize = 0;
+    size_t cqRingSize = 0;
+    io_uring_sqe *sqes = nullptr;
+    size_t sqesSize = 0;
+    io_uring_cqe *cqes = nullptr;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned cqMask = 0;
+    unsigned cqEntries = 0;
+
+    QMutex mutex; // protects the submission queue and the members below
+    QQueue<QAsyncFileOperation *> backlog;
+    QSet<QAsyncFileOperation *> submitted;
+    unsigned inFlight = 0;
+    int brokenError = 0; // the errno that stopped the reaper
+
+    Reaper reaper;
+};
+
+QT_END_NAMESPACE
+
+#endif // QASYNCFILE_URING_P_H
@@ -0,0 +1,1239 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qasynclogsink.h"
+#include "qasynclogsink_p.h"
+
+#include <QtCore/qdatetime.h>
+#include <QtCore/qiodevice.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/private/qlocking_p.h>
+#include <QtCore/private/qlogging_p.h>
+
+#include <chrono>
+#include <iterator>
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QAsyncLogSink
+    \inmodule QtCore
+    \since 6.0
+    \brief The QAsyncLogSink class records log messages without blocking the
+    threads that emit them.
+
+    \ingroup io
+
+    By default, every message passed to qDebug(), qCDebug() and friends is
+    formatted and handed to the message handler on the thread that emits it,
+    one thread at a time. Once a QAsyncLogSink is installed, the messages
+    that pass the QLoggingCategory filters are instead copied into a ring
+    buffer owned by the emitting thread, and a background thread takes them
+    from there.
+
+    For the printf-style overloads, such as \c{qCDebug(category, "%d", value)},
+    only the format and the arguments are copied; the message is formatted
+    later, on the background thread, or not at all if it goes to a binary
+    log. Messages composed with the QDebug stream operators are copied as
+    text.
+
+    A sink constructed with a file name writes a compact binary log, with the
+    category, file, line, function, thread and time of each message. Use
+    decode() to convert it to text. A sink constructed without a file name
+    passes the messages on to the message handler, see
+    qInstallMessageHandler(), from the background thread. The message
+    handler is then never called on the thread emitting the message, so the
+    \c{%{threadid}}, \c{%{time}} and \c{%{backtrace}} placeholders of the
+    message pattern refer to the background thread.
+
+    \snippet code/src_corelib_io_qasynclogsink.cpp 0
+
+    If a thread logs faster than the background thread can keep up with,
+    messages are dropped rather than blocking the thread; see bufferSize()
+    and droppedMessageCount(). Messages larger than a quarter of the buffer,
+    fatal messages, and messages that QT_FATAL_WARNINGS or
+    QT_FATAL_CRITICALS make fatal take the usual path, after the messages
+    recorded before them have been written.
+
+    Only one sink can be installed at a time.
+
+    \sa QLoggingCategory, qInstallMessageHandler()
+*/
+
+enum {
+    MinimumBufferSize = 4096,
+    WriterInterval = 10,        // milliseconds
+    MaxFileRecordSize = 64 * 1024 * 1024
+};
+
+static const char droppedCategory[] = "qt.core.logging";
+
+namespace {
+enum LengthModifier { NoModifier, hh, h, l, ll, L, j, z, t };
+
+enum ArgumentTag : char {
+    IntArgument,
+    UIntArgument,
+    DoubleArgument,
+    PointerArgument,
+    Utf8Argument,
+    Utf16Argument
+};
+
+// One conversion specification of a printf-style format, parsed with the
+// same rules as QString::vasprintf().
+struct Conversion
+{
+    enum Result {
+        Complete,
+        Incomplete,     // the rest of the format is text
+        Unknown         // the specification is text
+    };
+
+    const char *flags = nullptr;        // up to width
+    const char *width = nullptr;        // up to precision, digits or '*'
+    const char *precision = nullptr;    // up to modifier, empty or '.' and digits or '*'
+    const char *modifier = nullptr;
+    bool widthFromArgument = false;
+    bool precisionFromArgument = false;
+    LengthModifier length = NoModifier;
+    char specifier = 0;
+};
+
+// The binary log starts with a FileHeader, followed by records starting with
+// a FileRecord. All values are in host byte order.
+struct FileHeader
+{
+    char magic[8];
+    quint32 byteOrder;
+    quint32 version;
+};
+
+struct FileRecord
+{
+    quint32 size;           // including the header, a multiple of 8
+    quint8 kind;            // QAsyncLogSinkPrivate::RecordKind
+    quint8 reserved[3];
+};
+
+struct FileString
+{
+    FileRecord header;
+    quint32 id;
+    quint32 length;
+    // followed by length bytes
+};
+
+struct FileMessage
+{
+    FileRecord header;
+    quint8 type;
+    quint8 payloadKind;     // QAsyncLogRecord::Kind
+    quint16 reserved;
+    quint32 payloadSize;
+    qint32 line;
+    quint32 category;       // string ids, 0 for none
+    quint32 file;
+    quint32 function;
+    qint64 timestamp;
+    quint64 threadId;
+    // followed by payloadSize bytes
+};
+
+struct FileDropped
+{
+    FileRecord header;
+    quint64 threadId;
+    quint64 count;
+};
+} // unnamed namespace
+
+static_assert(sizeof(FileMessage) == 48);
+static_assert(sizeof(QAsyncLogRecord) % 8 == 0);
+
+static const FileHeader fileHeader = { { 'Q', 'T', 'L', 'O', 'G', 'v', '1', '\n' }, 0x01020304, 1 };
+
+static constexpr qsizetype alignedSize(qsizetype size)
+{
+    return (size + 7) & ~qsizetype(7);
+}
+
+static Conversion::Result parseConversion(const char *&c, Conversion &conversion)
+{
+    // c is past the '%'
+    conversion.flags = c;
+    while (*c == '#' || *c == '0' || *c == '-' || *c == ' ' || *c == '+' || *c == '\'')
+        ++c;
+    if (*c == '\0')
+        return Conversion::Incomplete;
+
+    conversion.width = c;
+    if (*c == '*') {
+        conversion.widthFromArgument = true;
+        ++c;
+    } else {
+        while (*c >= '0' && *c <= '9')
+            ++c;
+    }
+    if (*c == '\0')
+        return Conversion::Incomplete;
+
+    conversion.precision = c;
+    if (*c == '.') {
+        ++c;
+        if (*c == '*') {
+            conversion.precisionFromArgument = true;
+            ++c;
+        } else {
+            while (*c >= '0' && *c <= '9')
+                ++c;
+        }
+    }
+    if (*c == '\0')
+        return Conversion::Incomplete;
+
+    conversion.modifier = c;
+    switch (*c++) {
+    case 'h': conversion.length = *c == 'h' ? (++c, hh) : h; break;
+    case 'l': conversion.length = *c == 'l' ? (++c, ll) : l; break;
+    case 'L': conversion.length = L; break;
+    case 'j': conversion.length = j; break;
+    case 'z':
+    case 'Z': conversion.length = z; break;
+    case 't': conversion.length = t; break;
+    default: --c; break;
+    }
+    if (*c == '\0')
+        return Conversion::Incomplete;
+
+    switch (*c) {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+    case 'E': case 'e': case 'F': case 'f': case 'G': case 'g': case 'A': case 'a':
+    case 'c': case 's': case 'p': case 'n':
+        conversion.specifier = *c++;
+        return Conversion::Complete;
+    }
+    return Conversion::Unknown;
+}
+
+typedef QVarLengthArray<char, 512> PayloadBuffer;
+
+template <typename T>
+static void appendArgument(PayloadBuffer &buffer, ArgumentTag tag, T value)
+{
+    buffer.append(tag);
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// Copies the arguments \a format refers to from \a ap to \a buffer, reading
+// them like QString::vasprintf() does. Returns false for formats that cannot
+// be formatted later.
+static bool encodeArguments(const char *format, va_list ap, PayloadBuffer &buffer)
+{
+    for (const char *c = format; *c; ) {
+        if (*c++ != '%')
+            continue;
+        if (*c == '%') {
+            ++c;
+            continue;
+        }
+
+        Conversion conversion;
+        const Conversion::Result result = parseConversion(c, conversion);
+        if (result == Conversion::Incomplete)
+            break;
+        if (conversion.widthFromArgument)
+            appendArgument(buffer, IntArgument, qint64(va_arg(ap, int)));
+        if (conversion.precisionFromArgument)
+            appendArgument(buffer, IntArgument, qint64(va_arg(ap, int)));
+        if (result == Conversion::Unknown)
+            continue;
+
+        switch (conversion.specifier) {
+        case 'd':
+        case 'i': {
+            qint64 i = 0;
+            switch (conversion.length) {
+            case NoModifier: case hh: case h: i = va_arg(ap, int); break;
+            case l: case j: i = va_arg(ap, long int); break;
+            case ll: i = va_arg(ap, qint64); break;
+            case z: case t: i = va_arg(ap, qsizetype); break;
+            case L: break;
+            }
+            appendArgument(buffer, IntArgument, i);
+            break;
+        }
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X': {
+            quint64 u = 0;
+            switch (conversion.length) {
+            case NoModifier: case hh: case h: u = va_arg(ap, uint); break;
+            case l: u = va_arg(ap, ulong); break;
+            case ll: u = va_arg(ap, quint64); break;
+            case z: case t: u = va_arg(ap, size_t); break;
+            case j: case L: break;
+            }
+            appendArgument(buffer, UIntArgument, u);
+            break;
+        }
+        case 'c':
+            appendArgument(buffer, IntArgument, qint64(va_arg(ap, int)));
+            break;
+        case 's':
+            if (conversion.length == l) {
+                const ushort *string = va_arg(ap, const ushort *);
+                quint32 size = 0;
+                while (string[size])
+                    ++size;
+                appendArgument(buffer, Utf16Argument, size);
+                buffer.append(reinterpret_cast<const char *>(string), size * sizeof(ushort));
+            } else {
+                const char *string = va_arg(ap, const char *);
+                const quint32 size = string ? quint32(qstrlen(string)) : 0;
+                appendArgument(buffer, Utf8Argument, size);
+                buffer.append(string, size);
+                buffer.append('\0');
+            }
+            break;
+        case 'p':
+            appendArgument(buffer, PointerArgument, quint64(quintptr(va_arg(ap, void *))));
+            break;
+        case 'n':
+            // writes to its argument, which is gone by the time we format
+            return false;
+        default:
+            if (conversion.length == L)
+                appendArgument(buffer, DoubleArgument, double(va_arg(ap, long double)));
+            else
+                appendArgument(buffer, DoubleArgument, va_arg(ap, double));
+            break;
+        }
+    }
+    return true;
+}
+
+namespace {
+class ArgumentReader
+{
+public:
+    ArgumentReader(const char *begin, const char *end) : c(begin), end(end) { }
+
+    ArgumentTag tag() const { return c < end ? ArgumentTag(*c) : IntArgument; }
+
+    template <typename T>
+    T value()
+    {
+        T result = T();
+        if (end - c >= qsizetype(1 + sizeof(T))) {
+            memcpy(&result, c + 1, sizeof(T));
+            c += 1 + sizeof(T);
+        } else {
+            c = end;
+        }
+        return result;
+    }
+
+    const char *utf8()
+    {
+        const quint32 size = value<quint32>();
+        if (end - c < qsizetype(size) + 1) {
+            c = end;
+            return "";
+        }
+        const char *result = c;
+        c += size + 1;
+        return result;
+    }
+
+    QVarLengthArray<ushort, 256> utf16()
+    {
+        const quint32 size = value<quint32>();
+        QVarLengthArray<ushort, 256> result;
+        if (end - c < qsizetype(size * sizeof(ushort))) {
+            c = end;
+        } else {
+            result.resize(size);
+            memcpy(result.data(), c, size * sizeof(ushort));
+            c += size * sizeof(ushort);
+        }
+        result.append(0);
+        return result;
+    }
+
+private:
+    const char *c;
+    const char *const end;
+};
+} // unnamed namespace
+
+/*!
+    \internal
+
+    Formats \a format with the arguments encoded in the range from \a args to
+    \a end, producing what QString::vasprintf() returned for the original
+    arguments.
+*/
+QString QAsyncLogSinkPrivate::formatPrintf(const char *format, const char *args, const char *end)
+{
+    QString result;
+    ArgumentReader reader(args, end);
+
+    const char *c = format;
+    for (;;) {
+        const char *text = c;
+        while (*c != '\0' && *c != '%')
+            ++c;
+        result += QString::fromUtf8(text, c - text);
+        if (*c == '\0')
+            break;
+
+        const char *escapeStart = c++;
+        if (*c == '\0') {
+            result += QLatin1Char('%');
+            break;
+        }
+        if (*c == '%') {
+            result += QLatin1Char('%');
+            ++c;
+            continue;
+        }
+
+        Conversion conversion;
+        const Conversion::Result parsed = parseConversion(c, conversion);
+        if (parsed == Conversion::Incomplete) {
+            result += QLatin1String(escapeStart);
+            break;
+        }
+
+        // Rebuild the specification with the values of any '*' filled in
+        // and a length modifier matching the type the argument was stored as.
+        QByteArray spec = '%' + QByteArray(conversion.flags, conversion.width - conversion.flags);
+        if (conversion.widthFromArgument) {
+            const qint64 width = reader.value<qint64>();
+            if (width >= 0)
+                spec += QByteArray::number(width);
+        } else {
+            spec.append(conversion.width, conversion.precision - conversion.width);
+        }
+        if (conversion.precisionFromArgument) {
+            const qint64 precision = reader.value<qint64>();
+            if (precision >= 0)
+                spec += '.' + QByteArray::number(precision);
+        } else {
+            spec.append(conversion.precision, conversion.modifier - conversion.precision);
+        }
+
+        if (parsed == Conversion::Unknown) {
+            result += QLatin1String(escapeStart, c);
+            continue;
+        }
+
+        switch (conversion.specifier) {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            spec += "ll";
+            spec += conversion.specifier;
+            if (reader.tag() == UIntArgument)
+                result += QString::asprintf(spec.constData(), reader.value<quint64>());
+            else
+                result += QString::asprintf(spec.constData(), reader.value<qint64>());
+            break;
+        case 'c':
+            if (conversion.length == l)
+                spec += 'l';
+            spec += 'c';
+            result += QString::asprintf(spec.constData(), int(reader.value<qint64>()));
+            break;
+        case 's':
+            if (reader.tag() == Utf16Argument) {
+                spec += "ls";
+                result += QString::asprintf(spec.constData(), reader.utf16().constData());
+            } else {
+                spec += 's';
+                result += QString::asprintf(spec.constData(), reader.utf8());
+            }
+            break;
+        case 'p':
+            spec += 'p';
+            result += QString::asprintf(spec.constData(),
+                                        reinterpret_cast<void *>(quintptr(reader.value<quint64>())));
+            break;
+        default:
+            spec += conversion.specifier;
+            result += QString::asprintf(spec.constData(), reader.value<double>());
+            break;
+        }
+    }
+    return result;
+}
+
+static QBasicMutex registryMutex;
+static std::atomic<QAsyncLogSinkPrivate *> activeSink = {nullptr};
+// the generation of the installed sink, 0 if there is none
+static std::atomic<quint64> activeGeneration = {0};
+static quint64 lastGeneration = 0;
+
+static thread_local bool isWriterThread = false;
+static thread_local bool isThreadFinishing = false;
+static thread_local QAsyncLogRing *currentRing = nullptr;
+
+namespace {
+// Releases the thread's reference to its ring when the thread finishes.
+struct RingReleaser
+{
+    QAsyncLogRing *ring = nullptr;
+
+    ~RingReleaser()
+    {
+        isThreadFinishing = true;
+        currentRing = nullptr;
+        if (ring && !ring->ref.deref())
+            delete ring;
+    }
+};
+
+class QAsyncLogWriter : public QThread
+{
+public:
+    explicit QAsyncLogWriter(QAsyncLogSinkPrivate *d) : d(d) { }
+
+protected:
+    void run() override
+    {
+        isWriterThread = true;
+        d->run();
+    }
+
+private:
+    QAsyncLogSinkPrivate *const d;
+};
+} // unnamed namespace
+
+static thread_local RingReleaser ringReleaser;
+
+QAsyncLogRing::QAsyncLogRing(QAsyncLogSinkPrivate *sink, quint64 generation, qsizetype capacity)
+    : sink(sink),
+      generation(generation),
+      threadId(quint64(quintptr(QThread::currentThreadId()))),
+      capacity(capacity),
+      data(new char[capacity])
+{
+}
+
+/*!
+    \internal
+
+    Returns space for a record of \a size bytes, or \nullptr if the ring is
+    full. \a size must be a multiple of 8 and at most a quarter of the
+    capacity.
+*/
+QAsyncLogRecord *QAsyncLogRing::reserve(qsizetype size)
+{
+    qsizetype start = head.load(std::memory_order_relaxed);
+    const qsizetype consumed = tail.load(std::memory_order_acquire);
+    const qsizetype offset = start & (capacity - 1);
+    const qsizetype padding = capacity - offset < size ? capacity - offset : 0;
+    if (start + padding + size - consumed > capacity)
+        return nullptr;
+
+    if (padding) {
+        // records don't wrap around, mark the end of the ring as unused
+        reinterpret_cast<QAsyncLogRecord *>(data.get() + offset)->kind = QAsyncLogRecord::Padding;
+        start += padding;
+    }
+    reservedHead = start + size;
+    return reinterpret_cast<QAsyncLogRecord *>(data.get() + (start & (capacity - 1)));
+}
+
+void QAsyncLogRing::commit()
+{
+    head.store(reservedHead, std::memory_order_release);
+}
+
+static QAsyncLogRing *attachRing()
+{
+    const auto locker = qt_scoped_lock(registryMutex);
+    QAsyncLogSinkPrivate *sink = activeSink.load(std::memory_order_relaxed);
+    if (!sink)
+        return nullptr;
+
+    if (QAsyncLogRing *ring = ringReleaser.ring) {
+        ringReleaser.ring = nullptr;
+        if (!ring->ref.deref())
+            delete ring;
+    }
+
+    const qsizetype bufferSize = qMax(sink->bufferSize, qsizetype(MinimumBufferSize));
+    const qsizetype capacity = qsizetype(qNextPowerOfTwo(quint64(bufferSize - 1)));
+    QAsyncLogRing *ring = new QAsyncLogRing(sink, sink->generation, capacity);
+    {
+        const auto ringsLocker = qt_scoped_lock(sink->ringsMutex);
+        sink->rings.append(ring);
+    }
+    ringReleaser.ring = ring;
+    currentRing = ring;
+    return ring;
+}
+
+static quint32 contextStringSize(const char *string)
+{
+    return string ? quint32(qstrlen(string)) + 1 : 0;
+}
+
+template <typename Fill>
+static bool recordMessage(QtMsgType type, const QMessageLogContext &context,
+                          QAsyncLogRecord::Kind kind, qsizetype payloadSize, Fill fill)
+{
+    QAsyncLogRing *ring = currentRing;
+    if (!ring || ring->generation != activeGeneration.load(std::memory_order_relaxed)) {
+        ring = attachRing();
+        if (!ring)
+            return false;
+    }
+
+    const quint32 categorySize = contextStringSize(context.category);
+    const quint32 fileSize = contextStringSize(context.file);
+    const quint32 functionSize = contextStringSize(context.function);
+    const qsizetype size = alignedSize(sizeof(QAsyncLogRecord) + qsizetype(categorySize)
+                                       + fileSize + functionSize + payloadSize);
+    if (size > ring->capacity / 4)
+        return false;
+
+    // Pairs with QAsyncLogSink::uninstall(): either it sees us busy and
+    // waits, or we see that the ring's sink is no longer installed.
+    ring->busy.store(1);
+    if (activeGeneration.load() != ring->generation) {
+        ring->busy.store(0, std::memory_order_release);
+        return false;
+    }
+
+    bool wakeWriter = type != QtDebugMsg && type != QtInfoMsg;
+    if (QAsyncLogRecord *record = ring->reserve(size)) {
+        record->size = quint32(size);
+        record->kind = kind;
+        record->type = quint8(type);
+        record->reserved = 0;
+        record->payloadSize = quint32(payloadSize);
+        record->line = context.line;
+        record->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+        record->categorySize = categorySize;
+        record->fileSize = fileSize;
+        record->functionSize = functionSize;
+        record->reserved2 = 0;
+        char *out = reinterpret_cast<char *>(record + 1);
+        const auto appendName = [&out](const char *name, quint32 size) {
+            if (size)
+                memcpy(out, name, size);
+            out += size;
+        };
+        appendName(context.category, categorySize);
+        appendName(context.file, fileSize);
+        appendName(context.function, functionSize);
+        fill(out);
+        ring->commit();
+
+        // wake the writer up when the ring becomes half full
+        const qsizetype half = ring->capacity / 2;
+        const qsizetype used = ring->reservedHead - ring->tail.load(std::memory_order_relaxed);
+        wakeWriter = wakeWriter || (used >= half && used - size < half);
+    } else {
+        wakeWriter = ring->dropped.fetch_add(1, std::memory_order_relaxed) == 0;
+    }
+    if (wakeWriter)
+        ring->sink->wakeUp.release();
+
+    ring->busy.store(0, std::memory_order_release);
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns \c true if a sink is installed. Cheap enough to be called for
+    every message.
+*/
+bool QAsyncLogSinkPrivate::isActive() noexcept
+{
+    return activeGeneration.load(std::memory_order_relaxed) != 0;
+}
+
+/*!
+    \internal
+
+    Records the message with the printf-style \a format and its arguments
+    \a ap for the installed sink, without formatting it. Returns \c false if
+    the message was not recorded and must be passed to the message handler;
+    \a ap is left untouched in that case.
+*/
+bool QAsyncLogSinkPrivate::record(QtMsgType type, const QMessageLogContext &context,
+                                  const char *format, va_list ap)
+{
+    if (!isActive() || isWriterThread || isThreadFinishing || !format)
+        return false;
+
+    PayloadBuffer payload;
+    payload.append(format, qstrlen(format) + 1);
+    va_list args;
+    va_copy(args, ap);
+    const bool encoded = encodeArguments(format, args, payload);
+    va_end(args);
+    if (!encoded)
+        return false;
+
+    return recordMessage(type, context, QAsyncLogRecord::Printf, payload.size(),
+                         [&payload](char *out) {
+        memcpy(out, payload.constData(), payload.size());
+    });
+}
+
+/*!
+    \internal
+
+    Records \a message for the installed sink. Returns \c false if the message
+    was not recorded and must be passed to the message handler.
+*/
+bool QAsyncLogSinkPrivate::record(QtMsgType type, const QMessageLogContext &context,
+                                  const QString &message)
+{
+    if (!isActive() || isWriterThread || isThreadFinishing)
+        return false;
+
+    const qsizetype size = message.size() * qsizetype(sizeof(QChar));
+    return recordMessage(type, context, QAsyncLogRecord::Text, size, [&](char *out) {
+        memcpy(out, message.constData(), size);
+    });
+}
+
+/*!
+    \internal
+
+    Waits until the messages recorded so far have been written by the
+    installed sink, if any. Called before a fatal message ends the
+    application.
+*/
+void QAsyncLogSinkPrivate::flushInstalled()
+{
+    if (!isActive() || isWriterThread)
+        return;
+
+    const auto locker = qt_scoped_lock(registryMutex);
+    if (QAsyncLogSinkPrivate *sink = activeSink.load(std::memory_order_relaxed))
+        sink->flush();
+}
+
+void QAsyncLogSinkPrivate::run()
+{
+    for (;;) {
+        const bool stop = stopping.load(std::memory_order_acquire);
+        quint64 requested;
+        {
+            const auto locker = qt_scoped_lock(flushMutex);
+            requested = flushRequested;
+        }
+
+        drain();
+        if (!output.isEmpty()) {
+            file.write(output);
+            output.truncate(0);
+        }
+
+        {
+            const auto locker = qt_scoped_lock(flushMutex);
+            if (flushCompleted != requested) {
+                flushCompleted = requested;
+                flushed.wakeAll();
+            }
+        }
+
+        if (stop)
+            break;
+        if (wakeUp.tryAcquire(1, WriterInterval))
+            wakeUp.tryAcquire(wakeUp.available());
+    }
+}
+
+void QAsyncLogSinkPrivate::drain()
+{
+    QList<QAsyncLogRing *> current;
+    {
+        const auto locker = qt_scoped_lock(ringsMutex);
+        current = rings;
+    }
+
+    for (QAsyncLogRing *ring : qAsConst(current)) {
+        // a thread that has finished has released its reference
+        const bool finished = ring->ref.loadAcquire() == 1;
+        const qsizetype mask = ring->capacity - 1;
+        const qsizetype head = ring->head.load(std::memory_order_acquire);
+        qsizetype tail = ring->tail.load(std::memory_order_relaxed);
+        while (tail != head) {
+            const auto *record = reinterpret_cast<const QAsyncLogRecord *>(ring->data.get() + (tail & mask));
+            if (record->kind == QAsyncLogRecord::Padding) {
+                tail = (tail | mask) + 1;
+                continue;
+            }
+            processRecord(ring, record);
+            tail += record->size;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+
+        if (const quint64 dropped = ring->dropped.exchange(0, std::memory_order_relaxed))
+            processDropped(ring, dropped);
+
+        if (finished) {
+            {
+                const auto locker = qt_scoped_lock(ringsMutex);
+                rings.removeOne(ring);
+            }
+            delete ring;
+        }
+    }
+}
+
+void QAsyncLogSinkPrivate::flush()
+{
+    auto locker = qt_unique_lock(flushMutex);
+    if (!writerRunning)
+        return;
+    const quint64 target = ++flushRequested;
+    wakeUp.release();
+    while (flushCompleted < target)
+        flushed.wait(locker.mutex());
+}
+
+void QAsyncLogSinkPrivate::processRecord(const QAsyncLogRing *ring, const QAsyncLogRecord *record)
+{
+    const char *payload = record->payload();
+    if (fileName.isEmpty()) {
+        QString message;
+        if (record->kind == QAsyncLogRecord::Printf) {
+            const char *args = payload + qstrlen(payload) + 1;
+            message = formatPrintf(payload, args, payload + record->payloadSize);
+        } else {
+            message = QString(reinterpret_cast<const QChar *>(payload),
+                              record->payloadSize / sizeof(QChar));
+        }
+        const QMessageLogContext context(record->file(), record->line, record->function(),
+                                         record->category());
+        QtPrivate::printMessage(QtMsgType(record->type), context, message);
+        return;
+    }
+
+    FileMessage message = {};
+    message.category = stringId(record->category());
+    message.file = stringId(record->file());
+    message.function = stringId(record->function());
+    message.header.size = quint32(alignedSize(sizeof(message) + record->payloadSize));
+    message.header.kind = MessageRecord;
+    message.type = record->type;
+    message.payloadKind = record->kind;
+    message.payloadSize = record->payloadSize;
+    message.line = record->line;
+    message.timestamp = record->timestamp;
+    message.threadId = ring->threadId;
+    output.append(reinterpret_cast<const char *>(&message), sizeof(message));
+    output.append(payload, record->payloadSize);
+    output.append(qsizetype(message.header.size - sizeof(message) - record->payloadSize), '\0');
+}
+
+void QAsyncLogSinkPrivate::processDropped(const QAsyncLogRing *ring, quint64 count)
+{
+    droppedCount.fetch_add(count, std::memory_order_relaxed);
+
+    if (fileName.isEmpty()) {
+        const QMessageLogContext context(nullptr, 0, nullptr, droppedCategory);
+        const QString message = QString::asprintf("QAsyncLogSink: dropped %llu messages from thread 0x%llx",
+                                                  count, ring->threadId);
+        QtPrivate::printMessage(QtWarningMsg, context, message);
+        return;
+    }
+
+    FileDropped dropped = {};
+    dropped.header.size = sizeof(dropped);
+    dropped.header.kind = DroppedRecord;
+    dropped.threadId = ring->threadId;
+    dropped.count = count;
+    output.append(reinterpret_cast<const char *>(&dropped), sizeof(dropped));
+}
+
+// Returns the id of \a string in the binary log, writing a string record the
+// first time it is seen.
+quint32 QAsyncLogSinkPrivate::stringId(const char *string)
+{
+    if (!string)
+        return 0;
+    const QByteArray key = QByteArray::fromRawData(string, qstrlen(string));
+    const auto it = stringIds.constFind(key);
+    if (it != stringIds.constEnd())
+        return *it;
+
+    const quint32 id = quint32(stringIds.size()) + 1;
+    // a deep copy, the record holding the string is about to be reused
+    stringIds.insert(QByteArray(key.constData(), key.size()), id);
+
+    FileString record = {};
+    record.id = id;
+    record.length = quint32(key.size());
+    record.header.size = quint32(alignedSize(sizeof(record) + record.length));
+    record.header.kind = StringRecord;
+    output.append(reinterpret_cast<const char *>(&record), sizeof(record));
+    output.append(string, record.length);
+    output.append(qsizetype(record.header.size - sizeof(record) - record.length), '\0');
+    return id;
+}
+
+/*!
+    Constructs a sink that passes the messages on to the message handler from
+    a background thread.
+
+    \sa qInstallMessageHandler()
+*/
+QAsyncLogSink::QAsyncLogSink()
+    : d(new QAsyncLogSinkPrivate(QString()))
+{
+}
+
+/*!
+    Constructs a sink that writes the messages to the binary log \a fileName.
+    The file is created, or truncated, by install().
+
+    \sa decode()
+*/
+QAsyncLogSink::QAsyncLogSink(const QString &fileName)
+    : d(new QAsyncLogSinkPrivate(fileName))
+{
+}
+
+/*!
+    Destroys the sink, uninstalling it first if it is installed.
+*/
+QAsyncLogSink::~QAsyncLogSink()
+{
+    uninstall();
+}
+
+/*!
+    Returns the name of the binary log, or an empty string if the sink passes
+    the messages on to the message handler.
+*/
+QString QAsyncLogSink::fileName() const
+{
+    return d->fileName;
+}
+
+/*!
+    Returns the size, in bytes, of the buffer each logging thread records its
+    messages in. The default is 256 KiB.
+
+    \sa setBufferSize()
+*/
+qsizetype QAsyncLogSink::bufferSize() const
+{
+    const auto locker = qt_scoped_lock(registryMutex);
+    return d->bufferSize;
+}
+
+/*!
+    Sets the size of the buffer each logging thread records its messages in
+    to \a size bytes, rounded up to a power of two of at least 4 KiB. Threads
+    that have already logged a message keep their buffer until the sink is
+    installed again.
+
+    A larger buffer absorbs larger bursts of messages without dropping any,
+    at the cost of memory for every thread that logs.
+
+    \sa droppedMessageCount()
+*/
+void QAsyncLogSink::setBufferSize(qsizetype size)
+{
+    const auto locker = qt_scoped_lock(registryMutex);
+    d->bufferSize = size;
+}
+
+/*!
+    Installs the sink, starting its background thread, and returns \c true on
+    success. Returns \c false if another sink is installed or if the binary
+    log cannot be created.
+
+    \sa uninstall()
+*/
+bool QAsyncLogSink::install()
+{
+    const auto locker = qt_scoped_lock(registryMutex);
+    if (QAsyncLogSinkPrivate *sink = activeSink.load(std::memory_order_relaxed))
+        return sink == d.data();
+
+    if (!d->fileName.isEmpty()) {
+        d->file.setFileName(d->fileName);
+        if (!d->file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered))
+            return false;
+        if (d->file.write(reinterpret_cast<const char *>(&fileHeader), sizeof(fileHeader))
+                != qint64(sizeof(fileHeader))) {
+            d->file.close();
+            return false;
+        }
+    }
+
+    d->generation = ++lastGeneration;
+    d->stopping.store(false, std::memory_order_relaxed);
+    {
+        const auto flushLocker = qt_scoped_lock(d->flushMutex);
+        d->writerRunning = true;
+    }
+    d->writer.reset(new QAsyncLogWriter(d.data()));
+    d->writer->setObjectName(QStringLiteral("QAsyncLogSink"));
+    d->writer->start();
+
+    activeSink.store(d.data());
+    activeGeneration.store(d->generation);
+    return true;
+}
+
+/*!
+    Uninstalls the sink, if it is installed, after writing the messages
+    recorded so far. Messages emitted from now on take the usual path to the
+    message handler.
+
+    This function must not be called from the message handler.
+
+    \sa install()
+*/
+void QAsyncLogSink::uninstall()
+{
+    const auto locker = qt_scoped_lock(registryMutex);
+    if (activeSink.load(std::memory_order_relaxed) != d.data())
+        return;
+
+    activeGeneration.store(0);
+    activeSink.store(nullptr);
+    {
+        // wait for the threads that are recording a message right now
+        const auto ringsLocker = qt_scoped_lock(d->ringsMutex);
+        for (const QAsyncLogRing *ring : qAsConst(d->rings)) {
+            while (ring->busy.load())
+                QThread::yieldCurrentThread();
+        }
+    }
+
+    d->stopping.store(true, std::memory_order_release);
+    d->wakeUp.release();
+    d->writer->wait();
+    d->writer.reset();
+    {
+        const auto flushLocker = qt_scoped_lock(d->flushMutex);
+        d->writerRunning = false;
+        d->flushCompleted = d->flushRequested;
+        d->flushed.wakeAll();
+    }
+
+    // The threads still hold a reference to their rings; they get a new one
+    // the next time they log a message.
+    for (QAsyncLogRing *ring : qAsConst(d->rings)) {
+        ring->data.reset();
+        if (!ring->ref.deref())
+            delete ring;
+    }
+    d->rings.clear();
+    d->stringIds.clear();
+    d->output.clear();
+    d->wakeUp.tryAcquire(d->wakeUp.available());
+    if (d->file.isOpen())
+        d->file.close();
+}
+
+/*!
+    Returns \c true if the sink is installed.
+*/
+bool QAsyncLogSink::isInstalled() const
+{
+    return activeSink.load() == d.data();
+}
+
+/*!
+    Waits until the messages recorded so far have been written to the binary
+    log or passed to the message handler. Does nothing if the sink is not
+    installed.
+*/
+void QAsyncLogSink::flush()
+{
+    if (isWriterThread)
+        return;
+    d->flush();
+}
+
+/*!
+    Returns the number of messages dropped so far because a thread's buffer
+    was full. Call flush() first to include the messages dropped most
+    recently.
+
+    \sa bufferSize()
+*/
+quint64 QAsyncLogSink::droppedMessageCount() const
+{
+    return d->droppedCount.load(std::memory_order_relaxed);
+}
+
+static QByteArray stringForId(const QHash<quint32, QByteArray> &strings, quint32 id)
+{
+    return id ? strings.value(id) : QByteArray();
+}
+
+static QByteArray formatTimestamp(qint64 timestamp)
+{
+    const qint64 msecs = timestamp / 1000000;
+#if QT_CONFIG(datestring)
+    return QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC).toString(Qt::ISODateWithMs).toLatin1();
+#else
+    return QByteArray::number(msecs);
+#endif
+}
+
+/*!
+    Reads the binary log written by a sink from \a binaryLog and writes it to
+    \a output as UTF-8 text, one line per message. Returns \c false if
+    \a binaryLog is not a binary log, or is corrupt.
+
+    Each line holds the time in UTC, the type, the thread id, the category,
+    the message and, if known, the file and line it was emitted from:
+
+    \badcode
+    2020-06-01T09:30:00.123Z warning [0x7f1c2e7fc700] app.network: connection refused (client.cpp:128)
+    \endcode
+*/
+bool QAsyncLogSink::decode(QIODevice *binaryLog, QIODevice *output)
+{
+    static const char *const typeNames[] = { "debug", "warning", "critical", "fatal", "info" };
+
+    FileHeader header;
+    if (binaryLog->read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))
+            || memcmp(&header, &fileHeader, sizeof(header)) != 0) {
+        return false;
+    }
+
+    QHash<quint32, QByteArray> strings;
+    QByteArray record;
+    for (;;) {
+        FileRecord prefix;
+        const qint64 read = binaryLog->read(reinterpret_cast<char *>(&prefix), sizeof(prefix));
+        if (read == 0)
+            return true;
+        if (read != qint64(sizeof(prefix)) || prefix.size < sizeof(prefix) || prefix.size % 8
+                || prefix.size > MaxFileRecordSize) {
+            return false;
+        }
+        record.resize(prefix.size);
+        memcpy(record.data(), &prefix, sizeof(prefix));
+        const qint64 rest = prefix.size - sizeof(prefix);
+        if (binaryLog->read(record.data() + sizeof(prefix), rest) != rest)
+            return false;
+
+        QByteArray line;
+        switch (prefix.kind) {
+        case QAsyncLogSinkPrivate::StringRecord: {
+            FileString string;
+            if (record.size() < qsizetype(sizeof(string)))
+                return false;
+            memcpy(&string, record.constData(), sizeof(string));
+            if (string.length > record.size() - sizeof(string))
+                return false;
+            strings.insert(string.id, record.mid(sizeof(string), string.length));
+            break;
+        }
+        case QAsyncLogSinkPrivate::MessageRecord: {
+            FileMessage message;
+            if (record.size() < qsizetype(sizeof(message)))
+                return false;
+            memcpy(&message, record.constData(), sizeof(message));
+            if (message.payloadSize > record.size() - sizeof(message))
+                return false;
+
+            const char *payload = record.constData() + sizeof(message);
+            QString text;
+            if (message.payloadKind == QAsyncLogRecord::Printf) {
+                const char *end = payload + message.payloadSize;
+                const char *formatEnd = static_cast<const char *>(memchr(payload, '\0', message.payloadSize));
+                if (!formatEnd)
+                    return false;
+                text = QAsyncLogSinkPrivate::formatPrintf(payload, formatEnd + 1, end);
+            } else {
+                text = QString(reinterpret_cast<const QChar *>(payload),
+                               message.payloadSize / sizeof(QChar));
+            }
+
+            QByteArray category = stringForId(strings, message.category);
+            if (category.isEmpty())
+                category = "default";
+            line = formatTimestamp(message.timestamp) + ' '
+                    + (message.type < std::size(typeNames) ? typeNames[message.type] : "unknown")
+                    + " [0x" + QByteArray::number(message.threadId, 16) + "] "
+                    + category + ": " + text.toUtf8();
+            const QByteArray file = stringForId(strings, message.file);
+            if (!file.isEmpty())
+                line += " (" + file + ':' + QByteArray::number(message.line) + ')';
+            break;
+        }
+        case QAsyncLogSinkPrivate::DroppedRecord: {
+            FileDropped dropped;
+            if (record.size() < qsizetype(sizeof(dropped)))
+                return false;
+            memcpy(&dropped, record.constData(), sizeof(dropped));
+            line = "[0x" + QByteArray::number(dropped.threadId, 16) + "] "
+                    + droppedCategory + ": dropped " + QByteArray::number(dropped.count)
+                    + " messages";
+            break;
+        }
+        default:
+            // written by a later version, skip it
+            break;
+        }
+
+        if (!line.isNull()) {
+            line += '\n';
+            if (output->write(line) != line.size())
+                return false;
+        }
+    }
+}
+
+QT_END_NAMESPACE
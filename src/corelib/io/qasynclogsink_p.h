@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QASYNCLOGSINK_P_H
+#define QASYNCLOGSINK_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qasynclogsink.h"
+
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qsemaphore.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/private/qglobal_p.h>
+
+#include <atomic>
+#include <memory>
+
+#include <stdarg.h>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class QAsyncLogSinkPrivate;
+
+// A message as recorded by the logging thread, followed by the category,
+// file and function names of its QMessageLogContext, then its payload: the
+// UTF-16 text, or the printf-style format and its encoded arguments. The
+// names are copied, as nothing guarantees they outlive the message.
+struct QAsyncLogRecord
+{
+    enum Kind : quint8 {
+        Padding,    // the rest of the ring is unused, continue at its start
+        Text,
+        Printf
+    };
+
+    quint32 size;           // including the header, a multiple of 8
+    quint8 kind;
+    quint8 type;            // QtMsgType
+    quint16 reserved;
+    quint32 payloadSize;
+    qint32 line;
+    qint64 timestamp;       // nanoseconds since the epoch
+    // including the terminating null, 0 for a null name
+    quint32 categorySize;
+    quint32 fileSize;
+    quint32 functionSize;
+    quint32 reserved2;
+
+    const char *category() const { return string(0, categorySize); }
+    const char *file() const { return string(categorySize, fileSize); }
+    const char *function() const { return string(categorySize + fileSize, functionSize); }
+    const char *payload() const { return names() + categorySize + fileSize + functionSize; }
+
+private:
+    const char *names() const { return reinterpret_cast<const char *>(this + 1); }
+    const char *string(quint32 offset, quint32 size) const { return size ? names() + offset : nullptr; }
+};
+
+// Written by one logging thread, read by the writer thread.
+class QAsyncLogRing
+{
+    Q_DISABLE_COPY_MOVE(QAsyncLogRing)
+public:
+    QAsyncLogRing(QAsyncLogSinkPrivate *sink, quint64 generation, qsizetype capacity);
+
+    QAsyncLogRecord *reserve(qsizetype size);
+    void commit();
+
+    QAsyncLogSinkPrivate * const sink;
+    const quint64 generation;
+    const quint64 threadId;
+    const qsizetype capacity;   // a power of two
+    std::unique_ptr<char[]> data;
+
+    // one reference for the thread, one for the sink
+    QAtomicInt ref = 2;
+    std::atomic<quint64> dropped = {0};
+
+    // set while the thread is recording, see QAsyncLogSink::uninstall()
+    alignas(64) std::atomic<int> busy = {0};
+    qsizetype reservedHead = 0;
+    alignas(64) std::atomic<qsizetype> head = {0};
+    alignas(64) std::atomic<qsizetype> tail = {0};
+};
+
+class QAsyncLogSinkPrivate
+{
+public:
+    enum RecordKind : quint8 {
+        StringRecord = 1,
+        MessageRecord,
+        DroppedRecord
+    };
+
+    explicit QAsyncLogSinkPrivate(const QString &fileName) : fileName(fileName) { }
+
+    // Called by qlogging.cpp. They return false if the message must take the
+    // usual path to the message handler.
+    static bool isActive() noexcept;
+    static bool record(QtMsgType type, const QMessageLogContext &context, const char *format,
+                       va_list ap);
+    static bool record(QtMsgType type, const QMessageLogContext &context, const QString &message);
+    static void flushInstalled();
+
+    static QString formatPrintf(const char *format, const char *args, const char *end);
+
+    void run();
+    void drain();
+    void flush();
+    void processRecord(const QAsyncLogRing *ring, const QAsyncLogRecord *record);
+    void processDropped(const QAsyncLogRing *ring, quint64 count);
+    quint32 stringId(const char *string);
+
+    const QString fileName;
+    QFile file;
+    QByteArray output;
+    QHash<QByteArray, quint32> stringIds;
+    qsizetype bufferSize = 256 * 1024;
+
+    quint64 generation = 0;
+    QMutex ringsMutex;
+    QList<QAsyncLogRing *> rings;
+    std::unique_ptr<QThread> writer;
+    QSemaphore wakeUp;
+    std::atomic<bool> stopping = {false};
+    std::atomic<quint64> droppedCount = {0};
+
+    QMutex flushMutex;
+    QWaitCondition flushed;
+    quint64 flushRequested = 0;
+    quint64 flushCompleted = 0;
+    bool writerRunning = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QASYNCLOGSINK_P_H
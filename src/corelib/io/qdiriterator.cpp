@@ -87,6 +87,25 @@
     enables iterating through all subdirectories of the assigned path,
     following all symbolic links. Symbolic link loops (e.g., "link" => "." or
     "link" => "..") are automatically detected and ignored.
+
+    \value ParallelScan Scan directories on worker threads of
+    QThreadPool::globalInstance() while the entries found so far are being
+    consumed. Combined with Subdirectories, the subdirectories are scanned in
+    parallel. Entries are returned in no particular order, and hasNext()
+    blocks until the next one has been found. On Linux, directories are read
+    in large batches and the file type of entries the directory listing
+    doesn't report (symbolic links, or file systems not providing it) is
+    queried with \c{statx(AT_STATX_DONT_SYNC)}, so network file systems can
+    answer from their caches. This flag has no effect for paths handled by a
+    custom file engine, or if Qt was built without thread support. This
+    value was introduced in Qt 6.0.
+
+    \value PrefetchMetaData When combined with ParallelScan, also fetch the
+    size, timestamps, permissions and owner of each entry on the scanning
+    thread, so that the corresponding QFileInfo getters return without
+    touching the file system. This value was introduced in Qt 6.0.
+
+    \sa nextBatch()
 */
 
 #include "qdiriterator.h"
@@ -96,6 +115,12 @@
 #include <QtCore/qset.h>
 #include <QtCore/qstack.h>
 #include <QtCore/qvariant.h>
+#if QT_CONFIG(thread)
+#include <QtCore/qmutex.h>
+#include <QtCore/qqueue.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qwaitcondition.h>
+#endif
 #if QT_CONFIG(regularexpression)
 #include <QtCore/qregularexpression.h>
 #endif
@@ -121,6 +146,47 @@ public:
     }
 };
 
+#if QT_CONFIG(thread) && !defined(QT_NO_FILESYSTEMITERATOR)
+#define QT_DIRITERATOR_PARALLEL_SCAN
+
+class QDirIteratorPrivate;
+
+class QDirIteratorScanner
+{
+public:
+    enum {
+        BatchSize = 256,
+        MaxQueuedBatches = 64
+    };
+
+    explicit QDirIteratorScanner(QDirIteratorPrivate *d) : d(d) { }
+    ~QDirIteratorScanner();
+
+    void enqueue(const QFileSystemEntry &dirEntry);
+    void publish(QFileInfoList &batch, bool mayBlock);
+    QFileInfoList takeBatch();
+    bool isCanceled() const { return canceled.loadRelaxed(); }
+
+    QMutex visitedLinksMutex;
+
+private:
+    void work();
+
+    QDirIteratorPrivate *d;
+
+    QMutex mutex;
+    QWaitCondition batchReady;  // also signalled when a directory is queued or a worker exits
+    QWaitCondition batchTaken;
+    QQueue<QFileSystemEntry> directories;
+    QQueue<QFileInfoList> batches;
+    int workers = 0;
+    int scanning = 0;
+    QAtomicInt canceled;
+
+    Q_DISABLE_COPY_MOVE(QDirIteratorScanner)
+};
+#endif
+
 class QDirIteratorPrivate
 {
 public:
@@ -132,7 +198,12 @@ public:
     bool entryMatches(const QString & fileName, const QFileInfo &fileInfo);
     void pushDirectory(const QFileInfo &fileInfo);
     void checkAndPushDirectory(const QFileInfo &);
+    bool shouldDescendInto(const QFileInfo &fileInfo) const;
     bool matchesFilters(const QString &fileName, const QFileInfo &fi) const;
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    void scanDirectory(const QFileSystemEntry &entry, bool mayBlock);
+    bool fetchBatch();
+#endif
 
     std::unique_ptr<QAbstractFileEngine> engine;
 
@@ -155,6 +226,13 @@ public:
 
     // Loop protection
     QDuplicateTracker<QString> visitedLinks;
+
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    QFileInfoList batch;
+    qsizetype batchIndex = 0;
+    // last, so that the workers are gone before anything they use
+    std::unique_ptr<QDirIteratorScanner> scanner;
+#endif
 };
 
 /*!
@@ -180,6 +258,15 @@ QDirIteratorPrivate::QDirIteratorPrivate(const QFileSystemEntry &entry, const QS
         engine.reset(QFileSystemEngine::resolveEntryAndCreateLegacyEngine(dirEntry, metaData));
     QFileInfo fileInfo(new QFileInfoPrivate(dirEntry, metaData));
 
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    if (!engine && (flags & QDirIterator::ParallelScan)) {
+        // hasNext() waits for the entries to come in
+        scanner.reset(new QDirIteratorScanner(this));
+        pushDirectory(fileInfo);
+        return;
+    }
+#endif
+
     // Populate fields for hasNext() and next()
     pushDirectory(fileInfo);
     advance();
@@ -199,10 +286,21 @@ void QDirIteratorPrivate::pushDirectory(const QFileInfo &fileInfo)
 
     if ((iteratorFlags & QDirIterator::FollowSymlinks)) {
         // Stop link loops
-        if (visitedLinks.hasSeen(fileInfo.canonicalFilePath()))
+        const QString canonicalPath = fileInfo.canonicalFilePath();
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+        QMutexLocker locker(scanner ? &scanner->visitedLinksMutex : nullptr);
+#endif
+        if (visitedLinks.hasSeen(canonicalPath))
             return;
     }
 
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    if (scanner) {
+        scanner->enqueue(fileInfo.d_ptr->fileEntry);
+        return;
+    }
+#endif
+
     if (engine) {
         engine->setFileName(path);
         QAbstractFileEngineIterator *it = engine->beginEntryList(filters, nameFilters);
@@ -243,6 +341,13 @@ inline bool QDirIteratorPrivate::entryMatches(const QString & fileName, const QF
 */
 void QDirIteratorPrivate::advance()
 {
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    if (scanner) {
+        currentFileInfo = fetchBatch() ? batch.at(batchIndex++) : QFileInfo();
+        return;
+    }
+#endif
+
     if (engine) {
         while (!fileEngineIterators.isEmpty()) {
             // Find the next valid iterator that matches the filters.
@@ -286,31 +391,168 @@ void QDirIteratorPrivate::advance()
     \internal
  */
 void QDirIteratorPrivate::checkAndPushDirectory(const QFileInfo &fileInfo)
+{
+    if (shouldDescendInto(fileInfo))
+        pushDirectory(fileInfo);
+}
+
+/*!
+    \internal
+ */
+bool QDirIteratorPrivate::shouldDescendInto(const QFileInfo &fileInfo) const
 {
     // If we're doing flat iteration, we're done.
     if (!(iteratorFlags & QDirIterator::Subdirectories))
-        return;
+        return false;
 
     // Never follow non-directory entries
     if (!fileInfo.isDir())
-        return;
+        return false;
 
     // Follow symlinks only when asked
     if (!(iteratorFlags & QDirIterator::FollowSymlinks) && fileInfo.isSymLink())
-        return;
+        return false;
 
     // Never follow . and ..
     QString fileName = fileInfo.fileName();
     if (QLatin1String(".") == fileName || QLatin1String("..") == fileName)
-        return;
+        return false;
 
     // No hidden directories unless requested
     if (!(filters & QDir::AllDirs) && !(filters & QDir::Hidden) && fileInfo.isHidden())
+        return false;
+
+    return true;
+}
+
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+/*!
+    \internal
+
+    Lists \a entry for ParallelScan, queueing the subdirectories to descend
+    into and publishing the matching entries in batches. Runs on a worker
+    thread, or with \a mayBlock set to false on the iterating thread when it
+    has run out of entries.
+*/
+void QDirIteratorPrivate::scanDirectory(const QFileSystemEntry &entry, bool mayBlock)
+{
+    QFileSystemIterator it(entry, filters, nameFilters, iteratorFlags);
+    QFileSystemEntry nextEntry;
+    QFileSystemMetaData nextMetaData;
+    QFileInfoList found;
+    found.reserve(QDirIteratorScanner::BatchSize);
+
+    while (!scanner->isCanceled() && it.advance(nextEntry, nextMetaData)) {
+        QFileInfo info(new QFileInfoPrivate(nextEntry, nextMetaData));
+        checkAndPushDirectory(info);
+        if (matchesFilters(nextEntry.fileName(), info)) {
+            found.append(std::move(info));
+            if (found.size() == QDirIteratorScanner::BatchSize) {
+                scanner->publish(found, mayBlock);
+                found.reserve(QDirIteratorScanner::BatchSize);
+            }
+        }
+        nextMetaData = QFileSystemMetaData();
+    }
+    scanner->publish(found, mayBlock);
+}
+
+/*!
+    \internal
+
+    Makes sure batch has an entry at batchIndex, waiting for the scanner if
+    needed. Returns \c false once the scan is complete.
+*/
+bool QDirIteratorPrivate::fetchBatch()
+{
+    if (batchIndex < batch.size())
+        return true;
+    batch = scanner->takeBatch();
+    batchIndex = 0;
+    return !batch.isEmpty();
+}
+
+QDirIteratorScanner::~QDirIteratorScanner()
+{
+    QMutexLocker locker(&mutex);
+    canceled.storeRelaxed(1);
+    directories.clear();
+    batchTaken.wakeAll();
+    while (workers > 0)
+        batchReady.wait(&mutex);
+}
+
+void QDirIteratorScanner::enqueue(const QFileSystemEntry &dirEntry)
+{
+    QMutexLocker locker(&mutex);
+    directories.enqueue(dirEntry);
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    if (workers < pool->maxThreadCount() && pool->tryStart([this] { work(); }))
+        ++workers;
+
+    // if no worker could be started, the iterating thread does the work
+    batchReady.wakeAll();
+}
+
+void QDirIteratorScanner::work()
+{
+    QMutexLocker locker(&mutex);
+    while (!isCanceled() && !directories.isEmpty()) {
+        const QFileSystemEntry dirEntry = directories.dequeue();
+        ++scanning;
+        locker.unlock();
+        d->scanDirectory(dirEntry, true);
+        locker.relock();
+        --scanning;
+    }
+    --workers;
+    batchReady.wakeAll();
+}
+
+void QDirIteratorScanner::publish(QFileInfoList &found, bool mayBlock)
+{
+    if (found.isEmpty())
         return;
 
-    pushDirectory(fileInfo);
+    QMutexLocker locker(&mutex);
+    // Don't let the workers run arbitrarily far ahead of the iterating
+    // thread; it never waits here, as nobody else would take the batches.
+    while (mayBlock && batches.size() >= MaxQueuedBatches && !isCanceled())
+        batchTaken.wait(&mutex);
+    batches.enqueue(std::move(found));
+    found = QFileInfoList();
+    batchReady.wakeAll();
 }
 
+QFileInfoList QDirIteratorScanner::takeBatch()
+{
+    QMutexLocker locker(&mutex);
+    for (;;) {
+        if (!batches.isEmpty()) {
+            QFileInfoList found = batches.dequeue();
+            batchTaken.wakeAll();
+            return found;
+        }
+        if (!directories.isEmpty()) {
+            // Rather than wait for the pool to get around to it, scan the
+            // directory here. This also means the scan completes when every
+            // thread of the pool is busy, possibly with the caller itself.
+            const QFileSystemEntry dirEntry = directories.dequeue();
+            ++scanning;
+            locker.unlock();
+            d->scanDirectory(dirEntry, false);
+            locker.relock();
+            --scanning;
+            continue;
+        }
+        if (scanning == 0)
+            return QFileInfoList();
+        batchReady.wait(&mutex);
+    }
+}
+#endif // QT_DIRITERATOR_PARALLEL_SCAN
+
 /*!
     \internal
 
@@ -509,6 +751,10 @@ QString QDirIterator::next()
 */
 bool QDirIterator::hasNext() const
 {
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    if (d->scanner)
+        return d->fetchBatch();
+#endif
     if (d->engine)
         return !d->fileEngineIterators.isEmpty();
     else
@@ -519,6 +765,56 @@ bool QDirIterator::hasNext() const
 #endif
 }
 
+/*!
+    \since 6.0
+
+    Advances the iterator by up to \a maxCount entries and returns a QFileInfo
+    for each of them. Afterwards, fileInfo() refers to the last entry in the
+    returned list.
+
+    With ParallelScan, this returns the entries that have been found so far,
+    only waiting if there are none yet, so the list may be shorter than \a
+    maxCount even though hasNext() would still return \c true. Without it,
+    this is equivalent to calling next() and fileInfo() \a maxCount times.
+    An empty list is returned once the iteration is complete.
+
+    \snippet code/src_corelib_io_qdiriterator.cpp 3
+
+    \sa next(), hasNext(), ParallelScan
+*/
+QFileInfoList QDirIterator::nextBatch(qsizetype maxCount)
+{
+    QFileInfoList result;
+    if (maxCount <= 0)
+        return result;
+
+#ifdef QT_DIRITERATOR_PARALLEL_SCAN
+    if (d->scanner) {
+        if (!d->fetchBatch())
+            return result;
+        if (d->batchIndex == 0 && d->batch.size() <= maxCount) {
+            result.swap(d->batch);
+        } else {
+            const qsizetype count = qMin(maxCount, d->batch.size() - d->batchIndex);
+            result = d->batch.mid(d->batchIndex, count);
+            d->batchIndex += count;
+        }
+        if (d->batchIndex >= d->batch.size()) {
+            d->batch.clear();
+            d->batchIndex = 0;
+        }
+        d->currentFileInfo = result.constLast();
+        return result;
+    }
+#endif
+
+    while (result.size() < maxCount && hasNext()) {
+        d->advance();
+        result.append(d->currentFileInfo);
+    }
+    return result;
+}
+
 /*!
     Returns the file name for the current directory entry, without the path
     prepended.
@@ -51,7 +51,9 @@ public:
     enum IteratorFlag {
         NoIteratorFlags = 0x0,
         FollowSymlinks = 0x1,
-        Subdirectories = 0x2
+        Subdirectories = 0x2,
+        ParallelScan = 0x4,
+        PrefetchMetaData = 0x8
     };
     Q_DECLARE_FLAGS(IteratorFlags, IteratorFlag)
 
@@ -70,6 +72,7 @@ public:
 
     QString next();
     bool hasNext() const;
+    QFileInfoList nextBatch(qsizetype maxCount = 1024);
 
     QString fileName() const;
     QString filePath() const;
@@ -648,13 +648,15 @@ QFile::rename(const QString &newName)
         if (open(QIODevice::ReadOnly)) {
             if (out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
                 bool error = false;
-                char block[4096];
-                qint64 bytes;
-                while ((bytes = read(block, sizeof(block))) > 0) {
-                    if (bytes != out.write(block, bytes)) {
-                        d->setError(QFile::RenameError, out.errorString());
-                        error = true;
-                        break;
+                qint64 bytes = 0;
+                if (!d->engine()->cloneTo(out.d_func()->engine())) {
+                    QByteArray block(256 * 1024, Qt::Uninitialized);
+                    while ((bytes = read(block.data(), block.size())) > 0) {
+                        if (bytes != out.write(block.constData(), bytes)) {
+                            d->setError(QFile::RenameError, out.errorString());
+                            error = true;
+                            break;
+                        }
                     }
                 }
                 if (bytes == -1) {
@@ -814,14 +816,16 @@ QFile::copy(const QString &newName)
                     d->setError(QFile::CopyError, tr("Cannot open for output: %1").arg(out.errorString()));
                 } else {
                     if (!d->engine()->cloneTo(out.d_func()->engine())) {
-                        char block[4096];
+                        // large enough to bypass QFile's buffer and keep the
+                        // number of system calls low
+                        QByteArray block(256 * 1024, Qt::Uninitialized);
                         qint64 totalRead = 0;
                         while (!atEnd()) {
-                            qint64 in = read(block, sizeof(block));
+                            qint64 in = read(block.data(), block.size());
                             if (in <= 0)
                                 break;
                             totalRead += in;
-                            if (in != out.write(block, in)) {
+                            if (in != out.write(block.constData(), in)) {
                                 close();
                                 d->setError(QFile::CopyError, tr("Failure to write block"));
                                 error = true;
@@ -0,0 +1,585 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qplatformdefs.h"
+#include "qfilecopier.h"
+#include "qfilecopier_p.h"
+
+#include <QtCore/qdir.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qthreadpool.h>
+#include <QtCore/private/qlocking_p.h>
+
+#ifdef Q_OS_UNIX
+#include <QtCore/private/qcore_unix_p.h>
+#include <QtCore/private/qfilesystemengine_p.h>
+#include <QtCore/private/qsystemerror_p.h>
+#endif
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QFileCopier
+    \inmodule QtCore
+    \since 6.0
+    \brief The QFileCopier class copies files and directory trees, reporting
+    progress and allowing the operation to be canceled.
+
+    \ingroup io
+
+    QFileCopier copies a single file, like QFile::copy() does, or a whole
+    directory tree. Directories, files and symbolic links are recreated in
+    the destination; a symbolic link is copied as a link, with the same
+    target, rather than as the file it points to. Other special files, such
+    as sockets and device nodes, are skipped.
+
+    Where the platform allows it, the data is copied by the kernel without
+    passing through user space: on Linux, the file is cloned if the file
+    system supports it, and otherwise copied with \c copy_file_range() or
+    \c sendfile(). Holes in sparse files are preserved. Elsewhere, the data
+    is copied through a large buffer.
+
+    The files of a directory tree are copied in parallel, using up to
+    maxThreadCount() threads, including the one calling copy(). The thread
+    calling copy() emits progress() periodically; a slot connected to it can
+    call cancel() to stop the operation.
+
+    \snippet code/src_corelib_io_qfilecopier.cpp 0
+
+    \sa QFile::copy(), QDirIterator
+*/
+
+/*!
+    \enum QFileCopier::CopyFlag
+
+    This enum describes the options for copy().
+
+    \value NoCopyFlags          The copy fails if the destination exists.
+    \value OverwriteExisting    Existing files in the destination are
+                                replaced, and existing directories are
+                                merged with the ones copied.
+*/
+
+/*!
+    \fn void QFileCopier::progress(qint64 bytesCopied, qint64 bytesTotal)
+
+    This signal is emitted periodically while copy() runs, from the thread
+    that called it, and once more when it finishes. \a bytesCopied is the
+    amount of data copied so far, out of \a bytesTotal.
+
+    \sa cancel()
+*/
+
+enum {
+    ProgressInterval = 100,         // milliseconds
+    CopyBufferSize = 1024 * 1024
+};
+
+void QFileCopierPrivate::reset()
+{
+    files.clear();
+    directories.clear();
+    symLinks.clear();
+    copied.storeRelaxed(0);
+    total = 0;
+    nextFile.storeRelaxed(0);
+    canceled.storeRelaxed(0);
+    failed.storeRelaxed(0);
+    error = QFileDevice::NoError;
+    errorString.clear();
+    progressTimer.invalidate();
+}
+
+bool QFileCopierPrivate::setError(QFileDevice::FileError fileError, const QString &message)
+{
+    const auto locker = qt_scoped_lock(mutex);
+    if (error == QFileDevice::NoError) {
+        error = fileError;
+        errorString = message;
+    }
+    failed.storeRelaxed(1);
+    return false;
+}
+
+void QFileCopierPrivate::reportProgress(bool force)
+{
+    Q_Q(QFileCopier);
+    if (QThread::currentThread() != copyingThread)
+        return;
+    if (!force && progressTimer.isValid() && !progressTimer.hasExpired(ProgressInterval))
+        return;
+    progressTimer.start();
+    emit q->progress(copied.loadRelaxed(), total);
+}
+
+/*
+    Lists what is to be copied from \a source, which is a directory, to
+    \a destination.
+*/
+bool QFileCopierPrivate::scan(const QString &source, const QString &destination)
+{
+    const QDir sourceDir(source);
+    const QDir destinationDir(destination);
+    directories.append({ source, destination });
+
+    QDirIterator it(source, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories | QDirIterator::ParallelScan
+                    | QDirIterator::PrefetchMetaData);
+    while (it.hasNext()) {
+        if (isStopped())
+            return false;
+        it.next();
+        const QFileInfo info = it.fileInfo();
+        const QString target = destinationDir.filePath(sourceDir.relativeFilePath(info.filePath()));
+        if (info.isSymLink())
+            symLinks.append({ info.filePath(), target });
+        else if (info.isDir())
+            directories.append({ info.filePath(), target });
+        else if (info.isFile())
+            files.append({ info.filePath(), target, info.size() });
+    }
+
+    // a parallel scan returns the entries in no particular order
+    std::sort(directories.begin(), directories.end(), [](const PathPair &a, const PathPair &b) {
+        return a.second.size() < b.second.size();
+    });
+    // start with the largest files, so the last ones to finish are small
+    std::sort(files.begin(), files.end(), [](const FileJob &a, const FileJob &b) {
+        return a.size > b.size;
+    });
+    return true;
+}
+
+bool QFileCopierPrivate::createDirectories()
+{
+    const bool overwrite = flags.testFlag(QFileCopier::OverwriteExisting);
+    QDir dir;
+    for (const PathPair &directory : qAsConst(directories)) {
+        if (isStopped())
+            return false;
+        if (!dir.mkdir(directory.second) && !(overwrite && QFileInfo(directory.second).isDir())) {
+            return setError(QFileDevice::CopyError,
+                            QFileCopier::tr("Cannot create directory %1")
+                            .arg(QDir::toNativeSeparators(directory.second)));
+        }
+    }
+    return true;
+}
+
+// The target of \a link as stored, so that relative links stay relative.
+static QString rawSymLinkTarget(const QString &link)
+{
+#ifdef Q_OS_UNIX
+    QByteArray target(PATH_MAX, Qt::Uninitialized);
+    const ssize_t length = ::readlink(QFile::encodeName(link).constData(), target.data(),
+                                      target.size());
+    if (length < 0)
+        return QString();
+    target.truncate(length);
+    return QFile::decodeName(target);
+#else
+    return QFile::symLinkTarget(link);
+#endif
+}
+
+bool QFileCopierPrivate::createSymLinks()
+{
+    const bool overwrite = flags.testFlag(QFileCopier::OverwriteExisting);
+    for (const PathPair &link : qAsConst(symLinks)) {
+        if (isStopped())
+            return false;
+        const QString target = rawSymLinkTarget(link.first);
+        if (overwrite)
+            QFile::remove(link.second);
+        if (target.isEmpty() || !QFile::link(target, link.second)) {
+            return setError(QFileDevice::CopyError,
+                            QFileCopier::tr("Cannot create symbolic link %1")
+                            .arg(QDir::toNativeSeparators(link.second)));
+        }
+    }
+    return true;
+}
+
+bool QFileCopierPrivate::copyFile(const FileJob &job)
+{
+    const bool overwrite = flags.testFlag(QFileCopier::OverwriteExisting);
+    qint64 reported = 0;
+    const auto addProgress = [this, &reported](qint64 offset) {
+        copied.fetchAndAddRelaxed(offset - reported);
+        reported = offset;
+        reportProgress();
+        return !isStopped();
+    };
+
+#ifdef Q_OS_UNIX
+    const QByteArray source = QFile::encodeName(job.source);
+    const QByteArray destination = QFile::encodeName(job.destination);
+    const int srcfd = qt_safe_open(source.constData(), O_RDONLY);
+    if (srcfd == -1) {
+        return setError(QFileDevice::OpenError,
+                        QFileCopier::tr("Cannot open %1 for input: %2")
+                        .arg(job.source, qt_error_string(errno)));
+    }
+    QT_STATBUF st;
+    const bool haveStat = QT_FSTAT(srcfd, &st) == 0;
+    if (!haveStat)
+        st.st_mode = 0644;
+    // not O_TRUNC: the destination may be the source itself, under the same
+    // name, through a symbolic link or as a hard link
+    const int dstfd = qt_safe_open(destination.constData(),
+                                   O_WRONLY | O_CREAT | (overwrite ? 0 : O_EXCL),
+                                   st.st_mode & 0777);
+    if (dstfd == -1) {
+        const int savedErrno = errno;
+        qt_safe_close(srcfd);
+        return setError(QFileDevice::CopyError,
+                        QFileCopier::tr("Cannot open %1 for output: %2")
+                        .arg(job.destination, qt_error_string(savedErrno)));
+    }
+    if (overwrite) {
+        QT_STATBUF dst;
+        const bool sameFile = haveStat && QT_FSTAT(dstfd, &dst) == 0
+                && dst.st_dev == st.st_dev && dst.st_ino == st.st_ino;
+        if (sameFile || QT_FTRUNCATE(dstfd, 0) == -1) {
+            const int savedErrno = errno;
+            qt_safe_close(dstfd);
+            qt_safe_close(srcfd);
+            return setError(QFileDevice::CopyError,
+                            QFileCopier::tr("Cannot copy %1 to %2: %3")
+                            .arg(job.source, job.destination,
+                                 sameFile ? QFileCopier::tr("Source and destination are the same file")
+                                          : qt_error_string(savedErrno)));
+        }
+    }
+
+    QSystemError copyError;
+    const bool ok = QFileSystemEngine::copyFileData(srcfd, dstfd, copyError, addProgress);
+    if (ok) // like QFile::copy(), ignore failures to copy the permissions
+        ::fchmod(dstfd, st.st_mode & 07777);
+    qt_safe_close(dstfd);
+    qt_safe_close(srcfd);
+    if (!ok) {
+        ::unlink(destination.constData());
+        if (copyError.error() == ECANCELED)
+            return false;
+        return setError(QFileDevice::CopyError,
+                        QFileCopier::tr("Cannot copy %1 to %2: %3")
+                        .arg(job.source, job.destination, copyError.toString()));
+    }
+#else
+    QFile in(job.source);
+    if (!in.open(QIODevice::ReadOnly)) {
+        return setError(QFileDevice::OpenError,
+                        QFileCopier::tr("Cannot open %1 for input: %2")
+                        .arg(job.source, in.errorString()));
+    }
+    if (overwrite && QFileInfo(job.source) == QFileInfo(job.destination)) {
+        return setError(QFileDevice::CopyError,
+                        QFileCopier::tr("Cannot copy %1 to %2: %3")
+                        .arg(job.source, job.destination,
+                             QFileCopier::tr("Source and destination are the same file")));
+    }
+    QFile out(job.destination);
+    if (!out.open(QIODevice::WriteOnly | (overwrite ? QIODevice::Truncate : QIODevice::NewOnly))) {
+        return setError(QFileDevice::CopyError,
+                        QFileCopier::tr("Cannot open %1 for output: %2")
+                        .arg(job.destination, out.errorString()));
+    }
+    QByteArray block(CopyBufferSize, Qt::Uninitialized);
+    qint64 offset = 0;
+    for (;;) {
+        const qint64 n = in.read(block.data(), block.size());
+        if (n == 0)
+            break;
+        if (n < 0 || out.write(block.constData(), n) != n) {
+            const QString reason = n < 0 ? in.errorString() : out.errorString();
+            out.remove();
+            return setError(QFileDevice::CopyError,
+                            QFileCopier::tr("Cannot copy %1 to %2: %3")
+                            .arg(job.source, job.destination, reason));
+        }
+        offset += n;
+        if (!addProgress(offset)) {
+            out.remove();
+            return false;
+        }
+    }
+    out.close();
+    QFile::setPermissions(job.destination, in.permissions());
+#endif
+
+    // the file may have changed size since it was listed
+    copied.fetchAndAddRelaxed(job.size - reported);
+    return true;
+}
+
+void QFileCopierPrivate::work()
+{
+    while (!isStopped()) {
+        const int index = nextFile.fetchAndAddRelaxed(1);
+        if (index >= files.size())
+            break;
+        copyFile(files.at(index));
+    }
+}
+
+void QFileCopierPrivate::copyFiles()
+{
+    // the calling thread is one of the copying threads
+    const qsizetype threads = qMin<qsizetype>(maxThreadCount, files.size());
+    if (threads > 1) {
+        QThreadPool *pool = QThreadPool::globalInstance();
+        const auto locker = qt_scoped_lock(mutex);
+        for (qsizetype i = 1; i < threads; ++i) {
+            const bool started = pool->tryStart([this] {
+                work();
+                const auto locker = qt_scoped_lock(mutex);
+                if (--workers == 0)
+                    workerFinished.wakeAll();
+            });
+            if (!started)
+                break;
+            ++workers;
+        }
+    }
+
+    work();
+
+    QMutexLocker locker(&mutex);
+    while (workers > 0) {
+        workerFinished.wait(&mutex, ProgressInterval);
+        locker.unlock();
+        reportProgress();
+        locker.relock();
+    }
+}
+
+/*!
+    Constructs a file copier with the given \a parent.
+*/
+QFileCopier::QFileCopier(QObject *parent)
+    : QObject(*new QFileCopierPrivate, parent)
+{
+    Q_D(QFileCopier);
+    d->maxThreadCount = qMax(1, QThread::idealThreadCount());
+}
+
+/*!
+    Destroys the file copier.
+*/
+QFileCopier::~QFileCopier()
+{
+}
+
+/*!
+    Returns the maximum number of threads used to copy the files of a
+    directory tree, including the thread calling copy(). The default is
+    QThread::idealThreadCount().
+
+    The additional threads are taken from QThreadPool::globalInstance(),
+    when it has threads available.
+*/
+int QFileCopier::maxThreadCount() const
+{
+    Q_D(const QFileCopier);
+    return d->maxThreadCount;
+}
+
+/*!
+    Sets the maximum number of threads used by copy() to \a count. A
+    \a count of 1 copies the files one at a time, on the calling thread,
+    which may be faster on storage with slow seeks.
+*/
+void QFileCopier::setMaxThreadCount(int count)
+{
+    Q_D(QFileCopier);
+    d->maxThreadCount = qMax(1, count);
+}
+
+/*!
+    Copies \a source to \a destination, and returns \c true on success.
+
+    If \a source is a file, it is copied like QFile::copy() does. If it is
+    a directory, \a destination is created, and the contents of \a source
+    are copied into it recursively. The parent of \a destination must
+    exist. Unless \a flags contains OverwriteExisting, the copy fails if
+    \a destination, or anything in it, already exists.
+
+    copy() returns when the copy is complete, has failed, or was canceled.
+    When it fails or is canceled, the files already copied are left in
+    place; only the file being copied at the time is removed. error() and
+    errorString() then describe what went wrong.
+
+    \sa cancel(), progress()
+*/
+bool QFileCopier::copy(const QString &source, const QString &destination, CopyFlags flags)
+{
+    Q_D(QFileCopier);
+    if (d->copying) {
+        qWarning("QFileCopier::copy: A copy is already in progress");
+        return false;
+    }
+    d->reset();
+    d->flags = flags;
+
+    const QFileInfo sourceInfo(source);
+    if (!sourceInfo.exists() && !sourceInfo.isSymLink()) {
+        d->setError(QFileDevice::OpenError,
+                    tr("Source file does not exist: %1").arg(QDir::toNativeSeparators(source)));
+        return false;
+    }
+    if (!flags.testFlag(OverwriteExisting)
+            && (QFileInfo::exists(destination) || QFileInfo(destination).isSymLink())) {
+        d->setError(QFileDevice::CopyError,
+                    tr("Destination file exists: %1").arg(QDir::toNativeSeparators(destination)));
+        return false;
+    }
+
+    d->copying = true;
+    d->copyingThread = QThread::currentThread();
+    if (sourceInfo.isSymLink())
+        d->symLinks.append({ source, destination });
+    else if (sourceInfo.isDir())
+        d->scan(source, destination);
+    else
+        d->files.append({ source, destination, sourceInfo.size() });
+    for (const QFileCopierPrivate::FileJob &file : qAsConst(d->files))
+        d->total += file.size;
+    d->reportProgress(true);
+
+    if (d->createDirectories() && d->createSymLinks())
+        d->copyFiles();
+
+    // the permissions of the directories last, as they may forbid writing
+    if (!d->isStopped()) {
+        for (auto it = d->directories.crbegin(); it != d->directories.crend(); ++it)
+            QFile::setPermissions(it->second, QFile::permissions(it->first));
+    }
+
+    if (d->canceled.loadRelaxed())
+        d->setError(QFileDevice::AbortError, tr("Operation canceled"));
+    d->reportProgress(true);
+    d->copying = false;
+    d->copyingThread = nullptr;
+    return d->error == QFileDevice::NoError;
+}
+
+/*!
+    Stops the copy in progress, if any. copy() then returns \c false, with
+    error() set to QFileDevice::AbortError.
+
+    This function is thread-safe; it is typically called from a slot
+    connected to progress(), or from another thread.
+
+    \sa isCanceled()
+*/
+void QFileCopier::cancel()
+{
+    Q_D(QFileCopier);
+    d->canceled.storeRelaxed(1);
+}
+
+/*!
+    Returns \c true if the last copy was canceled.
+
+    \sa cancel()
+*/
+bool QFileCopier::isCanceled() const
+{
+    Q_D(const QFileCopier);
+    return d->canceled.loadRelaxed();
+}
+
+/*!
+    Returns the amount of data copied so far by the current or last copy,
+    in bytes.
+
+    \sa bytesTotal(), progress()
+*/
+qint64 QFileCopier::bytesCopied() const
+{
+    Q_D(const QFileCopier);
+    return d->copied.loadRelaxed();
+}
+
+/*!
+    Returns the total size of the files being copied, or copied by the
+    last copy, in bytes.
+
+    \sa bytesCopied(), progress()
+*/
+qint64 QFileCopier::bytesTotal() const
+{
+    Q_D(const QFileCopier);
+    return d->total;
+}
+
+/*!
+    Returns the error of the last copy, or QFileDevice::NoError if it
+    succeeded. When several files fail to copy, the first error is kept.
+
+    \sa errorString()
+*/
+QFileDevice::FileError QFileCopier::error() const
+{
+    Q_D(const QFileCopier);
+    const auto locker = qt_scoped_lock(d->mutex);
+    return d->error;
+}
+
+/*!
+    Returns a human-readable description of the error of the last copy.
+
+    \sa error()
+*/
+QString QFileCopier::errorString() const
+{
+    Q_D(const QFileCopier);
+    const auto locker = qt_scoped_lock(d->mutex);
+    return d->errorString;
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qfilecopier.cpp"
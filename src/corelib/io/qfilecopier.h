@@ -0,0 +1,90 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILECOPIER_H
+#define QFILECOPIER_H
+
+#include <QtCore/qfiledevice.h>
+#include <QtCore/qobject.h>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class QFileCopierPrivate;
+
+class Q_CORE_EXPORT QFileCopier : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QFileCopier)
+
+public:
+    enum CopyFlag {
+        NoCopyFlags = 0x0,
+        OverwriteExisting = 0x1
+    };
+    Q_DECLARE_FLAGS(CopyFlags, CopyFlag)
+    Q_FLAG(CopyFlags)
+
+    explicit QFileCopier(QObject *parent = nullptr);
+    ~QFileCopier();
+
+    int maxThreadCount() const;
+    void setMaxThreadCount(int count);
+
+    bool copy(const QString &source, const QString &destination,
+              CopyFlags flags = NoCopyFlags);
+    void cancel();
+    bool isCanceled() const;
+
+    qint64 bytesCopied() const;
+    qint64 bytesTotal() const;
+
+    QFileDevice::FileError error() const;
+    QString errorString() const;
+
+Q_SIGNALS:
+    void progress(qint64 bytesCopied, qint64 bytesTotal);
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QFileCopier::CopyFlags)
+
+QT_END_NAMESPACE
+
+#endif // QFILECOPIER_H
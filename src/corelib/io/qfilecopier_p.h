@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QFILECOPIER_P_H
+#define QFILECOPIER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qfilecopier.h"
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qpair.h>
+#include <QtCore/qwaitcondition.h>
+#include <QtCore/private/qobject_p.h>
+
+QT_REQUIRE_CONFIG(thread);
+
+QT_BEGIN_NAMESPACE
+
+class QThread;
+
+class QFileCopierPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QFileCopier)
+public:
+    struct FileJob
+    {
+        QString source;
+        QString destination;
+        qint64 size;
+    };
+    using PathPair = QPair<QString, QString>;   // source, destination
+
+    void reset();
+    bool scan(const QString &source, const QString &destination);
+    bool createDirectories();
+    bool createSymLinks();
+    void copyFiles();
+    void work();
+    bool copyFile(const FileJob &job);
+    void reportProgress(bool force = false);
+    bool setError(QFileDevice::FileError fileError, const QString &message);
+    bool isStopped() const { return canceled.loadRelaxed() || failed.loadRelaxed(); }
+
+    QList<FileJob> files;               // largest first
+    QList<PathPair> directories;        // parents first
+    QList<PathPair> symLinks;
+
+    QAtomicInteger<qint64> copied = 0;
+    qint64 total = 0;
+    QAtomicInt nextFile = 0;
+    QAtomicInt canceled = 0;
+    QAtomicInt failed = 0;
+
+    mutable QMutex mutex;
+    QWaitCondition workerFinished;
+    int workers = 0;                    // pool threads still copying
+
+    // protected by mutex
+    QFileDevice::FileError error = QFileDevice::NoError;
+    QString errorString;
+
+    QFileCopier::CopyFlags flags;
+    int maxThreadCount = 1;
+    QThread *copyingThread = nullptr;
+    QElapsedTimer progressTimer;
+    bool copying = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QFILECOPIER_P_H
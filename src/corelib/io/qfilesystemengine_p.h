@@ -56,6 +56,8 @@
 #include "qfilesystemmetadata_p.h"
 #include <QtCore/private/qsystemerror_p.h>
 
+#include <functional>
+
 QT_BEGIN_NAMESPACE
 
 #define Q_RETURN_ON_INVALID_FILENAME(message, result) \
@@ -122,7 +124,11 @@ public:
                              QFileSystemMetaData::MetaDataFlags what);
 #if defined(Q_OS_UNIX)
     static bool cloneFile(int srcfd, int dstfd, const QFileSystemMetaData &knownData);
+    static bool copyFileData(int srcfd, int dstfd, QSystemError &error,
+                             const std::function<bool(qint64)> &progress = {});
     static bool fillMetaData(int fd, QFileSystemMetaData &data); // what = PosixStatFlags
+    static bool fillMetaDataAt(int dirFd, const char *name, QFileSystemMetaData &data,
+                               QFileSystemMetaData::MetaDataFlags what);
     static QByteArray id(int fd);
     static bool setFileTime(int fd, const QDateTime &newDate,
                             QAbstractFileEngine::FileTime whatTime, QSystemError &error);
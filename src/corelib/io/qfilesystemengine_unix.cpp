@@ -51,6 +51,8 @@
 # include <QtCore/qstandardpaths.h>
 #endif // QT_BOOTSTRAPPED
 
+#include <limits>
+#include <memory>
 #include <pwd.h>
 #include <stdlib.h> // for realpath()
 #include <sys/types.h>
@@ -428,6 +430,134 @@ bool QFileSystemEngine::fillMetaData(int fd, QFileSystemMetaData &data)
     return false;
 }
 
+#ifdef STATX_BASIC_STATS
+static QFileSystemMetaData::MetaDataFlags knownFlagsFromStatxMask(unsigned mask)
+{
+    QFileSystemMetaData::MetaDataFlags known = QFileSystemMetaData::ExistsAttribute;
+    if (mask & STATX_TYPE) {
+        known |= QFileSystemMetaData::FileType
+                | QFileSystemMetaData::DirectoryType
+                | QFileSystemMetaData::SequentialType;
+    }
+    if (mask & STATX_MODE) {
+        known |= QFileSystemMetaData::OtherPermissions
+                | QFileSystemMetaData::GroupPermissions
+                | QFileSystemMetaData::OwnerPermissions;
+    }
+    if (mask & STATX_SIZE)
+        known |= QFileSystemMetaData::SizeAttribute;
+    if (mask & STATX_NLINK)
+        known |= QFileSystemMetaData::WasDeletedAttribute;
+    if ((mask & (STATX_ATIME | STATX_MTIME | STATX_CTIME)) == (STATX_ATIME | STATX_MTIME | STATX_CTIME))
+        known |= QFileSystemMetaData::Times;
+    if ((mask & (STATX_UID | STATX_GID)) == (STATX_UID | STATX_GID))
+        known |= QFileSystemMetaData::OwnerIds;
+    return known;
+}
+#endif
+
+/*!
+    \internal
+
+    Fills \a what in \a data for the entry called \a name in the directory
+    opened as \a dirFd, on top of what the directory entry itself told
+    QFileSystemIterator. Like fillMetaData(), symbolic links are followed for
+    everything but LinkType.
+
+    Unlike fillMetaData(), this uses statx() with AT_STATX_DONT_SYNC and asks
+    only for the fields in \a what, so network file systems may answer from
+    their attribute caches instead of asking the server. Only the flags the
+    kernel actually reported are marked as known; the rest are fetched on
+    demand as usual.
+*/
+//static
+bool QFileSystemEngine::fillMetaDataAt(int dirFd, const char *name, QFileSystemMetaData &data,
+                                       QFileSystemMetaData::MetaDataFlags what)
+{
+    const bool typeKnown = data.hasFlags(QFileSystemMetaData::LinkType);
+    data.knownFlagsMask |= QFileSystemMetaData::LinkType | QFileSystemMetaData::ExistsAttribute;
+
+#ifdef STATX_BASIC_STATS
+    unsigned mask = STATX_TYPE;
+    if (what & QFileSystemMetaData::Permissions)
+        mask |= STATX_MODE;
+    if (what & QFileSystemMetaData::SizeAttribute)
+        mask |= STATX_SIZE;
+    if (what & QFileSystemMetaData::WasDeletedAttribute)
+        mask |= STATX_NLINK;
+    if (what & QFileSystemMetaData::Times)
+        mask |= STATX_ATIME | STATX_MTIME | STATX_CTIME | STATX_BTIME;
+    if (what & QFileSystemMetaData::OwnerIds)
+        mask |= STATX_UID | STATX_GID;
+
+    struct statx statxBuffer;
+    int ret = 0;
+    if (!typeKnown || !data.isLink()) {
+        ret = statx(dirFd, name, AT_SYMLINK_NOFOLLOW | AT_STATX_DONT_SYNC, mask, &statxBuffer);
+        if (ret == 0) {
+            if (!S_ISLNK(statxBuffer.stx_mode)) {
+                data.entryFlags &= ~(QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::LinkType);
+                data.fillFromStatxBuf(statxBuffer);
+                data.knownFlagsMask |= knownFlagsFromStatxMask(statxBuffer.stx_mask);
+                return true;
+            }
+            data.entryFlags |= QFileSystemMetaData::LinkType;
+        }
+    }
+
+    if (ret == 0) {
+        // a symbolic link: report on its target
+        data.entryFlags &= ~(QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::ExistsAttribute);
+        ret = statx(dirFd, name, AT_STATX_DONT_SYNC, mask, &statxBuffer);
+        if (ret == 0) {
+            data.fillFromStatxBuf(statxBuffer);
+            data.knownFlagsMask |= knownFlagsFromStatxMask(statxBuffer.stx_mask);
+            return true;
+        }
+        if (errno != ENOSYS) {
+            // dangling; it exists as a link, but has no data
+            data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags;
+            data.size_ = 0;
+            return false;
+        }
+    } else if (errno != ENOSYS) {
+        // gone since the directory was read
+        data.entryFlags &= ~QFileSystemMetaData::ExistsAttribute;
+        return false;
+    }
+#else
+    Q_UNUSED(what);
+#endif
+
+    QT_STATBUF statBuffer;
+#if defined(QT_USE_XOPEN_LFS_EXTENSIONS) && defined(QT_LARGEFILE_SUPPORT)
+    auto statAt = [&](int flags) { return ::fstatat64(dirFd, name, &statBuffer, flags); };
+#else
+    auto statAt = [&](int flags) { return ::fstatat(dirFd, name, &statBuffer, flags); };
+#endif
+    bool isLink = typeKnown && data.isLink();
+    if (!isLink) {
+        if (statAt(AT_SYMLINK_NOFOLLOW) != 0) {
+            data.entryFlags &= ~QFileSystemMetaData::ExistsAttribute;
+            return false;
+        }
+        isLink = S_ISLNK(statBuffer.st_mode);
+        if (isLink)
+            data.entryFlags |= QFileSystemMetaData::LinkType;
+        else
+            data.entryFlags &= ~QFileSystemMetaData::LinkType;
+    }
+
+    data.entryFlags &= ~(QFileSystemMetaData::PosixStatFlags | QFileSystemMetaData::ExistsAttribute);
+    data.knownFlagsMask |= QFileSystemMetaData::PosixStatFlags;
+    if (isLink && statAt(0) != 0) {
+        data.size_ = 0;
+        return false;
+    }
+    data.fillFromStatBuf(statBuffer);
+    return true;
+}
+
 #if defined(_DEXTRA_FIRST)
 static void fillStat64fromStat32(struct stat64 *statBuf64, const struct stat &statBuf32)
 {
@@ -1072,42 +1202,175 @@ bool QFileSystemEngine::cloneFile(int srcfd, int dstfd, const QFileSystemMetaDat
     }
 
 #if defined(Q_OS_LINUX)
-    // first, try FICLONE (only works on regular files and only on certain fs)
-    if (::ioctl(dstfd, FICLONE, srcfd) == 0)
+    QSystemError error;
+    if (copyFileData(srcfd, dstfd, error))
         return true;
 
-    // Second, try sendfile (it can send to some special types too).
-    // sendfile(2) is limited in the kernel to 2G - 4k
-    const size_t SendfileSize = 0x7ffff000;
+    // we have no way to notify QFile of partial success, so just erase any
+    // work done and let it try at an upper layer
+    int n = QT_FTRUNCATE(dstfd, 0);
+    n = QT_LSEEK(srcfd, 0, SEEK_SET);
+    n = QT_LSEEK(dstfd, 0, SEEK_SET);
+    Q_UNUSED(n);
+    return false;
+#elif defined(Q_OS_DARWIN)
+    // try fcopyfile
+    return fcopyfile(srcfd, dstfd, nullptr, COPYFILE_DATA | COPYFILE_STAT) == 0;
+#else
+    Q_UNUSED(dstfd);
+    return false;
+#endif
+}
 
-    ssize_t n = ::sendfile(dstfd, srcfd, nullptr, SendfileSize);
-    if (n == -1) {
-        // if we got an error here, give up and try at an upper layer
+/*
+    Copies the contents of the regular file \a srcfd to the empty file
+    \a dstfd, at the same offsets, until the end of \a srcfd. After each
+    chunk, \a progress (if set) is called with the offset reached in the
+    source; copying stops with ECANCELED if it returns \c false.
+
+    On Linux, the file is first cloned with FICLONE, then copied with
+    copy_file_range(), which lets the file system share extents or copy on
+    the server side, then with sendfile(). Everywhere else, and when neither
+    works for this pair of files, the data goes through a large buffer. Holes
+    in sparse files are found with SEEK_DATA/SEEK_HOLE and skipped, so they
+    stay holes in the copy.
+
+    The size reported by fstat() is only used to find the holes: files in
+    /proc and /sys report a size of 0, or a wrong one, and copy_file_range()
+    and sendfile() return 0 on some of them instead of failing. The end of
+    the file is therefore only trusted once read() returns 0.
+
+    Returns \c false and sets \a error on failure, leaving whatever was
+    copied so far in \a dstfd.
+*/
+bool QFileSystemEngine::copyFileData(int srcfd, int dstfd, QSystemError &error,
+                                     const std::function<bool(qint64)> &progress)
+{
+    const auto fail = [&error](int errorCode) {
+        error = QSystemError(errorCode, QSystemError::StandardLibraryError);
         return false;
+    };
+
+    QT_STATBUF statBuffer;
+    if (QT_FSTAT(srcfd, &statBuffer) == -1)
+        return fail(errno);
+    const qint64 size = statBuffer.st_size;
+
+#if defined(Q_OS_LINUX)
+    if (size > 0 && ::ioctl(dstfd, FICLONE, srcfd) == 0) {
+        if (progress && !progress(size))
+            return fail(ECANCELED);
+        return true;
     }
+#endif
 
-    while (n) {
-        n = ::sendfile(dstfd, srcfd, nullptr, SendfileSize);
-        if (n == -1) {
-            // uh oh, this is probably a real error (like ENOSPC), but we have
-            // no way to notify QFile of partial success, so just erase any work
-            // done (hopefully we won't get any errors, because there's nothing
-            // we can do about them)
-            n = ftruncate(dstfd, 0);
-            n = lseek(srcfd, 0, SEEK_SET);
-            n = lseek(dstfd, 0, SEEK_SET);
-            return false;
+    // large enough for the system calls to dominate; small enough for
+    // progress to be reported a few times per second even on slow disks
+    const qint64 ChunkSize = 8 * 1024 * 1024;
+    enum { CopyFileRange, SendFile, ReadWrite } method =
+#if QT_CONFIG(copy_file_range)
+            CopyFileRange;
+#elif defined(Q_OS_LINUX)
+            SendFile;
+#else
+            ReadWrite;
+#endif
+    std::unique_ptr<char[]> buffer;
+    const qint64 BufferSize = 1024 * 1024;
+
+    qint64 offset = 0;
+    bool atEnd = false;
+    while (!atEnd) {
+        // copy up to the next hole, or to the end of the file
+        qint64 dataEnd = std::numeric_limits<qint64>::max();
+#ifdef SEEK_DATA
+        if (offset < size) {
+            const QT_OFF_T dataStart = QT_LSEEK(srcfd, offset, SEEK_DATA);
+            if (dataStart == -1 && errno == ENXIO) {
+                offset = size; // only a hole is left
+                continue;
+            }
+            if (dataStart != -1) {
+                offset = dataStart;
+                const QT_OFF_T holeStart = QT_LSEEK(srcfd, offset, SEEK_HOLE);
+                if (holeStart != -1 && holeStart < size)
+                    dataEnd = holeStart;
+            }
+            // otherwise (e.g. EINVAL) the file system can't tell: copy everything
+        }
+#endif
+
+        while (offset < dataEnd) {
+            const qint64 chunk = qMin(dataEnd - offset, ChunkSize);
+            qint64 n = -1;
+            switch (method) {
+            case CopyFileRange: {
+#if QT_CONFIG(copy_file_range)
+                loff_t in = offset;
+                loff_t out = offset;
+                EINTR_LOOP(n, ::copy_file_range(srcfd, &in, dstfd, &out, size_t(chunk), 0));
+                if (n == -1 && (errno == ENOSYS || errno == EXDEV || errno == EINVAL
+                                || errno == EOPNOTSUPP || errno == EBADF || errno == EPERM)) {
+                    // not for this kernel, file system or pair of files
+                    method = SendFile;
+                    continue;
+                }
+#endif
+                break;
+            }
+            case SendFile: {
+#if defined(Q_OS_LINUX)
+                QT_OFF_T in = offset;
+                if (QT_LSEEK(dstfd, offset, SEEK_SET) == -1)
+                    return fail(errno);
+                EINTR_LOOP(n, ::sendfile(dstfd, srcfd, &in, size_t(chunk)));
+                if (n == -1 && (errno == ENOSYS || errno == EINVAL)) {
+                    method = ReadWrite;
+                    continue;
+                }
+#endif
+                break;
+            }
+            case ReadWrite:
+                if (!buffer)
+                    buffer.reset(new char[BufferSize]);
+                if (QT_LSEEK(srcfd, offset, SEEK_SET) == -1
+                        || QT_LSEEK(dstfd, offset, SEEK_SET) == -1) {
+                    return fail(errno);
+                }
+                n = qt_safe_read(srcfd, buffer.get(), qMin(chunk, BufferSize));
+                for (qint64 written = 0; written < n; ) {
+                    const qint64 w = qt_safe_write(dstfd, buffer.get() + written, n - written);
+                    if (w <= 0)
+                        return fail(w == 0 ? ENOSPC : errno);
+                    written += w;
+                }
+                break;
+            }
+
+            if (n == -1)
+                return fail(errno);
+            if (n == 0) {
+                // only read() reliably tells the end of the file
+                if (method != ReadWrite) {
+                    method = ReadWrite;
+                    continue;
+                }
+                atEnd = true;
+                break;
+            }
+            offset += n;
+            if (progress && !progress(offset))
+                return fail(ECANCELED);
         }
     }
 
+    // recreate the trailing hole, if any
+    if (QT_FTRUNCATE(dstfd, offset) == -1)
+        return fail(errno);
+    if (progress && !progress(offset))
+        return fail(ECANCELED);
     return true;
-#elif defined(Q_OS_DARWIN)
-    // try fcopyfile
-    return fcopyfile(srcfd, dstfd, nullptr, COPYFILE_DATA | COPYFILE_STAT) == 0;
-#else
-    Q_UNUSED(dstfd);
-    return false;
-#endif
 }
 
 // Note: if \a shouldMkdirFirst is false, we assume the caller did try to mkdir
@@ -67,6 +67,17 @@
 #include <QtCore/qscopedpointer.h>
 #endif
 
+// Directories are read with getdents64() where QT_DIRENT is laid out like the
+// records it returns: always on 64-bit Linux, and with large file support on
+// 32-bit Linux. Otherwise they are read with readdir().
+#if defined(Q_OS_LINUX) && (QT_POINTER_SIZE == 8 || (defined(QT_LARGEFILE_SUPPORT) \
+        && defined(QT_USE_XOPEN_LFS_EXTENSIONS) && !defined(QT_NO_READDIR64)))
+#  define QT_FILESYSTEMITERATOR_GETDENTS64
+#endif
+#if defined(QT_FILESYSTEMITERATOR_GETDENTS64)
+#include <memory>
+#endif
+
 QT_BEGIN_NAMESPACE
 
 class QFileSystemIterator
@@ -90,6 +101,14 @@ private:
     bool uncFallback;
     int uncShareIndex;
     bool onlyDirs;
+#elif defined(QT_FILESYSTEMITERATOR_GETDENTS64)
+    int dirFd;
+    int bufferSize;
+    int bufferPos;
+    int bufferEnd;
+    std::unique_ptr<char[]> buffer; // records returned by getdents64()
+    QFileSystemMetaData::MetaDataFlags prefetchFlags;
+    int lastError;
 #else
     QT_DIR *dir;
     QT_DIRENT *dirEntry;
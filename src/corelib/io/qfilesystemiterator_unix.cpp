@@ -44,10 +44,19 @@
 
 #ifndef QT_NO_FILESYSTEMITERATOR
 
+#if defined(QT_FILESYSTEMITERATOR_GETDENTS64)
+#include <private/qcore_unix_p.h>
+#include <private/qfilesystemengine_p.h>
+#endif
+
 #include <memory>
 
 #include <stdlib.h>
 #include <errno.h>
+#if defined(QT_FILESYSTEMITERATOR_GETDENTS64)
+#include <stddef.h>
+#include <sys/syscall.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -59,6 +68,89 @@ static bool checkNameDecodable(const char *d_name, qsizetype len)
     return QUtf8::isValidUtf8(QByteArrayView(d_name, len)).isValidUtf8;
 }
 
+#if defined(QT_FILESYSTEMITERATOR_GETDENTS64)
+// getdents64() fills the buffer with records laid out like struct dirent64,
+// which is what fillFromDirEnt() reads
+static_assert(offsetof(QT_DIRENT, d_reclen) == 16 && offsetof(QT_DIRENT, d_type) == 18
+              && offsetof(QT_DIRENT, d_name) == 19,
+              "QT_DIRENT does not match the records returned by getdents64()");
+
+QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
+                                         const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
+    : nativePath(entry.nativeFilePath())
+    , dirFd(-1)
+    , bufferSize(32 * 1024) // same as readdir() in glibc
+    , bufferPos(0)
+    , bufferEnd(0)
+    , lastError(0)
+{
+    Q_UNUSED(nameFilters);
+
+    if (flags & QDirIterator::ParallelScan) {
+        // Each directory is read in one go, so a bigger buffer costs little
+        // and saves round trips to network file systems.
+        bufferSize = 256 * 1024;
+
+        // Complete what the filters and the recursion need up front, on the
+        // thread doing the scan, instead of leaving it to QFileInfo.
+        if ((flags & QDirIterator::Subdirectories)
+            || (filters & (QDir::Dirs | QDir::AllDirs | QDir::Files | QDir::NoSymLinks | QDir::System))) {
+            prefetchFlags = QFileSystemMetaData::Type | QFileSystemMetaData::ExistsAttribute;
+        }
+        if (flags & QDirIterator::PrefetchMetaData) {
+            prefetchFlags |= QFileSystemMetaData::Type | QFileSystemMetaData::ExistsAttribute
+                    | QFileSystemMetaData::PosixStatFlags;
+        }
+    }
+
+    dirFd = qt_safe_open(nativePath.constData(), O_RDONLY | O_DIRECTORY);
+    if (dirFd == -1) {
+        lastError = errno;
+    } else {
+        if (!nativePath.endsWith('/'))
+            nativePath.append('/');
+    }
+}
+
+QFileSystemIterator::~QFileSystemIterator()
+{
+    if (dirFd != -1)
+        qt_safe_close(dirFd);
+}
+
+bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaData &metaData)
+{
+    if (dirFd == -1)
+        return false;
+
+    for (;;) {
+        if (bufferPos == bufferEnd) {
+            if (!buffer)
+                buffer.reset(new char[bufferSize]);
+            long ret;
+            EINTR_LOOP(ret, syscall(SYS_getdents64, dirFd, buffer.get(), bufferSize));
+            if (ret <= 0) {
+                lastError = ret ? errno : 0;
+                return false;
+            }
+            bufferPos = 0;
+            bufferEnd = int(ret);
+        }
+
+        const QT_DIRENT *dirEntry = reinterpret_cast<const QT_DIRENT *>(buffer.get() + bufferPos);
+        bufferPos += dirEntry->d_reclen;
+
+        qsizetype len = strlen(dirEntry->d_name);
+        if (checkNameDecodable(dirEntry->d_name, len)) {
+            fileEntry = QFileSystemEntry(nativePath + QByteArray(dirEntry->d_name, len), QFileSystemEntry::FromNativePath());
+            metaData.fillFromDirEnt(*dirEntry);
+            if (metaData.missingFlags(prefetchFlags))
+                QFileSystemEngine::fillMetaDataAt(dirFd, dirEntry->d_name, metaData, prefetchFlags);
+            return true;
+        }
+    }
+}
+#else
 QFileSystemIterator::QFileSystemIterator(const QFileSystemEntry &entry, QDir::Filters filters,
                                          const QStringList &nameFilters, QDirIterator::IteratorFlags flags)
     : nativePath(entry.nativeFilePath())
@@ -108,6 +200,8 @@ bool QFileSystemIterator::advance(QFileSystemEntry &fileEntry, QFileSystemMetaDa
     return false;
 }
 
+#endif // QT_FILESYSTEMITERATOR_GETDENTS64
+
 QT_END_NAMESPACE
 
 #endif // QT_NO_FILESYSTEMITERATOR
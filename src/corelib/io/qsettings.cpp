@@ -160,6 +160,15 @@ ParsedSettingsMap QConfFile::mergedKeyMap() const
 }
 
 bool QConfFile::isWritable() const
+{
+    return QSettingsPrivate::isFileWritable(name);
+}
+
+/*
+    Returns \c true if the settings file \a name can be written, creating
+    the directories leading to it if it doesn't exist yet.
+*/
+bool QSettingsPrivate::isFileWritable(const QString &name)
 {
     QFileInfo fileInfo(name);
 
@@ -280,6 +289,8 @@ after_loop:
 QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::Scope scope,
                                            const QString &organization, const QString &application)
 {
+    if (format == QSettings::BinaryFormat)
+        return new QBinarySettingsPrivate(scope, organization, application);
     return new QConfFileSettingsPrivate(format, scope, organization, application);
 }
 #endif
@@ -287,6 +298,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
 #if !defined(Q_OS_WIN)
 QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::Format format)
 {
+    if (format == QSettings::BinaryFormat)
+        return new QBinarySettingsPrivate(fileName);
     return new QConfFileSettingsPrivate(fileName, format);
 }
 #endif
@@ -1054,29 +1067,25 @@ void Q_AUTOTEST_EXPORT clearDefaultPaths()
 }
 #endif // QT_BUILD_INTERNAL && Q_XDG_PLATFORM && !QT_NO_STANDARDPATHS
 
-QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
-                                                   QSettings::Scope scope,
-                                                   const QString &organization,
-                                                   const QString &application)
-    : QSettingsPrivate(format, scope, organization, application),
-      nextPosition(0x40000000) // big positive number
+/*
+    Returns the files that store the settings of \a organization and
+    \a application in \a scope, most specific first, together with
+    whether each of them belongs to the user.
+*/
+QList<QSettingsPrivate::SettingsFile>
+QSettingsPrivate::settingsFiles(QSettings::Format format, QSettings::Scope scope,
+                                const QString &organization, const QString &application,
+                                const QString &extension)
 {
-    initFormat();
-
-    QString org = organization;
-    if (org.isEmpty()) {
-        setStatus(QSettings::AccessError);
-        org = QLatin1String("Unknown Organization");
-    }
-
-    QString appFile = org + QDir::separator() + application + extension;
-    QString orgFile = org + extension;
+    QList<SettingsFile> files;
+    QString appFile = organization + QDir::separator() + application + extension;
+    QString orgFile = organization + extension;
 
     if (scope == QSettings::UserScope) {
         Path userPath = getPath(format, QSettings::UserScope);
         if (!application.isEmpty())
-            confFiles.append(QConfFile::fromName(userPath.path + appFile, true));
-        confFiles.append(QConfFile::fromName(userPath.path + orgFile, true));
+            files.append({ userPath.path + appFile, true });
+        files.append({ userPath.path + orgFile, true });
     }
 
     Path systemPath = getPath(format, QSettings::SystemScope);
@@ -1103,14 +1112,35 @@ QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
 
         // Note: No check for existence of files is done intentionaly.
         for (const auto &path : qAsConst(paths))
-            confFiles.append(QConfFile::fromName(path, false));
+            files.append({ path, false });
     } else
 #endif // Q_XDG_PLATFORM && !QT_NO_STANDARDPATHS
     {
         if (!application.isEmpty())
-            confFiles.append(QConfFile::fromName(systemPath.path + appFile, false));
-        confFiles.append(QConfFile::fromName(systemPath.path + orgFile, false));
+            files.append({ systemPath.path + appFile, false });
+        files.append({ systemPath.path + orgFile, false });
     }
+    return files;
+}
+
+QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
+                                                   QSettings::Scope scope,
+                                                   const QString &organization,
+                                                   const QString &application)
+    : QSettingsPrivate(format, scope, organization, application),
+      nextPosition(0x40000000) // big positive number
+{
+    initFormat();
+
+    QString org = organization;
+    if (org.isEmpty()) {
+        setStatus(QSettings::AccessError);
+        org = QLatin1String("Unknown Organization");
+    }
+
+    const auto files = settingsFiles(format, scope, org, application, extension);
+    for (const SettingsFile &file : files)
+        confFiles.append(QConfFile::fromName(file.name, file.userPerms));
 
 #ifndef Q_OS_WASM // wasm needs to delay access until after file sync
     initAccess();
@@ -2375,6 +2405,17 @@ void QConfFileSettingsPrivate::ensureSectionParsed(QConfFile *confFile,
     \value IniFormat        Store the settings in INI files. Note that type information
                             is not preserved when reading settings from INI files;
                             all values will be returned as QString.
+    \value BinaryFormat     Store the settings in a memory-mapped binary file
+                            with a sorted key index. Opening such a file takes
+                            constant time regardless of its size, values are
+                            read lazily, and sync() appends only the keys that
+                            changed; the file is compacted from time to time.
+                            On Windows, compaction is postponed while another
+                            process has the file open.
+                            Type information is preserved, and keys are case
+                            sensitive on all platforms. The files are stored in
+                            the IniFormat locations with a \c .qsettings
+                            extension. This enum value was added in Qt 6.0.
 
     \value InvalidFormat    Special value returned by registerFormat().
     \omitvalue CustomFormat1
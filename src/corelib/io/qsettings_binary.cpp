@@ -0,0 +1,797 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsettings.h"
+
+#include "qsettings_p.h"
+#include "qdatastream.h"
+#include "qfileinfo.h"
+#include "qhash.h"
+#include "qlockfile.h"
+#include "qrandom.h"
+#if QT_CONFIG(temporaryfile)
+#include "qsavefile.h"
+#endif
+#include "private/qlocking_p.h"
+
+#include <algorithm>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QSettings::BinaryFormat files consist of three parts:
+
+    - a compacted part: a header, followed by one entry per key (the
+      key in UTF-16 and the value as serialized by QDataStream), followed
+      by an index of entry offsets sorted by key;
+    - a log: the changes synced since the file was last compacted, as
+      Set/Remove/Clear records, each ending with a checksum so that a
+      record torn by a crash is recognized and dropped;
+    - possibly the remains of a record torn by a crash, zeroed when the
+      next writer writes its records over them. Other processes may have
+      the file mapped, so it is never made shorter in place.
+
+    The file is rewritten (compacted) through QSaveFile once the log grows
+    too large relative to the compacted part. On Windows, replacing a file
+    fails while another process has it mapped; the log then keeps growing
+    until a later compaction succeeds.
+
+    Opening a file maps it and replays the log; keys in the compacted
+    part are looked up by binary search over the mapping, so neither
+    opening nor reading depends on the number of keys. Syncing appends
+    the changed keys only. Everything is stored in host byte order and
+    8-byte aligned.
+*/
+
+namespace {
+
+struct FileHeader
+{
+    char magic[8];
+    quint32 byteOrder;
+    quint32 version;
+    quint64 fileId;      // random, changes whenever the file is compacted
+    quint64 indexOffset;
+    quint64 entryCount;
+    quint64 logOffset;
+    quint64 reserved[2];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct EntryHeader
+{
+    quint32 keySize;     // in UTF-16 code units
+    quint32 valueSize;
+};
+
+struct LogRecord
+{
+    quint32 size;        // of the whole record, including the checksum
+    quint8 kind;
+    quint8 reserved[3];
+    quint32 keySize;
+    quint32 valueSize;
+};
+static_assert(sizeof(LogRecord) == 16);
+
+} // unnamed namespace
+
+static const char FileMagic[8] = { 'Q', 'S', 'e', 't', 't', 'B', 'i', 'n' };
+static const quint32 ByteOrderMark = 0x01020304;
+static const quint32 FileVersion = 1;
+static const qint64 MinimumCompactionLogSize = 256 * 1024;
+
+static inline qint64 paddedSize(qint64 size)
+{
+    return (size + 7) & ~qint64(7);
+}
+
+// FNV-1a; unlike qHashBits() it doesn't depend on the process or the CPU
+static quint64 recordChecksum(const uchar *data, qint64 size)
+{
+    quint64 hash = Q_UINT64_C(14695981039346656037);
+    for (qint64 i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= Q_UINT64_C(1099511628211);
+    }
+    return hash;
+}
+
+static bool isValidHeader(const FileHeader &header, qint64 fileSize)
+{
+    return memcmp(header.magic, FileMagic, sizeof(FileMagic)) == 0
+            && header.byteOrder == ByteOrderMark
+            && header.version == FileVersion
+            && header.indexOffset >= sizeof(FileHeader)
+            && header.indexOffset % 8 == 0
+            && header.logOffset >= header.indexOffset
+            && header.logOffset <= quint64(fileSize)
+            && header.logOffset % 8 == 0
+            && header.entryCount <= (header.logOffset - header.indexOffset) / sizeof(quint64);
+}
+
+static void appendPadding(QByteArray &data)
+{
+    data.append(paddedSize(data.size()) - data.size(), '\0');
+}
+
+static void appendLogRecord(QByteArray &data, QBinarySettingsChanges::Kind kind, QStringView key,
+                            QByteArrayView value)
+{
+    const qsizetype start = data.size();
+    const qsizetype keyBytes = key.size() * qsizetype(sizeof(QChar));
+
+    LogRecord record = {};
+    record.size = quint32(paddedSize(sizeof(LogRecord) + keyBytes + value.size()) + sizeof(quint64));
+    record.kind = kind;
+    record.keySize = quint32(key.size());
+    record.valueSize = quint32(value.size());
+
+    data.append(reinterpret_cast<const char *>(&record), sizeof(record));
+    data.append(reinterpret_cast<const char *>(key.utf16()), keyBytes);
+    data.append(value);
+    appendPadding(data);
+    const quint64 checksum = recordChecksum(reinterpret_cast<const uchar *>(data.constData()) + start,
+                                            data.size() - start);
+    data.append(reinterpret_cast<const char *>(&checksum), sizeof(checksum));
+}
+
+/*
+    Calls \a f for the changes in \a changes, in an order that gives the
+    same result when they are applied again.
+*/
+template <typename Function>
+static void forEachChange(const QBinarySettingsChanges &changes, Function f)
+{
+    if (changes.cleared)
+        f(QBinarySettingsChanges::Clear, QString(), QByteArray());
+    for (const QString &group : changes.removedGroups)
+        f(QBinarySettingsChanges::Remove, group, QByteArray());
+    for (auto it = changes.values.cbegin(); it != changes.values.cend(); ++it)
+        f(QBinarySettingsChanges::Set, it.key(), it.value());
+}
+
+static QByteArray variantToData(const QVariant &value)
+{
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream << value;
+    return data;
+}
+
+static QVariant dataToVariant(const QByteArray &data)
+{
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_6_0);
+    QVariant value;
+    stream >> value;
+    return value;
+}
+
+/*******************************************************************************
+** QBinarySettingsChanges
+*/
+
+void QBinarySettingsChanges::apply(Kind kind, const QString &key, const QByteArray &value)
+{
+    switch (kind) {
+    case Set:
+        values.insert(key, value);
+        break;
+    case Remove: {
+        const QString prefix = key + QLatin1Char('/');
+        values.remove(key);
+        auto it = values.lowerBound(prefix);
+        while (it != values.end() && it.key().startsWith(prefix))
+            it = values.erase(it);
+        removedGroups.insert(key);
+        break;
+    }
+    case Clear:
+        values.clear();
+        removedGroups.clear();
+        cleared = true;
+        break;
+    }
+}
+
+/*
+    Returns \c true if \a key, or one of the groups containing it, was
+    removed by these changes; that is, if the changes hide the value
+    that an older layer has for \a key.
+*/
+bool QBinarySettingsChanges::hides(QStringView key) const
+{
+    if (cleared)
+        return true;
+    if (removedGroups.isEmpty())
+        return false;
+    for (qsizetype i = 0; i <= key.size(); ++i) {
+        if ((i == key.size() || key.at(i) == QLatin1Char('/'))
+                && removedGroups.contains(key.left(i).toString())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+** QBinarySettingsFile
+*/
+
+typedef QHash<QString, QBinarySettingsFile *> BinaryFileHash;
+Q_GLOBAL_STATIC(BinaryFileHash, usedBinaryFilesFunc)
+static QBasicMutex binaryFilesMutex;
+
+QBinarySettingsFile::QBinarySettingsFile(const QString &fileName, bool _userPerms)
+    : name(fileName), userPerms(_userPerms)
+{
+}
+
+QBinarySettingsFile::~QBinarySettingsFile() = default;
+
+QBinarySettingsFile *QBinarySettingsFile::fromName(const QString &fileName, bool _userPerms)
+{
+    const QString absPath = QFileInfo(fileName).absoluteFilePath();
+
+    const auto locker = qt_scoped_lock(binaryFilesMutex);
+    BinaryFileHash *usedFiles = usedBinaryFilesFunc();
+    QBinarySettingsFile *file = usedFiles->value(absPath);
+    if (!file) {
+        file = new QBinarySettingsFile(absPath, _userPerms);
+        usedFiles->insert(absPath, file);
+    }
+    file->ref.ref();
+    return file;
+}
+
+void QBinarySettingsFile::release(QBinarySettingsFile *file)
+{
+    const auto locker = qt_scoped_lock(binaryFilesMutex);
+    if (!file->ref.deref()) {
+        if (BinaryFileHash *usedFiles = usedBinaryFilesFunc())
+            usedFiles->remove(file->name);
+        delete file;
+    }
+}
+
+bool QBinarySettingsFile::isWritable() const
+{
+    return QSettingsPrivate::isFileWritable(name);
+}
+
+void QBinarySettingsFile::close()
+{
+    mappedFile.reset();
+    fileContents.clear();
+    data = nullptr;
+    size = 0;
+    fileId = 0;
+    entries = 0;
+    indexOffset = 0;
+    logOffset = 0;
+    logEnd = 0;
+    logChanges = QBinarySettingsChanges();
+}
+
+/*
+    Brings the mapping up to date with the file on disk. If only records
+    were appended since the last call, only those are replayed; if the
+    file was compacted or replaced, it is mapped again from scratch.
+    This costs a few system calls when nothing changed.
+*/
+QSettings::Status QBinarySettingsFile::refresh()
+{
+    auto file = std::make_unique<QFile>(name);
+    if (!file->open(QIODevice::ReadOnly)) {
+        const bool missing = !file->exists();
+        close();
+        return missing ? QSettings::NoError : QSettings::AccessError;
+    }
+
+    const qint64 fileSize = file->size();
+    if (fileSize == 0) {
+        close();
+        return QSettings::NoError;
+    }
+
+    FileHeader header;
+    if (file->read(reinterpret_cast<char *>(&header), sizeof(header)) != qint64(sizeof(header))
+            || !isValidHeader(header, fileSize)) {
+        close();
+        return QSettings::FormatError;
+    }
+
+    if (data && header.fileId == fileId && fileSize == size && (logEnd == size || mappedFile)) {
+        // records written over a torn tail show up in the mapping
+        replayLog();
+        return QSettings::NoError;
+    }
+    const bool appended = data && header.fileId == fileId && fileSize >= logEnd;
+
+    const uchar *newData = file->map(0, fileSize);
+    QByteArray contents;
+    if (!newData) {
+        // some file systems cannot be mapped
+        if (!file->seek(0)) {
+            close();
+            return QSettings::AccessError;
+        }
+        contents = file->readAll();
+        if (contents.size() != fileSize) {
+            close();
+            return QSettings::AccessError;
+        }
+        newData = reinterpret_cast<const uchar *>(contents.constData());
+        file.reset();
+    }
+
+    if (!appended) {
+        close();
+        fileId = header.fileId;
+        entries = qint64(header.entryCount);
+        indexOffset = qint64(header.indexOffset);
+        logOffset = qint64(header.logOffset);
+        logEnd = logOffset;
+    }
+    // this drops the previous mapping, if any
+    mappedFile = std::move(file);
+    fileContents = contents;
+    data = newData;
+    size = fileSize;
+
+    replayLog();
+    return QSettings::NoError;
+}
+
+/*
+    Applies the log records from logEnd to the end of the mapping, stopping
+    at the first one that is incomplete or damaged.
+*/
+void QBinarySettingsFile::replayLog()
+{
+    while (size - logEnd >= qint64(sizeof(LogRecord) + sizeof(quint64))) {
+        const uchar *start = data + logEnd;
+        LogRecord record;
+        memcpy(&record, start, sizeof(record));
+
+        const qint64 keyBytes = qint64(record.keySize) * qint64(sizeof(QChar));
+        if (record.size % 8 != 0 || qint64(record.size) > size - logEnd
+                || qint64(sizeof(record)) + keyBytes + record.valueSize + qint64(sizeof(quint64))
+                        > qint64(record.size)
+                || record.kind < QBinarySettingsChanges::Set
+                || record.kind > QBinarySettingsChanges::Clear) {
+            break;
+        }
+        quint64 checksum;
+        memcpy(&checksum, start + record.size - sizeof(checksum), sizeof(checksum));
+        if (checksum != recordChecksum(start, record.size - sizeof(checksum)))
+            break;
+
+        const uchar *key = start + sizeof(record);
+        logChanges.apply(QBinarySettingsChanges::Kind(record.kind),
+                         QString(reinterpret_cast<const QChar *>(key), record.keySize),
+                         QByteArray(reinterpret_cast<const char *>(key + keyBytes),
+                                    record.valueSize));
+        logEnd += record.size;
+    }
+}
+
+QBinarySettingsFile::Entry QBinarySettingsFile::entry(qint64 index) const
+{
+    quint64 offset;
+    memcpy(&offset, data + indexOffset + index * qint64(sizeof(quint64)), sizeof(offset));
+    if (offset < sizeof(FileHeader) || offset % 8 != 0
+            || offset > quint64(indexOffset) - sizeof(EntryHeader)) {
+        return Entry();
+    }
+
+    EntryHeader header;
+    memcpy(&header, data + offset, sizeof(header));
+    const qint64 keyStart = qint64(offset) + qint64(sizeof(header));
+    const qint64 keyBytes = qint64(header.keySize) * qint64(sizeof(QChar));
+    if (keyBytes + header.valueSize > indexOffset - keyStart)
+        return Entry();
+
+    return { QStringView(reinterpret_cast<const QChar *>(data + keyStart), header.keySize),
+             QByteArrayView(reinterpret_cast<const char *>(data + keyStart + keyBytes),
+                            header.valueSize) };
+}
+
+// Returns the index of the first compacted entry whose key isn't less than \a key.
+qint64 QBinarySettingsFile::lowerBound(QStringView key) const
+{
+    qint64 first = 0;
+    qint64 count = entries;
+    while (count > 0) {
+        const qint64 step = count / 2;
+        if (entry(first + step).key.compare(key) < 0) {
+            first += step + 1;
+            count -= step + 1;
+        } else {
+            count = step;
+        }
+    }
+    return first;
+}
+
+bool QBinarySettingsFile::find(const QString &key, QByteArray *value) const
+{
+    for (const QBinarySettingsChanges *changes : { &pendingChanges, &logChanges }) {
+        const auto it = changes->values.constFind(key);
+        if (it != changes->values.constEnd()) {
+            if (value)
+                *value = it.value();
+            return true;
+        }
+        if (changes->hides(key))
+            return false;
+    }
+
+    const qint64 i = lowerBound(key);
+    if (i == entries)
+        return false;
+    const Entry e = entry(i);
+    if (e.key != QStringView(key))
+        return false;
+    if (value)
+        *value = e.value.toByteArray();
+    return true;
+}
+
+void QBinarySettingsFile::children(const QString &prefix, QSettingsPrivate::ChildSpec spec,
+                                   QStringList &result) const
+{
+    const qsizetype startPos = prefix.size();
+
+    if (!pendingChanges.cleared && !logChanges.cleared) {
+        for (qint64 i = lowerBound(prefix); i < entries; ++i) {
+            const QStringView key = entry(i).key;
+            if (!key.startsWith(prefix))
+                break;
+            if (!logChanges.hides(key) && !pendingChanges.hides(key))
+                QSettingsPrivate::processChild(key.mid(startPos), spec, result);
+        }
+    }
+
+    for (const QBinarySettingsChanges *changes : { &logChanges, &pendingChanges }) {
+        auto it = changes->values.lowerBound(prefix);
+        for (; it != changes->values.cend() && it.key().startsWith(prefix); ++it) {
+            if (changes == &pendingChanges || !pendingChanges.hides(it.key()))
+                QSettingsPrivate::processChild(QStringView(it.key()).mid(startPos), spec, result);
+        }
+    }
+}
+
+/*
+    Writes the pending changes to disk. They are appended to the log,
+    unless the file has to be created; if the log has grown large, the
+    file is compacted afterwards.
+*/
+QSettings::Status QBinarySettingsFile::sync(bool atomicSyncOnly)
+{
+    if (pendingChanges.isEmpty())
+        return refresh();
+
+    if (!isWritable())
+        return QSettings::AccessError;
+
+    /*
+        Only concurrent writers need to be serialized. Readers stop at the
+        last complete record, so they never see a partial write.
+    */
+    QLockFile lockFile(name + QLatin1String(".lock"));
+    if (!lockFile.lock() && atomicSyncOnly)
+        return QSettings::AccessError;
+
+    const QSettings::Status status = refresh();
+    if (status == QSettings::AccessError)
+        return status;
+
+    // missing, empty or damaged: start over with a compacted file
+    if (!data)
+        return compact(atomicSyncOnly) ? status : QSettings::AccessError;
+
+    QByteArray records;
+    forEachChange(pendingChanges, [&records](QBinarySettingsChanges::Kind kind,
+                                             const QString &key, const QByteArray &value) {
+        appendLogRecord(records, kind, key, value);
+    });
+
+    QFile file(name);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Unbuffered))
+        return QSettings::AccessError;
+    if (!file.seek(logEnd) || file.write(records) != records.size())
+        return QSettings::AccessError;
+    /*
+        Overwrite whatever a writer that crashed left after the last complete
+        record, instead of truncating it: readers that have the file mapped
+        would get SIGBUS when touching the pages past the new end. A record
+        size of zero stops the replay.
+    */
+    const qint64 tornSize = file.size() - logEnd - records.size();
+    if (tornSize > 0 && file.write(QByteArray(tornSize, '\0')) != tornSize)
+        return QSettings::AccessError;
+    file.close();
+
+    forEachChange(pendingChanges, [this](QBinarySettingsChanges::Kind kind,
+                                         const QString &key, const QByteArray &value) {
+        logChanges.apply(kind, key, value);
+    });
+    pendingChanges = QBinarySettingsChanges();
+    logEnd += records.size();
+
+    // a failed compaction leaves a valid file behind, so it's only retried later
+    if (logEnd - logOffset > qMax(MinimumCompactionLogSize, logOffset / 2))
+        compact(atomicSyncOnly);
+    return status;
+}
+
+/*
+    Rewrites the file with all values, including the pending ones, in its
+    compacted part and an empty log. Must be called with the lock file held.
+*/
+bool QBinarySettingsFile::compact(bool atomicSyncOnly)
+{
+    // the values newer than the compacted part, in key order
+    QMap<QString, QByteArray> newValues;
+    if (!pendingChanges.cleared) {
+        for (auto it = logChanges.values.cbegin(); it != logChanges.values.cend(); ++it) {
+            if (!pendingChanges.hides(it.key()))
+                newValues.insert(it.key(), it.value());
+        }
+    }
+    for (auto it = pendingChanges.values.cbegin(); it != pendingChanges.values.cend(); ++it)
+        newValues.insert(it.key(), it.value());
+
+    QByteArray contents(sizeof(FileHeader), '\0');
+    QList<quint64> index;
+    const auto appendEntry = [&contents, &index](QStringView key, QByteArrayView value) {
+        index.append(quint64(contents.size()));
+        const EntryHeader header = { quint32(key.size()), quint32(value.size()) };
+        contents.append(reinterpret_cast<const char *>(&header), sizeof(header));
+        contents.append(reinterpret_cast<const char *>(key.utf16()),
+                        key.size() * qsizetype(sizeof(QChar)));
+        contents.append(value);
+        appendPadding(contents);
+    };
+
+    // merge the compacted entries that are still visible with the newer values
+    auto it = newValues.cbegin();
+    const bool keepEntries = !logChanges.cleared && !pendingChanges.cleared;
+    for (qint64 i = 0; keepEntries && i < entries; ++i) {
+        const Entry e = entry(i);
+        for (; it != newValues.cend() && QStringView(it.key()).compare(e.key) < 0; ++it)
+            appendEntry(it.key(), it.value());
+        if (it != newValues.cend() && QStringView(it.key()) == e.key)
+            continue; // replaced
+        if (!logChanges.hides(e.key) && !pendingChanges.hides(e.key))
+            appendEntry(e.key, e.value);
+    }
+    for (; it != newValues.cend(); ++it)
+        appendEntry(it.key(), it.value());
+
+    FileHeader header = {};
+    memcpy(header.magic, FileMagic, sizeof(FileMagic));
+    header.byteOrder = ByteOrderMark;
+    header.version = FileVersion;
+    header.fileId = QRandomGenerator::global()->generate64() | 1;
+    header.indexOffset = quint64(contents.size());
+    header.entryCount = quint64(index.size());
+    contents.append(reinterpret_cast<const char *>(index.constData()),
+                    index.size() * qsizetype(sizeof(quint64)));
+    header.logOffset = quint64(contents.size());
+    memcpy(contents.data(), &header, sizeof(header));
+
+    const bool createFile = !QFileInfo::exists(name);
+
+    // Windows cannot replace a file that is still mapped, by this process
+    // or any other; in the latter case, commit() fails
+    close();
+
+#if QT_CONFIG(temporaryfile)
+    QSaveFile file(name);
+    file.setDirectWriteFallback(!atomicSyncOnly);
+#else
+    Q_UNUSED(atomicSyncOnly);
+    QFile file(name);
+#endif
+    bool ok = file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+#if QT_CONFIG(temporaryfile)
+    if (ok)
+        ok = file.commit();
+#else
+    file.close();
+#endif
+
+    if (ok) {
+        // If we have created the file, apply the file perms
+        if (createFile) {
+            QFile::Permissions perms = QFileInfo(name).permissions()
+                    | QFile::ReadOwner | QFile::WriteOwner;
+            if (!userPerms)
+                perms |= QFile::ReadGroup | QFile::ReadOther;
+            QFile(name).setPermissions(perms);
+        }
+        pendingChanges = QBinarySettingsChanges();
+    }
+
+    refresh();
+    return ok;
+}
+
+/*******************************************************************************
+** QBinarySettingsPrivate
+*/
+
+QBinarySettingsPrivate::QBinarySettingsPrivate(QSettings::Scope scope,
+                                               const QString &organization,
+                                               const QString &application)
+    : QSettingsPrivate(QSettings::BinaryFormat, scope, organization, application)
+{
+    QString org = organization;
+    if (org.isEmpty()) {
+        setStatus(QSettings::AccessError);
+        org = QLatin1String("Unknown Organization");
+    }
+
+    const auto settingsFileList = settingsFiles(QSettings::BinaryFormat, scope, org, application,
+                                                QStringLiteral(".qsettings"));
+    for (const SettingsFile &file : settingsFileList)
+        files.append(QBinarySettingsFile::fromName(file.name, file.userPerms));
+
+    sync(); // maps the files the first time
+}
+
+QBinarySettingsPrivate::QBinarySettingsPrivate(const QString &fileName)
+    : QSettingsPrivate(QSettings::BinaryFormat)
+{
+    files.append(QBinarySettingsFile::fromName(fileName, true));
+
+    sync(); // maps the file the first time
+}
+
+QBinarySettingsPrivate::~QBinarySettingsPrivate()
+{
+    for (QBinarySettingsFile *file : qAsConst(files))
+        QBinarySettingsFile::release(file);
+}
+
+void QBinarySettingsPrivate::remove(const QString &key)
+{
+    if (files.isEmpty())
+        return;
+
+    // Note: First file is always the most specific.
+    QBinarySettingsFile *file = files.at(0);
+    const auto locker = qt_scoped_lock(file->mutex);
+    file->pendingChanges.apply(QBinarySettingsChanges::Remove, key);
+}
+
+void QBinarySettingsPrivate::set(const QString &key, const QVariant &value)
+{
+    if (files.isEmpty())
+        return;
+
+    const QByteArray data = variantToData(value);
+    QBinarySettingsFile *file = files.at(0);
+    const auto locker = qt_scoped_lock(file->mutex);
+    file->pendingChanges.apply(QBinarySettingsChanges::Set, key, data);
+}
+
+bool QBinarySettingsPrivate::get(const QString &key, QVariant *value) const
+{
+    QByteArray data;
+    for (QBinarySettingsFile *file : files) {
+        bool found;
+        {
+            const auto locker = qt_scoped_lock(file->mutex);
+            found = file->find(key, value ? &data : nullptr);
+        }
+        if (found) {
+            if (value)
+                *value = dataToVariant(data);
+            return true;
+        }
+        if (!fallbacks)
+            break;
+    }
+    return false;
+}
+
+QStringList QBinarySettingsPrivate::children(const QString &prefix, ChildSpec spec) const
+{
+    QStringList result;
+    for (QBinarySettingsFile *file : files) {
+        const auto locker = qt_scoped_lock(file->mutex);
+        file->children(prefix, spec, result);
+        if (!fallbacks)
+            break;
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()),
+                 result.end());
+    return result;
+}
+
+void QBinarySettingsPrivate::clear()
+{
+    if (files.isEmpty())
+        return;
+
+    QBinarySettingsFile *file = files.at(0);
+    const auto locker = qt_scoped_lock(file->mutex);
+    file->pendingChanges.apply(QBinarySettingsChanges::Clear, QString());
+}
+
+void QBinarySettingsPrivate::sync()
+{
+    // as with the other file formats, go on after an error and report the first one
+    for (QBinarySettingsFile *file : qAsConst(files)) {
+        const auto locker = qt_scoped_lock(file->mutex);
+        const QSettings::Status fileStatus = file->sync(atomicSyncOnly);
+        if (fileStatus != QSettings::NoError)
+            setStatus(fileStatus);
+    }
+}
+
+void QBinarySettingsPrivate::flush()
+{
+    sync();
+}
+
+bool QBinarySettingsPrivate::isWritable() const
+{
+    if (files.isEmpty())
+        return false;
+
+    return files.at(0)->isWritable();
+}
+
+QString QBinarySettingsPrivate::fileName() const
+{
+    if (files.isEmpty())
+        return QString();
+
+    return files.at(0)->name;
+}
+
+QT_END_NAMESPACE
@@ -569,6 +569,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format,
         QSettingsPrivate *newSettings;
         if (format == QSettings::NativeFormat) {
             newSettings = new QMacSettingsPrivate(scope, organizationDomain, applicationName);
+        } else if (format == QSettings::BinaryFormat) {
+            newSettings = new QBinarySettingsPrivate(scope, organizationDomain, applicationName);
         } else {
             newSettings = new QConfFileSettingsPrivate(format, scope, organizationDomain, applicationName);
         }
@@ -582,6 +584,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format,
 #endif
     if (format == QSettings::NativeFormat) {
         return new QMacSettingsPrivate(scope, organization, application);
+    } else if (format == QSettings::BinaryFormat) {
+        return new QBinarySettingsPrivate(scope, organization, application);
     } else {
         return new QConfFileSettingsPrivate(format, scope, organization, application);
     }
@@ -52,9 +52,11 @@
 //
 
 #include "QtCore/qdatetime.h"
+#include "QtCore/qfile.h"
 #include "QtCore/qmap.h"
 #include "QtCore/qmutex.h"
 #include "QtCore/qiodevice.h"
+#include "QtCore/qset.h"
 #include "QtCore/qstack.h"
 #include "QtCore/qstringlist.h"
 
@@ -66,6 +68,8 @@
 #endif
 #include "private/qscopedpointer_p.h"
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 #ifndef Q_OS_WIN
@@ -222,6 +226,17 @@ public:
 
     static void processChild(QStringView key, ChildSpec spec, QStringList &result);
 
+    struct SettingsFile
+    {
+        QString name;
+        bool userPerms;
+    };
+    static QList<SettingsFile> settingsFiles(QSettings::Format format, QSettings::Scope scope,
+                                             const QString &organization,
+                                             const QString &application,
+                                             const QString &extension);
+    static bool isFileWritable(const QString &name);
+
     // Variant streaming functions
     static QStringList variantListToStringList(const QVariantList &l);
     static QVariant stringListToVariantList(const QStringList &l);
@@ -304,6 +319,96 @@ private:
 #endif
 };
 
+class QBinarySettingsChanges
+{
+public:
+    enum Kind : quint8 { Set = 1, Remove, Clear };
+
+    void apply(Kind kind, const QString &key, const QByteArray &value = QByteArray());
+    bool hides(QStringView key) const;
+    bool isEmpty() const { return !cleared && removedGroups.isEmpty() && values.isEmpty(); }
+
+    QMap<QString, QByteArray> values;
+    QSet<QString> removedGroups;
+    bool cleared = false;
+};
+
+class Q_AUTOTEST_EXPORT QBinarySettingsFile
+{
+public:
+    ~QBinarySettingsFile();
+
+    static QBinarySettingsFile *fromName(const QString &name, bool userPerms);
+    static void release(QBinarySettingsFile *file);
+
+    QSettings::Status refresh();
+    QSettings::Status sync(bool atomicSyncOnly);
+    bool isWritable() const;
+
+    bool find(const QString &key, QByteArray *value) const;
+    void children(const QString &prefix, QSettingsPrivate::ChildSpec spec,
+                  QStringList &result) const;
+
+    qint64 entryCount() const { return entries; }
+    qint64 logSize() const { return logEnd - logOffset; }
+
+    QString name;
+    QAtomicInt ref;
+    QMutex mutex;
+    bool userPerms;
+    QBinarySettingsChanges pendingChanges;
+
+private:
+    Q_DISABLE_COPY(QBinarySettingsFile)
+    QBinarySettingsFile(const QString &name, bool userPerms);
+
+    struct Entry
+    {
+        QStringView key;
+        QByteArrayView value;
+    };
+    Entry entry(qint64 index) const;
+    qint64 lowerBound(QStringView key) const;
+    void close();
+    void replayLog();
+    bool compact(bool atomicSyncOnly);
+
+    std::unique_ptr<QFile> mappedFile;
+    QByteArray fileContents; // used if the file cannot be mapped
+    const uchar *data = nullptr;
+    qint64 size = 0;
+    quint64 fileId = 0;
+    qint64 entries = 0;
+    qint64 indexOffset = 0;
+    qint64 logOffset = 0;
+    qint64 logEnd = 0;
+    QBinarySettingsChanges logChanges;
+};
+
+class QBinarySettingsPrivate : public QSettingsPrivate
+{
+public:
+    QBinarySettingsPrivate(QSettings::Scope scope, const QString &organization,
+                           const QString &application);
+    QBinarySettingsPrivate(const QString &fileName);
+    ~QBinarySettingsPrivate();
+
+    void remove(const QString &key) override;
+    void set(const QString &key, const QVariant &value) override;
+    bool get(const QString &key, QVariant *value) const override;
+
+    QStringList children(const QString &prefix, ChildSpec spec) const override;
+
+    void clear() override;
+    void sync() override;
+    void flush() override;
+    bool isWritable() const override;
+    QString fileName() const override;
+
+private:
+    QList<QBinarySettingsFile *> files;
+};
+
 QT_END_NAMESPACE
 
 #endif // QSETTINGS_P_H
@@ -842,6 +842,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
         return new QWinSettingsPrivate(scope, organization, application, KEY_WOW64_32KEY);
     case QSettings::Registry64Format:
         return new QWinSettingsPrivate(scope, organization, application, KEY_WOW64_64KEY);
+    case QSettings::BinaryFormat:
+        return new QBinarySettingsPrivate(scope, organization, application);
     default:
         break;
     }
@@ -857,6 +859,8 @@ QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::F
         return new QWinSettingsPrivate(fileName, KEY_WOW64_32KEY);
     case QSettings::Registry64Format:
         return new QWinSettingsPrivate(fileName, KEY_WOW64_64KEY);
+    case QSettings::BinaryFormat:
+        return new QBinarySettingsPrivate(fileName);
     default:
         break;
     }
@@ -55,10 +55,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <limits>
+
 #ifndef QT_NO_EVENTFD
 #  include <sys/eventfd.h>
 #endif
 
+#if QT_CONFIG(epoll)
+#  include <sys/epoll.h>
+#  include <pthread.h>
+#endif
+
 // VxWorks doesn't correctly set the _POSIX_... options
 #if defined(Q_OS_VXWORKS)
 #  if defined(_POSIX_MONOTONIC_CLOCK) && (_POSIX_MONOTONIC_CLOCK <= 0)
@@ -226,10 +233,19 @@ QEventDispatcherUNIXPrivate::QEventDispatcherUNIXPrivate()
 {
     if (Q_UNLIKELY(threadPipe.init() == false))
         qFatal("QEventDispatcherUNIXPrivate(): Cannot continue without a thread pipe");
+
+#if QT_CONFIG(epoll)
+    if (qEnvironmentVariableIntValue("QT_EVENT_DISPATCHER_EPOLL") > 0)
+        initEpoll();
+#endif
 }
 
 QEventDispatcherUNIXPrivate::~QEventDispatcherUNIXPrivate()
 {
+#if QT_CONFIG(epoll)
+    closeEpoll();
+#endif
+
     // cleanup timers
     qDeleteAll(timerList);
 }
@@ -289,6 +305,191 @@ void QEventDispatcherUNIXPrivate::markPendingSocketNotifiers()
     pollfds.clear();
 }
 
+#if QT_CONFIG(epoll)
+// The epoll backend keeps the kernel's interest list in sync with
+// socketNotifiers, so a wait only returns the descriptors that are ready
+// instead of re-submitting every registered one as poll() has to.
+// The event bits are shared with poll(), which lets the ready descriptors
+// go through markPendingSocketNotifiers() unchanged.
+//
+// The kernel keys the interest list by open file, not by descriptor: a
+// descriptor that is closed while its notifiers are enabled is dropped
+// without an event (never POLLNVAL) if it was the last reference to the
+// file, and keeps reporting the file's events under its old number if it
+// was not, even after that number has been reused. Such an entry cannot be
+// removed any more. So every registration is tagged, and every event is
+// checked to come from the current registration of a descriptor that
+// still refers to the same file; if one does not, the dispatcher falls
+// back to poll(), which reports closed descriptors with POLLNVAL.
+static_assert(EPOLLIN == POLLIN && EPOLLOUT == POLLOUT && EPOLLPRI == POLLPRI
+              && EPOLLERR == POLLERR && EPOLLHUP == POLLHUP);
+
+// An epoll instance survives fork(), and the child would share the
+// parent's interest list: count the forks, so that a dispatcher used in a
+// child process creates its own instance.
+static QBasicAtomicInt epollForkCount = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+static void epollAtForkChild()
+{
+    epollForkCount.ref();
+}
+
+static int epollTimeout(const timespec &ts)
+{
+    // round up, so that we don't wake up before the next timer is due
+    const qint64 msecs = qint64(ts.tv_sec) * 1000 + (ts.tv_nsec + 999999) / 1000000;
+    return int(qMin<qint64>(msecs, std::numeric_limits<int>::max()));
+}
+
+bool QEventDispatcherUNIXPrivate::initEpoll()
+{
+    static const bool atForkRegistered = pthread_atfork(nullptr, nullptr, epollAtForkChild) == 0;
+    if (!atForkRegistered)
+        return false;
+
+    epollForkGeneration = epollForkCount.loadRelaxed();
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        perror("QEventDispatcherUNIXPrivate: Unable to create epoll instance, using poll()");
+        return false;
+    }
+
+    // the thread pipe is watched for the whole lifetime of the dispatcher
+    if (!updateEpollEvents(threadPipe.fds[0], POLLIN, true))
+        return false;
+
+    for (auto it = socketNotifiers.cbegin(); it != socketNotifiers.cend(); ++it) {
+        if (!updateEpollEvents(it.key(), it.value().events(), true))
+            return false;
+    }
+
+    return true;
+}
+
+void QEventDispatcherUNIXPrivate::closeEpoll()
+{
+    if (epollFd != -1) {
+        qt_safe_close(epollFd);
+        epollFd = -1;
+    }
+    epollTags.clear();
+}
+
+// Returns false if epoll is not in use (any more).
+bool QEventDispatcherUNIXPrivate::checkEpollAfterFork()
+{
+    if (epollFd == -1)
+        return false;
+    if (Q_LIKELY(epollForkGeneration == epollForkCount.loadRelaxed()))
+        return true;
+    closeEpoll();
+    return initEpoll();
+}
+
+bool QEventDispatcherUNIXPrivate::updateEpollEvents(int fd, short events, bool added)
+{
+    if (!checkEpollAfterFork())
+        return false;
+
+    if (events == 0) {
+        // the descriptor may already have been closed, which removes it implicitly
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        epollTags.remove(fd);
+        return true;
+    }
+
+    if (++lastEpollTag == 0)
+        ++lastEpollTag;
+
+    epoll_event ev = {};
+    ev.events = uint(events);
+    ev.data.u64 = quint64(lastEpollTag) << 32 | quint32(fd);
+
+    // a descriptor that was closed and reused behind our back is no longer
+    // known to epoll, and one we did not know about may still be, so retry
+    // with the other operation before giving up
+    int ret = epoll_ctl(epollFd, added ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+    if (ret == -1 && errno == (added ? EEXIST : ENOENT))
+        ret = epoll_ctl(epollFd, added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+
+    if (ret == -1) {
+        // e.g. EPERM for regular files, which poll() always reports as ready;
+        // the notifiers are still in socketNotifiers, so poll() takes over
+        closeEpoll();
+        return false;
+    }
+
+    epollTags.insert(fd, lastEpollTag);
+    return true;
+}
+
+// Returns -1 if epoll had to be given up, in which case the caller has to
+// poll() instead.
+int QEventDispatcherUNIXPrivate::processEpollEvents(const timespec *tm)
+{
+    if (!checkEpollAfterFork())
+        return -1;
+
+    enum { MaxEvents = 256 };
+    epoll_event events[MaxEvents];
+
+    int timeout = tm ? epollTimeout(*tm) : -1;
+    const timespec start = tm ? qt_gettime() : timespec{};
+    int n;
+    forever {
+        n = epoll_wait(epollFd, events, MaxEvents, timeout);
+        if (n != -1 || errno != EINTR)
+            break;
+        if (tm) {
+            // wait for what is left of the timeout, as qt_safe_poll() does
+            const timespec remaining = *tm + start - qt_gettime();
+            if (remaining.tv_sec < 0)
+                return 0;
+            timeout = epollTimeout(remaining);
+        }
+    }
+    if (n == -1) {
+        perror("epoll_wait");
+        return 0;
+    }
+
+    // check all the events before consuming any, so that poll() gets to
+    // see a wake-up of the thread pipe
+    for (int i = 0; i < n; ++i) {
+        const int fd = int(quint32(events[i].data.u64));
+        const auto it = epollTags.constFind(fd);
+        bool valid = it != epollTags.cend() && it.value() == quint32(events[i].data.u64 >> 32);
+        if (valid && fd != threadPipe.fds[0]) {
+            // fails with EBADF if the descriptor was closed, and with ENOENT
+            // if it now refers to another file
+            epoll_event ev = {};
+            ev.events = uint(socketNotifiers.value(fd).events());
+            ev.data = events[i].data;
+            valid = epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &ev) == 0;
+        }
+        if (Q_UNLIKELY(!valid)) {
+            closeEpoll();
+            return -1;
+        }
+    }
+
+    int nevents = 0;
+    pollfds.clear();
+
+    for (int i = 0; i < n; ++i) {
+        pollfd pfd = qt_make_pollfd(int(quint32(events[i].data.u64)), 0);
+        pfd.revents = short(events[i].events);
+
+        if (pfd.fd == threadPipe.fds[0])
+            nevents += threadPipe.check(pfd);
+        else if (socketNotifiers.contains(pfd.fd))
+            pollfds.append(pfd);
+    }
+
+    return nevents + activateSocketNotifiers();
+}
+#endif // QT_CONFIG(epoll)
+
 int QEventDispatcherUNIXPrivate::activateSocketNotifiers()
 {
     markPendingSocketNotifiers();
@@ -411,7 +612,16 @@ void QEventDispatcherUNIX::registerSocketNotifier(QSocketNotifier *notifier)
         qWarning("%s: Multiple socket notifiers for same socket %d and type %s",
                  Q_FUNC_INFO, sockfd, socketType(type));
 
+#if QT_CONFIG(epoll)
+    const bool added = sn_set.isEmpty();
+#endif
+
     sn_set.notifiers[type] = notifier;
+
+#if QT_CONFIG(epoll)
+    if (d->epollFd != -1)
+        d->updateEpollEvents(sockfd, sn_set.events(), added);
+#endif
 }
 
 void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
@@ -452,6 +662,11 @@ void QEventDispatcherUNIX::unregisterSocketNotifier(QSocketNotifier *notifier)
 
     sn_set.notifiers[type] = nullptr;
 
+#if QT_CONFIG(epoll)
+    if (d->epollFd != -1)
+        d->updateEpollEvents(sockfd, sn_set.events(), false);
+#endif
+
     if (sn_set.isEmpty())
         d->socketNotifiers.erase(i);
 }
@@ -487,29 +702,38 @@ bool QEventDispatcherUNIX::processEvents(QEventLoop::ProcessEventsFlags flags)
     if (!canWait || (include_timers && d->timerList.timerWait(wait_tm)))
         tm = &wait_tm;
 
-    d->pollfds.clear();
-    d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
+    int nevents = -1;
 
-    if (include_notifiers)
-        for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
-            d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
-
-    // This must be last, as it's popped off the end below
-    d->pollfds.append(d->threadPipe.prepare());
-
-    int nevents = 0;
+#if QT_CONFIG(epoll)
+    // the epoll set always contains the notifiers, so excluding them
+    // has to go through poll() on the thread pipe alone
+    if (d->epollFd != -1 && include_notifiers)
+        nevents = d->processEpollEvents(tm);
+#endif
+    if (nevents == -1) {
+        nevents = 0;
+        d->pollfds.clear();
+        d->pollfds.reserve(1 + (include_notifiers ? d->socketNotifiers.size() : 0));
 
-    switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
-    case -1:
-        perror("qt_safe_poll");
-        break;
-    case 0:
-        break;
-    default:
-        nevents += d->threadPipe.check(d->pollfds.takeLast());
         if (include_notifiers)
-            nevents += d->activateSocketNotifiers();
-        break;
+            for (auto it = d->socketNotifiers.cbegin(); it != d->socketNotifiers.cend(); ++it)
+                d->pollfds.append(qt_make_pollfd(it.key(), it.value().events()));
+
+        // This must be last, as it's popped off the end below
+        d->pollfds.append(d->threadPipe.prepare());
+
+        switch (qt_safe_poll(d->pollfds.data(), d->pollfds.size(), tm)) {
+        case -1:
+            perror("qt_safe_poll");
+            break;
+        case 0:
+            break;
+        default:
+            nevents += d->threadPipe.check(d->pollfds.takeLast());
+            if (include_notifiers)
+                nevents += d->activateSocketNotifiers();
+            break;
+        }
     }
 
     if (include_timers)
@@ -138,6 +138,19 @@ public:
     int activateSocketNotifiers();
     void setSocketNotifierPending(QSocketNotifier *notifier);
 
+#if QT_CONFIG(epoll)
+    bool initEpoll();
+    void closeEpoll();
+    bool checkEpollAfterFork();
+    bool updateEpollEvents(int fd, short events, bool added);
+    int processEpollEvents(const timespec *tm);
+
+    int epollFd = -1;
+    int epollForkGeneration = 0;
+    quint32 lastEpollTag = 0;
+    QHash<int, quint32> epollTags; // current registration of each descriptor
+#endif
+
     QThreadPipe threadPipe;
     QList<pollfd> pollfds;
 
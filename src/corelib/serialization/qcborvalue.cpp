@@ -298,6 +298,20 @@ QT_BEGIN_NAMESPACE
     \sa toDiagnosticNotation()
  */
 
+/*!
+    \enum QCborValue::DecodingOption
+    \since 6.0
+
+    This enum is used in the options argument to fromCbor(), modifying the
+    behavior of the decoder.
+
+    \value NoDecodingOptions    (Default) Copies all string contents into the decoded value.
+    \value ReferenceSourceData  Makes text and byte strings of definite length refer to
+                                the source buffer instead of copying them.
+
+    \sa fromCbor()
+ */
+
 /*!
     \enum QCborValue::Type
 
@@ -770,7 +784,7 @@ static QCborValue::Type convertToExtendedType(QCborContainerPrivate *d)
 {
     qint64 tag = d->elements.at(0).value;
     auto &e = d->elements[1];
-    const ByteData *b = d->byteData(e);
+    const ByteData b = d->byteData(e);
 
     auto replaceByteData = [&](const char *buf, qsizetype len, Element::ValueFlags f) {
         d->data.clear();
@@ -787,7 +801,7 @@ static QCborValue::Type convertToExtendedType(QCborContainerPrivate *d)
             e.type == QCborValue::String && (e.flags & Element::StringIsUtf16) == 0) {
             // The data is supposed to be US-ASCII. If it isn't (contains UTF-8),
             // QDateTime::fromString will fail anyway.
-            dt = QDateTime::fromString(b->asLatin1(), Qt::ISODateWithMs);
+            dt = QDateTime::fromString(b.asLatin1(), Qt::ISODateWithMs);
         } else if (tag == qint64(QCborKnownTags::UnixTime_t)) {
             qint64 msecs;
             bool ok = false;
@@ -826,8 +840,8 @@ static QCborValue::Type convertToExtendedType(QCborContainerPrivate *d)
             if (b) {
                 // normalize to a short (decoded) form, so as to save space
                 QUrl url(e.flags & Element::StringIsUtf16 ?
-                             b->asQStringRaw() :
-                             b->toUtf8String(), QUrl::StrictMode);
+                             b.asQStringRaw() :
+                             b.toUtf8String(), QUrl::StrictMode);
                 if (url.isValid()) {
                     QByteArray encoded = url.toString(QUrl::DecodeReserved).toUtf8();
                     replaceByteData(encoded, encoded.size(), {});
@@ -852,7 +866,7 @@ static QCborValue::Type convertToExtendedType(QCborContainerPrivate *d)
             // force the size to 16
             char buf[sizeof(QUuid)] = {};
             if (b)
-                memcpy(buf, b->byte(), qMin(sizeof(buf), size_t(b->len)));
+                memcpy(buf, b.byte(), qMin(sizeof(buf), size_t(b.len)));
             replaceByteData(buf, sizeof(buf), {});
 
             return QCborValue::Uuid;
@@ -1013,11 +1027,14 @@ void QCborContainerPrivate::replaceAt_complex(Element &e, const QCborValue &valu
         e = value.container->elements.at(value.n);
 
         // Copy string data, if any
-        if (const ByteData *b = value.container->byteData(value.n)) {
+        if (e.flags & Element::ByteDataInSource && source.constData() == value.container->source.constData()) {
+            // both containers reference the same encoded buffer, nothing to copy
+        } else if (const ByteData b = value.container->byteData(value.n)) {
             if (this == value.container)
-                e.value = addByteData(b->toByteArray(), b->len);
+                e.value = addByteData(b.toByteArray(), b.len);
             else
-                e.value = addByteData(b->byte(), b->len);
+                e.value = addByteData(b.byte(), b.len);
+            e.flags &= ~Element::ByteDataInSource;
         }
 
         if (disp == MoveContainer)
@@ -1037,7 +1054,7 @@ Q_NEVER_INLINE void QCborContainerPrivate::appendAsciiString(QStringView s)
     e.flags = Element::HasByteData | Element::StringIsAscii;
     elements.append(e);
 
-    char *ptr = data.data() + e.value + sizeof(ByteData);
+    char *ptr = data.data() + e.value + sizeof(ByteDataHeader);
     uchar *l = reinterpret_cast<uchar *>(ptr);
     qt_to_latin1_unchecked(l, s.utf16(), len);
 }
@@ -1047,13 +1064,18 @@ QCborValue QCborContainerPrivate::extractAt_complex(Element e)
     // create a new container for the returned value, containing the byte data
     // from this element, if it's worth it
     Q_ASSERT(e.flags & Element::HasByteData);
-    auto b = byteData(e);
+    const ByteData b = byteData(e);
     auto container = new QCborContainerPrivate;
 
-    if (b->len + qsizetype(sizeof(*b)) < data.size() / 4) {
+    if (e.flags & Element::ByteDataInSource) {
+        // keep referencing the encoded buffer
+        container->source = source;
+        container->elements.reserve(1);
+        container->elements.append(e);
+    } else if (b.len + qsizetype(sizeof(ByteDataHeader)) < data.size() / 4) {
         // make a shallow copy of the byte data
-        container->appendByteData(b->byte(), b->len, e.type, e.flags);
-        usedData -= b->len + qsizetype(sizeof(*b));
+        container->appendByteData(b.byte(), b.len, e.type, e.flags);
+        usedData -= b.len + qsizetype(sizeof(ByteDataHeader));
         compact(elements.size());
     } else {
         // just share with the original byte data
@@ -1122,11 +1144,11 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
                                 e2.flags & Element::IsContainer ? e2.container : nullptr);
 
     // string data?
-    const ByteData *b1 = c1 ? c1->byteData(e1) : nullptr;
-    const ByteData *b2 = c2 ? c2->byteData(e2) : nullptr;
+    const ByteData b1 = c1 ? c1->byteData(e1) : ByteData();
+    const ByteData b2 = c2 ? c2->byteData(e2) : ByteData();
     if (b1 || b2) {
-        auto len1 = b1 ? b1->len : 0;
-        auto len2 = b2 ? b2->len : 0;
+        auto len1 = b1 ? b1.len : 0;
+        auto len2 = b2 ? b2.len : 0;
 
         if (e1.flags & Element::StringIsUtf16)
             len1 /= 2;
@@ -1153,7 +1175,7 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
             // Case 1: both UTF-16, so lengths are comparable.
             // (we can't use memcmp in little-endian machines)
             if (len1 == len2)
-                return QtPrivate::compareStrings(b1->asStringView(), b2->asStringView());
+                return QtPrivate::compareStrings(b1.asStringView(), b2.asStringView());
             return len1 < len2 ? -1 : 1;
         }
 
@@ -1161,7 +1183,7 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
             // Cases 4, 5 and 6: neither is UTF-16, so lengths are comparable too
             // (this case includes byte arrays too)
             if (len1 == len2)
-                return memcmp(b1->byte(), b2->byte(), size_t(len1));
+                return memcmp(b1.byte(), b2.byte(), size_t(len1));
             return len1 < len2 ? -1 : 1;
         }
 
@@ -1169,8 +1191,8 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
             // Case 2: one of them is UTF-8 and the other is UTF-16, so lengths
             // are NOT comparable. We need to convert to UTF-16 first...
             // (we can't use QUtf8::compareUtf8 because we need to compare lengths)
-            auto string = [](const Element &e, const ByteData *b) {
-                return e.flags & Element::StringIsUtf16 ? b->asQStringRaw() : b->toUtf8String();
+            auto string = [](const Element &e, const ByteData &b) {
+                return e.flags & Element::StringIsUtf16 ? b.asQStringRaw() : b.toUtf8String();
             };
 
             QString s1 = string(e1, b1);
@@ -1184,8 +1206,8 @@ static int compareElementRecursive(const QCborContainerPrivate *c1, const Elemen
         if (len1 != len2)
             return len1 < len2 ? -1 : 1;
         if (e1.flags & Element::StringIsUtf16)
-            return QtPrivate::compareStrings(b1->asStringView(), b2->asLatin1());
-        return QtPrivate::compareStrings(b1->asLatin1(), b2->asStringView());
+            return QtPrivate::compareStrings(b1.asStringView(), b2.asLatin1());
+        return QtPrivate::compareStrings(b1.asLatin1(), b2.asStringView());
     }
 
     return compareElementNoData(e1, e2);
@@ -1366,21 +1388,21 @@ static void encodeToCbor(QCborStreamWriter &writer, const QCborContainerPrivate
     } else {
         // just one element
         auto e = d->elements.at(idx);
-        const ByteData *b = d->byteData(idx);
+        const ByteData b = d->byteData(idx);
         switch (e.type) {
         case QCborValue::Integer:
             return writer.append(qint64(e.value));
 
         case QCborValue::ByteArray:
             if (b)
-                return writer.appendByteString(b->byte(), b->len);
+                return writer.appendByteString(b.byte(), b.len);
             return writer.appendByteString("", 0);
 
         case QCborValue::String:
             if (b) {
                 if (e.flags & Element::StringIsUtf16)
-                    return writer.append(b->asStringView());
-                return writer.appendTextString(b->byte(), b->len);
+                    return writer.append(b.asStringView());
+                return writer.appendTextString(b.byte(), b.len);
             }
             return writer.append(QLatin1String());
 
@@ -1481,7 +1503,8 @@ static Element decodeBasicValueFromCbor(QCborStreamReader &reader)
     return e;
 }
 
-static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &reader, int remainingRecursionDepth)
+static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &reader, int remainingRecursionDepth,
+                                                             const QByteArray &source)
 {
     if (Q_UNLIKELY(remainingRecursionDepth == 0)) {
         QCborContainerPrivate::setErrorInReader(reader, { QCborError::NestingTooDeep });
@@ -1500,11 +1523,13 @@ static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &
         if (len) {
             d = new QCborContainerPrivate;
             d->ref.storeRelaxed(1);
+            d->source = source;
             d->elements.reserve(qsizetype(len) << mapShift);
         }
     } else {
         d = new QCborContainerPrivate;
         d->ref.storeRelaxed(1);
+        d->source = source;
     }
 
     reader.enterContainer();
@@ -1520,7 +1545,8 @@ static inline QCborContainerPrivate *createContainerFromCbor(QCborStreamReader &
     return d;
 }
 
-static QCborValue taggedValueFromCbor(QCborStreamReader &reader, int remainingRecursionDepth)
+static QCborValue taggedValueFromCbor(QCborStreamReader &reader, int remainingRecursionDepth,
+                                      const QByteArray &source)
 {
     if (Q_UNLIKELY(remainingRecursionDepth == 0)) {
         QCborContainerPrivate::setErrorInReader(reader, { QCborError::NestingTooDeep });
@@ -1528,6 +1554,7 @@ static QCborValue taggedValueFromCbor(QCborStreamReader &reader, int remainingRe
     }
 
     auto d = new QCborContainerPrivate;
+    d->source = source;
     d->append(reader.toTag());
     reader.next();
 
@@ -1556,13 +1583,56 @@ inline void QCborContainerPrivate::setErrorInReader(QCborStreamReader &reader, Q
     qt_cbor_stream_set_error(reader.d.data(), error);
 }
 
+bool QCborContainerPrivate::decodeStringReferenceFromCbor(QCborStreamReader &reader, Element &e,
+                                                          qsizetype len)
+{
+    // Skip over the string contents without copying them: reading a chunk
+    // into a zero-sized buffer only advances the reader.
+    char dummy;
+    const qint64 headerOffset = reader.currentOffset();
+    auto r = reader.readStringChunk(&dummy, 0);
+    if (r.status != QCborStreamReader::Ok)
+        return false;
+    const qint64 contentOffset = reader.currentOffset() - len;
+
+    ByteData b = sourceByteData(source, headerOffset);
+    if (Q_UNLIKELY(b.len != len || b.ptr != source.constData() + contentOffset)) {
+        // not where we expected it; shouldn't happen, but copy to be safe
+        b = { source.constData() + contentOffset, len };
+        e.value = addByteData(b.ptr, len);
+    } else {
+        e.value = headerOffset;
+        e.flags = Element::ByteDataInSource;
+    }
+    e.flags |= Element::HasByteData;
+
+    if (e.type == QCborValue::String) {
+        // verify UTF-8 string validity
+        auto utf8result = QUtf8::isValidUtf8(b.asByteArrayView());
+        if (!utf8result.isValidUtf8) {
+            setErrorInReader(reader, { QCborError::InvalidUtf8String });
+            return false;
+        }
+        if (utf8result.isValidAscii)
+            e.flags |= Element::StringIsAscii;
+        if (Q_UNLIKELY(len > MaxStringSize)) {
+            setErrorInReader(reader, { QCborError::DataTooLarge });
+            return false;
+        }
+    }
+
+    // advance past the end of the string
+    r = reader.readStringChunk(&dummy, 0);
+    return r.status == QCborStreamReader::EndOfString;
+}
+
 void QCborContainerPrivate::decodeStringFromCbor(QCborStreamReader &reader)
 {
     auto addByteData_local = [this](QByteArray::size_type len) -> qint64 {
         // this duplicates a lot of addByteData, but with overflow checking
         QByteArray::size_type newSize;
-        QByteArray::size_type increment = sizeof(QtCbor::ByteData);
-        QByteArray::size_type alignment = alignof(QtCbor::ByteData);
+        QByteArray::size_type increment = sizeof(QtCbor::ByteDataHeader);
+        QByteArray::size_type alignment = alignof(QtCbor::ByteDataHeader);
         QByteArray::size_type offset = data.size();
 
         // calculate the increment we want
@@ -1604,6 +1674,13 @@ void QCborContainerPrivate::decodeStringFromCbor(QCborStreamReader &reader)
         return;
     }
 
+    if (!source.isNull() && len != 0 && reader.isLengthKnown()) {
+        // reference the string in the source buffer instead of copying it
+        if (decodeStringReferenceFromCbor(reader, e, len))
+            elements.append(e);
+        return;
+    }
+
     // allocate space, but only if there will be data
     if (len != 0 || !reader.isLengthKnown()) {
         e.flags = Element::HasByteData;
@@ -1617,7 +1694,7 @@ void QCborContainerPrivate::decodeStringFromCbor(QCborStreamReader &reader)
 
     // read chunks
     bool isAscii = (e.type == QCborValue::String);
-    auto r = reader.readStringChunk(dataPtr() + e.value + sizeof(ByteData), len);
+    auto r = reader.readStringChunk(dataPtr() + e.value + sizeof(ByteDataHeader), len);
     while (r.status == QCborStreamReader::Ok) {
         if (e.type == QCborValue::String && len) {
             // verify UTF-8 string validity
@@ -1653,7 +1730,7 @@ void QCborContainerPrivate::decodeStringFromCbor(QCborStreamReader &reader)
 
     // update size
     if (r.status == QCborStreamReader::EndOfString && e.flags & Element::HasByteData) {
-        auto b = new (dataPtr() + e.value) ByteData;
+        auto b = new (dataPtr() + e.value) ByteDataHeader;
         b->len = data.size() - e.value - int(sizeof(*b));
         usedData += b->len;
 
@@ -1703,11 +1780,11 @@ void QCborContainerPrivate::decodeValueFromCbor(QCborStreamReader &reader, int r
     case QCborStreamReader::Array:
     case QCborStreamReader::Map:
         return append(makeValue(t == QCborStreamReader::Array ? QCborValue::Array : QCborValue::Map, -1,
-                                createContainerFromCbor(reader, remainingRecursionDepth),
+                                createContainerFromCbor(reader, remainingRecursionDepth, source),
                                 MoveContainer));
 
     case QCborStreamReader::Tag:
-        return append(taggedValueFromCbor(reader, remainingRecursionDepth));
+        return append(taggedValueFromCbor(reader, remainingRecursionDepth, source));
 
     case QCborStreamReader::Invalid:
         return;                 // probably a decode error
@@ -2010,13 +2087,13 @@ QDateTime QCborValue::toDateTime(const QDateTime &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteData byteData = container->byteData(1);
     if (!byteData)
         return defaultValue; // date/times are never empty, so this must be invalid
 
     // Our data must be US-ASCII.
     Q_ASSERT((container->elements.at(1).flags & Element::StringIsUtf16) == 0);
-    return QDateTime::fromString(byteData->asLatin1(), Qt::ISODateWithMs);
+    return QDateTime::fromString(byteData.asLatin1(), Qt::ISODateWithMs);
 }
 
 #ifndef QT_BOOTSTRAPPED
@@ -2034,11 +2111,11 @@ QUrl QCborValue::toUrl(const QUrl &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteData byteData = container->byteData(1);
     if (!byteData)
         return QUrl();  // valid, empty URL
 
-    return QUrl::fromEncoded(byteData->asByteArrayView());
+    return QUrl::fromEncoded(byteData.asByteArrayView());
 }
 #endif
 
@@ -2077,11 +2154,11 @@ QUuid QCborValue::toUuid(const QUuid &defaultValue) const
         return defaultValue;
 
     Q_ASSERT(n == -1);
-    const ByteData *byteData = container->byteData(1);
+    const ByteData byteData = container->byteData(1);
     if (!byteData)
         return defaultValue; // UUIDs must always be 16 bytes, so this must be invalid
 
-    return QUuid::fromRfc4122(byteData->asByteArrayView());
+    return QUuid::fromRfc4122(byteData.asByteArrayView());
 }
 
 /*!
@@ -2437,6 +2514,11 @@ enum { MaximumRecursionDepth = 1024 };
     \sa toCbor(), toDiagnosticNotation(), toVariant(), toJsonValue()
  */
 QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
+{
+    return QCborContainerPrivate::decodeFromCbor(reader, QByteArray());
+}
+
+QCborValue QCborContainerPrivate::decodeFromCbor(QCborStreamReader &reader, const QByteArray &source)
 {
     QCborValue result;
     auto t = reader.type();
@@ -2465,9 +2547,10 @@ QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
     case QCborStreamReader::ByteArray:
     case QCborStreamReader::String:
         result.n = 0;
-        result.t = reader.isString() ? String : ByteArray;
+        result.t = reader.isString() ? QCborValue::String : QCborValue::ByteArray;
         result.container = new QCborContainerPrivate;
         result.container->ref.ref();
+        result.container->source = source;
         result.container->decodeStringFromCbor(reader);
         break;
 
@@ -2475,13 +2558,13 @@ QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
     case QCborStreamReader::Array:
     case QCborStreamReader::Map:
         result.n = -1;
-        result.t = reader.isArray() ? Array : Map;
-        result.container = createContainerFromCbor(reader, MaximumRecursionDepth);
+        result.t = reader.isArray() ? QCborValue::Array : QCborValue::Map;
+        result.container = createContainerFromCbor(reader, MaximumRecursionDepth, source);
         break;
 
     // tag
     case QCborStreamReader::Tag:
-        result = taggedValueFromCbor(reader, MaximumRecursionDepth);
+        result = taggedValueFromCbor(reader, MaximumRecursionDepth, source);
         break;
     }
 
@@ -2511,9 +2594,39 @@ QCborValue QCborValue::fromCbor(QCborStreamReader &reader)
     \sa toCbor(), toDiagnosticNotation(), toVariant(), toJsonValue()
  */
 QCborValue QCborValue::fromCbor(const QByteArray &ba, QCborParserError *error)
+{
+    return fromCbor(ba, error, NoDecodingOptions);
+}
+
+/*!
+    \overload
+    \since 6.0
+
+    Decodes one item from the CBOR stream found in the byte array \a ba, like
+    the overload above, using the decoding options specified in \a options.
+
+    If \a options contains \l{DecodingOption}{ReferenceSourceData}, the text
+    and byte strings of definite length in the result are not copied: they
+    refer to their contents inside \a ba, which is kept alive by
+    implicit sharing for as long as the result or any value extracted from it
+    exists. Decoding a stream made mostly of large strings this way only
+    allocates memory for the array and map structure. Strings copied into
+    containers that were not decoded from the same buffer are detached as
+    usual.
+
+    \note If \a ba was created with QByteArray::fromRawData(), the memory it
+    refers to must remain valid for the lifetime of the returned value.
+
+    \sa toCbor(), DecodingOption
+ */
+QCborValue QCborValue::fromCbor(const QByteArray &ba, QCborParserError *error,
+                                DecodingOptions options)
 {
     QCborStreamReader reader(ba);
-    QCborValue result = fromCbor(reader);
+    QByteArray source;
+    if (options & ReferenceSourceData)
+        source = ba.isNull() ? QByteArray("") : ba;
+    QCborValue result = QCborContainerPrivate::decodeFromCbor(reader, source);
     if (error) {
         error->error = reader.lastError();
         error->offset = reader.currentOffset();
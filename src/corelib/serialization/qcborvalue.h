@@ -105,6 +105,12 @@ public:
     };
     Q_DECLARE_FLAGS(DiagnosticNotationOptions, DiagnosticNotationOption)
 
+    enum DecodingOption {
+        NoDecodingOptions       = 0x00,
+        ReferenceSourceData     = 0x01
+    };
+    Q_DECLARE_FLAGS(DecodingOptions, DecodingOption)
+
     // different from QCborStreamReader::Type because we have more types
     enum Type : int {
         Integer         = 0x00,
@@ -285,6 +291,8 @@ public:
 #if QT_CONFIG(cborstreamreader)
     static QCborValue fromCbor(QCborStreamReader &reader);
     static QCborValue fromCbor(const QByteArray &ba, QCborParserError *error = nullptr);
+    static QCborValue fromCbor(const QByteArray &ba, QCborParserError *error,
+                               DecodingOptions options);
     static QCborValue fromCbor(const char *data, qsizetype len, QCborParserError *error = nullptr)
     { return fromCbor(QByteArray(data, int(len)), error); }
     static QCborValue fromCbor(const quint8 *data, qsizetype len, QCborParserError *error = nullptr)
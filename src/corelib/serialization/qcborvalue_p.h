@@ -68,7 +68,8 @@ struct Element
         IsContainer                 = 0x0001,
         HasByteData                 = 0x0002,
         StringIsUtf16               = 0x0004,
-        StringIsAscii               = 0x0008
+        StringIsAscii               = 0x0008,
+        ByteDataInSource            = 0x0010
     };
     Q_DECLARE_FLAGS(ValueFlags, ValueFlag)
 
@@ -97,14 +98,25 @@ struct Element
 Q_DECLARE_OPERATORS_FOR_FLAGS(Element::ValueFlags)
 static_assert(sizeof(Element) == 16);
 
-struct ByteData
+// Header preceding each string stored in QCborContainerPrivate::data
+struct ByteDataHeader
 {
     QByteArray::size_type len;
+};
+static_assert(std::is_trivial<ByteDataHeader>::value);
+static_assert(std::is_standard_layout<ByteDataHeader>::value);
+
+// Read-only view of a string's contents, wherever they are stored; null if
+// the element has no byte data
+struct ByteData
+{
+    const char *ptr;
+    qsizetype len;
+
+    explicit operator bool() const  { return ptr != nullptr; }
 
-    const char *byte() const        { return reinterpret_cast<const char *>(this + 1); }
-    char *byte()                    { return reinterpret_cast<char *>(this + 1); }
-    const QChar *utf16() const      { return reinterpret_cast<const QChar *>(this + 1); }
-    QChar *utf16()                  { return reinterpret_cast<QChar *>(this + 1); }
+    const char *byte() const        { return ptr; }
+    const QChar *utf16() const      { return reinterpret_cast<const QChar *>(ptr); }
 
     QByteArray toByteArray() const  { return QByteArray(byte(), len); }
     QString toString() const        { return QString(utf16(), len / 2); }
@@ -133,6 +145,10 @@ public:
     QByteArray data;
     QList<QtCbor::Element> elements;
 
+    // Encoded CBOR buffer that ByteDataInSource elements point into (set only
+    // when decoding with QCborValue::ReferenceSourceData)
+    QByteArray source;
+
     void deref() { if (!ref.deref()) delete this; }
     void compact(qsizetype reserved);
     static QCborContainerPrivate *clone(QCborContainerPrivate *d, qsizetype reserved = -1);
@@ -148,37 +164,56 @@ public:
         qptrdiff offset = data.size();
 
         // align offset
-        offset += alignof(QtCbor::ByteData) - 1;
-        offset &= ~(alignof(QtCbor::ByteData) - 1);
+        offset += alignof(QtCbor::ByteDataHeader) - 1;
+        offset &= ~(alignof(QtCbor::ByteDataHeader) - 1);
 
-        qptrdiff increment = qptrdiff(sizeof(QtCbor::ByteData)) + len;
+        qptrdiff increment = qptrdiff(sizeof(QtCbor::ByteDataHeader)) + len;
 
         usedData += increment;
         data.resize(offset + increment);
 
         char *ptr = data.begin() + offset;
-        auto b = new (ptr) QtCbor::ByteData;
+        auto b = new (ptr) QtCbor::ByteDataHeader;
         b->len = len;
         if (block)
-            memcpy(b->byte(), block, len);
+            memcpy(b + 1, block, len);
 
         return offset;
     }
 
-    const QtCbor::ByteData *byteData(QtCbor::Element e) const
+    static QtCbor::ByteData sourceByteData(const QByteArray &source, qint64 offset)
+    {
+        // offset points to the CBOR header of a definite-length string
+        Q_ASSERT(offset >= 0 && offset < source.size());
+        auto ptr = reinterpret_cast<const uchar *>(source.constData()) + offset;
+        quint64 len = *ptr++ & 0x1f;
+        if (len >= 24) {
+            Q_ASSERT(len <= 27);
+            int n = 1 << (len - 24);
+            len = 0;
+            while (n--)
+                len = (len << 8) | *ptr++;
+        }
+        Q_ASSERT(ptr + len <= reinterpret_cast<const uchar *>(source.constEnd()));
+        return { reinterpret_cast<const char *>(ptr), qsizetype(len) };
+    }
+
+    QtCbor::ByteData byteData(QtCbor::Element e) const
     {
         if ((e.flags & QtCbor::Element::HasByteData) == 0)
-            return nullptr;
+            return {};
+        if (e.flags & QtCbor::Element::ByteDataInSource)
+            return sourceByteData(source, e.value);
 
         size_t offset = size_t(e.value);
-        Q_ASSERT((offset % alignof(QtCbor::ByteData)) == 0);
-        Q_ASSERT(offset + sizeof(QtCbor::ByteData) <= size_t(data.size()));
+        Q_ASSERT((offset % alignof(QtCbor::ByteDataHeader)) == 0);
+        Q_ASSERT(offset + sizeof(QtCbor::ByteDataHeader) <= size_t(data.size()));
 
-        auto b = reinterpret_cast<const QtCbor::ByteData *>(data.constData() + offset);
+        auto b = reinterpret_cast<const QtCbor::ByteDataHeader *>(data.constData() + offset);
         Q_ASSERT(offset + sizeof(*b) + size_t(b->len) <= size_t(data.size()));
-        return b;
+        return QtCbor::ByteData{ reinterpret_cast<const char *>(b + 1), b->len };
     }
-    const QtCbor::ByteData *byteData(qsizetype idx) const
+    QtCbor::ByteData byteData(qsizetype idx) const
     {
         return byteData(elements.at(idx));
     }
@@ -208,8 +243,10 @@ public:
             e.container->deref();
             e.container = nullptr;
             e.flags = {};
-        } else if (auto b = byteData(e)) {
-            usedData -= b->len + sizeof(QtCbor::ByteData);
+        } else if (e.flags & QtCbor::Element::ByteDataInSource) {
+            // nothing to release, the bytes belong to the source buffer
+        } else if (const QtCbor::ByteData b = byteData(e)) {
+            usedData -= b.len + sizeof(QtCbor::ByteDataHeader);
         }
         replaceAt_internal(e, value, disp);
     }
@@ -282,7 +319,7 @@ public:
         const auto data = byteData(e);
         if (!data)
             return QByteArray();
-        return data->toByteArray();
+        return data.toByteArray();
     }
     QString stringAt(qsizetype idx) const
     {
@@ -291,10 +328,10 @@ public:
         if (!data)
             return QString();
         if (e.flags & QtCbor::Element::StringIsUtf16)
-            return data->toString();
+            return data.toString();
         if (e.flags & QtCbor::Element::StringIsAscii)
-            return data->asLatin1();
-        return data->toUtf8String();
+            return data.asLatin1();
+        return data.toUtf8String();
     }
 
     static void resetValue(QCborValue &v)
@@ -362,14 +399,14 @@ public:
         return e;
     }
 
-    static int compareUtf8(const QtCbor::ByteData *b, const QLatin1String &s)
+    static int compareUtf8(const QtCbor::ByteData &b, const QLatin1String &s)
     {
-        return QUtf8::compareUtf8(QByteArrayView(b->byte(), b->len), s);
+        return QUtf8::compareUtf8(QByteArrayView(b.byte(), b.len), s);
     }
 
-    static int compareUtf8(const QtCbor::ByteData *b, QStringView s)
+    static int compareUtf8(const QtCbor::ByteData &b, QStringView s)
     {
-        return QUtf8::compareUtf8(QByteArrayView(b->byte(), b->len), s);
+        return QUtf8::compareUtf8(QByteArrayView(b.byte(), b.len), s);
     }
 
     template<typename String>
@@ -378,12 +415,12 @@ public:
         if (e.type != QCborValue::String)
             return int(e.type) - int(QCborValue::String);
 
-        const QtCbor::ByteData *b = byteData(e);
+        const QtCbor::ByteData b = byteData(e);
         if (!b)
             return s.isEmpty() ? 0 : -1;
 
         if (e.flags & QtCbor::Element::StringIsUtf16)
-            return QtPrivate::compareStrings(b->asStringView(), s);
+            return QtPrivate::compareStrings(b.asStringView(), s);
         return compareUtf8(b, s);
     }
 
@@ -414,8 +451,10 @@ public:
         elements.remove(idx);
     }
 
+    static QCborValue decodeFromCbor(QCborStreamReader &reader, const QByteArray &source);
     void decodeValueFromCbor(QCborStreamReader &reader, int remainiingStackDepth);
     void decodeStringFromCbor(QCborStreamReader &reader);
+    bool decodeStringReferenceFromCbor(QCborStreamReader &reader, QtCbor::Element &e, qsizetype len);
     static inline void setErrorInReader(QCborStreamReader &reader, QCborError error);
 };
 
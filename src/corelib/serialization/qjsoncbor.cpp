@@ -76,11 +76,11 @@ static QString simpleTypeString(QCborValue::Type t)
 
 static QString encodeByteArray(const QCborContainerPrivate *d, qsizetype idx, QCborTag encoding)
 {
-    const ByteData *b = d->byteData(idx);
+    const ByteData b = d->byteData(idx);
     if (!b)
         return QString();
 
-    QByteArray data = QByteArray::fromRawData(b->byte(), b->len);
+    QByteArray data = QByteArray::fromRawData(b.byte(), b.len);
     if (encoding == QCborKnownTags::ExpectedBase16)
         data = data.toHex();
     else if (encoding == QCborKnownTags::ExpectedBase64)
@@ -98,7 +98,7 @@ static QString maybeEncodeTag(const QCborContainerPrivate *d)
 {
     qint64 tag = d->elements.at(0).value;
     const Element &e = d->elements.at(1);
-    const ByteData *b = d->byteData(e);
+    const ByteData b = d->byteData(e);
 
     switch (tag) {
     case qint64(QCborKnownTags::DateTimeString):
@@ -115,8 +115,8 @@ static QString maybeEncodeTag(const QCborContainerPrivate *d)
         break;
 
     case qint64(QCborKnownTags::Uuid):
-        if (e.type == QCborValue::ByteArray && b->len == sizeof(QUuid))
-            return QUuid::fromRfc4122(b->asByteArrayView()).toString(QUuid::WithoutBraces);
+        if (e.type == QCborValue::ByteArray && b.len == sizeof(QUuid))
+            return QUuid::fromRfc4122(b.asByteArrayView()).toString(QUuid::WithoutBraces);
     }
 
     // don't know what to do, bail out
@@ -208,7 +208,7 @@ static QJsonValue convertExtendedTypeToJson(QCborContainerPrivate *d)
     case qint64(QCborKnownTags::Url):
         // use the fullly-encoded URL form
         if (d->elements.at(1).type == QCborValue::String)
-            return QUrl::fromEncoded(d->byteData(1)->asByteArrayView()).toString(QUrl::FullyEncoded);
+            return QUrl::fromEncoded(d->byteData(1).asByteArrayView()).toString(QUrl::FullyEncoded);
         Q_FALLTHROUGH();
 
     case qint64(QCborKnownTags::DateTimeString):
@@ -47,6 +47,7 @@
 #include "private/qstringconverter_p.h"
 #include "private/qcborvalue_p.h"
 #include "private/qnumeric_p.h"
+#include "private/qsimd_p.h"
 
 //#define PARSER_DEBUG
 #ifdef PARSER_DEBUG
@@ -272,6 +273,114 @@ enum {
     Quote = 0x22
 };
 
+/*
+    The scanners below look at 16 bytes at a time. findNonSpace() returns the
+    first byte that is not JSON whitespace; findStringSpecial() returns the
+    first byte inside a string that needs attention: the closing quote, a
+    backslash or the start of a non-ASCII UTF-8 sequence. Both return \a end
+    if there is no such byte.
+*/
+static inline bool isJsonSpace(char c)
+{
+    return c == Space || c == Tab || c == LineFeed || c == Return;
+}
+
+static inline bool isStringSpecial(char c)
+{
+    return c == Quote || c == '\\' || uchar(c) >= 0x80;
+}
+
+#if QT_COMPILER_USES(sse2)
+static inline const char *findNonSpace(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i space = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Space)),
+                                 _mm_cmpeq_epi8(data, _mm_set1_epi8(Tab))),
+                    _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(LineFeed)),
+                                 _mm_cmpeq_epi8(data, _mm_set1_epi8(Return))));
+        const uint mask = ~uint(_mm_movemask_epi8(space)) & 0xffff;
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    while (json < end && isJsonSpace(*json))
+        ++json;
+    return json;
+}
+
+static inline const char *findStringSpecial(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(json));
+        const __m128i special = _mm_or_si128(_mm_cmpeq_epi8(data, _mm_set1_epi8(Quote)),
+                                             _mm_cmpeq_epi8(data, _mm_set1_epi8('\\')));
+        // non-ASCII bytes have their high bit set already
+        const uint mask = uint(_mm_movemask_epi8(_mm_or_si128(special, data)));
+        if (mask)
+            return json + qCountTrailingZeroBits(mask);
+    }
+    while (json < end && !isStringSpecial(*json))
+        ++json;
+    return json;
+}
+#elif QT_COMPILER_USES(neon) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+// narrowing the comparison result leaves four bits per byte in a 64-bit mask
+static inline uint neonFirstMatch(uint8x16_t matches)
+{
+    const uint8x8_t bits = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(bits), 0);
+    return mask ? qCountTrailingZeroBits(mask) / 4 : 16;
+}
+
+static inline const char *findNonSpace(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(json));
+        const uint8x16_t space = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Space)),
+                                                   vceqq_u8(data, vdupq_n_u8(Tab))),
+                                          vorrq_u8(vceqq_u8(data, vdupq_n_u8(LineFeed)),
+                                                   vceqq_u8(data, vdupq_n_u8(Return))));
+        const uint first = neonFirstMatch(vmvnq_u8(space));
+        if (first < 16)
+            return json + first;
+    }
+    while (json < end && isJsonSpace(*json))
+        ++json;
+    return json;
+}
+
+static inline const char *findStringSpecial(const char *json, const char *end)
+{
+    for ( ; end - json >= 16; json += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(json));
+        const uint8x16_t special = vorrq_u8(vorrq_u8(vceqq_u8(data, vdupq_n_u8(Quote)),
+                                                     vceqq_u8(data, vdupq_n_u8('\\'))),
+                                            vcgeq_u8(data, vdupq_n_u8(0x80)));
+        const uint first = neonFirstMatch(special);
+        if (first < 16)
+            return json + first;
+    }
+    while (json < end && !isStringSpecial(*json))
+        ++json;
+    return json;
+}
+#else
+static inline const char *findNonSpace(const char *json, const char *end)
+{
+    while (json < end && isJsonSpace(*json))
+        ++json;
+    return json;
+}
+
+static inline const char *findStringSpecial(const char *json, const char *end)
+{
+    while (json < end && !isStringSpecial(*json))
+        ++json;
+    return json;
+}
+#endif
+
 void Parser::eatBOM()
 {
     // eat UTF-8 byte order mark
@@ -285,16 +394,10 @@ void Parser::eatBOM()
 
 bool Parser::eatSpace()
 {
-    while (json < end) {
-        if (*json > Space)
-            break;
-        if (*json != Space &&
-            *json != Tab &&
-            *json != LineFeed &&
-            *json != Return)
-            break;
-        ++json;
-    }
+    // compact documents rarely have whitespace, so check the first byte
+    // before setting up the vector scan
+    if (json < end && isJsonSpace(*json))
+        json = findNonSpace(json + 1, end);
     return (json < end);
 }
 
@@ -393,8 +496,8 @@ static void sortContainer(QCborContainerPrivate *container)
         Q_ASSERT(aKey.flags & QtCbor::Element::HasByteData);
         Q_ASSERT(bKey.flags & QtCbor::Element::HasByteData);
 
-        const QtCbor::ByteData *aData = container->byteData(aKey);
-        const QtCbor::ByteData *bData = container->byteData(bKey);
+        const QtCbor::ByteData aData = container->byteData(aKey);
+        const QtCbor::ByteData bData = container->byteData(bKey);
 
         if (!aData)
             return bData ? -1 : 0;
@@ -406,17 +509,17 @@ static void sortContainer(QCborContainerPrivate *container)
 
         if (aKey.flags & QtCbor::Element::StringIsUtf16) {
             if (bKey.flags & QtCbor::Element::StringIsUtf16)
-                return QtPrivate::compareStrings(aData->asStringView(), bData->asStringView());
+                return QtPrivate::compareStrings(aData.asStringView(), bData.asStringView());
 
-            return -QCborContainerPrivate::compareUtf8(bData, aData->asStringView());
+            return -QCborContainerPrivate::compareUtf8(bData, aData.asStringView());
         } else {
             if (bKey.flags & QtCbor::Element::StringIsUtf16)
-                return QCborContainerPrivate::compareUtf8(aData, bData->asStringView());
+                return QCborContainerPrivate::compareUtf8(aData, bData.asStringView());
 
             // We're missing an explicit UTF-8 to UTF-8 comparison in Qt, but
             // UTF-8 to UTF-8 comparison retains simple byte ordering, so we'll
             // abuse the Latin-1 comparison function.
-            return QtPrivate::compareStrings(aData->asLatin1(), bData->asLatin1());
+            return QtPrivate::compareStrings(aData.asLatin1(), bData.asLatin1());
         }
     };
 
@@ -766,78 +869,6 @@ bool Parser::parseNumber()
 
         unescaped = %x20-21 / %x23-5B / %x5D-10FFFF
  */
-static inline bool addHexDigit(char digit, uint *result)
-{
-    *result <<= 4;
-    if (digit >= '0' && digit <= '9')
-        *result |= (digit - '0');
-    else if (digit >= 'a' && digit <= 'f')
-        *result |= (digit - 'a') + 10;
-    else if (digit >= 'A' && digit <= 'F')
-        *result |= (digit - 'A') + 10;
-    else
-        return false;
-    return true;
-}
-
-static inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
-{
-    ++json;
-    if (json >= end)
-        return false;
-
-    DEBUG << "scan escape" << (char)*json;
-    uint escaped = *json++;
-    switch (escaped) {
-    case '"':
-        *ch = '"'; break;
-    case '\\':
-        *ch = '\\'; break;
-    case '/':
-        *ch = '/'; break;
-    case 'b':
-        *ch = 0x8; break;
-    case 'f':
-        *ch = 0xc; break;
-    case 'n':
-        *ch = 0xa; break;
-    case 'r':
-        *ch = 0xd; break;
-    case 't':
-        *ch = 0x9; break;
-    case 'u': {
-        *ch = 0;
-        if (json > end - 4)
-            return false;
-        for (int i = 0; i < 4; ++i) {
-            if (!addHexDigit(*json, ch))
-                return false;
-            ++json;
-        }
-        return true;
-    }
-    default:
-        // this is not as strict as one could be, but allows for more Json files
-        // to be parsed correctly.
-        *ch = escaped;
-        return true;
-    }
-    return true;
-}
-
-static inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
-{
-    const auto *usrc = reinterpret_cast<const uchar *>(json);
-    const auto *uend = reinterpret_cast<const uchar *>(end);
-    const uchar b = *usrc++;
-    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, usrc, uend);
-    if (res < 0)
-        return false;
-
-    json = reinterpret_cast<const char *>(usrc);
-    return true;
-}
-
 bool Parser::parseString()
 {
     const char *start = json;
@@ -848,6 +879,9 @@ bool Parser::parseString()
     bool isUtf8 = true;
     bool isAscii = true;
     while (json < end) {
+        json = findStringSpecial(json, end);
+        if (json >= end)
+            break;
         uint ch = 0;
         if (*json == '"')
             break;
@@ -890,6 +924,14 @@ bool Parser::parseString()
 
     QString ucs4;
     while (json < end) {
+        // copy runs of plain ASCII in one go
+        const char *run = json;
+        json = findStringSpecial(json, end);
+        if (json != run)
+            ucs4.append(QLatin1String(run, json - run));
+        if (json >= end)
+            break;
+
         uint ch = 0;
         if (*json == '"')
             break;
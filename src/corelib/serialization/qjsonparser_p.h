@@ -53,12 +53,84 @@
 
 #include <QtCore/private/qglobal_p.h>
 #include <QtCore/private/qcborvalue_p.h>
+#include <QtCore/private/qstringconverter_p.h>
 #include <QtCore/qjsondocument.h>
 
 QT_BEGIN_NAMESPACE
 
 namespace QJsonPrivate {
 
+inline bool addHexDigit(char digit, uint *result)
+{
+    *result <<= 4;
+    if (digit >= '0' && digit <= '9')
+        *result |= (digit - '0');
+    else if (digit >= 'a' && digit <= 'f')
+        *result |= (digit - 'a') + 10;
+    else if (digit >= 'A' && digit <= 'F')
+        *result |= (digit - 'A') + 10;
+    else
+        return false;
+    return true;
+}
+
+inline bool scanEscapeSequence(const char *&json, const char *end, uint *ch)
+{
+    ++json;
+    if (json >= end)
+        return false;
+
+    uint escaped = *json++;
+    switch (escaped) {
+    case '"':
+        *ch = '"'; break;
+    case '\\':
+        *ch = '\\'; break;
+    case '/':
+        *ch = '/'; break;
+    case 'b':
+        *ch = 0x8; break;
+    case 'f':
+        *ch = 0xc; break;
+    case 'n':
+        *ch = 0xa; break;
+    case 'r':
+        *ch = 0xd; break;
+    case 't':
+        *ch = 0x9; break;
+    case 'u': {
+        *ch = 0;
+        if (json > end - 4)
+            return false;
+        for (int i = 0; i < 4; ++i) {
+            if (!addHexDigit(*json, ch))
+                return false;
+            ++json;
+        }
+        return true;
+    }
+    default:
+        // this is not as strict as one could be, but allows for more Json files
+        // to be parsed correctly.
+        *ch = escaped;
+        return true;
+    }
+    return true;
+}
+
+inline bool scanUtf8Char(const char *&json, const char *end, uint *result)
+{
+    const auto *usrc = reinterpret_cast<const uchar *>(json);
+    const auto *uend = reinterpret_cast<const uchar *>(end);
+    const uchar b = *usrc++;
+    int res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(b, result, usrc, uend);
+    if (res < 0)
+        return false;
+
+    json = reinterpret_cast<const char *>(usrc);
+    return true;
+}
+
 class Parser
 {
 public:
@@ -0,0 +1,752 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qjsonstreamparser.h"
+
+#include <qjsonarray.h>
+#include <qjsonobject.h>
+#include <qvarlengtharray.h>
+
+#include "private/qjsonparser_p.h"
+#include "private/qnumeric_p.h"
+
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QJsonStreamHandler
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.0
+
+    \brief The QJsonStreamHandler class receives the events reported by
+    QJsonStreamParser.
+
+    Subclass QJsonStreamHandler and reimplement the functions for the events
+    you are interested in. The default implementations do nothing.
+
+    \sa QJsonStreamParser
+*/
+
+/*!
+    Destroys the handler.
+*/
+QJsonStreamHandler::~QJsonStreamHandler()
+    = default;
+
+/*!
+    Called when the parser encounters the beginning of an object.
+*/
+void QJsonStreamHandler::startObject()
+{
+}
+
+/*!
+    Called when the parser encounters the end of an object.
+*/
+void QJsonStreamHandler::endObject()
+{
+}
+
+/*!
+    Called when the parser encounters the beginning of an array.
+*/
+void QJsonStreamHandler::startArray()
+{
+}
+
+/*!
+    Called when the parser encounters the end of an array.
+*/
+void QJsonStreamHandler::endArray()
+{
+}
+
+/*!
+    Called for the \a key of each member of an object. The member's value
+    is reported next, either through value() or as a nested object or array.
+*/
+void QJsonStreamHandler::key(const QString &key)
+{
+    Q_UNUSED(key);
+}
+
+/*!
+    Called for each string, number, boolean and null \a value, and for the
+    complete elements of the top-level array if
+    QJsonStreamParser::MaterializeArrayElements is set.
+*/
+void QJsonStreamHandler::value(const QJsonValue &value)
+{
+    Q_UNUSED(value);
+}
+
+/*!
+    \class QJsonStreamParser
+    \inmodule QtCore
+    \ingroup json
+    \reentrant
+    \since 6.0
+
+    \brief The QJsonStreamParser class parses JSON documents incrementally.
+
+    QJsonDocument::fromJson() needs the complete document in memory and
+    builds a tree for all of it. QJsonStreamParser instead accepts the
+    document in chunks of arbitrary size through addData() and reports what
+    it finds to a QJsonStreamHandler as soon as it has been parsed. It only
+    keeps the part of the input that does not form a complete token yet, so
+    its memory use does not depend on the size of the document.
+
+    \snippet code/src_corelib_serialization_qjsonstreamparser.cpp 0
+
+    Call finish() once all data has been added to detect truncated
+    documents. The parser accepts the same documents as
+    QJsonDocument::fromJson(), and reports errors with the same
+    QJsonParseError codes.
+
+    Many large documents are a single array of records. With the
+    MaterializeArrayElements option each element of such a top-level array
+    is delivered as a complete QJsonValue, so that the records can be
+    processed with the regular JSON classes one at a time.
+
+    \sa QJsonStreamHandler, QJsonDocument
+*/
+
+/*!
+    \enum QJsonStreamParser::Option
+
+    \value NoOptions Every value is reported individually.
+    \value MaterializeArrayElements If the document is an array, each of its
+           elements is reported as one QJsonValue through
+           QJsonStreamHandler::value(), instead of as a sequence of events.
+*/
+
+static const int nestingLimit = 1024;
+
+class QJsonStreamParserPrivate
+{
+public:
+    enum State : quint8 {
+        ExpectDocument,
+        ExpectValue,            // after a name separator
+        ExpectValueOrEnd,       // after the beginning of an array
+        ExpectArrayValue,       // after a value separator in an array
+        ExpectKeyOrEnd,         // after the beginning of an object
+        ExpectKey,              // after a value separator in an object
+        ExpectNameSeparator,
+        ExpectSeparatorOrEnd,
+        Finished,
+        Failed
+    };
+
+    enum Result { Done, NeedMoreData, Error };
+
+    // a container that is being materialized
+    struct Frame
+    {
+        QJsonArray array;
+        QJsonObject object;
+        QString key;
+        bool isObject;
+    };
+
+    QJsonStreamParserPrivate(QJsonStreamHandler *handler, QJsonStreamParser::Options options)
+        : handler(handler), options(options)
+    {}
+
+    qsizetype parse(const char *begin, const char *end, bool atEndOfInput);
+    Result parseValue(const char *&json, const char *end, bool atEndOfInput);
+    Result parseLiteral(const char *&json, const char *end, bool atEndOfInput);
+    Result parseNumber(const char *&json, const char *end, bool atEndOfInput);
+    Result parseString(const char *&json, const char *end, QString *result);
+    Result fail(QJsonParseError::ParseError error, const char *where);
+
+    void startContainer(bool isObject);
+    void endContainer();
+    void emitKey(QString &&key);
+    void emitValue(QJsonValue &&value);
+    void valueDone() { state = containers.isEmpty() ? Finished : ExpectSeparatorOrEnd; }
+
+    QJsonStreamHandler *handler;
+    QJsonStreamParser::Options options;
+
+    QByteArray buffer;          // input that has not been consumed yet
+    const char *base = nullptr; // start of the input being parsed
+    qint64 offset = 0;          // position of base in the document
+    qsizetype scanned = 0;      // part of a pending string known not to contain its end
+
+    QVarLengthArray<bool, 32> containers; // true for objects
+    QList<Frame> frames;
+    State state = ExpectDocument;
+    bool bomChecked = false;
+    QJsonParseError lastError;
+    qint64 errorOffset = -1;
+};
+
+static inline bool isJsonSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+QJsonStreamParserPrivate::Result
+QJsonStreamParserPrivate::fail(QJsonParseError::ParseError error, const char *where)
+{
+    state = Failed;
+    lastError.error = error;
+    errorOffset = offset + (where - base);
+    lastError.offset = int(qMin<qint64>(errorOffset, std::numeric_limits<int>::max()));
+    return Error;
+}
+
+void QJsonStreamParserPrivate::startContainer(bool isObject)
+{
+    containers.append(isObject);
+    state = isObject ? ExpectKeyOrEnd : ExpectValueOrEnd;
+
+    const bool materialize = !frames.isEmpty()
+            || ((options & QJsonStreamParser::MaterializeArrayElements)
+                && containers.size() == 2 && !containers.first());
+    if (materialize)
+        frames.append(Frame{ {}, {}, {}, isObject });
+    else if (isObject)
+        handler->startObject();
+    else
+        handler->startArray();
+}
+
+void QJsonStreamParserPrivate::endContainer()
+{
+    const bool isObject = containers.last();
+    containers.removeLast();
+
+    if (!frames.isEmpty()) {
+        Frame frame = frames.takeLast();
+        emitValue(isObject ? QJsonValue(std::move(frame.object)) : QJsonValue(std::move(frame.array)));
+    } else if (isObject) {
+        handler->endObject();
+    } else {
+        handler->endArray();
+    }
+    valueDone();
+}
+
+void QJsonStreamParserPrivate::emitKey(QString &&key)
+{
+    if (frames.isEmpty())
+        handler->key(key);
+    else
+        frames.last().key = std::move(key);
+}
+
+void QJsonStreamParserPrivate::emitValue(QJsonValue &&value)
+{
+    if (frames.isEmpty()) {
+        handler->value(value);
+        return;
+    }
+
+    Frame &frame = frames.last();
+    if (frame.isObject)
+        frame.object.insert(frame.key, std::move(value));
+    else
+        frame.array.append(std::move(value));
+}
+
+/*
+    Parses as much of [begin, end) as possible and returns the number of
+    bytes consumed. Unless \a atEndOfInput is set, a token that reaches the
+    end of the data is left for the next call.
+*/
+qsizetype QJsonStreamParserPrivate::parse(const char *begin, const char *end, bool atEndOfInput)
+{
+    base = begin;
+    const char *json = begin;
+
+    if (!bomChecked) {
+        static const char utf8bom[] = "\xef\xbb\xbf";
+        const qsizetype available = qMin<qsizetype>(end - json, 3);
+        if (memcmp(json, utf8bom, available) == 0) {
+            if (available < 3 && !atEndOfInput)
+                return 0;
+            json += available;
+        }
+        bomChecked = true;
+    }
+
+    while (state != Failed) {
+        while (json < end && isJsonSpace(*json))
+            ++json;
+        if (json == end)
+            break;
+
+        const char *token = json;
+        Result result = Done;
+        switch (state) {
+        case Finished:
+            fail(QJsonParseError::GarbageAtEnd, json);
+            break;
+
+        case ExpectNameSeparator:
+            if (*json != ':') {
+                fail(QJsonParseError::MissingNameSeparator, json);
+                break;
+            }
+            ++json;
+            state = ExpectValue;
+            break;
+
+        case ExpectSeparatorOrEnd: {
+            const bool inObject = containers.last();
+            if (*json == ',') {
+                ++json;
+                state = inObject ? ExpectKey : ExpectArrayValue;
+            } else if (*json == (inObject ? '}' : ']')) {
+                ++json;
+                endContainer();
+            } else {
+                fail(inObject ? QJsonParseError::UnterminatedObject
+                              : QJsonParseError::MissingValueSeparator, json);
+            }
+            break;
+        }
+
+        case ExpectKeyOrEnd:
+            if (*json == '}') {
+                ++json;
+                endContainer();
+                break;
+            }
+            Q_FALLTHROUGH();
+        case ExpectKey: {
+            if (*json != '"') {
+                fail(state == ExpectKey && *json == '}' ? QJsonParseError::MissingObject
+                                                        : QJsonParseError::UnterminatedObject, json);
+                break;
+            }
+            QString key;
+            result = parseString(json, end, &key);
+            if (result == Done) {
+                emitKey(std::move(key));
+                state = ExpectNameSeparator;
+            }
+            break;
+        }
+
+        case ExpectDocument:
+            if (*json != '{' && *json != '[') {
+                fail(QJsonParseError::IllegalValue, json);
+                break;
+            }
+            result = parseValue(json, end, atEndOfInput);
+            break;
+
+        case ExpectValueOrEnd:
+            if (*json == ']') {
+                ++json;
+                endContainer();
+                break;
+            }
+            Q_FALLTHROUGH();
+        case ExpectValue:
+        case ExpectArrayValue:
+            result = parseValue(json, end, atEndOfInput);
+            break;
+
+        case Failed:
+            Q_UNREACHABLE();
+        }
+
+        if (result == NeedMoreData) {
+            json = token;
+            break;
+        }
+    }
+
+    return json - begin;
+}
+
+QJsonStreamParserPrivate::Result
+QJsonStreamParserPrivate::parseValue(const char *&json, const char *end, bool atEndOfInput)
+{
+    switch (*json) {
+    case '{':
+    case '[':
+        if (containers.size() >= nestingLimit)
+            return fail(QJsonParseError::DeepNesting, json);
+        startContainer(*json++ == '{');
+        return Done;
+    case '"': {
+        QString string;
+        const Result result = parseString(json, end, &string);
+        if (result == Done) {
+            emitValue(QJsonValue(std::move(string)));
+            valueDone();
+        }
+        return result;
+    }
+    case 't':
+    case 'f':
+    case 'n':
+        return parseLiteral(json, end, atEndOfInput);
+    case ',':
+        // Essentially missing value, but after a colon, not after a comma
+        // like the other MissingObject errors.
+        return fail(state == ExpectValue ? QJsonParseError::IllegalValue
+                                         : QJsonParseError::MissingObject, json);
+    case '}':
+    case ']':
+        return fail(QJsonParseError::MissingObject, json);
+    default:
+        return parseNumber(json, end, atEndOfInput);
+    }
+}
+
+QJsonStreamParserPrivate::Result
+QJsonStreamParserPrivate::parseLiteral(const char *&json, const char *end, bool atEndOfInput)
+{
+    QLatin1String literal;
+    switch (*json) {
+    case 't':
+        literal = QLatin1String("true");
+        break;
+    case 'f':
+        literal = QLatin1String("false");
+        break;
+    default:
+        literal = QLatin1String("null");
+        break;
+    }
+
+    const qsizetype available = qMin(qsizetype(end - json), literal.size());
+    if (memcmp(json, literal.data(), available) != 0)
+        return fail(QJsonParseError::IllegalValue, json);
+    if (available < literal.size())
+        return atEndOfInput ? fail(QJsonParseError::IllegalValue, json) : NeedMoreData;
+
+    json += literal.size();
+    if (*literal.data() == 'n')
+        emitValue(QJsonValue(QJsonValue::Null));
+    else
+        emitValue(QJsonValue(*literal.data() == 't'));
+    valueDone();
+    return Done;
+}
+
+/*
+    See Parser::parseNumber() for the grammar. A number that reaches the end
+    of the data may continue in the next chunk.
+*/
+QJsonStreamParserPrivate::Result
+QJsonStreamParserPrivate::parseNumber(const char *&json, const char *end, bool atEndOfInput)
+{
+    const char *start = json;
+    const char *p = json;
+    bool isInt = true;
+
+    if (p < end && *p == '-')
+        ++p;
+
+    if (p < end && *p == '0') {
+        ++p;
+    } else {
+        while (p < end && *p >= '0' && *p <= '9')
+            ++p;
+    }
+
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end && *p >= '0' && *p <= '9') {
+            isInt = isInt && *p == '0';
+            ++p;
+        }
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        isInt = false;
+        ++p;
+        if (p < end && (*p == '-' || *p == '+'))
+            ++p;
+        while (p < end && *p >= '0' && *p <= '9')
+            ++p;
+    }
+
+    if (p >= end)
+        return atEndOfInput ? fail(QJsonParseError::TerminationByNumber, p) : NeedMoreData;
+
+    const QByteArray number = QByteArray::fromRawData(start, p - start);
+    bool ok = false;
+    if (isInt) {
+        const qlonglong n = number.toLongLong(&ok);
+        if (ok)
+            emitValue(QJsonValue(n));
+    }
+    if (!ok) {
+        const double d = number.toDouble(&ok);
+        if (!ok)
+            return fail(QJsonParseError::IllegalNumber, start);
+
+        qint64 n;
+        if (convertDoubleTo(d, &n))
+            emitValue(QJsonValue(n));
+        else
+            emitValue(QJsonValue(d));
+    }
+
+    json = p;
+    valueDone();
+    return Done;
+}
+
+QJsonStreamParserPrivate::Result
+QJsonStreamParserPrivate::parseString(const char *&json, const char *end, QString *result)
+{
+    using namespace QJsonPrivate;
+
+    // Find the closing quotation mark: it is escaped if it is preceded by an
+    // odd number of backslashes. Remember how far we got, so that a long
+    // string arriving in many chunks is only scanned once.
+    const char *start = json + 1;
+    const char *closing = start + scanned;
+    while (true) {
+        closing = static_cast<const char *>(memchr(closing, '"', end - closing));
+        if (!closing) {
+            scanned = end - start;
+            return NeedMoreData;
+        }
+        const char *backslash = closing;
+        while (backslash > start && backslash[-1] == '\\')
+            --backslash;
+        if ((closing - backslash) % 2 == 0)
+            break;
+        ++closing;
+    }
+    scanned = 0;
+
+    const QByteArrayView content(start, closing - start);
+    if (!memchr(content.data(), '\\', content.size())) {
+        const QUtf8::ValidUtf8Result validity = QUtf8::isValidUtf8(content);
+        if (!validity.isValidUtf8)
+            return fail(QJsonParseError::IllegalUTF8String, json);
+        *result = validity.isValidAscii ? QString::fromLatin1(content.data(), content.size())
+                                        : QString::fromUtf8(content);
+    } else {
+        QString string;
+        string.reserve(content.size());
+        const char *p = start;
+        while (p < closing) {
+            uint ch = 0;
+            if (*p == '\\') {
+                if (!scanEscapeSequence(p, closing, &ch))
+                    return fail(QJsonParseError::IllegalEscapeSequence, p);
+            } else if (!scanUtf8Char(p, closing, &ch)) {
+                return fail(QJsonParseError::IllegalUTF8String, p);
+            }
+            string.append(QChar::fromUcs4(ch));
+        }
+        *result = std::move(string);
+    }
+
+    json = closing + 1;
+    return Done;
+}
+
+/*!
+    Constructs a parser that reports the contents of the document to
+    \a handler, according to \a options. The handler must outlive the
+    parser.
+*/
+QJsonStreamParser::QJsonStreamParser(QJsonStreamHandler *handler, Options options)
+    : d(new QJsonStreamParserPrivate(handler, options))
+{
+    Q_ASSERT(handler);
+}
+
+/*!
+    Destroys the parser.
+*/
+QJsonStreamParser::~QJsonStreamParser()
+{
+}
+
+/*!
+    Returns the handler that receives the parse events.
+*/
+QJsonStreamHandler *QJsonStreamParser::handler() const
+{
+    return d->handler;
+}
+
+/*!
+    Returns the options this parser was created with.
+*/
+QJsonStreamParser::Options QJsonStreamParser::options() const
+{
+    return d->options;
+}
+
+/*!
+    Parses the next chunk \a data of the document and reports the complete
+    tokens it contains to the handler. A token that is cut off by the end of
+    \a data is kept until the next call.
+
+    Returns \c false if the document turned out to be invalid, \c true
+    otherwise.
+
+    \sa finish(), error()
+*/
+bool QJsonStreamParser::addData(QByteArrayView data)
+{
+    if (d->state == QJsonStreamParserPrivate::Failed)
+        return false;
+    if (data.isEmpty())
+        return true;
+
+    if (d->buffer.isEmpty()) {
+        // the common case: parse the data in place and keep only what is left over
+        const qsizetype consumed = d->parse(data.data(), data.data() + data.size(), false);
+        d->buffer = data.sliced(consumed).toByteArray();
+        d->offset += consumed;
+    } else {
+        d->buffer.append(data);
+        const qsizetype consumed = d->parse(d->buffer.constData(),
+                                            d->buffer.constData() + d->buffer.size(), false);
+        d->buffer.remove(0, consumed);
+        d->offset += consumed;
+    }
+    return d->state != QJsonStreamParserPrivate::Failed;
+}
+
+/*!
+    Tells the parser that the whole document has been added, and parses
+    what is left over from the previous calls to addData().
+
+    Returns \c true if the data formed a complete document, \c false
+    otherwise.
+
+    \sa addData(), atEnd()
+*/
+bool QJsonStreamParser::finish()
+{
+    using State = QJsonStreamParserPrivate::State;
+    if (d->state == State::Failed)
+        return false;
+
+    const char *begin = d->buffer.constData();
+    const char *end = begin + d->buffer.size();
+    const qsizetype consumed = d->parse(begin, end, true);
+    if (d->state == State::Failed || d->state == State::Finished)
+        return d->state == State::Finished;
+
+    if (consumed < d->buffer.size() && begin[consumed] == '"')
+        d->fail(QJsonParseError::UnterminatedString, end);
+    else if (d->containers.isEmpty())
+        d->fail(QJsonParseError::IllegalValue, end);
+    else
+        d->fail(d->containers.last() ? QJsonParseError::UnterminatedObject
+                                     : QJsonParseError::UnterminatedArray, end);
+    return false;
+}
+
+/*!
+    Discards all state, so that the parser can be used for a new document.
+*/
+void QJsonStreamParser::reset()
+{
+    d.reset(new QJsonStreamParserPrivate(d->handler, d->options));
+}
+
+/*!
+    Returns the number of objects and arrays the parser is currently inside
+    of. In QJsonStreamHandler::startObject() and
+    QJsonStreamHandler::startArray(), the new container is included.
+*/
+int QJsonStreamParser::depth() const
+{
+    return int(d->containers.size());
+}
+
+/*!
+    Returns \c true if a complete document has been parsed.
+*/
+bool QJsonStreamParser::atEnd() const
+{
+    return d->state == QJsonStreamParserPrivate::Finished;
+}
+
+/*!
+    Returns \c true if the document was found to be invalid.
+
+    \sa error()
+*/
+bool QJsonStreamParser::hasError() const
+{
+    return d->state == QJsonStreamParserPrivate::Failed;
+}
+
+/*!
+    Returns the error that stopped the parser. The offset of the error is
+    relative to the beginning of the document.
+
+    QJsonParseError::offset is an \c int, so for errors found after the
+    first 2 GB of a document it is clamped to \c INT_MAX. Use errorOffset()
+    to get the exact position.
+
+    \sa hasError(), errorOffset()
+*/
+QJsonParseError QJsonStreamParser::error() const
+{
+    return d->lastError;
+}
+
+/*!
+    Returns the position of the error that stopped the parser, relative to
+    the beginning of the document, or -1 if there was no error.
+
+    Unlike error(), this is exact for documents larger than 2 GB.
+
+    \sa error(), hasError()
+*/
+qint64 QJsonStreamParser::errorOffset() const
+{
+    return d->errorOffset;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,98 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QJSONSTREAMPARSER_H
+#define QJSONSTREAMPARSER_H
+
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonvalue.h>
+#include <QtCore/qscopedpointer.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QJsonStreamHandler
+{
+public:
+    virtual ~QJsonStreamHandler();
+
+    virtual void startObject();
+    virtual void endObject();
+    virtual void startArray();
+    virtual void endArray();
+    virtual void key(const QString &key);
+    virtual void value(const QJsonValue &value);
+};
+
+class QJsonStreamParserPrivate;
+class Q_CORE_EXPORT QJsonStreamParser
+{
+public:
+    enum Option {
+        NoOptions = 0x0,
+        MaterializeArrayElements = 0x1
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    explicit QJsonStreamParser(QJsonStreamHandler *handler, Options options = NoOptions);
+    ~QJsonStreamParser();
+
+    QJsonStreamHandler *handler() const;
+    Options options() const;
+
+    bool addData(QByteArrayView data);
+    bool finish();
+    void reset();
+
+    int depth() const;
+    bool atEnd() const;
+    bool hasError() const;
+    QJsonParseError error() const;
+    qint64 errorOffset() const;
+
+private:
+    Q_DISABLE_COPY(QJsonStreamParser)
+    QScopedPointer<QJsonStreamParserPrivate> d;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(QJsonStreamParser::Options)
+
+QT_END_NAMESPACE
+
+#endif // QJSONSTREAMPARSER_H
@@ -322,6 +322,15 @@ QT_BEGIN_NAMESPACE
 
 //-------------------------------------------------------------------
 
+#ifndef QT_NO_QOBJECT
+void QDeviceClosedNotifier::flushStream()
+{
+    stream->flush();
+    // closing the device unmaps it
+    stream->d_func()->unmapDevice();
+}
+#endif
+
 /*!
     \internal
 */
@@ -373,6 +382,7 @@ void QTextStreamPrivate::reset()
     readBufferOffset = 0;
     readBufferStartDevicePos = 0;
     lastTokenSize = 0;
+    mappingFailed = false;
 
     hasWrittenData = false;
     generateBOM = false;
@@ -392,6 +402,9 @@ bool QTextStreamPrivate::fillReadBuffer(qint64 maxBytes)
     Q_ASSERT(!string);
     Q_ASSERT(device);
 
+    // continue after the lines read from the mapping, if any
+    unmapDevice();
+
     // handle text translation and bypass the Text flag in the device.
     bool textModeEnabled = device->isTextModeEnabled();
     if (textModeEnabled)
@@ -501,6 +514,141 @@ void QTextStreamPrivate::resetReadBuffer()
     readBufferStartDevicePos = (device ? device->pos() : 0);
 }
 
+/*!
+    \internal
+
+    Maps the device for QTextStream::readLineView(), starting at the current
+    stream position. Returns \c false if lines have to be read through the
+    read buffer instead: mapping isn't enabled, the device isn't a regular
+    file, the encoding isn't one where '\n' is a single byte, or the device
+    translates line endings.
+*/
+bool QTextStreamPrivate::mapDevice()
+{
+    if (mappedData) {
+        if (mappedPos < mappedSize || mappedFile->size() <= mappedSize)
+            return true;
+
+        // the file has grown since it was mapped
+        const qint64 pos = mappedPos;
+        mappedFile->unmap(mappedData);
+        mappedData = mappedFile->map(0, mappedFile->size());
+        if (mappedData) {
+            mappedSize = mappedFile->size();
+            mappedPos = pos;
+            return true;
+        }
+        mappedFile = nullptr;
+        mappedSize = 0;
+        device->seek(pos);
+        mappingFailed = true;
+        return false;
+    }
+
+    if (!mappingEnabled || mappingFailed || device->isTextModeEnabled() || !device->isReadable())
+        return false;
+    if (encoding != QStringConverter::Utf8 && encoding != QStringConverter::Latin1)
+        return false;
+
+#ifndef QT_NO_QOBJECT
+    QFileDevice *file = qobject_cast<QFileDevice *>(device);
+#else
+    QFileDevice *file = nullptr;
+#endif
+    if (!file || file->isSequential()) {
+        mappingFailed = true;
+        return false;
+    }
+
+    const qint64 size = file->size();
+    if (size == 0)
+        return false;
+
+    // pos() decodes the read buffer again to find where the stream is
+    const qint64 pos = readBuffer.isEmpty() ? device->pos() : q_func()->pos();
+    if (pos < 0)
+        return false;
+    uchar *data = file->map(0, size);
+    if (!data) {
+        mappingFailed = true;
+        return false;
+    }
+    resetReadBuffer();
+    toUtf16.resetState();
+    lastTokenSize = 0;
+
+    if (autoDetectUnicode) {
+        autoDetectUnicode = false;
+        const QByteArrayView head(data + pos, qMin<qint64>(size - pos, QTEXTSTREAM_BUFFERSIZE));
+        auto e = QStringConverter::encodingForData(head);
+        // QStringConverter::Locale implies unknown, so keep the current encoding
+        if (e && *e != encoding) {
+            encoding = *e;
+            toUtf16 = QStringDecoder(encoding);
+            fromUtf16 = QStringEncoder(encoding);
+        }
+        if (encoding != QStringConverter::Utf8 && encoding != QStringConverter::Latin1) {
+            file->unmap(data);
+            return false;
+        }
+    }
+
+    mappedFile = file;
+    mappedData = data;
+    mappedSize = size;
+    mappedPos = pos;
+    // the decoder would skip a byte order mark at the start of the stream
+    if (pos == 0 && encoding == QStringConverter::Utf8 && size >= 3
+            && data[0] == 0xef && data[1] == 0xbb && data[2] == 0xbf) {
+        mappedPos = 3;
+    }
+    return true;
+}
+
+/*!
+    \internal
+
+    Leaves memory-mapped line reading, moving the device to the stream
+    position so that buffered reading and writing continue from there.
+*/
+void QTextStreamPrivate::unmapDevice()
+{
+    if (!mappedData)
+        return;
+
+    mappedFile->unmap(mappedData);
+    mappedFile = nullptr;
+    mappedData = nullptr;
+    mappedSize = 0;
+    if (device->isOpen())
+        device->seek(mappedPos);
+    resetReadBuffer();
+}
+
+/*!
+    \internal
+
+    Returns the next line in the mapping, without its end-of-line
+    characters, the same way scan() does for EndOfLine.
+*/
+bool QTextStreamPrivate::readMappedLine(QByteArrayView *line)
+{
+    Q_ASSERT(mappedData);
+    if (mappedPos >= mappedSize) {
+        *line = QByteArrayView();
+        return false;
+    }
+
+    const QByteArrayView rest(mappedData + mappedPos, mappedSize - mappedPos);
+    const qsizetype newline = rest.indexOf('\n');
+    qsizetype length = newline < 0 ? rest.size() : newline;
+    mappedPos += newline < 0 ? length : length + 1;
+    if (length && rest.at(length - 1) == '\r')
+        --length;
+    *line = rest.first(length);
+    return true;
+}
+
 /*!
     \internal
 */
@@ -519,6 +667,9 @@ void QTextStreamPrivate::flushWriteBuffer()
     if (writeBuffer.isEmpty())
         return;
 
+    // write at the stream position, not where the device was left
+    unmapDevice();
+
 #if defined (Q_OS_WIN)
     // handle text translation and bypass the Text flag in the device.
     bool textModeEnabled = device->isTextModeEnabled();
@@ -614,6 +765,27 @@ bool QTextStreamPrivate::scan(const QChar **ptr, int *length, int maxlen, TokenD
         }
         chPtr += startOffset;
 
+        if (delimiter == EndOfLine) {
+            // QStringView::indexOf() searches many characters at a time
+            int available = endOffset - startOffset;
+            if (maxlen)
+                available = qMin(available, maxlen - totalSize);
+            if (available > 0) {
+                const qsizetype newline = QStringView(chPtr, available).indexOf(QLatin1Char('\n'));
+                const int scanned = newline < 0 ? available : int(newline) + 1;
+                if (newline >= 0) {
+                    const QChar previous = newline ? chPtr[newline - 1] : lastChar;
+                    foundToken = true;
+                    delimSize = (previous == QLatin1Char('\r')) ? 2 : 1;
+                    consumeDelimiter = true;
+                }
+                lastChar = chPtr[scanned - 1];
+                totalSize += scanned;
+                startOffset += scanned;
+            }
+            continue;
+        }
+
         for (; !foundToken && startOffset < endOffset && (!maxlen || totalSize < maxlen); ++startOffset) {
             const QChar ch = *chPtr++;
             ++totalSize;
@@ -632,12 +804,7 @@ bool QTextStreamPrivate::scan(const QChar **ptr, int *length, int maxlen, TokenD
                 }
                 break;
             case EndOfLine:
-                if (ch == QLatin1Char('\n')) {
-                    foundToken = true;
-                    delimSize = (lastChar == QLatin1Char('\r')) ? 2 : 1;
-                    consumeDelimiter = true;
-                }
-                lastChar = ch;
+                Q_UNREACHABLE(); // handled above
                 break;
             }
         }
@@ -1097,6 +1264,8 @@ QTextStream::~QTextStream()
 #endif
     if (!d->writeBuffer.isEmpty())
         d->flushWriteBuffer();
+    if (d->device)
+        d->unmapDevice();
 }
 
 /*!
@@ -1134,6 +1303,7 @@ bool QTextStream::seek(qint64 pos)
     if (d->device) {
         // Empty the write buffer
         d->flushWriteBuffer();
+        d->unmapDevice();
         if (!d->device->seek(pos))
             return false;
         d->resetReadBuffer();
@@ -1169,6 +1339,9 @@ qint64 QTextStream::pos() const
 {
     Q_D(const QTextStream);
     if (d->device) {
+        if (d->mappedData)
+            return d->mappedPos;
+
         // Cutoff
         if (d->readBuffer.isEmpty())
             return d->device->pos();
@@ -1241,6 +1414,8 @@ void QTextStream::setDevice(QIODevice *device)
 {
     Q_D(QTextStream);
     flush();
+    if (d->device)
+        d->unmapDevice();
     if (d->deleteDevice) {
 #ifndef QT_NO_QOBJECT
         d->deviceClosedNotifier.disconnect();
@@ -1281,6 +1456,8 @@ void QTextStream::setString(QString *string, OpenMode openMode)
 {
     Q_D(QTextStream);
     flush();
+    if (d->device)
+        d->unmapDevice();
     if (d->deleteDevice) {
 #ifndef QT_NO_QOBJECT
         d->deviceClosedNotifier.disconnect();
@@ -1559,6 +1736,8 @@ bool QTextStream::atEnd() const
 
     if (d->string)
         return d->string->size() == d->stringOffset;
+    if (d->mappedData)
+        return d->mappedPos >= d->mappedSize && d->mappedFile->size() <= d->mappedSize;
     return d->readBuffer.isEmpty() && d->device->atEnd();
 }
 
@@ -1655,6 +1834,115 @@ bool QTextStream::readLineInto(QString *line, qint64 maxlen)
     return true;
 }
 
+/*!
+    \since 6.0
+
+    Reads one line of text from the stream and points \a line at it.
+
+    Unlike readLineInto(), this function doesn't copy the line out of the
+    stream, so reading a file line by line doesn't allocate memory for each
+    line. If memory mapping is enabled, the stream operates on a QFile, or
+    another QFileDevice that can be memory-mapped, and its encoding is UTF-8
+    or Latin-1, the stream maps the file and decodes one line at a time from
+    the mapping into a reusable buffer. Otherwise the line is read as with
+    readLineInto().
+
+    The view is only valid until the next call to a function that reads from
+    the stream, or that changes its device, string or position.
+
+    The resulting line has no trailing end-of-line characters ("\\n"
+    or "\\r\\n").
+
+    Returns \c false if the stream has read to the end of the file or
+    an error has occurred; otherwise returns \c true.
+
+    \sa readLineInto(), setMemoryMappingEnabled()
+*/
+bool QTextStream::readLineView(QStringView *line)
+{
+    Q_D(QTextStream);
+    CHECK_VALID_STREAM(false);
+
+    if (d->string) {
+        // the string outlives the view, so point into it
+        const QChar *readPtr;
+        int length;
+        if (!d->scan(&readPtr, &length, 0, QTextStreamPrivate::EndOfLine)) {
+            *line = QStringView();
+            return false;
+        }
+        *line = QStringView(readPtr, length);
+        d->consumeLastToken();
+        return true;
+    }
+
+    if (!d->mapDevice()) {
+        if (!readLineInto(&d->lineBuffer)) {
+            *line = QStringView();
+            return false;
+        }
+        *line = d->lineBuffer;
+        return true;
+    }
+
+    QByteArrayView bytes;
+    if (!d->readMappedLine(&bytes)) {
+        *line = QStringView();
+        return false;
+    }
+    // lines start on a character boundary, so no state is carried over
+    QStringDecoder decoder(d->encoding, QStringDecoder::Flag::Stateless);
+    d->lineBuffer.resize(decoder.requiredSpace(bytes.size()));
+    const QChar *end = decoder.appendToBuffer(d->lineBuffer.data(), bytes);
+    d->lineBuffer.truncate(end - d->lineBuffer.constData());
+    *line = d->lineBuffer;
+    return true;
+}
+
+/*!
+    \since 6.0
+    \overload
+
+    Reads one line from the stream and points \a line at its bytes, without
+    decoding them.
+
+    If memory mapping is enabled, the stream operates on a QFile, or another
+    QFileDevice that can be memory-mapped, and its encoding is UTF-8 or
+    Latin-1, the view points straight into the mapped file: reading a line
+    costs a search for the next newline and nothing else. The bytes are not validated. Otherwise the line
+    is read as with readLineInto() and converted to Latin-1 if that is the
+    stream's encoding, and to UTF-8 if not.
+
+    The view is only valid until the next call to a function that reads from
+    the stream, or that changes its device, string or position.
+
+    \snippet code/src_corelib_io_qtextstream.cpp 11
+
+    \sa readLineInto(), encoding(), setMemoryMappingEnabled()
+*/
+bool QTextStream::readLineView(QByteArrayView *line)
+{
+    Q_D(QTextStream);
+    CHECK_VALID_STREAM(false);
+
+    if (d->device && d->mapDevice())
+        return d->readMappedLine(line);
+
+    QStringView text;
+    if (!readLineView(&text)) {
+        *line = QByteArrayView();
+        return false;
+    }
+    QStringEncoder encoder(d->encoding == QStringConverter::Latin1 ? QStringConverter::Latin1
+                                                                   : QStringConverter::Utf8,
+                           QStringEncoder::Flag::Stateless);
+    d->byteLineBuffer.resize(encoder.requiredSpace(text.size()));
+    const char *end = encoder.appendToBuffer(d->byteLineBuffer.data(), text);
+    d->byteLineBuffer.truncate(end - d->byteLineBuffer.constData());
+    *line = d->byteLineBuffer;
+    return true;
+}
+
 /*!
     \since 4.1
 
@@ -3048,6 +3336,43 @@ bool QTextStream::autoDetectUnicode() const
     return d->autoDetectUnicode;
 }
 
+/*!
+    \since 6.0
+
+    If \a enabled is true, readLineView() memory-maps the file the stream
+    operates on, if it can, instead of reading it through the stream's
+    buffer.
+
+    \warning Only enable this for files that are not truncated while the
+    stream reads them, such as files the application wrote itself. On most
+    platforms, accessing the part of a mapping past the end of a truncated
+    file makes the process crash, for instance with SIGBUS on Unix; log
+    rotation with copytruncate does this to the files it rotates.
+
+    \sa isMemoryMappingEnabled(), readLineView(), QFileDevice::map()
+*/
+void QTextStream::setMemoryMappingEnabled(bool enabled)
+{
+    Q_D(QTextStream);
+    if (!enabled)
+        d->unmapDevice();
+    d->mappingEnabled = enabled;
+}
+
+/*!
+    \since 6.0
+
+    Returns \c true if readLineView() may memory-map the stream's file,
+    otherwise returns \c false. Memory mapping is disabled by default.
+
+    \sa setMemoryMappingEnabled()
+*/
+bool QTextStream::isMemoryMappingEnabled() const
+{
+    Q_D(const QTextStream);
+    return d->mappingEnabled;
+}
+
 /*!
     If \a generate is true and a UTF encoding is used, QTextStream will insert
     the BOM (Byte Order Mark) before any data has been written to the
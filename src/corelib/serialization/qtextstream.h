@@ -101,6 +101,8 @@ public:
     QStringConverter::Encoding encoding() const;
     void setAutoDetectUnicode(bool enabled);
     bool autoDetectUnicode() const;
+    void setMemoryMappingEnabled(bool enabled);
+    bool isMemoryMappingEnabled() const;
     void setGenerateByteOrderMark(bool generate);
     bool generateByteOrderMark() const;
 
@@ -127,6 +129,8 @@ public:
 
     QString readLine(qint64 maxlen = 0);
     bool readLineInto(QString *line, qint64 maxlen = 0);
+    bool readLineView(QStringView *line);
+    bool readLineView(QByteArrayView *line);
     QString readAll();
     QString read(qint64 maxlen);
 
@@ -190,6 +194,7 @@ private:
     Q_DISABLE_COPY(QTextStream)
     friend class QDebugStateSaverPrivate;
     friend class QDebug;
+    friend class QDeviceClosedNotifier;
 
     QScopedPointer<QTextStreamPrivate> d_ptr;
 };
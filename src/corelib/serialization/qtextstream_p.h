@@ -53,6 +53,7 @@
 //
 
 #include <QtCore/private/qglobal_p.h>
+#include "qfiledevice.h"
 #include "qiodevice.h"
 #include "qlocale.h"
 #include "qtextstream.h"
@@ -76,7 +77,7 @@ public:
     }
 
 public Q_SLOTS:
-    inline void flushStream() { stream->flush(); }
+    void flushStream();
 
 private:
     QTextStream *stream;
@@ -128,6 +129,17 @@ public:
     int readConverterSavedStateOffset; //the offset between readBufferStartDevicePos and that start of the buffer
     qint64 readBufferStartDevicePos;
 
+    // memory-mapped line reading; while mappedData is set, mappedPos is the
+    // stream position and the device position is stale
+    QFileDevice *mappedFile = nullptr;
+    uchar *mappedData = nullptr;
+    qint64 mappedSize = 0;
+    qint64 mappedPos = 0;
+    bool mappingEnabled = false;
+    bool mappingFailed = false;
+    QString lineBuffer;
+    QByteArray byteLineBuffer;
+
     Params params;
 
     // status
@@ -190,6 +202,10 @@ public:
     bool fillReadBuffer(qint64 maxBytes = -1);
     void resetReadBuffer();
     void flushWriteBuffer();
+
+    bool mapDevice();
+    void unmapDevice();
+    bool readMappedLine(QByteArrayView *line);
 };
 
 QT_END_NAMESPACE
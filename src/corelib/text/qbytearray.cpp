@@ -52,6 +52,7 @@
 #include "qscopedpointer.h"
 #include "qbytearray_p.h"
 #include <qdatastream.h>
+#include <qendian.h>
 #include <qmath.h>
 
 #ifndef QT_NO_COMPRESS
@@ -59,6 +60,7 @@
 #include <zlib.h>
 #endif
 #include <ctype.h>
+#include <float.h>
 #include <limits.h>
 #include <string.h>
 #include <stdlib.h>
@@ -1877,6 +1879,22 @@ QByteArray &QByteArray::append(const QByteArray &ba)
     array. Ensure that \a len is \e not longer than \a str.
 */
 
+/*!
+    \fn template <typename...Args> QByteArray &QByteArray::appendArgs(const QLatin1String &format, const Args &...args)
+    \since 6.0
+
+    Appends a copy of \a format to this byte array in which the \c{%N}
+    placeholders are replaced by \a args, encoded in UTF-8, and returns a
+    reference to this byte array.
+
+    The placeholders and the arguments are handled as by
+    QString::appendArgs(), without creating an intermediate QString.
+
+    \snippet code/src_corelib_text_qbytearray.cpp 55
+
+    \sa QString::appendArgs(), append()
+*/
+
 /*! \fn QByteArray &QByteArray::append(qsizetype count, char ch)
 
     \overload
@@ -3707,6 +3725,363 @@ float QByteArray::toFloat(bool *ok) const
     return QLocaleData::convertDoubleToFloat(toDouble(ok), ok);
 }
 
+/*
+    Locale-free parsing of separated numbers, for QByteArrayView::parseNumbers().
+
+    Runs of decimal digits are found 16 bytes at a time and converted eight
+    digits at a time (SWAR: SIMD within a 64-bit register). Floating-point
+    numbers with at most 19 significant digits and a small decimal exponent
+    take Clinger's fast path, which is exact: the mantissa and the power of
+    ten are both exactly representable doubles, so one multiplication or
+    division rounds correctly. Everything else goes through
+    qt_asciiToDouble(), as QByteArray::toDouble() does.
+*/
+namespace {
+
+inline bool isSpaceExcept(char c, char separator)
+{
+    return c != separator && ascii_isspace(uchar(c));
+}
+
+inline const char *skipSpaces(const char *p, const char *end, char separator)
+{
+    while (p != end && isSpaceExcept(*p, separator))
+        ++p;
+    return p;
+}
+
+// returns p if only spaces are left before the next separator or the end
+inline const char *fieldEnd(const char *p, const char *end, char separator)
+{
+    p = skipSpaces(p, end, separator);
+    return p == end || *p == separator ? p : nullptr;
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+#if QT_COMPILER_USES(sse2)
+inline qsizetype digitRunLength(const char *p, const char *end)
+{
+    const char *const begin = p;
+    for ( ; end - p >= 16; p += 16) {
+        const __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        // bytes >= 0x80 are negative, so they fail the first comparison
+        const __m128i digits = _mm_and_si128(_mm_cmpgt_epi8(data, _mm_set1_epi8('0' - 1)),
+                                             _mm_cmplt_epi8(data, _mm_set1_epi8('9' + 1)));
+        const uint mask = ~uint(_mm_movemask_epi8(digits)) & 0xffff;
+        if (mask)
+            return p - begin + qCountTrailingZeroBits(mask);
+    }
+    while (p != end && isDigit(*p))
+        ++p;
+    return p - begin;
+}
+#elif QT_COMPILER_USES(neon) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+inline qsizetype digitRunLength(const char *p, const char *end)
+{
+    const char *const begin = p;
+    for ( ; end - p >= 16; p += 16) {
+        const uint8x16_t data = vld1q_u8(reinterpret_cast<const uchar *>(p));
+        const uint8x16_t other = vcgtq_u8(vsubq_u8(data, vdupq_n_u8('0')), vdupq_n_u8(9));
+        // narrowing the comparison result leaves four bits per byte in a 64-bit mask
+        const uint8x8_t bits = vshrn_n_u16(vreinterpretq_u16_u8(other), 4);
+        const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(bits), 0);
+        if (mask)
+            return p - begin + qCountTrailingZeroBits(mask) / 4;
+    }
+    while (p != end && isDigit(*p))
+        ++p;
+    return p - begin;
+}
+#else
+inline qsizetype digitRunLength(const char *p, const char *end)
+{
+    const char *const begin = p;
+    while (p != end && isDigit(*p))
+        ++p;
+    return p - begin;
+}
+#endif
+
+// converts eight ASCII digits, the first one in the lowest byte
+inline quint32 eightDigitsValue(quint64 chunk)
+{
+    const quint64 mask = 0x000000FF000000FF;
+    const quint64 mul1 = 100 + (Q_UINT64_C(1000000) << 32);
+    const quint64 mul2 = 1 + (Q_UINT64_C(10000) << 32);
+    chunk -= Q_UINT64_C(0x3030303030303030);
+    chunk = chunk * 10 + (chunk >> 8);    // pairs of digits
+    chunk = ((chunk & mask) * mul1 + ((chunk >> 16) & mask) * mul2) >> 32;
+    return quint32(chunk);
+}
+
+// the value of at most 19 digits, which always fits
+inline quint64 digitsValue(const char *p, qsizetype length)
+{
+    Q_ASSERT(length <= 19);
+    quint64 value = 0;
+    for ( ; length >= 8; p += 8, length -= 8)
+        value = value * 100000000 + eightDigitsValue(qFromLittleEndian<quint64>(p));
+    for ( ; length; ++p, --length)
+        value = value * 10 + (*p - '0');
+    return value;
+}
+
+// parses [sign] digits; *negative is left false if sign isn't allowed
+inline const char *parseMagnitude(const char *p, const char *end, char separator,
+                                  bool allowMinus, quint64 *magnitude, bool *negative)
+{
+    p = skipSpaces(p, end, separator);
+    *negative = false;
+    if (p != end && (*p == '+' || *p == '-')) {
+        *negative = *p == '-';
+        if (*negative && !allowMinus)
+            return nullptr;
+        ++p;
+    }
+
+    qsizetype length = digitRunLength(p, end);
+    if (!length)
+        return nullptr;
+    const char *const digitsEnd = p + length;
+    while (length > 1 && *p == '0') {
+        ++p;
+        --length;
+    }
+    if (length <= 19) {
+        *magnitude = digitsValue(p, length);
+    } else if (length == 20) {
+        quint64 value = digitsValue(p, 19);
+        if (mul_overflow(value, quint64(10), &value)
+                || add_overflow(value, quint64(p[19] - '0'), &value)) {
+            return nullptr;
+        }
+        *magnitude = value;
+    } else {
+        return nullptr;
+    }
+    return fieldEnd(digitsEnd, end, separator);
+}
+
+const char *parseField(const char *p, const char *end, char separator, qulonglong *value)
+{
+    quint64 magnitude;
+    bool negative;
+    p = parseMagnitude(p, end, separator, false, &magnitude, &negative);
+    if (p)
+        *value = magnitude;
+    return p;
+}
+
+const char *parseField(const char *p, const char *end, char separator, qlonglong *value)
+{
+    quint64 magnitude;
+    bool negative;
+    p = parseMagnitude(p, end, separator, true, &magnitude, &negative);
+    if (!p)
+        return nullptr;
+    const quint64 limit = quint64(std::numeric_limits<qlonglong>::max()) + (negative ? 1 : 0);
+    if (magnitude > limit)
+        return nullptr;
+    // as in QLocaleData::longLongToString(), avoid negating min()
+    *value = negative ? qlonglong(0 - magnitude) : qlonglong(magnitude);
+    return p;
+}
+
+// Clinger's fast path; returns nullptr if the text needs the full conversion
+inline const char *parseSimpleDouble(const char *p, const char *end, char separator, double *value)
+{
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    static const double powersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    const bool negative = p != end && *p == '-';
+    if (negative)
+        ++p;
+
+    // the significant digits, without leading zeros, may span the point
+    const qsizetype integralLength = digitRunLength(p, end);
+    if (!integralLength)
+        return nullptr;
+    const char *integral = p;
+    p += integralLength;
+    const char *fraction = p;
+    qsizetype fractionLength = 0;
+    if (p != end && *p == '.') {
+        fraction = ++p;
+        fractionLength = digitRunLength(p, end);
+        if (!fractionLength)
+            return nullptr;
+        p += fractionLength;
+    }
+    int exponent = 0;
+    if (p != end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        const bool negativeExponent = p != end && *p == '-';
+        if (p != end && (*p == '-' || *p == '+'))
+            ++p;
+        const qsizetype exponentLength = digitRunLength(p, end);
+        if (!exponentLength || exponentLength > 4)
+            return nullptr;
+        exponent = int(digitsValue(p, exponentLength));
+        if (negativeExponent)
+            exponent = -exponent;
+        p += exponentLength;
+    }
+    p = fieldEnd(p, end, separator);
+    if (!p)
+        return nullptr;
+
+    qsizetype leadingZeros = 0;
+    while (leadingZeros < integralLength && integral[leadingZeros] == '0')
+        ++leadingZeros;
+    quint64 mantissa;
+    if (leadingZeros < integralLength) {
+        const qsizetype length = integralLength - leadingZeros;
+        if (length + fractionLength > 19)
+            return nullptr;
+        mantissa = digitsValue(integral + leadingZeros, length);
+        mantissa = mantissa * quint64(powersOfTen[fractionLength]) + digitsValue(fraction, fractionLength);
+    } else {
+        while (fractionLength && *fraction == '0') {
+            ++fraction;
+            --fractionLength;
+            --exponent;
+        }
+        if (fractionLength > 19)
+            return nullptr;
+        mantissa = digitsValue(fraction, fractionLength);
+    }
+    exponent -= int(fractionLength);
+
+    if (mantissa > (Q_UINT64_C(1) << std::numeric_limits<double>::digits))
+        return nullptr;
+    double d = double(mantissa);
+    if (mantissa) {
+        if (exponent < -22 || exponent > 22)
+            return nullptr;
+        d = exponent < 0 ? d / powersOfTen[-exponent] : d * powersOfTen[exponent];
+    }
+    *value = negative ? -d : d;
+    return p;
+#else
+    // excess precision in intermediate results breaks the fast path
+    Q_UNUSED(p);
+    Q_UNUSED(end);
+    Q_UNUSED(separator);
+    Q_UNUSED(value);
+    return nullptr;
+#endif
+}
+
+const char *parseField(const char *p, const char *end, char separator, double *value)
+{
+    p = skipSpaces(p, end, separator);
+    if (const char *next = parseSimpleDouble(p, end, separator, value))
+        return next;
+
+    const char *next = std::find(p, end, separator);
+    QByteArrayView field(p, next);
+    while (!field.isEmpty() && ascii_isspace(uchar(field.back())))
+        field.chop(1);
+    bool ok;
+    int processed;
+    const double d = qt_asciiToDouble(field.data(), field.size(), ok, processed);
+    if (!ok)
+        return nullptr;
+    *value = d;
+    return next;
+}
+
+template <typename T>
+qsizetype parseNumbersImpl(QByteArrayView data, T *values, qsizetype maxCount, char separator,
+                           qsizetype *endPosition)
+{
+    const char *const begin = data.data();
+    const char *const end = begin + data.size();
+    const char *p = begin;
+    qsizetype count = 0;
+    while (count < maxCount && p != end) {
+        const char *next = parseField(p, end, separator, values + count);
+        if (!next)
+            break;
+        ++count;
+        // a trailing separator starts an empty field, which stops parsing
+        // in front of it like the one in "1,,2" does
+        if (next == end || next + 1 == end) {
+            p = next;
+            break;
+        }
+        p = next + 1;
+    }
+    if (endPosition)
+        *endPosition = p - begin;
+    return count;
+}
+
+} // unnamed namespace
+
+/*!
+    \since 6.0
+
+    Parses the numbers in this view, separated by \a separator, into the
+    array of \a maxCount integers at \a values, and returns how many were
+    stored.
+
+    Each number is a sequence of decimal digits with an optional leading
+    \c{+} or \c{-} sign. ASCII whitespace around the numbers, other than \a
+    separator itself, is skipped. Parsing stops at the end of the view, after
+    \a maxCount numbers or at the first field that isn't a number in range.
+    An empty field isn't a number, wherever it is: parsing stops at the
+    second separator in \c{"1,,2"} and at the trailing one in \c{"1,2,"}.
+    If \a endPosition is not \nullptr, it is set to the offset at which
+    parsing stopped: the size of the view if everything was parsed, the
+    offset of a trailing separator, and otherwise the start of the first
+    field that wasn't stored. Parsing can therefore resume with
+    sliced(*endPosition).
+
+    Unlike QByteArray::toLongLong(), this function doesn't copy its input
+    and never allocates memory. The conversion is always in the C locale.
+
+    \snippet code/src_corelib_text_qbytearray.cpp 57
+
+    \sa QByteArray::toLongLong(), QByteArray::appendNumbers()
+*/
+qsizetype QByteArrayView::parseNumbers(qlonglong *values, qsizetype maxCount, char separator,
+                                       qsizetype *endPosition) const
+{
+    return parseNumbersImpl(*this, values, maxCount, separator, endPosition);
+}
+
+/*!
+    \overload
+    \since 6.0
+
+    A number with a \c{-} sign is not a valid unsigned integer.
+*/
+qsizetype QByteArrayView::parseNumbers(qulonglong *values, qsizetype maxCount, char separator,
+                                       qsizetype *endPosition) const
+{
+    return parseNumbersImpl(*this, values, maxCount, separator, endPosition);
+}
+
+/*!
+    \overload
+    \since 6.0
+
+    The numbers have the syntax QByteArray::toDouble() accepts. A number that
+    overflows or underflows stops parsing like any other invalid field.
+*/
+qsizetype QByteArrayView::parseNumbers(double *values, qsizetype maxCount, char separator,
+                                       qsizetype *endPosition) const
+{
+    return parseNumbersImpl(*this, values, maxCount, separator, endPosition);
+}
+
 /*!
     \since 5.2
 
@@ -3912,14 +4287,14 @@ QByteArray &QByteArray::setNum(qulonglong n, int base)
     \sa toDouble()
 */
 
-QByteArray &QByteArray::setNum(double n, char f, int prec)
+static QLocaleData::DoubleForm doubleFormForFormat(char f, uint *flags)
 {
     QLocaleData::DoubleForm form = QLocaleData::DFDecimal;
-    uint flags = QLocaleData::ZeroPadExponent;
+    *flags = QLocaleData::ZeroPadExponent;
 
     char lower = asciiLower(uchar(f));
     if (f != lower)
-        flags |= QLocaleData::CapitalEorX;
+        *flags |= QLocaleData::CapitalEorX;
     f = lower;
 
     switch (f) {
@@ -3938,8 +4313,20 @@ QByteArray &QByteArray::setNum(double n, char f, int prec)
 #endif
             break;
     }
+    return form;
+}
 
-    *this = QLocaleData::c()->doubleToString(n, prec, form, -1, flags).toUtf8();
+QByteArray &QByteArray::setNum(double n, char f, int prec)
+{
+    uint flags;
+    const QLocaleData::DoubleForm form = doubleFormForFormat(f, &flags);
+
+    QCLocaleNumberFormatter formatter;
+    const bool ok = formatter.setDouble(n, prec, form, -1, flags);
+    Q_ASSERT(ok); // no digit grouping
+    Q_UNUSED(ok);
+    resize(formatter.size());
+    formatter.write(data());
     return *this;
 }
 
@@ -4076,6 +4463,86 @@ QByteArray QByteArray::number(double n, char f, int prec)
     return s;
 }
 
+template <typename T, typename SetNumber>
+static void appendNumbersImpl(QByteArray &out, const T *values, qsizetype count,
+                              QByteArrayView separator, SetNumber setNumber)
+{
+    // the separator may point into out, which appending reallocates
+    QVarLengthArray<char, 16> sep;
+    sep.append(separator.data(), separator.size());
+
+    QCLocaleNumberFormatter formatter;
+    for (qsizetype i = 0; i < count; ++i) {
+        const bool ok = setNumber(formatter, values[i]);
+        Q_ASSERT(ok); // no digit grouping, always base 10
+        Q_UNUSED(ok);
+
+        const qsizetype separatorSize = i ? sep.size() : 0;
+        const qsizetype oldSize = out.size();
+        out.resize(oldSize + separatorSize + formatter.size());
+        char *dst = out.data() + oldSize;
+        dst = std::copy(sep.cbegin(), sep.cbegin() + separatorSize, dst);
+        formatter.write(dst);
+    }
+}
+
+/*!
+    \since 6.0
+
+    Appends the decimal text of the \a count integers starting at \a values
+    to this byte array, separated by \a separator, and returns a reference to
+    this byte array.
+
+    The numbers are formatted as number() does, but directly into this byte
+    array: it grows as needed and no temporary byte array is created for each
+    number.
+
+    \snippet code/src_corelib_text_qbytearray.cpp 56
+
+    \sa number(), append(), QString::appendNumbers()
+*/
+QByteArray &QByteArray::appendNumbers(const qlonglong *values, qsizetype count, QByteArrayView separator)
+{
+    appendNumbersImpl(*this, values, count, separator, [](QCLocaleNumberFormatter &f, qlonglong n) {
+        // as in QLocaleData::longLongToString(), avoid negating min()
+        return f.setInteger(n < 0 ? 0 - qulonglong(n) : qulonglong(n), n < 0);
+    });
+    return *this;
+}
+
+/*!
+    \overload
+    \since 6.0
+*/
+QByteArray &QByteArray::appendNumbers(const qulonglong *values, qsizetype count, QByteArrayView separator)
+{
+    appendNumbersImpl(*this, values, count, separator, [](QCLocaleNumberFormatter &f, qulonglong n) {
+        return f.setInteger(n, false);
+    });
+    return *this;
+}
+
+/*!
+    \overload
+    \since 6.0
+
+    Appends the text of the \a count numbers starting at \a values, separated
+    by \a separator, formatted according to the given \a format and \a
+    precision as by number(). With a \a precision of
+    QLocale::FloatingPointShortest, each number gets the fewest digits that
+    still read back as the same value.
+*/
+QByteArray &QByteArray::appendNumbers(const double *values, qsizetype count, QByteArrayView separator,
+                                      char format, int precision)
+{
+    uint flags;
+    const QLocaleData::DoubleForm form = doubleFormForFormat(format, &flags);
+    appendNumbersImpl(*this, values, count, separator, [=](QCLocaleNumberFormatter &f, double d) {
+        return f.setDouble(d, precision, form, -1, flags);
+    });
+    return *this;
+}
+
 /*!
     \fn QByteArray QByteArray::fromRawData(const char *data, qsizetype size) constexpr
 
@@ -121,8 +121,15 @@ inline quint16 qChecksum(const char *s, qsizetype len,
 #endif
 
 class QString;
+class QLatin1String;
 class QDataStream;
 
+namespace QtPrivate {
+// Formats the arguments of QByteArray::appendArgs(). Defined in qstring.h,
+// next to the argument types it accepts.
+template <typename...Args> struct ByteArrayArgsAppender;
+}
+
 using QByteArrayData = QArrayDataPointer<char>;
 
 #  define QByteArrayLiteral(str) \
@@ -297,6 +304,12 @@ public:
     QByteArray &append(const QByteArray &a);
     QByteArray &append(QByteArrayView a)
     { return insert(size(), a); }
+    template <typename...Args>
+    QByteArray &appendArgs(const QLatin1String &format, const Args &...args)
+    {
+        QtPrivate::ByteArrayArgsAppender<Args...>::append(*this, format, args...);
+        return *this;
+    }
 
     QByteArray &insert(qsizetype i, QByteArrayView data);
     QByteArray &insert(qsizetype i, qsizetype count, char c);
@@ -374,6 +387,11 @@ public:
     [[nodiscard]] static QByteArray number(qlonglong, int base = 10);
     [[nodiscard]] static QByteArray number(qulonglong, int base = 10);
     [[nodiscard]] static QByteArray number(double, char f = 'g', int prec = 6);
+
+    QByteArray &appendNumbers(const qlonglong *values, qsizetype count, QByteArrayView separator);
+    QByteArray &appendNumbers(const qulonglong *values, qsizetype count, QByteArrayView separator);
+    QByteArray &appendNumbers(const double *values, qsizetype count, QByteArrayView separator,
+                              char format = 'g', int precision = 6);
     [[nodiscard]] static QByteArray fromRawData(const char *data, qsizetype size)
     {
         return QByteArray(DataPointer(nullptr, const_cast<char *>(data), size));
@@ -270,6 +270,13 @@ public:
     [[nodiscard]] qsizetype count(char ch) const noexcept
     { return QtPrivate::count(*this, QByteArrayView(&ch, 1)); }
 
+    qsizetype parseNumbers(qlonglong *values, qsizetype maxCount, char separator = ',',
+                           qsizetype *endPosition = nullptr) const;
+    qsizetype parseNumbers(qulonglong *values, qsizetype maxCount, char separator = ',',
+                           qsizetype *endPosition = nullptr) const;
+    qsizetype parseNumbers(double *values, qsizetype maxCount, char separator = ',',
+                           qsizetype *endPosition = nullptr) const;
+
     //
     // STL compatibility API:
     //
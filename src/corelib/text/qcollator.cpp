@@ -43,6 +43,14 @@
 #include "qstring.h"
 
 #include "qdebug.h"
+#if QT_CONFIG(thread)
+#include "qsemaphore.h"
+#include "qthread.h"
+#include "qthreadpool.h"
+#endif
+
+#include <algorithm>
+#include <numeric>
 
 QT_BEGIN_NAMESPACE
 
@@ -67,6 +75,10 @@ QT_BEGIN_NAMESPACE
 
     In addition to the locale and collation strategy, several optional flags can
     be set that influence the result of the collation.
+
+    To sort a large list of strings, use sort(), or sortKeys() to compute the
+    sort keys of all the strings at once; both are much faster than calling
+    compare() for every pair of strings that the sorting algorithm visits.
 */
 
 /*!
@@ -341,6 +353,56 @@ int QCollator::compare(const QChar *s1, int len1, const QChar *s2, int len2) con
 }
 #endif // QT_STRINGVIEW_LEVEL < 2
 
+/*!
+    \internal
+
+    Returns the number of chunks that \a count strings are split into to be
+    processed in parallel.
+*/
+static qsizetype collatorChunkCount(qsizetype count)
+{
+#if QT_CONFIG(thread)
+    // below this, starting a thread costs more than it saves
+    constexpr qsizetype MinimumChunkSize = 4096;
+    return qBound(qsizetype(1), count / MinimumChunkSize, qsizetype(QThread::idealThreadCount()));
+#else
+    Q_UNUSED(count);
+    return 1;
+#endif
+}
+
+/*!
+    \internal
+
+    Splits [0, \a count) into \a chunks consecutive ranges and calls
+    \a func(chunk, begin, end) for each of them, on threads of the global
+    thread pool. Chunks that cannot be started on a pool thread (for
+    instance because all of them are busy) run on the calling thread, so
+    that this never waits for unrelated tasks.
+*/
+template <typename Func>
+static void collatorForEachChunk(qsizetype count, qsizetype chunks, Func func)
+{
+#if QT_CONFIG(thread)
+    QSemaphore done;
+    for (qsizetype chunk = 1; chunk < chunks; ++chunk) {
+        const qsizetype begin = count * chunk / chunks;
+        const qsizetype end = count * (chunk + 1) / chunks;
+        const auto task = [&func, &done, chunk, begin, end] {
+            func(chunk, begin, end);
+            done.release();
+        };
+        if (!QThreadPool::globalInstance()->tryStart(task))
+            task();
+    }
+    func(0, 0, count / chunks);
+    done.acquire(int(chunks - 1));
+#else
+    Q_ASSERT(chunks == 1);
+    func(0, 0, count);
+#endif
+}
+
 /*!
     \fn QCollatorSortKey QCollator::sortKey(const QString &string) const
 
@@ -354,6 +416,123 @@ int QCollator::compare(const QChar *s1, int len1, const QChar *s2, int len2) con
     \note Not supported with the C (a.k.a. POSIX) locale on Darwin.
  */
 
+/*!
+    \since 6.0
+
+    Returns the sort keys of all the strings in \a strings, in the same
+    order.
+
+    This is equivalent to calling sortKey() for each string, but stores all
+    the keys in a single block of memory, and computes them on several
+    threads when \a strings is large. If all the strings are ASCII-only,
+    some back-ends use a cheaper form of keys; such keys can only be compared
+    within the returned list.
+
+    \note Not supported with the C (a.k.a. POSIX) locale on Darwin.
+
+    \sa sort(), QCollatorSortKeyList::compare()
+*/
+QCollatorSortKeyList QCollator::sortKeys(const QStringList &strings) const
+{
+    if (d->dirty)
+        d->init();
+
+    const bool allAscii = std::all_of(strings.cbegin(), strings.cend(), [](const QString &s) {
+        return QtPrivate::isAscii(s);
+    });
+
+    // each chunk of strings gets its own key storage, merged at the end
+    const qsizetype count = strings.size();
+    const qsizetype chunks = collatorChunkCount(count);
+    QVarLengthArray<CollatorKeyType, 1> keys(chunks);
+    QVarLengthArray<QList<qsizetype>, 1> offsets(chunks);
+    collatorForEachChunk(count, chunks, [&](qsizetype chunk, qsizetype begin, qsizetype end) {
+        CollatorKeyType &chunkKeys = keys[chunk];
+        QList<qsizetype> &chunkOffsets = offsets[chunk];
+        chunkOffsets.reserve(end - begin + 1);
+        for (qsizetype i = begin; i < end; ++i) {
+            chunkOffsets.append(chunkKeys.size());
+            d->appendSortKey(chunkKeys, strings.at(i), allAscii);
+        }
+    });
+
+    QCollatorSortKeyListPrivate *list = new QCollatorSortKeyListPrivate;
+    if (chunks == 1) {
+        list->keys = std::move(keys[0]);
+        list->offsets = std::move(offsets[0]);
+    } else {
+        qsizetype size = 0;
+        for (const CollatorKeyType &chunkKeys : qAsConst(keys))
+            size += chunkKeys.size();
+        list->keys.reserve(size);
+        list->offsets.reserve(count + 1);
+        for (qsizetype chunk = 0; chunk < chunks; ++chunk) {
+            const qsizetype base = list->keys.size();
+            for (qsizetype offset : qAsConst(offsets[chunk]))
+                list->offsets.append(base + offset);
+            list->keys.append(keys[chunk]);
+        }
+    }
+    list->offsets.append(list->keys.size());
+    return QCollatorSortKeyList(list);
+}
+
+/*!
+    \since 6.0
+
+    Sorts \a strings according to this collator. The sort is stable: strings
+    that compare equal keep their relative order.
+
+    The strings are sorted by their sort keys, computed by sortKeys(); for
+    large lists, both computing and sorting the keys are spread over several
+    threads of the global QThreadPool.
+
+    \sa sortKeys(), compare()
+*/
+void QCollator::sort(QStringList &strings) const
+{
+    const qsizetype count = strings.size();
+    if (count < 2)
+        return;
+
+    const QCollatorSortKeyList keys = sortKeys(strings);
+
+    // sort references to the keys by chunks, then merge the chunks
+    struct Entry {
+        const CollatorKeyUnit *key;
+        qsizetype length;
+        qsizetype index;
+    };
+    const auto lessThan = [](const Entry &lhs, const Entry &rhs) {
+        return QCollatorPrivate::compareSortKeys(lhs.key, lhs.length, rhs.key, rhs.length) < 0;
+    };
+
+    QList<Entry> order(count);
+    Entry *entries = order.data();
+    const qsizetype *offsets = keys.d->offsets.constData();
+    for (qsizetype i = 0; i < count; ++i)
+        entries[i] = { keys.d->keys.constData() + offsets[i], offsets[i + 1] - offsets[i], i };
+
+    const qsizetype chunks = collatorChunkCount(count);
+    collatorForEachChunk(count, chunks, [&](qsizetype, qsizetype begin, qsizetype end) {
+        std::stable_sort(entries + begin, entries + end, lessThan);
+    });
+    for (qsizetype width = 1; width < chunks; width *= 2) {
+        for (qsizetype chunk = 0; chunk + width < chunks; chunk += 2 * width) {
+            const qsizetype begin = count * chunk / chunks;
+            const qsizetype middle = count * (chunk + width) / chunks;
+            const qsizetype end = count * qMin(chunk + 2 * width, chunks) / chunks;
+            std::inplace_merge(entries + begin, entries + middle, entries + end, lessThan);
+        }
+    }
+
+    QStringList sorted;
+    sorted.reserve(count);
+    for (qsizetype i = 0; i < count; ++i)
+        sorted.append(std::move(strings[entries[i].index]));
+    strings = std::move(sorted);
+}
+
 /*!
     \class QCollatorSortKey
     \inmodule QtCore
@@ -440,4 +619,111 @@ QCollatorSortKey& QCollatorSortKey::operator=(const QCollatorSortKey &other)
     \sa operator<()
  */
 
+/*!
+    \class QCollatorSortKeyList
+    \inmodule QtCore
+    \brief The QCollatorSortKeyList class holds the sort keys of a list of strings.
+
+    \since 6.0
+
+    The QCollatorSortKeyList class is created by QCollator::sortKeys(). It
+    stores the sort keys of all the strings in a single block of memory, and
+    is used to sort many strings, or to compare them repeatedly, without
+    collating them again. Keys are identified by the index of their string,
+    and can only be compared with keys of the same list.
+
+    \reentrant
+    \ingroup i18n
+    \ingroup string-processing
+    \ingroup shared
+
+    \sa QCollator::sortKeys(), QCollator::sort(), QCollatorSortKey
+*/
+
+/*!
+    Constructs an empty list of sort keys.
+*/
+QCollatorSortKeyList::QCollatorSortKeyList()
+{
+}
+
+/*!
+    \internal
+*/
+QCollatorSortKeyList::QCollatorSortKeyList(QCollatorSortKeyListPrivate *d)
+    : d(d)
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QCollatorSortKeyList::QCollatorSortKeyList(const QCollatorSortKeyList &other)
+    : d(other.d)
+{
+}
+
+/*!
+    Destroys the list.
+*/
+QCollatorSortKeyList::~QCollatorSortKeyList()
+{
+}
+
+/*!
+    Assigns \a other to this list.
+*/
+QCollatorSortKeyList &QCollatorSortKeyList::operator=(const QCollatorSortKeyList &other)
+{
+    d = other.d;
+    return *this;
+}
+
+/*!
+    \fn QCollatorSortKeyList &QCollatorSortKeyList::operator=(QCollatorSortKeyList &&other)
+
+    Move-assigns \a other to this list.
+*/
+
+/*!
+    \fn void QCollatorSortKeyList::swap(QCollatorSortKeyList &other)
+
+    Swaps this list with \a other.
+*/
+
+/*!
+    Returns the number of keys in the list.
+
+    \sa isEmpty()
+*/
+qsizetype QCollatorSortKeyList::size() const
+{
+    return d ? d->offsets.size() - 1 : 0;
+}
+
+/*!
+    \fn bool QCollatorSortKeyList::isEmpty() const
+
+    Returns \c true if the list holds no keys.
+
+    \sa size()
+*/
+
+/*!
+    Compares the key at index \a i with the key at index \a j.
+
+    Returns a negative value if the string at index \a i sorts before the one
+    at index \a j, 0 if they sort equally, or a positive value if it sorts
+    after it. Both indexes must be valid indexes in the list.
+*/
+int QCollatorSortKeyList::compare(qsizetype i, qsizetype j) const
+{
+    Q_ASSERT(i >= 0 && i < size());
+    Q_ASSERT(j >= 0 && j < size());
+    const qsizetype *offsets = d->offsets.constData();
+    const CollatorKeyUnit *keys = d->keys.constData();
+    return QCollatorPrivate::compareSortKeys(keys + offsets[i], offsets[i + 1] - offsets[i],
+                                             keys + offsets[j], offsets[j + 1] - offsets[j]);
+}
+
 QT_END_NAMESPACE
@@ -49,6 +49,7 @@ QT_BEGIN_NAMESPACE
 
 class QCollatorPrivate;
 class QCollatorSortKeyPrivate;
+class QCollatorSortKeyListPrivate;
 
 class Q_CORE_EXPORT QCollatorSortKey
 {
@@ -77,6 +78,29 @@ inline bool operator<(const QCollatorSortKey &lhs, const QCollatorSortKey &rhs)
     return lhs.compare(rhs) < 0;
 }
 
+class Q_CORE_EXPORT QCollatorSortKeyList
+{
+    friend class QCollator;
+public:
+    QCollatorSortKeyList();
+    QCollatorSortKeyList(const QCollatorSortKeyList &other);
+    ~QCollatorSortKeyList();
+    QCollatorSortKeyList &operator=(const QCollatorSortKeyList &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QCollatorSortKeyList)
+    void swap(QCollatorSortKeyList &other) noexcept
+    { d.swap(other.d); }
+
+    qsizetype size() const;
+    bool isEmpty() const { return size() == 0; }
+
+    int compare(qsizetype i, qsizetype j) const;
+
+private:
+    QCollatorSortKeyList(QCollatorSortKeyListPrivate *);
+
+    QExplicitlySharedDataPointer<QCollatorSortKeyListPrivate> d;
+};
+
 class Q_CORE_EXPORT QCollator
 {
 public:
@@ -117,6 +141,9 @@ public:
     { return compare(s1, s2) < 0; }
 
     QCollatorSortKey sortKey(const QString &string) const;
+    QCollatorSortKeyList sortKeys(const QStringList &strings) const;
+
+    void sort(QStringList &strings) const;
 
 private:
     QCollatorPrivate *d;
@@ -125,6 +152,7 @@ private:
 };
 
 Q_DECLARE_SHARED(QCollatorSortKey)
+Q_DECLARE_SHARED(QCollatorSortKeyList)
 Q_DECLARE_SHARED(QCollator)
 
 QT_END_NAMESPACE
@@ -47,6 +47,7 @@
 #include <unicode/ucol.h>
 #include <unicode/ustring.h>
 #include <unicode/ures.h>
+#include <unicode/uset.h>
 
 #include "qdebug.h"
 
@@ -97,14 +98,155 @@ void QCollatorPrivate::init()
     if (U_FAILURE(status))
         qWarning("ucol_setAttribute: Alternate handling failed: %d", status);
 
+    initAsciiFastPath();
+
     dirty = false;
 }
 
+/*
+    In the root collation order, every ASCII character maps to a single
+    collation element, whose secondary weight is the common one, or is
+    completely ignorable (the control characters). Two ASCII-only strings
+    therefore compare by the primary weights of their characters, then, if
+    the strength includes it, by their tertiary weights (i.e. case).
+
+    initAsciiFastPath() checks that the collator's tailoring and attributes
+    keep that property, and if so extracts the rank of each ASCII character
+    at each of those levels from ICU's own sort keys. compareAscii() then
+    compares ASCII-only strings without calling ICU at all.
+*/
+void QCollatorPrivate::initAsciiFastPath()
+{
+    asciiFastPath = false;
+
+    UErrorCode status = U_ZERO_ERROR;
+    const UColAttributeValue strength = ucol_getAttribute(collator, UCOL_STRENGTH, &status);
+    if (U_FAILURE(status) || strength == UCOL_IDENTICAL
+            || ucol_getAttribute(collator, UCOL_CASE_FIRST, &status) != UCOL_OFF
+            || ucol_getAttribute(collator, UCOL_CASE_LEVEL, &status) != UCOL_OFF
+            || ucol_getAttribute(collator, UCOL_ALTERNATE_HANDLING, &status) != UCOL_NON_IGNORABLE
+            || ucol_getAttribute(collator, UCOL_NUMERIC_COLLATION, &status) != UCOL_OFF
+            || U_FAILURE(status)) {
+        return;
+    }
+
+    // the tailoring must not touch ASCII, neither as single characters nor
+    // as the start of a contraction
+    USet *tailored = ucol_getTailoredSet(collator, &status);
+    if (U_FAILURE(status))
+        return;
+    USet *ascii = uset_open(0, 0x7f);
+    bool tailorsAscii = uset_containsSome(tailored, ascii);
+    for (int32_t i = 0, count = uset_getItemCount(tailored); i < count && !tailorsAscii; ++i) {
+        UChar32 start, end;
+        UChar string[16];
+        status = U_ZERO_ERROR;
+        const int32_t length = uset_getItem(tailored, i, &start, &end, string, 16, &status);
+        if (U_FAILURE(status) || (length > 0 && string[0] < 0x80))
+            tailorsAscii = true;
+    }
+    uset_close(ascii);
+    uset_close(tailored);
+    if (tailorsAscii)
+        return;
+
+    // split the sort key of each character into its levels
+    // (sort keys are "level 1 \x01 level 2 \x01 ... \x00")
+    QByteArray levels[128][4];
+    for (int c = 0; c < 128; ++c) {
+        const UChar ch = UChar(c);
+        uint8_t key[64];
+        const int32_t length = ucol_getSortKey(collator, &ch, 1, key, sizeof(key));
+        if (length <= 0 || length > int32_t(sizeof(key)) || key[length - 1] != 0)
+            return;
+        int level = 0;
+        for (int32_t i = 0; i < length - 1; ++i) {
+            if (key[i] == 1) {
+                if (++level == 4)
+                    return;
+            } else {
+                levels[c][level] += char(key[i]);
+            }
+        }
+    }
+
+    // all the characters must share the same secondary and quaternary
+    // weights, unless they are completely ignorable
+    const QByteArray *reference = nullptr;
+    for (int c = 0; c < 128; ++c) {
+        const QByteArray *l = levels[c];
+        if (l[0].isEmpty()) {
+            if (!l[1].isEmpty() || !l[2].isEmpty() || !l[3].isEmpty())
+                return;
+            continue;
+        }
+        if (!reference)
+            reference = l;
+        else if (l[1] != reference[1] || l[3] != reference[3])
+            return;
+    }
+
+    // rank the primary and tertiary weights; 0 means ignorable
+    const auto rank = [&levels](int level, uchar *ranks) {
+        QList<QByteArray> weights;
+        for (int c = 0; c < 128; ++c) {
+            if (!levels[c][0].isEmpty())
+                weights.append(levels[c][level]);
+        }
+        std::sort(weights.begin(), weights.end());
+        weights.erase(std::unique(weights.begin(), weights.end()), weights.end());
+        if (weights.size() > 250)
+            return false;
+        for (int c = 0; c < 128; ++c) {
+            ranks[c] = levels[c][0].isEmpty()
+                    ? 0 : uchar(2 + (std::lower_bound(weights.cbegin(), weights.cend(), levels[c][level])
+                                     - weights.cbegin()));
+        }
+        return true;
+    };
+    asciiTertiaryLevel = strength >= UCOL_TERTIARY;
+    if (!rank(0, asciiPrimary) || (asciiTertiaryLevel && !rank(2, asciiTertiary)))
+        return;
+
+    asciiFastPath = true;
+}
+
+/*!
+    \internal
+
+    Compares two ASCII-only strings, see initAsciiFastPath().
+*/
+int QCollatorPrivate::compareAscii(QStringView s1, QStringView s2) const
+{
+    const char16_t *p1 = s1.utf16();
+    const char16_t *p2 = s2.utf16();
+    const char16_t *end1 = p1 + s1.size();
+    const char16_t *end2 = p2 + s2.size();
+
+    const auto compareLevel = [&](const uchar *ranks) {
+        for (const char16_t *i1 = p1, *i2 = p2; ; ++i1, ++i2) {
+            while (i1 != end1 && !asciiPrimary[*i1])
+                ++i1;
+            while (i2 != end2 && !asciiPrimary[*i2])
+                ++i2;
+            if (i1 == end1 || i2 == end2)
+                return i1 == end1 ? (i2 == end2 ? 0 : -1) : 1;
+            if (ranks[*i1] != ranks[*i2])
+                return ranks[*i1] < ranks[*i2] ? -1 : 1;
+        }
+    };
+
+    if (int result = compareLevel(asciiPrimary))
+        return result;
+    return asciiTertiaryLevel ? compareLevel(asciiTertiary) : 0;
+}
+
 void QCollatorPrivate::cleanup()
 {
     if (collator)
         ucol_close(collator);
     collator = nullptr;
+    asciiFastPath = false;
 }
 
 int QCollator::compare(QStringView s1, QStringView s2) const
@@ -118,6 +260,8 @@ int QCollator::compare(QStringView s1, QStringView s2) const
         d->init();
 
     if (d->collator) {
+        if (d->asciiFastPath && QtPrivate::isAscii(s1) && QtPrivate::isAscii(s2))
+            return d->compareAscii(s1, s2);
         return ucol_strcoll(d->collator,
                             reinterpret_cast<const UChar *>(s1.data()), s1.size(),
                             reinterpret_cast<const UChar *>(s2.data()), s2.size());
@@ -128,27 +272,68 @@ int QCollator::compare(QStringView s1, QStringView s2) const
                                    d->caseSensitivity);
 }
 
-QCollatorSortKey QCollator::sortKey(const QString &string) const
+void QCollatorPrivate::appendSortKey(CollatorKeyType &keys, QStringView string, bool allAscii) const
 {
-    if (d->dirty)
-        d->init();
-    if (d->isC())
-        return QCollatorSortKey(new QCollatorSortKeyPrivate(string.toUtf8()));
+    if (isC()) {
+        keys += string.toUtf8();
+        return;
+    }
+    if (!collator)
+        return;
 
-    if (d->collator) {
-        QByteArray result(16 + string.size() + (string.size() >> 2), Qt::Uninitialized);
-        int size = ucol_getSortKey(d->collator, (const UChar *)string.constData(),
-                                   string.size(), (uint8_t *)result.data(), result.size());
-        if (size > result.size()) {
-            result.resize(size);
-            size = ucol_getSortKey(d->collator, (const UChar *)string.constData(),
-                                   string.size(), (uint8_t *)result.data(), result.size());
+    const qsizetype offset = keys.size();
+    if (allAscii && asciiFastPath) {
+        // the same order as compareAscii(): the primary ranks, then the
+        // tertiary ones, all of them >= 2
+        keys.resize(offset + 2 * string.size() + 2);
+        char *out = keys.data() + offset;
+        for (QChar c : string) {
+            if (const uchar r = asciiPrimary[c.unicode()])
+                *out++ = char(r);
         }
-        result.truncate(size);
-        return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(result)));
+        if (asciiTertiaryLevel) {
+            *out++ = 1;
+            for (QChar c : string) {
+                if (asciiPrimary[c.unicode()])
+                    *out++ = char(asciiTertiary[c.unicode()]);
+            }
+        }
+        *out++ = 0;
+        keys.resize(out - keys.constData());
+        return;
+    }
+
+    int capacity = int(16 + string.size() + (string.size() >> 2));
+    keys.resize(offset + capacity);
+    int size = ucol_getSortKey(collator, reinterpret_cast<const UChar *>(string.data()),
+                               string.size(), reinterpret_cast<uint8_t *>(keys.data() + offset),
+                               capacity);
+    if (size > capacity) {
+        capacity = size;
+        keys.resize(offset + capacity);
+        size = ucol_getSortKey(collator, reinterpret_cast<const UChar *>(string.data()),
+                               string.size(), reinterpret_cast<uint8_t *>(keys.data() + offset),
+                               capacity);
     }
+    keys.resize(offset + size);
+}
+
+int QCollatorPrivate::compareSortKeys(const char *key1, qsizetype len1,
+                                      const char *key2, qsizetype len2)
+{
+    if (const int result = memcmp(key1, key2, size_t(qMin(len1, len2))))
+        return result;
+    return len1 < len2 ? -1 : len1 > len2 ? 1 : 0;
+}
+
+QCollatorSortKey QCollator::sortKey(const QString &string) const
+{
+    if (d->dirty)
+        d->init();
 
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(QByteArray()));
+    QByteArray key;
+    d->appendSortKey(key, string, false);
+    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(key)));
 }
 
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
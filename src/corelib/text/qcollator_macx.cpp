@@ -116,6 +116,37 @@ int QCollator::compare(QStringView s1, QStringView s2) const
     return result < 0 ? -1 : 1;
 }
 
+void QCollatorPrivate::appendSortKey(CollatorKeyType &keys, QStringView string, bool allAscii) const
+{
+    Q_UNUSED(allAscii);
+    if (!collator)
+        return;
+
+    //Documentation recommends having it 5 times as big as the input
+    const qsizetype offset = keys.size();
+    keys.resize(offset + string.size() * 5);
+    ItemCount actualSize;
+    int status = UCGetCollationKey(collator,
+                                   reinterpret_cast<const UniChar *>(string.data()),
+                                   string.size(), string.size() * 5, &actualSize,
+                                   keys.data() + offset);
+
+    keys.resize(offset + actualSize + 1);
+    if (status == kUCOutputBufferTooSmall) {
+        UCGetCollationKey(collator, reinterpret_cast<const UniChar *>(string.data()),
+                          string.size(), actualSize + 1, &actualSize, keys.data() + offset);
+    }
+    keys[offset + actualSize] = 0;
+}
+
+int QCollatorPrivate::compareSortKeys(const UCCollationValue *key1, qsizetype len1,
+                                      const UCCollationValue *key2, qsizetype len2)
+{
+    SInt32 order;
+    UCCompareCollationKeys(key1, len1, key2, len2, 0, &order);
+    return order;
+}
+
 QCollatorSortKey QCollator::sortKey(const QString &string) const
 {
     if (d->dirty)
@@ -126,20 +157,9 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
         return QCollatorSortKey(nullptr);
     }
 
-    //Documentation recommends having it 5 times as big as the input
-    QList<UCCollationValue> ret(string.size() * 5);
-    ItemCount actualSize;
-    int status = UCGetCollationKey(d->collator,
-                                   reinterpret_cast<const UniChar *>(string.constData()),
-                                   string.count(), ret.size(), &actualSize, ret.data());
-
-    ret.resize(actualSize + 1);
-    if (status == kUCOutputBufferTooSmall) {
-        UCGetCollationKey(d->collator, reinterpret_cast<const UniChar *>(string.constData()),
-                          string.count(), ret.size(), &actualSize, ret.data());
-    }
-    ret[actualSize] = 0;
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(ret)));
+    QList<UCCollationValue> key;
+    d->appendSortKey(key, string, false);
+    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(key)));
 }
 
 int QCollatorSortKey::compare(const QCollatorSortKey &key) const
@@ -85,6 +85,7 @@ typedef QList<wchar_t> CollatorKeyType;
 typedef bool CollatorType;
 const CollatorType NoCollator = false;
 #endif
+typedef CollatorKeyType::value_type CollatorKeyUnit;
 
 class QCollatorPrivate
 {
@@ -107,7 +108,7 @@ public:
 
     QCollatorPrivate(const QLocale &locale) : locale(locale) {}
     ~QCollatorPrivate() { cleanup(); }
-    bool isC() { return locale.language() == QLocale::C; }
+    bool isC() const { return locale.language() == QLocale::C; }
 
     void clear() {
         cleanup();
@@ -117,6 +118,24 @@ public:
     // Implemented by each back-end, in its own way:
     void init();
     void cleanup();
+    // Appends the sort key of string to keys. If allAscii is true, the key
+    // will only ever be compared to keys of other ASCII-only strings, which
+    // allows back-ends to use a cheaper key format.
+    void appendSortKey(CollatorKeyType &keys, QStringView string, bool allAscii) const;
+    static int compareSortKeys(const CollatorKeyUnit *key1, qsizetype len1,
+                               const CollatorKeyUnit *key2, qsizetype len2);
+
+#if QT_CONFIG(icu)
+    // The order of ASCII-only strings, derived from the collator by init()
+    // when it can be computed without calling ICU; see qcollator_icu.cpp.
+    bool asciiFastPath = false;
+    bool asciiTertiaryLevel = false;
+    uchar asciiPrimary[128];
+    uchar asciiTertiary[128];
+
+    void initAsciiFastPath();
+    int compareAscii(QStringView s1, QStringView s2) const;
+#endif
 
 private:
     Q_DISABLE_COPY_MOVE(QCollatorPrivate)
@@ -139,6 +158,12 @@ private:
     Q_DISABLE_COPY_MOVE(QCollatorSortKeyPrivate)
 };
 
+class QCollatorSortKeyListPrivate : public QSharedData
+{
+public:
+    CollatorKeyType keys;       // all the keys, back to back
+    QList<qsizetype> offsets;   // start of each key, then the end of the last one
+};
 
 QT_END_NAMESPACE
 
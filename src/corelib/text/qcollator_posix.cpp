@@ -91,26 +91,47 @@ int QCollator::compare(QStringView s1, QStringView s2) const
     return std::wcscoll(array1.constData(), array2.constData());
 }
 
+void QCollatorPrivate::appendSortKey(CollatorKeyType &keys, QStringView string, bool allAscii) const
+{
+    Q_UNUSED(allAscii);
+    QVarLengthArray<wchar_t> original;
+    stringToWCharArray(original, string);
+
+    const qsizetype offset = keys.size();
+    if (isC()) {
+        keys.resize(offset + original.size());
+        std::copy(original.cbegin(), original.cend(), keys.begin() + offset);
+        return;
+    }
+
+    qsizetype capacity = original.size();
+    keys.resize(offset + capacity);
+    size_t size = std::wcsxfrm(keys.data() + offset, original.constData(), size_t(capacity));
+    if (size >= size_t(capacity)) {
+        capacity = qsizetype(size) + 1;
+        keys.resize(offset + capacity);
+        size = std::wcsxfrm(keys.data() + offset, original.constData(), size_t(capacity));
+    }
+    keys.resize(offset + qsizetype(size) + 1);
+    keys[offset + qsizetype(size)] = 0;
+}
+
+int QCollatorPrivate::compareSortKeys(const wchar_t *key1, qsizetype len1,
+                                      const wchar_t *key2, qsizetype len2)
+{
+    if (const int result = std::wmemcmp(key1, key2, size_t(qMin(len1, len2))))
+        return result;
+    return len1 < len2 ? -1 : len1 > len2 ? 1 : 0;
+}
+
 QCollatorSortKey QCollator::sortKey(const QString &string) const
 {
     if (d->dirty)
         d->init();
 
-    QVarLengthArray<wchar_t> original;
-    stringToWCharArray(original, string);
-    QList<wchar_t> result(original.size());
-    if (d->isC()) {
-        std::copy(original.cbegin(), original.cend(), result.begin());
-    } else {
-        size_t size = std::wcsxfrm(result.data(), original.constData(), string.size());
-        if (size > uint(result.size())) {
-            result.resize(size+1);
-            size = std::wcsxfrm(result.data(), original.constData(), string.size());
-        }
-        result.resize(size+1);
-        result[size] = 0;
-    }
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(result)));
+    QList<wchar_t> key;
+    d->appendSortKey(key, string, false);
+    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(key)));
 }
 
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
@@ -137,31 +137,33 @@ int QCollator::compare(QStringView s1, QStringView s2) const
     return 0;
 }
 
-QCollatorSortKey QCollator::sortKey(const QString &string) const
+void QCollatorPrivate::appendSortKey(CollatorKeyType &keys, QStringView string, bool allAscii) const
 {
-    if (d->dirty)
-        d->init();
-    if (d->isC())
-        return QCollatorSortKey(new QCollatorSortKeyPrivate(string));
+    Q_UNUSED(allAscii);
+    if (isC()) {
+        keys.append(string);
+        return;
+    }
 
 #ifndef USE_COMPARESTRINGEX
-    int size = LCMapStringW(d->localeID, LCMAP_SORTKEY | d->collator,
-                           reinterpret_cast<const wchar_t*>(string.constData()), string.size(),
+    int size = LCMapStringW(localeID, LCMAP_SORTKEY | collator,
+                           reinterpret_cast<const wchar_t*>(string.data()), string.size(),
                            0, 0);
 #else
-    int size = LCMapStringEx(LPCWSTR(d->localeName.utf16()), LCMAP_SORTKEY | d->collator,
-                           reinterpret_cast<LPCWSTR>(string.constData()), string.size(),
+    int size = LCMapStringEx(LPCWSTR(localeName.utf16()), LCMAP_SORTKEY | collator,
+                           reinterpret_cast<LPCWSTR>(string.data()), string.size(),
                            0, 0, NULL, NULL, 0);
 #endif
-    QString ret(size, Qt::Uninitialized);
+    const qsizetype offset = keys.size();
+    keys.resize(offset + size, QChar());
 #ifndef USE_COMPARESTRINGEX
-    int finalSize = LCMapStringW(d->localeID, LCMAP_SORTKEY | d->collator,
-                           reinterpret_cast<const wchar_t*>(string.constData()), string.size(),
-                           reinterpret_cast<wchar_t*>(ret.data()), ret.size());
+    int finalSize = LCMapStringW(localeID, LCMAP_SORTKEY | collator,
+                           reinterpret_cast<const wchar_t*>(string.data()), string.size(),
+                           reinterpret_cast<wchar_t*>(keys.data() + offset), size);
 #else
-    int finalSize = LCMapStringEx(LPCWSTR(d->localeName.utf16()), LCMAP_SORTKEY | d->collator,
-                           reinterpret_cast<LPCWSTR>(string.constData()), string.size(),
-                           reinterpret_cast<LPWSTR>(ret.data()), ret.size(),
+    int finalSize = LCMapStringEx(LPCWSTR(localeName.utf16()), LCMAP_SORTKEY | collator,
+                           reinterpret_cast<LPCWSTR>(string.data()), string.size(),
+                           reinterpret_cast<LPWSTR>(keys.data() + offset), size,
                            NULL, NULL, 0);
 #endif
     if (finalSize == 0) {
@@ -169,7 +171,22 @@ QCollatorSortKey QCollator::sortKey(const QString &string) const
             << "there were problems when generating the ::sortKey by LCMapStringW with error:"
             << GetLastError();
     }
-    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(ret)));
+}
+
+int QCollatorPrivate::compareSortKeys(const QChar *key1, qsizetype len1,
+                                      const QChar *key2, qsizetype len2)
+{
+    return QStringView(key1, len1).compare(QStringView(key2, len2));
+}
+
+QCollatorSortKey QCollator::sortKey(const QString &string) const
+{
+    if (d->dirty)
+        d->init();
+
+    QString key;
+    d->appendSortKey(key, string, false);
+    return QCollatorSortKey(new QCollatorSortKeyPrivate(std::move(key)));
 }
 
 int QCollatorSortKey::compare(const QCollatorSortKey &otherKey) const
@@ -3286,9 +3286,325 @@ QString QCalendarBackend::dateTimeToString(QStringView format, const QDateTime &
 
 // End of QCalendar intrustions
 
+// Space qt_doubleToAscii() needs for the digits of d
+static int doubleDigitsBufferSize(double d, QLocaleData::DoubleForm form, int precision)
+{
+    int bufSize = 1;
+    if (precision == QLocale::FloatingPointShortest)
+        bufSize += std::numeric_limits<double>::max_digits10;
+    else if (form == QLocaleData::DFDecimal)
+        bufSize += wholePartSpace(qAbs(d)) + precision;
+    else // Add extra digit due to different interpretations of precision. Also, "nan" has to fit.
+        bufSize += qMax(2, precision) + 1;
+    return bufSize;
+}
+
+/*
+    Decides between decimal and exponent form for DFSignificantDigits, given
+    the digitCount digits and decimal point position decpt of the number.
+    groupingBias is the number of grouping separators the decimal form would
+    get.
+*/
+static bool significantDigitsUseDecimal(int decpt, int digitCount, int precision,
+                                        bool mustMarkDecimal, int minExponentDigits,
+                                        int groupingBias)
+{
+    /* POSIX specifies sprintf() to follow fprintf(), whose 'g/G'
+       format says; with P = 6 if precision unspecified else 1 if
+       precision is 0 else precision; when 'e/E' would have exponent
+       X, use:
+         * 'f/F' if P > X >= -4, with precision P-1-X
+         * 'e/E' otherwise, with precision P-1
+       Helpfully, we already have mapped precision < 0 to 6 - except
+       for F.P.Shortest mode, which is its own story - and those of
+       our callers with unspecified precision either used 6 or -1
+       for it.
+    */
+    if (precision == QLocale::FloatingPointShortest) {
+        // Find out which representation is shorter.
+        // Set bias to everything added to exponent form but not
+        // decimal, minus the converse.
+
+        // Exponent adds separator, sign and digits:
+        int bias = 2 + minExponentDigits;
+        // Decimal form may get grouping separators inserted:
+        bias -= groupingBias;
+        // X = decpt - 1 needs two digits if decpt > 10:
+        if (decpt > 10 && minExponentDigits == 1)
+            ++bias;
+        // Assume digitCount < 95, so we can ignore the 3-digit
+        // exponent case (we'll set useDecimal false anyway).
+
+        if (!mustMarkDecimal) {
+            // Decimal separator is skipped if at end; adjust if
+            // that happens for only one form:
+            if (digitCount <= decpt && digitCount > 1)
+                ++bias; // decimal but not exponent
+            else if (digitCount == 1 && decpt <= 0)
+                --bias; // exponent but not decimal
+        }
+        // When 0 < decpt <= digitCount, the forms have equal digit
+        // counts, plus things bias has taken into account;
+        // otherwise decimal form's digit count is right-padded with
+        // zeros to decpt, when decpt is positive, otherwise it's
+        // left-padded with 1 - decpt zeros.
+        return decpt <= 0 ? 1 - decpt <= bias
+               : decpt <= digitCount ? 0 <= bias
+               : decpt <= digitCount + bias;
+    }
+
+    // X == decpt - 1, POSIX's P; -4 <= X < P iff -4 < decpt <= P
+    Q_ASSERT(precision >= 0);
+    return decpt > -4 && decpt <= (precision ? precision : 1);
+}
+
+/*
+    QCLocaleNumberFormatter: the C locale's digits, separators and signs are
+    all single ASCII characters, so the text of a number is fully described by
+    its digits, the position of the decimal separator and a few counts of
+    zeros. The layout mirrors doubleToString(), decimalForm(), exponentForm()
+    and applyIntegerFormatting() below.
+*/
+
+static char *ulltoaDecimal(char *end, qulonglong n)
+{
+    static const char digitPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    while (n >= 100) {
+        end -= 2;
+        memcpy(end, digitPairs + 2 * (n % 100), 2);
+        n /= 100;
+    }
+    if (n >= 10) {
+        end -= 2;
+        memcpy(end, digitPairs + 2 * n, 2);
+    } else {
+        *--end = char('0' + n);
+    }
+    return end;
+}
+
+static char cLocaleSign(bool negative, unsigned flags)
+{
+    if (negative)
+        return '-';
+    if (flags & QLocaleData::AlwaysShowSign)
+        return '+';
+    if (flags & QLocaleData::BlankBeforePositive)
+        return ' ';
+    return 0;
+}
+
+bool QCLocaleNumberFormatter::setInteger(qulonglong magnitude, bool negative, int precision,
+                                         int base, int width, unsigned flags)
+{
+    if (base != 10 || flags & QLocaleData::GroupDigits)
+        return false;
+
+    char buf[std::numeric_limits<qulonglong>::digits10 + 1];
+    char *const end = buf + sizeof buf;
+    const char *begin = ulltoaDecimal(end, magnitude);
+    m_digits.clear();
+    m_digits.append(begin, end - begin);
+
+    m_layout = Integer;
+    m_sign = cLocaleSign(negative, flags);
+    const int digitCount = int(end - begin);
+    const bool noPrecision = precision == -1;
+    if (noPrecision)
+        precision = 1;
+    m_padZeros = qMax(0, precision - digitCount);
+    const int usedWidth = (m_sign ? 1 : 0) + m_padZeros + digitCount;
+    if (noPrecision && flags & QLocaleData::ZeroPadded && !(flags & QLocaleData::LeftAdjusted))
+        m_padZeros += qMax(0, width - usedWidth);
+    m_size = (m_sign ? 1 : 0) + m_padZeros + digitCount;
+    return true;
+}
+
+bool QCLocaleNumberFormatter::setDouble(double d, int precision, QLocaleData::DoubleForm form,
+                                        int width, unsigned flags)
+{
+    if (flags & QLocaleData::GroupDigits)
+        return false;
+
+    if (precision != QLocale::FloatingPointShortest && precision < 0)
+        precision = 6;
+
+    const int bufSize = doubleDigitsBufferSize(d, form, precision);
+    m_digits.resize(bufSize);
+    int length;
+    int decpt;
+    bool negative = false;
+    qt_doubleToAscii(d, form, precision, m_digits.data(), bufSize, negative, length, decpt);
+    m_digits.resize(length);
+
+    m_sign = cLocaleSign(negative && !isZero(d), flags);
+    m_capital = flags & QLocaleData::CapitalEorX;
+    m_padZeros = 0;
+    m_trailingZeros = 0;
+    if (qt_is_inf(d) || qt_is_nan(d)) {
+        m_layout = Special;
+        m_size = (m_sign ? 1 : 0) + length;
+        return true;
+    }
+
+    enum { DecimalDigits, SignificantDigits, ChopTrailingZeros } mode = DecimalDigits;
+    const bool mustMarkDecimal = flags & QLocaleData::ForcePoint;
+    const int minExponentDigits = flags & QLocaleData::ZeroPadExponent ? 2 : 1;
+    switch (form) {
+    case QLocaleData::DFExponent:
+        m_layout = Exponent;
+        break;
+    case QLocaleData::DFDecimal:
+        m_layout = Decimal;
+        break;
+    case QLocaleData::DFSignificantDigits:
+        mode = flags & QLocaleData::AddTrailingZeroes ? SignificantDigits : ChopTrailingZeros;
+        m_layout = significantDigitsUseDecimal(decpt, length, precision, mustMarkDecimal,
+                                               minExponentDigits, 0) ? Decimal : Exponent;
+        break;
+    }
+
+    int bodySize;
+    if (m_layout == Decimal) {
+        m_fractionZeros = decpt < 0 ? -decpt : 0;
+        m_pointAt = qMax(decpt, 0);
+        int digitCount = m_fractionZeros + length;
+        if (m_pointAt > digitCount)
+            m_trailingZeros = m_pointAt - digitCount;
+        digitCount += m_trailingZeros;
+        int padding = 0;
+        if (mode == DecimalDigits)
+            padding = precision - (digitCount - m_pointAt);
+        else if (mode == SignificantDigits)
+            padding = precision - digitCount;
+        if (padding > 0) {
+            m_trailingZeros += padding;
+            digitCount += padding;
+        }
+        m_point = mustMarkDecimal || m_pointAt < digitCount;
+        bodySize = (m_pointAt == 0 ? 1 : 0) + digitCount + (m_point ? 1 : 0);
+    } else {
+        int padding = 0;
+        if (mode == DecimalDigits)
+            padding = precision + 1 - length;
+        else if (mode == SignificantDigits)
+            padding = precision - length;
+        m_trailingZeros = qMax(0, padding);
+        const int digitCount = length + m_trailingZeros;
+        m_point = mustMarkDecimal || digitCount > 1;
+
+        m_exponent = decpt - 1;
+        m_exponentDigits = 1;
+        for (uint e = qAbs(m_exponent); e >= 10; e /= 10)
+            ++m_exponentDigits;
+        m_exponentDigits = qMax(m_exponentDigits, minExponentDigits);
+        bodySize = digitCount + (m_point ? 1 : 0) + 2 + m_exponentDigits;
+    }
+
+    // LeftAdjusted overrides ZeroPadded
+    const int usedWidth = (m_sign ? 1 : 0) + bodySize;
+    if (flags & QLocaleData::ZeroPadded && !(flags & QLocaleData::LeftAdjusted))
+        m_padZeros = qMax(0, width - usedWidth);
+    m_size = usedWidth + m_padZeros;
+    return true;
+}
+
+template <typename Char>
+static Char *writeZeros(Char *out, qsizetype count)
+{
+    return std::fill_n(out, count, Char('0'));
+}
+
+template <typename Char>
+static Char *writeDigits(Char *out, const char *digits, qsizetype count)
+{
+    return std::copy(digits, digits + count, out);
+}
+
+template <typename Char>
+Char *QCLocaleNumberFormatter::writeText(Char *out) const noexcept
+{
+    const char *const digits = m_digits.constData();
+    const qsizetype length = m_digits.size();
+
+    if (m_sign)
+        *out++ = Char(m_sign);
+    out = writeZeros(out, m_padZeros);
+
+    switch (m_layout) {
+    case Special:
+        for (qsizetype i = 0; i < length; ++i) // "inf" or "nan"
+            *out++ = Char(m_capital ? digits[i] - 'a' + 'A' : digits[i]);
+        return out;
+    case Integer:
+        return writeDigits(out, digits, length);
+    case Decimal: {
+        if (m_pointAt == 0) {
+            *out++ = Char('0');
+            if (m_point)
+                *out++ = Char('.');
+            out = writeZeros(out, m_fractionZeros);
+            out = writeDigits(out, digits, length);
+            return writeZeros(out, m_trailingZeros);
+        }
+        const qsizetype integralDigits = qMin<qsizetype>(m_pointAt, length);
+        const qsizetype integralZeros = m_pointAt - integralDigits;
+        out = writeDigits(out, digits, integralDigits);
+        out = writeZeros(out, integralZeros);
+        if (m_point)
+            *out++ = Char('.');
+        out = writeDigits(out, digits + integralDigits, length - integralDigits);
+        return writeZeros(out, m_trailingZeros - integralZeros);
+    }
+    case Exponent: {
+        const qsizetype integralDigits = qMin<qsizetype>(1, length);
+        out = writeDigits(out, digits, integralDigits);
+        if (m_point)
+            *out++ = Char('.');
+        out = writeDigits(out, digits + integralDigits, length - integralDigits);
+        out = writeZeros(out, m_trailingZeros);
+        *out++ = Char(m_capital ? 'E' : 'e');
+        *out++ = Char(m_exponent < 0 ? '-' : '+');
+        Char *const end = out + m_exponentDigits;
+        uint e = qAbs(m_exponent);
+        for (Char *p = end; p != out; e /= 10)
+            *--p = Char('0' + e % 10);
+        return end;
+    }
+    }
+    Q_UNREACHABLE();
+    return out;
+}
+
+char *QCLocaleNumberFormatter::write(char *out) const noexcept
+{
+    return writeText(out);
+}
+
+char16_t *QCLocaleNumberFormatter::write(char16_t *out) const noexcept
+{
+    return writeText(out);
+}
+
+static QString toQString(const QCLocaleNumberFormatter &formatter)
+{
+    QString result(formatter.size(), Qt::Uninitialized);
+    formatter.write(reinterpret_cast<char16_t *>(result.data()));
+    return result;
+}
+
 QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
                                     int width, unsigned flags) const
 {
+    if (this == c()) {
+        QCLocaleNumberFormatter formatter;
+        if (formatter.setDouble(d, precision, form, width, flags))
+            return toQString(formatter);
+    }
+
     // Undocumented: aside from F.P.Shortest, precision < 0 is treated as
     // default, 6 - same as printf().
     if (precision != QLocale::FloatingPointShortest && precision < 0)
@@ -3297,14 +3613,7 @@ QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
         width = 0;
 
     int decpt;
-    int bufSize = 1;
-    if (precision == QLocale::FloatingPointShortest)
-        bufSize += std::numeric_limits<double>::max_digits10;
-    else if (form == DFDecimal)
-        bufSize += wholePartSpace(qAbs(d)) + precision;
-    else // Add extra digit due to different interpretations of precision. Also, "nan" has to fit.
-        bufSize += qMax(2, precision) + 1;
-
+    const int bufSize = doubleDigitsBufferSize(d, form, precision);
     QVarLengthArray<char> buf(bufSize);
     int length;
     bool negative = false;
@@ -3357,56 +3666,12 @@ QString QLocaleData::doubleToString(double d, int precision, DoubleForm form,
                 PrecisionMode mode = (flags & AddTrailingZeroes) ?
                             PMSignificantDigits : PMChopTrailingZeros;
 
-                /* POSIX specifies sprintf() to follow fprintf(), whose 'g/G'
-                   format says; with P = 6 if precision unspecified else 1 if
-                   precision is 0 else precision; when 'e/E' would have exponent
-                   X, use:
-                     * 'f/F' if P > X >= -4, with precision P-1-X
-                     * 'e/E' otherwise, with precision P-1
-                   Helpfully, we already have mapped precision < 0 to 6 - except
-                   for F.P.Shortest mode, which is its own story - and those of
-                   our callers with unspecified precision either used 6 or -1
-                   for it.
-                */
-                bool useDecimal;
-                if (precision == QLocale::FloatingPointShortest) {
-                    // Find out which representation is shorter.
-                    // Set bias to everything added to exponent form but not
-                    // decimal, minus the converse.
-
-                    // Exponent adds separator, sign and digits:
-                    int bias = 2 + minExponentDigits;
-                    // Decimal form may get grouping separators inserted:
-                    if (groupDigits && decpt >= m_grouping_top + m_grouping_least)
-                        bias -= (decpt - m_grouping_top - m_grouping_least) / m_grouping_higher + 1;
-                    // X = decpt - 1 needs two digits if decpt > 10:
-                    if (decpt > 10 && minExponentDigits == 1)
-                        ++bias;
-                    // Assume digitCount < 95, so we can ignore the 3-digit
-                    // exponent case (we'll set useDecimal false anyway).
-
-                    const int digitCount = digits.length() / zero.size();
-                    if (!mustMarkDecimal) {
-                        // Decimal separator is skipped if at end; adjust if
-                        // that happens for only one form:
-                        if (digitCount <= decpt && digitCount > 1)
-                            ++bias; // decimal but not exponent
-                        else if (digitCount == 1 && decpt <= 0)
-                            --bias; // exponent but not decimal
-                    }
-                    // When 0 < decpt <= digitCount, the forms have equal digit
-                    // counts, plus things bias has taken into account;
-                    // otherwise decimal form's digit count is right-padded with
-                    // zeros to decpt, when decpt is positive, otherwise it's
-                    // left-padded with 1 - decpt zeros.
-                    useDecimal = (decpt <= 0 ? 1 - decpt <= bias
-                                  : decpt <= digitCount ? 0 <= bias
-                                  : decpt <= digitCount + bias);
-                } else {
-                    // X == decpt - 1, POSIX's P; -4 <= X < P iff -4 < decpt <= P
-                    Q_ASSERT(precision >= 0);
-                    useDecimal = decpt > -4 && decpt <= (precision ? precision : 1);
-                }
+                int groupingBias = 0;
+                if (groupDigits && decpt >= m_grouping_top + m_grouping_least)
+                    groupingBias = (decpt - m_grouping_top - m_grouping_least) / m_grouping_higher + 1;
+                const bool useDecimal =
+                        significantDigitsUseDecimal(decpt, digits.length() / zero.size(), precision,
+                                                    mustMarkDecimal, minExponentDigits, groupingBias);
 
                 numStr = useDecimal
                     ? decimalForm(std::move(digits), decpt, precision, mode,
@@ -3540,15 +3805,30 @@ QT_WARNING_DISABLE_MSVC(4146)
       Negating std::numeric_limits<qlonglong>::min() hits undefined behavior, so
       taking an absolute value has to cast to unsigned to change sign.
      */
-    QString numStr = qulltoa(negative ? -qulonglong(l) : qulonglong(l), base, zeroDigit());
+    const qulonglong magnitude = negative ? -qulonglong(l) : qulonglong(l);
 QT_WARNING_POP
 
+    // qulltoa() gives no digits for zero, only a precision pads it to "0"
+    if (this == c() && (magnitude || precision == -1 || precision > 0)) {
+        QCLocaleNumberFormatter formatter;
+        if (formatter.setInteger(magnitude, negative, precision, base, width, flags))
+            return toQString(formatter);
+    }
+
+    QString numStr = qulltoa(magnitude, base, zeroDigit());
+
     return applyIntegerFormatting(std::move(numStr), negative, precision, base, width, flags);
 }
 
 QString QLocaleData::unsLongLongToString(qulonglong l, int precision,
                                          int base, int width, unsigned flags) const
 {
+    if (this == c()) {
+        QCLocaleNumberFormatter formatter;
+        if (formatter.setInteger(l, false, precision, base, width, flags))
+            return toQString(formatter);
+    }
+
     const QString zero = zeroDigit();
     QString resultZero = base == 10 ? zero : QStringLiteral("0");
     return applyIntegerFormatting(l ? qulltoa(l, base, zero) : resultZero,
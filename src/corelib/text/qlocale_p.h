@@ -378,6 +378,46 @@ public:
     quint8 m_grouping_least : 3; // Number of digits after last grouping separator (before decimal).
 };
 
+/*
+    Lays out a number the way QLocaleData::c() formats it and writes it
+    straight into a caller-provided buffer, skipping the intermediate strings
+    of the generic code. The set functions return false for options only the
+    generic code handles (digit grouping, bases other than 10); size() is
+    then meaningless.
+*/
+class QCLocaleNumberFormatter
+{
+public:
+    bool setDouble(double d, int precision = -1,
+                   QLocaleData::DoubleForm form = QLocaleData::DFSignificantDigits,
+                   int width = -1, unsigned flags = QLocaleData::NoFlags);
+    bool setInteger(qulonglong magnitude, bool negative, int precision = -1, int base = 10,
+                    int width = -1, unsigned flags = QLocaleData::NoFlags);
+
+    qsizetype size() const noexcept { return m_size; }
+    // both return the end of the text written
+    char *write(char *out) const noexcept;
+    char16_t *write(char16_t *out) const noexcept;
+
+private:
+    template <typename Char> Char *writeText(Char *out) const noexcept;
+
+    enum Layout : uchar { Special, Integer, Decimal, Exponent };
+
+    QVarLengthArray<char, 32> m_digits;
+    qsizetype m_size = 0;
+    int m_padZeros = 0;      // between the sign and the number
+    int m_pointAt = 0;       // Decimal: digits before the separator
+    int m_fractionZeros = 0; // Decimal: zeros between the separator and the digits
+    int m_trailingZeros = 0; // zeros after the digits, on either side of the separator
+    int m_exponent = 0;
+    int m_exponentDigits = 0;
+    Layout m_layout = Integer;
+    char m_sign = 0;
+    bool m_point = false;
+    bool m_capital = false;
+};
+
 class Q_CORE_EXPORT QLocalePrivate // A POD type
 {
 public:
@@ -50,7 +50,17 @@
 #include <QtCore/qthreadstorage.h>
 #include <QtCore/qglobal.h>
 #include <QtCore/qatomic.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qcryptographichash.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qsysinfo.h>
+#include <QtCore/qvarlengtharray.h>
 
 #define PCRE2_CODE_UNIT_WIDTH 16
 
@@ -428,6 +438,22 @@ QT_BEGIN_NAMESPACE
     its \l{QRegularExpressionMatch::}{isValid()} function will return false).
     The same applies for attempting a global match.
 
+    \section1 Caching Compiled Patterns
+
+    A QRegularExpression compiles its pattern the first time it is used. An
+    application that uses many regular expressions can spend a noticeable
+    amount of its startup time doing so. To avoid that, the compiled form of
+    the patterns can be stored in a cache file and reused by later runs of
+    the application:
+
+    \snippet code/src_corelib_text_qregularexpression.cpp 36
+
+    loadCompiledPatternCache() enables the cache for the whole process; from
+    then on, patterns found in the cache are not compiled again, and the
+    other ones are added to the cache as they get compiled.
+    saveCompiledPatternCache() writes the cache back to disk. The cache file
+    can also be shipped with the application, for instance as a resource.
+
     \section1 Unsupported Perl-compatible Regular Expressions Features
 
     QRegularExpression does not support all the features available in
@@ -881,6 +907,291 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
     usingCrLfNewlines = false;
 }
 
+/*
+    Process-wide cache of compiled patterns, keyed by pattern and pattern
+    options, that can be saved to and loaded from a file so that the
+    patterns do not need to be compiled again when the application restarts.
+
+    The cache stores patterns as compiled by pcre2_compile_16, without any
+    JIT data (which cannot be serialized). It is only used once enabled by
+    QRegularExpression::loadCompiledPatternCache().
+
+    The cache is bounded by the size of the compiled code it holds; when it
+    is full, the least recently used patterns are dropped.
+*/
+static QBasicAtomicInt compiledPatternCacheEnabled = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+struct QRegularExpressionCacheKey
+{
+    QString pattern;
+    QRegularExpression::PatternOptions patternOptions;
+
+    friend bool operator==(const QRegularExpressionCacheKey &lhs, const QRegularExpressionCacheKey &rhs) noexcept
+    {
+        return lhs.patternOptions == rhs.patternOptions && lhs.pattern == rhs.pattern;
+    }
+    friend size_t qHash(const QRegularExpressionCacheKey &key, size_t seed = 0) noexcept
+    {
+        return qHashMulti(seed, key.pattern, int(key.patternOptions));
+    }
+};
+
+struct QRegularExpressionCachedCode
+{
+    Q_DISABLE_COPY_MOVE(QRegularExpressionCachedCode)
+
+    explicit QRegularExpressionCachedCode(pcre2_code_16 *code) noexcept : code(code) {}
+    ~QRegularExpressionCachedCode() { pcre2_code_free_16(code); }
+
+    pcre2_code_16 *code;
+};
+
+class QRegularExpressionCompiledPatternCache
+{
+    Q_DISABLE_COPY_MOVE(QRegularExpressionCompiledPatternCache)
+
+public:
+    // in bytes of compiled code and patterns
+    enum { MaxCost = 4 * 1024 * 1024 };
+
+    QRegularExpressionCompiledPatternCache() : codes(MaxCost) {}
+
+    pcre2_code_16 *lookup(const QString &pattern, QRegularExpression::PatternOptions patternOptions);
+    void insert(const QString &pattern, QRegularExpression::PatternOptions patternOptions,
+                const pcre2_code_16 *code);
+
+    bool load(const QString &fileName);
+    bool save(const QString &fileName);
+    void clear();
+
+private:
+    void insertLocked(const QRegularExpressionCacheKey &key, pcre2_code_16 *code);
+
+    QMutex mutex;
+    QCache<QRegularExpressionCacheKey, QRegularExpressionCachedCode> codes;
+};
+
+Q_GLOBAL_STATIC(QRegularExpressionCompiledPatternCache, compiledPatternCache)
+
+// Bump whenever the layout of the file changes. PCRE2's own serialized
+// data carries a separate check of the PCRE2 version and configuration.
+static const quint32 compiledPatternCacheMagic = 0x51524543; // "QREC"
+static const quint32 compiledPatternCacheVersion = 2;
+
+// Detects damaged files; hashes the two parts without copying them together.
+static QByteArray compiledPatternCacheDigest(const QByteArray &table, const QByteArray &serialized)
+{
+    QCryptographicHash hash(QCryptographicHash::Blake3_256);
+    hash.addData(table);
+    hash.addData(serialized);
+    return hash.result();
+}
+
+/*!
+    \internal
+
+    Returns a copy of the cached compiled code for \a pattern with
+    \a patternOptions, which the caller owns, or \nullptr if there is none.
+
+    The codes decoded from a file share their character tables, whose
+    reference count is not atomic and is only safe to update under the
+    mutex. The copy therefore gets tables of its own, so that it can be
+    freed on any thread.
+*/
+pcre2_code_16 *QRegularExpressionCompiledPatternCache::lookup(const QString &pattern,
+                                                             QRegularExpression::PatternOptions patternOptions)
+{
+    const QMutexLocker lock(&mutex);
+    const QRegularExpressionCachedCode *cached = codes.object({ pattern, patternOptions });
+    return cached ? pcre2_code_copy_with_tables_16(cached->code) : nullptr;
+}
+
+/*!
+    \internal
+
+    Adds a copy of \a code, compiled from \a pattern with \a patternOptions,
+    to the cache.
+*/
+void QRegularExpressionCompiledPatternCache::insert(const QString &pattern,
+                                                    QRegularExpression::PatternOptions patternOptions,
+                                                    const pcre2_code_16 *code)
+{
+    const QRegularExpressionCacheKey key = { pattern, patternOptions };
+    const QMutexLocker lock(&mutex);
+    if (!codes.contains(key))
+        insertLocked(key, pcre2_code_copy_16(code));
+}
+
+/*!
+    \internal
+
+    Adds \a code, which the cache takes ownership of, under \a key, dropping
+    the least recently used patterns if the cache gets too large. Must be
+    called with the mutex locked.
+*/
+void QRegularExpressionCompiledPatternCache::insertLocked(const QRegularExpressionCacheKey &key,
+                                                          pcre2_code_16 *code)
+{
+    if (!code)
+        return;
+    size_t codeSize = 0;
+    pcre2_pattern_info_16(code, PCRE2_INFO_SIZE, &codeSize);
+    const qsizetype cost = qsizetype(codeSize) + key.pattern.size() * qsizetype(sizeof(QChar));
+    // frees the code if it alone exceeds the budget
+    codes.insert(key, new QRegularExpressionCachedCode(code), cost);
+}
+
+/*!
+    \internal
+
+    Adds the patterns stored in \a fileName to the cache. Returns \c false
+    if the file cannot be read, or was written by an incompatible version
+    of Qt or PCRE2.
+*/
+bool QRegularExpressionCompiledPatternCache::load(const QString &fileName)
+{
+#ifndef QT_NO_DATASTREAM
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    quint32 magic, version, pcreMajor, pcreMinor;
+    quint8 pointerSize, byteOrder;
+    in >> magic >> version >> pcreMajor >> pcreMinor >> pointerSize >> byteOrder;
+    if (in.status() != QDataStream::Ok
+            || magic != compiledPatternCacheMagic
+            || version != compiledPatternCacheVersion
+            || pcreMajor != PCRE2_MAJOR
+            || pcreMinor != PCRE2_MINOR
+            || pointerSize != sizeof(void *)
+            || byteOrder != QSysInfo::ByteOrder) {
+        return false;
+    }
+
+    // the digest covers both the table of keys and the compiled code
+    QByteArray table, serialized, digest;
+    in >> table >> serialized >> digest;
+    if (in.status() != QDataStream::Ok || digest != compiledPatternCacheDigest(table, serialized))
+        return false;
+
+    QDataStream tableIn(table);
+    tableIn.setVersion(QDataStream::Qt_6_0);
+    quint32 count;
+    tableIn >> count;
+    QList<QRegularExpressionCacheKey> keys;
+    for (quint32 i = 0; i < count && tableIn.status() == QDataStream::Ok; ++i) {
+        QString pattern;
+        quint32 patternOptions;
+        tableIn >> pattern >> patternOptions;
+        keys.append({ pattern, QRegularExpression::PatternOptions(patternOptions) });
+    }
+    if (tableIn.status() != QDataStream::Ok || !tableIn.atEnd())
+        return false;
+    if (count == 0)
+        return true;
+
+    // pcre2_serialize_decode_16 trusts its input; the checks above make
+    // sure that we are at least reading back what we wrote
+    const auto bytes = reinterpret_cast<const uint8_t *>(serialized.constData());
+    if (pcre2_serialize_get_number_of_codes_16(bytes) != int(count))
+        return false;
+
+    QList<pcre2_code_16 *> decoded(count, nullptr);
+    if (pcre2_serialize_decode_16(decoded.data(), int(count), bytes, nullptr) != int(count))
+        return false;
+
+    const QMutexLocker lock(&mutex);
+    for (quint32 i = 0; i < count; ++i) {
+        if (codes.contains(keys.at(i)))
+            pcre2_code_free_16(decoded.at(i));
+        else
+            insertLocked(keys.at(i), decoded.at(i));
+    }
+    return true;
+#else
+    Q_UNUSED(fileName);
+    return false;
+#endif
+}
+
+/*!
+    \internal
+
+    Writes all the patterns in the cache to \a fileName.
+*/
+bool QRegularExpressionCompiledPatternCache::save(const QString &fileName)
+{
+#ifndef QT_NO_DATASTREAM
+    QList<QRegularExpressionCacheKey> keys;
+    QByteArray serialized;
+    {
+        const QMutexLocker lock(&mutex);
+        keys = codes.keys();
+        QList<const pcre2_code_16 *> list;
+        list.reserve(keys.size());
+        for (const QRegularExpressionCacheKey &key : qAsConst(keys))
+            list.append(codes.object(key)->code);
+
+        if (!list.isEmpty()) {
+            uint8_t *bytes;
+            PCRE2_SIZE size;
+            if (pcre2_serialize_encode_16(list.data(), int(list.size()), &bytes, &size, nullptr) < 0)
+                return false;
+            serialized = QByteArray(reinterpret_cast<const char *>(bytes), qsizetype(size));
+            pcre2_serialize_free_16(bytes);
+        }
+    }
+
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+#if QT_CONFIG(temporaryfile)
+    QSaveFile file(fileName);
+#else
+    QFile file(fileName);
+#endif
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << compiledPatternCacheMagic << compiledPatternCacheVersion
+        << quint32(PCRE2_MAJOR) << quint32(PCRE2_MINOR)
+        << quint8(sizeof(void *)) << quint8(QSysInfo::ByteOrder);
+
+    QByteArray table;
+    {
+        QDataStream tableOut(&table, QIODevice::WriteOnly);
+        tableOut.setVersion(QDataStream::Qt_6_0);
+        tableOut << quint32(keys.size());
+        for (const QRegularExpressionCacheKey &key : qAsConst(keys))
+            tableOut << key.pattern << quint32(int(key.patternOptions));
+    }
+    out << table << serialized << compiledPatternCacheDigest(table, serialized);
+
+#if QT_CONFIG(temporaryfile)
+    return out.status() == QDataStream::Ok && file.commit();
+#else
+    return out.status() == QDataStream::Ok;
+#endif
+#else
+    Q_UNUSED(fileName);
+    return false;
+#endif
+}
+
+/*!
+    \internal
+
+    Drops all the patterns in the cache.
+*/
+void QRegularExpressionCompiledPatternCache::clear()
+{
+    const QMutexLocker lock(&mutex);
+    codes.clear();
+}
+
 /*!
     \internal
 */
@@ -894,23 +1205,32 @@ void QRegularExpressionPrivate::compilePattern()
     isDirty = false;
     cleanCompiledPattern();
 
-    int options = convertToPcreOptions(patternOptions);
-    options |= PCRE2_UTF;
-
-    PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.utf16()),
-                                       pattern.length(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       nullptr);
+    const bool useCache = compiledPatternCacheEnabled.loadRelaxed();
+    if (useCache)
+        compiledPattern = compiledPatternCache()->lookup(pattern, patternOptions);
 
     if (!compiledPattern) {
-        errorOffset = qsizetype(patternErrorOffset);
-        return;
-    } else {
-        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
-        errorCode = 0;
+        int options = convertToPcreOptions(patternOptions);
+        options |= PCRE2_UTF;
+
+        PCRE2_SIZE patternErrorOffset;
+        compiledPattern = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.utf16()),
+                                           pattern.length(),
+                                           options,
+                                           &errorCode,
+                                           &patternErrorOffset,
+                                           nullptr);
+
+        if (!compiledPattern) {
+            errorOffset = qsizetype(patternErrorOffset);
+            return;
+        } else {
+            // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
+            errorCode = 0;
+        }
+
+        if (useCache)
+            compiledPatternCache()->insert(pattern, patternOptions, compiledPattern);
     }
 
     optimizePattern();
@@ -1530,20 +1850,19 @@ bool QRegularExpression::isValid() const
 }
 
 /*!
-    Returns a textual description of the error found when checking the validity
-    of the regular expression, or "no error" if no error was found.
+    \internal
 
-    \sa isValid(), patternErrorOffset()
+    Returns the (translated) PCRE2 message for \a errorCode, or "no error"
+    if \a errorCode is 0.
 */
-QString QRegularExpression::errorString() const
+static QString errorMessageForCode(int errorCode)
 {
-    d.data()->compilePattern();
-    if (d->errorCode) {
+    if (errorCode) {
         QString errorString;
         int errorStringLength;
         do {
             errorString.resize(errorString.length() + 64);
-            errorStringLength = pcre2_get_error_message_16(d->errorCode,
+            errorStringLength = pcre2_get_error_message_16(errorCode,
                                                            reinterpret_cast<ushort *>(errorString.data()),
                                                            errorString.length());
         } while (errorStringLength < 0);
@@ -1562,6 +1881,18 @@ QString QRegularExpression::errorString() const
 #endif
 }
 
+/*!
+    Returns a textual description of the error found when checking the validity
+    of the regular expression, or "no error" if no error was found.
+
+    \sa isValid(), patternErrorOffset()
+*/
+QString QRegularExpression::errorString() const
+{
+    d.data()->compilePattern();
+    return errorMessageForCode(d->errorCode);
+}
+
 /*!
     Returns the offset, inside the pattern string, at which an error was found
     when checking the validity of the regular expression. If no error was
@@ -1980,6 +2311,88 @@ QRegularExpression QRegularExpression::fromWildcard(QStringView pattern, Qt::Cas
     return QRegularExpression(wildcardToRegularExpression(pattern, options), reOptions);
 }
 
+/*!
+    \internal
+*/
+static QString defaultCompiledPatternCacheFileName()
+{
+#ifndef QT_NO_STANDARDPATHS
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!dir.isEmpty())
+        return dir + QLatin1String("/qregularexpression.cache");
+#endif
+    return QString();
+}
+
+/*!
+    \since 6.0
+
+    Enables the process-wide cache of compiled patterns and fills it with
+    the patterns stored in \a fileName by a previous call to
+    saveCompiledPatternCache(). If \a fileName is empty, the file
+    \c{qregularexpression.cache} in the QStandardPaths::CacheLocation
+    directory is used.
+
+    Once the cache is enabled, a QRegularExpression whose pattern and pattern
+    options are found in the cache uses the stored compiled pattern instead
+    of compiling it, and patterns that are not in the cache are added to it
+    when they are compiled. The cache stays enabled for the rest of the
+    lifetime of the process. It holds at most a few megabytes of compiled
+    patterns; beyond that, the least recently used ones are dropped. Note that the just in time compilation of
+    patterns, if enabled, cannot be cached.
+
+    Returns \c true if the file was loaded. Returns \c false if it does not
+    exist, cannot be read, or was written by an incompatible version of Qt
+    or of the PCRE2 library; the cache is enabled nonetheless, so that a
+    following call to saveCompiledPatternCache() replaces the file.
+
+    \warning The file is trusted: only load files written by
+    saveCompiledPatternCache(), from locations that are not writable by
+    other users.
+
+    \sa saveCompiledPatternCache()
+*/
+bool QRegularExpression::loadCompiledPatternCache(const QString &fileName)
+{
+    compiledPatternCacheEnabled.storeRelaxed(1);
+    const QString name = fileName.isEmpty() ? defaultCompiledPatternCacheFileName() : fileName;
+    return !name.isEmpty() && compiledPatternCache()->load(name);
+}
+
+/*!
+    \since 6.0
+
+    Writes all the patterns in the process-wide cache of compiled patterns
+    to \a fileName, replacing its contents. If \a fileName is empty, the file
+    \c{qregularexpression.cache} in the QStandardPaths::CacheLocation
+    directory is used.
+
+    Returns \c true on success; returns \c false if the file could not be
+    written, or if the cache was not enabled by loadCompiledPatternCache().
+
+    \sa loadCompiledPatternCache()
+*/
+bool QRegularExpression::saveCompiledPatternCache(const QString &fileName)
+{
+    if (!compiledPatternCacheEnabled.loadRelaxed())
+        return false;
+    const QString name = fileName.isEmpty() ? defaultCompiledPatternCacheFileName() : fileName;
+    return !name.isEmpty() && compiledPatternCache()->save(name);
+}
+
+/*!
+    \internal
+
+    Disables the process-wide cache of compiled patterns and empties it,
+    so that autotests can start from a clean state.
+*/
+Q_AUTOTEST_EXPORT void qt_regularexpression_resetCompiledPatternCache()
+{
+    compiledPatternCacheEnabled.storeRelaxed(0);
+    if (compiledPatternCache.exists())
+        compiledPatternCache()->clear();
+}
+
 #if QT_STRINGVIEW_LEVEL < 2
 /*!
     \fn QRegularExpression::anchoredPattern(const QString &expression)
@@ -2625,6 +3038,725 @@ QtPrivate::QRegularExpressionMatchIteratorRangeBasedForIterator begin(const QReg
   \internal
 */
 
+/*!
+    \class QRegularExpressionSet
+    \inmodule QtCore
+    \reentrant
+    \since 6.0
+
+    \brief The QRegularExpressionSet class matches a subject string against
+    a set of regular expressions in a single pass.
+
+    \ingroup tools
+    \ingroup shared
+    \ingroup string-processing
+
+    \keyword regular expression set
+
+    Classifying a string by testing it against a list of patterns, for
+    instance to pick a syntax highlighting rule or a routing entry, is
+    usually written as a loop over QRegularExpression objects. Such a loop
+    scans the subject string once for every pattern. QRegularExpressionSet
+    instead compiles all of its patterns into one program (or, for sets of
+    several hundred patterns, into a few programs, each covering a range of
+    patterns), so that the subject string is scanned once and every pattern
+    that matches somewhere in it is reported:
+
+    \snippet code/src_corelib_text_qregularexpression.cpp 35
+
+    Patterns are identified by their index in the list passed to the
+    constructor or to setPatterns(). matchingPatterns() returns the indexes
+    of all the patterns that match, firstMatchingPattern() returns the
+    lowest such index, and hasMatch() only reports whether any of the
+    patterns matches; the latter two stop scanning as soon as their answer
+    is known.
+
+    All patterns share the same pattern options. Patterns can still change
+    options locally, for instance with \c{(?i)}; such a change only applies
+    to the pattern that contains it.
+
+    \section1 Compilation and validity
+
+    The patterns are compiled when they are set, not when the set is first
+    used for matching; a QRegularExpressionSet can therefore be used from
+    multiple threads concurrently. If one of the patterns is not a valid
+    regular expression, isValid() returns \c false, errorPatternIndex()
+    returns the index of the first such pattern, and errorString() and
+    patternErrorOffset() describe the error. An invalid set never matches.
+
+    \section1 Limitations
+
+    A few constructs only make sense within a regular expression on its own,
+    because they refer to capturing groups by number or to the state of the
+    whole match: backreferences, subroutine calls and recursion, conditional
+    groups, callouts, and the backtracking control verbs such as
+    \c{(*SKIP)}. Patterns that use any of these are still supported, but
+    are matched separately, each with its own scan of the subject string.
+
+    Only complete matches are supported; the set reports which patterns
+    match, not where they match. Use QRegularExpression on the matching
+    patterns to retrieve captured substrings.
+
+    \sa QRegularExpression, QStringMultiMatcher
+*/
+
+/*!
+    \internal
+
+    Everything is set up by the constructor and never changed afterwards:
+    setters of QRegularExpressionSet create a new private, so that const
+    matching functions can run concurrently without any locking.
+*/
+struct QRegularExpressionSetPrivate : QSharedData
+{
+    QRegularExpressionSetPrivate(const QStringList &patterns,
+                                 QRegularExpression::PatternOptions patternOptions);
+    ~QRegularExpressionSetPrivate();
+
+    enum MatchMode {
+        AllMatches,
+        FirstMatch,
+        AnyMatch
+    };
+
+    struct MatchState {
+        QVarLengthArray<bool, 256> matched;
+        qsizetype remaining;    // patterns of the current program not matched yet
+        qsizetype limit;        // patterns with a higher index are not interesting
+        qsizetype firstCombined;
+        MatchMode mode;
+        bool found;
+    };
+
+    // a slice of the patterns that can be matched together, merged into
+    // one program; the indexes are ascending across programs
+    struct CombinedProgram {
+        pcre2_code_16 *code;
+        QList<qsizetype> indexes;
+    };
+
+    void compile();
+    void compileCombined(const QList<qsizetype> &indexes, int options);
+    bool doMatch(MatchState *state, QStringView subject, qsizetype offset,
+                 QRegularExpression::MatchOptions matchOptions) const;
+
+    const QStringList patterns;
+    const QRegularExpression::PatternOptions patternOptions;
+
+    // patterns that can be matched together are merged into as few programs
+    // as the size limit of PCRE2 allows; the others are matched one by one
+    QList<CombinedProgram> combinedPrograms;
+    QList<qsizetype> fallbackIndexes;
+    QList<QRegularExpression> fallbackExpressions;
+
+    // created once, used by whichever match gets hold of them first;
+    // concurrent matches allocate their own
+    pcre2_match_context_16 *matchContext = nullptr;
+    pcre2_match_data_16 *matchData = nullptr;
+    mutable QBasicAtomicInt matchResourcesInUse = Q_BASIC_ATOMIC_INITIALIZER(0);
+
+    int errorCode = 0;
+    qsizetype errorPatternIndex = -1;
+    qsizetype errorOffset = -1;
+};
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QRegularExpressionSetPrivate)
+
+/*!
+    \internal
+*/
+QRegularExpressionSetPrivate::QRegularExpressionSetPrivate(const QStringList &patterns,
+                                                           QRegularExpression::PatternOptions patternOptions)
+    : patterns(patterns),
+      patternOptions(patternOptions)
+{
+    compile();
+}
+
+/*!
+    \internal
+*/
+QRegularExpressionSetPrivate::~QRegularExpressionSetPrivate()
+{
+    for (const CombinedProgram &program : qAsConst(combinedPrograms))
+        pcre2_code_free_16(program.code);
+    pcre2_match_data_free_16(matchData);
+    pcre2_match_context_free_16(matchContext);
+}
+
+/*!
+    \internal
+
+    Returns \c true if \a pattern contains a construct whose meaning depends
+    on the pattern being compiled on its own: numbered or named group
+    references, recursion, conditionals, callouts and backtracking verbs.
+    The scan is purely textual and errs on the side of caution.
+*/
+static bool needsSeparateMatch(QStringView pattern)
+{
+    const qsizetype size = pattern.size();
+    for (qsizetype i = 0; i < size; ++i) {
+        const QChar c = pattern.at(i);
+        if (c == QLatin1Char('\\')) {
+            if (++i < size && (pattern.at(i) == QLatin1Char('g') || pattern.at(i) == QLatin1Char('k')))
+                return true;
+        } else if (c == QLatin1Char('(') && i + 1 < size) {
+            const QChar next = pattern.at(i + 1);
+            if (next == QLatin1Char('*'))
+                return true;
+            if (next != QLatin1Char('?') || i + 2 >= size)
+                continue;
+            const QChar kind = pattern.at(i + 2);
+            if (kind == QLatin1Char('R') || kind == QLatin1Char('&') || kind == QLatin1Char('(')
+                    || kind == QLatin1Char('C') || kind == QLatin1Char('+')
+                    || kind == QLatin1Char('-') || kind.isDigit()) {
+                // (?-i) is an option setting, not a relative recursion
+                if (kind == QLatin1Char('-') && !(i + 3 < size && pattern.at(i + 3).isDigit()))
+                    continue;
+                return true;
+            }
+            if (kind == QLatin1Char('P') && i + 3 < size
+                    && (pattern.at(i + 3) == QLatin1Char('>') || pattern.at(i + 3) == QLatin1Char('=')))
+                return true;
+        }
+    }
+    return false;
+}
+
+/*!
+    \internal
+
+    Validates every pattern, then merges the ones that can be matched
+    together into programs of the form
+
+    \code
+    (?:(?C{0})(?>pattern0\E(?x)\n)(?C{=0})|(?C{1})(?>pattern1\E(?x)\n)(?C{=1})|...)(*FAIL)
+    \endcode
+
+    The callout before each alternative lets the matcher skip patterns that
+    already matched; the one after it records a match and makes the
+    alternative fail, so that the following alternatives are tried as well.
+    The atomic group keeps PCRE2 from retrying other ways of matching a
+    pattern that already matched at the current position. The \c{\E(?x)\n}
+    suffix terminates a trailing \c{\Q} quote or \c{#} comment in the pattern
+    and is otherwise a no-op; the option change is local to the group.
+
+    A compiled program cannot exceed 64K code units, so consecutive patterns
+    are packed into programs by their compiled size (see
+    compileCombined()).
+*/
+void QRegularExpressionSetPrivate::compile()
+{
+    const int options = convertToPcreOptions(patternOptions) | PCRE2_UTF;
+
+    // the limit is 64K code units, i.e. 128 KiB; the estimate is the size
+    // reported by PCRE2_INFO_SIZE for every pattern on its own, plus the
+    // callouts and groups wrapping it, and leaves some room for error
+    constexpr size_t MaxCombinedProgramSize = 96 * 1024;
+    constexpr size_t WrapperSize = 64;
+
+    QList<qsizetype> combinedIndexes;
+    size_t combinedSize = 0;
+
+    for (qsizetype i = 0; i < patterns.size(); ++i) {
+        const QString &pattern = patterns.at(i);
+        int code;
+        PCRE2_SIZE patternErrorOffset;
+        pcre2_code_16 *compiled = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.utf16()),
+                                                   pattern.length(),
+                                                   options,
+                                                   &code,
+                                                   &patternErrorOffset,
+                                                   nullptr);
+        if (!compiled) {
+            errorCode = code;
+            errorPatternIndex = i;
+            errorOffset = qsizetype(patternErrorOffset);
+            for (const CombinedProgram &program : qAsConst(combinedPrograms))
+                pcre2_code_free_16(program.code);
+            combinedPrograms.clear();
+            fallbackIndexes.clear();
+            return;
+        }
+
+        uint32_t backReferenceMax = 0;
+        size_t size = 0;
+        pcre2_pattern_info_16(compiled, PCRE2_INFO_BACKREFMAX, &backReferenceMax);
+        pcre2_pattern_info_16(compiled, PCRE2_INFO_SIZE, &size);
+        pcre2_code_free_16(compiled);
+        size += WrapperSize;
+
+        if (backReferenceMax > 0 || needsSeparateMatch(pattern)) {
+            fallbackIndexes.append(i);
+            continue;
+        }
+
+        if (!combinedIndexes.isEmpty() && combinedSize + size > MaxCombinedProgramSize) {
+            compileCombined(combinedIndexes, options);
+            combinedIndexes.clear();
+            combinedSize = 0;
+        }
+        combinedIndexes.append(i);
+        combinedSize += size;
+    }
+
+    if (!combinedIndexes.isEmpty())
+        compileCombined(combinedIndexes, options);
+    std::sort(fallbackIndexes.begin(), fallbackIndexes.end());
+
+    if (!combinedPrograms.isEmpty()) {
+        matchContext = pcre2_match_context_create_16(nullptr);
+        pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, nullptr);
+        matchData = pcre2_match_data_create_16(1, nullptr);
+    }
+
+    fallbackExpressions.reserve(fallbackIndexes.size());
+    for (qsizetype index : qAsConst(fallbackIndexes)) {
+        QRegularExpression re(patterns.at(index), patternOptions);
+        re.optimize();
+        fallbackExpressions.append(re);
+    }
+}
+
+/*!
+    \internal
+
+    Merges the patterns at \a indexes into one program, compiled with
+    \a options, and appends it to combinedPrograms. The size estimate of
+    compile() can be off for patterns that grow when wrapped (for instance,
+    because of a trailing quantifier on a group): if the program turns out
+    to be too large anyway, the patterns are split in two halves that are
+    merged separately. A pattern that cannot be merged at all is matched on
+    its own.
+*/
+void QRegularExpressionSetPrivate::compileCombined(const QList<qsizetype> &indexes, int options)
+{
+    QString combined = QStringLiteral("(?:");
+    for (qsizetype index : indexes) {
+        const QString number = QString::number(index);
+        if (index != indexes.constFirst())
+            combined += QLatin1Char('|');
+        combined += QLatin1String("(?C{") + number + QLatin1String("})(?>")
+                + patterns.at(index)
+                + QLatin1String("\\E(?x)\n)(?C{=") + number + QLatin1String("})");
+    }
+    combined += QLatin1String(")(*FAIL)");
+
+    int code;
+    PCRE2_SIZE patternErrorOffset;
+    pcre2_code_16 *compiled = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(combined.utf16()),
+                                               combined.length(),
+                                               options | PCRE2_DUPNAMES | PCRE2_NO_AUTO_CAPTURE,
+                                               &code,
+                                               &patternErrorOffset,
+                                               nullptr);
+    if (compiled) {
+        static const bool enableJit = isJitEnabled();
+        if (enableJit)
+            pcre2_jit_compile_16(compiled, PCRE2_JIT_COMPLETE);
+        combinedPrograms.append({ compiled, indexes });
+    } else if (code == PCRE2_ERROR_PATTERN_TOO_LARGE && indexes.size() > 1) {
+        const qsizetype half = indexes.size() / 2;
+        compileCombined(indexes.mid(0, half), options);
+        compileCombined(indexes.mid(half), options);
+    } else {
+        // every pattern is valid on its own, so this can only be a limit
+        // of the combined program: match these patterns one by one
+        fallbackIndexes += indexes;
+    }
+}
+
+/*!
+    \internal
+
+    PCRE2 callout for the program built by
+    QRegularExpressionSetPrivate::compile(). \a data is the
+    QRegularExpressionSetPrivate::MatchState of the current match.
+
+    Returns 0 to proceed with the match, a positive value to backtrack and a
+    negative value to abort the whole match once the answer is known.
+*/
+static int qt_regularexpressionset_callout(pcre2_callout_block_16 *block, void *data)
+{
+    auto state = static_cast<QRegularExpressionSetPrivate::MatchState *>(data);
+    const auto str = reinterpret_cast<const char16_t *>(block->callout_string);
+    const qsizetype length = qsizetype(block->callout_string_length);
+
+    const bool isEnd = length > 0 && str[0] == u'=';
+    qsizetype index = 0;
+    for (qsizetype i = isEnd ? 1 : 0; i < length; ++i)
+        index = index * 10 + (str[i] - u'0');
+
+    if (!isEnd)
+        return (state->matched[index] || index > state->limit) ? 1 : 0;
+
+    state->matched[index] = true;
+    state->found = true;
+    --state->remaining;
+
+    switch (state->mode) {
+    case QRegularExpressionSetPrivate::AnyMatch:
+        return PCRE2_ERROR_CALLOUT;
+    case QRegularExpressionSetPrivate::FirstMatch:
+        state->limit = index - 1;
+        if (index == state->firstCombined)
+            return PCRE2_ERROR_CALLOUT;
+        break;
+    case QRegularExpressionSetPrivate::AllMatches:
+        if (state->remaining == 0)
+            return PCRE2_ERROR_CALLOUT;
+        break;
+    }
+
+    return 1;
+}
+
+/*!
+    \internal
+
+    Runs the combined programs over \a subject starting at \a offset,
+    recording the matching patterns in \a state. Returns \c false if the
+    subject could not be matched at all (for instance, because it is not
+    valid UTF-16), in which case the fallback patterns must not be tried
+    either.
+*/
+bool QRegularExpressionSetPrivate::doMatch(MatchState *state, QStringView subject, qsizetype offset,
+                                           QRegularExpression::MatchOptions matchOptions) const
+{
+    if (combinedPrograms.isEmpty())
+        return true;
+
+    const bool shared = matchResourcesInUse.testAndSetAcquire(0, 1);
+    pcre2_match_context_16 *context = matchContext;
+    pcre2_match_data_16 *data = matchData;
+    if (!shared) {
+        context = pcre2_match_context_create_16(nullptr);
+        pcre2_jit_stack_assign_16(context, &qtPcreCallback, nullptr);
+        data = pcre2_match_data_create_16(1, nullptr);
+    }
+    pcre2_set_callout_16(context, &qt_regularexpressionset_callout, state);
+
+    uint32_t options = convertToPcreOptions(matchOptions);
+    bool ok = true;
+    for (const CombinedProgram &program : combinedPrograms) {
+        // programs are sorted by pattern index, so an earlier match is
+        // always the better one
+        if (state->mode == AnyMatch && state->found)
+            break;
+        state->firstCombined = program.indexes.constFirst();
+        if (state->firstCombined > state->limit)
+            break;
+        state->remaining = program.indexes.size();
+
+        const int result = safe_pcre2_match_16(program.code,
+                                               reinterpret_cast<PCRE2_SPTR16>(subject.utf16()), subject.size(),
+                                               offset, options, data, context);
+
+        // the program always ends in (*FAIL): it either runs to completion
+        // or gets aborted by the callout
+        if (result != PCRE2_ERROR_NOMATCH && result != PCRE2_ERROR_CALLOUT) {
+            ok = false;
+            break;
+        }
+        options |= PCRE2_NO_UTF_CHECK;
+    }
+
+    if (shared) {
+        matchResourcesInUse.storeRelease(0);
+    } else {
+        pcre2_match_data_free_16(data);
+        pcre2_match_context_free_16(context);
+    }
+    return ok;
+}
+
+/*!
+    \internal
+
+    Sets up \a state for matching \a subject from \a offset with the set
+    \a d, turning a negative \a offset into a position from the end of
+    \a subject. Returns \c false if nothing can match.
+*/
+static bool prepareMatch(const QRegularExpressionSetPrivate *d,
+                         QRegularExpressionSetPrivate::MatchState *state,
+                         QRegularExpressionSetPrivate::MatchMode mode,
+                         QStringView subject, qsizetype *offset)
+{
+    if (Q_UNLIKELY(d->errorPatternIndex != -1)) {
+        qWarning("QRegularExpressionSet: called on an invalid QRegularExpressionSet object");
+        return false;
+    }
+
+    if (*offset < 0)
+        *offset += subject.size();
+    if (*offset < 0 || *offset > subject.size())
+        return false;
+
+    state->matched.resize(d->patterns.size());
+    std::fill(state->matched.begin(), state->matched.end(), false);
+    state->remaining = 0;
+    state->limit = d->patterns.size() - 1;
+    state->firstCombined = -1;
+    state->mode = mode;
+    state->found = false;
+    return true;
+}
+
+/*!
+    Constructs an empty set. An empty set is valid, and never matches.
+*/
+QRegularExpressionSet::QRegularExpressionSet()
+    : d(new QRegularExpressionSetPrivate(QStringList(), QRegularExpression::NoPatternOption))
+{
+}
+
+/*!
+    Constructs a set of the regular expressions in \a patterns, compiled with
+    the pattern options \a options.
+
+    \sa setPatterns(), setPatternOptions()
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QStringList &patterns,
+                                             QRegularExpression::PatternOptions options)
+    : d(new QRegularExpressionSetPrivate(patterns, options))
+{
+}
+
+/*!
+    Constructs a set as a copy of \a other.
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QRegularExpressionSet &other) = default;
+
+/*!
+    \fn QRegularExpressionSet::QRegularExpressionSet(QRegularExpressionSet &&other)
+
+    Move-constructs a set from \a other.
+
+    \note The moved-from object \a other is placed in a
+    partially-formed state, in which the only valid operations are
+    destruction and assignment of a new value.
+*/
+
+/*!
+    Assigns \a other to this set and returns a reference to it.
+*/
+QRegularExpressionSet &QRegularExpressionSet::operator=(const QRegularExpressionSet &other) = default;
+
+/*!
+    \fn QRegularExpressionSet &QRegularExpressionSet::operator=(QRegularExpressionSet &&other)
+
+    Move-assigns \a other to this set and returns a reference to it.
+*/
+
+/*!
+    Destroys the set.
+*/
+QRegularExpressionSet::~QRegularExpressionSet() = default;
+
+/*!
+    \fn void QRegularExpressionSet::swap(QRegularExpressionSet &other)
+
+    Swaps the set \a other with this set. This operation is very fast and
+    never fails.
+*/
+
+/*!
+    Returns the patterns of the set.
+
+    \sa setPatterns()
+*/
+QStringList QRegularExpressionSet::patterns() const
+{
+    return d->patterns;
+}
+
+/*!
+    Sets the patterns of the set to \a patterns and compiles them.
+
+    \sa patterns(), isValid()
+*/
+void QRegularExpressionSet::setPatterns(const QStringList &patterns)
+{
+    d = new QRegularExpressionSetPrivate(patterns, d->patternOptions);
+}
+
+/*!
+    Returns the number of patterns in the set.
+*/
+qsizetype QRegularExpressionSet::patternCount() const
+{
+    return d->patterns.size();
+}
+
+/*!
+    Returns the pattern options used for all the patterns of the set.
+
+    \sa setPatternOptions()
+*/
+QRegularExpression::PatternOptions QRegularExpressionSet::patternOptions() const
+{
+    return d->patternOptions;
+}
+
+/*!
+    Sets the pattern options of the set to \a options and recompiles the
+    patterns.
+
+    \sa patternOptions()
+*/
+void QRegularExpressionSet::setPatternOptions(QRegularExpression::PatternOptions options)
+{
+    d = new QRegularExpressionSetPrivate(d->patterns, options);
+}
+
+/*!
+    Returns \c true if all the patterns of the set are valid regular
+    expressions; returns \c false otherwise.
+
+    \sa errorString(), errorPatternIndex(), patternErrorOffset()
+*/
+bool QRegularExpressionSet::isValid() const
+{
+    return d->errorPatternIndex == -1;
+}
+
+/*!
+    Returns a textual description of the error found in the pattern at
+    errorPatternIndex(), or "no error" if all the patterns are valid.
+
+    \sa isValid(), QRegularExpression::errorString()
+*/
+QString QRegularExpressionSet::errorString() const
+{
+    return errorMessageForCode(d->errorCode);
+}
+
+/*!
+    Returns the index of the first pattern that is not a valid regular
+    expression, or -1 if all the patterns are valid.
+
+    \sa isValid(), patternErrorOffset()
+*/
+qsizetype QRegularExpressionSet::errorPatternIndex() const
+{
+    return d->errorPatternIndex;
+}
+
+/*!
+    Returns the offset, inside the pattern at errorPatternIndex(), at which
+    an error was found, or -1 if all the patterns are valid.
+
+    \sa errorPatternIndex(), QRegularExpression::patternErrorOffset()
+*/
+qsizetype QRegularExpressionSet::patternErrorOffset() const
+{
+    return d->errorOffset;
+}
+
+/*!
+    Matches all the patterns of the set against \a subject, starting at the
+    position \a offset inside the subject, using the match options
+    \a matchOptions, and returns the indexes of the patterns that match, in
+    ascending order.
+
+    As with QRegularExpression::match(), a negative \a offset is taken as a
+    position from the end of \a subject.
+
+    \sa firstMatchingPattern(), hasMatch()
+*/
+QList<qsizetype> QRegularExpressionSet::matchingPatterns(QStringView subject, qsizetype offset,
+                                                         QRegularExpression::MatchOptions matchOptions) const
+{
+    QList<qsizetype> result;
+
+    QRegularExpressionSetPrivate::MatchState state;
+    if (!prepareMatch(d.data(), &state, QRegularExpressionSetPrivate::AllMatches, subject, &offset))
+        return result;
+
+    if (!d->doMatch(&state, subject, offset, matchOptions))
+        return result;
+
+    if (!d->combinedPrograms.isEmpty())
+        matchOptions |= QRegularExpression::DontCheckSubjectStringMatchOption;
+    for (qsizetype i = 0; i < d->fallbackIndexes.size(); ++i) {
+        const QRegularExpression &re = d->fallbackExpressions.at(i);
+        if (re.match(subject, offset, QRegularExpression::NormalMatch, matchOptions).hasMatch())
+            state.matched[d->fallbackIndexes.at(i)] = true;
+    }
+
+    for (qsizetype i = 0; i < state.matched.size(); ++i) {
+        if (state.matched.at(i))
+            result.append(i);
+    }
+    return result;
+}
+
+/*!
+    Returns the lowest index of the patterns of the set that match
+    \a subject, starting at the position \a offset inside the subject and
+    using the match options \a matchOptions, or -1 if none of them matches.
+
+    This is equivalent to taking the first element of matchingPatterns(),
+    but it can stop scanning \a subject earlier.
+
+    \sa matchingPatterns(), hasMatch()
+*/
+qsizetype QRegularExpressionSet::firstMatchingPattern(QStringView subject, qsizetype offset,
+                                                      QRegularExpression::MatchOptions matchOptions) const
+{
+    QRegularExpressionSetPrivate::MatchState state;
+    if (!prepareMatch(d.data(), &state, QRegularExpressionSetPrivate::FirstMatch, subject, &offset))
+        return -1;
+
+    if (!d->doMatch(&state, subject, offset, matchOptions))
+        return -1;
+
+    // the combined programs left limit just below their best match
+    const qsizetype best = state.limit + 1;
+
+    if (!d->combinedPrograms.isEmpty())
+        matchOptions |= QRegularExpression::DontCheckSubjectStringMatchOption;
+    for (qsizetype i = 0; i < d->fallbackIndexes.size(); ++i) {
+        const qsizetype index = d->fallbackIndexes.at(i);
+        if (index >= best)
+            break;
+        const QRegularExpression &re = d->fallbackExpressions.at(i);
+        if (re.match(subject, offset, QRegularExpression::NormalMatch, matchOptions).hasMatch())
+            return index;
+    }
+
+    return best < d->patterns.size() ? best : -1;
+}
+
+/*!
+    Returns \c true if any of the patterns of the set matches \a subject,
+    starting at the position \a offset inside the subject and using the
+    match options \a matchOptions; returns \c false otherwise.
+
+    \sa matchingPatterns(), firstMatchingPattern()
+*/
+bool QRegularExpressionSet::hasMatch(QStringView subject, qsizetype offset,
+                                     QRegularExpression::MatchOptions matchOptions) const
+{
+    QRegularExpressionSetPrivate::MatchState state;
+    if (!prepareMatch(d.data(), &state, QRegularExpressionSetPrivate::AnyMatch, subject, &offset))
+        return false;
+
+    if (!d->doMatch(&state, subject, offset, matchOptions))
+        return false;
+
+    if (state.found)
+        return true;
+
+    if (!d->combinedPrograms.isEmpty())
+        matchOptions |= QRegularExpression::DontCheckSubjectStringMatchOption;
+    for (const QRegularExpression &re : d->fallbackExpressions) {
+        if (re.match(subject, offset, QRegularExpression::NormalMatch, matchOptions).hasMatch())
+            return true;
+    }
+    return false;
+}
+
 #ifndef QT_NO_DATASTREAM
 /*!
     \relates QRegularExpression
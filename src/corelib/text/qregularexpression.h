@@ -173,6 +173,9 @@ public:
     static QRegularExpression fromWildcard(QStringView pattern, Qt::CaseSensitivity cs = Qt::CaseInsensitive,
                                            WildcardConversionOptions options = DefaultWildcardConversion);
 
+    static bool loadCompiledPatternCache(const QString &fileName = QString());
+    static bool saveCompiledPatternCache(const QString &fileName = QString());
+
     bool operator==(const QRegularExpression &re) const;
     inline bool operator!=(const QRegularExpression &re) const { return !operator==(re); }
 
@@ -400,6 +403,48 @@ private:
 
 Q_DECLARE_SHARED(QRegularExpressionMatchIterator)
 
+struct QRegularExpressionSetPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QRegularExpressionSetPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QRegularExpressionSet
+{
+public:
+    QRegularExpressionSet();
+    explicit QRegularExpressionSet(const QStringList &patterns,
+                                   QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption);
+    QRegularExpressionSet(const QRegularExpressionSet &other);
+    QRegularExpressionSet(QRegularExpressionSet &&other) noexcept = default;
+    QRegularExpressionSet &operator=(const QRegularExpressionSet &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QRegularExpressionSet)
+    ~QRegularExpressionSet();
+
+    void swap(QRegularExpressionSet &other) noexcept { d.swap(other.d); }
+
+    QStringList patterns() const;
+    void setPatterns(const QStringList &patterns);
+    qsizetype patternCount() const;
+
+    QRegularExpression::PatternOptions patternOptions() const;
+    void setPatternOptions(QRegularExpression::PatternOptions options);
+
+    bool isValid() const;
+    QString errorString() const;
+    qsizetype errorPatternIndex() const;
+    qsizetype patternErrorOffset() const;
+
+    QList<qsizetype> matchingPatterns(QStringView subject, qsizetype offset = 0,
+                                      QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+    qsizetype firstMatchingPattern(QStringView subject, qsizetype offset = 0,
+                                   QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+    bool hasMatch(QStringView subject, qsizetype offset = 0,
+                  QRegularExpression::MatchOptions matchOptions = QRegularExpression::NoMatchOption) const;
+
+private:
+    QExplicitlySharedDataPointer<QRegularExpressionSetPrivate> d;
+};
+
+Q_DECLARE_SHARED(QRegularExpressionSet)
+
 QT_END_NAMESPACE
 
 #endif // QREGULAREXPRESSION_H
@@ -7254,13 +7254,13 @@ QString QString::number(qulonglong n, int base)
 
     \sa setNum(), QLocale::toString()
 */
-QString QString::number(double n, char f, int prec)
+static QLocaleData::DoubleForm doubleFormForFormat(char f, uint *flags)
 {
     QLocaleData::DoubleForm form = QLocaleData::DFDecimal;
-    uint flags = QLocaleData::ZeroPadExponent;
+    *flags = QLocaleData::ZeroPadExponent;
 
     if (qIsUpper(f))
-        flags |= QLocaleData::CapitalEorX;
+        *flags |= QLocaleData::CapitalEorX;
 
     switch (qToLower(f)) {
         case 'f':
@@ -7278,10 +7278,96 @@ QString QString::number(double n, char f, int prec)
 #endif
             break;
     }
+    return form;
+}
 
+QString QString::number(double n, char f, int prec)
+{
+    uint flags;
+    const QLocaleData::DoubleForm form = doubleFormForFormat(f, &flags);
     return QLocaleData::c()->doubleToString(n, prec, form, -1, flags);
 }
 
+template <typename T, typename SetNumber>
+static void appendNumbersImpl(QString &out, const T *values, qsizetype count,
+                              QStringView separator, SetNumber setNumber)
+{
+    // the separator may point into out, which appending reallocates
+    QVarLengthArray<char16_t, 16> sep;
+    sep.append(separator.utf16(), separator.size());
+
+    QCLocaleNumberFormatter formatter;
+    for (qsizetype i = 0; i < count; ++i) {
+        const bool ok = setNumber(formatter, values[i]);
+        Q_ASSERT(ok); // no digit grouping, always base 10
+        Q_UNUSED(ok);
+
+        const qsizetype separatorSize = i ? sep.size() : 0;
+        const qsizetype oldSize = out.size();
+        out.resize(oldSize + separatorSize + formatter.size());
+        char16_t *dst = reinterpret_cast<char16_t *>(out.data()) + oldSize;
+        dst = std::copy(sep.cbegin(), sep.cbegin() + separatorSize, dst);
+        formatter.write(dst);
+    }
+}
+
+/*!
+    \since 6.0
+
+    Appends the decimal text of the  count integers starting at  values
+    to this string, separated by  separator, and returns a reference to this
+    string.
+
+    The numbers are formatted as number() does, but directly into this
+    string: the string grows as needed and no temporary string is created
+    for each number.
+
+    \snippet qstring/main.cpp 87
+
+    \sa number(), append()
+*/
+QString &QString::appendNumbers(const qlonglong *values, qsizetype count, QStringView separator)
+{
+    appendNumbersImpl(*this, values, count, separator, [](QCLocaleNumberFormatter &f, qlonglong n) {
+        // as in QLocaleData::longLongToString(), avoid negating min()
+        return f.setInteger(n < 0 ? 0 - qulonglong(n) : qulonglong(n), n < 0);
+    });
+    return *this;
+}
+
+/*!
+    \overload
+    \since 6.0
+*/
+QString &QString::appendNumbers(const qulonglong *values, qsizetype count, QStringView separator)
+{
+    appendNumbersImpl(*this, values, count, separator, [](QCLocaleNumberFormatter &f, qulonglong n) {
+        return f.setInteger(n, false);
+    });
+    return *this;
+}
+
+/*!
+    \overload
+    \since 6.0
+
+    Appends the text of the  count numbers starting at  values, separated
+    by  separator, formatted according to the given  format and 
+    precision as by number(). With a  precision of
+    QLocale::FloatingPointShortest, each number gets the fewest digits that
+    still read back as the same value.
+*/
+QString &QString::appendNumbers(const double *values, qsizetype count, QStringView separator,
+                                char format, int precision)
+{
+    uint flags;
+    const QLocaleData::DoubleForm form = doubleFormForFormat(format, &flags);
+    appendNumbersImpl(*this, values, count, separator, [=](QCLocaleNumberFormatter &f, double d) {
+        return f.setDouble(d, precision, form, -1, flags);
+    });
+    return *this;
+}
+
 namespace {
 template<class ResultList, class StringSource>
 static ResultList splitString(const StringSource &source, QStringView sep,
@@ -8198,9 +8284,9 @@ static int getEscape(const Char *uc, qsizetype *pos, qsizetype len, int maxNumbe
     Algorithm for multiArg:
 
     1. Parse the string as a sequence of verbatim text and placeholders (%L?\d{,3}).
-       The L is parsed and accepted for compatibility with non-multi-arg, but since
-       multiArg only accepts strings as replacements, the localization request can
-       be safely ignored.
+       The L is parsed and accepted for compatibility with non-multi-arg. multiArg
+       only accepts strings as replacements and ignores it; appendArgs() uses it
+       to format numeric replacements in the default locale.
     2. The result of step (1) is a list of (string-ref,int)-tuples. The string-ref
        either points at text to be copied verbatim (in which case the int is -1),
        or, initially, at the textual representation of the placeholder. In that case,
@@ -8224,6 +8310,8 @@ static int getEscape(const Char *uc, qsizetype *pos, qsizetype len, int maxNumbe
        5a. If the int is negative, do nothing.
        5b. Otherwise, if the int is found in the result of step (3) at index I, replace
            the string-ref with a string-ref for the (complete) I'th replacement string.
+           If that replacement is a number (appendArgs() only), format it into a
+           shared buffer first and refer to its text there.
        5c. Otherwise, do nothing.
     6. Concatenate all string refs into a single result string.
 */
@@ -8232,15 +8320,16 @@ namespace {
 struct Part
 {
     Part() = default; // for QVarLengthArray; do not use
-    constexpr Part(QStringView s, int num = -1)
-        : tag{QtPrivate::ArgBase::U16}, number{num}, data{s.utf16()}, size{s.size()} {}
-    constexpr Part(QLatin1String s, int num = -1)
-        : tag{QtPrivate::ArgBase::L1}, number{num}, data{s.data()}, size{s.size()} {}
+    constexpr Part(QStringView s, int num = -1, bool localized = false)
+        : tag{QtPrivate::ArgBase::U16}, localized{localized}, number{num}, data{s.utf16()}, size{s.size()} {}
+    constexpr Part(QLatin1String s, int num = -1, bool localized = false)
+        : tag{QtPrivate::ArgBase::L1}, localized{localized}, number{num}, data{s.data()}, size{s.size()} {}
 
     void reset(QStringView s) noexcept { *this = {s, number}; }
     void reset(QLatin1String s) noexcept { *this = {s, number}; }
 
     QtPrivate::ArgBase::Tag tag;
+    bool localized;
     int number;
     const void *data;
     qsizetype size;
@@ -8272,9 +8361,10 @@ static ParseResult parseMultiArgFormatString(StringView s)
             qsizetype percent = i;
             int number = getEscape(uc, &i, len);
             if (number != -1) {
+                const bool localized = uc[percent + 1] == QLatin1Char('L');
                 if (last != percent)
                     result.push_back(Part{s.mid(last, percent - last)}); // literal text (incl. failed placeholders)
-                result.push_back(Part{s.mid(percent, i - percent), number});  // parsed placeholder
+                result.push_back(Part{s.mid(percent, i - percent), number, localized});  // parsed placeholder
                 last = i;
                 continue;
             }
@@ -8304,9 +8394,84 @@ static ArgIndexToPlaceholderMap makeArgIndexToPlaceholderMap(const ParseResult &
     return result;
 }
 
-static qsizetype resolveStringRefsAndReturnTotalSize(ParseResult &parts, const ArgIndexToPlaceholderMap &argIndexToPlaceholderMap, const QtPrivate::ArgBase *args[])
+/*
+    Holds the text of the numbers substituted by appendArgs(). The text of all
+    of them is kept in one buffer, so that formatting a few numbers in the C
+    locale doesn't allocate at all.
+*/
+class NumberArgBuffer
+{
+public:
+    qsizetype append(const QtPrivate::ArgBase &arg, bool localized);
+    const char16_t *data() const noexcept { return chars.constData(); }
+    qsizetype size() const noexcept { return chars.size(); }
+
+private:
+    void appendFormatted()
+    {
+        const qsizetype offset = chars.size();
+        chars.resize(offset + formatter.size());
+        formatter.write(chars.data() + offset);
+    }
+    void appendString(const QString &text)
+    { chars.append(reinterpret_cast<const char16_t *>(text.constData()), text.size()); }
+
+    QVarLengthArray<char16_t, 256> chars;
+    QCLocaleNumberFormatter formatter;
+};
+
+// returns the offset of the text in the buffer; the same formatting as
+// QString::arg() with the default field width, base and format
+qsizetype NumberArgBuffer::append(const QtPrivate::ArgBase &arg, bool localized)
+{
+    using namespace QtPrivate;
+    const qsizetype offset = chars.size();
+    switch (arg.tag) {
+    case ArgBase::Integer: {
+        const qlonglong value = static_cast<const QIntegerArg &>(arg).value;
+        if (localized) {
+            appendString(QLocale().toString(value));
+        } else {
+            formatter.setInteger(value < 0 ? 0 - qulonglong(value) : qulonglong(value), value < 0);
+            appendFormatted();
+        }
+        break;
+    }
+    case ArgBase::UnsignedInteger: {
+        const qulonglong value = static_cast<const QUnsignedIntegerArg &>(arg).value;
+        if (localized) {
+            appendString(QLocale().toString(value));
+        } else {
+            formatter.setInteger(value, false);
+            appendFormatted();
+        }
+        break;
+    }
+    case ArgBase::Double: {
+        const double value = static_cast<const QDoubleArg &>(arg).value;
+        if (localized) {
+            appendString(QLocale().toString(value, 'g', -1));
+        } else {
+            formatter.setDouble(value, -1, QLocaleData::DFSignificantDigits, -1,
+                                QLocaleData::ZeroPadExponent);
+            appendFormatted();
+        }
+        break;
+    }
+    case ArgBase::L1:
+    case ArgBase::U8:
+    case ArgBase::U16:
+        Q_UNREACHABLE();
+        break;
+    }
+    return offset;
+}
+
+static qsizetype resolveStringRefsAndReturnTotalSize(ParseResult &parts, const ArgIndexToPlaceholderMap &argIndexToPlaceholderMap,
+                                                     const QtPrivate::ArgBase *args[], NumberArgBuffer *numbers = nullptr)
 {
     using namespace QtPrivate;
+    QVarLengthArray<qsizetype, ExpectedParts/2> numberOffsets;
     qsizetype totalSize = 0;
     for (Part &part : parts) {
         if (part.number != -1) {
@@ -8323,11 +8488,32 @@ static qsizetype resolveStringRefsAndReturnTotalSize(ParseResult &parts, const A
                 case ArgBase::U16:
                     part.reset(static_cast<const QStringViewArg&>(arg).string);
                     break;
+                case ArgBase::Integer:
+                case ArgBase::UnsignedInteger:
+                case ArgBase::Double: {
+                    // the buffer may still move: keep the offset, and the
+                    // Integer tag marks the part until it's resolved below
+                    Q_ASSERT(numbers);
+                    const qsizetype offset = numbers->append(arg, part.localized);
+                    numberOffsets.push_back(offset);
+                    part.tag = ArgBase::Integer;
+                    part.data = nullptr;
+                    part.size = numbers->size() - offset;
+                    break;
+                }
                 }
             }
         }
         totalSize += part.size;
     }
+
+    if (!numberOffsets.isEmpty()) {
+        const qsizetype *offset = numberOffsets.constData();
+        for (Part &part : parts) {
+            if (part.tag == ArgBase::Integer)
+                part.reset(QStringView(numbers->data() + *offset++, part.size));
+        }
+    }
     return totalSize;
 }
 
@@ -8336,8 +8522,10 @@ static qsizetype resolveStringRefsAndReturnTotalSize(ParseResult &parts, const A
 Q_ALWAYS_INLINE QString to_string(QLatin1String s) noexcept { return s; }
 Q_ALWAYS_INLINE QString to_string(QStringView s) noexcept { return s.toString(); }
 
+// Step 1-5 above: returns the parts to concatenate and their total size
 template <typename StringView>
-static QString argToQStringImpl(StringView pattern, size_t numArgs, const QtPrivate::ArgBase **args)
+static ParseResult resolveMultiArgFormatString(StringView pattern, size_t numArgs, const QtPrivate::ArgBase **args,
+                                              qsizetype *totalSize, NumberArgBuffer *numbers = nullptr)
 {
     // Step 1-2 above
     ParseResult parts = parseMultiArgFormatString(pattern);
@@ -8352,12 +8540,13 @@ static QString argToQStringImpl(StringView pattern, size_t numArgs, const QtPriv
                  int(numArgs - argIndexToPlaceholderMap.size()), qUtf16Printable(to_string(pattern)));
 
     // 5
-    const qsizetype totalSize = resolveStringRefsAndReturnTotalSize(parts, argIndexToPlaceholderMap, args);
-
-    // 6:
-    QString result(totalSize, Qt::Uninitialized);
-    auto out = const_cast<QChar*>(result.constData());
+    *totalSize = resolveStringRefsAndReturnTotalSize(parts, argIndexToPlaceholderMap, args, numbers);
+    return parts;
+}
 
+// 6: writes the parts as UTF-16
+static void writeParts(QChar *out, const ParseResult &parts)
+{
     for (Part part : parts) {
         switch (part.tag) {
         case QtPrivate::ArgBase::L1:
@@ -8366,17 +8555,29 @@ static QString argToQStringImpl(StringView pattern, size_t numArgs, const QtPriv
                                reinterpret_cast<const char*>(part.data), part.size);
             }
             break;
-        case QtPrivate::ArgBase::U8:
-            Q_UNREACHABLE(); // waiting for QUtf8String
-            break;
         case QtPrivate::ArgBase::U16:
             if (part.size)
                 memcpy(out, part.data, part.size * sizeof(QChar));
             break;
+        case QtPrivate::ArgBase::U8:
+        case QtPrivate::ArgBase::Integer:
+        case QtPrivate::ArgBase::UnsignedInteger:
+        case QtPrivate::ArgBase::Double:
+            Q_UNREACHABLE(); // waiting for QUtf8String; numbers were resolved
+            break;
         }
         out += part.size;
     }
+}
 
+template <typename StringView>
+static QString argToQStringImpl(StringView pattern, size_t numArgs, const QtPrivate::ArgBase **args)
+{
+    qsizetype totalSize;
+    const ParseResult parts = resolveMultiArgFormatString(pattern, numArgs, args, &totalSize);
+
+    QString result(totalSize, Qt::Uninitialized);
+    writeParts(const_cast<QChar*>(result.constData()), parts);
     return result;
 }
 
@@ -8390,6 +8591,111 @@ QString QtPrivate::argToQString(QLatin1String pattern, size_t n, const ArgBase *
     return argToQStringImpl(pattern, n, args);
 }
 
+// Returns a copy of \a out if some of \a parts refer to its data, so that the
+// data stays alive when appending to \a out reallocates it
+template <typename Container>
+static Container keepAliveIfReferenced(const Container &out, const ParseResult &parts)
+{
+    const quintptr begin = quintptr(out.constData());
+    const quintptr end = begin + out.size() * sizeof(*out.constData());
+    for (Part part : parts) {
+        if (part.size && quintptr(part.data) >= begin && quintptr(part.data) < end)
+            return out;
+    }
+    return Container();
+}
+
+template <typename StringView>
+static void appendArgsImpl(QString &out, StringView pattern, size_t numArgs, const QtPrivate::ArgBase **args)
+{
+    NumberArgBuffer numbers;
+    qsizetype totalSize;
+    const ParseResult parts = resolveMultiArgFormatString(pattern, numArgs, args, &totalSize, &numbers);
+
+    const QString keepAlive = keepAliveIfReferenced(out, parts);
+    const qsizetype oldSize = out.size();
+    if (oldSize == 0 && out.capacity() < totalSize)
+        out = QString(totalSize, Qt::Uninitialized);  // don't over-allocate a new string
+    else
+        out.resize(oldSize + totalSize);
+    writeParts(out.data() + oldSize, parts);
+}
+
+void QtPrivate::appendArgs(QString &out, QStringView pattern, size_t n, const ArgBase **args)
+{
+    appendArgsImpl(out, pattern, n, args);
+}
+
+void QtPrivate::appendArgs(QString &out, QLatin1String pattern, size_t n, const ArgBase **args)
+{
+    appendArgsImpl(out, pattern, n, args);
+}
+
+void QtPrivate::appendArgs(QByteArray &out, QLatin1String pattern, size_t n, const ArgBase **args)
+{
+    NumberArgBuffer numbers;
+    qsizetype totalSize;
+    const ParseResult parts = resolveMultiArgFormatString(pattern, n, args, &totalSize, &numbers);
+
+    // each Latin-1 character takes at most two bytes in UTF-8, each UTF-16
+    // code unit at most three
+    qsizetype maxSize = 0;
+    for (Part part : parts)
+        maxSize += part.size * (part.tag == ArgBase::L1 ? 2 : 3);
+
+    const QByteArray keepAlive = keepAliveIfReferenced(out, parts);
+    const qsizetype oldSize = out.size();
+    out.resize(oldSize + maxSize);
+    uchar *dst = reinterpret_cast<uchar *>(out.data()) + oldSize;
+    QStringConverter::State state(QStringConverter::Flag::Stateless);
+    for (Part part : parts) {
+        if (part.tag == ArgBase::L1) {
+            const uchar *src = static_cast<const uchar *>(part.data);
+            for (const uchar *end = src + part.size; src != end; ++src) {
+                if (*src < 0x80) {
+                    *dst++ = *src;
+                } else {
+                    *dst++ = 0xc0 | (*src >> 6);
+                    *dst++ = 0x80 | (*src & 0x3f);
+                }
+            }
+        } else {
+            Q_ASSERT(part.tag == ArgBase::U16);
+            const QStringView text(static_cast<const QChar *>(part.data), part.size);
+            dst = reinterpret_cast<uchar *>(QUtf8::convertFromUnicode(reinterpret_cast<char *>(dst), text, &state));
+        }
+    }
+    out.truncate(reinterpret_cast<char *>(dst) - out.constData());
+}
+
+/*!
+    \fn template <typename...Args> QString &QString::appendArgs(QStringView format, const Args &...args)
+    \fn template <typename...Args> QString &QString::appendArgs(QLatin1String format, const Args &...args)
+    \since 6.0
+
+    Appends a copy of \a format to this string in which the \c{%N}
+    placeholders are replaced by \a args, and returns a reference to this
+    string.
+
+    The placeholders are replaced the same way as by the multi-argument
+    overload of arg(): the lowest-numbered placeholder is replaced by the
+    first argument, the next one by the second argument, and so on. In
+    addition to strings (QString, QStringView, QLatin1String, QChar and
+    \c{char}), \a args may contain integers and floating-point numbers. A
+    \c{%N} placeholder formats them in the C locale, a \c{%LN} one in the
+    default locale, as arg(qlonglong) and arg(double) with the default field
+    width, base, format and precision would.
+
+    Unlike chaining arg() calls, the format string is parsed once, the size
+    of the result is computed before anything is written and the result is
+    written directly into this string: there is at most one allocation,
+    and none if the string has enough capacity.
+
+    \snippet qstring/main.cpp 86
+
+    \sa arg(), append(), QByteArray::appendArgs()
+*/
+
 /*! \fn bool QString::isSimpleText() const
 
     \internal
@@ -9019,6 +9325,22 @@ QString &QString::setRawData(const QChar *unicode, qsizetype size)
     \sa indexOf(), QStringView::lastIndexOf(), QStringView::indexOf(), QString::indexOf()
 */
 
+/*!
+    \fn qsizetype QLatin1String::parseNumbers(qlonglong *values, qsizetype maxCount, char separator, qsizetype *endPosition) const
+    \fn qsizetype QLatin1String::parseNumbers(qulonglong *values, qsizetype maxCount, char separator, qsizetype *endPosition) const
+    \fn qsizetype QLatin1String::parseNumbers(double *values, qsizetype maxCount, char separator, qsizetype *endPosition) const
+    \since 6.0
+
+    Parses the numbers in this Latin-1 string, separated by \a separator,
+    into the array of \a maxCount elements at \a values, and returns how many
+    were stored. If \a endPosition is not \nullptr, it is set to the offset
+    at which parsing stopped.
+
+    This is the same as QByteArrayView::parseNumbers() on the Latin-1 data.
+
+    \sa QByteArrayView::parseNumbers()
+*/
+
 /*!
     \fn QLatin1String::const_iterator QLatin1String::begin() const
     \since 5.10
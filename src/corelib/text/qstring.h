@@ -157,6 +157,16 @@ public:
     [[nodiscard]] qsizetype lastIndexOf(QChar c, qsizetype from = -1, Qt::CaseSensitivity cs = Qt::CaseSensitive) const noexcept
     { return QtPrivate::lastIndexOf(*this, from, QStringView(&c, 1), cs); }
 
+    qsizetype parseNumbers(qlonglong *values, qsizetype maxCount, char separator = ',',
+                           qsizetype *endPosition = nullptr) const
+    { return QByteArrayView(m_data, m_size).parseNumbers(values, maxCount, separator, endPosition); }
+    qsizetype parseNumbers(qulonglong *values, qsizetype maxCount, char separator = ',',
+                           qsizetype *endPosition = nullptr) const
+    { return QByteArrayView(m_data, m_size).parseNumbers(values, maxCount, separator, endPosition); }
+    qsizetype parseNumbers(double *values, qsizetype maxCount, char separator = ',',
+                           qsizetype *endPosition = nullptr) const
+    { return QByteArrayView(m_data, m_size).parseNumbers(values, maxCount, separator, endPosition); }
+
     using value_type = const char;
     using reference = value_type&;
     using const_reference = reference;
@@ -430,6 +440,11 @@ public:
     arg(Args &&...args) const
     { return qToStringViewIgnoringNull(*this).arg(std::forward<Args>(args)...); }
 
+    template <typename...Args>
+    QString &appendArgs(QStringView format, const Args &...args);
+    template <typename...Args>
+    QString &appendArgs(QLatin1String format, const Args &...args);
+
     static QString vasprintf(const char *format, va_list ap) Q_ATTRIBUTE_FORMAT_PRINTF(1, 0);
     static QString asprintf(const char *format, ...) Q_ATTRIBUTE_FORMAT_PRINTF(1, 2);
 
@@ -781,6 +796,11 @@ public:
     static QString number(qulonglong, int base=10);
     static QString number(double, char f='g', int prec=6);
 
+    QString &appendNumbers(const qlonglong *values, qsizetype count, QStringView separator);
+    QString &appendNumbers(const qulonglong *values, qsizetype count, QStringView separator);
+    QString &appendNumbers(const double *values, qsizetype count, QStringView separator,
+                           char format = 'g', int precision = 6);
+
     friend Q_CORE_EXPORT bool operator==(const QString &s1, const QString &s2) noexcept;
     friend Q_CORE_EXPORT bool operator<(const QString &s1, const QString &s2) noexcept;
     friend inline bool operator>(const QString &s1, const QString &s2) noexcept { return s2 < s1; }
@@ -1494,7 +1514,7 @@ inline QString &&asString(QString &&s)              { return std::move(s); }
 namespace QtPrivate {
 
 struct ArgBase {
-    enum Tag : uchar { L1, U8, U16 } tag;
+    enum Tag : uchar { L1, U8, U16, Integer, UnsignedInteger, Double } tag;
 };
 
 struct QStringViewArg : ArgBase {
@@ -1509,6 +1529,21 @@ struct QLatin1StringArg : ArgBase {
     constexpr explicit QLatin1StringArg(QLatin1String v) noexcept : ArgBase{L1}, string{v} {}
 };
 
+struct QIntegerArg : ArgBase {
+    qlonglong value;
+    constexpr explicit QIntegerArg(qlonglong v) noexcept : ArgBase{Integer}, value{v} {}
+};
+
+struct QUnsignedIntegerArg : ArgBase {
+    qulonglong value;
+    constexpr explicit QUnsignedIntegerArg(qulonglong v) noexcept : ArgBase{UnsignedInteger}, value{v} {}
+};
+
+struct QDoubleArg : ArgBase {
+    double value;
+    constexpr explicit QDoubleArg(double v) noexcept : ArgBase{Double}, value{v} {}
+};
+
 [[nodiscard]] Q_CORE_EXPORT QString argToQString(QStringView pattern, size_t n, const ArgBase **args);
 [[nodiscard]] Q_CORE_EXPORT QString argToQString(QLatin1String pattern, size_t n, const ArgBase **args);
 
@@ -1524,6 +1559,49 @@ constexpr inline QStringViewArg   qStringLikeToArg(QStringView s) noexcept { ret
           inline QStringViewArg   qStringLikeToArg(const QChar &c) noexcept { return QStringViewArg{QStringView{&c, 1}}; }
 constexpr inline QLatin1StringArg qStringLikeToArg(QLatin1String s) noexcept { return QLatin1StringArg{s}; }
 
+Q_CORE_EXPORT void appendArgs(QString &out, QStringView pattern, size_t n, const ArgBase **args);
+Q_CORE_EXPORT void appendArgs(QString &out, QLatin1String pattern, size_t n, const ArgBase **args);
+Q_CORE_EXPORT void appendArgs(QByteArray &out, QLatin1String pattern, size_t n, const ArgBase **args);
+
+template <typename Output, typename StringView, typename...Args>
+Q_ALWAYS_INLINE void appendArgsDispatch(Output &out, StringView pattern, const Args &...args)
+{
+    const ArgBase *argBases[] = {&args..., /* avoid zero-sized array */ nullptr};
+    QtPrivate::appendArgs(out, pattern, sizeof...(Args), argBases);
+}
+
+template <typename T>
+struct IsFormatInteger
+    : std::integral_constant<bool,
+        std::is_integral<T>::value &&
+        !std::is_same<T, bool>::value &&
+        !std::is_same<T, char>::value &&
+        !std::is_same<T, char16_t>::value &&
+        !std::is_same<T, char32_t>::value &&
+        !std::is_same<T, wchar_t>::value> {};
+
+          inline QStringViewArg   qFormatToArg(const QString &s) noexcept { return qStringLikeToArg(s); }
+constexpr inline QStringViewArg   qFormatToArg(QStringView s) noexcept { return qStringLikeToArg(s); }
+          inline QStringViewArg   qFormatToArg(const QChar &c) noexcept { return qStringLikeToArg(c); }
+constexpr inline QLatin1StringArg qFormatToArg(QLatin1String s) noexcept { return qStringLikeToArg(s); }
+          inline QLatin1StringArg qFormatToArg(const char &c) noexcept { return QLatin1StringArg{QLatin1String(&c, 1)}; }
+constexpr inline QDoubleArg       qFormatToArg(double d) noexcept { return QDoubleArg{d}; }
+constexpr inline QDoubleArg       qFormatToArg(float f) noexcept { return QDoubleArg{f}; }
+
+template <typename T, typename std::enable_if<IsFormatInteger<T>::value && std::is_signed<T>::value, bool>::type = true>
+constexpr inline QIntegerArg qFormatToArg(T i) noexcept { return QIntegerArg{i}; }
+template <typename T, typename std::enable_if<IsFormatInteger<T>::value && std::is_unsigned<T>::value, bool>::type = true>
+constexpr inline QUnsignedIntegerArg qFormatToArg(T i) noexcept { return QUnsignedIntegerArg{i}; }
+
+template <typename...Args>
+struct ByteArrayArgsAppender
+{
+    static Q_ALWAYS_INLINE void append(QByteArray &out, QLatin1String format, const Args &...args)
+    {
+        appendArgsDispatch(out, format, qFormatToArg(args)...);
+    }
+};
+
 } // namespace QtPrivate
 
 template <typename...Args>
@@ -1540,6 +1618,22 @@ QString QLatin1String::arg(Args &&...args) const
     return QtPrivate::argToQStringDispatch(*this, QtPrivate::qStringLikeToArg(args)...);
 }
 
+template <typename...Args>
+Q_ALWAYS_INLINE
+QString &QString::appendArgs(QStringView format, const Args &...args)
+{
+    QtPrivate::appendArgsDispatch(*this, format, QtPrivate::qFormatToArg(args)...);
+    return *this;
+}
+
+template <typename...Args>
+Q_ALWAYS_INLINE
+QString &QString::appendArgs(QLatin1String format, const Args &...args)
+{
+    QtPrivate::appendArgsDispatch(*this, format, QtPrivate::qFormatToArg(args)...);
+    return *this;
+}
+
 QT_END_NAMESPACE
 
 #if defined(QT_USE_FAST_OPERATOR_PLUS) || defined(QT_USE_QSTRINGBUILDER)
@@ -482,6 +482,350 @@ static void simdCompareAscii(const char8_t *&, const char8_t *, const char16_t *
 }
 #endif
 
+// Shuffle tables for the multi-byte transcoders below. They are indexed by a
+// bitmask describing a block and move the wanted bytes to the front; an index
+// of 0x80 produces a zero.
+struct Utf16CompactTable
+{
+    // entry m keeps the 16-bit lanes whose bit is set in m
+    uchar shuffle[256][16];
+    constexpr Utf16CompactTable() : shuffle{}
+    {
+        for (int m = 0; m < 256; ++m) {
+            int out = 0;
+            for (int lane = 0; lane < 8; ++lane) {
+                if (m & (1 << lane)) {
+                    shuffle[m][out++] = uchar(2 * lane);
+                    shuffle[m][out++] = uchar(2 * lane + 1);
+                }
+            }
+            while (out < 16)
+                shuffle[m][out++] = 0x80;
+        }
+    }
+};
+
+struct Utf8CompactTable
+{
+    // entry m packs four 32-bit lanes holding 1, 2 or 3 bytes of UTF-8 each;
+    // bits 2k and 2k+1 of m contain the length minus one of lane k
+    uchar shuffle[256][16];
+    uchar length[256];
+    constexpr Utf8CompactTable() : shuffle{}, length{}
+    {
+        for (int m = 0; m < 256; ++m) {
+            int out = 0;
+            for (int lane = 0; lane < 4; ++lane) {
+                int len = ((m >> (2 * lane)) & 3) + 1;
+                for (int i = 0; i < len && i < 3; ++i)
+                    shuffle[m][out++] = uchar(4 * lane + i);
+            }
+            length[m] = uchar(out);
+            while (out < 16)
+                shuffle[m][out++] = 0x80;
+        }
+    }
+};
+
+[[maybe_unused]] static constexpr Utf16CompactTable utf16CompactTable;
+[[maybe_unused]] static constexpr Utf8CompactTable utf8CompactTable;
+
+// spreads the four bits of a lane mask so that bit k ends up in bit 2k
+[[maybe_unused]] static constexpr uchar utf8LengthSpread[16] = {
+    0x00, 0x01, 0x04, 0x05, 0x10, 0x11, 0x14, 0x15,
+    0x40, 0x41, 0x44, 0x45, 0x50, 0x51, 0x54, 0x55
+};
+
+/*
+    The multi-byte transcoders handle text consisting of one, two and three
+    byte UTF-8 sequences (i.e., everything in the BMP except surrogates) in
+    blocks of 16 bytes or 8 code units. They stop at the first block that
+    contains anything else -- four-byte sequences, surrogates, malformed input
+    or pure ASCII -- and leave it to the scalar and ASCII paths, which take
+    care of the error handling. Both return true if they made progress.
+
+    The decoder needs 17 readable bytes (it peeks at the byte following the
+    block), writes at most 16 bytes past dst and consumes only complete
+    characters, so a caller whose output buffer holds one UTF-16 code unit per
+    input byte is safe. The encoder converts eight code units at a time while
+    at least ten remain, so its 16-byte stores stay within the usual three
+    bytes per code unit.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(SSE4_1)
+QT_FUNCTION_TARGET(SSE4_1)
+static inline __m128i utf8DecodeHalf_sse4(__m128i bytes, __m128i prev1, __m128i prev2,
+                                          __m128i is2, __m128i is3)
+{
+    const __m128i c = _mm_cvtepu8_epi16(bytes);
+    const __m128i p1 = _mm_cvtepu8_epi16(prev1);
+    const __m128i p2 = _mm_cvtepu8_epi16(prev2);
+    const __m128i low6 = _mm_and_si128(c, _mm_set1_epi16(0x3f));
+    const __m128i mid6 = _mm_slli_epi16(_mm_and_si128(p1, _mm_set1_epi16(0x3f)), 6);
+
+    // the shift of p2 by 12 discards the 0xE0 marker of the leading byte
+    const __m128i v2 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(p1, _mm_set1_epi16(0x1f)), 6), low6);
+    const __m128i v3 = _mm_or_si128(_mm_slli_epi16(p2, 12), _mm_or_si128(mid6, low6));
+
+    __m128i value = _mm_blendv_epi8(c, v2, _mm_cvtepi8_epi16(is2));
+    return _mm_blendv_epi8(value, v3, _mm_cvtepi8_epi16(is3));
+}
+
+QT_FUNCTION_TARGET(SSE4_1)
+static bool simdDecodeMultiByte_sse4(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const uchar *const start = src;
+    while (end - src >= 17) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+        const __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 1));
+        if (_mm_movemask_epi8(bytes) == 0)
+            break;
+
+        const __m128i isCont = _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(char(0xc0))),
+                                              _mm_set1_epi8(char(0x80)));
+        const __m128i nextIsCont = _mm_cmpeq_epi8(_mm_and_si128(next, _mm_set1_epi8(char(0xc0))),
+                                                  _mm_set1_epi8(char(0x80)));
+        const __m128i isLead2 = _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(char(0xe0))),
+                                               _mm_set1_epi8(char(0xc0)));
+        const __m128i isLead3 = _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(char(0xf0))),
+                                               _mm_set1_epi8(char(0xe0)));
+
+        // every leading byte must be followed by exactly the right number of
+        // continuation bytes, and every continuation byte must be expected;
+        // checking the following bytes as well covers the byte after the block
+        const __m128i isLead = _mm_or_si128(isLead2, isLead3);
+        const __m128i expected = _mm_or_si128(_mm_slli_si128(isLead, 1), _mm_slli_si128(isLead3, 2));
+        const __m128i nextExpected = _mm_or_si128(isLead, _mm_slli_si128(isLead3, 1));
+        __m128i error = _mm_or_si128(_mm_xor_si128(isCont, expected), _mm_xor_si128(nextIsCont, nextExpected));
+
+        // four-byte sequences, invalid bytes and overlong two-byte sequences
+        error = _mm_or_si128(error, _mm_cmpeq_epi8(_mm_max_epu8(bytes, _mm_set1_epi8(char(0xf0))), bytes));
+        error = _mm_or_si128(error, _mm_cmpeq_epi8(_mm_and_si128(bytes, _mm_set1_epi8(char(0xfe))),
+                                                   _mm_set1_epi8(char(0xc0))));
+
+        // overlong three-byte sequences (E0 followed by less than A0) and
+        // surrogates (ED followed by A0 or more)
+        const __m128i nextBelowA0 = _mm_cmpeq_epi8(_mm_min_epu8(next, _mm_set1_epi8(char(0x9f))), next);
+        error = _mm_or_si128(error, _mm_and_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(char(0xe0))), nextBelowA0));
+        error = _mm_or_si128(error, _mm_andnot_si128(nextBelowA0, _mm_cmpeq_epi8(bytes, _mm_set1_epi8(char(0xed)))));
+        if (!_mm_testz_si128(error, error))
+            break;
+
+        // a character ends where the following byte does not continue it
+        const uint ends = ~uint(_mm_movemask_epi8(nextIsCont)) & 0xffff;
+        if (!ends)
+            break;
+
+        const __m128i prev1 = _mm_slli_si128(bytes, 1);
+        const __m128i prev2 = _mm_slli_si128(bytes, 2);
+        const __m128i is2 = _mm_slli_si128(isLead2, 1);
+        const __m128i is3 = _mm_slli_si128(isLead3, 2);
+
+        const __m128i lo = utf8DecodeHalf_sse4(bytes, prev1, prev2, is2, is3);
+        const __m128i hi = utf8DecodeHalf_sse4(_mm_srli_si128(bytes, 8), _mm_srli_si128(prev1, 8),
+                                               _mm_srli_si128(prev2, 8), _mm_srli_si128(is2, 8),
+                                               _mm_srli_si128(is3, 8));
+
+        const uint loEnds = ends & 0xff;
+        const uint hiEnds = ends >> 8;
+        const __m128i loShuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16CompactTable.shuffle[loEnds]));
+        const __m128i hiShuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16CompactTable.shuffle[hiEnds]));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(lo, loShuffle));
+        dst += qPopulationCount(loEnds);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(hi, hiShuffle));
+        dst += qPopulationCount(hiEnds);
+        src += 32 - qCountLeadingZeroBits(ends);
+    }
+    return src != start;
+}
+
+QT_FUNCTION_TARGET(SSE4_1)
+static inline void utf8EncodeQuad_sse4(uchar *&dst, __m128i units)
+{
+    const __m128i u = _mm_cvtepu16_epi32(units);
+    const __m128i is2 = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7f));
+    const __m128i is3 = _mm_cmpgt_epi32(u, _mm_set1_epi32(0x7ff));
+
+    const __m128i cont = _mm_set1_epi32(0x80);
+    const __m128i low6 = _mm_or_si128(_mm_and_si128(u, _mm_set1_epi32(0x3f)), cont);
+    const __m128i mid6 = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(u, 6), _mm_set1_epi32(0x3f)), cont);
+    const __m128i lead2 = _mm_or_si128(_mm_srli_epi32(u, 6), _mm_set1_epi32(0xc0));
+    const __m128i lead3 = _mm_or_si128(_mm_srli_epi32(u, 12), _mm_set1_epi32(0xe0));
+
+    // each lane holds its UTF-8 bytes in memory order
+    const __m128i enc2 = _mm_or_si128(lead2, _mm_slli_epi32(low6, 8));
+    const __m128i enc3 = _mm_or_si128(lead3, _mm_or_si128(_mm_slli_epi32(mid6, 8), _mm_slli_epi32(low6, 16)));
+    __m128i enc = _mm_blendv_epi8(u, enc2, is2);
+    enc = _mm_blendv_epi8(enc, enc3, is3);
+
+    const uint index = utf8LengthSpread[_mm_movemask_ps(_mm_castsi128_ps(is2))]
+            + utf8LengthSpread[_mm_movemask_ps(_mm_castsi128_ps(is3))];
+    const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8CompactTable.shuffle[index]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_shuffle_epi8(enc, shuffle));
+    dst += utf8CompactTable.length[index];
+}
+
+QT_FUNCTION_TARGET(SSE4_1)
+static bool simdEncodeMultiByte_sse4(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    const ushort *const start = src;
+    for ( ; end - src >= 10; src += 8) {
+        const __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+
+        // leave ASCII to simdEncodeAscii and surrogates to the scalar code
+        const __m128i nonAscii = _mm_and_si128(units, _mm_set1_epi16(short(0xff80)));
+        const __m128i surrogate = _mm_cmpeq_epi16(_mm_and_si128(units, _mm_set1_epi16(short(0xf800))),
+                                                  _mm_set1_epi16(short(0xd800)));
+        if (_mm_testz_si128(nonAscii, nonAscii) || !_mm_testz_si128(surrogate, surrogate))
+            break;
+
+        utf8EncodeQuad_sse4(dst, units);
+        utf8EncodeQuad_sse4(dst, _mm_srli_si128(units, 8));
+    }
+    return src != start;
+}
+
+static inline bool simdDecodeMultiByte(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    return qCpuHasFeature(SSE4_1) && simdDecodeMultiByte_sse4(dst, src, end);
+}
+
+static inline bool simdEncodeMultiByte(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    return qCpuHasFeature(SSE4_1) && simdEncodeMultiByte_sse4(dst, src, end);
+}
+#elif defined(__ARM_NEON__) && defined(Q_PROCESSOR_ARM_64) // vaddv and vqtbl1q are only available on Aarch64
+static inline uint neonMoveMask(uint8x16_t v)
+{
+    const uint8x8_t weights = { 1, 1 << 1, 1 << 2, 1 << 3, 1 << 4, 1 << 5, 1 << 6, 1 << 7 };
+    return vaddv_u8(vand_u8(vget_low_u8(v), weights))
+            | (uint(vaddv_u8(vand_u8(vget_high_u8(v), weights))) << 8);
+}
+
+// shifts the bytes of v towards the end of the block, filling with zeroes
+template <int N> static inline uint8x16_t neonShiftBytesUp(uint8x16_t v)
+{
+    return vextq_u8(vdupq_n_u8(0), v, 16 - N);
+}
+
+static inline uint16x8_t utf8DecodeHalf_neon(uint8x8_t bytes, uint8x8_t prev1, uint8x8_t prev2,
+                                             uint8x8_t is2, uint8x8_t is3)
+{
+    const uint16x8_t c = vmovl_u8(bytes);
+    const uint16x8_t p1 = vmovl_u8(prev1);
+    const uint16x8_t p2 = vmovl_u8(prev2);
+    const uint16x8_t low6 = vandq_u16(c, vdupq_n_u16(0x3f));
+    const uint16x8_t mid6 = vshlq_n_u16(vandq_u16(p1, vdupq_n_u16(0x3f)), 6);
+
+    // the shift of p2 by 12 discards the 0xE0 marker of the leading byte
+    const uint16x8_t v2 = vorrq_u16(vshlq_n_u16(vandq_u16(p1, vdupq_n_u16(0x1f)), 6), low6);
+    const uint16x8_t v3 = vorrq_u16(vshlq_n_u16(p2, 12), vorrq_u16(mid6, low6));
+
+    const uint16x8_t value = vbslq_u16(vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(is2))), v2, c);
+    return vbslq_u16(vreinterpretq_u16_s16(vmovl_s8(vreinterpret_s8_u8(is3))), v3, value);
+}
+
+static inline bool simdDecodeMultiByte(ushort *&dst, const uchar *&src, const uchar *end)
+{
+    const uchar *const start = src;
+    while (end - src >= 17) {
+        const uint8x16_t bytes = vld1q_u8(src);
+        const uint8x16_t next = vld1q_u8(src + 1);
+        if (vmaxvq_u8(bytes) < 0x80)
+            break;
+
+        const uint8x16_t isCont = vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80));
+        const uint8x16_t isLead2 = vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xe0)), vdupq_n_u8(0xc0));
+        const uint8x16_t isLead3 = vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xf0)), vdupq_n_u8(0xe0));
+        const uint8x16_t nextIsCont = vceqq_u8(vandq_u8(next, vdupq_n_u8(0xc0)), vdupq_n_u8(0x80));
+        const uint8x16_t isLead = vorrq_u8(isLead2, isLead3);
+        const uint8x16_t is2 = neonShiftBytesUp<1>(isLead2);
+        const uint8x16_t is3 = neonShiftBytesUp<2>(isLead3);
+
+        // see simdDecodeMultiByte_sse4 for the individual checks
+        const uint8x16_t expected = vorrq_u8(neonShiftBytesUp<1>(isLead), is3);
+        const uint8x16_t nextExpected = vorrq_u8(isLead, neonShiftBytesUp<1>(isLead3));
+        uint8x16_t error = vorrq_u8(veorq_u8(isCont, expected), veorq_u8(nextIsCont, nextExpected));
+        error = vorrq_u8(error, vcgeq_u8(bytes, vdupq_n_u8(0xf0)));
+        error = vorrq_u8(error, vceqq_u8(vandq_u8(bytes, vdupq_n_u8(0xfe)), vdupq_n_u8(0xc0)));
+        const uint8x16_t nextBelowA0 = vcltq_u8(next, vdupq_n_u8(0xa0));
+        error = vorrq_u8(error, vandq_u8(vceqq_u8(bytes, vdupq_n_u8(0xe0)), nextBelowA0));
+        error = vorrq_u8(error, vbicq_u8(vceqq_u8(bytes, vdupq_n_u8(0xed)), nextBelowA0));
+        if (vmaxvq_u8(error))
+            break;
+
+        const uint ends = ~neonMoveMask(nextIsCont) & 0xffff;
+        if (!ends)
+            break;
+
+        const uint8x16_t prev1 = neonShiftBytesUp<1>(bytes);
+        const uint8x16_t prev2 = neonShiftBytesUp<2>(bytes);
+        const uint16x8_t lo = utf8DecodeHalf_neon(vget_low_u8(bytes), vget_low_u8(prev1), vget_low_u8(prev2),
+                                                  vget_low_u8(is2), vget_low_u8(is3));
+        const uint16x8_t hi = utf8DecodeHalf_neon(vget_high_u8(bytes), vget_high_u8(prev1), vget_high_u8(prev2),
+                                                  vget_high_u8(is2), vget_high_u8(is3));
+
+        const uint loEnds = ends & 0xff;
+        const uint hiEnds = ends >> 8;
+        vst1q_u8(reinterpret_cast<uchar *>(dst),
+                 vqtbl1q_u8(vreinterpretq_u8_u16(lo), vld1q_u8(utf16CompactTable.shuffle[loEnds])));
+        dst += qPopulationCount(loEnds);
+        vst1q_u8(reinterpret_cast<uchar *>(dst),
+                 vqtbl1q_u8(vreinterpretq_u8_u16(hi), vld1q_u8(utf16CompactTable.shuffle[hiEnds])));
+        dst += qPopulationCount(hiEnds);
+        src += 32 - qCountLeadingZeroBits(ends);
+    }
+    return src != start;
+}
+
+static inline void utf8EncodeQuad_neon(uchar *&dst, uint16x4_t units)
+{
+    const uint32x4_t u = vmovl_u16(units);
+    const uint32x4_t is2 = vcgtq_u32(u, vdupq_n_u32(0x7f));
+    const uint32x4_t is3 = vcgtq_u32(u, vdupq_n_u32(0x7ff));
+
+    const uint32x4_t cont = vdupq_n_u32(0x80);
+    const uint32x4_t low6 = vorrq_u32(vandq_u32(u, vdupq_n_u32(0x3f)), cont);
+    const uint32x4_t mid6 = vorrq_u32(vandq_u32(vshrq_n_u32(u, 6), vdupq_n_u32(0x3f)), cont);
+    const uint32x4_t lead2 = vorrq_u32(vshrq_n_u32(u, 6), vdupq_n_u32(0xc0));
+    const uint32x4_t lead3 = vorrq_u32(vshrq_n_u32(u, 12), vdupq_n_u32(0xe0));
+
+    const uint32x4_t enc2 = vorrq_u32(lead2, vshlq_n_u32(low6, 8));
+    const uint32x4_t enc3 = vorrq_u32(lead3, vorrq_u32(vshlq_n_u32(mid6, 8), vshlq_n_u32(low6, 16)));
+    const uint32x4_t enc = vbslq_u32(is3, enc3, vbslq_u32(is2, enc2, u));
+
+    const uint32x4_t weights = { 1, 1 << 1, 1 << 2, 1 << 3 };
+    const uint index = utf8LengthSpread[vaddvq_u32(vandq_u32(is2, weights))]
+            + utf8LengthSpread[vaddvq_u32(vandq_u32(is3, weights))];
+    vst1q_u8(dst, vqtbl1q_u8(vreinterpretq_u8_u32(enc), vld1q_u8(utf8CompactTable.shuffle[index])));
+    dst += utf8CompactTable.length[index];
+}
+
+static inline bool simdEncodeMultiByte(uchar *&dst, const ushort *&src, const ushort *end)
+{
+    const ushort *const start = src;
+    for ( ; end - src >= 10; src += 8) {
+        const uint16x8_t units = vld1q_u16(src);
+        const uint16x8_t surrogate = vceqq_u16(vandq_u16(units, vdupq_n_u16(0xf800)), vdupq_n_u16(0xd800));
+        if (vmaxvq_u16(units) < 0x80 || vmaxvq_u16(surrogate))
+            break;
+
+        utf8EncodeQuad_neon(dst, vget_low_u16(units));
+        utf8EncodeQuad_neon(dst, vget_high_u16(units));
+    }
+    return src != start;
+}
+#else
+static inline bool simdDecodeMultiByte(ushort *&, const uchar *&, const uchar *)
+{
+    return false;
+}
+
+static inline bool simdEncodeMultiByte(uchar *&, const ushort *&, const ushort *)
+{
+    return false;
+}
+#endif
+
 enum { HeaderDone = 1 };
 
 QByteArray QUtf8::convertFromUnicode(QStringView in)
@@ -498,6 +842,8 @@ QByteArray QUtf8::convertFromUnicode(QStringView in)
         const ushort *nextAscii = end;
         if (simdEncodeAscii(dst, nextAscii, src, end))
             break;
+        if (simdEncodeMultiByte(dst, src, end))
+            continue;
 
         do {
             ushort u = *src++;
@@ -565,6 +911,8 @@ char *QUtf8::convertFromUnicode(char *out, QStringView in, QStringConverter::Sta
         const ushort *nextAscii = end;
         if (simdEncodeAscii(cursor, nextAscii, src, end))
             break;
+        if (simdEncodeMultiByte(cursor, src, end))
+            continue;
 
         do {
             ushort uc = *src++;
@@ -652,6 +1000,8 @@ QChar *QUtf8::convertToUnicode(QChar *buffer, QByteArrayView in) noexcept
             nextAscii = end;
             if (simdDecodeAscii(dst, nextAscii, src, end))
                 break;
+            if (simdDecodeMultiByte(dst, src, end))
+                continue;
 
             do {
                 uchar b = *src++;
@@ -754,8 +1104,14 @@ QChar *QUtf8::convertToUnicode(QChar *out, QByteArrayView in, QStringConverter::
     res = 0;
     const uchar *nextAscii = src;
     while (res >= 0 && src < end) {
-        if (src >= nextAscii && simdDecodeAscii(dst, nextAscii, src, end))
-            break;
+        if (src >= nextAscii) {
+            if (simdDecodeAscii(dst, nextAscii, src, end))
+                break;
+            if (simdDecodeMultiByte(dst, src, end)) {
+                nextAscii = src;
+                continue;
+            }
+        }
 
         ch = *src++;
         res = QUtf8Functions::fromUtf8<QUtf8BaseTraits>(ch, dst, src, end);
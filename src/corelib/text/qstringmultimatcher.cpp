@@ -0,0 +1,573 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qstringmultimatcher.h"
+
+#include <QtCore/qvarlengtharray.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// Aho-Corasick automaton over 16-bit code units (UTF-16 code units, or bytes
+// for the UTF-8 variant). Code units are first mapped to character classes,
+// so that the transition table only has as many columns as there are
+// distinct units in the patterns. Case-insensitive matching is handled when
+// building the class table, by giving every unit the class of its folded
+// form; scanning never needs to fold the haystack.
+struct MultiMatcherAutomaton
+{
+    // maximum size of the dense transition table, in entries; larger
+    // automata keep the sparse trie and follow failure links instead
+    enum : qsizetype { DenseLimit = 1 << 20 };
+
+    using FoldFunction = char16_t (*)(char16_t);
+
+    QList<qint32> classTable;       // 256 entries per page; page 0 is all zeroes
+    qint32 pageOffset[256] = {};
+    qint32 classCount = 1;          // class 0: unit doesn't occur in any pattern
+
+    QList<qint32> transitions;      // dense: [state * classCount + class]
+    QList<qint32> childStart;       // sparse: children of state s are at
+    QList<qint32> childClass;       //   [childStart[s], childStart[s + 1])
+    QList<qint32> childState;
+    QList<qint32> failure;
+
+    QList<qint32> outputStart;      // outputs of state s are at
+    QList<qint32> outputs;          //   [outputStart[s], outputStart[s + 1])
+    QList<qsizetype> lengths;       // length of each pattern, in code units
+
+    void build(const QList<std::u16string> &patterns, FoldFunction fold, char16_t maxUnit);
+
+    qint32 classOf(char16_t u) const
+    {
+        return classTable.constData()[pageOffset[u >> 8] + (u & 0xff)];
+    }
+
+    qint32 child(qint32 state, qint32 cls) const
+    {
+        const qint32 *begin = childClass.constData() + childStart.at(state);
+        const qint32 *end = childClass.constData() + childStart.at(state + 1);
+        const qint32 *it = std::lower_bound(begin, end, cls);
+        if (it != end && *it == cls)
+            return childState.at(it - childClass.constData());
+        return -1;
+    }
+
+    // Calls \a report(patternIndex, endOffset) for each match, in order of
+    // the end offset, until it returns false.
+    template <typename Unit, typename Report>
+    void scan(const Unit *begin, const Unit *end, Report report) const
+    {
+        const qint32 *out = outputStart.constData();
+        qint32 state = 0;
+        if (!transitions.isEmpty()) {
+            const qint32 *table = transitions.constData();
+            for (const Unit *p = begin; p != end; ++p) {
+                state = table[state * classCount + classOf(*p)];
+                if (Q_UNLIKELY(out[state] != out[state + 1])) {
+                    for (qint32 i = out[state]; i != out[state + 1]; ++i) {
+                        if (!report(outputs.at(i), p - begin + 1))
+                            return;
+                    }
+                }
+            }
+            return;
+        }
+
+        for (const Unit *p = begin; p != end; ++p) {
+            const qint32 cls = classOf(*p);
+            if (!cls) {
+                state = 0;
+                continue;
+            }
+            for (;;) {
+                const qint32 next = child(state, cls);
+                if (next >= 0) {
+                    state = next;
+                    break;
+                }
+                if (!state)
+                    break;
+                state = failure.at(state);
+            }
+            for (qint32 i = out[state]; i != out[state + 1]; ++i) {
+                if (!report(outputs.at(i), p - begin + 1))
+                    return;
+            }
+        }
+    }
+};
+
+void MultiMatcherAutomaton::build(const QList<std::u16string> &patterns, FoldFunction fold,
+                                  char16_t maxUnit)
+{
+    // assign character classes
+    std::vector<qint32> classes(size_t(maxUnit) + 1, 0);
+    for (const std::u16string &pattern : patterns) {
+        for (char16_t u : pattern) {
+            if (!classes[u])
+                classes[u] = classCount++;
+        }
+    }
+    if (fold) {
+        for (size_t u = 0; u < classes.size(); ++u) {
+            if (!classes[u])
+                classes[u] = classes[fold(char16_t(u))];
+        }
+    }
+
+    classTable.fill(0, 256);
+    for (size_t page = 0; page * 256 < classes.size(); ++page) {
+        const auto first = classes.cbegin() + page * 256;
+        if (std::all_of(first, first + 256, [](qint32 c) { return c == 0; }))
+            continue;
+        pageOffset[page] = classTable.size();
+        classTable.append(QList<qint32>(first, first + 256));
+    }
+
+    // build the trie
+    struct Node
+    {
+        QVarLengthArray<std::pair<qint32, qint32>, 2> children; // (class, state), sorted
+        QVarLengthArray<qint32, 1> own;                          // patterns ending here
+        qint32 failure = 0;
+    };
+    std::vector<Node> nodes(1);
+    lengths.resize(patterns.size());
+    for (qsizetype i = 0; i < patterns.size(); ++i) {
+        const std::u16string &pattern = patterns.at(i);
+        lengths[i] = qsizetype(pattern.size());
+        if (pattern.empty())
+            continue;               // empty patterns never match
+
+        qint32 state = 0;
+        for (char16_t u : pattern) {
+            const qint32 cls = classes[u];
+            auto &children = nodes[state].children;
+            auto it = std::lower_bound(children.begin(), children.end(), cls,
+                                       [](const auto &c, qint32 v) { return c.first < v; });
+            if (it != children.end() && it->first == cls) {
+                state = it->second;
+            } else {
+                const qint32 next = qint32(nodes.size());
+                children.insert(it, { cls, next });
+                nodes.emplace_back();
+                state = next;
+            }
+        }
+        nodes[state].own.append(qint32(i));
+    }
+
+    auto findChild = [&nodes](qint32 state, qint32 cls) {
+        const auto &children = nodes[state].children;
+        auto it = std::lower_bound(children.begin(), children.end(), cls,
+                                   [](const auto &c, qint32 v) { return c.first < v; });
+        return it != children.end() && it->first == cls ? it->second : -1;
+    };
+
+    // compute failure links in breadth-first order
+    std::vector<qint32> order;
+    order.reserve(nodes.size());
+    order.push_back(0);
+    for (size_t i = 0; i < order.size(); ++i) {
+        const qint32 state = order[i];
+        for (const auto &[cls, next] : nodes[state].children) {
+            qint32 f = 0;
+            if (state != 0) {
+                f = nodes[state].failure;
+                while (f && findChild(f, cls) < 0)
+                    f = nodes[f].failure;
+                const qint32 target = findChild(f, cls);
+                f = target >= 0 ? target : 0;
+            }
+            nodes[next].failure = f;
+            order.push_back(next);
+        }
+    }
+
+    // outputs: the state's own patterns (longest), then those of its failure
+    // state (shorter suffixes), already complete thanks to the BFS order
+    const qsizetype stateCount = qsizetype(nodes.size());
+    std::vector<QVarLengthArray<qint32, 1>> stateOutputs(nodes.size());
+    for (qint32 state : order) {
+        stateOutputs[state] = nodes[state].own;
+        if (state)
+            stateOutputs[state].append(stateOutputs[nodes[state].failure].constData(),
+                                       stateOutputs[nodes[state].failure].size());
+    }
+    outputStart.reserve(stateCount + 1);
+    for (const auto &out : stateOutputs) {
+        outputStart.append(qint32(outputs.size()));
+        outputs.append(QList<qint32>(out.cbegin(), out.cend()));
+    }
+    outputStart.append(qint32(outputs.size()));
+
+    if (stateCount * classCount <= DenseLimit) {
+        transitions.resize(stateCount * classCount);
+        for (qint32 state : order) {
+            qint32 *row = transitions.data() + state * classCount;
+            const qint32 *failureRow = transitions.constData() + nodes[state].failure * classCount;
+            for (qint32 cls = 0; cls < classCount; ++cls) {
+                const qint32 next = findChild(state, cls);
+                row[cls] = next >= 0 ? next : state ? failureRow[cls] : 0;
+            }
+        }
+        return;
+    }
+
+    childStart.reserve(stateCount + 1);
+    failure.reserve(stateCount);
+    for (const Node &node : nodes) {
+        childStart.append(qint32(childClass.size()));
+        for (const auto &[cls, next] : node.children) {
+            childClass.append(cls);
+            childState.append(next);
+        }
+        failure.append(node.failure);
+    }
+    childStart.append(qint32(childClass.size()));
+}
+
+char16_t foldUtf16(char16_t u)
+{
+    if (QChar::isSurrogate(u))
+        return u;
+    const char32_t folded = QChar::toCaseFolded(char32_t(u));
+    return folded > 0xffff ? u : char16_t(folded);
+}
+
+char16_t foldAscii(char16_t u)
+{
+    return u >= 'A' && u <= 'Z' ? char16_t(u | 0x20) : u;
+}
+} // unnamed namespace
+
+class QStringMultiMatcherPrivate : public QSharedData
+{
+public:
+    QStringMultiMatcherPrivate(const QStringList &patterns, Qt::CaseSensitivity cs);
+
+    QStringList patterns;
+    Qt::CaseSensitivity cs;
+    MultiMatcherAutomaton utf16;
+    MultiMatcherAutomaton utf8;
+};
+
+QStringMultiMatcherPrivate::QStringMultiMatcherPrivate(const QStringList &patterns,
+                                                       Qt::CaseSensitivity cs)
+    : patterns(patterns), cs(cs)
+{
+    const bool fold = cs == Qt::CaseInsensitive;
+    QList<std::u16string> units;
+    QList<std::u16string> bytes;
+    units.reserve(patterns.size());
+    bytes.reserve(patterns.size());
+    for (const QString &pattern : patterns) {
+        std::u16string u(QStringView(pattern).utf16(), size_t(pattern.size()));
+        if (fold)
+            std::transform(u.begin(), u.end(), u.begin(), foldUtf16);
+        units.append(std::move(u));
+
+        const QByteArray utf8 = pattern.toUtf8();
+        std::u16string b(size_t(utf8.size()), u'\0');
+        std::transform(utf8.cbegin(), utf8.cend(), b.begin(), [fold](char c) {
+            const char16_t u = uchar(c);
+            return fold ? foldAscii(u) : u;
+        });
+        bytes.append(std::move(b));
+    }
+
+    utf16.build(units, fold ? foldUtf16 : nullptr, 0xffff);
+    utf8.build(bytes, fold ? foldAscii : nullptr, 0xff);
+}
+
+QT_DEFINE_QESDP_SPECIALIZATION_DTOR(QStringMultiMatcherPrivate)
+
+/*!
+    \class QStringMultiMatcher
+    \inmodule QtCore
+    \since 6.0
+    \brief The QStringMultiMatcher class finds occurrences of many patterns
+    in a string in a single pass.
+
+    \ingroup tools
+    \ingroup string-processing
+    \reentrant
+
+    QStringMatcher searches for one pattern at a time, so looking for every
+    keyword of a large set means scanning the text once per keyword.
+    QStringMultiMatcher instead builds an Aho-Corasick automaton out of all
+    its patterns, and finds all of their occurrences by reading each
+    character of the text only once, regardless of the number of patterns.
+
+    Create the matcher with the list of patterns, then call findAll() to get
+    every occurrence of every pattern, or findNext() to find them one at a
+    time. Each occurrence is reported as a Match, holding the index of the
+    pattern in patterns() and the offset and length of the match in the
+    searched text. Overlapping occurrences are all reported.
+
+    \snippet code/src_corelib_text_qstringmultimatcher.cpp 0
+
+    The text to search can be given as UTF-16 (QStringView) or as UTF-8
+    (QByteArrayView); the patterns are matched against the same text in either
+    encoding, and offsets and lengths are expressed in code units of the text.
+    For case-insensitive matching, UTF-16 text is compared using Unicode simple
+    case folding of the characters in the Basic Multilingual Plane, whereas
+    UTF-8 text only folds the case of US-ASCII letters.
+
+    Building the automaton takes time proportional to the total length of the
+    patterns, so QStringMultiMatcher is meant to be created once and reused.
+    It is implicitly shared and all of its const functions can be called
+    concurrently from multiple threads.
+
+    \sa QStringMatcher, QByteArrayMatcher
+*/
+
+/*!
+    \class QStringMultiMatcher::Match
+    \inmodule QtCore
+    \since 6.0
+    \brief The Match struct describes one occurrence of a pattern found by
+    QStringMultiMatcher.
+
+    \variable QStringMultiMatcher::Match::patternIndex
+    The index of the matched pattern in QStringMultiMatcher::patterns(), or -1
+    if this object does not describe a match.
+
+    \variable QStringMultiMatcher::Match::offset
+    The position of the first code unit of the occurrence in the searched text.
+
+    \variable QStringMultiMatcher::Match::length
+    The length of the occurrence, in code units of the searched text.
+*/
+
+/*!
+    \fn bool QStringMultiMatcher::Match::isValid() const
+
+    Returns \c true if this object describes an occurrence of a pattern.
+*/
+
+/*!
+    Constructs a matcher without patterns, which doesn't match anything. Call
+    setPatterns() to give it patterns to search for.
+*/
+QStringMultiMatcher::QStringMultiMatcher()
+    : QStringMultiMatcher(QStringList())
+{
+}
+
+/*!
+    Constructs a matcher that searches for any of the \a patterns, with case
+    sensitivity \a cs. Empty patterns never match.
+*/
+QStringMultiMatcher::QStringMultiMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+    : d(new QStringMultiMatcherPrivate(patterns, cs))
+{
+}
+
+/*!
+    Constructs a copy of \a other.
+*/
+QStringMultiMatcher::QStringMultiMatcher(const QStringMultiMatcher &other) = default;
+
+/*!
+    Assigns \a other to this matcher and returns a reference to this matcher.
+*/
+QStringMultiMatcher &QStringMultiMatcher::operator=(const QStringMultiMatcher &other) = default;
+
+/*!
+    \fn QStringMultiMatcher::QStringMultiMatcher(QStringMultiMatcher &&other)
+
+    Move-constructs a matcher from \a other.
+*/
+
+/*!
+    \fn QStringMultiMatcher &QStringMultiMatcher::operator=(QStringMultiMatcher &&other)
+
+    Move-assigns \a other to this matcher.
+*/
+
+/*!
+    \fn void QStringMultiMatcher::swap(QStringMultiMatcher &other)
+
+    Swaps this matcher with \a other. This operation is very fast and never
+    fails.
+*/
+
+/*!
+    Destroys the matcher.
+*/
+QStringMultiMatcher::~QStringMultiMatcher() = default;
+
+/*!
+    Sets the patterns to search for to \a patterns, keeping the current case
+    sensitivity.
+
+    \sa patterns(), setCaseSensitivity()
+*/
+void QStringMultiMatcher::setPatterns(const QStringList &patterns)
+{
+    d = new QStringMultiMatcherPrivate(patterns, d->cs);
+}
+
+/*!
+    Returns the patterns this matcher searches for. The index of a pattern in
+    this list is the one reported in Match::patternIndex.
+*/
+QStringList QStringMultiMatcher::patterns() const
+{
+    return d->patterns;
+}
+
+/*!
+    Returns the number of patterns this matcher searches for.
+*/
+qsizetype QStringMultiMatcher::patternCount() const
+{
+    return d->patterns.size();
+}
+
+/*!
+    Sets the case sensitivity of the matcher to \a cs.
+
+    \sa caseSensitivity()
+*/
+void QStringMultiMatcher::setCaseSensitivity(Qt::CaseSensitivity cs)
+{
+    if (cs != d->cs)
+        d = new QStringMultiMatcherPrivate(d->patterns, cs);
+}
+
+/*!
+    Returns the case sensitivity of the matcher.
+
+    \sa setCaseSensitivity()
+*/
+Qt::CaseSensitivity QStringMultiMatcher::caseSensitivity() const
+{
+    return d->cs;
+}
+
+template <typename Unit>
+static QList<QStringMultiMatcher::Match> findAllImpl(const MultiMatcherAutomaton &automaton,
+                                                     const Unit *begin, const Unit *end)
+{
+    QList<QStringMultiMatcher::Match> result;
+    automaton.scan(begin, end, [&](qint32 pattern, qsizetype endOffset) {
+        const qsizetype length = automaton.lengths.at(pattern);
+        result.append({ pattern, endOffset - length, length });
+        return true;
+    });
+    return result;
+}
+
+template <typename Unit>
+static QStringMultiMatcher::Match findNextImpl(const MultiMatcherAutomaton &automaton,
+                                               const Unit *begin, qsizetype size, qsizetype from)
+{
+    if (from < 0)
+        from = qMax(from + size, qsizetype(0));
+    QStringMultiMatcher::Match result;
+    if (from >= size)
+        return result;
+    automaton.scan(begin + from, begin + size, [&](qint32 pattern, qsizetype endOffset) {
+        result.patternIndex = pattern;
+        result.length = automaton.lengths.at(pattern);
+        result.offset = from + endOffset - result.length;
+        return false;
+    });
+    return result;
+}
+
+/*!
+    Returns all occurrences of the patterns in \a haystack, sorted by the
+    position where they end. When several occurrences end at the same
+    position, the longest comes first.
+
+    \sa findNext()
+*/
+QList<QStringMultiMatcher::Match> QStringMultiMatcher::findAll(QStringView haystack) const
+{
+    return findAllImpl(d->utf16, haystack.utf16(), haystack.utf16() + haystack.size());
+}
+
+/*!
+    \overload
+
+    Returns all occurrences of the patterns in the UTF-8 text \a haystack.
+    Offsets and lengths of the matches are in bytes.
+*/
+QList<QStringMultiMatcher::Match> QStringMultiMatcher::findAll(QByteArrayView haystack) const
+{
+    auto begin = reinterpret_cast<const uchar *>(haystack.data());
+    return findAllImpl(d->utf8, begin, begin + haystack.size());
+}
+
+/*!
+    Returns the first occurrence of any pattern in \a haystack that starts at
+    or after position \a from, or an invalid Match if there is none. The
+    occurrence returned is the one that ends first; if several end at the same
+    position, the longest of them is returned.
+
+    If \a from is negative, it counts from the end of \a haystack.
+
+    \sa findAll()
+*/
+QStringMultiMatcher::Match QStringMultiMatcher::findNext(QStringView haystack, qsizetype from) const
+{
+    return findNextImpl(d->utf16, haystack.utf16(), haystack.size(), from);
+}
+
+/*!
+    \overload
+
+    Returns the first occurrence of any pattern in the UTF-8 text \a haystack
+    that starts at or after the byte position \a from.
+*/
+QStringMultiMatcher::Match QStringMultiMatcher::findNext(QByteArrayView haystack, qsizetype from) const
+{
+    auto begin = reinterpret_cast<const uchar *>(haystack.data());
+    return findNextImpl(d->utf8, begin, haystack.size(), from);
+}
+
+QT_END_NAMESPACE
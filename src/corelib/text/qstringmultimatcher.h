@@ -0,0 +1,99 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSTRINGMULTIMATCHER_H
+#define QSTRINGMULTIMATCHER_H
+
+#include <QtCore/qbytearrayview.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qshareddata.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qstringview.h>
+
+QT_BEGIN_NAMESPACE
+
+
+class QStringMultiMatcherPrivate;
+QT_DECLARE_QESDP_SPECIALIZATION_DTOR_WITH_EXPORT(QStringMultiMatcherPrivate, Q_CORE_EXPORT)
+
+class Q_CORE_EXPORT QStringMultiMatcher
+{
+public:
+    struct Match
+    {
+        qsizetype patternIndex = -1;
+        qsizetype offset = -1;
+        qsizetype length = 0;
+
+        constexpr bool isValid() const noexcept { return patternIndex >= 0; }
+    };
+
+    QStringMultiMatcher();
+    explicit QStringMultiMatcher(const QStringList &patterns,
+                                 Qt::CaseSensitivity cs = Qt::CaseSensitive);
+    QStringMultiMatcher(const QStringMultiMatcher &other);
+    QStringMultiMatcher(QStringMultiMatcher &&other) noexcept = default;
+    QStringMultiMatcher &operator=(const QStringMultiMatcher &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QStringMultiMatcher)
+    ~QStringMultiMatcher();
+
+    void swap(QStringMultiMatcher &other) noexcept { d.swap(other.d); }
+
+    void setPatterns(const QStringList &patterns);
+    QStringList patterns() const;
+    qsizetype patternCount() const;
+
+    void setCaseSensitivity(Qt::CaseSensitivity cs);
+    Qt::CaseSensitivity caseSensitivity() const;
+
+    QList<Match> findAll(QStringView haystack) const;
+    QList<Match> findAll(QByteArrayView haystack) const;
+    Match findNext(QStringView haystack, qsizetype from = 0) const;
+    Match findNext(QByteArrayView haystack, qsizetype from = 0) const;
+
+private:
+    QExplicitlySharedDataPointer<QStringMultiMatcherPrivate> d;
+};
+
+Q_DECLARE_SHARED(QStringMultiMatcher)
+Q_DECLARE_TYPEINFO(QStringMultiMatcher::Match, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QSTRINGMULTIMATCHER_H
@@ -27,6 +27,7 @@ HEADERS +=  \
         text/qstringlist.h \
         text/qstringliteral.h \
         text/qstringmatcher.h \
+        text/qstringmultimatcher.h \
         text/qstringview.h \
         text/qstringtokenizer.h \
         text/qtextboundaryfinder.h \
@@ -45,6 +46,7 @@ SOURCES += \
         text/qstringbuilder.cpp \
         text/qstringconverter.cpp \
         text/qstringlist.cpp \
+        text/qstringmultimatcher.cpp \
         text/qstringview.cpp \
         text/qstringtokenizer.cpp \
         text/qtextboundaryfinder.cpp \
@@ -57,11 +57,26 @@ public:
     void run() override;
     void registerThreadInactive();
 
+    int pushLocalRunnable(QRunnable *runnable);
+    QRunnable *takeLocalRunnable();
+    QRunnable *stealLocalRunnable();
+    bool tryTakeLocalRunnable(QRunnable *runnable);
+    QList<QRunnable *> takeLocalRunnables();
+
     QWaitCondition runnableReady;
     QThreadPoolPrivate *manager;
     QRunnable *runnable;
+
+    // Runnables started from this thread in work-stealing mode. Only this
+    // thread pushes; it pops the newest while idle threads steal the oldest.
+    // The size lets both sides skip the lock while the queue is empty.
+    QMutex localMutex;
+    QList<QRunnable *> localQueue;
+    QAtomicInt localQueueSize;
 };
 
+static thread_local QThreadPoolThread *currentPoolThread = nullptr;
+
 /*
     QThreadPool private class.
 */
@@ -81,6 +96,8 @@ QThreadPoolThread::QThreadPoolThread(QThreadPoolPrivate *manager)
 */
 void QThreadPoolThread::run()
 {
+    currentPoolThread = this;
+
     QMutexLocker locker(&manager->mutex);
     for(;;) {
         QRunnable *r = runnable;
@@ -109,6 +126,13 @@ void QThreadPoolThread::run()
 
                 if (del)
                     delete r;
+
+                // run what r started locally before touching the pool's mutex again,
+                // so the local queue is always empty when this thread waits or expires
+                r = takeLocalRunnable();
+                if (r)
+                    continue;
+
                 locker.relock();
             }
 
@@ -117,7 +141,9 @@ void QThreadPoolThread::run()
                 break;
 
             if (manager->queue.isEmpty()) {
-                r = nullptr;
+                r = manager->stealRunnable(this);
+                if (r)
+                    continue;
                 break;
             }
 
@@ -136,7 +162,9 @@ void QThreadPoolThread::run()
             manager->waitingThreads.enqueue(this);
             registerThreadInactive();
             // wait for work, exiting after the expiry timeout is reached
+            manager->idleThreads.ref();
             runnableReady.wait(locker.mutex(), QDeadlineTimer(manager->expiryTimeout));
+            manager->idleThreads.deref();
             ++manager->activeThreads;
             if (manager->waitingThreads.removeOne(this))
                 expired = true;
@@ -159,6 +187,74 @@ void QThreadPoolThread::registerThreadInactive()
         manager->noActiveThreads.wakeAll();
 }
 
+/*
+    \internal
+    Called from this thread only. Returns the new size of the local queue.
+*/
+int QThreadPoolThread::pushLocalRunnable(QRunnable *runnable)
+{
+    QMutexLocker locker(&localMutex);
+    localQueue.append(runnable);
+    localQueueSize.storeRelease(localQueue.size());
+    return localQueue.size();
+}
+
+/*
+    \internal
+    Called from this thread only: takes the most recently started runnable,
+    whose data is most likely still in this core's caches.
+*/
+QRunnable *QThreadPoolThread::takeLocalRunnable()
+{
+    if (localQueueSize.loadAcquire() == 0)
+        return nullptr;
+    QMutexLocker locker(&localMutex);
+    if (localQueue.isEmpty())
+        return nullptr;
+    QRunnable *r = localQueue.takeLast();
+    localQueueSize.storeRelease(localQueue.size());
+    return r;
+}
+
+/*
+    \internal
+    Called from idle threads: takes the oldest runnable, which tends to be
+    the one that starts the largest amount of further work.
+*/
+QRunnable *QThreadPoolThread::stealLocalRunnable()
+{
+    if (localQueueSize.loadAcquire() == 0)
+        return nullptr;
+    QMutexLocker locker(&localMutex);
+    if (localQueue.isEmpty())
+        return nullptr;
+    QRunnable *r = localQueue.takeFirst();
+    localQueueSize.storeRelease(localQueue.size());
+    return r;
+}
+
+bool QThreadPoolThread::tryTakeLocalRunnable(QRunnable *runnable)
+{
+    if (localQueueSize.loadAcquire() == 0)
+        return false;
+    QMutexLocker locker(&localMutex);
+    if (!localQueue.removeOne(runnable))
+        return false;
+    localQueueSize.storeRelease(localQueue.size());
+    return true;
+}
+
+QList<QRunnable *> QThreadPoolThread::takeLocalRunnables()
+{
+    QList<QRunnable *> runnables;
+    if (localQueueSize.loadAcquire() == 0)
+        return runnables;
+    QMutexLocker locker(&localMutex);
+    runnables.swap(localQueue);
+    localQueueSize.storeRelease(0);
+    return runnables;
+}
+
 
 /*
     \internal
@@ -203,6 +299,74 @@ bool QThreadPoolPrivate::tryStart(QRunnable *task)
     return true;
 }
 
+/*
+    \internal
+    In work-stealing mode, queues \a task on the calling pool thread's local
+    queue instead of the shared one and returns \c true. Returns \c false
+    if work stealing is disabled or the caller is not one of our threads.
+    Called without holding the mutex.
+*/
+bool QThreadPoolPrivate::tryStartLocally(QRunnable *task)
+{
+    QThreadPoolThread *thread = currentPoolThread;
+    if (!thread || thread->manager != this || !workStealing.loadRelaxed())
+        return false;
+
+    const int size = thread->pushLocalRunnable(task);
+
+    // Recruit a thief if one is sleeping, and otherwise each time the backlog
+    // doubles, so that a producer does not take the mutex for every task.
+    // Starting at a backlog of one gives the same guarantee as start() that a
+    // free thread will pick the task up even if the caller blocks on it.
+    if (idleThreads.loadRelaxed() > 0 || (size & (size - 1)) == 0) {
+        QMutexLocker locker(&mutex);
+        startThreadForStealing();
+    }
+    return true;
+}
+
+/*
+    \internal
+    Wakes or starts a thread that looks for work in the other threads'
+    local queues. Must be called with the mutex held.
+*/
+void QThreadPoolPrivate::startThreadForStealing()
+{
+    if (!waitingThreads.isEmpty()) {
+        waitingThreads.takeFirst()->runnableReady.wakeOne();
+        return;
+    }
+
+    if (activeThreadCount() >= maxThreadCount)
+        return;
+
+    if (!expiredThreads.isEmpty()) {
+        QThreadPoolThread *thread = expiredThreads.dequeue();
+        Q_ASSERT(thread->runnable == nullptr);
+        ++activeThreads;
+        thread->start();
+        return;
+    }
+
+    startThread();
+}
+
+/*
+    \internal
+    Takes the oldest runnable from another thread's local queue.
+    Must be called with the mutex held.
+*/
+QRunnable *QThreadPoolPrivate::stealRunnable(QThreadPoolThread *thief)
+{
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        if (thread == thief)
+            continue;
+        if (QRunnable *r = thread->stealLocalRunnable())
+            return r;
+    }
+    return nullptr;
+}
+
 inline bool comparePriority(int priority, const QueuePage *p)
 {
     return p->priority() < priority;
@@ -257,7 +421,8 @@ bool QThreadPoolPrivate::tooManyThreadsActive() const
 */
 void QThreadPoolPrivate::startThread(QRunnable *runnable)
 {
-    Q_ASSERT(runnable != nullptr);
+    // threads started to steal work begin without a runnable of their own
+    Q_ASSERT(runnable != nullptr || workStealing.loadRelaxed());
     QScopedPointer <QThreadPoolThread> thread(new QThreadPoolThread(this));
     thread->setObjectName(QLatin1String("Thread (pooled)"));
     Q_ASSERT(!allThreads.contains(thread.data())); // if this assert hits, we have an ABA problem (deleted threads don't get removed here)
@@ -324,6 +489,20 @@ bool QThreadPoolPrivate::waitForDone(int msecs)
 void QThreadPoolPrivate::clear()
 {
     QMutexLocker locker(&mutex);
+    // unlocking while iterating would let other threads change allThreads
+    QList<QRunnable *> autoDeleted;
+    for (QThreadPoolThread *thread : qAsConst(allThreads)) {
+        const QList<QRunnable *> runnables = thread->takeLocalRunnables();
+        for (QRunnable *r : runnables) {
+            if (r->autoDelete())
+                autoDeleted.append(r);
+        }
+    }
+    if (!autoDeleted.isEmpty()) {
+        locker.unlock();
+        qDeleteAll(autoDeleted);
+        locker.relock();
+    }
     while (!queue.isEmpty()) {
         auto *page = queue.takeLast();
         while (!page->isFinished()) {
@@ -373,6 +552,11 @@ bool QThreadPool::tryTake(QRunnable *runnable)
         }
     }
 
+    for (QThreadPoolThread *thread : qAsConst(d->allThreads)) {
+        if (thread->tryTakeLocalRunnable(runnable))
+            return true;
+    }
+
     return false;
 }
 
@@ -500,6 +684,9 @@ void QThreadPool::start(QRunnable *runnable, int priority)
         return;
 
     Q_D(QThreadPool);
+    if (priority == 0 && d->tryStartLocally(runnable))
+        return;
+
     QMutexLocker locker(&d->mutex);
 
     if (!d->tryStart(runnable)) {
@@ -747,6 +934,41 @@ void QThreadPool::clear()
     d->clear();
 }
 
+/*! \property QThreadPool::workStealingEnabled
+    \since 6.0
+
+    This property holds whether runnables started from the pool's own
+    threads are scheduled with work stealing.
+
+    By default, all runnables go through one queue that is shared by all
+    threads of the pool. When many small runnables are started from within
+    other runnables, that queue becomes a point of contention. With work
+    stealing enabled, a runnable that start() is called for with the default
+    priority from one of the pool's threads is instead put on that thread's
+    own queue. The thread runs its own runnables, newest first, once the
+    current one returns, and threads that run out of work take the oldest
+    runnables from the other threads' queues.
+
+    Runnables started from threads that do not belong to the pool, or with
+    a non-zero priority, are queued and prioritized as before, and are
+    preferred over stealing. tryStart() is not affected.
+
+    The default value is \c false.
+
+    \sa start()
+*/
+bool QThreadPool::isWorkStealingEnabled() const
+{
+    Q_D(const QThreadPool);
+    return d->workStealing.loadRelaxed();
+}
+
+void QThreadPool::setWorkStealingEnabled(bool enabled)
+{
+    Q_D(QThreadPool);
+    d->workStealing.storeRelaxed(enabled);
+}
+
 /*!
     \since 6.0
 
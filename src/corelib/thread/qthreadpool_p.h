@@ -156,10 +156,13 @@ public:
     QThreadPoolPrivate();
 
     bool tryStart(QRunnable *task);
+    bool tryStartLocally(QRunnable *task);
     void enqueueTask(QRunnable *task, int priority = 0);
     int activeThreadCount() const;
 
     void tryToStartMoreThreads();
+    void startThreadForStealing();
+    QRunnable *stealRunnable(QThreadPoolThread *thief);
     bool tooManyThreadsActive() const;
 
     void startThread(QRunnable *runnable = nullptr);
@@ -182,6 +185,8 @@ public:
     int reservedThreads = 0;
     int activeThreads = 0;
     uint stackSize = 0;
+    QAtomicInt workStealing; // bool
+    QAtomicInt idleThreads;  // threads blocked in runnableReady, read without the mutex
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qarenaallocator_p.h"
+
+#include <QtCore/qatomic.h>
+
+#include <cstddef>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QArenaScope
+    \inmodule QtCore
+
+    \brief The QArenaScope class makes Qt's array-based containers take their
+    memory from a bump allocator while it is alive.
+
+    While a QArenaScope exists on a thread, every QArrayData allocation made on
+    that thread (and thus the storage of QString, QByteArray and QList) is
+    carved out of large chunks owned by the scope instead of coming from
+    malloc(). Freeing such a block only drops a reference on its chunk; the
+    chunks are released in one go when the scope is destroyed.
+
+    Objects may outlive the scope: a chunk that still holds live blocks when
+    the scope ends stays allocated until the last of those blocks is freed.
+    Once the scope is gone, detaching or growing such an object moves its data
+    to the heap.
+
+    Scopes nest and must be destroyed on the thread that created them, in the
+    reverse order of creation.
+*/
+
+struct alignas(std::max_align_t) QArenaScope::Chunk
+{
+    // one reference for the owning scope, one per live block
+    QAtomicInt ref;
+    Chunk *next;
+
+    char *data() noexcept { return reinterpret_cast<char *>(this + 1); }
+};
+
+struct alignas(std::max_align_t) QArenaScope::BlockHeader
+{
+    Chunk *chunk;
+    size_t size;
+
+    char *data() noexcept { return reinterpret_cast<char *>(this + 1); }
+    char *dataEnd() noexcept { return data() + size; }
+};
+
+static constexpr size_t alignedSize(size_t size) noexcept
+{
+    return (size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+}
+
+static thread_local QArenaScope *currentArenaScope = nullptr;
+
+QArenaScope::QArenaScope(qsizetype chunkSize) noexcept
+    : previous(currentArenaScope),
+      chunkSize(alignedSize(size_t(qMax(chunkSize, qsizetype(1024)))))
+{
+    currentArenaScope = this;
+}
+
+QArenaScope::~QArenaScope()
+{
+    Q_ASSERT_X(currentArenaScope == this, "QArenaScope",
+               "Arena scopes must be destroyed in reverse order, on the thread that created them");
+    currentArenaScope = previous;
+
+    for (Chunk *c = head; c; ) {
+        Chunk *next = c->next;
+        if (!c->ref.deref())
+            ::free(c);
+        c = next;
+    }
+}
+
+/*!
+    Returns the innermost arena scope of the calling thread, or \nullptr if
+    there is none.
+*/
+QArenaScope *QArenaScope::current() noexcept
+{
+    return currentArenaScope;
+}
+
+/*!
+    Returns a block of at least \a size bytes from the current thread's arena,
+    or \nullptr if there is no active scope or the memory could not be
+    allocated. The block is suitably aligned for any type.
+*/
+void *QArenaScope::allocate(size_t size) noexcept
+{
+    if (QArenaScope *scope = currentArenaScope)
+        return scope->allocateBlock(size);
+    return nullptr;
+}
+
+/*!
+    Resizes the arena \a block to \a size bytes. The block is grown in place if
+    it is the most recent allocation of the current thread's arena; otherwise
+    its contents are moved to a new block, taken from the arena if a scope is
+    active or from the heap if not. \a inArena is set accordingly.
+
+    Returns \nullptr and leaves \a block untouched if no memory is available.
+*/
+void *QArenaScope::reallocate(void *block, size_t size, bool *inArena) noexcept
+{
+    Q_ASSERT(block);
+    BlockHeader *header = static_cast<BlockHeader *>(block) - 1;
+    QArenaScope *scope = currentArenaScope;
+    if (scope && scope->tryGrowInPlace(header, size)) {
+        *inArena = true;
+        return block;
+    }
+
+    void *newBlock = scope ? scope->allocateBlock(size) : nullptr;
+    *inArena = newBlock != nullptr;
+    if (!newBlock)
+        newBlock = ::malloc(size);
+    if (!newBlock)
+        return nullptr;
+    memcpy(newBlock, block, qMin(header->size, size));
+    free(block);
+    return newBlock;
+}
+
+/*!
+    Releases the arena \a block. This may be called from any thread.
+*/
+void QArenaScope::free(void *block) noexcept
+{
+    if (!block)
+        return;
+    BlockHeader *header = static_cast<BlockHeader *>(block) - 1;
+    Chunk *chunk = header->chunk;
+
+    // short-lived temporaries are common: hand the space of the most recent
+    // allocation straight back to the bump pointer
+    QArenaScope *scope = currentArenaScope;
+    if (scope && chunk == scope->bump && header->dataEnd() == scope->pos)
+        scope->pos = reinterpret_cast<char *>(header);
+
+    if (!chunk->ref.deref())
+        ::free(chunk);
+}
+
+void *QArenaScope::allocateBlock(size_t size) noexcept
+{
+    size = alignedSize(size);
+    const size_t needed = sizeof(BlockHeader) + size;
+    char *mem;
+    Chunk *chunk;
+    if (needed > chunkSize / 4) {
+        // large blocks get a chunk of their own, so they don't waste the
+        // rest of the current one
+        chunk = newChunk(needed);
+        if (!chunk)
+            return nullptr;
+        mem = chunk->data();
+    } else {
+        if (size_t(end - pos) < needed) {
+            chunk = newChunk(chunkSize);
+            if (!chunk)
+                return nullptr;
+            bump = chunk;
+            pos = chunk->data();
+            end = pos + chunkSize;
+        }
+        chunk = bump;
+        mem = pos;
+        pos += needed;
+    }
+
+    chunk->ref.ref();
+    BlockHeader *header = new (mem) BlockHeader{ chunk, size };
+    ++blocks;
+    bytes += qsizetype(size);
+    return header->data();
+}
+
+bool QArenaScope::tryGrowInPlace(BlockHeader *header, size_t size) noexcept
+{
+    if (header->chunk != bump || header->dataEnd() != pos)
+        return false;
+    size = alignedSize(size);
+    if (size > size_t(end - header->data()))
+        return false;
+    bytes += qsizetype(size) - qsizetype(header->size);
+    header->size = size;
+    pos = header->dataEnd();
+    return true;
+}
+
+QArenaScope::Chunk *QArenaScope::newChunk(size_t capacity) noexcept
+{
+    void *mem = ::malloc(sizeof(Chunk) + capacity);
+    if (!mem)
+        return nullptr;
+    Chunk *chunk = new (mem) Chunk;
+    chunk->ref.storeRelaxed(1);
+    chunk->next = head;
+    head = chunk;
+    ++chunks;
+    return chunk;
+}
+
+QT_END_NAMESPACE
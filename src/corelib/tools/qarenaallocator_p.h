@@ -0,0 +1,100 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QARENAALLOCATOR_P_H
+#define QARENAALLOCATOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_CORE_EXPORT QArenaScope
+{
+public:
+    enum { DefaultChunkSize = 64 * 1024 };
+
+    explicit QArenaScope(qsizetype chunkSize = DefaultChunkSize) noexcept;
+    ~QArenaScope();
+
+    static QArenaScope *current() noexcept;
+
+    qsizetype blockCount() const noexcept { return blocks; }
+    qsizetype chunkCount() const noexcept { return chunks; }
+    qsizetype bytesAllocated() const noexcept { return bytes; }
+
+    // used by QArrayData
+    static void *allocate(size_t size) noexcept;
+    static void *reallocate(void *block, size_t size, bool *inArena) noexcept;
+    static void free(void *block) noexcept;
+
+private:
+    Q_DISABLE_COPY_MOVE(QArenaScope)
+
+    struct Chunk;
+    struct BlockHeader;
+
+    void *allocateBlock(size_t size) noexcept;
+    bool tryGrowInPlace(BlockHeader *header, size_t size) noexcept;
+    Chunk *newChunk(size_t capacity) noexcept;
+
+    QArenaScope *previous;
+    Chunk *head = nullptr;
+    Chunk *bump = nullptr;
+    char *pos = nullptr;
+    char *end = nullptr;
+    size_t chunkSize;
+    qsizetype blocks = 0;
+    qsizetype chunks = 0;
+    qsizetype bytes = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QARENAALLOCATOR_P_H
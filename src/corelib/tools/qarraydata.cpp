@@ -39,6 +39,7 @@
 ****************************************************************************/
 
 #include <QtCore/qarraydata.h>
+#include <QtCore/private/qarenaallocator_p.h>
 #include <QtCore/private/qnumeric_p.h>
 #include <QtCore/private/qtools_p.h>
 #include <QtCore/qmath.h>
@@ -175,7 +176,13 @@ static inline qsizetype calculateBlockSize(qsizetype &capacity, qsizetype object
 
 static QArrayData *allocateData(qsizetype allocSize, uint options)
 {
-    QArrayData *header = static_cast<QArrayData *>(::malloc(size_t(allocSize)));
+    // ArenaAllocated is only ever set here and in reallocateUnaligned()
+    options &= ~QArrayData::ArenaAllocated;
+    QArrayData *header = static_cast<QArrayData *>(QArenaScope::allocate(size_t(allocSize)));
+    if (header)
+        options |= QArrayData::ArenaAllocated;
+    else
+        header = static_cast<QArrayData *>(::malloc(size_t(allocSize)));
     if (header) {
         header->ref_.storeRelaxed(1);
         header->flags = options;
@@ -241,7 +248,16 @@ QArrayData::reallocateUnaligned(QArrayData *data, void *dataPointer,
     if (Q_UNLIKELY(allocSize < 0))  // handle overflow. cannot reallocate reliably
         return qMakePair(data, dataPointer);
 
-    QArrayData *header = static_cast<QArrayData *>(::realloc(data, size_t(allocSize)));
+    options &= ~ArenaAllocated;
+    QArrayData *header;
+    if (data && (data->flags & ArenaAllocated)) {
+        bool inArena = false;
+        header = static_cast<QArrayData *>(QArenaScope::reallocate(data, size_t(allocSize), &inArena));
+        if (inArena)
+            options |= ArenaAllocated;
+    } else {
+        header = static_cast<QArrayData *>(::realloc(data, size_t(allocSize)));
+    }
     if (header) {
         header->flags = options;
         header->alloc = uint(capacity);
@@ -259,7 +275,10 @@ void QArrayData::deallocate(QArrayData *data, qsizetype objectSize,
     Q_UNUSED(objectSize);
     Q_UNUSED(alignment);
 
-    ::free(data);
+    if (data && (data->flags & ArenaAllocated))
+        QArenaScope::free(data);
+    else
+        ::free(data);
 }
 
 QT_END_NAMESPACE
@@ -56,7 +56,8 @@ struct Q_CORE_EXPORT QArrayData
         DefaultAllocationFlags = 0,
         CapacityReserved     = 0x1,  //!< the capacity was reserved by the user, try to keep it
         GrowsForward         = 0x2,  //!< allocate with eyes towards growing through append()
-        GrowsBackwards       = 0x4   //!< allocate with eyes towards growing through prepend()
+        GrowsBackwards       = 0x4,  //!< allocate with eyes towards growing through prepend()
+        ArenaAllocated       = 0x8   //!< internal: the block was allocated from a QArenaScope
     };
     Q_DECLARE_FLAGS(ArrayOptions, ArrayOption)
 
@@ -0,0 +1,633 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qblake3_p.h"
+
+#include <qendian.h>
+#include <private/qsimd_p.h>
+
+#if QT_CONFIG(thread)
+#include <qatomic.h>
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#include <qvarlengtharray.h>
+#endif
+
+#include <string.h>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    BLAKE3, as specified in https://github.com/BLAKE3-team/BLAKE3-specs.
+
+    The compression function is BLAKE2s with 7 rounds and a fixed message
+    permutation. Every node of the tree is compressed the same way, so the
+    SIMD kernels below hash 4 (SSE2) or 8 (AVX2) independent inputs at once,
+    one input per vector lane, rather than vectorizing a single compression.
+*/
+
+namespace {
+
+enum : quint8 {
+    ChunkStart = 1,
+    ChunkEnd = 2,
+    Parent = 4,
+    Root = 8
+};
+
+enum : qsizetype {
+    BlockLength = 64,
+    ChunkLength = 1024,
+    BlocksPerChunk = ChunkLength / BlockLength,
+    OutLength = 32,
+    // chunks hashed in one batch before merging them into parents
+    MaxBatch = 64
+};
+
+const quint32 iv[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// the message word order of each round, i.e. the permutation applied 0..6 times
+const quint8 messageSchedule[7][16] = {
+    { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+    { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+    { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+    { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+    { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+    { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+    { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 },
+};
+
+inline quint32 rotateRight(quint32 w, int c)
+{
+    return (w >> c) | (w << (32 - c));
+}
+
+inline void g(quint32 *v, int a, int b, int c, int d, quint32 x, quint32 y)
+{
+    v[a] = v[a] + v[b] + x;
+    v[d] = rotateRight(v[d] ^ v[a], 16);
+    v[c] = v[c] + v[d];
+    v[b] = rotateRight(v[b] ^ v[c], 12);
+    v[a] = v[a] + v[b] + y;
+    v[d] = rotateRight(v[d] ^ v[a], 8);
+    v[c] = v[c] + v[d];
+    v[b] = rotateRight(v[b] ^ v[c], 7);
+}
+
+void compress(quint32 *v, const quint32 *chainingValue, const uchar *block, quint8 blockLength,
+              quint64 counter, quint8 flags)
+{
+    quint32 m[16];
+    for (int i = 0; i < 16; ++i)
+        m[i] = qFromLittleEndian<quint32>(block + 4 * i);
+
+    memcpy(v, chainingValue, 8 * sizeof(quint32));
+    memcpy(v + 8, iv, 4 * sizeof(quint32));
+    v[12] = quint32(counter);
+    v[13] = quint32(counter >> 32);
+    v[14] = blockLength;
+    v[15] = flags;
+
+    for (const quint8 *s : messageSchedule) {
+        g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+        g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+        g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+        g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+        g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+        g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+        g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+        g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+    }
+}
+
+inline void compressInPlace(quint32 *chainingValue, const uchar *block, quint8 blockLength,
+                            quint64 counter, quint8 flags)
+{
+    quint32 v[16];
+    compress(v, chainingValue, block, blockLength, counter, flags);
+    for (int i = 0; i < 8; ++i)
+        chainingValue[i] = v[i] ^ v[i + 8];
+}
+
+inline void storeChainingValue(uchar *out, const quint32 *chainingValue)
+{
+    for (int i = 0; i < 8; ++i)
+        qToLittleEndian(chainingValue[i], out + 4 * i);
+}
+
+inline void loadChainingValue(quint32 *chainingValue, const uchar *in)
+{
+    for (int i = 0; i < 8; ++i)
+        chainingValue[i] = qFromLittleEndian<quint32>(in + 4 * i);
+}
+
+/*
+    Hashes \a count inputs of \a blocks full blocks each, storing one 32-byte
+    chaining value per input in \a out. The counter is \a counter for every
+    input, or \a counter plus the input's index for chunks.
+*/
+struct HashManyArgs
+{
+    qsizetype blocks;
+    quint64 counter;
+    bool incrementCounter;
+    quint8 flags;
+    quint8 flagsStart;
+    quint8 flagsEnd;
+};
+
+void hashOne(const uchar *input, const HashManyArgs &args, quint64 counter, uchar *out)
+{
+    quint32 chainingValue[8];
+    memcpy(chainingValue, iv, sizeof(chainingValue));
+    quint8 flags = args.flags | args.flagsStart;
+    for (qsizetype b = 0; b < args.blocks; ++b) {
+        if (b + 1 == args.blocks)
+            flags |= args.flagsEnd;
+        compressInPlace(chainingValue, input + b * BlockLength, BlockLength, counter, flags);
+        flags = args.flags;
+    }
+    storeChainingValue(out, chainingValue);
+}
+
+#if QT_COMPILER_USES(sse2)
+inline __m128i rotateRight16(__m128i x)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(x, 0xb1), 0xb1);
+}
+
+template <int C>
+inline __m128i rotateRight(__m128i x)
+{
+    return _mm_or_si128(_mm_srli_epi32(x, C), _mm_slli_epi32(x, 32 - C));
+}
+
+inline void g(__m128i *v, int a, int b, int c, int d, __m128i x, __m128i y)
+{
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), x);
+    v[d] = rotateRight16(_mm_xor_si128(v[d], v[a]));
+    v[c] = _mm_add_epi32(v[c], v[d]);
+    v[b] = rotateRight<12>(_mm_xor_si128(v[b], v[c]));
+    v[a] = _mm_add_epi32(_mm_add_epi32(v[a], v[b]), y);
+    v[d] = rotateRight<8>(_mm_xor_si128(v[d], v[a]));
+    v[c] = _mm_add_epi32(v[c], v[d]);
+    v[b] = rotateRight<7>(_mm_xor_si128(v[b], v[c]));
+}
+
+inline void transpose(__m128i *rows)
+{
+    const __m128i ab01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+    const __m128i ab23 = _mm_unpackhi_epi32(rows[0], rows[1]);
+    const __m128i cd01 = _mm_unpacklo_epi32(rows[2], rows[3]);
+    const __m128i cd23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+    rows[0] = _mm_unpacklo_epi64(ab01, cd01);
+    rows[1] = _mm_unpackhi_epi64(ab01, cd01);
+    rows[2] = _mm_unpacklo_epi64(ab23, cd23);
+    rows[3] = _mm_unpackhi_epi64(ab23, cd23);
+}
+
+void hash4(const uchar *const *inputs, const HashManyArgs &args, quint64 counter, uchar *out)
+{
+    __m128i h[8];
+    for (int i = 0; i < 8; ++i)
+        h[i] = _mm_set1_epi32(int(iv[i]));
+    quint64 counters[4];
+    for (int i = 0; i < 4; ++i)
+        counters[i] = counter + (args.incrementCounter ? i : 0);
+    const __m128i counterLow = _mm_setr_epi32(int(counters[0]), int(counters[1]),
+                                              int(counters[2]), int(counters[3]));
+    const __m128i counterHigh = _mm_setr_epi32(int(counters[0] >> 32), int(counters[1] >> 32),
+                                               int(counters[2] >> 32), int(counters[3] >> 32));
+
+    quint8 flags = args.flags | args.flagsStart;
+    for (qsizetype b = 0; b < args.blocks; ++b) {
+        if (b + 1 == args.blocks)
+            flags |= args.flagsEnd;
+
+        // m[w] holds message word w of all four inputs
+        __m128i m[16];
+        for (int q = 0; q < 4; ++q) {
+            for (int i = 0; i < 4; ++i) {
+                const uchar *p = inputs[i] + b * BlockLength + 16 * q;
+                m[4 * q + i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            }
+            transpose(m + 4 * q);
+        }
+
+        __m128i v[16];
+        memcpy(v, h, sizeof(h));
+        for (int i = 0; i < 4; ++i)
+            v[8 + i] = _mm_set1_epi32(int(iv[i]));
+        v[12] = counterLow;
+        v[13] = counterHigh;
+        v[14] = _mm_set1_epi32(BlockLength);
+        v[15] = _mm_set1_epi32(flags);
+        for (const quint8 *s : messageSchedule) {
+            g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        for (int i = 0; i < 8; ++i)
+            h[i] = _mm_xor_si128(v[i], v[i + 8]);
+        flags = args.flags;
+    }
+
+    transpose(h);
+    transpose(h + 4);
+    for (int i = 0; i < 4; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + OutLength * i), h[i]);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + OutLength * i + 16), h[4 + i]);
+    }
+}
+#endif // sse2
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+inline __m256i rotateRight16(__m256i x)
+{
+    const __m256i mask = _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                          2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13);
+    return _mm256_shuffle_epi8(x, mask);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+inline __m256i rotateRight8(__m256i x)
+{
+    const __m256i mask = _mm256_setr_epi8(1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                          1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12);
+    return _mm256_shuffle_epi8(x, mask);
+}
+
+template <int C>
+QT_FUNCTION_TARGET(AVX2)
+inline __m256i rotateRight(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, C), _mm256_slli_epi32(x, 32 - C));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+inline void g(__m256i *v, int a, int b, int c, int d, __m256i x, __m256i y)
+{
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), x);
+    v[d] = rotateRight16(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotateRight<12>(_mm256_xor_si256(v[b], v[c]));
+    v[a] = _mm256_add_epi32(_mm256_add_epi32(v[a], v[b]), y);
+    v[d] = rotateRight8(_mm256_xor_si256(v[d], v[a]));
+    v[c] = _mm256_add_epi32(v[c], v[d]);
+    v[b] = rotateRight<7>(_mm256_xor_si256(v[b], v[c]));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+inline void transpose(__m256i *rows)
+{
+    __m256i t[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+    }
+    __m256i u[8];
+    for (int i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+QT_FUNCTION_TARGET(AVX2)
+void hash8(const uchar *const *inputs, const HashManyArgs &args, quint64 counter, uchar *out)
+{
+    __m256i h[8];
+    for (int i = 0; i < 8; ++i)
+        h[i] = _mm256_set1_epi32(int(iv[i]));
+    quint32 counterLow[8];
+    quint32 counterHigh[8];
+    for (int i = 0; i < 8; ++i) {
+        const quint64 c = counter + (args.incrementCounter ? i : 0);
+        counterLow[i] = quint32(c);
+        counterHigh[i] = quint32(c >> 32);
+    }
+
+    quint8 flags = args.flags | args.flagsStart;
+    for (qsizetype b = 0; b < args.blocks; ++b) {
+        if (b + 1 == args.blocks)
+            flags |= args.flagsEnd;
+
+        // m[w] holds message word w of all eight inputs
+        __m256i m[16];
+        for (int half = 0; half < 2; ++half) {
+            for (int i = 0; i < 8; ++i) {
+                const uchar *p = inputs[i] + b * BlockLength + 32 * half;
+                m[8 * half + i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+            }
+            transpose(m + 8 * half);
+        }
+
+        __m256i v[16];
+        memcpy(v, h, sizeof(h));
+        for (int i = 0; i < 4; ++i)
+            v[8 + i] = _mm256_set1_epi32(int(iv[i]));
+        v[12] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counterLow));
+        v[13] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(counterHigh));
+        v[14] = _mm256_set1_epi32(BlockLength);
+        v[15] = _mm256_set1_epi32(flags);
+        for (const quint8 *s : messageSchedule) {
+            g(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            g(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            g(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            g(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            g(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            g(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            g(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            g(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        for (int i = 0; i < 8; ++i)
+            h[i] = _mm256_xor_si256(v[i], v[i + 8]);
+        flags = args.flags;
+    }
+
+    transpose(h);
+    for (int i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + OutLength * i), h[i]);
+}
+#endif // AVX2
+
+void hashMany(const uchar *const *inputs, qsizetype count, const HashManyArgs &args, uchar *out)
+{
+    quint64 counter = args.counter;
+    const quint64 step = args.incrementCounter ? 1 : 0;
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        for ( ; count >= 8; count -= 8, inputs += 8, out += 8 * OutLength, counter += 8 * step)
+            hash8(inputs, args, counter, out);
+    }
+#endif
+#if QT_COMPILER_USES(sse2)
+    for ( ; count >= 4; count -= 4, inputs += 4, out += 4 * OutLength, counter += 4 * step)
+        hash4(inputs, args, counter, out);
+#endif
+    for ( ; count; --count, ++inputs, out += OutLength, counter += step)
+        hashOne(*inputs, args, counter, out);
+}
+
+// the chaining value of a parent node of two chaining values
+void parentChainingValue(quint32 *out, const quint32 *left, const quint32 *right)
+{
+    uchar block[BlockLength];
+    storeChainingValue(block, left);
+    storeChainingValue(block + OutLength, right);
+    memcpy(out, iv, sizeof(iv));
+    compressInPlace(out, block, BlockLength, 0, Parent);
+}
+
+/*
+    Returns the chaining value of the subtree made of \a chunks full chunks at
+    \a input, \a chunks being a power of two. Its first chunk has the index
+    \a counter in the whole input, which must be a multiple of \a chunks.
+*/
+void subtreeChainingValue(quint32 *out, const uchar *input, qsizetype chunks, quint64 counter)
+{
+    if (chunks > MaxBatch) {
+        const qsizetype half = chunks / 2;
+        quint32 left[8];
+        quint32 right[8];
+        subtreeChainingValue(left, input, half, counter);
+        subtreeChainingValue(right, input + half * ChunkLength, half, counter + half);
+        parentChainingValue(out, left, right);
+        return;
+    }
+
+    // hash all chunks of the batch at once, then each level of parents at once
+    const uchar *inputs[MaxBatch];
+    uchar chainingValues[2][MaxBatch * OutLength];
+    for (qsizetype i = 0; i < chunks; ++i)
+        inputs[i] = input + i * ChunkLength;
+    hashMany(inputs, chunks, { BlocksPerChunk, counter, true, 0, ChunkStart, ChunkEnd },
+             chainingValues[0]);
+
+    int level = 0;
+    for (qsizetype n = chunks / 2; n; n /= 2, level ^= 1) {
+        for (qsizetype i = 0; i < n; ++i)
+            inputs[i] = chainingValues[level] + i * BlockLength;
+        hashMany(inputs, n, { 1, 0, false, Parent, 0, 0 }, chainingValues[level ^ 1]);
+    }
+    loadChainingValue(out, chainingValues[level]);
+}
+
+} // unnamed namespace
+
+void QBlake3::reset()
+{
+    memcpy(chunkChainingValue, iv, sizeof(iv));
+    chunkCounter = 0;
+    memset(block, 0, sizeof(block));
+    blockLength = 0;
+    blocksCompressed = 0;
+    stackSize = 0;
+}
+
+// Moves the full chunk in the chunk state into the tree, once more input follows it.
+void QBlake3::pushFullChunk()
+{
+    Q_ASSERT(chunkStateLength() == ChunkLength);
+    compressInPlace(chunkChainingValue, block, blockLength, chunkCounter, ChunkEnd);
+    const quint32 *chainingValue = chunkChainingValue;
+    quint32 merged[8];
+    quint64 total = ++chunkCounter;
+    while (!(total & 1)) {
+        parentChainingValue(merged, stack[--stackSize], chainingValue);
+        chainingValue = merged;
+        total >>= 1;
+    }
+    memcpy(stack[stackSize++], chainingValue, sizeof(merged));
+
+    memcpy(chunkChainingValue, iv, sizeof(iv));
+    memset(block, 0, sizeof(block));
+    blockLength = 0;
+    blocksCompressed = 0;
+}
+
+// Adds a complete subtree of \a chunks chunks, which follows the input so far.
+void QBlake3::pushSubtree(const quint32 *chainingValue, quint64 chunks)
+{
+    Q_ASSERT(chunkStateLength() == 0);
+    Q_ASSERT(chunkCounter % chunks == 0);
+    quint32 merged[8];
+    chunkCounter += chunks;
+    for (quint64 total = chunkCounter / chunks; !(total & 1); total >>= 1) {
+        parentChainingValue(merged, stack[--stackSize], chainingValue);
+        chainingValue = merged;
+    }
+    memcpy(stack[stackSize++], chainingValue, sizeof(merged));
+}
+
+void QBlake3::addData(const uchar *data, qsizetype length)
+{
+    while (length) {
+        if (chunkStateLength() == ChunkLength)
+            pushFullChunk();
+
+        if (chunkStateLength() == 0 && length > ChunkLength) {
+            // hash the largest aligned subtree that leaves some input for the
+            // chunk state, as the last chunk needs the Root flag
+            qsizetype chunks = 1;
+            while (chunks < MaxBatch && (chunks * 2) * ChunkLength < length
+                   && chunkCounter % (chunks * 2) == 0) {
+                chunks *= 2;
+            }
+            quint32 chainingValue[8];
+            subtreeChainingValue(chainingValue, data, chunks, chunkCounter);
+            pushSubtree(chainingValue, chunks);
+            data += chunks * ChunkLength;
+            length -= chunks * ChunkLength;
+            continue;
+        }
+
+        if (blockLength == BlockLength) {
+            compressInPlace(chunkChainingValue, block, BlockLength, chunkCounter,
+                            blocksCompressed ? 0 : ChunkStart);
+            ++blocksCompressed;
+            memset(block, 0, sizeof(block));
+            blockLength = 0;
+        }
+        const qsizetype n = qMin(length, qsizetype(BlockLength - blockLength));
+        memcpy(block + blockLength, data, n);
+        blockLength += quint8(n);
+        data += n;
+        length -= n;
+    }
+}
+
+/*
+    Adds \a length bytes at \a data, hashing large inputs on the threads of
+    \a pool. The calling thread takes part, and only idle threads of the pool
+    are used, so this is safe to call from a task running on \a pool.
+*/
+void QBlake3::addData(const uchar *data, qsizetype length, QThreadPool *pool)
+{
+#if QT_CONFIG(thread)
+    // 256 KiB per task
+    const qsizetype taskChunks = 256;
+    const qsizetype taskLength = taskChunks * ChunkLength;
+    if (!pool || length < 4 * taskLength) {
+        addData(data, length);
+        return;
+    }
+
+    // tasks must start on a subtree boundary of the whole input
+    const qsizetype position = qsizetype(chunkCounter % taskChunks) * ChunkLength + chunkStateLength();
+    const qsizetype head = position ? taskLength - position : 0;
+    addData(data, head);
+    data += head;
+    length -= head;
+    if (chunkStateLength() == ChunkLength)
+        pushFullChunk();
+
+    // leave at least one byte for the chunk state
+    const qsizetype tasks = (length - 1) / taskLength;
+    QVarLengthArray<quint32, 8 * 64> chainingValues(8 * tasks);
+    QAtomicInteger<qsizetype> next(0);
+    const quint64 counter = chunkCounter;
+    const auto work = [&]() {
+        for (qsizetype i; (i = next.fetchAndAddRelaxed(1)) < tasks; ) {
+            subtreeChainingValue(chainingValues.data() + 8 * i, data + i * taskLength,
+                                 taskChunks, counter + i * taskChunks);
+        }
+    };
+
+    QSemaphore done;
+    const qsizetype maxHelpers = qMin(qsizetype(pool->maxThreadCount()), tasks) - 1;
+    int helpers = 0;
+    while (helpers < maxHelpers && pool->tryStart([&]() { work(); done.release(); }))
+        ++helpers;
+    work();
+    done.acquire(helpers);
+
+    for (qsizetype i = 0; i < tasks; ++i)
+        pushSubtree(chainingValues.constData() + 8 * i, taskChunks);
+    addData(data + tasks * taskLength, length - tasks * taskLength);
+#else
+    Q_UNUSED(pool);
+    addData(data, length);
+#endif
+}
+
+void QBlake3::finalize(uchar *out) const
+{
+    // the last chunk is the rightmost node; fold the stack into it
+    quint32 chainingValue[8];
+    memcpy(chainingValue, chunkChainingValue, sizeof(chainingValue));
+    uchar nodeBlock[BlockLength];
+    memcpy(nodeBlock, block, sizeof(nodeBlock));
+    quint8 nodeBlockLength = blockLength;
+    quint64 nodeCounter = chunkCounter;
+    quint8 nodeFlags = ChunkEnd | (blocksCompressed ? 0 : ChunkStart);
+
+    for (int i = stackSize - 1; i >= 0; --i) {
+        quint32 right[8];
+        memcpy(right, chainingValue, sizeof(right));
+        compressInPlace(right, nodeBlock, nodeBlockLength, nodeCounter, nodeFlags);
+        storeChainingValue(nodeBlock, stack[i]);
+        storeChainingValue(nodeBlock + OutLength, right);
+        memcpy(chainingValue, iv, sizeof(iv));
+        nodeBlockLength = BlockLength;
+        nodeCounter = 0;
+        nodeFlags = Parent;
+    }
+
+    quint32 v[16];
+    compress(v, chainingValue, nodeBlock, nodeBlockLength, nodeCounter, nodeFlags | Root);
+    for (int i = 0; i < 8; ++i)
+        qToLittleEndian(v[i] ^ v[i + 8], out + 4 * i);
+}
+
+QT_END_NAMESPACE
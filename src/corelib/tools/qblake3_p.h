@@ -0,0 +1,94 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QBLAKE3_P_H
+#define QBLAKE3_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+
+// Incremental BLAKE3 hasher (unkeyed, 256-bit output), for QCryptographicHash.
+// BLAKE3 splits its input into 1 KiB chunks and combines their chaining
+// values in a binary tree, so independent subtrees can be hashed with SIMD
+// (several chunks at once) and on several threads. The object is trivially
+// copyable so that result() can finalize a copy.
+class QBlake3
+{
+public:
+    enum { HashLength = 32 };
+
+    void reset();
+    void addData(const uchar *data, qsizetype length);
+    void addData(const uchar *data, qsizetype length, QThreadPool *pool);
+    void finalize(uchar *out) const;
+
+private:
+    enum { ChunkLength = 1024, BlockLength = 64, MaxDepth = 54 };
+
+    qsizetype chunkStateLength() const
+    { return qsizetype(blocksCompressed) * BlockLength + blockLength; }
+    void pushFullChunk();
+    void pushSubtree(const quint32 *chainingValue, quint64 chunks);
+
+    quint32 stack[MaxDepth][8];
+    quint32 chunkChainingValue[8];
+    quint64 chunkCounter;
+    uchar block[BlockLength];
+    quint8 blockLength;
+    quint8 blocksCompressed;
+    quint8 stackSize;
+};
+
+QT_END_NAMESPACE
+
+#endif // QBLAKE3_P_H
@@ -39,7 +39,15 @@
 ****************************************************************************/
 
 #include <qcryptographichash.h>
+#include <qendian.h>
+#include <qfiledevice.h>
 #include <qiodevice.h>
+#include <qvarlengtharray.h>
+#include <private/qsimd_p.h>
+
+#ifndef QT_BOOTSTRAPPED
+#include "qsha_p.h"
+#endif
 
 #include "../../3rdparty/sha1/sha1.cpp"
 
@@ -109,9 +117,11 @@ static SHA3Final * const sha3Final = Final;
 static int SHA224_256AddLength(SHA256Context *context, unsigned int length);
 static int SHA384_512AddLength(SHA512Context *context, unsigned int length);
 
-// Sources from rfc6234, with 4 modifications:
+// Sources from rfc6234, with 5 modifications:
 // sha224-256.c - commented out 'static uint32_t addTemp;' on line 68
 // sha224-256.c - appended 'M' to the SHA224_256AddLength macro on line 70
+// sha224-256.c - appended 'Portable' to SHA224_256ProcessMessageBlock on line 385,
+//                which is defined below instead
 #include "../../3rdparty/rfc6234/sha224-256.c"
 // sha384-512.c - commented out 'static uint64_t addTemp;' on line 302
 // sha384-512.c - appended 'M' to the SHA224_256AddLength macro on line 304
@@ -128,11 +138,213 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
   return SHA384_512AddLengthM(context, length);
 }
 
+static void SHA224_256ProcessMessageBlock(SHA256Context *context)
+{
+    if (QT_PREPEND_NAMESPACE(qt_sha256ProcessBlocks)(context->Intermediate_Hash,
+                                                     context->Message_Block, 1)) {
+        context->Message_Block_Index = 0;
+    } else {
+        SHA224_256ProcessMessageBlockPortable(context);
+    }
+}
+
+/*
+    SHA256Input() copies its input one byte at a time into the message
+    block. This hashes the whole blocks in the input straight from it instead.
+*/
+static void SHA224_256InputBlocks(SHA256Context *context, const uint8_t *data, unsigned int length)
+{
+    if (context->Message_Block_Index) {
+        unsigned int head = SHA256_Message_Block_Size - context->Message_Block_Index;
+        if (head > length)
+            head = length;
+        SHA256Input(context, data, head);
+        data += head;
+        length -= head;
+    }
+
+    const unsigned int blocks = length / SHA256_Message_Block_Size;
+    if (blocks && !context->Computed && !context->Corrupted) {
+        const uint64_t oldBits = uint64_t(context->Length_High) << 32 | context->Length_Low;
+        const uint64_t bits = oldBits + uint64_t(blocks) * SHA256_Message_Block_Size * 8;
+        if (bits < oldBits) {
+            context->Corrupted = shaInputTooLong;
+            return;
+        }
+        context->Length_High = uint32_t(bits >> 32);
+        context->Length_Low = uint32_t(bits);
+        if (!QT_PREPEND_NAMESPACE(qt_sha256ProcessBlocks)(context->Intermediate_Hash, data, blocks)) {
+            for (unsigned int i = 0; i < blocks; ++i) {
+                memcpy(context->Message_Block, data + i * SHA256_Message_Block_Size,
+                       SHA256_Message_Block_Size);
+                SHA224_256ProcessMessageBlockPortable(context);
+            }
+        }
+        data += blocks * SHA256_Message_Block_Size;
+        length -= blocks * SHA256_Message_Block_Size;
+    }
+
+    SHA256Input(context, data, length);
+}
+
 #if QT_CONFIG(system_libb2)
 #include <blake2.h>
 #else
+// Sources from the BLAKE2 reference implementation, with 1 modification each:
+// blake2b-ref.c and blake2s-ref.c - if BLAKE2_QT_COMPRESS is defined, the
+// compression function is renamed with a '_ref' suffix and only declared under
+// its original name, so that we can supply SIMD versions below
+#define BLAKE2_QT_COMPRESS
 #include "../../3rdparty/blake2/src/blake2b-ref.c"
 #include "../../3rdparty/blake2/src/blake2s-ref.c"
+
+/*
+    Both compression functions keep one row of the 4x4 state matrix per
+    vector, so that the four G functions of a column (or diagonal) step run
+    at once; rotating rows b, c and d by one, two and three lanes turns the
+    diagonals into columns. The message words are gathered per step from the
+    sigma permutation.
+*/
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+static inline void blake2b_g_avx2(__m256i &a, __m256i &b, __m256i &c, __m256i &d,
+                                  __m256i x, __m256i y)
+{
+    const __m256i rotate24 = _mm256_setr_epi8(3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+                                              3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10);
+    const __m256i rotate16 = _mm256_setr_epi8(2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+                                              2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9);
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), x);
+    d = _mm256_shuffle_epi32(_mm256_xor_si256(d, a), _MM_SHUFFLE(2, 3, 0, 1));
+    c = _mm256_add_epi64(c, d);
+    b = _mm256_shuffle_epi8(_mm256_xor_si256(b, c), rotate24);
+    a = _mm256_add_epi64(_mm256_add_epi64(a, b), y);
+    d = _mm256_shuffle_epi8(_mm256_xor_si256(d, a), rotate16);
+    c = _mm256_add_epi64(c, d);
+    b = _mm256_xor_si256(b, c);
+    b = _mm256_or_si256(_mm256_srli_epi64(b, 63), _mm256_add_epi64(b, b));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+static void blake2b_compress_avx2(blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES])
+{
+    long long m[16];
+    for (int i = 0; i < 16; ++i)
+        m[i] = (long long)load64(block + i * sizeof(m[i]));
+
+    const __m256i h0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(S->h));
+    const __m256i h1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(S->h + 4));
+    __m256i a = h0;
+    __m256i b = h1;
+    __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blake2b_IV));
+    __m256i d = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(blake2b_IV + 4)),
+                                 _mm256_setr_epi64x((long long)S->t[0], (long long)S->t[1],
+                                                    (long long)S->f[0], (long long)S->f[1]));
+
+    for (const uint8_t *s : blake2b_sigma) {
+        blake2b_g_avx2(a, b, c, d,
+                       _mm256_setr_epi64x(m[s[0]], m[s[2]], m[s[4]], m[s[6]]),
+                       _mm256_setr_epi64x(m[s[1]], m[s[3]], m[s[5]], m[s[7]]));
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(2, 1, 0, 3));
+        blake2b_g_avx2(a, b, c, d,
+                       _mm256_setr_epi64x(m[s[8]], m[s[10]], m[s[12]], m[s[14]]),
+                       _mm256_setr_epi64x(m[s[9]], m[s[11]], m[s[13]], m[s[15]]));
+        b = _mm256_permute4x64_epi64(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm256_permute4x64_epi64(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm256_permute4x64_epi64(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(S->h), _mm256_xor_si256(h0, _mm256_xor_si256(a, c)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(S->h + 4), _mm256_xor_si256(h1, _mm256_xor_si256(b, d)));
+}
+#endif // AVX2
+
+#if QT_COMPILER_USES(sse2)
+static inline void blake2s_g_sse2(__m128i &a, __m128i &b, __m128i &c, __m128i &d,
+                                  __m128i x, __m128i y)
+{
+    a = _mm_add_epi32(_mm_add_epi32(a, b), x);
+    d = _mm_xor_si128(d, a);
+    d = _mm_shufflehi_epi16(_mm_shufflelo_epi16(d, _MM_SHUFFLE(2, 3, 0, 1)), _MM_SHUFFLE(2, 3, 0, 1));
+    c = _mm_add_epi32(c, d);
+    b = _mm_xor_si128(b, c);
+    b = _mm_or_si128(_mm_srli_epi32(b, 12), _mm_slli_epi32(b, 32 - 12));
+    a = _mm_add_epi32(_mm_add_epi32(a, b), y);
+    d = _mm_xor_si128(d, a);
+    d = _mm_or_si128(_mm_srli_epi32(d, 8), _mm_slli_epi32(d, 32 - 8));
+    c = _mm_add_epi32(c, d);
+    b = _mm_xor_si128(b, c);
+    b = _mm_or_si128(_mm_srli_epi32(b, 7), _mm_slli_epi32(b, 32 - 7));
+}
+
+static void blake2s_compress_sse2(blake2s_state *S, const uint8_t in[BLAKE2S_BLOCKBYTES])
+{
+    int m[16];
+    for (int i = 0; i < 16; ++i)
+        m[i] = (int)load32(in + i * sizeof(m[i]));
+
+    const __m128i h0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(S->h));
+    const __m128i h1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(S->h + 4));
+    __m128i a = h0;
+    __m128i b = h1;
+    __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i *>(blake2s_IV));
+    __m128i d = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(blake2s_IV + 4)),
+                              _mm_setr_epi32((int)S->t[0], (int)S->t[1], (int)S->f[0], (int)S->f[1]));
+
+    for (const uint8_t *s : blake2s_sigma) {
+        blake2s_g_sse2(a, b, c, d,
+                       _mm_setr_epi32(m[s[0]], m[s[2]], m[s[4]], m[s[6]]),
+                       _mm_setr_epi32(m[s[1]], m[s[3]], m[s[5]], m[s[7]]));
+        b = _mm_shuffle_epi32(b, _MM_SHUFFLE(0, 3, 2, 1));
+        c = _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm_shuffle_epi32(d, _MM_SHUFFLE(2, 1, 0, 3));
+        blake2s_g_sse2(a, b, c, d,
+                       _mm_setr_epi32(m[s[8]], m[s[10]], m[s[12]], m[s[14]]),
+                       _mm_setr_epi32(m[s[9]], m[s[11]], m[s[13]], m[s[15]]));
+        b = _mm_shuffle_epi32(b, _MM_SHUFFLE(2, 1, 0, 3));
+        c = _mm_shuffle_epi32(c, _MM_SHUFFLE(1, 0, 3, 2));
+        d = _mm_shuffle_epi32(d, _MM_SHUFFLE(0, 3, 2, 1));
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(S->h), _mm_xor_si128(h0, _mm_xor_si128(a, c)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(S->h + 4), _mm_xor_si128(h1, _mm_xor_si128(b, d)));
+}
+#endif // sse2
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_BEGIN_NAMESPACE
+static bool qt_blake2bUseAvx2()
+{
+    return qCpuHasFeature(AVX2);
+}
+QT_END_NAMESPACE
+#endif
+
+static void blake2b_compress(blake2b_state *S, const uint8_t block[BLAKE2B_BLOCKBYTES])
+{
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (QT_PREPEND_NAMESPACE(qt_blake2bUseAvx2)())
+        return blake2b_compress_avx2(S, block);
+#endif
+    blake2b_compress_ref(S, block);
+}
+
+static void blake2s_compress(blake2s_state *S, const uint8_t in[BLAKE2S_BLOCKBYTES])
+{
+#if QT_COMPILER_USES(sse2)
+    Q_UNUSED(blake2s_compress_ref);
+    blake2s_compress_sse2(S, in);
+#else
+    blake2s_compress_ref(S, in);
+#endif
+}
+#endif // system_libb2
+
+#include "qblake3_p.h"
+#if QT_CONFIG(thread)
+#include <qthreadpool.h>
 #endif
 #endif // QT_CRYPTOGRAPHICHASH_ONLY_SHA1
 
@@ -154,6 +366,7 @@ public:
         SHA3Context sha3Context;
         blake2b_state blake2bContext;
         blake2s_state blake2sContext;
+        QBlake3 blake3Context;
 #endif
     };
 #ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
@@ -257,6 +470,9 @@ void QCryptographicHashPrivate::sha3Finish(int bitCount, Sha3Variant sha3Variant
   \value Blake2s_160 Generate a BLAKE2s-160 hash sum. Introduced in Qt 6.0
   \value Blake2s_224 Generate a BLAKE2s-224 hash sum. Introduced in Qt 6.0
   \value Blake2s_256 Generate a BLAKE2s-256 hash sum. Introduced in Qt 6.0
+  \value Blake3_256 Generate a BLAKE3 hash sum (256 bits). BLAKE3 hashes its
+         input as a tree of 1 KiB chunks, which lets it use SIMD and, through
+         hashFile(), several threads. Introduced in Qt 6.0
   \omitvalue RealSha3_224
   \omitvalue RealSha3_256
   \omitvalue RealSha3_384
@@ -346,6 +562,10 @@ void QCryptographicHash::reset()
         new (&d->blake2sContext) blake2s_state;
         blake2s_init(&d->blake2sContext, hashLength(d->method));
         break;
+    case Blake3_256:
+        new (&d->blake3Context) QBlake3;
+        d->blake3Context.reset();
+        break;
 #endif
     }
     d->result.clear();
@@ -387,10 +607,10 @@ void QCryptographicHash::addData(const char *data, qsizetype length)
             MD5Update(&d->md5Context, (const unsigned char *)data, length);
             break;
         case Sha224:
-            SHA224Input(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+            SHA224_256InputBlocks(&d->sha224Context, reinterpret_cast<const unsigned char *>(data), length);
             break;
         case Sha256:
-            SHA256Input(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+            SHA224_256InputBlocks(&d->sha256Context, reinterpret_cast<const unsigned char *>(data), length);
             break;
         case Sha384:
             SHA384Input(&d->sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -426,6 +646,9 @@ void QCryptographicHash::addData(const char *data, qsizetype length)
         case Blake2s_256:
             blake2s_update(&d->blake2sContext, reinterpret_cast<const uint8_t *>(data), length);
             break;
+        case Blake3_256:
+            d->blake3Context.addData(reinterpret_cast<const uchar *>(data), length);
+            break;
 #endif
         }
     }
@@ -575,6 +798,10 @@ QByteArray QCryptographicHash::result() const
         blake2s_final(&copy, reinterpret_cast<uint8_t *>(d->result.data()), length);
         break;
     }
+    case Blake3_256:
+        d->result.resize(QBlake3::HashLength);
+        d->blake3Context.finalize(reinterpret_cast<uchar *>(d->result.data()));
+        break;
 #endif
     }
     return d->result;
@@ -590,6 +817,99 @@ QByteArray QCryptographicHash::hash(const QByteArray &data, Algorithm method)
     return hash.result();
 }
 
+/*!
+  \since 6.0
+
+  Returns the hashes of each of \a messages using \a method, in the same
+  order.
+
+  This is equivalent to calling hash() for each message, but for Sha224 and
+  Sha256 on CPUs without SHA instructions, up to eight messages are hashed
+  at once with AVX2. This makes it suited for hashing many short, independent
+  messages, such as network replies or cache entries.
+
+  \sa hash()
+*/
+QByteArrayList QCryptographicHash::hashMany(const QList<QByteArrayView> &messages, Algorithm method)
+{
+    QByteArrayList results;
+    results.reserve(messages.size());
+#if !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) && !defined(QT_BOOTSTRAPPED)
+    if (method == Sha224 || method == Sha256) {
+        QVarLengthArray<quint32, 8 * 16> states(8 * messages.size());
+        const uint32_t *initialState = method == Sha224 ? SHA224_H0 : SHA256_H0;
+        if (qt_sha256Many(initialState, messages.constData(), messages.size(), states.data())) {
+            const int length = hashLength(method);
+            for (qsizetype i = 0; i < messages.size(); ++i) {
+                QByteArray result(length, Qt::Uninitialized);
+                for (int word = 0; word < length / 4; ++word)
+                    qToBigEndian(states[8 * i + word], result.data() + 4 * word);
+                results.append(result);
+            }
+            return results;
+        }
+    }
+#endif
+
+    QCryptographicHash hash(method);
+    for (QByteArrayView message : messages) {
+        hash.reset();
+        hash.addData(message.data(), message.size());
+        results.append(hash.result());
+    }
+    return results;
+}
+
+/*!
+  \since 6.0
+
+  Returns the hash of the contents of \a file, from its current position to
+  its end, using \a method. Returns an empty QByteArray if \a file is not
+  open for reading or could not be read. On return, the position of \a file
+  is at its end.
+
+  Rather than reading \a file through a buffer like addData(QIODevice *)
+  does, this function hashes the file through memory mappings. With the
+  Blake3_256 algorithm, large files are in addition hashed in parallel on
+  idle threads of QThreadPool::globalInstance(). Sequential devices, and
+  files that cannot be mapped, are read instead.
+
+  \sa hash(), addData(), QFileDevice::map()
+*/
+QByteArray QCryptographicHash::hashFile(QFileDevice *file, Algorithm method)
+{
+    if (!file->isReadable())
+        return QByteArray();
+
+    QCryptographicHash hash(method);
+    if (!file->isSequential()) {
+        // map at most 256 MiB at a time, to spare the address space
+        const qint64 window = qint64(1) << 28;
+        const qint64 size = file->size();
+        qint64 pos = file->pos();
+        while (pos < size) {
+            const qint64 length = qMin(window, size - pos);
+            uchar *data = file->map(pos, length);
+            if (!data)
+                break;
+#if !defined(QT_CRYPTOGRAPHICHASH_ONLY_SHA1) && QT_CONFIG(thread)
+            if (method == Blake3_256)
+                hash.d->blake3Context.addData(data, length, QThreadPool::globalInstance());
+            else
+#endif
+                hash.addData(reinterpret_cast<const char *>(data), length);
+            file->unmap(data);
+            pos += length;
+        }
+        // reads whatever could not be mapped
+        if (!file->seek(pos))
+            return QByteArray();
+    }
+    if (!hash.addData(static_cast<QIODevice *>(file)))
+        return QByteArray();
+    return hash.result();
+}
+
 /*!
   Returns the size of the output of the selected hash \a method in bytes.
 
@@ -626,6 +946,7 @@ int QCryptographicHash::hashLength(QCryptographicHash::Algorithm method)
     case QCryptographicHash::Keccak_256:
     case QCryptographicHash::Blake2b_256:
     case QCryptographicHash::Blake2s_256:
+    case QCryptographicHash::Blake3_256:
         return 256 / 8;
     case QCryptographicHash::RealSha3_384:
     case QCryptographicHash::Keccak_384:
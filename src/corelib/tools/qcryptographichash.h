@@ -42,6 +42,7 @@
 #define QCRYPTOGRAPHICHASH_H
 
 #include <QtCore/qbytearray.h>
+#include <QtCore/qbytearraylist.h>
 #include <QtCore/qobjectdefs.h>
 
 QT_BEGIN_NAMESPACE
@@ -49,6 +50,7 @@ QT_BEGIN_NAMESPACE
 
 class QCryptographicHashPrivate;
 class QIODevice;
+class QFileDevice;
 
 class Q_CORE_EXPORT QCryptographicHash
 {
@@ -94,6 +96,7 @@ public:
         Blake2s_160,
         Blake2s_224,
         Blake2s_256,
+        Blake3_256,
 #endif
     };
     Q_ENUM(Algorithm)
@@ -110,6 +113,8 @@ public:
     QByteArray result() const;
 
     static QByteArray hash(const QByteArray &data, Algorithm method);
+    static QByteArrayList hashMany(const QList<QByteArrayView> &messages, Algorithm method);
+    static QByteArray hashFile(QFileDevice *file, Algorithm method);
     static int hashLength(Algorithm method);
 private:
     Q_DISABLE_COPY(QCryptographicHash)
@@ -37,21 +37,12 @@
 **
 ****************************************************************************/
 
-#ifndef QFLATMAP_P_H
-#define QFLATMAP_P_H
-
-//
-//  W A R N I N G
-//  -------------
-//
-// This file is not part of the Qt API.  It exists for the convenience
-// of a number of Qt sources files.  This header file may change from
-// version to version without notice, or even be removed.
-//
-// We mean it.
-//
-
-#include "qlist.h"
+#ifndef QFLATMAP_H
+#define QFLATMAP_H
+
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qstringview.h>
 
 #include <algorithm>
 #include <functional>
@@ -64,19 +55,6 @@
 
 QT_BEGIN_NAMESPACE
 
-/*
-  QFlatMap provides an associative container backed by sorted sequential
-  containers. By default, QList is used.
-
-  Keys and values are stored in two separate containers. This provides improved
-  cache locality for key iteration and makes keys() and values() fast
-  operations.
-
-  One can customize the underlying container type by passing the KeyContainer
-  and MappedContainer template arguments:
-      QFlatMap<float, int, std::less<float>, std::vector<float>, std::vector<int>>
-*/
-
 namespace Qt {
 
 struct OrderedUniqueRange_t {};
@@ -84,6 +62,57 @@ constexpr OrderedUniqueRange_t OrderedUniqueRange = {};
 
 } // namespace Qt
 
+struct QFlatMapStringLess
+{
+    using is_transparent = void;
+
+    template <typename L, typename R>
+    bool operator()(const L &lhs, const R &rhs) const noexcept
+    {
+        return QtPrivate::compareStrings(view(lhs), view(rhs)) < 0;
+    }
+
+private:
+    static QStringView view(QStringView s) noexcept { return s; }
+    static QLatin1String view(QLatin1String s) noexcept { return s; }
+};
+
+namespace QtPrivate {
+
+// Removes equivalent elements from a sorted range of parallel containers,
+// keeping the last one of each run (i.e. later insertions win). Linear time.
+template <class Compare, class KeyContainer, class... ValueContainers>
+void makeSortedUnique(const Compare &compare, KeyContainer &keys, ValueContainers &... values)
+{
+    using size_type = typename KeyContainer::size_type;
+    const size_type n = keys.size();
+    size_type out = 0;
+    for (size_type i = 0; i < n; ++i) {
+        if (i + 1 < n && !compare(keys[i], keys[i + 1]))
+            continue;
+        if (out != i) {
+            keys[out] = std::move(keys[i]);
+            ((values[out] = std::move(values[i])), ...);
+        }
+        ++out;
+    }
+    if (out != n) {
+        keys.erase(keys.begin() + out, keys.end());
+        (values.erase(values.begin() + out, values.end()), ...);
+    }
+}
+
+template <class Compare, class KeyContainer>
+bool isSortedUnique(const Compare &compare, const KeyContainer &keys)
+{
+    return std::adjacent_find(keys.begin(), keys.end(),
+                              [&compare](const auto &a, const auto &b) {
+                                  return !compare(a, b);
+                              }) == keys.end();
+}
+
+} // namespace QtPrivate
+
 template <class Key, class T, class Compare>
 class QFlatMapValueCompare : protected Compare
 {
@@ -417,7 +446,8 @@ private:
     struct is_marked_transparent_type : std::false_type { };
 
     template <class X>
-    struct is_marked_transparent_type<X, typename X::is_transparent> : std::true_type { };
+    struct is_marked_transparent_type<X, QtPrivate::void_t<typename X::is_transparent>>
+        : std::true_type { };
 
     template <class X>
     using is_marked_transparent = typename std::enable_if<
@@ -645,6 +675,12 @@ public:
         return binary_find(key) != end();
     }
 
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    bool contains(const X &key) const
+    {
+        return binary_find(key) != end();
+    }
+
     T value(const Key &key, const T &defaultValue) const
     {
         auto it = binary_find(key);
@@ -657,6 +693,20 @@ public:
         return it == end() ? T() : it.value();
     }
 
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    T value(const X &key, const T &defaultValue) const
+    {
+        auto it = binary_find(key);
+        return it == end() ? defaultValue : it.value();
+    }
+
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    T value(const X &key) const
+    {
+        auto it = binary_find(key);
+        return it == end() ? T() : it.value();
+    }
+
     T &operator[](const Key &key)
     {
         auto it = lower_bound(key);
@@ -700,7 +750,7 @@ public:
         auto it = lower_bound(key);
         if (it == end() || key_compare::operator()(key, it.key())) {
             c.values.insert(toValuesIterator(it), value);
-            return { c.keys.insert(it, std::move(key)), true };
+            return { fromKeysIterator(c.keys.insert(toKeysIterator(it), std::move(key))), true };
         } else {
             *toValuesIterator(it) = value;
             return {it, false};
@@ -712,7 +762,7 @@ public:
         auto it = lower_bound(key);
         if (it == end() || key_compare::operator()(key, it.key())) {
             c.values.insert(toValuesIterator(it), std::move(value));
-            return { c.keys.insert(it, key), true };
+            return { fromKeysIterator(c.keys.insert(toKeysIterator(it), key)), true };
         } else {
             *toValuesIterator(it) = std::move(value);
             return {it, false};
@@ -814,6 +864,18 @@ public:
         return binary_find(k);
     }
 
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    iterator find(const X &k)
+    {
+        return binary_find(k);
+    }
+
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    const_iterator find(const X &k) const
+    {
+        return binary_find(k);
+    }
+
     key_compare key_comp() const noexcept
     {
         return static_cast<key_compare>(*this);
@@ -825,6 +887,9 @@ public:
     }
 
 private:
+    // unlike key_comp(), does not copy a stateful comparator
+    const key_compare &keyCompare() const noexcept { return *this; }
+
     template <class InputIt, is_compatible_iterator<InputIt> = nullptr>
     void initWithRange(InputIt first, InputIt last)
     {
@@ -859,14 +924,23 @@ private:
     template <class InputIt>
     void insertRange(InputIt first, InputIt last)
     {
-        size_type i = c.keys.size();
-        c.keys.resize(i + std::distance(first, last));
+        // Sort only the new elements, then merge them with the (already
+        // ordered) existing ones. Elements inserted later win.
+        const size_type s = c.keys.size();
+        size_type i = s;
+        c.keys.resize(s + std::distance(first, last));
         c.values.resize(c.keys.size());
         for (; first != last; ++first, ++i) {
             c.keys[i] = first->first;
             c.values[i] = first->second;
         }
-        ensureOrderedUnique();
+
+        std::vector<size_type> p(size_t(c.keys.size()));
+        std::iota(p.begin(), p.end(), 0);
+        std::stable_sort(p.begin() + s, p.end(), IndexedKeyComparator(this));
+        std::inplace_merge(p.begin(), p.begin() + s, p.end(), IndexedKeyComparator(this));
+        applyPermutation(p);
+        makeUnique();
     }
 
     class IndexedKeyComparator
@@ -904,12 +978,14 @@ private:
         makeUnique();
     }
 
-    iterator binary_find(const Key &key)
+    template <class X>
+    iterator binary_find(const X &key)
     {
         return { &c, const_cast<const full_map_t *>(this)->binary_find(key).i };
     }
 
-    const_iterator binary_find(const Key &key) const
+    template <class X>
+    const_iterator binary_find(const X &key) const
     {
         auto it = lower_bound(key);
         if (it != end()) {
@@ -922,6 +998,8 @@ private:
 
     void ensureOrderedUnique()
     {
+        if (QtPrivate::isSortedUnique(keyCompare(), std::as_const(c.keys)))
+            return;
         std::vector<size_type> p(size_t(c.keys.size()));
         std::iota(p.begin(), p.end(), 0);
         std::stable_sort(p.begin(), p.end(), IndexedKeyComparator(this));
@@ -951,31 +1029,192 @@ private:
 
     void makeUnique()
     {
-        if (c.keys.size() < 2)
-            return;
-        auto k = std::end(c.keys) - 1;
-        auto i = k - 1;
-        for (;;) {
-            if (key_compare::operator()(*i, *k) || key_compare::operator()(*k, *i)) {
-                if (i == std::begin(c.keys))
-                    break;
-                --i;
-                --k;
-            } else {
-                c.values.erase(std::begin(c.values) + std::distance(std::begin(c.keys), i));
-                i = c.keys.erase(i);
-                if (i == std::begin(c.keys))
-                    break;
-                k = i + 1;
-            }
+        const size_type s = c.keys.size();
+        QtPrivate::makeSortedUnique(keyCompare(), c.keys, c.values);
+        if (c.keys.size() != s) {
+            c.keys.shrink_to_fit();
+            c.values.shrink_to_fit();
         }
-        c.keys.shrink_to_fit();
-        c.values.shrink_to_fit();
     }
 
     containers c;
 };
 
+template<class Key, class Compare = std::less<Key>, class Container = QList<Key>>
+class QFlatSet : private Compare
+{
+    template <class, class = void>
+    struct is_marked_transparent_type : std::false_type { };
+
+    template <class X>
+    struct is_marked_transparent_type<X, QtPrivate::void_t<typename X::is_transparent>>
+        : std::true_type { };
+
+    template <class X>
+    using is_marked_transparent = typename std::enable_if<
+        is_marked_transparent_type<X>::value>::type *;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using container_type = Container;
+    using size_type = typename container_type::size_type;
+    using const_iterator = typename container_type::const_iterator;
+    using iterator = const_iterator;
+
+    QFlatSet() = default;
+
+    explicit QFlatSet(const Compare &compare)
+        : Compare(compare)
+    {
+    }
+
+    explicit QFlatSet(const container_type &keys, const Compare &compare = Compare())
+        : Compare(compare), c(keys)
+    {
+        ensureOrderedUnique();
+    }
+
+    explicit QFlatSet(container_type &&keys, const Compare &compare = Compare())
+        : Compare(compare), c(std::move(keys))
+    {
+        ensureOrderedUnique();
+    }
+
+    QFlatSet(std::initializer_list<Key> lst, const Compare &compare = Compare())
+        : QFlatSet(lst.begin(), lst.end(), compare)
+    {
+    }
+
+    template <class InputIt, QtPrivate::IfIsInputIterator<InputIt> = true>
+    explicit QFlatSet(InputIt first, InputIt last, const Compare &compare = Compare())
+        : Compare(compare)
+    {
+        QtPrivate::reserveIfForwardIterator(&c, first, last);
+        std::copy(first, last, std::back_inserter(c));
+        ensureOrderedUnique();
+    }
+
+    explicit QFlatSet(Qt::OrderedUniqueRange_t, const container_type &keys,
+                      const Compare &compare = Compare())
+        : Compare(compare), c(keys)
+    {
+    }
+
+    explicit QFlatSet(Qt::OrderedUniqueRange_t, container_type &&keys,
+                      const Compare &compare = Compare())
+        : Compare(compare), c(std::move(keys))
+    {
+    }
+
+    size_type count() const noexcept { return c.size(); }
+    size_type size() const noexcept { return c.size(); }
+    size_type capacity() const noexcept { return c.capacity(); }
+    bool isEmpty() const noexcept { return c.empty(); }
+    bool empty() const noexcept { return c.empty(); }
+    container_type extract() && { return std::move(c); }
+    const container_type &values() const noexcept { return c; }
+
+    void reserve(size_type s) { c.reserve(s); }
+    void clear() { c.clear(); }
+
+    std::pair<const_iterator, bool> insert(const Key &key)
+    {
+        auto it = lower_bound(key);
+        if (it == end() || keyCompare()(key, *it)) {
+            const size_type i = size_type(it - begin());
+            c.insert(c.begin() + i, key);
+            return { begin() + i, true };
+        }
+        return { it, false };
+    }
+
+    template <class InputIt, QtPrivate::IfIsInputIterator<InputIt> = true>
+    void insert(InputIt first, InputIt last)
+    {
+        // Sort only the new elements, then merge them with the (already
+        // ordered) existing ones. Existing elements win over equivalent new ones.
+        const size_type s = c.size();
+        std::copy(first, last, std::back_inserter(c));
+        std::stable_sort(c.begin() + s, c.end(), keyCompare());
+        std::inplace_merge(c.begin(), c.begin() + s, c.end(), keyCompare());
+        c.erase(std::unique(c.begin(), c.end(), [this](const Key &a, const Key &b) {
+                    return !keyCompare()(a, b);
+                }), c.end());
+    }
+
+    bool remove(const Key &key)
+    {
+        auto it = find(key);
+        if (it == end())
+            return false;
+        erase(it);
+        return true;
+    }
+
+    const_iterator erase(const_iterator it)
+    {
+        const size_type i = size_type(it - begin());
+        c.erase(c.begin() + i);
+        return begin() + i;
+    }
+
+    bool contains(const Key &key) const { return find(key) != end(); }
+
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    bool contains(const X &key) const { return find(key) != end(); }
+
+    const_iterator find(const Key &key) const { return binary_find(key); }
+
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    const_iterator find(const X &key) const { return binary_find(key); }
+
+    const_iterator lower_bound(const Key &key) const
+    {
+        return std::lower_bound(begin(), end(), key, keyCompare());
+    }
+
+    template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
+    const_iterator lower_bound(const X &key) const
+    {
+        return std::lower_bound(begin(), end(), key, keyCompare());
+    }
+
+    const_iterator begin() const { return c.cbegin(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator end() const { return c.cend(); }
+    const_iterator cend() const { return end(); }
+    const_iterator constEnd() const { return end(); }
+
+    key_compare key_comp() const noexcept { return keyCompare(); }
+    value_compare value_comp() const noexcept { return keyCompare(); }
+
+private:
+    const key_compare &keyCompare() const noexcept { return *this; }
+
+    template <class X>
+    const_iterator binary_find(const X &key) const
+    {
+        auto it = lower_bound(key);
+        if (it != end() && keyCompare()(key, *it))
+            it = end();
+        return it;
+    }
+
+    void ensureOrderedUnique()
+    {
+        if (QtPrivate::isSortedUnique(keyCompare(), std::as_const(c)))
+            return;
+        std::stable_sort(c.begin(), c.end(), keyCompare());
+        QtPrivate::makeSortedUnique(keyCompare(), c);
+    }
+
+    container_type c;
+};
+
 QT_END_NAMESPACE
 
-#endif // QFLATMAP_P_H
+#endif // QFLATMAP_H
@@ -49,6 +49,16 @@
 
 #include <initializer_list>
 
+// Only the SSE2 or NEON intrinsics header, and only if the compiler targets
+// it anyway: qsimd.h is too heavy to be pulled into every user of QHash.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define QHASH_CONTROL_SSE2
+#elif defined(__ARM_NEON) && Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+#  include <arm_neon.h>
+#  define QHASH_CONTROL_NEON
+#endif
+
 QT_BEGIN_NAMESPACE
 
 struct QHashDummyValue
@@ -243,14 +253,76 @@ constexpr bool isRelocatable()
 // actual storage space for the Nodes (the 'entries' member) or 0xff (UnusedEntry) to flag that the bucket is empty.
 // As we have only 128 entries per Span, the offset array can be represented using an unsigned char. This trick makes the hash
 // table have a very small memory overhead compared to many other implementations.
+//
+// Next to the offsets, each Span keeps a control byte per bucket. An unused bucket has a control byte of 0
+// (EmptyControl), a used one stores the top 7 bits of the key's hash with the high bit set. Lookups scan the
+// control bytes in groups of 16 buckets (with SSE2 or NEON where available) and only compare the actual keys
+// of buckets whose hash fragment matches, stopping at the first empty bucket. The probing sequence itself is
+// still plain linear probing, so bucket positions and iterator behavior are the same as without the control
+// bytes.
+
+// Result of matching a group of 16 control bytes: bit i is set in matches if the control byte of bucket i of
+// the group equals the searched one, and in empties if the bucket is unused.
+struct GroupMatch {
+    uint matches;
+    uint empties;
+};
+
+#ifdef QHASH_CONTROL_NEON
+// NEON has no movemask: the narrowing shift in matchControlGroup() yields a nibble of all ones or all zeroes
+// per bucket, which this packs into one bit per bucket.
+inline uint nibbleMaskToBits(quint64 mask) noexcept
+{
+    mask &= Q_UINT64_C(0x1111111111111111);
+    mask = (mask | (mask >> 3)) & Q_UINT64_C(0x0303030303030303);
+    mask = (mask | (mask >> 6)) & Q_UINT64_C(0x000f000f000f000f);
+    mask = (mask | (mask >> 12)) & Q_UINT64_C(0x000000ff000000ff);
+    return uint((mask | (mask >> 24)) & 0xffff);
+}
+#endif
+
+// Matches the 16 control bytes starting at group, which must be 16-byte aligned, against control. This is
+// part of the probing loop of every lookup, so it has to stay inline.
+inline GroupMatch matchControlGroup(const unsigned char *group, unsigned char control) noexcept
+{
+    Q_ASSERT((quintptr(group) & 15) == 0);
+#if defined(QHASH_CONTROL_SSE2)
+    const __m128i bytes = _mm_load_si128(reinterpret_cast<const __m128i *>(group));
+    const __m128i eq = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(control)));
+    // used buckets have the high bit set in their control byte
+    return { uint(_mm_movemask_epi8(eq)), uint(~_mm_movemask_epi8(bytes) & 0xffff) };
+#elif defined(QHASH_CONTROL_NEON)
+    const uint8x16_t bytes = vld1q_u8(group);
+    const uint8x16_t eq = vceqq_u8(bytes, vdupq_n_u8(control));
+    const uint8x16_t empty = vceqq_u8(bytes, vdupq_n_u8(0));
+    const uint8x8_t eqBits = vshrn_n_u16(vreinterpretq_u16_u8(eq), 4);
+    const uint8x8_t emptyBits = vshrn_n_u16(vreinterpretq_u16_u8(empty), 4);
+    return { nibbleMaskToBits(vget_lane_u64(vreinterpret_u64_u8(eqBits), 0)),
+             nibbleMaskToBits(vget_lane_u64(vreinterpret_u64_u8(emptyBits), 0)) };
+#else
+    GroupMatch m = { 0, 0 };
+    for (uint i = 0; i < 16; ++i) {
+        if (group[i] == control)
+            m.matches |= 1u << i;
+        else if (group[i] == 0)
+            m.empties |= 1u << i;
+    }
+    return m;
+#endif
+}
+
 template<typename Node>
 struct Span {
     enum {
         NEntries = 128,
         LocalBucketMask = (NEntries - 1),
-        UnusedEntry = 0xff
+        UnusedEntry = 0xff,
+        GroupSize = 16,
+        GroupMask = (GroupSize - 1),
+        EmptyControl = 0
     };
     static_assert ((NEntries & LocalBucketMask) == 0, "EntriesPerSpan must be a power of two.");
+    static_assert ((NEntries % GroupSize) == 0, "EntriesPerSpan must be a multiple of GroupSize.");
 
     // Entry is a slot available for storing a Node. The Span holds a pointer to
     // an array of Entries. Upon construction of the array, those entries are
@@ -265,14 +337,31 @@ struct Span {
         Node &node() { return *reinterpret_cast<Node *>(&storage); }
     };
 
+    alignas(GroupSize) unsigned char control[NEntries];
     unsigned char offsets[NEntries];
     Entry *entries = nullptr;
     unsigned char allocated = 0;
     unsigned char nextFree = 0;
     Span() noexcept
     {
+        memset(control, EmptyControl, sizeof(control));
         memset(offsets, UnusedEntry, sizeof(offsets));
     }
+
+    static constexpr unsigned char controlForHash(size_t hash) noexcept
+    {
+        return static_cast<unsigned char>(0x80 | (hash >> (8*sizeof(size_t) - 7)));
+    }
+    unsigned char controlAt(size_t i) const noexcept
+    {
+        return control[i];
+    }
+    GroupMatch matchGroup(size_t group, unsigned char c) const noexcept
+    {
+        Q_ASSERT((group & GroupMask) == 0);
+        Q_ASSERT(group + GroupSize <= NEntries);
+        return matchControlGroup(control + group, c);
+    }
     ~Span()
     {
         freeData();
@@ -290,16 +379,18 @@ struct Span {
             entries = nullptr;
         }
     }
-    Node *insert(size_t i)
+    Node *insert(size_t i, unsigned char c)
     {
         Q_ASSERT(i <= NEntries);
         Q_ASSERT(offsets[i] == UnusedEntry);
+        Q_ASSERT(c & 0x80);
         if (nextFree == allocated)
             addStorage();
         unsigned char entry = nextFree;
         Q_ASSERT(entry < allocated);
         nextFree = entries[entry].nextFree();
         offsets[i] = entry;
+        control[i] = c;
         return &entries[entry].node();
     }
     void erase(size_t bucket) noexcept(std::is_nothrow_destructible<Node>::value)
@@ -309,6 +400,7 @@ struct Span {
 
         unsigned char entry = offsets[bucket];
         offsets[bucket] = UnusedEntry;
+        control[bucket] = EmptyControl;
 
         entries[entry].node().~Node();
         entries[entry].nextFree() = nextFree;
@@ -354,6 +446,8 @@ struct Span {
         Q_ASSERT(offsets[to] == UnusedEntry);
         offsets[to] = offsets[from];
         offsets[from] = UnusedEntry;
+        control[to] = control[from];
+        control[from] = EmptyControl;
     }
     void moveFromSpan(Span &fromSpan, size_t fromIndex, size_t to) noexcept(std::is_nothrow_move_constructible_v<Node>)
     {
@@ -365,11 +459,13 @@ struct Span {
             addStorage();
         Q_ASSERT(nextFree < allocated);
         offsets[to] = nextFree;
+        control[to] = fromSpan.control[fromIndex];
         Entry &toEntry = entries[nextFree];
         nextFree = toEntry.nextFree();
 
         size_t fromOffset = fromSpan.offsets[fromIndex];
         fromSpan.offsets[fromIndex] = UnusedEntry;
+        fromSpan.control[fromIndex] = EmptyControl;
         Entry &fromEntry = fromSpan.entries[fromOffset];
 
         if constexpr (isRelocatable<Node>()) {
@@ -450,8 +546,9 @@ struct Data
         bool resized = numBuckets != other.numBuckets;
         size_t nSpans = (numBuckets + Span::LocalBucketMask) / Span::NEntries;
         spans = new Span[nSpans];
+        size_t otherNSpans = (other.numBuckets + Span::LocalBucketMask) / Span::NEntries;
 
-        for (size_t s = 0; s < nSpans; ++s) {
+        for (size_t s = 0; s < otherNSpans; ++s) {
             const Span &span = other.spans[s];
             for (size_t index = 0; index < Span::NEntries; ++index) {
                 if (!span.hasNode(index))
@@ -459,7 +556,7 @@ struct Data
                 const Node &n = span.at(index);
                 iterator it = resized ? find(n.key) : iterator{ this, s*Span::NEntries + index };
                 Q_ASSERT(it.isUnused());
-                Node *newNode = spans[it.span()].insert(it.index());
+                Node *newNode = spans[it.span()].insert(it.index(), span.controlAt(index));
                 new (newNode) Node(n);
             }
         }
@@ -523,7 +620,7 @@ struct Data
                 Node &n = span.at(index);
                 iterator it = find(n.key);
                 Q_ASSERT(it.isUnused());
-                Node *newNode = spans[it.span()].insert(it.index());
+                Node *newNode = spans[it.span()].insert(it.index(), span.controlAt(index));
                 new (newNode) Node(std::move(n));
             }
             span.freeData();
@@ -549,10 +646,20 @@ struct Data
     }
 
     iterator find(const Key &key) const noexcept
+    {
+        return find(key, qHash(key, seed));
+    }
+
+    iterator find(const Key &key, size_t hash) const noexcept
     {
         Q_ASSERT(numBuckets > 0);
-        size_t hash = qHash(key, seed);
+        const unsigned char control = Span::controlForHash(hash);
         size_t bucket = GrowthPolicy::bucketForHash(numBuckets, hash);
+        // Scan the control bytes one group at a time. Groups are aligned and never
+        // cross a Span boundary (numBuckets is a multiple of the group size), so
+        // only the first group needs to ignore the buckets before the start bucket.
+        uint startMask = ~0u << (bucket & Span::GroupMask);
+        bucket &= ~size_t(Span::GroupMask);
         // loop over the buckets until we find the entry we search for
         // or an empty slot, in which case we know the entry doesn't exist
         while (true) {
@@ -560,16 +667,25 @@ struct Data
             // offset inside the span
             size_t span = bucket / Span::NEntries;
             size_t index = bucket & Span::LocalBucketMask;
-            Span &s = spans[span];
-            size_t offset = s.offset(index);
-            if (offset == Span::UnusedEntry) {
-                return iterator{ this, bucket };
-            } else {
-                Node &n = s.atOffset(offset);
-                if (n.key == key)
-                    return iterator{ this, bucket };
+            const Span &s = spans[span];
+            auto group = s.matchGroup(index, control);
+            uint matches = group.matches & startMask;
+            uint empties = group.empties & startMask;
+            // only candidates in front of the first empty bucket are part of the probing sequence
+            if (empties)
+                matches &= (empties & (~empties + 1)) - 1;
+            while (matches) {
+                size_t i = qCountTrailingZeroBits(matches);
+                if (s.at(index + i).key == key)
+                    return iterator{ this, bucket + i };
+                matches &= matches - 1;
             }
-            bucket = nextBucket(bucket);
+            if (empties)
+                return iterator{ this, bucket + qCountTrailingZeroBits(empties) };
+            startMask = ~0u;
+            bucket += Span::GroupSize;
+            if (bucket == numBuckets)
+                bucket = 0;
         }
     }
 
@@ -592,9 +708,10 @@ struct Data
     {
         if (shouldGrow())
             rehash(size + 1);
-        iterator it = find(key);
+        size_t hash = qHash(key, seed);
+        iterator it = find(key, hash);
         if (it.isUnused()) {
-            spans[it.span()].insert(it.index());
+            spans[it.span()].insert(it.index(), Span::controlForHash(hash));
             ++size;
             return { it, false };
         }
@@ -1997,4 +2114,7 @@ inline size_t qHash(const QMultiHash<Key, T> &key, size_t seed = 0)
 
 QT_END_NAMESPACE
 
+#undef QHASH_CONTROL_SSE2
+#undef QHASH_CONTROL_NEON
+
 #endif // QHASH_H
@@ -0,0 +1,495 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qsha_p.h"
+
+#include <qbytearrayview.h>
+#include <qendian.h>
+#include <private/qsimd_p.h>
+
+#include <string.h>
+
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SHA)
+#  define QT_SHA_INSTRUCTIONS_X86
+#elif defined(Q_PROCESSOR_ARM_V8) && QT_COMPILER_SUPPORTS_HERE(SHA2)
+#  define QT_SHA_INSTRUCTIONS_ARM
+#  include <arm_neon.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+enum : qsizetype { BlockLength = 64 };
+
+alignas(16) const quint32 sha1RoundConstants[4] = {
+    0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6
+};
+
+alignas(16) const quint32 sha256RoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+/*
+    Writes the padding of a message of \a totalLength bytes, whose last
+    \a restLength (< 64) bytes are at \a rest, to \a tail and returns the
+    number of blocks in \a tail (1 or 2).
+*/
+inline int padMessage(uchar *tail, const uchar *rest, qsizetype restLength, quint64 totalLength)
+{
+    const int blocks = restLength + 1 + 8 <= BlockLength ? 1 : 2;
+    memcpy(tail, rest, restLength);
+    tail[restLength] = 0x80;
+    memset(tail + restLength + 1, 0, blocks * BlockLength - restLength - 1 - 8);
+    qToBigEndian(totalLength * 8, tail + blocks * BlockLength - 8);
+    return blocks;
+}
+
+#if defined(QT_SHA_INSTRUCTIONS_X86)
+/*
+    The SHA-NI code keeps the state in the lane order the instructions want:
+    ABCD reversed (and E in the top lane of a separate register) for SHA-1;
+    ABEF and CDGH for SHA-256.
+*/
+QT_FUNCTION_TARGET(SHA)
+void sha1Blocks(quint32 *state, const uchar *data, qsizetype blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0001020304050607LL, 0x08090a0b0c0d0e0fLL);
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0x1b);
+    __m128i e = _mm_set_epi32(int(state[4]), 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += BlockLength) {
+        const __m128i abcdSaved = abcd;
+        const __m128i eSaved = e;
+
+        // w[i % 4] holds words 4 * i to 4 * i + 3 of the message schedule
+        __m128i w[4];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            w[i] = _mm_shuffle_epi8(w[i], byteSwap);
+        }
+
+        __m128i previous = abcd;
+        __m128i ew = _mm_add_epi32(e, w[0]);
+        for (int i = 0; i < 20; ++i) {
+            if (i) {
+                ew = _mm_sha1nexte_epu32(previous, w[i % 4]);
+                previous = abcd;
+            }
+            switch (i / 5) {
+            case 0: abcd = _mm_sha1rnds4_epu32(abcd, ew, 0); break;
+            case 1: abcd = _mm_sha1rnds4_epu32(abcd, ew, 1); break;
+            case 2: abcd = _mm_sha1rnds4_epu32(abcd, ew, 2); break;
+            default: abcd = _mm_sha1rnds4_epu32(abcd, ew, 3); break;
+            }
+            if (i < 16) {
+                __m128i next = _mm_sha1msg1_epu32(w[i % 4], w[(i + 1) % 4]);
+                next = _mm_xor_si128(next, w[(i + 2) % 4]);
+                w[i % 4] = _mm_sha1msg2_epu32(next, w[(i + 3) % 4]);
+            }
+        }
+
+        e = _mm_sha1nexte_epu32(previous, eSaved);
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = quint32(_mm_extract_epi32(e, 3));
+}
+
+QT_FUNCTION_TARGET(SHA)
+void sha256Blocks(quint32 *state, const uchar *data, qsizetype blocks)
+{
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+    const __m128i dcba = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state)), 0xb1);
+    const __m128i hgfe = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(state + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(dcba, hgfe, 8);
+    __m128i cdgh = _mm_blend_epi16(hgfe, dcba, 0xf0);
+
+    for ( ; blocks; --blocks, data += BlockLength) {
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+
+        __m128i w[4];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i));
+            w[i] = _mm_shuffle_epi8(w[i], byteSwap);
+        }
+
+        for (int i = 0; i < 16; ++i) {
+            const __m128i k = _mm_load_si128(reinterpret_cast<const __m128i *>(sha256RoundConstants + 4 * i));
+            const __m128i wk = _mm_add_epi32(w[i % 4], k);
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            if (i < 12) {
+                __m128i next = _mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+                w[i % 4] = _mm_sha256msg2_epu32(next, w[(i + 3) % 4]);
+            }
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+        }
+
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state), _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(state + 4), _mm_alignr_epi8(dchg, feba, 8));
+}
+#elif defined(QT_SHA_INSTRUCTIONS_ARM)
+void sha1Blocks(quint32 *state, const uchar *data, qsizetype blocks)
+{
+    uint32x4_t abcd = vld1q_u32(state);
+    quint32 e = state[4];
+
+    for ( ; blocks; --blocks, data += BlockLength) {
+        const uint32x4_t abcdSaved = abcd;
+        const quint32 eSaved = e;
+
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; ++i)
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+
+        for (int i = 0; i < 20; ++i) {
+            const uint32x4_t wk = vaddq_u32(w[i % 4], vdupq_n_u32(sha1RoundConstants[i / 5]));
+            const quint32 nextE = vsha1h_u32(vgetq_lane_u32(abcd, 0));
+            if (i < 5)
+                abcd = vsha1cq_u32(abcd, e, wk);
+            else if (i < 10 || i >= 15)
+                abcd = vsha1pq_u32(abcd, e, wk);
+            else
+                abcd = vsha1mq_u32(abcd, e, wk);
+            e = nextE;
+            if (i < 16) {
+                const uint32x4_t next = vsha1su0q_u32(w[i % 4], w[(i + 1) % 4], w[(i + 2) % 4]);
+                w[i % 4] = vsha1su1q_u32(next, w[(i + 3) % 4]);
+            }
+        }
+
+        abcd = vaddq_u32(abcd, abcdSaved);
+        e += eSaved;
+    }
+
+    vst1q_u32(state, abcd);
+    state[4] = e;
+}
+
+void sha256Blocks(quint32 *state, const uchar *data, qsizetype blocks)
+{
+    uint32x4_t abcd = vld1q_u32(state);
+    uint32x4_t efgh = vld1q_u32(state + 4);
+
+    for ( ; blocks; --blocks, data += BlockLength) {
+        const uint32x4_t abcdSaved = abcd;
+        const uint32x4_t efghSaved = efgh;
+
+        uint32x4_t w[4];
+        for (int i = 0; i < 4; ++i)
+            w[i] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(data + 16 * i)));
+
+        for (int i = 0; i < 16; ++i) {
+            const uint32x4_t wk = vaddq_u32(w[i % 4], vld1q_u32(sha256RoundConstants + 4 * i));
+            if (i < 12) {
+                const uint32x4_t next = vsha256su0q_u32(w[i % 4], w[(i + 1) % 4]);
+                w[i % 4] = vsha256su1q_u32(next, w[(i + 2) % 4], w[(i + 3) % 4]);
+            }
+            const uint32x4_t previous = abcd;
+            abcd = vsha256hq_u32(abcd, efgh, wk);
+            efgh = vsha256h2q_u32(efgh, previous, wk);
+        }
+
+        abcd = vaddq_u32(abcd, abcdSaved);
+        efgh = vaddq_u32(efgh, efghSaved);
+    }
+
+    vst1q_u32(state, abcd);
+    vst1q_u32(state + 4, efgh);
+}
+#endif
+
+inline bool hasShaInstructions()
+{
+#if defined(QT_SHA_INSTRUCTIONS_X86)
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+#elif defined(QT_SHA_INSTRUCTIONS_ARM)
+    return qCpuHasFeature(SHA2);
+#else
+    return false;
+#endif
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+/*
+    Multi-buffer SHA-256: each of the 8 lanes of a vector belongs to a
+    different message, so one pass of the scalar algorithm on vectors
+    compresses one block of 8 messages.
+*/
+template <int C>
+QT_FUNCTION_TARGET(AVX2)
+inline __m256i rotateRight(__m256i x)
+{
+    return _mm256_or_si256(_mm256_srli_epi32(x, C), _mm256_slli_epi32(x, 32 - C));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+inline __m256i add(__m256i a, __m256i b)
+{
+    return _mm256_add_epi32(a, b);
+}
+
+QT_FUNCTION_TARGET(AVX2)
+inline __m256i xor3(__m256i a, __m256i b, __m256i c)
+{
+    return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+// rows[i] holds 8 consecutive words of lane i; afterwards rows[j] holds word j of all lanes
+QT_FUNCTION_TARGET(AVX2)
+inline void transpose(__m256i *rows)
+{
+    __m256i t[8];
+    for (int i = 0; i < 8; i += 2) {
+        t[i] = _mm256_unpacklo_epi32(rows[i], rows[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(rows[i], rows[i + 1]);
+    }
+    __m256i u[8];
+    for (int i = 0; i < 8; i += 4) {
+        u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        rows[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+// compresses the block at blocks[i] into lane i of states (stored word by word)
+QT_FUNCTION_TARGET(AVX2)
+void sha256Blocks8(quint32 (*states)[8], const uchar *const *blocks)
+{
+    const __m256i byteSwap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    __m256i w[16];
+    for (int half = 0; half < 2; ++half) {
+        for (int i = 0; i < 8; ++i)
+            w[8 * half + i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(blocks[i] + 32 * half));
+        transpose(w + 8 * half);
+    }
+    for (__m256i &word : w)
+        word = _mm256_shuffle_epi8(word, byteSwap);
+
+    __m256i s[8];
+    for (int i = 0; i < 8; ++i)
+        s[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(states[i]));
+    __m256i a = s[0], b = s[1], c = s[2], d = s[3], e = s[4], f = s[5], g = s[6], h = s[7];
+
+    for (int t = 0; t < 64; ++t) {
+        __m256i &wt = w[t % 16];
+        if (t >= 16) {
+            const __m256i w15 = w[(t - 15) % 16];
+            const __m256i w2 = w[(t - 2) % 16];
+            const __m256i sigma0 = xor3(rotateRight<7>(w15), rotateRight<18>(w15), _mm256_srli_epi32(w15, 3));
+            const __m256i sigma1 = xor3(rotateRight<17>(w2), rotateRight<19>(w2), _mm256_srli_epi32(w2, 10));
+            wt = add(add(wt, sigma0), add(w[(t - 7) % 16], sigma1));
+        }
+        const __m256i bigSigma1 = xor3(rotateRight<6>(e), rotateRight<11>(e), rotateRight<25>(e));
+        const __m256i choose = _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g));
+        const __m256i k = _mm256_set1_epi32(int(sha256RoundConstants[t]));
+        const __m256i temp1 = add(add(h, bigSigma1), add(choose, add(k, wt)));
+        const __m256i bigSigma0 = xor3(rotateRight<2>(a), rotateRight<13>(a), rotateRight<22>(a));
+        const __m256i majority = _mm256_or_si256(_mm256_and_si256(a, b),
+                                                 _mm256_and_si256(c, _mm256_or_si256(a, b)));
+        const __m256i temp2 = add(bigSigma0, majority);
+        h = g;
+        g = f;
+        f = e;
+        e = add(d, temp1);
+        d = c;
+        c = b;
+        b = a;
+        a = add(temp1, temp2);
+    }
+
+    const __m256i result[8] = { a, b, c, d, e, f, g, h };
+    for (int i = 0; i < 8; ++i)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(states[i]), add(s[i], result[i]));
+}
+
+QT_FUNCTION_TARGET(AVX2)
+void sha256ManyAvx2(const quint32 *initialState, const QByteArrayView *messages, qsizetype count,
+                    quint32 *out)
+{
+    struct Lane {
+        const uchar *data;      // the full blocks of the message that are left
+        qsizetype blocks;
+        int tailBlocks;         // the padded blocks that are left, after those
+        int tailIndex;
+        qsizetype message;      // -1 if the lane is idle
+        uchar tail[2 * BlockLength];
+    };
+    static const uchar idleBlock[BlockLength] = {};
+
+    Lane lanes[8];
+    quint32 states[8][8];       // word, lane
+    qsizetype nextMessage = 0;
+    int busy = 0;
+    const auto start = [&](int lane) {
+        Lane &l = lanes[lane];
+        if (nextMessage == count) {
+            l.message = -1;
+            return;
+        }
+        const QByteArrayView message = messages[nextMessage];
+        l.message = nextMessage++;
+        l.data = reinterpret_cast<const uchar *>(message.data());
+        l.blocks = message.size() / BlockLength;
+        l.tailBlocks = padMessage(l.tail, l.data + l.blocks * BlockLength,
+                                  message.size() % BlockLength, quint64(message.size()));
+        l.tailIndex = 0;
+        for (int i = 0; i < 8; ++i)
+            states[i][lane] = initialState[i];
+        ++busy;
+    };
+    for (int lane = 0; lane < 8; ++lane)
+        start(lane);
+
+    while (busy) {
+        const uchar *blocks[8];
+        for (int lane = 0; lane < 8; ++lane) {
+            Lane &l = lanes[lane];
+            if (l.message < 0) {
+                blocks[lane] = idleBlock;
+            } else if (l.blocks) {
+                blocks[lane] = l.data;
+                l.data += BlockLength;
+                --l.blocks;
+            } else {
+                blocks[lane] = l.tail + BlockLength * l.tailIndex++;
+            }
+        }
+        sha256Blocks8(states, blocks);
+        for (int lane = 0; lane < 8; ++lane) {
+            Lane &l = lanes[lane];
+            if (l.message < 0 || l.blocks || l.tailIndex < l.tailBlocks)
+                continue;
+            for (int i = 0; i < 8; ++i)
+                out[8 * l.message + i] = states[i][lane];
+            --busy;
+            start(lane);
+        }
+    }
+}
+#endif // AVX2
+
+} // unnamed namespace
+
+bool qt_sha1ProcessBlocks(quint32 *state, const uchar *data, qsizetype blocks)
+{
+#if defined(QT_SHA_INSTRUCTIONS_X86) || defined(QT_SHA_INSTRUCTIONS_ARM)
+    if (hasShaInstructions()) {
+        sha1Blocks(state, data, blocks);
+        return true;
+    }
+#else
+    Q_UNUSED(state);
+    Q_UNUSED(data);
+    Q_UNUSED(blocks);
+#endif
+    return false;
+}
+
+bool qt_sha256ProcessBlocks(quint32 *state, const uchar *data, qsizetype blocks)
+{
+#if defined(QT_SHA_INSTRUCTIONS_X86) || defined(QT_SHA_INSTRUCTIONS_ARM)
+    if (hasShaInstructions()) {
+        sha256Blocks(state, data, blocks);
+        return true;
+    }
+#else
+    Q_UNUSED(state);
+    Q_UNUSED(data);
+    Q_UNUSED(blocks);
+#endif
+    return false;
+}
+
+bool qt_sha256Many(const quint32 *initialState, const QByteArrayView *messages, qsizetype count,
+                   quint32 *states)
+{
+#if defined(QT_SHA_INSTRUCTIONS_X86) || defined(QT_SHA_INSTRUCTIONS_ARM)
+    // one message at a time with the SHA instructions is faster than 8 with AVX2
+    if (hasShaInstructions()) {
+        for (qsizetype i = 0; i < count; ++i, states += 8) {
+            const uchar *data = reinterpret_cast<const uchar *>(messages[i].data());
+            const qsizetype blocks = messages[i].size() / BlockLength;
+            uchar tail[2 * BlockLength];
+            const int tailBlocks = padMessage(tail, data + blocks * BlockLength,
+                                              messages[i].size() % BlockLength,
+                                              quint64(messages[i].size()));
+            memcpy(states, initialState, 8 * sizeof(quint32));
+            sha256Blocks(states, data, blocks);
+            sha256Blocks(states, tail, tailBlocks);
+        }
+        return true;
+    }
+#endif
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2)) {
+        sha256ManyAvx2(initialState, messages, count, states);
+        return true;
+    }
+#endif
+    Q_UNUSED(initialState);
+    Q_UNUSED(messages);
+    Q_UNUSED(count);
+    Q_UNUSED(states);
+    return false;
+}
+
+QT_END_NAMESPACE
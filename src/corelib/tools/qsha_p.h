@@ -0,0 +1,76 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPL3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl-3.0.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or (at your option) the GNU General
+** Public license version 3 or any later version approved by the KDE Free
+** Qt Foundation. The licenses are as published by the Free Software
+** Foundation and appearing in the file LICENSE.GPL2 and LICENSE.GPL3
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-2.0.html and
+** https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QSHA_P_H
+#define QSHA_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QByteArrayView;
+
+// SHA-1 and SHA-256 compression with the CPU's SHA instructions (SHA-NI on
+// x86, the cryptography extension on ARMv8), for QCryptographicHash. They
+// process \a blocks 64-byte blocks at \a data into \a state (5 or 8 words)
+// and return false, leaving \a state alone, if the CPU lacks the instructions.
+bool qt_sha1ProcessBlocks(quint32 *state, const uchar *data, qsizetype blocks);
+bool qt_sha256ProcessBlocks(quint32 *state, const uchar *data, qsizetype blocks);
+
+// Hashes \a count complete messages with SHA-256 (or SHA-224, depending on
+// \a initialState), storing 8 state words per message in \a states. Uses the
+// SHA instructions, or else hashes 8 messages at a time with AVX2. Returns
+// false if neither is available.
+bool qt_sha256Many(const quint32 *initialState, const QByteArrayView *messages, qsizetype count,
+                   quint32 *states);
+
+QT_END_NAMESPACE
+
+#endif // QSHA_P_H
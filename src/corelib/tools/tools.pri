@@ -4,16 +4,18 @@ intel_icc: QMAKE_CXXFLAGS += -fp-model strict
 
 HEADERS +=  \
         tools/qalgorithms.h \
+        tools/qarenaallocator_p.h \
         tools/qarraydata.h \
         tools/qarraydataops.h \
         tools/qarraydatapointer.h \
         tools/qbitarray.h \
+        tools/qblake3_p.h \
         tools/qcache.h \
         tools/qcontainerfwd.h \
         tools/qcontainertools_impl.h \
         tools/qcryptographichash.h \
         tools/qduplicatetracker_p.h \
-        tools/qflatmap_p.h \
+        tools/qflatmap.h \
         tools/qfreelist_p.h \
         tools/qhash.h \
         tools/qhashfunctions.h \
@@ -41,6 +43,7 @@ HEADERS +=  \
         tools/qsharedpointer.h \
         tools/qsharedpointer_impl.h \
         tools/qset.h \
+        tools/qsha_p.h \
         tools/qsize.h \
         tools/qstack.h \
         tools/qtools_p.h \
@@ -50,8 +53,10 @@ HEADERS +=  \
         tools/qversionnumber.h
 
 SOURCES += \
+        tools/qarenaallocator.cpp \
         tools/qarraydata.cpp \
         tools/qbitarray.cpp \
+        tools/qblake3.cpp \
         tools/qcryptographichash.cpp \
         tools/qfreelist.cpp \
         tools/qhash.cpp \
@@ -63,6 +68,7 @@ SOURCES += \
         tools/qrect.cpp \
         tools/qrefcount.cpp \
         tools/qringbuffer.cpp \
+        tools/qsha.cpp \
         tools/qshareddata.cpp \
         tools/qsharedpointer.cpp \
         tools/qsize.cpp \
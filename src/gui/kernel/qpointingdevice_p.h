@@ -55,7 +55,7 @@
 #include <QtGui/qpointingdevice.h>
 #include <QtGui/private/qtguiglobal_p.h>
 #include <QtGui/private/qinputdevice_p.h>
-#include <QtCore/private/qflatmap_p.h>
+#include <QtCore/qflatmap.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -161,6 +161,28 @@ socklen_t sctpInitMsgSize = sizeof(sctpInitMsg);
 "# FIXME: use: unmapped library: network
 )
 
+# sendmmsg
+qt_config_compile_test(sendmmsg
+    LABEL "recvmmsg() and sendmmsg()"
+    CODE
+"
+#include <sys/types.h>
+#include <sys/socket.h>
+
+int main(int argc, char **argv)
+{
+    (void)argc; (void)argv;
+    /* BEGIN TEST: */
+struct mmsghdr msgs[2] = {};
+(void) recvmmsg(-1, msgs, 2, MSG_DONTWAIT, 0);
+(void) sendmmsg(-1, msgs, 2, 0);
+(void) msgs[0].msg_len;
+    /* END TEST: */
+    return 0;
+}
+"# FIXME: use: unmapped library: network
+)
+
 # dtls
 qt_config_compile_test(dtls
     LABEL "DTLS support in OpenSSL"
@@ -316,6 +338,10 @@ qt_feature("sctp" PUBLIC
     CONDITION TEST_sctp
 )
 qt_feature_definition("sctp" "QT_NO_SCTP" NEGATE VALUE "1")
+qt_feature("sendmmsg" PRIVATE
+    LABEL "recvmmsg()/sendmmsg()"
+    CONDITION UNIX AND TEST_sendmmsg
+)
 qt_feature("system-proxies" PRIVATE
     LABEL "Use system proxies"
 )
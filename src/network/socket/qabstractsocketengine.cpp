@@ -44,6 +44,8 @@
 #include "qmutex.h"
 #include "qnetworkproxy.h"
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QSocketEngineHandlerList : public QList<QSocketEngineHandler*>
@@ -259,6 +261,66 @@ void QAbstractSocketEngine::setPeerPort(quint16 port)
     d_func()->peerPort = port;
 }
 
+#ifndef QT_NO_UDPSOCKET
+/*
+    Reads up to \a maxCount pending datagrams of at most \a maxlen bytes
+    each, or of their full size if \a maxlen is -1, and appends them to
+    \a datagrams, which takes ownership of them. Returns how many were read,
+    or -1 if an error occurred before any datagram could be read.
+
+    This implementation calls readDatagram() once per datagram; engines
+    that can receive several datagrams in one system call reimplement it.
+*/
+qint64 QAbstractSocketEngine::readDatagrams(QList<QNetworkDatagramPrivate *> *datagrams,
+                                            qint64 maxCount, qint64 maxlen,
+                                            PacketHeaderOptions options)
+{
+    qint64 received = 0;
+    while (received < maxCount && hasPendingDatagrams()) {
+        const qint64 size = maxlen < 0 ? pendingDatagramSize() : maxlen;
+        if (size < 0)
+            break;
+        std::unique_ptr<QNetworkDatagramPrivate> datagram(
+                    new QNetworkDatagramPrivate(QByteArray(size, Qt::Uninitialized)));
+        const qint64 readBytes = readDatagram(datagram->data.data(), size,
+                                              &datagram->header, options);
+        if (readBytes < 0) {
+            if (readBytes == -2 || received)
+                break;
+            return -1;
+        }
+        datagram->data.truncate(readBytes);
+        datagrams->append(datagram.release());
+        ++received;
+    }
+    return received;
+}
+
+/*
+    Sends the first \a count entries of \a datagrams and returns how many
+    were sent, or -1 if an error occurred before any datagram was sent.
+
+    This implementation calls writeDatagram() once per datagram; engines
+    that can send several datagrams in one system call reimplement it.
+*/
+qint64 QAbstractSocketEngine::writeDatagrams(const QNetworkDatagramPrivate * const *datagrams,
+                                             qint64 count)
+{
+    qint64 sent = 0;
+    for ( ; sent < count; ++sent) {
+        const QNetworkDatagramPrivate *datagram = datagrams[sent];
+        const qint64 written = writeDatagram(datagram->data.constData(), datagram->data.size(),
+                                             datagram->header);
+        if (written < 0) {
+            if (written == -2 || sent)
+                break;
+            return -1;
+        }
+    }
+    return sent;
+}
+#endif // QT_NO_UDPSOCKET
+
 int QAbstractSocketEngine::inboundStreamCount() const
 {
     return d_func()->inboundStreamCount;
@@ -154,6 +154,10 @@ public:
 
     virtual bool hasPendingDatagrams() const = 0;
     virtual qint64 pendingDatagramSize() const = 0;
+
+    virtual qint64 readDatagrams(QList<QNetworkDatagramPrivate *> *datagrams, qint64 maxCount,
+                                 qint64 maxlen, PacketHeaderOptions = WantNone);
+    virtual qint64 writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, qint64 count);
 #endif // QT_NO_UDPSOCKET
 
     virtual qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader *header = nullptr,
@@ -842,6 +842,49 @@ qint64 QNativeSocketEngine::pendingDatagramSize() const
 
     return d->nativePendingDatagramSize();
 }
+
+#if QT_CONFIG(sendmmsg)
+/*!
+    Reads up to \a maxCount pending datagrams of at most \a maxSize bytes
+    each, or of any size if \a maxSize is -1, with as few system calls as
+    possible. They are appended to \a datagrams, which takes ownership of
+    them, and the number of datagrams read is returned. Header fields are
+    stored according to the request in \a options, as with readDatagram().
+
+    Returns -1 if an error occurred before any datagram was read.
+
+    \sa readDatagram()
+*/
+qint64 QNativeSocketEngine::readDatagrams(QList<QNetworkDatagramPrivate *> *datagrams,
+                                          qint64 maxCount, qint64 maxSize,
+                                          PacketHeaderOptions options)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::readDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::readDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+    return d->nativeReceiveDatagrams(datagrams, maxCount, maxSize, options);
+}
+
+/*!
+    Sends the first \a count entries of \a datagrams with as few system
+    calls as possible, and returns the number of datagrams sent, or -1
+    if an error occurred before any datagram was sent.
+
+    \sa writeDatagram()
+*/
+qint64 QNativeSocketEngine::writeDatagrams(const QNetworkDatagramPrivate * const *datagrams,
+                                           qint64 count)
+{
+    Q_D(QNativeSocketEngine);
+    Q_CHECK_VALID_SOCKETLAYER(QNativeSocketEngine::writeDatagrams(), -1);
+    Q_CHECK_STATES(QNativeSocketEngine::writeDatagrams(), QAbstractSocket::BoundState,
+                   QAbstractSocket::ConnectedState, -1);
+
+    return d->nativeSendDatagrams(datagrams, count);
+}
+#endif // QT_CONFIG(sendmmsg)
 #endif // QT_NO_UDPSOCKET
 
 /*!
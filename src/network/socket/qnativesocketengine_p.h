@@ -159,6 +159,12 @@ public:
 
     bool hasPendingDatagrams() const override;
     qint64 pendingDatagramSize() const override;
+
+#if QT_CONFIG(sendmmsg)
+    qint64 readDatagrams(QList<QNetworkDatagramPrivate *> *datagrams, qint64 maxCount,
+                         qint64 maxlen, PacketHeaderOptions = WantNone) override;
+    qint64 writeDatagrams(const QNetworkDatagramPrivate * const *datagrams, qint64 count) override;
+#endif
 #endif // QT_NO_UDPSOCKET
 
     qint64 readDatagram(char *data, qint64 maxlen, QIpPacketHeader * = nullptr,
@@ -277,6 +283,14 @@ public:
     qint64 nativeReceiveDatagram(char *data, qint64 maxLength, QIpPacketHeader *header,
                                  QAbstractSocketEngine::PacketHeaderOptions options);
     qint64 nativeSendDatagram(const char *data, qint64 length, const QIpPacketHeader &header);
+#if QT_CONFIG(sendmmsg)
+    qint64 nativeReceiveDatagrams(QList<QNetworkDatagramPrivate *> *datagrams, qint64 maxCount,
+                                  qint64 maxLength,
+                                  QAbstractSocketEngine::PacketHeaderOptions options);
+    qint64 nativeSendDatagrams(const QNetworkDatagramPrivate * const *datagrams, qint64 count);
+
+    QByteArray datagramBatchBuffer;
+#endif
     qint64 nativeRead(char *data, qint64 maxLength);
     qint64 nativeWrite(const char *data, qint64 length);
     int nativeSelect(int timeout, bool selectForRead) const;
@@ -935,11 +935,11 @@ qint64 QNativeSocketEnginePrivate::nativePendingDatagramSize() const
     return qint64(recvResult);
 }
 
-qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
-                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+namespace {
+// we use quintptr to force the alignment
+struct ReceiveControlBuffer
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+    quintptr data[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
 #if !defined(IP_PKTINFO) && defined(IP_RECVIF) && defined(Q_OS_BSD4)
                    + CMSG_SPACE(sizeof(sockaddr_dl))
 #endif
@@ -947,7 +947,105 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
                    + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
 #endif
                    + sizeof(quintptr) - 1) / sizeof(quintptr)];
+};
+
+struct SendControlBuffer
+{
+    quintptr data[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
+#ifndef QT_NO_SCTP
+                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
+#endif
+                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+};
+} // unnamed namespace
+
+static void qt_prepareReceiveMessage(msghdr *msg, iovec *vec, qt_sockaddr *aa, ReceiveControlBuffer *cbuf,
+                                     QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    msg->msg_iov = vec;
+    msg->msg_iovlen = 1;
+    if (options & QAbstractSocketEngine::WantDatagramSender) {
+        msg->msg_name = aa;
+        msg->msg_namelen = sizeof(*aa);
+    }
+    if (options & (QAbstractSocketEngine::WantDatagramHopLimit | QAbstractSocketEngine::WantDatagramDestination
+                   | QAbstractSocketEngine::WantStreamNumber)) {
+        msg->msg_control = cbuf->data;
+        msg->msg_controllen = sizeof(cbuf->data);
+    }
+}
+
+static void qt_parseReceivedHeader(msghdr *msg, qt_sockaddr *aa, quint16 localPort, QIpPacketHeader *header)
+{
+    qt_socket_getPortAndAddress(aa, &header->senderPort, &header->senderAddress);
+    header->destinationPort = localPort;
+    header->endOfRecord = (msg->msg_flags & MSG_EOR) != 0;
+
+    // parse the ancillary data
+    struct cmsghdr *cmsgptr;
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_CLANG("-Wsign-compare")
+    for (cmsgptr = CMSG_FIRSTHDR(msg); cmsgptr != nullptr;
+         cmsgptr = CMSG_NXTHDR(msg, cmsgptr)) {
+        QT_WARNING_POP
+        if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
+            in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
+            header->ifindex = info->ipi6_ifindex;
+            if (header->ifindex)
+                header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
+        }
+
+#ifdef IP_PKTINFO
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
+            in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
+            header->ifindex = info->ipi_ifindex;
+        }
+#else
+#  ifdef IP_RECVDSTADDR
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
+            in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
+
+            header->destinationAddress.setAddress(ntohl(addr->s_addr));
+        }
+#  endif
+#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
+        if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
+                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
+            sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
+            header->ifindex = sdl->sdl_index;
+        }
+#  endif
+#endif
+
+        if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
+                && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
+                    || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
+            static_assert(sizeof(header->hopLimit) == sizeof(int));
+            memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
+        }
+
+#ifndef QT_NO_SCTP
+        if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
+            && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
+            sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
 
+            header->streamNumber = int(rcvInfo->sinfo_stream);
+        }
+#endif
+    }
+}
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxSize, QIpPacketHeader *header,
+                                                         QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    ReceiveControlBuffer cbuf;
     struct msghdr msg;
     struct iovec vec;
     qt_sockaddr aa;
@@ -958,17 +1056,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     // we need to receive at least one byte, even if our user isn't interested in it
     vec.iov_base = maxSize ? data : &c;
     vec.iov_len = maxSize ? maxSize : 1;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    if (options & QAbstractSocketEngine::WantDatagramSender) {
-        msg.msg_name = &aa;
-        msg.msg_namelen = sizeof(aa);
-    }
-    if (options & (QAbstractSocketEngine::WantDatagramHopLimit | QAbstractSocketEngine::WantDatagramDestination
-                   | QAbstractSocketEngine::WantStreamNumber)) {
-        msg.msg_control = cbuf;
-        msg.msg_controllen = sizeof(cbuf);
-    }
+    qt_prepareReceiveMessage(&msg, &vec, &aa, &cbuf, options);
 
     ssize_t recvResult = 0;
     do {
@@ -994,69 +1082,7 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
             header->clear();
     } else if (options != QAbstractSocketEngine::WantNone) {
         Q_ASSERT(header);
-        qt_socket_getPortAndAddress(&aa, &header->senderPort, &header->senderAddress);
-        header->destinationPort = localPort;
-        header->endOfRecord = (msg.msg_flags & MSG_EOR) != 0;
-
-        // parse the ancillary data
-        struct cmsghdr *cmsgptr;
-        QT_WARNING_PUSH
-        QT_WARNING_DISABLE_CLANG("-Wsign-compare")
-        for (cmsgptr = CMSG_FIRSTHDR(&msg); cmsgptr != nullptr;
-             cmsgptr = CMSG_NXTHDR(&msg, cmsgptr)) {
-            QT_WARNING_POP
-            if (cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in6_pktinfo))) {
-                in6_pktinfo *info = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(reinterpret_cast<quint8 *>(&info->ipi6_addr));
-                header->ifindex = info->ipi6_ifindex;
-                if (header->ifindex)
-                    header->destinationAddress.setScopeId(QString::number(info->ipi6_ifindex));
-            }
-
-#ifdef IP_PKTINFO
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_PKTINFO
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_pktinfo))) {
-                in_pktinfo *info = reinterpret_cast<in_pktinfo *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(info->ipi_addr.s_addr));
-                header->ifindex = info->ipi_ifindex;
-            }
-#else
-#  ifdef IP_RECVDSTADDR
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVDSTADDR
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(in_addr))) {
-                in_addr *addr = reinterpret_cast<in_addr *>(CMSG_DATA(cmsgptr));
-
-                header->destinationAddress.setAddress(ntohl(addr->s_addr));
-            }
-#  endif
-#  if defined(IP_RECVIF) && defined(Q_OS_BSD4)
-            if (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_RECVIF
-                    && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sockaddr_dl))) {
-                sockaddr_dl *sdl = reinterpret_cast<sockaddr_dl *>(CMSG_DATA(cmsgptr));
-                header->ifindex = sdl->sdl_index;
-            }
-#  endif
-#endif
-
-            if (cmsgptr->cmsg_len == CMSG_LEN(sizeof(int))
-                    && ((cmsgptr->cmsg_level == IPPROTO_IPV6 && cmsgptr->cmsg_type == IPV6_HOPLIMIT)
-                        || (cmsgptr->cmsg_level == IPPROTO_IP && cmsgptr->cmsg_type == IP_TTL))) {
-                static_assert(sizeof(header->hopLimit) == sizeof(int));
-                memcpy(&header->hopLimit, CMSG_DATA(cmsgptr), sizeof(header->hopLimit));
-            }
-
-#ifndef QT_NO_SCTP
-            if (cmsgptr->cmsg_level == IPPROTO_SCTP && cmsgptr->cmsg_type == SCTP_SNDRCV
-                && cmsgptr->cmsg_len >= CMSG_LEN(sizeof(sctp_sndrcvinfo))) {
-                sctp_sndrcvinfo *rcvInfo = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
-
-                header->streamNumber = int(rcvInfo->sinfo_stream);
-            }
-#endif
-        }
+        qt_parseReceivedHeader(&msg, &aa, localPort, header);
     }
 
 #if defined (QNATIVESOCKETENGINE_DEBUG)
@@ -1071,37 +1097,27 @@ qint64 QNativeSocketEnginePrivate::nativeReceiveDatagram(char *data, qint64 maxS
     return qint64((maxSize || recvResult < 0) ? recvResult : Q_INT64_C(0));
 }
 
-qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+static void qt_prepareSendMessage(QNativeSocketEnginePrivate *d, msghdr *msg, iovec *vec, qt_sockaddr *aa,
+                                  SendControlBuffer *cbuf, const char *payload, qint64 len,
+                                  const QIpPacketHeader &header)
 {
-    // we use quintptr to force the alignment
-    quintptr cbuf[(CMSG_SPACE(sizeof(struct in6_pktinfo)) + CMSG_SPACE(sizeof(int))
-#ifndef QT_NO_SCTP
-                   + CMSG_SPACE(sizeof(struct sctp_sndrcvinfo))
-#endif
-                   + sizeof(quintptr) - 1) / sizeof(quintptr)];
+    struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf->data);
 
-    struct cmsghdr *cmsgptr = reinterpret_cast<struct cmsghdr *>(cbuf);
-    struct msghdr msg;
-    struct iovec vec;
-    qt_sockaddr aa;
-
-    memset(&msg, 0, sizeof(msg));
-    memset(&aa, 0, sizeof(aa));
-    vec.iov_base = const_cast<char *>(data);
-    vec.iov_len = len;
-    msg.msg_iov = &vec;
-    msg.msg_iovlen = 1;
-    msg.msg_control = &cbuf;
+    vec->iov_base = const_cast<char *>(payload);
+    vec->iov_len = len;
+    msg->msg_iov = vec;
+    msg->msg_iovlen = 1;
+    msg->msg_control = cbuf->data;
 
     if (header.destinationPort != 0) {
-        msg.msg_name = &aa.a;
-        setPortAndAddress(header.destinationPort, header.destinationAddress,
-                          &aa, &msg.msg_namelen);
+        msg->msg_name = &aa->a;
+        d->setPortAndAddress(header.destinationPort, header.destinationAddress,
+                             aa, &msg->msg_namelen);
     }
 
-    if (msg.msg_namelen == sizeof(aa.a6)) {
+    if (msg->msg_namelen == sizeof(aa->a6)) {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_HOPLIMIT;
@@ -1111,7 +1127,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         if (header.ifindex != 0 || !header.senderAddress.isNull()) {
             struct in6_pktinfo *data = reinterpret_cast<in6_pktinfo *>(CMSG_DATA(cmsgptr));
             memset(data, 0, sizeof(*data));
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr->cmsg_level = IPPROTO_IPV6;
             cmsgptr->cmsg_type = IPV6_PKTINFO;
@@ -1123,7 +1139,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
         }
     } else {
         if (header.hopLimit != -1) {
-            msg.msg_controllen += CMSG_SPACE(sizeof(int));
+            msg->msg_controllen += CMSG_SPACE(sizeof(int));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(int));
             cmsgptr->cmsg_level = IPPROTO_IP;
             cmsgptr->cmsg_type = IP_TTL;
@@ -1145,7 +1161,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
             data->s_addr = htonl(header.senderAddress.toIPv4Address());
 #  endif
             cmsgptr->cmsg_level = IPPROTO_IP;
-            msg.msg_controllen += CMSG_SPACE(sizeof(*data));
+            msg->msg_controllen += CMSG_SPACE(sizeof(*data));
             cmsgptr->cmsg_len = CMSG_LEN(sizeof(*data));
             cmsgptr = reinterpret_cast<cmsghdr *>(reinterpret_cast<char *>(cmsgptr) + CMSG_SPACE(sizeof(*data)));
         }
@@ -1156,7 +1172,7 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     if (header.streamNumber != -1) {
         struct sctp_sndrcvinfo *data = reinterpret_cast<sctp_sndrcvinfo *>(CMSG_DATA(cmsgptr));
         memset(data, 0, sizeof(*data));
-        msg.msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
+        msg->msg_controllen += CMSG_SPACE(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_len = CMSG_LEN(sizeof(sctp_sndrcvinfo));
         cmsgptr->cmsg_level = IPPROTO_SCTP;
         cmsgptr->cmsg_type =  SCTP_SNDRCV;
@@ -1165,8 +1181,21 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     }
 #endif
 
-    if (msg.msg_controllen == 0)
-        msg.msg_control = nullptr;
+    if (msg->msg_controllen == 0)
+        msg->msg_control = nullptr;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 len, const QIpPacketHeader &header)
+{
+    SendControlBuffer cbuf;
+    struct msghdr msg;
+    struct iovec vec;
+    qt_sockaddr aa;
+
+    memset(&msg, 0, sizeof(msg));
+    memset(&aa, 0, sizeof(aa));
+    qt_prepareSendMessage(this, &msg, &vec, &aa, &cbuf, data, len, header);
+
     ssize_t sentBytes = qt_safe_sendmsg(socketDescriptor, &msg, 0);
 
     if (sentBytes < 0) {
@@ -1198,6 +1227,138 @@ qint64 QNativeSocketEnginePrivate::nativeSendDatagram(const char *data, qint64 l
     return qint64(sentBytes);
 }
 
+#if QT_CONFIG(sendmmsg)
+// Upper bounds for one recvmmsg()/sendmmsg() call; the receive side also
+// limits the scratch buffer that all datagrams of a call are read into.
+enum {
+    MaxDatagramsPerCall = 64,
+    MaxDatagramBatchBufferSize = 1024 * 1024,
+    MaxUdpPayloadSize = 65535 - 8   // the UDP header, over IPv6 without jumbograms
+};
+
+qint64 QNativeSocketEnginePrivate::nativeReceiveDatagrams(QList<QNetworkDatagramPrivate *> *datagrams,
+                                                          qint64 maxCount, qint64 maxSize,
+                                                          QAbstractSocketEngine::PacketHeaderOptions options)
+{
+    // we need to receive at least one byte, even if our user isn't interested in it
+    const qint64 slotSize = maxSize < 0 ? qint64(MaxUdpPayloadSize) : qMax(maxSize, Q_INT64_C(1));
+    const qint64 keepSize = maxSize < 0 ? slotSize : maxSize;
+    const int batchSize = int(qBound(Q_INT64_C(1), qMin(maxCount, MaxDatagramBatchBufferSize / slotSize),
+                                     qint64(MaxDatagramsPerCall)));
+    if (datagramBatchBuffer.size() < batchSize * slotSize)
+        datagramBatchBuffer.resize(batchSize * slotSize);
+
+    mmsghdr msgs[MaxDatagramsPerCall];
+    iovec vecs[MaxDatagramsPerCall];
+    qt_sockaddr addrs[MaxDatagramsPerCall];
+    ReceiveControlBuffer cbufs[MaxDatagramsPerCall];
+
+    qint64 received = 0;
+    while (received < maxCount) {
+        const int n = int(qMin(maxCount - received, qint64(batchSize)));
+        memset(msgs, 0, n * sizeof(mmsghdr));
+        memset(addrs, 0, n * sizeof(qt_sockaddr));
+        for (int i = 0; i < n; ++i) {
+            vecs[i].iov_base = datagramBatchBuffer.data() + i * slotSize;
+            vecs[i].iov_len = slotSize;
+            qt_prepareReceiveMessage(&msgs[i].msg_hdr, &vecs[i], &addrs[i], &cbufs[i], options);
+        }
+
+        const int result = qt_safe_recvmmsg(socketDescriptor, msgs, n, MSG_DONTWAIT);
+        if (result == -1) {
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                // No (more) datagrams were available for reading
+                return received;
+            case ECONNREFUSED:
+                setError(QAbstractSocket::ConnectionRefusedError, ConnectionRefusedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, ReceiveDatagramErrorString);
+            }
+            return received ? received : -1;
+        }
+
+        datagrams->reserve(datagrams->size() + result);
+        for (int i = 0; i < result; ++i) {
+            const qint64 length = qMin(qint64(msgs[i].msg_len), keepSize);
+            auto *datagram = new QNetworkDatagramPrivate(
+                        QByteArray(datagramBatchBuffer.constData() + i * slotSize, length));
+            if (options != QAbstractSocketEngine::WantNone)
+                qt_parseReceivedHeader(&msgs[i].msg_hdr, &addrs[i], localPort, &datagram->header);
+            datagrams->append(datagram);
+        }
+        received += result;
+
+        if (result < n)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeReceiveDatagrams(%p, %lli, %lli) == %lli",
+           datagrams, maxCount, maxSize, received);
+#endif
+
+    return received;
+}
+
+qint64 QNativeSocketEnginePrivate::nativeSendDatagrams(const QNetworkDatagramPrivate * const *datagrams,
+                                                       qint64 count)
+{
+    mmsghdr msgs[MaxDatagramsPerCall];
+    iovec vecs[MaxDatagramsPerCall];
+    qt_sockaddr addrs[MaxDatagramsPerCall];
+    SendControlBuffer cbufs[MaxDatagramsPerCall];
+
+    qint64 sent = 0;
+    while (sent < count) {
+        const int n = int(qMin(count - sent, qint64(MaxDatagramsPerCall)));
+        memset(msgs, 0, n * sizeof(mmsghdr));
+        memset(addrs, 0, n * sizeof(qt_sockaddr));
+        for (int i = 0; i < n; ++i) {
+            const QNetworkDatagramPrivate *datagram = datagrams[sent + i];
+            qt_prepareSendMessage(this, &msgs[i].msg_hdr, &vecs[i], &addrs[i], &cbufs[i],
+                                  datagram->data.constData(), datagram->data.size(),
+                                  datagram->header);
+        }
+
+        const int result = qt_safe_sendmmsg(socketDescriptor, msgs, n, 0);
+        if (result == -1) {
+            switch (errno) {
+#if defined(EWOULDBLOCK) && EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case EAGAIN:
+                return sent;
+            case EMSGSIZE:
+                setError(QAbstractSocket::DatagramTooLargeError, DatagramTooLargeErrorString);
+                break;
+            case ECONNRESET:
+                setError(QAbstractSocket::RemoteHostClosedError, RemoteHostClosedErrorString);
+                break;
+            default:
+                setError(QAbstractSocket::NetworkError, SendDatagramErrorString);
+            }
+            return sent ? sent : -1;
+        }
+
+        sent += result;
+        if (result < n)
+            break;
+    }
+
+#if defined (QNATIVESOCKETENGINE_DEBUG)
+    qDebug("QNativeSocketEnginePrivate::nativeSendDatagrams(%p, %lli) == %lli",
+           datagrams, count, sent);
+#endif
+
+    return sent;
+}
+#endif // QT_CONFIG(sendmmsg)
+
 bool QNativeSocketEnginePrivate::fetchConnectionParameters()
 {
     localPort = 0;
@@ -68,6 +68,8 @@
     that case, hasPendingDatagrams() returns \c true. Call
     pendingDatagramSize() to obtain the size of the first pending
     datagram, and readDatagram() or receiveDatagram() to read it.
+    High-rate applications can use receiveDatagrams() and writeDatagrams()
+    to transfer several datagrams at once.
 
     \note An incoming datagram should be read when you receive the readyRead()
     signal, otherwise this signal will not be emitted for the next datagram.
@@ -102,6 +104,7 @@
 #include "qnetworkdatagram.h"
 #include "qnetworkinterface.h"
 #include "qabstractsocket_p.h"
+#include "qvarlengtharray.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -476,6 +479,103 @@ QNetworkDatagram QUdpSocket::receiveDatagram(qint64 maxSize)
     return result;
 }
 
+/*!
+    \since 6.0
+
+    Receives up to \a maxCount pending datagrams, each no larger than \a
+    maxSize bytes, and returns them in arrival order. Sender and destination
+    addresses, ports and hop limits are filled in as for receiveDatagram().
+
+    Where the operating system supports it (\c recvmmsg() on Linux and some
+    BSDs), all datagrams are read with as few system calls as possible;
+    otherwise, this function reads them one by one. It never blocks: if fewer
+    than \a maxCount datagrams are pending, only those are returned, and an
+    empty list is returned if there are none or an error occurred.
+
+    If \a maxSize is too small, the rest of each datagram will be lost. If \a
+    maxSize is -1 (the default), each datagram is read in full, up to the
+    maximum UDP payload size.
+
+    \sa receiveDatagram(), writeDatagrams(), hasPendingDatagrams()
+*/
+QList<QNetworkDatagram> QUdpSocket::receiveDatagrams(qsizetype maxCount, qint64 maxSize)
+{
+    Q_D(QUdpSocket);
+
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::receiveDatagrams(%lld, %lld)", qint64(maxCount), maxSize);
+#endif
+    QT_CHECK_BOUND("QUdpSocket::receiveDatagrams()", QList<QNetworkDatagram>());
+
+    if (maxCount <= 0)
+        return QList<QNetworkDatagram>();
+
+    // only the datagrams actually pending are allocated
+    QList<QNetworkDatagramPrivate *> received;
+    const qint64 count = d->socketEngine->readDatagrams(&received, maxCount, maxSize,
+                                                        QAbstractSocketEngine::WantAll);
+    d->hasPendingData = false;
+    d->socketEngine->setReadNotificationEnabled(true);
+    if (count < 0)
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+
+    QList<QNetworkDatagram> result;
+    result.reserve(received.size());
+    for (QNetworkDatagramPrivate *datagram : qAsConst(received))
+        result.append(QNetworkDatagram(*datagram));
+    return result;
+}
+
+/*!
+    \since 6.0
+
+    Sends all datagrams in \a datagrams, each to the address, port, interface
+    and hop limit it carries, as writeDatagram(const QNetworkDatagram &) does.
+
+    Where the operating system supports it (\c sendmmsg() on Linux and some
+    BSDs), the datagrams are sent with as few system calls as possible;
+    otherwise, this function sends them one by one.
+
+    Returns the number of datagrams sent, which can be less than the size of
+    \a datagrams if the socket's send buffer filled up or an error occurred
+    part-way, or -1 if no datagram could be sent because of an error. The
+    bytesWritten() signal is emitted once with the total payload size sent.
+
+    \sa writeDatagram(), receiveDatagrams()
+*/
+qsizetype QUdpSocket::writeDatagrams(const QList<QNetworkDatagram> &datagrams)
+{
+    Q_D(QUdpSocket);
+#if defined QUDPSOCKET_DEBUG
+    qDebug("QUdpSocket::writeDatagrams(%lld)", qint64(datagrams.size()));
+#endif
+    if (datagrams.isEmpty())
+        return 0;
+    if (!d->doEnsureInitialized(QHostAddress::Any, 0, datagrams.constFirst().destinationAddress()))
+        return -1;
+    if (state() == UnconnectedState)
+        bind();
+
+    QVarLengthArray<const QNetworkDatagramPrivate *, 64> privates(datagrams.size());
+    for (qsizetype i = 0; i < datagrams.size(); ++i)
+        privates[i] = datagrams.at(i).d;
+
+    const qint64 sent = d->socketEngine->writeDatagrams(privates.constData(), privates.size());
+    d->cachedSocketDescriptor = d->socketEngine->socketDescriptor();
+
+    if (sent < 0) {
+        d->setErrorAndEmit(d->socketEngine->error(), d->socketEngine->errorString());
+        return -1;
+    }
+
+    qint64 bytes = 0;
+    for (qint64 i = 0; i < sent; ++i)
+        bytes += privates[i]->data.size();
+    if (sent > 0)
+        emit bytesWritten(bytes);
+    return qsizetype(sent);
+}
+
 /*!
     Receives a datagram no larger than \a maxSize bytes and stores
     it in \a data. The sender's host address and port is stored in
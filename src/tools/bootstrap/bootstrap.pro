@@ -100,6 +100,7 @@ SOURCES += \
            ../../corelib/time/qdatetime.cpp \
            ../../corelib/time/qgregoriancalendar.cpp \
            ../../corelib/time/qromancalendar.cpp \
+           ../../corelib/tools/qarenaallocator.cpp \
            ../../corelib/tools/qarraydata.cpp \
            ../../corelib/tools/qbitarray.cpp \
            ../../corelib/tools/qcommandlineparser.cpp \
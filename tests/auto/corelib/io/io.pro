@@ -1,6 +1,8 @@
 TEMPLATE=subdirs
 SUBDIRS=\
     qabstractfileengine \
+    qasyncfile \
+    qasynclogsink \
     qbuffer \
     qdataurl \
     qdebug \
@@ -8,6 +10,7 @@ SUBDIRS=\
     qdiriterator \
     qfile \
     largefile \
+    qfilecopier \
     qfileinfo \
     qfileselector \
     qfilesystemmetadata \
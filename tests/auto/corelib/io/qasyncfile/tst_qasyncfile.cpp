@@ -0,0 +1,316 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qasyncfile.h>
+#include <qfile.h>
+#include <qtemporarydir.h>
+#include <qtemporaryfile.h>
+
+class tst_QAsyncFile : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void openAndClose_data() { backends(); }
+    void openAndClose();
+    void openNonExisting();
+    void writeAndRead_data() { backends(); }
+    void writeAndRead();
+    void readPastEnd_data() { backends(); }
+    void readPastEnd();
+    void manyRequests_data() { backends(); }
+    void manyRequests();
+    void signals_data() { backends(); }
+    void signals();
+    void sync_data() { backends(); }
+    void sync();
+    void closeWithPendingRequests_data() { backends(); }
+    void closeWithPendingRequests();
+    void wrongMode();
+#ifdef Q_OS_UNIX
+    void readError_data() { backends(); }
+    void readError();
+#endif
+
+private:
+    void backends();
+    void useBackend();
+    QByteArray pattern(int size) const;
+
+    QTemporaryDir dir;
+};
+
+void tst_QAsyncFile::init()
+{
+    QVERIFY(dir.isValid());
+}
+
+void tst_QAsyncFile::cleanup()
+{
+    qunsetenv("QT_NO_IO_URING");
+}
+
+void tst_QAsyncFile::backends()
+{
+    QTest::addColumn<bool>("threadPool");
+
+    QTest::newRow("default") << false;
+    QTest::newRow("threadpool") << true;
+}
+
+void tst_QAsyncFile::useBackend()
+{
+    QFETCH(bool, threadPool);
+    if (threadPool)
+        qputenv("QT_NO_IO_URING", "1");
+}
+
+QByteArray tst_QAsyncFile::pattern(int size) const
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i)
+        data[i] = char(i % 251);
+    return data;
+}
+
+void tst_QAsyncFile::openAndClose()
+{
+    useBackend();
+    QFETCH(bool, threadPool);
+
+    const QString name = dir.filePath(QStringLiteral("openAndClose"));
+    QAsyncFile file(name);
+    QCOMPARE(file.fileName(), name);
+    QVERIFY(!file.isOpen());
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QVERIFY(file.isOpen());
+    QCOMPARE(file.openMode(), QIODevice::WriteOnly | QIODevice::Truncate);
+    QCOMPARE(file.error(), QFileDevice::NoError);
+    QCOMPARE(file.size(), qint64(0));
+    if (threadPool)
+        QCOMPARE(file.backend(), QAsyncFile::ThreadPoolBackend);
+
+    QTest::ignoreMessage(QtWarningMsg, qPrintable(QLatin1String("QAsyncFile::open: File (")
+                                                  + name + QLatin1String(") already open")));
+    QVERIFY(!file.open(QIODevice::ReadOnly));
+
+    file.close();
+    QVERIFY(!file.isOpen());
+    QVERIFY(QFile::exists(name));
+}
+
+void tst_QAsyncFile::openNonExisting()
+{
+    QAsyncFile file(dir.filePath(QStringLiteral("does-not-exist")));
+    QVERIFY(!file.open(QIODevice::ReadOnly));
+    QVERIFY(!file.isOpen());
+    QCOMPARE(file.error(), QFileDevice::OpenError);
+    QVERIFY(!file.errorString().isEmpty());
+
+    QVERIFY(!file.open(QIODevice::WriteOnly | QIODevice::ExistingOnly));
+    QCOMPARE(file.error(), QFileDevice::OpenError);
+}
+
+void tst_QAsyncFile::writeAndRead()
+{
+    useBackend();
+
+    const QByteArray data = pattern(3 * 1024 * 1024 + 17);
+    QAsyncFile file(dir.filePath(QStringLiteral("writeAndRead")));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+
+    // out of order, in two halves
+    const int half = data.size() / 2;
+    QFuture<qint64> second = file.write(half, data.mid(half));
+    QFuture<qint64> first = file.write(0, data.left(half));
+    QCOMPARE(second.result(), qint64(data.size() - half));
+    QCOMPARE(first.result(), qint64(half));
+    QCOMPARE(file.size(), qint64(data.size()));
+
+    QCOMPARE(file.readAll().result(), data);
+    QCOMPARE(file.read(12345, 1000).result(), data.mid(12345, 1000));
+    QCOMPARE(file.error(), QFileDevice::NoError);
+
+    QFile check(file.fileName());
+    QVERIFY(check.open(QIODevice::ReadOnly));
+    QCOMPARE(check.readAll(), data);
+}
+
+void tst_QAsyncFile::readPastEnd()
+{
+    useBackend();
+
+    const QByteArray data = pattern(1000);
+    QAsyncFile file(dir.filePath(QStringLiteral("readPastEnd")));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QCOMPARE(file.write(0, data).result(), qint64(data.size()));
+
+    QCOMPARE(file.read(900, 500).result(), data.mid(900));
+    QCOMPARE(file.read(1000, 10).result(), QByteArray());
+    QCOMPARE(file.read(5000, 10).result(), QByteArray());
+    QCOMPARE(file.read(0, 0).result(), QByteArray());
+    QCOMPARE(file.error(), QFileDevice::NoError);
+}
+
+void tst_QAsyncFile::manyRequests()
+{
+    useBackend();
+
+    const QByteArray data = pattern(1024 * 1024);
+    QAsyncFile file(dir.filePath(QStringLiteral("manyRequests")));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+
+    // more requests than fit in the submission queue at once
+    QList<QFuture<qint64>> writes;
+    for (int offset = 0; offset < data.size(); offset += 1024)
+        writes.append(file.write(offset, data.mid(offset, 1024)));
+    for (const QFuture<qint64> &write : qAsConst(writes))
+        QCOMPARE(write.result(), qint64(1024));
+
+    QList<QPair<int, QFuture<QByteArray>>> reads;
+    for (int i = 0; i < 2000; ++i) {
+        const int offset = (i * 7919) % data.size();
+        reads.append(qMakePair(offset, file.read(offset, 333)));
+    }
+    for (const auto &read : qAsConst(reads))
+        QCOMPARE(read.second.result(), data.mid(read.first, 333));
+}
+
+void tst_QAsyncFile::signals()
+{
+    useBackend();
+
+    QAsyncFile file(dir.filePath(QStringLiteral("signals")));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QSignalSpy readSpy(&file, &QAsyncFile::readFinished);
+    QSignalSpy writeSpy(&file, &QAsyncFile::writeFinished);
+    QSignalSpy errorSpy(&file, &QAsyncFile::errorOccurred);
+
+    file.write(10, QByteArrayLiteral("hello"));
+    QTRY_COMPARE(writeSpy.count(), 1);
+    QCOMPARE(writeSpy.at(0).at(0).toLongLong(), qint64(10));
+    QCOMPARE(writeSpy.at(0).at(1).toLongLong(), qint64(5));
+
+    file.read(10, 100);
+    QTRY_COMPARE(readSpy.count(), 1);
+    QCOMPARE(readSpy.at(0).at(0).toLongLong(), qint64(10));
+    QCOMPARE(readSpy.at(0).at(1).toByteArray(), QByteArrayLiteral("hello"));
+    QCOMPARE(errorSpy.count(), 0);
+
+    // results arrive in the thread the object lives in
+    QThread *receivingThread = nullptr;
+    connect(&file, &QAsyncFile::readFinished, this, [&] {
+        receivingThread = QThread::currentThread();
+    });
+    file.read(0, 1);
+    QTRY_VERIFY(receivingThread);
+    QCOMPARE(receivingThread, thread());
+}
+
+void tst_QAsyncFile::sync()
+{
+    useBackend();
+
+    QAsyncFile file(dir.filePath(QStringLiteral("sync")));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    QSignalSpy syncSpy(&file, &QAsyncFile::syncFinished);
+    QCOMPARE(file.write(0, pattern(100)).result(), qint64(100));
+    QVERIFY(file.sync().result());
+    QTRY_COMPARE(syncSpy.count(), 1);
+}
+
+void tst_QAsyncFile::closeWithPendingRequests()
+{
+    useBackend();
+
+    const QByteArray data = pattern(256 * 1024);
+    const QString name = dir.filePath(QStringLiteral("closeWithPendingRequests"));
+    QList<QFuture<QByteArray>> reads;
+    {
+        QAsyncFile file(name);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QCOMPARE(file.write(0, data).result(), qint64(data.size()));
+        for (int i = 0; i < 64; ++i)
+            reads.append(file.read(i * 4096, 4096));
+        file.close();
+    }
+    for (int i = 0; i < 64; ++i) {
+        QVERIFY(reads.at(i).isFinished());
+        QCOMPARE(reads.at(i).result(), data.mid(i * 4096, 4096));
+    }
+}
+
+void tst_QAsyncFile::wrongMode()
+{
+    const QString name = dir.filePath(QStringLiteral("wrongMode"));
+    QAsyncFile file(name);
+    const auto ignoreWarning = [&name](const char *function, const char *message) {
+        const QString warning = QLatin1String("QAsyncFile::") + QLatin1String(function)
+                + QLatin1String(" (") + name + QLatin1String("): ") + QLatin1String(message);
+        QTest::ignoreMessage(QtWarningMsg, qPrintable(warning));
+    };
+
+    ignoreWarning("read", "file not open");
+    QCOMPARE(file.read(0, 10).result(), QByteArray());
+    ignoreWarning("sync", "file not open");
+    QVERIFY(!file.sync().result());
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    ignoreWarning("read", "WriteOnly file");
+    QCOMPARE(file.read(0, 10).result(), QByteArray());
+    file.close();
+
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    ignoreWarning("write", "ReadOnly file");
+    QCOMPARE(file.write(0, "x").result(), qint64(-1));
+}
+
+#ifdef Q_OS_UNIX
+void tst_QAsyncFile::readError()
+{
+    useBackend();
+
+    // opening a directory read-only succeeds, reading from it does not
+    QAsyncFile file(dir.path());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QSignalSpy errorSpy(&file, &QAsyncFile::errorOccurred);
+    QCOMPARE(file.read(0, 10).result(), QByteArray());
+    QCOMPARE(file.error(), QFileDevice::ReadError);
+    QVERIFY(!file.errorString().isEmpty());
+    QTRY_COMPARE(errorSpy.count(), 1);
+    QCOMPARE(errorSpy.at(0).at(0).value<QFileDevice::FileError>(), QFileDevice::ReadError);
+}
+#endif
+
+QTEST_MAIN(tst_QAsyncFile)
+#include "tst_qasyncfile.moc"
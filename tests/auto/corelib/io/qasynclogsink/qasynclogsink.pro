@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qasynclogsink
+QT = core testlib
+SOURCES = tst_qasynclogsink.cpp
+DEFINES += QT_MESSAGELOGCONTEXT
@@ -0,0 +1,456 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qasynclogsink.h>
+#include <qbuffer.h>
+#include <qfile.h>
+#include <qloggingcategory.h>
+#include <qmutex.h>
+#include <qsemaphore.h>
+#include <qtemporarydir.h>
+#include <qthread.h>
+
+Q_LOGGING_CATEGORY(lcTest, "qt.test.asynclog")
+Q_LOGGING_CATEGORY(lcQuiet, "qt.test.asynclog.quiet", QtWarningMsg)
+
+struct HandledMessage
+{
+    QtMsgType type;
+    QByteArray category;
+    QString message;
+    QThread *thread;
+};
+
+static QMutex handledMutex;
+static QList<HandledMessage> handledMessages;
+static QSemaphore *handlerGate = nullptr;
+
+static void collectingHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    if (QSemaphore *gate = handlerGate) {
+        handlerGate = nullptr;
+        gate->acquire();
+    }
+    const QMutexLocker locker(&handledMutex);
+    handledMessages.append({ type, context.category, message, QThread::currentThread() });
+}
+
+static int handledCount()
+{
+    const QMutexLocker locker(&handledMutex);
+    return handledMessages.size();
+}
+
+class tst_QAsyncLogSink : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void binaryLog();
+    void printfFormats();
+    void categoryFilter();
+    void messageHandler();
+    void transientContext();
+    void manyThreads();
+    void droppedMessages();
+    void largeMessage();
+    void installTwice();
+    void reinstall();
+    void decodeInvalid();
+
+private:
+    QStringList decodedLines();
+
+    QTemporaryDir tempDir;
+    QString logFileName;
+    QtMessageHandler oldHandler = nullptr;
+};
+
+void tst_QAsyncLogSink::initTestCase()
+{
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    logFileName = tempDir.filePath("test.qlog");
+}
+
+void tst_QAsyncLogSink::init()
+{
+    handledMessages.clear();
+    oldHandler = qInstallMessageHandler(collectingHandler);
+}
+
+void tst_QAsyncLogSink::cleanup()
+{
+    qInstallMessageHandler(oldHandler);
+    QFile::remove(logFileName);
+}
+
+QStringList tst_QAsyncLogSink::decodedLines()
+{
+    QFile log(logFileName);
+    if (!log.open(QIODevice::ReadOnly))
+        return QStringList();
+    QBuffer text;
+    text.open(QIODevice::WriteOnly);
+    if (!QAsyncLogSink::decode(&log, &text))
+        return QStringList();
+    return QString::fromUtf8(text.data()).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+}
+
+void tst_QAsyncLogSink::binaryLog()
+{
+    QAsyncLogSink sink(logFileName);
+    QCOMPARE(sink.fileName(), logFileName);
+    QVERIFY(!sink.isInstalled());
+    QVERIFY(sink.install());
+    QVERIFY(sink.isInstalled());
+
+    const int line = __LINE__ + 1;
+    qCDebug(lcTest, "%d items in %s", 3, "the box");
+    qCWarning(lcTest) << "streamed" << 42;
+    qInfo("caf\xc3\xa9 %%");
+    sink.uninstall();
+    QVERIFY(!sink.isInstalled());
+    QVERIFY(handledMessages.isEmpty());
+
+    const QStringList lines = decodedLines();
+    QCOMPARE(lines.size(), 3);
+    QVERIFY2(lines.at(0).contains(" debug [0x"), qPrintable(lines.at(0)));
+    QVERIFY2(lines.at(0).contains("] qt.test.asynclog: 3 items in the box ("), qPrintable(lines.at(0)));
+    QVERIFY2(lines.at(0).endsWith("tst_qasynclogsink.cpp:" + QString::number(line) + ')'),
+             qPrintable(lines.at(0)));
+    QVERIFY2(lines.at(1).contains(" warning [0x"), qPrintable(lines.at(1)));
+    QVERIFY2(lines.at(1).contains("] qt.test.asynclog: streamed 42 ("), qPrintable(lines.at(1)));
+    QVERIFY2(lines.at(2).contains(" info [0x"), qPrintable(lines.at(2)));
+    QVERIFY2(lines.at(2).contains(QString::fromUtf8("] default: caf\xc3\xa9 % (")),
+             qPrintable(lines.at(2)));
+
+    // the messages take the usual path again
+    qCDebug(lcTest, "after");
+    QCOMPARE(handledMessages.size(), 1);
+    QCOMPARE(handledMessages.at(0).message, QStringLiteral("after"));
+}
+
+void tst_QAsyncLogSink::printfFormats()
+{
+    QStringList expected;
+#define CHECK_FORMAT(...) \
+    do { \
+        expected << QString::asprintf(__VA_ARGS__); \
+        qCDebug(lcTest, __VA_ARGS__); \
+    } while (false)
+
+    QAsyncLogSink sink;
+    QVERIFY(sink.install());
+    CHECK_FORMAT("plain");
+    CHECK_FORMAT("%d|%i|%u|%x|%X|%o", -5, 7, 8u, 255u, 255u, 8u);
+    CHECK_FORMAT("%lld|%llu|%ld|%zd|%hd|%hhu", -1LL, 2ULL, -3L, qsizetype(-4), short(5), 6);
+    CHECK_FORMAT("%5.2f|%-8s|%08.3e|%g|%Lf", 3.14159, "ab", 1234.5, 0.0001, (long double)1.5);
+    CHECK_FORMAT("%*d|%-*.*s|%.*f|%*d", 6, 42, 10, 3, "abcdef", 2, 2.71828, -4, 1);
+    CHECK_FORMAT("%c%lc|%s", 'h', 0xe9, "caf\xc3\xa9");
+    CHECK_FORMAT("%#x|%+d|% d|%p", 255u, 5, 6, reinterpret_cast<void *>(0x1234));
+#undef CHECK_FORMAT
+    sink.flush();
+    sink.uninstall();
+
+    QCOMPARE(handledMessages.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QCOMPARE(handledMessages.at(i).message, expected.at(i));
+        QVERIFY(handledMessages.at(i).thread != QThread::currentThread());
+    }
+}
+
+void tst_QAsyncLogSink::categoryFilter()
+{
+    QAsyncLogSink sink(logFileName);
+    QVERIFY(sink.install());
+    qCDebug(lcQuiet, "not recorded %d", 1);
+    qCDebug(lcQuiet) << "not recorded either";
+    qCWarning(lcQuiet, "recorded %d", 2);
+
+    QLoggingCategory *defaultCategory = QLoggingCategory::defaultCategory();
+    defaultCategory->setEnabled(QtDebugMsg, false);
+    qDebug("disabled %d", 3);
+    defaultCategory->setEnabled(QtDebugMsg, true);
+    sink.uninstall();
+
+    const QStringList lines = decodedLines();
+    QCOMPARE(lines.size(), 1);
+    QVERIFY2(lines.at(0).contains("qt.test.asynclog.quiet: recorded 2"), qPrintable(lines.at(0)));
+}
+
+void tst_QAsyncLogSink::messageHandler()
+{
+    QAsyncLogSink sink;
+    QVERIFY(sink.fileName().isEmpty());
+    QVERIFY(sink.install());
+    qCDebug(lcTest, "value %d", 7);
+    qCInfo(lcTest) << "streamed" << 8;
+    qCritical("critical %s", "message");
+    sink.flush();
+
+    {
+        const QMutexLocker locker(&handledMutex);
+        QCOMPARE(handledMessages.size(), 3);
+        QCOMPARE(handledMessages.at(0).type, QtDebugMsg);
+        QCOMPARE(handledMessages.at(0).category, QByteArray("qt.test.asynclog"));
+        QCOMPARE(handledMessages.at(0).message, QStringLiteral("value 7"));
+        QCOMPARE(handledMessages.at(1).type, QtInfoMsg);
+        QCOMPARE(handledMessages.at(1).message, QStringLiteral("streamed 8"));
+        QCOMPARE(handledMessages.at(2).type, QtCriticalMsg);
+        QCOMPARE(handledMessages.at(2).category, QByteArray("default"));
+        QCOMPARE(handledMessages.at(2).message, QStringLiteral("critical message"));
+        for (const HandledMessage &message : qAsConst(handledMessages))
+            QVERIFY(message.thread != QThread::currentThread());
+    }
+    sink.uninstall();
+}
+
+// Logs messages whose context strings are gone by the time they are written,
+// and likely reuse the same addresses.
+static void logWithTransientContext(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const QByteArray file = "file" + QByteArray::number(i) + ".qml";
+        const QByteArray function = "function" + QByteArray::number(i);
+        const QByteArray category = "qt.test.transient" + QByteArray::number(i);
+        QMessageLogger(file.constData(), i + 1, function.constData(), category.constData())
+                .debug("message %d", i);
+    }
+}
+
+void tst_QAsyncLogSink::transientContext()
+{
+    enum { MessageCount = 3 };
+
+    QAsyncLogSink binarySink(logFileName);
+    QVERIFY(binarySink.install());
+    logWithTransientContext(MessageCount);
+    binarySink.uninstall();
+
+    const QStringList lines = decodedLines();
+    QCOMPARE(lines.size(), int(MessageCount));
+    for (int i = 0; i < MessageCount; ++i) {
+        const QString expected = QString::asprintf("] qt.test.transient%d: message %d (file%d.qml:%d)",
+                                                   i, i, i, i + 1);
+        QVERIFY2(lines.at(i).endsWith(expected), qPrintable(lines.at(i)));
+    }
+
+    QAsyncLogSink handlerSink;
+    QVERIFY(handlerSink.install());
+    logWithTransientContext(MessageCount);
+    handlerSink.flush();
+    handlerSink.uninstall();
+
+    QCOMPARE(handledMessages.size(), int(MessageCount));
+    for (int i = 0; i < MessageCount; ++i) {
+        QCOMPARE(handledMessages.at(i).category, "qt.test.transient" + QByteArray::number(i));
+        QCOMPARE(handledMessages.at(i).message, QString::asprintf("message %d", i));
+    }
+}
+
+void tst_QAsyncLogSink::manyThreads()
+{
+    enum { ThreadCount = 4, MessageCount = 1000 };
+
+    QAsyncLogSink sink(logFileName);
+    sink.setBufferSize(1024 * 1024);
+    QCOMPARE(sink.bufferSize(), qsizetype(1024 * 1024));
+    QVERIFY(sink.install());
+
+    std::unique_ptr<QThread> threads[ThreadCount];
+    for (int t = 0; t < ThreadCount; ++t) {
+        threads[t].reset(QThread::create([t] {
+            for (int i = 0; i < MessageCount; ++i)
+                qCDebug(lcTest, "thread %d message %d", t, i);
+        }));
+        threads[t]->start();
+    }
+    for (auto &thread : threads)
+        QVERIFY(thread->wait());
+    sink.uninstall();
+    QCOMPARE(sink.droppedMessageCount(), quint64(0));
+
+    // each thread's messages are in order
+    const QStringList lines = decodedLines();
+    QCOMPARE(lines.size(), ThreadCount * MessageCount);
+    int next[ThreadCount] = {};
+    const QRegularExpression pattern(QStringLiteral("thread (\\d) message (\\d+)"));
+    for (const QString &line : lines) {
+        const QRegularExpressionMatch match = pattern.match(line);
+        QVERIFY2(match.hasMatch(), qPrintable(line));
+        const int t = match.captured(1).toInt();
+        QCOMPARE(match.captured(2).toInt(), next[t]++);
+    }
+}
+
+void tst_QAsyncLogSink::droppedMessages()
+{
+    QAsyncLogSink sink;
+    sink.setBufferSize(4096);
+    QVERIFY(sink.install());
+
+    // hold the writer thread up in the message handler until the buffer overflows
+    QSemaphore gate;
+    handlerGate = &gate;
+    qCWarning(lcTest, "first");
+    for (int i = 0; i < 1000; ++i)
+        qCDebug(lcTest, "overflowing %d", i);
+    gate.release();
+    sink.flush();
+    sink.uninstall();
+
+    const quint64 dropped = sink.droppedMessageCount();
+    QVERIFY(dropped > 0);
+    QVERIFY(dropped < 1000);
+
+    // the messages that made it, and one warning about the others
+    QCOMPARE(quint64(handledMessages.size()), 1 + 1000 - dropped + 1);
+    QCOMPARE(handledMessages.first().message, QStringLiteral("first"));
+    const auto isWarning = [](const HandledMessage &message) {
+        return message.category == "qt.core.logging";
+    };
+    const auto warning = std::find_if(handledMessages.cbegin(), handledMessages.cend(), isWarning);
+    QVERIFY(warning != handledMessages.cend());
+    QCOMPARE(warning->type, QtWarningMsg);
+    QCOMPARE(warning->message,
+             QString::asprintf("QAsyncLogSink: dropped %llu messages from thread 0x%llx", dropped,
+                               quint64(quintptr(QThread::currentThreadId()))));
+}
+
+void tst_QAsyncLogSink::largeMessage()
+{
+    QAsyncLogSink sink;
+    sink.setBufferSize(4096);
+    QVERIFY(sink.install());
+
+    qCDebug(lcTest, "first");
+    qCDebug(lcTest) << "second";
+
+    // too large for the buffer, printed right away, but after the messages
+    // recorded before it
+    const QString large(2048, QLatin1Char('x'));
+    qCDebug(lcTest) << qPrintable(large);
+    QCOMPARE(handledCount(), 3);
+    QCOMPARE(handledMessages.at(0).message, QStringLiteral("first"));
+    QCOMPARE(handledMessages.at(1).message, QStringLiteral("second"));
+    QVERIFY(handledMessages.at(1).thread != QThread::currentThread());
+    QCOMPARE(handledMessages.at(2).message, large);
+    QCOMPARE(handledMessages.at(2).thread, QThread::currentThread());
+    sink.uninstall();
+}
+
+void tst_QAsyncLogSink::installTwice()
+{
+    QAsyncLogSink first;
+    QAsyncLogSink second(logFileName);
+    QVERIFY(first.install());
+    QVERIFY(first.install());
+    QVERIFY(!second.install());
+    QVERIFY(first.isInstalled());
+    QVERIFY(!second.isInstalled());
+
+    first.uninstall();
+    QVERIFY(second.install());
+    QVERIFY(!first.isInstalled());
+
+    // destroying an installed sink uninstalls it
+    {
+        QAsyncLogSink third;
+        second.uninstall();
+        QVERIFY(third.install());
+    }
+    QVERIFY(second.install());
+    second.uninstall();
+
+    QAsyncLogSink unwritable(tempDir.filePath("missing/test.qlog"));
+    QVERIFY(!unwritable.install());
+    QVERIFY(!unwritable.isInstalled());
+}
+
+void tst_QAsyncLogSink::reinstall()
+{
+    QAsyncLogSink sink;
+    QThread *thread = QThread::create([&sink] {
+        for (int i = 0; i < 3; ++i) {
+            while (!sink.isInstalled())
+                QThread::yieldCurrentThread();
+            qCDebug(lcTest, "round %d", i);
+            while (sink.isInstalled())
+                QThread::yieldCurrentThread();
+        }
+    });
+    thread->start();
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(sink.install());
+        QTRY_COMPARE(handledCount(), i + 1);
+        sink.uninstall();
+    }
+    QVERIFY(thread->wait());
+    delete thread;
+
+    QCOMPARE(handledMessages.at(0).message, QStringLiteral("round 0"));
+    QCOMPARE(handledMessages.at(1).message, QStringLiteral("round 1"));
+    QCOMPARE(handledMessages.at(2).message, QStringLiteral("round 2"));
+}
+
+void tst_QAsyncLogSink::decodeInvalid()
+{
+    QBuffer output;
+    output.open(QIODevice::WriteOnly);
+
+    QBuffer empty;
+    empty.open(QIODevice::ReadOnly);
+    QVERIFY(!QAsyncLogSink::decode(&empty, &output));
+
+    QByteArray data("not a binary log");
+    QBuffer garbage(&data);
+    garbage.open(QIODevice::ReadOnly);
+    QVERIFY(!QAsyncLogSink::decode(&garbage, &output));
+
+    // a valid header followed by a truncated record
+    {
+        QAsyncLogSink sink(logFileName);
+        QVERIFY(sink.install());
+        qCDebug(lcTest, "a message");
+    }
+    QFile log(logFileName);
+    QVERIFY(log.open(QIODevice::ReadOnly));
+    QByteArray truncated = log.readAll();
+    truncated.chop(4);
+    QBuffer buffer(&truncated);
+    buffer.open(QIODevice::ReadOnly);
+    QVERIFY(!QAsyncLogSink::decode(&buffer, &output));
+}
+
+QTEST_MAIN(tst_QAsyncLogSink)
+#include "tst_qasynclogsink.moc"
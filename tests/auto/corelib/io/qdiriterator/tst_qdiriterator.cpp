@@ -92,6 +92,10 @@ private slots:
     void cleanupTestCase();
     void iterateRelativeDirectory_data();
     void iterateRelativeDirectory();
+    void parallelScan_data();
+    void parallelScan();
+    void parallelScanLargeTree();
+    void nextBatch();
     void iterateResource_data();
     void iterateResource();
     void stopLinkLoop();
@@ -386,6 +390,122 @@ void tst_QDirIterator::iterateRelativeDirectory()
     QCOMPARE(list, sortedEntries);
 }
 
+void tst_QDirIterator::parallelScan_data()
+{
+    iterateRelativeDirectory_data();
+}
+
+void tst_QDirIterator::parallelScan()
+{
+    QFETCH(QString, dirName);
+    QFETCH(QDirIterator::IteratorFlags, flags);
+    QFETCH(QDir::Filters, filters);
+    QFETCH(QStringList, nameFilters);
+    QFETCH(QStringList, entries);
+
+    const QDirIterator::IteratorFlags parallelFlags[] = {
+        flags | QDirIterator::ParallelScan,
+        flags | QDirIterator::ParallelScan | QDirIterator::PrefetchMetaData
+    };
+    for (QDirIterator::IteratorFlags parallel : parallelFlags) {
+        QDirIterator it(dirName, nameFilters, filters, parallel);
+        QStringList list;
+        while (it.hasNext()) {
+            QString next = it.next();
+            QCOMPARE(it.path(), dirName);
+            QCOMPARE(next, it.filePath());
+
+            const QFileInfo info = it.fileInfo();
+            const QFileInfo expected(next);
+            QCOMPARE(info, expected);
+            QCOMPARE(info.isSymLink(), expected.isSymLink());
+            QCOMPARE(info.isDir(), expected.isDir());
+            QCOMPARE(info.isFile(), expected.isFile());
+            if (info.isFile())
+                QCOMPARE(info.size(), expected.size());
+
+            list << info.canonicalFilePath();
+        }
+        QVERIFY(!it.hasNext());
+
+        // The order of items returned by QDirIterator is not guaranteed.
+        list.sort();
+
+        QStringList sortedEntries;
+        for (const QString &item : qAsConst(entries))
+            sortedEntries.append(QFileInfo(item).canonicalFilePath());
+        sortedEntries.sort();
+
+        QCOMPARE(list, sortedEntries);
+    }
+}
+
+void tst_QDirIterator::parallelScanLargeTree()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+
+    QSet<QString> expected;
+    QDir root(tempDir.path());
+    for (int i = 0; i < 20; ++i) {
+        const QString sub = QString::number(i) + QLatin1String("/sub");
+        QVERIFY(root.mkpath(sub));
+        expected << root.filePath(QString::number(i)) << root.filePath(sub);
+        for (int j = 0; j < 60; ++j) {
+            const QString fileName = root.filePath((j % 2 ? sub : QString::number(i))
+                                                   + QLatin1String("/file") + QString::number(j));
+            QFile file(fileName);
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(QByteArray(j, 'x'));
+            expected << fileName;
+        }
+    }
+
+    QDirIterator it(tempDir.path(), QDir::AllEntries | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories | QDirIterator::ParallelScan
+                    | QDirIterator::PrefetchMetaData);
+    QSet<QString> actual;
+    for (QFileInfoList batch = it.nextBatch(); !batch.isEmpty(); batch = it.nextBatch()) {
+        QCOMPARE(it.fileInfo(), batch.constLast());
+        for (const QFileInfo &info : qAsConst(batch)) {
+            QVERIFY2(!actual.contains(info.filePath()), qPrintable(info.filePath()));
+            actual << info.filePath();
+            if (info.isFile())
+                QCOMPARE(info.size(), info.fileName().mid(4).toLongLong());
+        }
+    }
+    QVERIFY(!it.hasNext());
+    QCOMPARE(actual, expected);
+
+    // Stopping half-way cancels the scan
+    {
+        QDirIterator it(tempDir.path(), QDir::AllEntries | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories | QDirIterator::ParallelScan);
+        for (int i = 0; i < 100 && it.hasNext(); ++i)
+            it.next();
+    }
+}
+
+void tst_QDirIterator::nextBatch()
+{
+    QDirIterator all("entrylist", QDir::AllEntries | QDir::NoDotAndDotDot);
+    QStringList expected;
+    while (all.hasNext())
+        expected << all.next();
+    QVERIFY(expected.size() > 2);
+
+    QDirIterator it("entrylist", QDir::AllEntries | QDir::NoDotAndDotDot);
+    QStringList list;
+    for (QFileInfoList batch = it.nextBatch(2); !batch.isEmpty(); batch = it.nextBatch(2)) {
+        QVERIFY(batch.size() == 2 || !it.hasNext());
+        QCOMPARE(it.filePath(), batch.constLast().filePath());
+        for (const QFileInfo &info : qAsConst(batch))
+            list << info.filePath();
+    }
+    QCOMPARE(list, expected);
+    QVERIFY(it.nextBatch(0).isEmpty());
+}
+
 void tst_QDirIterator::iterateResource_data()
 {
     QTest::addColumn<QString>("dirName"); // relative from current path or abs
@@ -189,6 +189,9 @@ private slots:
     void copyRemovesTemporaryFile() const;
     void copyShouldntOverwrite();
     void copyFallback();
+#ifdef Q_OS_LINUX
+    void copyVirtualFile();
+#endif
     void link();
     void linkToDir();
     void absolutePathLinkToRelativePath();
@@ -1488,6 +1491,35 @@ void tst_QFile::copyFallback()
             QFile::ReadOwner | QFile::WriteOwner);
 }
 
+#ifdef Q_OS_LINUX
+void tst_QFile::copyVirtualFile()
+{
+    // files in /proc report a size of 0, yet have contents
+    const QString destination = "file-copy-virtual.txt";
+    QFile::remove(destination);
+
+    QFile source("/proc/version");
+    QCOMPARE(QFileInfo(source).size(), Q_INT64_C(0));
+    QVERIFY2(source.open(QIODevice::ReadOnly), msgOpenFailed(source).constData());
+    const QByteArray expected = source.readAll();
+    source.close();
+    QVERIFY(!expected.isEmpty());
+
+    QVERIFY(QFile::copy(source.fileName(), destination));
+    QFile copy(destination);
+    QVERIFY2(copy.open(QIODevice::ReadOnly), msgOpenFailed(copy).constData());
+    QCOMPARE(copy.readAll(), expected);
+    copy.close();
+    QVERIFY(QFile::remove(destination));
+
+    QVERIFY(QFile::copy("/proc/self/status", destination));
+    QVERIFY2(copy.open(QIODevice::ReadOnly), msgOpenFailed(copy).constData());
+    QVERIFY(copy.readAll().startsWith("Name:"));
+    copy.close();
+    QVERIFY(QFile::remove(destination));
+}
+#endif
+
 #ifdef Q_OS_WIN
 #include <objbase.h>
 #include <shlobj.h>
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qfilecopier
+QT = core testlib
+SOURCES = tst_qfilecopier.cpp
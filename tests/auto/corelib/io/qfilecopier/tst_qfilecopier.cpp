@@ -0,0 +1,369 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qdir.h>
+#include <qdiriterator.h>
+#include <qfile.h>
+#include <qfilecopier.h>
+#include <qfileinfo.h>
+#include <qtemporarydir.h>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+class tst_QFileCopier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void copyFile();
+    void copyEmptyFile();
+    void copySparseFile();
+    void copyTree_data();
+    void copyTree();
+    void copySymLinks();
+    void existingDestination();
+    void sameFile();
+    void missingSource();
+    void cancel();
+    void progress();
+
+private:
+    QString path(const QString &name) const { return dir.filePath(name); }
+    static QByteArray readAll(const QString &fileName);
+    static bool writeFile(const QString &fileName, const QByteArray &data);
+    static QByteArray pattern(qsizetype size, int seed);
+    void makeTree(const QString &root, int fileCount);
+
+    QTemporaryDir dir;
+};
+
+void tst_QFileCopier::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+}
+
+QByteArray tst_QFileCopier::readAll(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+bool tst_QFileCopier::writeFile(const QString &fileName, const QByteArray &data)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size();
+}
+
+QByteArray tst_QFileCopier::pattern(qsizetype size, int seed)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    quint32 state = quint32(seed) * 2654435761u + 1;
+    for (qsizetype i = 0; i < size; ++i) {
+        state = state * 1664525u + 1013904223u;
+        data[i] = char(state >> 24);
+    }
+    return data;
+}
+
+void tst_QFileCopier::makeTree(const QString &root, int fileCount)
+{
+    QDir rootDir(root);
+    QVERIFY(rootDir.mkpath("a/b/c"));
+    QVERIFY(rootDir.mkpath("d"));
+    QVERIFY(rootDir.mkpath("empty"));
+    const QStringList subdirs = { QString(), "a", "a/b", "a/b/c", "d" };
+    for (int i = 0; i < fileCount; ++i) {
+        const QString name = rootDir.filePath(subdirs.at(i % subdirs.size())
+                                              + QLatin1String("/file") + QString::number(i));
+        QVERIFY(writeFile(name, pattern(i * 977, i)));
+    }
+    QVERIFY(writeFile(rootDir.filePath(".hidden"), "hidden"));
+}
+
+void tst_QFileCopier::copyFile()
+{
+    const QByteArray data = pattern(3 * 1024 * 1024 + 17, 1);
+    const QString source = path("copyFile.src");
+    const QString destination = path("copyFile.dst");
+    QVERIFY(writeFile(source, data));
+    QVERIFY(QFile::setPermissions(source, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner));
+
+    QFileCopier copier;
+    QVERIFY2(copier.copy(source, destination), qPrintable(copier.errorString()));
+    QCOMPARE(copier.error(), QFileDevice::NoError);
+    QCOMPARE(copier.bytesTotal(), qint64(data.size()));
+    QCOMPARE(copier.bytesCopied(), qint64(data.size()));
+    QCOMPARE(readAll(destination), data);
+#ifdef Q_OS_UNIX
+    QVERIFY(QFile::permissions(destination).testFlag(QFile::ExeOwner));
+#endif
+}
+
+void tst_QFileCopier::copyEmptyFile()
+{
+    const QString source = path("copyEmptyFile.src");
+    const QString destination = path("copyEmptyFile.dst");
+    QVERIFY(writeFile(source, QByteArray()));
+
+    QFileCopier copier;
+    QVERIFY2(copier.copy(source, destination), qPrintable(copier.errorString()));
+    QVERIFY(QFileInfo::exists(destination));
+    QCOMPARE(QFileInfo(destination).size(), qint64(0));
+}
+
+void tst_QFileCopier::copySparseFile()
+{
+    const qint64 size = 64 * 1024 * 1024;
+    const QByteArray middle = pattern(64 * 1024, 2);
+    const QByteArray tail = pattern(1000, 3);
+    const QString source = path("copySparseFile.src");
+    const QString destination = path("copySparseFile.dst");
+    {
+        QFile file(source);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QVERIFY(file.resize(size));
+        QVERIFY(file.seek(size / 2));
+        QCOMPARE(file.write(middle), middle.size());
+        QVERIFY(file.seek(size - tail.size()));
+        QCOMPARE(file.write(tail), tail.size());
+    }
+
+    QFileCopier copier;
+    QVERIFY2(copier.copy(source, destination), qPrintable(copier.errorString()));
+    QCOMPARE(QFileInfo(destination).size(), size);
+    QCOMPARE(readAll(destination), readAll(source));
+
+#ifdef Q_OS_UNIX
+    struct stat sourceStat, destinationStat;
+    QCOMPARE(::stat(QFile::encodeName(source).constData(), &sourceStat), 0);
+    QCOMPARE(::stat(QFile::encodeName(destination).constData(), &destinationStat), 0);
+    if (sourceStat.st_blocks * 512 >= size)
+        QSKIP("The file system does not support sparse files");
+    // the holes must not have been filled in
+    QVERIFY2(destinationStat.st_blocks * 512 < size / 2,
+             qPrintable(QString::number(destinationStat.st_blocks)));
+#endif
+}
+
+void tst_QFileCopier::copyTree_data()
+{
+    QTest::addColumn<int>("threads");
+    QTest::newRow("single-thread") << 1;
+    QTest::newRow("multi-thread") << 4;
+}
+
+void tst_QFileCopier::copyTree()
+{
+    QFETCH(int, threads);
+    const QString source = path(QString("tree.src.") + QTest::currentDataTag());
+    const QString destination = path(QString("tree.dst.") + QTest::currentDataTag());
+    QVERIFY(QDir().mkdir(source));
+    makeTree(source, 50);
+
+    QFileCopier copier;
+    copier.setMaxThreadCount(threads);
+    QCOMPARE(copier.maxThreadCount(), threads);
+    QVERIFY2(copier.copy(source, destination), qPrintable(copier.errorString()));
+    QCOMPARE(copier.bytesCopied(), copier.bytesTotal());
+
+    QStringList sourceEntries;
+    QDirIterator it(source, QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories);
+    qint64 total = 0;
+    while (it.hasNext()) {
+        const QString entry = it.next();
+        const QString relative = QDir(source).relativeFilePath(entry);
+        sourceEntries.append(relative);
+        const QString copy = QDir(destination).filePath(relative);
+        QCOMPARE(QFileInfo(copy).isDir(), it.fileInfo().isDir());
+        if (it.fileInfo().isFile()) {
+            total += it.fileInfo().size();
+            QCOMPARE(readAll(copy), readAll(entry));
+        }
+    }
+    QCOMPARE(copier.bytesTotal(), total);
+
+    QStringList destinationEntries;
+    QDirIterator copied(destination, QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot,
+                        QDirIterator::Subdirectories);
+    while (copied.hasNext())
+        destinationEntries.append(QDir(destination).relativeFilePath(copied.next()));
+    sourceEntries.sort();
+    destinationEntries.sort();
+    QCOMPARE(destinationEntries, sourceEntries);
+}
+
+void tst_QFileCopier::copySymLinks()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("Symbolic links are only tested on Unix");
+#else
+    const QString source = path("links.src");
+    const QString destination = path("links.dst");
+    QVERIFY(QDir().mkpath(source + "/sub"));
+    QVERIFY(writeFile(source + "/sub/target", "target"));
+    QVERIFY(QFile::link("sub/target", source + "/relative"));
+    QVERIFY(QFile::link("does-not-exist", source + "/dangling"));
+
+    QFileCopier copier;
+    QVERIFY2(copier.copy(source, destination), qPrintable(copier.errorString()));
+    QVERIFY(QFileInfo(destination + "/relative").isSymLink());
+    // relative links point into the copy
+    QCOMPARE(QFileInfo(destination + "/relative").symLinkTarget(),
+             QFileInfo(destination + "/sub/target").absoluteFilePath());
+    QCOMPARE(readAll(destination + "/relative"), QByteArray("target"));
+    QVERIFY(QFileInfo(destination + "/dangling").isSymLink());
+    QVERIFY(!QFileInfo::exists(destination + "/dangling"));
+#endif
+}
+
+void tst_QFileCopier::existingDestination()
+{
+    const QString source = path("existing.src");
+    const QString destination = path("existing.dst");
+    QVERIFY(writeFile(source, "new contents"));
+    QVERIFY(writeFile(destination, "old"));
+
+    QFileCopier copier;
+    QVERIFY(!copier.copy(source, destination));
+    QCOMPARE(copier.error(), QFileDevice::CopyError);
+    QVERIFY(!copier.errorString().isEmpty());
+    QCOMPARE(readAll(destination), QByteArray("old"));
+
+    QVERIFY2(copier.copy(source, destination, QFileCopier::OverwriteExisting),
+             qPrintable(copier.errorString()));
+    QCOMPARE(copier.error(), QFileDevice::NoError);
+    QCOMPARE(readAll(destination), QByteArray("new contents"));
+
+    // directories are merged
+    const QString sourceTree = path("existing.tree.src");
+    const QString destinationTree = path("existing.tree.dst");
+    QVERIFY(QDir().mkpath(sourceTree + "/sub"));
+    QVERIFY(QDir().mkpath(destinationTree + "/sub"));
+    QVERIFY(writeFile(sourceTree + "/sub/file", "copied"));
+    QVERIFY(writeFile(destinationTree + "/sub/other", "kept"));
+    QVERIFY(!copier.copy(sourceTree, destinationTree));
+    QVERIFY2(copier.copy(sourceTree, destinationTree, QFileCopier::OverwriteExisting),
+             qPrintable(copier.errorString()));
+    QCOMPARE(readAll(destinationTree + "/sub/file"), QByteArray("copied"));
+    QCOMPARE(readAll(destinationTree + "/sub/other"), QByteArray("kept"));
+}
+
+void tst_QFileCopier::sameFile()
+{
+    const QByteArray data = pattern(64 * 1024, 3);
+    const QString source = path("sameFile.src");
+    QVERIFY(writeFile(source, data));
+
+    QStringList destinations = { source };
+    if (QFile::link(source, path("sameFile.symlink")))
+        destinations.append(path("sameFile.symlink"));
+#ifdef Q_OS_UNIX
+    QVERIFY(::link(QFile::encodeName(source).constData(),
+                   QFile::encodeName(path("sameFile.hardlink")).constData()) == 0);
+    destinations.append(path("sameFile.hardlink"));
+#endif
+
+    // must fail without truncating the source first
+    QFileCopier copier;
+    for (const QString &destination : qAsConst(destinations)) {
+        QVERIFY2(!copier.copy(source, destination, QFileCopier::OverwriteExisting),
+                 qPrintable(destination));
+        QCOMPARE(copier.error(), QFileDevice::CopyError);
+        QCOMPARE(readAll(source), data);
+    }
+}
+
+void tst_QFileCopier::missingSource()
+{
+    QFileCopier copier;
+    QVERIFY(!copier.copy(path("does-not-exist"), path("missingSource.dst")));
+    QCOMPARE(copier.error(), QFileDevice::OpenError);
+    QVERIFY(!QFileInfo::exists(path("missingSource.dst")));
+}
+
+void tst_QFileCopier::cancel()
+{
+    const QString source = path("cancel.src");
+    const QString destination = path("cancel.dst");
+    QVERIFY(QDir().mkdir(source));
+    makeTree(source, 20);
+
+    QFileCopier copier;
+    int emissions = 0;
+    connect(&copier, &QFileCopier::progress, &copier, [&] {
+        ++emissions;
+        copier.cancel();
+    });
+    QVERIFY(!copier.copy(source, destination));
+    QVERIFY(copier.isCanceled());
+    QCOMPARE(copier.error(), QFileDevice::AbortError);
+    QVERIFY(emissions >= 1);
+    QVERIFY(copier.bytesCopied() < copier.bytesTotal());
+
+    // a new copy starts afresh
+    QVERIFY2(copier.copy(source, destination, QFileCopier::OverwriteExisting),
+             qPrintable(copier.errorString()));
+    QVERIFY(!copier.isCanceled());
+}
+
+void tst_QFileCopier::progress()
+{
+    const QString source = path("progress.src");
+    const QString destination = path("progress.dst");
+    QVERIFY(QDir().mkdir(source));
+    makeTree(source, 30);
+
+    QFileCopier copier;
+    QList<QPair<qint64, qint64>> reports;
+    connect(&copier, &QFileCopier::progress, &copier, [&](qint64 copied, qint64 total) {
+        QCOMPARE(QThread::currentThread(), copier.thread());
+        reports.append({ copied, total });
+    });
+    QVERIFY2(copier.copy(source, destination), qPrintable(copier.errorString()));
+    QVERIFY(reports.size() >= 2);
+    QCOMPARE(reports.first().first, qint64(0));
+    QCOMPARE(reports.last().first, copier.bytesTotal());
+    for (int i = 0; i < reports.size(); ++i) {
+        QCOMPARE(reports.at(i).second, copier.bytesTotal());
+        if (i > 0)
+            QVERIFY(reports.at(i).first >= reports.at(i - 1).first);
+    }
+}
+
+QTEST_GUILESS_MAIN(tst_QFileCopier)
+
+#include "tst_qfilecopier.moc"
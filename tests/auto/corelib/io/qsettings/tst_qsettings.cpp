@@ -191,6 +191,10 @@ private slots:
     void spaceAfterComment();
 
     void testXdg();
+
+    void binaryFormat();
+    void binaryFormatPersistence();
+    void binaryFormatDamagedFile();
 private:
     void cleanupTestFiles();
 
@@ -2235,6 +2239,140 @@ void tst_QSettings::testResourceFiles()
     QCOMPARE(settings.value("Field 1/Bottom").toInt(), 90);
 }
 
+void tst_QSettings::binaryFormat()
+{
+    QSettings settings(QSettings::BinaryFormat, QSettings::UserScope, "software.org", "KillerAPP");
+    QCOMPARE(settings.format(), QSettings::BinaryFormat);
+    QVERIFY(settings.fileName().endsWith(QLatin1String("KillerAPP.qsettings")));
+    QVERIFY(settings.isWritable());
+
+    settings.setValue("alpha", 1);
+    settings.setValue("beta/gamma", QSize(3, 4));
+    settings.setValue("beta/delta/epsilon", QStringList() << "a" << "b");
+    settings.setValue("Beta", true);
+    QCOMPARE(settings.value("alpha"), QVariant(1));
+    QCOMPARE(settings.value("beta/gamma"), QVariant(QSize(3, 4)));
+    QCOMPARE(settings.value("Beta"), QVariant(true));
+    QCOMPARE(settings.childKeys(), QStringList() << "Beta" << "alpha");
+    QCOMPARE(settings.childGroups(), QStringList() << "beta");
+
+    settings.sync();
+    QCOMPARE(settings.status(), QSettings::NoError);
+    QVERIFY(QFile::exists(settings.fileName()));
+    QCOMPARE(settings.value("beta/delta/epsilon"), QVariant(QStringList() << "a" << "b"));
+
+    settings.remove("beta");
+    QVERIFY(!settings.contains("beta/gamma"));
+    QVERIFY(!settings.contains("beta/delta/epsilon"));
+    QVERIFY(settings.contains("Beta"));
+    settings.setValue("beta/zeta", 5);
+    QCOMPARE(settings.allKeys(), QStringList() << "Beta" << "alpha" << "beta/zeta");
+
+    settings.sync();
+    QCOMPARE(settings.status(), QSettings::NoError);
+    QCOMPARE(settings.allKeys(), QStringList() << "Beta" << "alpha" << "beta/zeta");
+
+    settings.clear();
+    QVERIFY(settings.allKeys().isEmpty());
+    settings.sync();
+    QVERIFY(settings.allKeys().isEmpty());
+}
+
+void tst_QSettings::binaryFormatPersistence()
+{
+    const QString fileName = settingsPath("binary.qsettings");
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        for (int i = 0; i < 1000; ++i)
+            settings.setValue(QString::fromLatin1("group%1/key%2").arg(i % 10).arg(i), i);
+    }
+    const qint64 compactedSize = QFileInfo(fileName).size();
+
+    // small changes are appended to the file
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        QCOMPARE(settings.value("group3/key3"), QVariant(3));
+        settings.setValue("group3/key3", "three");
+        settings.remove("group4");
+    }
+    QVERIFY(QFileInfo(fileName).size() > compactedSize);
+
+    // many changes make the file be compacted
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        QCOMPARE(settings.value("group3/key3"), QVariant("three"));
+        QCOMPARE(settings.childGroups().size(), 9);
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 100; ++i)
+                settings.setValue(QString::fromLatin1("group5/key%1").arg(i * 10 + 5), round);
+            settings.sync();
+            QCOMPARE(settings.status(), QSettings::NoError);
+        }
+    }
+    // without compaction the log alone would hold 10000 records
+    QVERIFY(QFileInfo(fileName).size() < compactedSize + 384 * 1024);
+
+    QSettings settings(fileName, QSettings::BinaryFormat);
+    QCOMPARE(settings.allKeys().size(), 900);
+    QCOMPARE(settings.value("group5/key995"), QVariant(99));
+    QCOMPARE(settings.value("group3/key3"), QVariant("three"));
+    QVERIFY(!settings.contains("group4/key4"));
+}
+
+void tst_QSettings::binaryFormatDamagedFile()
+{
+    const QString fileName = settingsPath("damaged.qsettings");
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        settings.setValue("a", 1);
+        settings.sync();
+        settings.setValue("b", 2);
+    }
+
+    // a writer that crashed in the middle of appending a change
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::Append));
+        QVERIFY(file.write(QByteArray(200, '\x7f')) == 200);
+    }
+    const qint64 damagedSize = QFileInfo(fileName).size();
+    {
+        QSettings reader(fileName, QSettings::BinaryFormat);
+        QCOMPARE(reader.allKeys(), QStringList() << "a" << "b");
+
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.allKeys(), QStringList() << "a" << "b");
+        settings.setValue("c", 3);
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+
+        // the torn record is overwritten, not truncated under the reader's mapping
+        QCOMPARE(QFileInfo(fileName).size(), damagedSize);
+        reader.sync();
+        QCOMPARE(reader.allKeys(), QStringList() << "a" << "b" << "c");
+    }
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        QCOMPARE(settings.allKeys(), QStringList() << "a" << "b" << "c");
+        settings.setValue("d", 4);
+    }
+    {
+        QSettings settings(fileName, QSettings::BinaryFormat);
+        QCOMPARE(settings.allKeys(), QStringList() << "a" << "b" << "c" << "d");
+    }
+
+    // not a settings file at all
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QVERIFY(file.write("[General]\na=1\n") > 0);
+    }
+    QSettings settings(fileName, QSettings::BinaryFormat);
+    QCOMPARE(settings.status(), QSettings::FormatError);
+    QVERIFY(settings.allKeys().isEmpty());
+}
+
 void tst_QSettings::testRegistryShortRootNames()
 {
 #ifndef Q_OS_WIN
@@ -1,9 +1,12 @@
+QT_FOR_CONFIG += core-private
+
 TEMPLATE=subdirs
 SUBDIRS=\
     qcoreapplication \
     qdeadlinetimer \
     qelapsedtimer \
     qeventdispatcher \
+    qeventdispatcher_epoll \
     qeventloop \
     qmath \
     qmetacontainer \
@@ -20,6 +23,7 @@ SUBDIRS=\
     qsignalblocker \
     qsignalmapper \
     qsocketnotifier \
+    qsocketnotifier_epoll \
     qsystemsemaphore \
     qtimer \
     qtranslator \
@@ -35,13 +39,19 @@ SUBDIRS=\
 !qtHaveModule(network): SUBDIRS -= \
     qeventloop \
     qobject \
-    qsocketnotifier
+    qsocketnotifier \
+    qsocketnotifier_epoll
 
 !qtConfig(private_tests): SUBDIRS -= \
     qsocketnotifier \
+    qsocketnotifier_epoll \
     qsharedmemory \
     qproperty
 
+!qtConfig(epoll): SUBDIRS -= \
+    qeventdispatcher_epoll \
+    qsocketnotifier_epoll
+
 # This test is only applicable on Windows
 !win32*: SUBDIRS -= qwineventnotifier
 
@@ -34,6 +34,19 @@
 #endif
 #include <QtTest/QtTest>
 
+#ifdef USE_EPOLL_DISPATCHER
+#  include <QtCore/private/qeventdispatcher_unix_p.h>
+#  define tst_QEventDispatcher tst_QEventDispatcherEpoll
+
+// the environment is read when the dispatcher is created, in QCoreApplication
+static void useEpollDispatcher()
+{
+    qputenv("QT_NO_GLIB", "1");
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(useEpollDispatcher)
+#endif
+
 enum {
     PreciseTimerInterval    =   10,
     CoarseTimerInterval     =  200,
@@ -91,6 +104,12 @@ bool tst_QEventDispatcher::event(QEvent *e)
 // drain the system event queue after the test starts to avoid destabilizing the test functions
 void tst_QEventDispatcher::initTestCase()
 {
+#ifdef USE_EPOLL_DISPATCHER
+    auto dispatcher = qobject_cast<QEventDispatcherUNIX *>(eventDispatcher);
+    QVERIFY(dispatcher);
+    QVERIFY(static_cast<QEventDispatcherUNIXPrivate *>(QObjectPrivate::get(dispatcher))->epollFd != -1);
+#endif
+
     QElapsedTimer elapsedTimer;
     elapsedTimer.start();
     while (!elapsedTimer.hasExpired(CoarseTimerInterval) && eventDispatcher->processEvents(QEventLoop::AllEvents)) {
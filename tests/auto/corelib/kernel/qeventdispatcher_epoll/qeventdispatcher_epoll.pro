@@ -0,0 +1,5 @@
+CONFIG += testcase
+TARGET = tst_qeventdispatcher_epoll
+QT = core-private testlib
+SOURCES += ../qeventdispatcher/tst_qeventdispatcher.cpp
+DEFINES += USE_EPOLL_DISPATCHER
@@ -44,6 +44,19 @@
 #endif
 #include <limits>
 
+#ifdef USE_EPOLL_DISPATCHER
+#  include <QtCore/private/qeventdispatcher_unix_p.h>
+#  define tst_QSocketNotifier tst_QSocketNotifierEpoll
+
+// the environment is read when the dispatcher is created, in QCoreApplication
+static void useEpollDispatcher()
+{
+    qputenv("QT_NO_GLIB", "1");
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", "1");
+}
+Q_CONSTRUCTOR_FUNCTION(useEpollDispatcher)
+#endif
+
 #if defined (Q_CC_MSVC) && defined(max)
 #  undef max
 #  undef min
@@ -54,6 +67,9 @@ class tst_QSocketNotifier : public QObject
 {
     Q_OBJECT
 private slots:
+#ifdef USE_EPOLL_DISPATCHER
+    void initTestCase();
+#endif
     void unexpectedDisconnection();
     void mixingWithTimers();
 #ifdef Q_OS_UNIX
@@ -63,6 +79,11 @@ private slots:
     void activationReason_data();
     void activationReason();
     void legacyConnect();
+#ifdef USE_EPOLL_DISPATCHER
+    void epollAfterFork();
+    // must be last, it makes the dispatcher fall back to poll()
+    void epollReusedDescriptor();
+#endif
 
 protected slots:
     void async_readDatagramSlot();
@@ -124,6 +145,15 @@ signals:
     void finished();
 };
 
+#ifdef USE_EPOLL_DISPATCHER
+void tst_QSocketNotifier::initTestCase()
+{
+    auto dispatcher = qobject_cast<QEventDispatcherUNIX *>(QAbstractEventDispatcher::instance());
+    QVERIFY(dispatcher);
+    QVERIFY(static_cast<QEventDispatcherUNIXPrivate *>(QObjectPrivate::get(dispatcher))->epollFd != -1);
+}
+#endif
+
 void tst_QSocketNotifier::unexpectedDisconnection()
 {
     /*
@@ -428,5 +458,65 @@ void tst_QSocketNotifier::legacyConnect()
 }
 
 
+#ifdef USE_EPOLL_DISPATCHER
+void tst_QSocketNotifier::epollAfterFork()
+{
+    int fds[2];
+    QCOMPARE(qt_safe_pipe(fds), 0);
+    QSocketNotifier notifier(fds[0], QSocketNotifier::Read);
+    QSignalSpy spy(&notifier, &QSocketNotifier::activated);
+
+    // the child must not change the interest list of the parent
+    const pid_t pid = ::fork();
+    QVERIFY(pid != -1);
+    if (pid == 0) {
+        notifier.setEnabled(false);
+        QCoreApplication::processEvents();
+        ::_exit(0);
+    }
+    int status = 0;
+    QCOMPARE(qt_safe_waitpid(pid, &status, 0), pid);
+
+    QCOMPARE(qt_safe_write(fds[1], "x", 1), qint64(1));
+    QTRY_VERIFY(spy.count() > 0);
+
+    notifier.setEnabled(false);
+    qt_safe_close(fds[0]);
+    qt_safe_close(fds[1]);
+}
+
+void tst_QSocketNotifier::epollReusedDescriptor()
+{
+    int oldPipe[2];
+    QCOMPARE(qt_safe_pipe(oldPipe), 0);
+    // keeps the old pipe open, and registered with epoll
+    const int keep = qt_safe_dup(oldPipe[0]);
+    QSocketNotifier notifier(oldPipe[0], QSocketNotifier::Read);
+    QSignalSpy spy(&notifier, &QSocketNotifier::activated);
+
+    // close the descriptor behind the notifier's back, and reuse its number
+    qt_safe_close(oldPipe[0]);
+    int newPipe[2];
+    QCOMPARE(qt_safe_pipe(newPipe), 0);
+    if (newPipe[0] != notifier.socket())
+        QSKIP("The descriptor was not reused");
+
+    // the old pipe must not activate the notifier any more...
+    QCOMPARE(qt_safe_write(oldPipe[1], "x", 1), qint64(1));
+    QTest::qWait(100);
+    QCOMPARE(spy.count(), 0);
+
+    // ...but the file that has its descriptor now does, as with poll()
+    QCOMPARE(qt_safe_write(newPipe[1], "y", 1), qint64(1));
+    QTRY_VERIFY(spy.count() > 0);
+
+    notifier.setEnabled(false);
+    qt_safe_close(keep);
+    qt_safe_close(oldPipe[1]);
+    qt_safe_close(newPipe[0]);
+    qt_safe_close(newPipe[1]);
+}
+#endif
+
 QTEST_MAIN(tst_QSocketNotifier)
 #include <tst_qsocketnotifier.moc>
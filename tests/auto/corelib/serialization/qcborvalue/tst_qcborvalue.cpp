@@ -41,6 +41,8 @@
 #include <QtTest>
 
 #include <QtCore/private/qbytearray_p.h>
+#include <QtCore/private/qcborvalue_p.h>
+#include <QtCore/private/qjson_p.h>
 
 Q_DECLARE_METATYPE(QCborKnownTags)
 Q_DECLARE_METATYPE(QCborValue)
@@ -106,6 +108,9 @@ private slots:
     void fromCborStreamReaderByteArray();
     void fromCborStreamReaderIODevice_data() { fromCbor_data(); }
     void fromCborStreamReaderIODevice();
+    void fromCborReferenceSourceData_data() { fromCbor_data(); }
+    void fromCborReferenceSourceData();
+    void fromCborReferenceSourceDataLarge();
     void validation_data();
     void validation();
     void extendedTypeValidation_data();
@@ -1988,6 +1993,86 @@ void tst_QCborValue::fromCborStreamReaderIODevice()
     fromCbor_common(doCheck);
 }
 
+void tst_QCborValue::fromCborReferenceSourceData()
+{
+    auto doCheck = [](const QCborValue &v, const QByteArray &result) {
+        QCborParserError error;
+        QCborValue decoded = QCborValue::fromCbor(result, &error, QCborValue::ReferenceSourceData);
+        QVERIFY2(error.error == QCborError(), qPrintable(error.errorString()));
+        QCOMPARE(error.offset, result.size());
+        QVERIFY(decoded == v);
+        QVERIFY(v == decoded);
+        QCOMPARE(decoded.toCbor(), v.toCbor());
+    };
+
+    fromCbor_common(doCheck);
+}
+
+void tst_QCborValue::fromCborReferenceSourceDataLarge()
+{
+    // 100 byte strings of 1 MB each, plus a couple of text strings
+    constexpr int Count = 100;
+    constexpr int ChunkSize = 1024 * 1024;
+    QByteArray encoded;
+    encoded.reserve(Count * (ChunkSize + 5) + 64);
+    encoded += '\x98';
+    encoded += char(Count + 2);
+    for (int i = 0; i < Count; ++i) {
+        encoded += "\x5a\x00\x10\x00\x00";
+        encoded += QByteArray(ChunkSize, char('a' + i % 26));
+    }
+    encoded += "\x65Hello";
+    encoded += "\x6b" "Gr\xc3\xbc\xc3\x9f Gott";
+
+    QCborParserError error;
+    QCborValue v = QCborValue::fromCbor(encoded, &error, QCborValue::ReferenceSourceData);
+    QCOMPARE(error.error, QCborError::NoError);
+    QCOMPARE(error.offset, encoded.size());
+    QVERIFY(v.isArray());
+
+    // only the element index was allocated, no string data was copied
+    const QCborContainerPrivate *d = QJsonPrivate::Value::container(v);
+    QVERIFY(d);
+    QCOMPARE(d->data.size(), 0);
+    QCOMPARE(d->usedData, 0);
+    QCOMPARE(d->elements.size(), Count + 2);
+    for (const QtCbor::Element &e : d->elements)
+        QVERIFY(e.flags & QtCbor::Element::ByteDataInSource);
+    QVERIFY(d->elements.at(Count).flags & QtCbor::Element::StringIsAscii);
+    QVERIFY(!(d->elements.at(Count + 1).flags & QtCbor::Element::StringIsAscii));
+
+    QCborArray array = v.toArray();
+    QCOMPARE(array.size(), Count + 2);
+    QCOMPARE(array.at(0).toByteArray(), QByteArray(ChunkSize, 'a'));
+    QCOMPARE(array.at(Count - 1).toByteArray(), QByteArray(ChunkSize, char('a' + (Count - 1) % 26)));
+    QCOMPARE(array.at(Count).toString(), "Hello");
+    QCOMPARE(array.at(Count + 1).toString(), QString::fromUtf8("Gr\xc3\xbc\xc3\x9f Gott"));
+    QCOMPARE(array.at(Count + 1), QCborValue(QString::fromUtf8("Gr\xc3\xbc\xc3\x9f Gott")));
+
+    // modifying the original buffer detaches it and doesn't affect the result
+    encoded[7] = 'z';
+    QCOMPARE(array.at(0).toByteArray(), QByteArray(ChunkSize, 'a'));
+
+    // values extracted from the array keep the buffer alive
+    QCborValue first = array.takeAt(1);
+    v = QCborValue();
+    array = QCborArray();
+    QCOMPARE(first.toByteArray(), QByteArray(ChunkSize, 'b'));
+
+    // copying into an unrelated container copies the contents
+    QCborArray other;
+    other.append(first);
+    other.append(QCborValue::fromCbor(QByteArray("\x43xyz"), nullptr,
+                                      QCborValue::ReferenceSourceData));
+    first = QCborValue();
+    const QCborContainerPrivate *od = QJsonPrivate::Value::container(other);
+    QVERIFY(od);
+    QVERIFY(od->data.size() > ChunkSize);
+    QVERIFY(!(od->elements.at(0).flags & QtCbor::Element::ByteDataInSource));
+    QCOMPARE(other.at(0).toByteArray(), QByteArray(ChunkSize, 'b'));
+    QCOMPARE(other.at(1).toByteArray(), "xyz");
+}
+
 #include "../cborlargedatavalidation.cpp"
 
 void tst_QCborValue::validation_data()
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qjsonstreamparser
+QT = core testlib
+SOURCES = tst_qjsonstreamparser.cpp
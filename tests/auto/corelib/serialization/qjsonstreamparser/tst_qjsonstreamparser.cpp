@@ -0,0 +1,361 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonstreamparser.h>
+
+class EventRecorder : public QJsonStreamHandler
+{
+public:
+    void startObject() override { events << QStringLiteral("{"); }
+    void endObject() override { events << QStringLiteral("}"); }
+    void startArray() override { events << QStringLiteral("["); }
+    void endArray() override { events << QStringLiteral("]"); }
+    void key(const QString &key) override { events << QLatin1String("key:") + key; }
+    void value(const QJsonValue &value) override
+    {
+        values << value;
+        QJsonArray wrapper { value };
+        const QByteArray json = QJsonDocument(wrapper).toJson(QJsonDocument::Compact);
+        events << QString::fromUtf8(json.mid(1, json.size() - 2));
+    }
+
+    QStringList events;
+    QList<QJsonValue> values;
+};
+
+// rebuilds a document from the events, to compare with QJsonDocument
+class TreeBuilder : public QJsonStreamHandler
+{
+public:
+    void startObject() override { stack.append({ true, {}, {}, {} }); }
+    void startArray() override { stack.append({ false, {}, {}, {} }); }
+    void endObject() override { finish(QJsonValue(stack.takeLast().object)); }
+    void endArray() override { finish(QJsonValue(stack.takeLast().array)); }
+    void key(const QString &key) override { stack.last().key = key; }
+    void value(const QJsonValue &value) override { finish(value); }
+
+    void finish(const QJsonValue &value)
+    {
+        if (stack.isEmpty()) {
+            result = value.isObject() ? QJsonDocument(value.toObject())
+                                      : QJsonDocument(value.toArray());
+        } else if (stack.last().isObject) {
+            stack.last().object.insert(stack.last().key, value);
+        } else {
+            stack.last().array.append(value);
+        }
+    }
+
+    struct Level
+    {
+        bool isObject;
+        QJsonObject object;
+        QJsonArray array;
+        QString key;
+    };
+    QList<Level> stack;
+    QJsonDocument result;
+};
+
+class tst_QJsonStreamParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void events_data();
+    void events();
+    void chunked_data() { events_data(); }
+    void chunked();
+    void treeMatchesDocument_data();
+    void treeMatchesDocument();
+    void errors_data();
+    void errors();
+    void errorOffsetAcrossChunks();
+    void errorOffsetBeyondIntMax();
+    void materializeArrayElements();
+    void depth();
+    void reset();
+};
+
+void tst_QJsonStreamParser::events_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("empty-object") << QByteArray("{}") << QStringList{ "{", "}" };
+    QTest::newRow("empty-array") << QByteArray(" [ ] ") << QStringList{ "[", "]" };
+    QTest::newRow("bom") << QByteArray("\xef\xbb\xbf[]") << QStringList{ "[", "]" };
+    QTest::newRow("scalars")
+            << QByteArray("[true, false, null, 0, -12, 1.5, 2.0, 1e3, \"\"]")
+            << QStringList{ "[", "true", "false", "null", "0", "-12", "1.5", "2", "1000", "\"\"", "]" };
+    QTest::newRow("object")
+            << QByteArray("{\"a\": 1, \"b\": [\"x\", {}], \"c\": {\"d\": null}}")
+            << QStringList{ "{", "key:a", "1", "key:b", "[", "\"x\"", "{", "}", "]",
+                            "key:c", "{", "key:d", "null", "}", "}" };
+    QTest::newRow("strings")
+            << QByteArray("[\"caf\xc3\xa9\", \"\\u00e9\\n\\\"\\\\\", \"\\ud83d\\ude00\", \"a\\\\\"]")
+            << QStringList{ "[", "\"caf\xc3\xa9\"", "\"\xc3\xa9\\n\\\"\\\\\"",
+                            "\"\xf0\x9f\x98\x80\"", "\"a\\\\\"", "]" };
+    QTest::newRow("large-integer")
+            << QByteArray("[9007199254740993, 18446744073709551616]")
+            << QStringList{ "[", "9007199254740993", "1.8446744073709552e+19", "]" };
+}
+
+void tst_QJsonStreamParser::events()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QStringList, expected);
+
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder);
+    QVERIFY(parser.addData(json));
+    QVERIFY(parser.finish());
+    QVERIFY(parser.atEnd());
+    QVERIFY(!parser.hasError());
+    QCOMPARE(parser.error().error, QJsonParseError::NoError);
+    QCOMPARE(recorder.events, expected);
+}
+
+void tst_QJsonStreamParser::chunked()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QStringList, expected);
+
+    // split the document at every position
+    for (qsizetype split = 0; split <= json.size(); ++split) {
+        EventRecorder recorder;
+        QJsonStreamParser parser(&recorder);
+        QVERIFY(parser.addData(QByteArrayView(json).first(split)));
+        QVERIFY(parser.addData(QByteArrayView(json).sliced(split)));
+        QVERIFY(parser.finish());
+        QCOMPARE(recorder.events, expected);
+    }
+
+    // and feed it one byte at a time
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder);
+    for (qsizetype i = 0; i < json.size(); ++i)
+        QVERIFY(parser.addData(QByteArrayView(json).sliced(i, 1)));
+    QVERIFY(parser.finish());
+    QCOMPARE(recorder.events, expected);
+}
+
+void tst_QJsonStreamParser::treeMatchesDocument_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QTest::newRow("nested") << QByteArray(
+            "{\"array\": [1, [2, [3, {\"deep\": true}]], {\"x\": \"y\"}],"
+            " \"dup\": 1, \"dup\": 2, \"text\": \"\\t\\u0041\\/\","
+            " \"numbers\": [-0, 0.0, 1.25e-3, -9223372036854775808]}");
+    QTest::newRow("records") << QByteArray(
+            "[{\"id\": 1, \"tags\": [\"a\", \"b\"]}, {\"id\": 2, \"tags\": []},"
+            " {\"id\": 3, \"owner\": {\"name\": \"\xe5\x90\x8d\"}}]");
+}
+
+void tst_QJsonStreamParser::treeMatchesDocument()
+{
+    QFETCH(QByteArray, json);
+
+    QJsonParseError error;
+    const QJsonDocument expected = QJsonDocument::fromJson(json, &error);
+    QCOMPARE(error.error, QJsonParseError::NoError);
+
+    for (qsizetype chunkSize : { 1, 3, 7, 64 }) {
+        TreeBuilder builder;
+        QJsonStreamParser parser(&builder);
+        for (qsizetype i = 0; i < json.size(); i += chunkSize)
+            QVERIFY(parser.addData(QByteArrayView(json).sliced(i, qMin(chunkSize, json.size() - i))));
+        QVERIFY(parser.finish());
+        QCOMPARE(builder.result, expected);
+    }
+}
+
+void tst_QJsonStreamParser::errors_data()
+{
+    QTest::addColumn<QByteArray>("json");
+    QTest::addColumn<QJsonParseError::ParseError>("expected");
+
+    QTest::newRow("empty") << QByteArray() << QJsonParseError::IllegalValue;
+    QTest::newRow("scalar-document") << QByteArray("1") << QJsonParseError::IllegalValue;
+    QTest::newRow("garbage-at-end") << QByteArray("{} x") << QJsonParseError::GarbageAtEnd;
+    QTest::newRow("unterminated-object") << QByteArray("{\"a\": 1") << QJsonParseError::UnterminatedObject;
+    QTest::newRow("unterminated-array") << QByteArray("[1, 2") << QJsonParseError::UnterminatedArray;
+    QTest::newRow("unterminated-string") << QByteArray("[\"abc") << QJsonParseError::UnterminatedString;
+    QTest::newRow("missing-name-separator") << QByteArray("{\"a\" 1}") << QJsonParseError::MissingNameSeparator;
+    QTest::newRow("missing-value-separator") << QByteArray("[1 2]") << QJsonParseError::MissingValueSeparator;
+    QTest::newRow("missing-object") << QByteArray("{\"a\": 1,}") << QJsonParseError::MissingObject;
+    QTest::newRow("trailing-comma") << QByteArray("[1,]") << QJsonParseError::MissingObject;
+    QTest::newRow("illegal-value") << QByteArray("[tru]") << QJsonParseError::IllegalValue;
+    QTest::newRow("illegal-number") << QByteArray("[-]") << QJsonParseError::IllegalNumber;
+    QTest::newRow("termination-by-number") << QByteArray("[1") << QJsonParseError::TerminationByNumber;
+    QTest::newRow("illegal-escape") << QByteArray("[\"\\u12x4\"]") << QJsonParseError::IllegalEscapeSequence;
+    QTest::newRow("illegal-utf8") << QByteArray("[\"\xc3\x28\"]") << QJsonParseError::IllegalUTF8String;
+    QTest::newRow("deep-nesting") << QByteArray(2000, '[') << QJsonParseError::DeepNesting;
+}
+
+void tst_QJsonStreamParser::errors()
+{
+    QFETCH(QByteArray, json);
+    QFETCH(QJsonParseError::ParseError, expected);
+
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder);
+    if (parser.addData(json))
+        QVERIFY(!parser.finish());
+    QVERIFY(parser.hasError());
+    QVERIFY(!parser.atEnd());
+    QCOMPARE(parser.error().error, expected);
+
+    // once failed, the parser stays failed
+    QVERIFY(!parser.addData("[]"));
+    QVERIFY(!parser.finish());
+    QCOMPARE(parser.error().error, expected);
+
+    // QJsonDocument agrees, except where it looks at the end of the input
+    // before the incremental parser can
+    QJsonParseError error;
+    QJsonDocument::fromJson(json, &error);
+    if (expected != QJsonParseError::TerminationByNumber && expected != QJsonParseError::UnterminatedString)
+        QCOMPARE(error.error, expected);
+}
+
+void tst_QJsonStreamParser::errorOffsetAcrossChunks()
+{
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder);
+    QVERIFY(parser.addData("[1, 2, "));
+    QVERIFY(parser.addData("3, "));
+    QVERIFY(!parser.addData("4 5]"));
+    QCOMPARE(parser.error().error, QJsonParseError::MissingValueSeparator);
+    QCOMPARE(parser.errorOffset(), qint64(12));
+    QCOMPARE(parser.error().offset, 12);
+    QCOMPARE(recorder.events, QStringList({ "[", "1", "2", "3", "4" }));
+}
+
+void tst_QJsonStreamParser::errorOffsetBeyondIntMax()
+{
+    const QByteArray whitespace(1024 * 1024, ' ');
+
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder);
+    QVERIFY(parser.addData("[1"));
+    qint64 position = 2;
+    while (position <= std::numeric_limits<int>::max()) {
+        QVERIFY(parser.addData(whitespace));
+        position += whitespace.size();
+    }
+    QCOMPARE(parser.errorOffset(), qint64(-1));
+    QVERIFY(!parser.addData("2]"));
+
+    QCOMPARE(parser.error().error, QJsonParseError::MissingValueSeparator);
+    QCOMPARE(parser.errorOffset(), position);
+    QCOMPARE(parser.error().offset, std::numeric_limits<int>::max());
+
+    parser.reset();
+    QCOMPARE(parser.errorOffset(), qint64(-1));
+}
+
+void tst_QJsonStreamParser::materializeArrayElements()
+{
+    const QByteArray json =
+            "[{\"id\": 1, \"tags\": [\"a\", \"b\"]}, 2, \"three\", [4, [5]], {\"id\": {\"n\": {}}}]";
+    const QJsonArray expected = QJsonDocument::fromJson(json).array();
+    QCOMPARE(expected.size(), 5);
+
+    for (qsizetype chunkSize : { 1, 5, 1000 }) {
+        EventRecorder recorder;
+        QJsonStreamParser parser(&recorder, QJsonStreamParser::MaterializeArrayElements);
+        QCOMPARE(parser.options(), QJsonStreamParser::Options(QJsonStreamParser::MaterializeArrayElements));
+        for (qsizetype i = 0; i < json.size(); i += chunkSize)
+            QVERIFY(parser.addData(QByteArrayView(json).sliced(i, qMin(chunkSize, json.size() - i))));
+        QVERIFY(parser.finish());
+
+        QCOMPARE(recorder.events.first(), QStringLiteral("["));
+        QCOMPARE(recorder.events.last(), QStringLiteral("]"));
+        QCOMPARE(recorder.events.size(), 7);
+        QCOMPARE(recorder.values.size(), 5);
+        for (int i = 0; i < expected.size(); ++i)
+            QCOMPARE(recorder.values.at(i), expected.at(i));
+    }
+
+    // objects at the top level are reported as usual
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder, QJsonStreamParser::MaterializeArrayElements);
+    QVERIFY(parser.addData("{\"a\": [1]}"));
+    QVERIFY(parser.finish());
+    QCOMPARE(recorder.events, QStringList({ "{", "key:a", "[", "1", "]", "}" }));
+}
+
+void tst_QJsonStreamParser::depth()
+{
+    class DepthRecorder : public QJsonStreamHandler
+    {
+    public:
+        void startObject() override { depths << parser->depth(); }
+        void startArray() override { depths << parser->depth(); }
+        void value(const QJsonValue &) override { depths << parser->depth(); }
+
+        QJsonStreamParser *parser = nullptr;
+        QList<int> depths;
+    } recorder;
+
+    QJsonStreamParser parser(&recorder);
+    recorder.parser = &parser;
+    QCOMPARE(parser.depth(), 0);
+    QVERIFY(parser.addData("[1, {\"a\": [2]}"));
+    QCOMPARE(parser.depth(), 1);
+    QVERIFY(parser.addData("]"));
+    QCOMPARE(parser.depth(), 0);
+    QCOMPARE(recorder.depths, QList<int>({ 1, 1, 2, 3, 3 }));
+}
+
+void tst_QJsonStreamParser::reset()
+{
+    EventRecorder recorder;
+    QJsonStreamParser parser(&recorder);
+    QVERIFY(!parser.addData("[1 x"));
+    QVERIFY(parser.hasError());
+
+    parser.reset();
+    QVERIFY(!parser.hasError());
+    QCOMPARE(parser.handler(), static_cast<QJsonStreamHandler *>(&recorder));
+    recorder.events.clear();
+    QVERIFY(parser.addData("[2]"));
+    QVERIFY(parser.finish());
+    QCOMPARE(recorder.events, QStringList({ "[", "2", "]" }));
+}
+
+QTEST_APPLESS_MAIN(tst_QJsonStreamParser)
+
+#include "tst_qjsonstreamparser.moc"
@@ -80,6 +80,10 @@ private slots:
     void readLineMaxlen();
     void readLinesFromBufferCRCR();
     void readLineInto();
+    void readLineView_data();
+    void readLineView();
+    void readLineViewMixed();
+    void readLineViewTruncatedFile();
 
     // all
     void readAllFromDevice_data();
@@ -661,6 +665,170 @@ void tst_QTextStream::readLineInto()
     QVERIFY(line.isEmpty());
 }
 
+void tst_QTextStream::readLineView_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QStringConverter::Encoding>("encoding");
+
+    QTest::newRow("empty") << QByteArray() << QStringConverter::Utf8;
+    QTest::newRow("one-line") << QByteArray("hello") << QStringConverter::Utf8;
+    QTest::newRow("lf") << QByteArray("a\nbb\n\nccc\n") << QStringConverter::Utf8;
+    QTest::newRow("crlf") << QByteArray("a\r\nbb\r\n\r\nccc") << QStringConverter::Utf8;
+    QTest::newRow("cr-at-end") << QByteArray("a\rb\nc\r") << QStringConverter::Utf8;
+    QTest::newRow("utf8") << QByteArray("gr\xc3\xbc\xc3\x9f\n\xe2\x82\xac") << QStringConverter::Utf8;
+    QTest::newRow("utf8-bom") << QByteArray("\xef\xbb\xbfone\ntwo") << QStringConverter::Utf8;
+    QTest::newRow("latin1") << QByteArray("gr\xfc\xdf\n\xa4") << QStringConverter::Latin1;
+    QStringEncoder toUtf16(QStringConverter::Utf16LE);
+    QTest::newRow("utf16") << QByteArray(toUtf16(u"one\ntwo\r\n")) << QStringConverter::Utf16LE;
+    QByteArray longLines;
+    for (int i = 0; i < 5000; ++i)
+        longLines += QByteArray(i % 97, 'x') + QByteArray::number(i) + '\n';
+    QTest::newRow("long") << longLines << QStringConverter::Utf8;
+}
+
+void tst_QTextStream::readLineView()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QStringConverter::Encoding, encoding);
+
+    QStringList expected;
+    {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+        QTextStream stream(&buffer);
+        stream.setAutoDetectUnicode(false);
+        stream.setEncoding(encoding);
+        QString line;
+        while (stream.readLineInto(&line))
+            expected << line;
+    }
+
+    QFile file(testFileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+    file.close();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QTextStream stream(&file);
+    stream.setAutoDetectUnicode(false);
+    stream.setEncoding(encoding);
+    QStringList lines;
+    QStringView line;
+    while (stream.readLineView(&line))
+        lines << line.toString();
+    QCOMPARE(lines, expected);
+    QVERIFY(stream.atEnd());
+    QVERIFY(line.isNull());
+
+    // the same from a mapping of the file
+    QVERIFY(file.seek(0));
+    stream.setDevice(&file);
+    stream.setMemoryMappingEnabled(true);
+    stream.setAutoDetectUnicode(false);
+    stream.setEncoding(encoding);
+    lines.clear();
+    while (stream.readLineView(&line))
+        lines << line.toString();
+    QCOMPARE(lines, expected);
+    QVERIFY(stream.atEnd());
+
+    // the same through a buffer, which can't be mapped
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    stream.setDevice(&buffer);
+    stream.setAutoDetectUnicode(false);
+    stream.setEncoding(encoding);
+    lines.clear();
+    while (stream.readLineView(&line))
+        lines << line.toString();
+    QCOMPARE(lines, expected);
+
+    // raw lines are Latin-1 for Latin-1 streams and UTF-8 otherwise
+    QVERIFY(file.seek(0));
+    stream.setDevice(&file);
+    stream.setAutoDetectUnicode(false);
+    stream.setEncoding(encoding);
+    lines.clear();
+    QByteArrayView bytes;
+    while (stream.readLineView(&bytes)) {
+        lines << (encoding == QStringConverter::Latin1 ? QString::fromLatin1(bytes)
+                                                       : QString::fromUtf8(bytes));
+    }
+    QCOMPARE(lines, expected);
+    QVERIFY(stream.atEnd());
+}
+
+void tst_QTextStream::readLineViewMixed()
+{
+    QFile file(testFileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("first\nsecond\r\nthird\n42 fourth\nfifth");
+    file.close();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    QTextStream stream(&file);
+    stream.setMemoryMappingEnabled(true);
+    QString line = stream.readLine();
+    QCOMPARE(line, QStringLiteral("first"));
+
+    // switching to views continues where readLine() stopped
+    QStringView view;
+    QVERIFY(stream.readLineView(&view));
+    QCOMPARE(view, QStringLiteral("second"));
+    QCOMPARE(stream.pos(), qint64(14));
+
+    QByteArrayView bytes;
+    QVERIFY(stream.readLineView(&bytes));
+    QCOMPARE(bytes, "third");
+
+    // and back again
+    int number = 0;
+    stream >> number;
+    QCOMPARE(number, 42);
+    QCOMPARE(stream.readLine(), QStringLiteral(" fourth"));
+    QVERIFY(stream.readLineView(&view));
+    QCOMPARE(view, QStringLiteral("fifth"));
+    QVERIFY(stream.atEnd());
+    QVERIFY(!stream.readLineView(&view));
+
+    QVERIFY(stream.seek(6));
+    QVERIFY(stream.readLineView(&bytes));
+    QCOMPARE(bytes, "second");
+    QCOMPARE(stream.readLine(), QStringLiteral("third"));
+
+    // the device follows the stream when it is closed
+    QVERIFY(stream.readLineView(&bytes));
+    file.close();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY(stream.readLineView(&bytes));
+    QCOMPARE(bytes, "first");
+}
+
+void tst_QTextStream::readLineViewTruncatedFile()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i)
+        data += "line " + QByteArray::number(i) + '\n';
+    QFile file(testFileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    QCOMPARE(file.write(data), data.size());
+    file.close();
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    // files aren't mapped unless asked to, so truncating one underneath
+    // the stream, as log rotation does, only ends the lines early
+    QTextStream stream(&file);
+    QVERIFY(!stream.isMemoryMappingEnabled());
+    QByteArrayView bytes;
+    QVERIFY(stream.readLineView(&bytes));
+    QCOMPARE(bytes, "line 0");
+    QVERIFY(QFile::resize(testFileName, 0));
+    int count = 1;
+    while (stream.readLineView(&bytes))
+        ++count;
+    QVERIFY(count < 10000);
+}
+
 // ------------------------------------------------------------------------------
 void tst_QTextStream::readLineFromString_data()
 {
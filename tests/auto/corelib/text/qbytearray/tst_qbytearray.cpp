@@ -90,6 +90,10 @@ private slots:
     void toULongLong();
 
     void number();
+    void appendNumbers();
+    void parseNumbers_data();
+    void parseNumbers();
+    void parseNumbersDouble();
     void toInt_data();
     void toInt();
     void toDouble_data();
@@ -1048,6 +1052,155 @@ void tst_QByteArray::number()
              QString(QByteArray("-9223372036854775808")));
 }
 
+void tst_QByteArray::appendNumbers()
+{
+    const qlonglong signedValues[] = { -7, 0, Q_INT64_C(0x7FFFFFFFFFFFFFFF) };
+    QByteArray ba("[");
+    QCOMPARE(&ba.appendNumbers(signedValues, 3, ", "), &ba);
+    QCOMPARE(ba, QByteArray("[-7, 0, 9223372036854775807"));
+
+    const qulonglong unsignedValues[] = { Q_UINT64_C(0xFFFFFFFFFFFFFFFF), 10 };
+    ba.clear();
+    ba.appendNumbers(unsignedValues, 2, "\t");
+    QCOMPARE(ba, QByteArray("18446744073709551615\t10"));
+
+    const double doubles[] = { 0.1, -2.5, 1e21, 1e-300, qQNaN() };
+    for (char format : { 'g', 'e', 'F' }) {
+        for (int precision : { 6, 1, int(QLocale::FloatingPointShortest) }) {
+            QByteArray expected;
+            for (double d : doubles)
+                expected += QByteArray::number(d, format, precision) + ',';
+            expected.chop(1);
+            ba.clear();
+            ba.appendNumbers(doubles, 5, ",", format, precision);
+            QCOMPARE(ba, expected);
+            QCOMPARE(QByteArray::number(doubles[2], format, precision),
+                     QString::number(doubles[2], format, precision).toLatin1());
+        }
+    }
+}
+
+void tst_QByteArray::parseNumbers_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<char>("separator");
+    QTest::addColumn<QList<qlonglong>>("expected");
+    QTest::addColumn<qsizetype>("endPosition");
+
+    QTest::newRow("empty") << QByteArray() << ',' << QList<qlonglong>() << qsizetype(0);
+    QTest::newRow("single") << QByteArray("42") << ',' << QList<qlonglong>{ 42 } << qsizetype(2);
+    QTest::newRow("csv") << QByteArray("1,-2,+3") << ',' << QList<qlonglong>{ 1, -2, 3 }
+                         << qsizetype(7);
+    QTest::newRow("spaces") << QByteArray(" 1 ,	2 , 3 ") << ',' << QList<qlonglong>{ 1, 2, 3 }
+                            << qsizetype(11);
+    QTest::newRow("space-separated") << QByteArray("10 20 30") << ' '
+                                     << QList<qlonglong>{ 10, 20, 30 } << qsizetype(8);
+    QTest::newRow("trailing-separator") << QByteArray("1,2,") << ','
+                                        << QList<qlonglong>{ 1, 2 } << qsizetype(3);
+    QTest::newRow("trailing-separator-space") << QByteArray("1,2, ") << ','
+                                              << QList<qlonglong>{ 1, 2 } << qsizetype(4);
+    QTest::newRow("only-separator") << QByteArray(",") << ',' << QList<qlonglong>()
+                                    << qsizetype(0);
+    QTest::newRow("empty-field") << QByteArray("1,,2") << ',' << QList<qlonglong>{ 1 }
+                                 << qsizetype(2);
+    QTest::newRow("junk") << QByteArray("3, 14, 15, x, 92") << ','
+                          << QList<qlonglong>{ 3, 14, 15 } << qsizetype(10);
+    QTest::newRow("junk-after-digits") << QByteArray("7,8x") << ',' << QList<qlonglong>{ 7 }
+                                       << qsizetype(2);
+    QTest::newRow("wrong-separator") << QByteArray("1;2") << ',' << QList<qlonglong>()
+                                     << qsizetype(0);
+    QTest::newRow("long-digits") << QByteArray("12345678901234567,000000000000000000000000001")
+                                 << ',' << QList<qlonglong>{ Q_INT64_C(12345678901234567), 1 }
+                                 << qsizetype(45);
+    QTest::newRow("limits") << QByteArray("9223372036854775807,-9223372036854775808") << ','
+                            << QList<qlonglong>{ std::numeric_limits<qlonglong>::max(),
+                                                 std::numeric_limits<qlonglong>::min() }
+                            << qsizetype(40);
+    QTest::newRow("overflow") << QByteArray("1,9223372036854775808") << ','
+                              << QList<qlonglong>{ 1 } << qsizetype(2);
+    QTest::newRow("underflow") << QByteArray("-9223372036854775809") << ','
+                               << QList<qlonglong>() << qsizetype(0);
+}
+
+void tst_QByteArray::parseNumbers()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(char, separator);
+    QFETCH(QList<qlonglong>, expected);
+    QFETCH(qsizetype, endPosition);
+
+    qlonglong values[8];
+    qsizetype end = -1;
+    qsizetype count = QByteArrayView(data).parseNumbers(values, 8, separator, &end);
+    QCOMPARE(QList<qlonglong>(values, values + count), expected);
+    QCOMPARE(end, endPosition);
+
+    count = QLatin1String(data).parseNumbers(values, 8, separator);
+    QCOMPARE(QList<qlonglong>(values, values + count), expected);
+
+    // the same through the unsigned overload, which stops at negative numbers
+    QList<qulonglong> unsignedExpected;
+    for (qlonglong value : expected) {
+        if (value < 0)
+            break;
+        unsignedExpected.append(qulonglong(value));
+    }
+    qulonglong unsignedValues[8];
+    count = QByteArrayView(data).parseNumbers(unsignedValues, 8, separator);
+    QCOMPARE(QList<qulonglong>(unsignedValues, unsignedValues + count), unsignedExpected);
+
+    // stopping early leaves the rest for the next call
+    if (expected.size() > 1) {
+        QCOMPARE(QByteArrayView(data).parseNumbers(values, 1, separator, &end), 1);
+        QCOMPARE(values[0], expected.first());
+        count = QByteArrayView(data).sliced(end).parseNumbers(values, 8, separator);
+        QCOMPARE(QList<qlonglong>(values, values + count), expected.mid(1));
+    }
+
+    qulonglong max;
+    QCOMPARE(QByteArrayView("18446744073709551615").parseNumbers(&max, 1), 1);
+    QCOMPARE(max, std::numeric_limits<qulonglong>::max());
+    QCOMPARE(QByteArrayView("18446744073709551616").parseNumbers(&max, 1), 0);
+}
+
+void tst_QByteArray::parseNumbersDouble()
+{
+    const QByteArray data("0.1, -2.5e3,1e-300 ,  nan,inf,3.14159265358979323846,"
+                          "123456789012345678901234567890, .5, 1E22, -0");
+    const QList<QByteArray> fields = data.split(',');
+    double values[16];
+    qsizetype end = -1;
+    const qsizetype count = QByteArrayView(data).parseNumbers(values, 16, ',', &end);
+    QCOMPARE(count, fields.size());
+    QCOMPARE(end, data.size());
+    for (qsizetype i = 0; i < count; ++i) {
+        bool ok;
+        const double expected = fields.at(i).trimmed().toDouble(&ok);
+        QVERIFY(ok);
+        if (qIsNaN(expected))
+            QVERIFY(qIsNaN(values[i]));
+        else
+            QCOMPARE(values[i], expected);
+    }
+    QVERIFY(std::signbit(values[count - 1]));
+
+    // sample the fast path against the full conversion
+    QRandomGenerator rng(42);
+    QByteArray number;
+    for (int i = 0; i < 10000; ++i) {
+        number.setNum(double(qint64(rng.generate64() >> rng.bounded(64))) / 1000, 'f', rng.bounded(4));
+        double value;
+        QCOMPARE(QByteArrayView(number).parseNumbers(&value, 1), 1);
+        QCOMPARE(value, number.toDouble());
+    }
+
+    QCOMPARE(QByteArrayView("1,1e400").parseNumbers(values, 16, ',', &end), 1);
+    QCOMPARE(end, 2);
+    QCOMPARE(QByteArrayView("1.5.5").parseNumbers(values, 16), 0);
+    QCOMPARE(QLatin1String("0.25;0.5").parseNumbers(values, 16, ';'), 2);
+    QCOMPARE(values[1], 0.5);
+}
+
 // defined later
 extern const char globalChar;
 
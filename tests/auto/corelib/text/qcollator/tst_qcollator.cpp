@@ -32,6 +32,7 @@
 #include <qcollator.h>
 #include <private/qglobal_p.h>
 
+#include <algorithm>
 #include <cstring>
 
 class tst_QCollator : public QObject
@@ -45,8 +46,49 @@ private Q_SLOTS:
     void compare();
 
     void state();
+
+    void sortKeys_data();
+    void sortKeys();
+    void sort_data() { sortKeys_data(); }
+    void sort();
+    void asciiStrings_data() { sortKeys_data(); }
+    void asciiStrings();
 };
 
+// Need to canonicalize sign to -1, 0 or 1, as .compare() can produce any -ve for <, any +ve for >.
+static int asSign(int compared)
+{
+    return compared < 0 ? -1 : compared > 0 ? 1 : 0;
+}
+
+static QStringList collatorTestStrings()
+{
+    return QStringList {
+        QStringLiteral("a"), QStringLiteral("A"), QStringLiteral("b"), QStringLiteral("ab"),
+        QStringLiteral("aB"), QStringLiteral("Ab"), QStringLiteral("a b"), QStringLiteral("a-b"),
+        QStringLiteral("ch"), QStringLiteral("cz"), QStringLiteral("aa"), QStringLiteral("z"),
+        QStringLiteral("10"), QStringLiteral("9"), QStringLiteral("\u00e4"), QStringLiteral("\u00c4b"),
+        QStringLiteral("\u00f8"), QStringLiteral("\u00e5"), QStringLiteral("ae"), QStringLiteral("oe"),
+        QStringLiteral("\u00df"), QStringLiteral("ss"), QStringLiteral("i"), QStringLiteral("I"),
+        QStringLiteral("\u0131"), QStringLiteral("\u0130"), QStringLiteral("a"), QStringLiteral("zz")
+    };
+}
+
+static QStringList asciiTestStrings()
+{
+    static const char alphabet[] = "aAbBcChHiIoOsSzZ019 -_.,'";
+    QRandomGenerator generator(4711);
+    QStringList strings;
+    for (int i = 0; i < 500; ++i) {
+        QString string;
+        const int length = 1 + generator.bounded(6);
+        for (int j = 0; j < length; ++j)
+            string += QLatin1Char(alphabet[generator.bounded(int(sizeof alphabet) - 1)]);
+        strings += string;
+    }
+    return strings;
+}
+
 static bool dpointer_is_null(QCollator &c)
 {
     char mem[sizeof c];
@@ -196,11 +238,6 @@ void tst_QCollator::compare()
 #endif
 
     QCollator collator((QLocale(locale)));
-    // Need to canonicalize sign to -1, 0 or 1, as .compare() can produce any -ve for <, any +ve for >.
-    auto asSign = [](int compared) {
-        return compared < 0 ? -1 : compared > 0 ? 1 : 0;
-    };
-
 #if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_EMBEDDED)
     if (collator.locale() != QLocale())
         QSKIP("Posix implementation of collation only supports default locale");
@@ -242,6 +279,117 @@ void tst_QCollator::state()
 
 }
 
+void tst_QCollator::sortKeys_data()
+{
+    QTest::addColumn<QString>("locale");
+    QTest::addColumn<Qt::CaseSensitivity>("caseSensitivity");
+
+    const char *const locales[] = { "en_US", "de_DE", "sv_SE", "cs_CZ", "da_DK", "tr_TR", "ja_JP" };
+    for (const char *locale : locales) {
+        QTest::addRow("%s-sensitive", locale) << QString::fromLatin1(locale) << Qt::CaseSensitive;
+        QTest::addRow("%s-insensitive", locale) << QString::fromLatin1(locale) << Qt::CaseInsensitive;
+    }
+}
+
+void tst_QCollator::sortKeys()
+{
+    QFETCH(QString, locale);
+    QFETCH(Qt::CaseSensitivity, caseSensitivity);
+
+#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_EMBEDDED)
+    QSKIP("Posix implementation of collation only supports default locale");
+#endif
+
+    QCollator collator((QLocale(locale)));
+    collator.setCaseSensitivity(caseSensitivity);
+
+    QVERIFY(collator.sortKeys(QStringList()).isEmpty());
+
+    for (const QStringList &strings : { collatorTestStrings(), asciiTestStrings() }) {
+        const QCollatorSortKeyList keys = collator.sortKeys(strings);
+        QCOMPARE(keys.size(), strings.size());
+
+        for (qsizetype i = 0; i < strings.size(); ++i) {
+            const QCollatorSortKey key = collator.sortKey(strings.at(i));
+            QCOMPARE(keys.compare(i, i), 0);
+            for (qsizetype j = 0; j < strings.size(); j += 7) {
+                const QCollatorSortKey other = collator.sortKey(strings.at(j));
+                QCOMPARE(asSign(keys.compare(i, j)), asSign(key.compare(other)));
+                QCOMPARE(asSign(keys.compare(j, i)), -asSign(keys.compare(i, j)));
+            }
+        }
+
+        // copies share the keys
+        const QCollatorSortKeyList copy = keys;
+        QCOMPARE(copy.size(), keys.size());
+        QCOMPARE(asSign(copy.compare(0, 1)), asSign(keys.compare(0, 1)));
+    }
+}
+
+void tst_QCollator::sort()
+{
+    QFETCH(QString, locale);
+    QFETCH(Qt::CaseSensitivity, caseSensitivity);
+
+#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_EMBEDDED)
+    QSKIP("Posix implementation of collation only supports default locale");
+#endif
+
+    QCollator collator((QLocale(locale)));
+    collator.setCaseSensitivity(caseSensitivity);
+
+    const auto lessThan = [&collator](const QString &lhs, const QString &rhs) {
+        const QCollatorSortKey left = collator.sortKey(lhs);
+        return left.compare(collator.sortKey(rhs)) < 0;
+    };
+
+    QStringList empty;
+    collator.sort(empty);
+    QVERIFY(empty.isEmpty());
+
+    for (const QStringList &strings : { collatorTestStrings(), asciiTestStrings() }) {
+        QStringList expected = strings;
+        std::stable_sort(expected.begin(), expected.end(), lessThan);
+
+        QStringList sorted = strings;
+        collator.sort(sorted);
+        QCOMPARE(sorted, expected);
+    }
+
+    // large enough to be sorted in several chunks, with lots of equal keys
+    QStringList large;
+    for (int i = 0; i < 20000; ++i)
+        large += QString::number((i * 7919) % 1000) + (i % 2 ? QLatin1String("a") : QLatin1String("A"));
+    QStringList expected = large;
+    std::stable_sort(expected.begin(), expected.end(), lessThan);
+    collator.sort(large);
+    QCOMPARE(large, expected);
+}
+
+void tst_QCollator::asciiStrings()
+{
+    QFETCH(QString, locale);
+    QFETCH(Qt::CaseSensitivity, caseSensitivity);
+
+#if defined(Q_OS_ANDROID) && !defined(Q_OS_ANDROID_EMBEDDED)
+    QSKIP("Posix implementation of collation only supports default locale");
+#endif
+
+    // ASCII-only strings may be compared without going through the
+    // collation library; that must not change the order
+    QCollator collator((QLocale(locale)));
+    collator.setCaseSensitivity(caseSensitivity);
+
+    const QStringList strings = asciiTestStrings();
+    for (const QString &lhs : strings) {
+        const QCollatorSortKey left = collator.sortKey(lhs);
+        for (qsizetype i = 0; i < strings.size(); i += 11) {
+            const QString &rhs = strings.at(i);
+            QCOMPARE(asSign(collator.compare(lhs, rhs)), asSign(left.compare(collator.sortKey(rhs))));
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QCollator)
 
 #include "tst_qcollator.moc"
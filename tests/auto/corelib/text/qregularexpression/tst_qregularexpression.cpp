@@ -32,6 +32,8 @@
 #include <qlist.h>
 #include <qstringlist.h>
 #include <qhash.h>
+#include <qfile.h>
+#include <qtemporarydir.h>
 
 #include <qobject.h>
 #include <qregularexpression.h>
@@ -41,11 +43,18 @@ Q_DECLARE_METATYPE(QRegularExpression::PatternOptions)
 Q_DECLARE_METATYPE(QRegularExpression::MatchType)
 Q_DECLARE_METATYPE(QRegularExpression::MatchOptions)
 
+#ifdef QT_BUILD_INTERNAL
+QT_BEGIN_NAMESPACE
+extern Q_AUTOTEST_EXPORT void qt_regularexpression_resetCompiledPatternCache();
+QT_END_NAMESPACE
+#endif
+
 class tst_QRegularExpression : public QObject
 {
     Q_OBJECT
 
 private slots:
+    void cleanup();
     void defaultConstructors();
     void gettersSetters_data();
     void gettersSetters();
@@ -85,6 +94,14 @@ private slots:
     void testInvalidWildcard_data();
     void testInvalidWildcard();
 
+    void regularExpressionSet();
+    void regularExpressionSetValidity();
+    void regularExpressionSetMatch_data();
+    void regularExpressionSetMatch();
+    void regularExpressionSetLarge();
+    void compiledPatternCache();
+    void compiledPatternCacheBounded();
+
 private:
     void provideRegularExpressions();
 };
@@ -429,6 +446,14 @@ void tst_QRegularExpression::provideRegularExpressions()
                                                                      | QRegularExpression::InvertedGreedinessOption);
 }
 
+void tst_QRegularExpression::cleanup()
+{
+#ifdef QT_BUILD_INTERNAL
+    // loadCompiledPatternCache() enables the cache for the whole process
+    qt_regularexpression_resetCompiledPatternCache();
+#endif
+}
+
 void tst_QRegularExpression::defaultConstructors()
 {
     QRegularExpression re;
@@ -2294,6 +2319,283 @@ void tst_QRegularExpression::testInvalidWildcard()
     QCOMPARE(re.isValid(), isValid);
 }
 
+void tst_QRegularExpression::regularExpressionSet()
+{
+    QRegularExpressionSet empty;
+    QVERIFY(empty.isValid());
+    QCOMPARE(empty.patternCount(), 0);
+    QCOMPARE(empty.errorPatternIndex(), -1);
+    QCOMPARE(empty.patternErrorOffset(), -1);
+    QVERIFY(!empty.hasMatch(u"abc"));
+    QCOMPARE(empty.firstMatchingPattern(u"abc"), -1);
+    QVERIFY(empty.matchingPatterns(u"abc").isEmpty());
+
+    const QStringList patterns = { "abc", "def" };
+    QRegularExpressionSet set(patterns);
+    QVERIFY(set.isValid());
+    QCOMPARE(set.patterns(), patterns);
+    QCOMPARE(set.patternCount(), 2);
+    QCOMPARE(set.patternOptions(), QRegularExpression::NoPatternOption);
+    QVERIFY(!set.hasMatch(u"ABC"));
+
+    QRegularExpressionSet copy = set;
+    set.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    QCOMPARE(set.patternOptions(), QRegularExpression::CaseInsensitiveOption);
+    QCOMPARE(set.firstMatchingPattern(u"xxDEF"), 1);
+    QCOMPARE(copy.patternOptions(), QRegularExpression::NoPatternOption);
+    QCOMPARE(copy.firstMatchingPattern(u"xxDEF"), -1);
+
+    set.setPatterns({ "def", "abc", "ghi" });
+    QCOMPARE(set.patternCount(), 3);
+    QCOMPARE(set.matchingPatterns(u"ABC DEF"), QList<qsizetype>({ 0, 1 }));
+
+    QRegularExpressionSet moved = std::move(set);
+    QCOMPARE(moved.patternCount(), 3);
+    set = copy;
+    QCOMPARE(set.patterns(), patterns);
+    set.swap(moved);
+    QCOMPARE(set.patternCount(), 3);
+    QCOMPARE(moved.patternCount(), 2);
+}
+
+void tst_QRegularExpression::regularExpressionSetValidity()
+{
+    QRegularExpressionSet set({ "a", "b(c", "[d" });
+    QVERIFY(!set.isValid());
+    QCOMPARE(set.errorPatternIndex(), 1);
+    QCOMPARE(set.patternErrorOffset(), QRegularExpression("b(c").patternErrorOffset());
+    QCOMPARE(set.errorString(), QRegularExpression("b(c").errorString());
+
+    QTest::ignoreMessage(QtWarningMsg, "QRegularExpressionSet: called on an invalid QRegularExpressionSet object");
+    QVERIFY(!set.hasMatch(u"a"));
+
+    set.setPatterns({ "a", "b" });
+    QVERIFY(set.isValid());
+    QCOMPARE(set.errorPatternIndex(), -1);
+    QCOMPARE(set.patternErrorOffset(), -1);
+    QCOMPARE(set.errorString(), QRegularExpression("a").errorString());
+    QVERIFY(set.hasMatch(u"a"));
+}
+
+void tst_QRegularExpression::regularExpressionSetMatch_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QRegularExpression::PatternOptions>("options");
+    QTest::addColumn<QString>("subject");
+    QTest::addColumn<qsizetype>("offset");
+    QTest::addColumn<QList<qsizetype>>("expected");
+
+    const auto none = QRegularExpression::PatternOptions(QRegularExpression::NoPatternOption);
+    const auto caseInsensitive = QRegularExpression::PatternOptions(QRegularExpression::CaseInsensitiveOption);
+
+    const QStringList basic = { "abc", "b+c", "^x", "y$", "\\d{3}", "z*" };
+    QTest::newRow("basic") << basic << none << "xabbc" << qsizetype(0) << QList<qsizetype>{ 1, 2, 5 };
+    QTest::newRow("basic-offset") << basic << none << "xabbc" << qsizetype(1) << QList<qsizetype>{ 1, 5 };
+    QTest::newRow("basic-negative-offset") << basic << none << "12345y" << qsizetype(-4) << QList<qsizetype>{ 3, 4, 5 };
+    QTest::newRow("basic-offset-out-of-range") << basic << none << "abc" << qsizetype(4) << QList<qsizetype>{};
+    QTest::newRow("basic-empty-subject") << basic << none << "" << qsizetype(0) << QList<qsizetype>{ 5 };
+
+    const QStringList cased = { "ABC", "(?-i)Def", "(?i)ghi" };
+    QTest::newRow("case-sensitive") << cased << none << "abc Def GHI" << qsizetype(0) << QList<qsizetype>{ 1, 2 };
+    QTest::newRow("case-insensitive") << cased << caseInsensitive << "abc def GHI" << qsizetype(0) << QList<qsizetype>{ 0, 2 };
+
+    // option changes, quoting and comments must stay local to their pattern
+    const QStringList local = { "(?x) a b # comment", "\\Qa.b", "a b", "a.b" };
+    QTest::newRow("local-settings") << local << none << "a b" << qsizetype(0) << QList<qsizetype>{ 2, 3 };
+    QTest::newRow("local-settings-2") << local << none << "ab" << qsizetype(0) << QList<qsizetype>{ 0 };
+    QTest::newRow("local-settings-3") << local << none << "a.b" << qsizetype(0) << QList<qsizetype>{ 1, 3 };
+
+    // duplicate names across patterns
+    const QStringList names = { "(?<n>foo)bar", "(?<n>fo+)$" };
+    QTest::newRow("names") << names << none << "foobar" << qsizetype(0) << QList<qsizetype>{ 0 };
+    QTest::newRow("names-2") << names << none << "fooo" << qsizetype(0) << QList<qsizetype>{ 1 };
+
+    // constructs that need a separate match
+    const QStringList separate = { "(a)\\1", "(x|y)(?1)", "(a)(?(1)b|c)", "(*SKIP)zz|zzz", "(k)\\g{1}",
+                                   "a(?C1)b", "(?<w>b)\\k<w>", "plain" };
+    QTest::newRow("separate") << separate << none << "aa xy ab kk bb plain" << qsizetype(0)
+                              << QList<qsizetype>{ 0, 1, 2, 4, 5, 6, 7 };
+    QTest::newRow("separate-2") << separate << none << "zzz" << qsizetype(0) << QList<qsizetype>{ 3 };
+    QTest::newRow("separate-3") << separate << none << "plain" << qsizetype(0) << QList<qsizetype>{ 7 };
+
+    const QStringList unicode = { "é", "\\x{1F600}", "^.$" };
+    QTest::newRow("unicode") << unicode << none << QString::fromUtf8("\U0001F600") << qsizetype(0)
+                             << QList<qsizetype>{ 1, 2 };
+    QTest::newRow("unicode-2") << unicode << caseInsensitive << QString::fromUtf8("É") << qsizetype(0)
+                               << QList<qsizetype>{ 0, 2 };
+}
+
+void tst_QRegularExpression::regularExpressionSetMatch()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QRegularExpression::PatternOptions, options);
+    QFETCH(QString, subject);
+    QFETCH(qsizetype, offset);
+    QFETCH(QList<qsizetype>, expected);
+
+    // the set must agree with matching the patterns one by one
+    QList<qsizetype> oneByOne;
+    for (qsizetype i = 0; i < patterns.size(); ++i) {
+        if (QRegularExpression(patterns.at(i), options).match(subject, offset).hasMatch())
+            oneByOne.append(i);
+    }
+    QCOMPARE(oneByOne, expected);
+
+    const QRegularExpressionSet set(patterns, options);
+    QVERIFY(set.isValid());
+    QCOMPARE(set.matchingPatterns(subject, offset), expected);
+    QCOMPARE(set.firstMatchingPattern(subject, offset), expected.isEmpty() ? -1 : expected.first());
+    QCOMPARE(set.hasMatch(subject, offset), !expected.isEmpty());
+}
+
+void tst_QRegularExpression::regularExpressionSetLarge()
+{
+    // too many patterns for a single combined program
+    QStringList patterns;
+    for (int i = 0; i < 5000; ++i)
+        patterns.append(QStringLiteral("\\bkey%1\\b").arg(i));
+    patterns.append(QStringLiteral("key(\\d+)\\s+key\\1"));
+
+    const QRegularExpressionSet set(patterns);
+    QVERIFY(set.isValid());
+
+    QString subject;
+    for (int i = 0; i < 1000; ++i)
+        subject += QStringLiteral("word%1 ").arg(i);
+    QVERIFY(!set.hasMatch(subject));
+    QCOMPARE(set.firstMatchingPattern(subject), -1);
+
+    subject += QStringLiteral("key4999 key2500 key42 key7 key7");
+    QCOMPARE(set.matchingPatterns(subject), QList<qsizetype>({ 7, 42, 2500, 4999, 5000 }));
+    QCOMPARE(set.firstMatchingPattern(subject), 7);
+    QVERIFY(set.hasMatch(subject));
+    QCOMPARE(set.matchingPatterns(subject, subject.size() - 9), QList<qsizetype>({ 7, 5000 }));
+    QCOMPARE(set.firstMatchingPattern(subject, subject.size() - 22), 42);
+    QCOMPARE(set.firstMatchingPattern(QStringLiteral("key4999 key2500")), 2500);
+    QVERIFY(set.hasMatch(QStringLiteral("key4999")));
+}
+
+void tst_QRegularExpression::compiledPatternCache()
+{
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("cache/qregularexpression.cache"));
+
+    // the cache is disabled until it's first loaded
+    QVERIFY(!QRegularExpression::saveCompiledPatternCache(fileName));
+    QVERIFY(!QRegularExpression::loadCompiledPatternCache(fileName));
+
+    const auto check = [] {
+        QRegularExpression re(QStringLiteral("(?<word>\\w+)@(\\d+)"));
+        QVERIFY(re.isValid());
+        QCOMPARE(re.captureCount(), 2);
+        QCOMPARE(re.namedCaptureGroups(), QStringList({ QString(), "word", QString() }));
+        QRegularExpressionMatch match = re.match(QStringLiteral("see foo@42"));
+        QVERIFY(match.hasMatch());
+        QCOMPARE(match.captured("word"), QStringLiteral("foo"));
+
+        QRegularExpression caseInsensitive(QStringLiteral("^abc$"), QRegularExpression::CaseInsensitiveOption);
+        QVERIFY(caseInsensitive.match(QStringLiteral("ABC")).hasMatch());
+        QRegularExpression caseSensitive(QStringLiteral("^abc$"));
+        QVERIFY(!caseSensitive.match(QStringLiteral("ABC")).hasMatch());
+
+        QRegularExpression invalid(QStringLiteral("a(b"));
+        QVERIFY(!invalid.isValid());
+        QVERIFY(invalid.patternErrorOffset() >= 0);
+    };
+
+    check();
+    QVERIFY(QRegularExpression::saveCompiledPatternCache(fileName));
+    QVERIFY(QFile::exists(fileName));
+
+    QVERIFY(QRegularExpression::loadCompiledPatternCache(fileName));
+    check();
+
+    // a damaged file is rejected
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QVERIFY(file.resize(file.size() / 2));
+    }
+    QVERIFY(!QRegularExpression::loadCompiledPatternCache(fileName));
+    check();
+    QVERIFY(QRegularExpression::saveCompiledPatternCache(fileName));
+    QVERIFY(QRegularExpression::loadCompiledPatternCache(fileName));
+}
+
+// the patterns stored in a cache file, from the table that precedes the compiled code
+static QStringList compiledPatternCacheFilePatterns(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 magic, version, pcreMajor, pcreMinor;
+    quint8 pointerSize, byteOrder;
+    QByteArray table;
+    in >> magic >> version >> pcreMajor >> pcreMinor >> pointerSize >> byteOrder >> table;
+
+    QDataStream tableIn(table);
+    tableIn.setVersion(QDataStream::Qt_6_0);
+    quint32 count;
+    tableIn >> count;
+    QStringList patterns;
+    for (quint32 i = 0; i < count && tableIn.status() == QDataStream::Ok; ++i) {
+        QString pattern;
+        quint32 patternOptions;
+        tableIn >> pattern >> patternOptions;
+        patterns.append(pattern);
+    }
+    return patterns;
+}
+
+void tst_QRegularExpression::compiledPatternCacheBounded()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("qregularexpression.cache"));
+    QVERIFY(!QRegularExpression::loadCompiledPatternCache(fileName));
+
+    // about 8 MB of patterns and compiled code, twice what the cache keeps
+    const QString filler(1000, QLatin1Char('x'));
+    const QString kept = QStringLiteral("kept:") + filler;
+    const int patternCount = 2000;
+    for (int i = 0; i < patternCount; ++i) {
+        QVERIFY(QRegularExpression(QStringLiteral("pattern%1:").arg(i) + filler).isValid());
+        if (i % 100 == 0)
+            QVERIFY(QRegularExpression(kept).isValid());
+    }
+
+    QVERIFY(QRegularExpression::saveCompiledPatternCache(fileName));
+    const QStringList patterns = compiledPatternCacheFilePatterns(fileName);
+    QVERIFY(patterns.size() > 0);
+    QVERIFY(patterns.size() < patternCount);
+    QVERIFY(QFileInfo(fileName).size() < 8 * 1024 * 1024);
+    QVERIFY(patterns.contains(kept));
+    QVERIFY(patterns.contains(QStringLiteral("pattern%1:").arg(patternCount - 1) + filler));
+    QVERIFY(!patterns.contains(QStringLiteral("pattern0:") + filler));
+
+    // the digest covers the patterns as well as the compiled code
+    QByteArray contents;
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        contents = file.readAll();
+    }
+    // QDataStream stores the patterns as big endian UTF-16
+    const qsizetype pos = contents.indexOf(QByteArray("\0k\0e\0p\0t\0:", 10));
+    QVERIFY(pos >= 0);
+    contents[pos + 1] = 'K';
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(contents), contents.size());
+    }
+    QVERIFY(!QRegularExpression::loadCompiledPatternCache(fileName));
+}
+
 QTEST_APPLESS_MAIN(tst_QRegularExpression)
 
 #include "tst_qregularexpression.moc"
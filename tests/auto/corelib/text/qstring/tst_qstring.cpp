@@ -520,6 +520,7 @@ private slots:
     void arg();
     void number();
     void doubleOut();
+    void appendNumbers();
     void arg_fillChar_data();
     void arg_fillChar();
     void capacity_data();
@@ -559,6 +560,9 @@ private slots:
     void repeated() const;
     void repeated_data() const;
     void arg_locale();
+    void appendArgs();
+    void appendArgs_locale();
+    void appendArgs_byteArray();
 #if QT_CONFIG(icu)
     void toUpperLower_icu();
 #endif
@@ -4812,6 +4816,56 @@ void tst_QString::doubleOut()
     }
 }
 
+void tst_QString::appendNumbers()
+{
+    const qlonglong signedValues[] = { 0, -1, 42, std::numeric_limits<qlonglong>::min(),
+                                       std::numeric_limits<qlonglong>::max() };
+    QString str = QLatin1String("ints:");
+    QCOMPARE(&str.appendNumbers(signedValues, 5, u", "), &str);
+    QCOMPARE(str, QLatin1String("ints:0, -1, 42, -9223372036854775808, 9223372036854775807"));
+
+    const qulonglong unsignedValues[] = { 0, 100, std::numeric_limits<qulonglong>::max() };
+    str.clear();
+    str.appendNumbers(unsignedValues, 3, u";");
+    QCOMPARE(str, QLatin1String("0;100;18446744073709551615"));
+
+    // each number reads as number() writes it
+    const double doubles[] = { 0.0, -0.0, 1.0, -2.5, 0.1, 1e-7, 0.000123, 123456789.0, 1e21,
+                               qInf(), -qInf(), qQNaN() };
+    const qsizetype count = sizeof doubles / sizeof *doubles;
+    for (char format : { 'g', 'G', 'e', 'E', 'f' }) {
+        for (int precision : { 6, 0, 2, 17, int(QLocale::FloatingPointShortest) }) {
+            QStringList expected;
+            for (double d : doubles)
+                expected << QString::number(d, format, precision);
+            str.clear();
+            str.appendNumbers(doubles, count, u"|", format, precision);
+            QCOMPARE(str, expected.join(u'|'));
+        }
+    }
+
+    str = QLatin1String("x");
+    str.appendNumbers(doubles, 0, u",");
+    QCOMPARE(str, QLatin1String("x"));
+    str.appendNumbers(unsignedValues + 1, 1, u",");
+    QCOMPARE(str, QLatin1String("x100"));
+
+    // the separator may refer to the string itself
+    str = QLatin1String(", ");
+    str.appendNumbers(unsignedValues, 3, str);
+    QCOMPARE(str, QLatin1String(", 0, 100, 18446744073709551615"));
+
+    // the C locale's text, written without intermediate strings
+    QCOMPARE(QString::number(1e21), QLatin1String("1e+21"));
+    QCOMPARE(QString::number(123456789.0), QLatin1String("1.23457e+08"));
+    QCOMPARE(QString::number(0.5, 'E', 2), QLatin1String("5.00E-01"));
+    QCOMPARE(QString::number(1e-5, 'f', 8), QLatin1String("0.00001000"));
+    QCOMPARE(QString::number(100.0, 'f', QLocale::FloatingPointShortest), QLatin1String("100"));
+    QCOMPARE(QString::number(-1e-7, 'g', QLocale::FloatingPointShortest), QLatin1String("-1e-07"));
+    QCOMPARE(QString::number(qInf(), 'G'), QLatin1String("INF"));
+    QCOMPARE(QString::asprintf("%+08.2f|%05d|% d", 3.14159, -42, 7), QLatin1String("+0003.14|-0042| 7"));
+}
+
 void tst_QString::capacity_data()
 {
     length_data();
@@ -6292,6 +6346,98 @@ void tst_QString::arg_locale()
     QCOMPARE(str.arg(123456).arg(1234.56), QString::fromLatin1("*123456*1234.56*"));
 }
 
+void tst_QString::appendArgs()
+{
+    QString str;
+    QCOMPARE(&str.appendArgs(u"[%1 %2 %3]", QString("foo"), QStringView(u"bar"), QLatin1String("baz")), &str);
+    QCOMPARE(str, QLatin1String("[foo bar baz]"));
+
+    // numbers are formatted as arg() does
+    str.clear();
+    str.appendArgs(u"%1 %2 %3 %4 %5", 42, -7, 3.5, 1.5f, 1e100);
+    QCOMPARE(str, QString("%1 %2 %3 %4 %5").arg(42).arg(-7).arg(3.5).arg(1.5f).arg(1e100));
+    str.clear();
+    str.appendArgs(QLatin1String("%1 %2 %3 %4"), std::numeric_limits<qlonglong>::min(),
+                   std::numeric_limits<qulonglong>::max(), short(-3), uchar(200));
+    QCOMPARE(str, QLatin1String("-9223372036854775808 18446744073709551615 -3 200"));
+
+    // characters are characters
+    str.clear();
+    str.appendArgs(u"%1%2", 'a', QChar(0x263a));
+    QCOMPARE(str, QStringView(u"a\u263a"));
+
+    // appends to the existing contents
+    str = QLatin1String("log:");
+    str.appendArgs(u" %1=%2", QLatin1String("x"), 1).appendArgs(QLatin1String(" %1=%2"), QLatin1String("y"), 2);
+    QCOMPARE(str, QLatin1String("log: x=1 y=2"));
+
+    // placeholders are matched as by the multi-argument arg()
+    str.clear();
+    str.appendArgs(u"[%9 %3 %1 %3]", 1, 2, 3);
+    QCOMPARE(str, QLatin1String("[3 2 1 2]"));
+    str.clear();
+    str.appendArgs(u"[%1 %L2]", 1);
+    QCOMPARE(str, QLatin1String("[1 %L2]"));
+    str.clear();
+    str.appendArgs(u"no placeholders");
+    QCOMPARE(str, QLatin1String("no placeholders"));
+    str.clear();
+    QTest::ignoreMessage(QtWarningMsg, "QString::arg: 1 argument(s) missing in [%1]");
+    str.appendArgs(u"[%1]", 1, 2);
+    QCOMPARE(str, QLatin1String("[1]"));
+
+    // the format and the arguments may refer to the string itself
+    str = QLatin1String("abc");
+    str.appendArgs(u"%1%1%1%1%1%1%1%1", str);
+    QCOMPARE(str, QLatin1String("abcabcabcabcabcabcabcabcabc"));
+    str = QLatin1String("[%1]");
+    str.appendArgs(str, 5);
+    QCOMPARE(str, QLatin1String("[%1][5]"));
+
+    // appending to a string with enough capacity doesn't reallocate
+    str.clear();
+    str.reserve(100);
+    const QChar *data = str.constData();
+    str.appendArgs(u"%1 [%2] %3 (%4)", 1, QLatin1String("warning"), QString("message"), 0.5);
+    QCOMPARE(str, QLatin1String("1 [warning] message (0.5)"));
+    QCOMPARE(str.constData(), data);
+}
+
+void tst_QString::appendArgs_locale()
+{
+    QLocale l(QLocale::German, QLocale::Germany);
+    TransientDefaultLocale transient(l);
+
+    QString str;
+    str.appendArgs(u"*%L1*%L2*%1*%2*%L3*", 123456, 1234.56, std::numeric_limits<qulonglong>::max());
+    QCOMPARE(str, QString("*%L1*%L2*%1*%2*%L3*").arg(123456).arg(1234.56).arg(std::numeric_limits<qulonglong>::max()));
+    QCOMPARE(str, QString::fromUtf8("*123.456*1.234,56*123456*1234.56*18.446.744.073.709.551.615*"));
+
+    l.setNumberOptions(QLocale::OmitGroupSeparator);
+    transient.revise(l);
+    str.clear();
+    str.appendArgs(u"*%L1*%L2*", 123456, 1234.56);
+    QCOMPARE(str, QString::fromLatin1("*123456*1234,56*"));
+}
+
+void tst_QString::appendArgs_byteArray()
+{
+    QByteArray ba("x:");
+    QCOMPARE(&ba.appendArgs(QLatin1String(" %1 %2"), QLatin1String("a"), 1), &ba);
+    QCOMPARE(ba, QByteArray("x: a 1"));
+
+    // the result is UTF-8, whatever the arguments are
+    ba.clear();
+    ba.appendArgs(QLatin1String("%1 \xe9 %2 %3 %4"), QString::fromUtf8("Fl\xc3\xbcgel \xf0\x9f\x98\x80"),
+                  QLatin1String("\xfc"), 1024, -0.25);
+    QCOMPARE(ba, QString::fromLatin1("%1 \xe9 %2 %3 %4").arg(QString::fromUtf8("Fl\xc3\xbcgel \xf0\x9f\x98\x80"))
+                 .arg(QLatin1String("\xfc")).arg(1024).arg(-0.25).toUtf8());
+
+    ba = "[%1]";
+    ba.appendArgs(QLatin1String(ba.constData(), ba.size()), ba.size());
+    QCOMPARE(ba, QByteArray("[%1][4]"));
+}
+
 
 #if QT_CONFIG(icu)
 // Qt has to be built with ICU support
@@ -57,6 +57,9 @@ private slots:
     void utf8stateful_data();
     void utf8stateful();
 
+    void utf8MixedScript_data();
+    void utf8MixedScript();
+
     void utfHeaders_data();
     void utfHeaders();
 
@@ -1420,6 +1423,59 @@ void tst_QStringConverter::utf8stateful()
     }
 }
 
+void tst_QStringConverter::utf8MixedScript_data()
+{
+    QTest::addColumn<QString>("pattern");
+
+    QTest::newRow("latin-accented") << QStringLiteral("Größere Übungen für Ärzte, élèves. ");
+    QTest::newRow("cyrillic") << QStringLiteral("Съешь же ещё этих мягких булок. ");
+    QTest::newRow("cjk") << QStringLiteral("敏捷的棕色狐狸跳过了懒狗。いろはにほへと");
+    QTest::newRow("mixed") << QStringLiteral("abc Ξεσκεπάζω 狐狸 déjà Съешь \uffff\u0800\u07ff\ue000");
+    QTest::newRow("supplementary") << QString::fromUcs4(U"\u4e00\u00e9\U00010428x\u0416");
+}
+
+void tst_QStringConverter::utf8MixedScript()
+{
+    // long enough for the vectorized paths to kick in at every alignment
+    QFETCH(QString, pattern);
+    QString text;
+    while (text.size() < 256)
+        text += pattern;
+
+    // converting one unit or byte at a time only uses the scalar code
+    QByteArray expectedUtf8;
+    QStringEncoder encoder(QStringEncoder::Utf8);
+    for (qsizetype i = 0; i < text.size(); ++i)
+        expectedUtf8 += encoder(QStringView(text).sliced(i, 1));
+    QVERIFY(!encoder.hasError());
+
+    for (qsizetype offset = 0; offset < 16; ++offset) {
+        QStringView view = QStringView(text).sliced(offset);
+        QByteArray utf8 = view.toUtf8();
+        QCOMPARE(QString::fromUtf8(utf8), view);
+        QCOMPARE(QStringEncoder(QStringEncoder::Utf8).encode(view), QByteArray(utf8));
+        QCOMPARE(QStringDecoder(QStringDecoder::Utf8).decode(utf8), view);
+    }
+    QCOMPARE(text.toUtf8(), expectedUtf8);
+
+    // every kind of corruption at every position must be handled like the
+    // scalar decoder does
+    for (uchar corruption : { 0x80, 0xbf, 0xc0, 0xc1, 0xe0, 0xed, 0xf0, 0xff, 'x' }) {
+        for (qsizetype i = 0; i < expectedUtf8.size(); ++i) {
+            QByteArray broken = expectedUtf8;
+            broken[i] = char(corruption);
+
+            QStringDecoder bytewise(QStringDecoder::Utf8);
+            QString expected;
+            for (qsizetype j = 0; j < broken.size(); ++j)
+                expected += bytewise(QByteArrayView(broken).sliced(j, 1));
+            QStringDecoder decoder(QStringDecoder::Utf8);
+            QCOMPARE(decoder(broken), expected);
+            QCOMPARE(decoder.hasError(), bytewise.hasError());
+        }
+    }
+}
+
 void tst_QStringConverter::utfHeaders_data()
 {
     QTest::addColumn<QStringConverter::Encoding>("encoding");
@@ -0,0 +1,4 @@
+CONFIG += testcase
+TARGET = tst_qstringmultimatcher
+QT = core testlib
+SOURCES = tst_qstringmultimatcher.cpp
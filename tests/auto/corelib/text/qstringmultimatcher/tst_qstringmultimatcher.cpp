@@ -0,0 +1,262 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <qstringmatcher.h>
+#include <qstringmultimatcher.h>
+
+class tst_QStringMultiMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void defaultConstructed();
+    void findAll_data();
+    void findAll();
+    void findAllUtf8_data();
+    void findAllUtf8();
+    void findNext();
+    void setters();
+    void largePatternSet_data();
+    void largePatternSet();
+};
+
+// flattens matches to (patternIndex, offset, length) triples
+static QList<qsizetype> flatten(const QList<QStringMultiMatcher::Match> &matches)
+{
+    QList<qsizetype> result;
+    for (const QStringMultiMatcher::Match &m : matches)
+        result << m.patternIndex << m.offset << m.length;
+    return result;
+}
+
+void tst_QStringMultiMatcher::defaultConstructed()
+{
+    QStringMultiMatcher matcher;
+    QCOMPARE(matcher.patternCount(), 0);
+    QVERIFY(matcher.patterns().isEmpty());
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseSensitive);
+    QVERIFY(matcher.findAll(u"some text").isEmpty());
+    QVERIFY(matcher.findAll(QByteArrayView("some text")).isEmpty());
+    QVERIFY(!matcher.findNext(u"some text").isValid());
+}
+
+void tst_QStringMultiMatcher::findAll_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QList<qsizetype>>("expected");
+
+    const QStringList classic = { "he", "she", "his", "hers" };
+    QTest::newRow("classic") << classic << Qt::CaseSensitive << "ushers"
+                             << QList<qsizetype>{ 1, 1, 3,  0, 2, 2,  3, 2, 4 };
+    QTest::newRow("classic-no-match") << classic << Qt::CaseSensitive << "USHERS"
+                                      << QList<qsizetype>{};
+    QTest::newRow("classic-ci") << classic << Qt::CaseInsensitive << "USHERS"
+                                << QList<qsizetype>{ 1, 1, 3,  0, 2, 2,  3, 2, 4 };
+    QTest::newRow("empty-haystack") << classic << Qt::CaseSensitive << QString()
+                                    << QList<qsizetype>{};
+    QTest::newRow("overlapping") << QStringList{ "aa" } << Qt::CaseSensitive << "aaaa"
+                                 << QList<qsizetype>{ 0, 0, 2,  0, 1, 2,  0, 2, 2 };
+    QTest::newRow("nested") << QStringList{ "a", "abc", "bc", "c" } << Qt::CaseSensitive << "abcd"
+                            << QList<qsizetype>{ 0, 0, 1,  1, 0, 3,  2, 1, 2,  3, 2, 1 };
+    QTest::newRow("duplicates") << QStringList{ "ab", "ab" } << Qt::CaseSensitive << "xab"
+                                << QList<qsizetype>{ 0, 1, 2,  1, 1, 2 };
+    QTest::newRow("empty-pattern") << QStringList{ QString(), "b" } << Qt::CaseSensitive << "abc"
+                                   << QList<qsizetype>{ 1, 1, 1 };
+    QTest::newRow("whole-string") << QStringList{ "keyword" } << Qt::CaseSensitive << "keyword"
+                                  << QList<qsizetype>{ 0, 0, 7 };
+    QTest::newRow("latin1-ci") << QStringList{ QString::fromUtf8("caf\xc3\xa9") }
+                               << Qt::CaseInsensitive << QString::fromUtf8("un CAF\xc3\x89 noir")
+                               << QList<qsizetype>{ 0, 3, 4 };
+    QTest::newRow("non-latin1-ci") << QStringList{ QString::fromUtf8("\xce\xbb\xcf\x8c\xce\xb3\xce\xbf\xcf\x82") }
+                                   << Qt::CaseInsensitive
+                                   << QString::fromUtf8("\xce\x9b\xce\x8c\xce\x93\xce\x9f\xce\xa3 x")
+                                   << QList<qsizetype>{ 0, 0, 5 };
+    QTest::newRow("surrogates") << QStringList{ QString::fromUtf8("\xf0\x9f\x98\x80") }
+                                << Qt::CaseSensitive
+                                << QString::fromUtf8("a\xf0\x9f\x98\x80 b\xf0\x9f\x98\x80")
+                                << QList<qsizetype>{ 0, 1, 2,  0, 5, 2 };
+}
+
+void tst_QStringMultiMatcher::findAll()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(Qt::CaseSensitivity, cs);
+    QFETCH(QString, haystack);
+    QFETCH(QList<qsizetype>, expected);
+
+    QStringMultiMatcher matcher(patterns, cs);
+    QCOMPARE(matcher.patterns(), patterns);
+    QCOMPARE(matcher.patternCount(), patterns.size());
+    QCOMPARE(matcher.caseSensitivity(), cs);
+    QCOMPARE(flatten(matcher.findAll(haystack)), expected);
+}
+
+void tst_QStringMultiMatcher::findAllUtf8_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QList<qsizetype>>("expected");
+
+    const QStringList classic = { "he", "she", "his", "hers" };
+    QTest::newRow("classic") << classic << Qt::CaseSensitive << QByteArray("ushers")
+                             << QList<qsizetype>{ 1, 1, 3,  0, 2, 2,  3, 2, 4 };
+    QTest::newRow("classic-ci") << classic << Qt::CaseInsensitive << QByteArray("USHERS")
+                                << QList<qsizetype>{ 1, 1, 3,  0, 2, 2,  3, 2, 4 };
+    // offsets and lengths are in bytes
+    QTest::newRow("non-ascii") << QStringList{ QString::fromUtf8("caf\xc3\xa9"), "noir" }
+                               << Qt::CaseSensitive << QByteArray("un caf\xc3\xa9 noir")
+                               << QList<qsizetype>{ 0, 3, 5,  1, 9, 4 };
+    // only US-ASCII letters are folded
+    QTest::newRow("non-ascii-ci") << QStringList{ QString::fromUtf8("caf\xc3\xa9") }
+                                  << Qt::CaseInsensitive << QByteArray("CAF\xc3\xa9 CAF\xc3\x89")
+                                  << QList<qsizetype>{ 0, 0, 5 };
+}
+
+void tst_QStringMultiMatcher::findAllUtf8()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(Qt::CaseSensitivity, cs);
+    QFETCH(QByteArray, haystack);
+    QFETCH(QList<qsizetype>, expected);
+
+    QStringMultiMatcher matcher(patterns, cs);
+    QCOMPARE(flatten(matcher.findAll(QByteArrayView(haystack))), expected);
+}
+
+void tst_QStringMultiMatcher::findNext()
+{
+    QStringMultiMatcher matcher({ "he", "she", "his", "hers" });
+    const QString haystack = QStringLiteral("ushers and his hens");
+
+    QList<qsizetype> found;
+    qsizetype from = 0;
+    for (;;) {
+        const QStringMultiMatcher::Match m = matcher.findNext(haystack, from);
+        if (!m.isValid())
+            break;
+        found << m.patternIndex << m.offset << m.length;
+        from = m.offset + 1;
+    }
+    QCOMPARE(found, (QList<qsizetype>{ 1, 1, 3,  0, 2, 2,  2, 11, 3,  0, 15, 2 }));
+
+    QStringMultiMatcher::Match m = matcher.findNext(haystack, -4);
+    QCOMPARE(m.patternIndex, 0);
+    QCOMPARE(m.offset, 15);
+    QVERIFY(!matcher.findNext(haystack, haystack.size()).isValid());
+    QVERIFY(!matcher.findNext(haystack, 16).isValid());
+
+    m = matcher.findNext(QByteArrayView("ushers"), 2);
+    QCOMPARE(m.patternIndex, 0);
+    QCOMPARE(m.offset, 2);
+    QCOMPARE(m.length, 2);
+}
+
+void tst_QStringMultiMatcher::setters()
+{
+    QStringMultiMatcher matcher({ "foo" });
+    QStringMultiMatcher copy = matcher;
+    QCOMPARE(matcher.findAll(u"FOO foo").size(), 1);
+
+    matcher.setCaseSensitivity(Qt::CaseInsensitive);
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(matcher.findAll(u"FOO foo").size(), 2);
+    QCOMPARE(matcher.patterns(), QStringList{ "foo" });
+
+    matcher.setPatterns({ "bar", "o" });
+    QCOMPARE(matcher.caseSensitivity(), Qt::CaseInsensitive);
+    QCOMPARE(flatten(matcher.findAll(u"FOO BAR")), (QList<qsizetype>{ 1, 1, 1,  1, 2, 1,  0, 4, 3 }));
+
+    // the copy is not affected
+    QCOMPARE(copy.caseSensitivity(), Qt::CaseSensitive);
+    QCOMPARE(copy.patterns(), QStringList{ "foo" });
+    QCOMPARE(copy.findAll(u"FOO foo").size(), 1);
+
+    copy = std::move(matcher);
+    QCOMPARE(copy.patterns(), (QStringList{ "bar", "o" }));
+}
+
+void tst_QStringMultiMatcher::largePatternSet_data()
+{
+    QTest::addColumn<int>("patternCount");
+    QTest::addColumn<int>("alphabetSize");
+
+    QTest::newRow("ascii-300") << 300 << 26;
+    // large enough that the automaton doesn't use the dense transition table
+    QTest::newRow("cjk-20000") << 20000 << 3000;
+}
+
+void tst_QStringMultiMatcher::largePatternSet()
+{
+    QFETCH(int, patternCount);
+    QFETCH(int, alphabetSize);
+
+    const char16_t base = alphabetSize <= 26 ? u'a' : char16_t(0x4e00);
+    QRandomGenerator rng(patternCount);
+    auto randomString = [&](int length) {
+        QString s(length, Qt::Uninitialized);
+        for (QChar &c : s)
+            c = QChar(char16_t(base + rng.bounded(alphabetSize)));
+        return s;
+    };
+
+    QStringList patterns;
+    for (int i = 0; i < patternCount; ++i)
+        patterns << randomString(3 + rng.bounded(6));
+    QString haystack;
+    for (int i = 0; i < 200; ++i)
+        haystack += randomString(10) + patterns.at(rng.bounded(patternCount));
+
+    QStringMultiMatcher matcher(patterns);
+    QList<QStringMultiMatcher::Match> matches = matcher.findAll(haystack);
+
+    // compare with one QStringMatcher per pattern
+    QList<std::pair<qsizetype, qsizetype>> expected;    // (offset, pattern)
+    for (qsizetype i = 0; i < patterns.size(); ++i) {
+        QStringMatcher single(patterns.at(i));
+        for (qsizetype pos = single.indexIn(haystack); pos >= 0; pos = single.indexIn(haystack, pos + 1))
+            expected.append({ pos, i });
+    }
+    QList<std::pair<qsizetype, qsizetype>> actual;
+    for (const QStringMultiMatcher::Match &m : matches) {
+        QCOMPARE(m.length, patterns.at(m.patternIndex).size());
+        actual.append({ m.offset, m.patternIndex });
+    }
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    QCOMPARE(actual.size(), expected.size());
+    QVERIFY(actual == expected);
+    QVERIFY(actual.size() >= 200);
+}
+
+QTEST_APPLESS_MAIN(tst_QStringMultiMatcher)
+#include "tst_qstringmultimatcher.moc"
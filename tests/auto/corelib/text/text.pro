@@ -20,6 +20,7 @@ SUBDIRS = \
     qstringiterator \
     qstringlist \
     qstringmatcher \
+    qstringmultimatcher \
     qstringtokenizer \
     qstringview \
     qtextboundaryfinder
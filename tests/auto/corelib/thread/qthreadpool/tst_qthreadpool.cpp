@@ -101,6 +101,8 @@ private slots:
     void stressTest();
     void takeAllAndIncreaseMaxThreadCount();
     void waitForDoneAfterTake();
+    void workStealing();
+    void workStealingBlockedParent();
 
 private:
     QMutex m_functionTestMutex;
@@ -1310,5 +1312,80 @@ void tst_QThreadPool::waitForDoneAfterTake()
 
 }
 
+
+class FanOutTask : public QRunnable
+{
+public:
+    FanOutTask(QThreadPool *pool, QAtomicInt *count, int depth)
+        : pool(pool), count(count), depth(depth)
+    {}
+
+    void run() override
+    {
+        count->ref();
+        if (depth > 0) {
+            pool->start(new FanOutTask(pool, count, depth - 1));
+            pool->start(new FanOutTask(pool, count, depth - 1));
+        }
+    }
+
+private:
+    QThreadPool *pool;
+    QAtomicInt *count;
+    int depth;
+};
+
+void tst_QThreadPool::workStealing()
+{
+    QThreadPool pool;
+    QVERIFY(!pool.isWorkStealingEnabled());
+    pool.setWorkStealingEnabled(true);
+    QVERIFY(pool.isWorkStealingEnabled());
+    pool.setMaxThreadCount(4);
+
+    // a binary tree of runnables, all but the root started from pool threads
+    const int depth = 10;
+    QAtomicInt count;
+    pool.start(new FanOutTask(&pool, &count, depth));
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(count.loadRelaxed(), (1 << (depth + 1)) - 1);
+
+    // clear() and tryTake() see the local queues, too
+    QSemaphore started;
+    QSemaphore proceed;
+    QRunnable *child = QRunnable::create([] {});
+    child->setAutoDelete(false);
+    pool.setMaxThreadCount(1);
+    pool.start([&] {
+        pool.start(child);
+        started.release();
+        proceed.acquire();
+    });
+    started.acquire();
+    QVERIFY(pool.tryTake(child));
+    proceed.release();
+    QVERIFY(pool.waitForDone(30000));
+    delete child;
+}
+
+void tst_QThreadPool::workStealingBlockedParent()
+{
+    // A runnable that blocks on one it started itself must not deadlock as
+    // long as the pool has room for another thread, just like without
+    // work stealing.
+    QThreadPool pool;
+    pool.setWorkStealingEnabled(true);
+    pool.setMaxThreadCount(2);
+
+    QSemaphore childDone;
+    bool childRan = false;
+    pool.start([&] {
+        pool.start([&] { childDone.release(); });
+        childRan = childDone.tryAcquire(1, 10000);
+    });
+    QVERIFY(pool.waitForDone(30000));
+    QVERIFY(childRan);
+}
+
 QTEST_MAIN(tst_QThreadPool);
 #include "tst_qthreadpool.moc"
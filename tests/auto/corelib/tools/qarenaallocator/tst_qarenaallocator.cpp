@@ -0,0 +1,167 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstring.h>
+#include <QtCore/qthread.h>
+#include <QtCore/private/qarenaallocator_p.h>
+
+class tst_QArenaAllocator : public QObject
+{
+    Q_OBJECT
+private slots:
+    void noScope();
+    void allocatesFromArena();
+    void escapeByCopy();
+    void escapeByMove();
+    void growInPlace();
+    void largeBlocks();
+    void nestedScopes();
+    void releaseFromOtherThread();
+};
+
+void tst_QArenaAllocator::noScope()
+{
+    QCOMPARE(QArenaScope::current(), nullptr);
+    QCOMPARE(QArenaScope::allocate(16), nullptr);
+}
+
+void tst_QArenaAllocator::allocatesFromArena()
+{
+    QArenaScope scope;
+    QCOMPARE(QArenaScope::current(), &scope);
+
+    QStringList list;
+    for (int i = 0; i < 1000; ++i)
+        list.append(QString::number(i));
+    QVERIFY(scope.blockCount() >= 1000);
+    QVERIFY(scope.chunkCount() < scope.blockCount() / 10);
+    QVERIFY(scope.bytesAllocated() > 0);
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(list.at(i), QString::number(i));
+}
+
+void tst_QArenaAllocator::escapeByCopy()
+{
+    QString escaped;
+    {
+        QArenaScope scope;
+        QString s = QStringLiteral("Hello ") + QString::number(42);
+        escaped = s;
+    }
+    QCOMPARE(QArenaScope::current(), nullptr);
+    QCOMPARE(escaped, QStringLiteral("Hello 42"));
+    // detaching after the scope ended moves the data to the heap
+    escaped.append(QLatin1String(", world"));
+    QCOMPARE(escaped, QStringLiteral("Hello 42, world"));
+}
+
+void tst_QArenaAllocator::escapeByMove()
+{
+    QList<QByteArray> escaped;
+    {
+        QArenaScope scope;
+        QList<QByteArray> list;
+        for (int i = 0; i < 100; ++i)
+            list.append(QByteArray::number(i));
+        escaped = std::move(list);
+    }
+    QCOMPARE(escaped.size(), 100);
+    for (int i = 0; i < 100; ++i)
+        QCOMPARE(escaped.at(i), QByteArray::number(i));
+    for (int i = 100; i < 1000; ++i)
+        escaped.append(QByteArray::number(i));
+    QCOMPARE(escaped.last(), QByteArray("999"));
+}
+
+void tst_QArenaAllocator::growInPlace()
+{
+    QArenaScope scope;
+    QByteArray ba;
+    for (int i = 0; i < 4096; ++i)
+        ba.append(char('a' + i % 26));
+    QCOMPARE(ba.size(), 4096);
+    QCOMPARE(ba.at(4095), char('a' + 4095 % 26));
+    // the array was the most recent allocation, so it grew in place
+    QCOMPARE(scope.blockCount(), 1);
+    QVERIFY(scope.bytesAllocated() < 2 * 4096);
+}
+
+void tst_QArenaAllocator::largeBlocks()
+{
+    QArenaScope scope(4096);
+    QByteArray small(16, 'x');
+    const qsizetype chunks = scope.chunkCount();
+    QByteArray large(100000, 'y');
+    QCOMPARE(scope.chunkCount(), chunks + 1);
+    QByteArray small2(16, 'z');
+    // the large block did not replace the chunk used for small ones
+    QCOMPARE(scope.chunkCount(), chunks + 1);
+    QCOMPARE(large.count('y'), 100000);
+    QCOMPARE(small, QByteArray(16, 'x'));
+}
+
+void tst_QArenaAllocator::nestedScopes()
+{
+    QArenaScope outer;
+    QString a = QString::number(1);
+    const qsizetype outerBlocks = outer.blockCount();
+    {
+        QArenaScope inner;
+        QCOMPARE(QArenaScope::current(), &inner);
+        QString b = QString::number(2);
+        QCOMPARE(inner.blockCount(), 1);
+        QCOMPARE(outer.blockCount(), outerBlocks);
+        a += b;
+    }
+    QCOMPARE(QArenaScope::current(), &outer);
+    QCOMPARE(a, QStringLiteral("12"));
+}
+
+void tst_QArenaAllocator::releaseFromOtherThread()
+{
+    QList<QString> list;
+    {
+        QArenaScope scope;
+        for (int i = 0; i < 1000; ++i)
+            list.append(QString::number(i));
+    }
+    QScopedPointer<QThread> thread(QThread::create([l = std::move(list)]() mutable {
+        QCOMPARE(l.size(), 1000);
+        QCOMPARE(l.last(), QStringLiteral("999"));
+        l.clear();
+    }));
+    thread->start();
+    QVERIFY(thread->wait());
+}
+
+QTEST_APPLESS_MAIN(tst_QArenaAllocator)
+#include "tst_qarenaallocator.moc"
@@ -30,6 +30,7 @@
 #include <QtCore/QCoreApplication>
 #include <QtTest/QtTest>
 #include <QtCore/QMetaEnum>
+#include <QtCore/QTemporaryFile>
 
 Q_DECLARE_METATYPE(QCryptographicHash::Algorithm)
 
@@ -46,6 +47,14 @@ private slots:
     void sha3();
     void blake2_data();
     void blake2();
+    void blake3_data();
+    void blake3();
+    void shaBlocks_data();
+    void shaBlocks();
+    void hashMany_data();
+    void hashMany();
+    void hashFile_data();
+    void hashFile();
     void files_data();
     void files();
     void hashLength();
@@ -358,6 +367,16 @@ void tst_QCryptographicHash::blake2_data()
         "95bca6e1b761dca1323505cc629949a0e03edf11633cc7935bd8b56f393afcf2");
 
 #undef ROW
+
+    // several blocks
+    QByteArray counting(1000, Qt::Uninitialized);
+    for (int i = 0; i < counting.size(); ++i)
+        counting[i] = char(i % 251);
+    QTest::newRow("blake2b_512_counting") << QCryptographicHash::Blake2b_512 << counting
+        << QByteArray::fromHex("c11e1c0340bd7e5a1b275f1230c962fad215ecb1391486e74e31b960a2f29963"
+                               "81a5fad092da06841d5f26e38f6ecfeaf441acbcd1c2de61aef121e7927175f5");
+    QTest::newRow("blake2s_256_counting") << QCryptographicHash::Blake2s_256 << counting
+        << QByteArray::fromHex("1c067a5e746fb0f6734efac9a8cdb0e11061f0077f255184365c690115392501");
 }
 
 void tst_QCryptographicHash::blake2()
@@ -370,6 +389,198 @@ void tst_QCryptographicHash::blake2()
     QCOMPARE(result, expectedResult);
 }
 
+static QByteArray countingBytes(int length)
+{
+    // the input of the official BLAKE3 test vectors
+    QByteArray data(length, Qt::Uninitialized);
+    for (int i = 0; i < length; ++i)
+        data[i] = char(i % 251);
+    return data;
+}
+
+void tst_QCryptographicHash::blake3_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray>("expectedResult");
+
+    QTest::newRow("pangram") << QByteArrayLiteral("The quick brown fox jumps over the lazy dog")
+        << QByteArray::fromHex("2f1514181aadccd913abd94cfa592701a5686ab23f8df1dff1b74710febc6d4a");
+
+    // lengths around chunk (1 KiB) and tree boundaries
+    const struct {
+        int length;
+        const char *hash;
+    } vectors[] = {
+        { 0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262" },
+        { 1, "2d3adedff11b61f14c886e35afa036736dcd87a74d27b5c1510225d0f592e213" },
+        { 1023, "10108970eeda3eb932baac1428c7a2163b0e924c9a9e25b35bba72b28f70bd11" },
+        { 1024, "42214739f095a406f3fc83deb889744ac00df831c10daa55189b5d121c855af7" },
+        { 1025, "d00278ae47eb27b34faecf67b4fe263f82d5412916c1ffd97c8cb7fb814b8444" },
+        { 2048, "e776b6028c7cd22a4d0ba182a8bf62205d2ef576467e838ed6f2529b85fba24a" },
+        { 2049, "5f4d72f40d7a5f82b15ca2b2e44b1de3c2ef86c426c95c1af0b6879522563030" },
+        { 3072, "b98cb0ff3623be03326b373de6b9095218513e64f1ee2edd2525c7ad1e5cffd2" },
+        { 3073, "7124b49501012f81cc7f11ca069ec9226cecb8a2c850cfe644e327d22d3e1cd3" },
+        { 4096, "015094013f57a5277b59d8475c0501042c0b642e531b0a1c8f58d2163229e969" },
+        { 4097, "9b4052b38f1c5fc8b1f9ff7ac7b27cd242487b3d890d15c96a1c25b8aa0fb995" },
+        { 8192, "aae792484c8efe4f19e2ca7d371d8c467ffb10748d8a5a1ae579948f718a2a63" },
+        { 8193, "bab6c09cb8ce8cf459261398d2e7aef35700bf488116ceb94a36d0f5f1b7bc3b" },
+        { 16384, "f875d6646de28985646f34ee13be9a576fd515f76b5b0a26bb324735041ddde4" },
+        { 31744, "62b6960e1a44bcc1eb1a611a8d6235b6b4b78f32e7abc4fb4c6cdcce94895c47" },
+        { 102400, "bc3e3d41a1146b069abffad3c0d44860cf664390afce4d9661f7902e7943e085" },
+    };
+    for (const auto &vector : vectors) {
+        QTest::addRow("counting_%d", vector.length) << countingBytes(vector.length)
+                                                    << QByteArray::fromHex(vector.hash);
+    }
+}
+
+void tst_QCryptographicHash::blake3()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray, expectedResult);
+
+    QCOMPARE(QCryptographicHash::hash(data, QCryptographicHash::Blake3_256), expectedResult);
+
+    // the result must not depend on how the input is split
+    for (int step : { 1, 63, 1000, 4097 }) {
+        QCryptographicHash hash(QCryptographicHash::Blake3_256);
+        for (int i = 0; i < data.size(); i += step)
+            hash.addData(data.constData() + i, qMin(step, data.size() - i));
+        QCOMPARE(hash.result(), expectedResult);
+    }
+}
+
+void tst_QCryptographicHash::shaBlocks_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("length");
+    QTest::addColumn<QByteArray>("expectedResult");
+
+    // lengths around the padding boundary and spanning many blocks, so that
+    // both the hardware and the portable block functions see partial blocks
+    QTest::newRow("sha1_55") << QCryptographicHash::Sha1 << 55
+        << QByteArray::fromHex("8ae2d46729cfe68ff927af5eec9c7d1b66d65ac2");
+    QTest::newRow("sha224_55") << QCryptographicHash::Sha224 << 55
+        << QByteArray::fromHex("8991dfba74284e04dc7581c7c3e4068ff6cb7a63733361429834bb56");
+    QTest::newRow("sha256_55") << QCryptographicHash::Sha256 << 55
+        << QByteArray::fromHex("463eb28e72f82e0a96c0a4cc53690c571281131f672aa229e0d45ae59b598b59");
+    QTest::newRow("sha1_56") << QCryptographicHash::Sha1 << 56
+        << QByteArray::fromHex("636e2ec698dac903498e648bd2f3af641d3c88cb");
+    QTest::newRow("sha224_56") << QCryptographicHash::Sha224 << 56
+        << QByteArray::fromHex("2b2cd637c16ad7290bb067ad7d8fd04e204fa43a84366afc7130f4ef");
+    QTest::newRow("sha256_56") << QCryptographicHash::Sha256 << 56
+        << QByteArray::fromHex("da2ae4d6b36748f2a318f23e7ab1dfdf45acdc9d049bd80e59de82a60895f562");
+    QTest::newRow("sha1_64") << QCryptographicHash::Sha1 << 64
+        << QByteArray::fromHex("c6138d514ffa2135bfce0ed0b8fac65669917ec7");
+    QTest::newRow("sha224_64") << QCryptographicHash::Sha224 << 64
+        << QByteArray::fromHex("c37b88a3522dbf7ac30d1c68ea397ac11d4773571aed01ddab73531e");
+    QTest::newRow("sha256_64") << QCryptographicHash::Sha256 << 64
+        << QByteArray::fromHex("fdeab9acf3710362bd2658cdc9a29e8f9c757fcf9811603a8c447cd1d9151108");
+    QTest::newRow("sha1_65") << QCryptographicHash::Sha1 << 65
+        << QByteArray::fromHex("69bd728ad6e13cd76ff19751fde427b00e395746");
+    QTest::newRow("sha224_65") << QCryptographicHash::Sha224 << 65
+        << QByteArray::fromHex("114b5fd665736a96585c5d5837d35250aed73c725252cbf7f8b121f6");
+    QTest::newRow("sha256_65") << QCryptographicHash::Sha256 << 65
+        << QByteArray::fromHex("4bfd2c8b6f1eec7a2afeb48b934ee4b2694182027e6d0fc075074f2fabb31781");
+    QTest::newRow("sha1_1000") << QCryptographicHash::Sha1 << 1000
+        << QByteArray::fromHex("c9c960a0b925474fab83942cc27d504fc24ac37b");
+    QTest::newRow("sha224_1000") << QCryptographicHash::Sha224 << 1000
+        << QByteArray::fromHex("c182669a7f6629dc7fd8a9198f15af15adbbaeffa1842e854f681357");
+    QTest::newRow("sha256_1000") << QCryptographicHash::Sha256 << 1000
+        << QByteArray::fromHex("4e4c294b331f7a2099a379bec34b9f9fc03dc46ab465d998f4d683da53487e6d");
+    QTest::newRow("sha1_4113") << QCryptographicHash::Sha1 << 4113
+        << QByteArray::fromHex("3d15084b2da07627880f8c35530fafd8697dd724");
+    QTest::newRow("sha224_4113") << QCryptographicHash::Sha224 << 4113
+        << QByteArray::fromHex("dd5299994701800fb3ad2e58365f7da4f5c980cca7165283abc7f457");
+    QTest::newRow("sha256_4113") << QCryptographicHash::Sha256 << 4113
+        << QByteArray::fromHex("d855ba636ffdfea364522538421fa585c1927fe5ef4d8065b89549c6bf744213");
+}
+
+void tst_QCryptographicHash::shaBlocks()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, length);
+    QFETCH(QByteArray, expectedResult);
+
+    const QByteArray data = countingBytes(length);
+    QCOMPARE(QCryptographicHash::hash(data, algorithm), expectedResult);
+
+    for (int step : { 1, 63, 65, 1000 }) {
+        QCryptographicHash hash(algorithm);
+        for (int i = 0; i < data.size(); i += step)
+            hash.addData(data.constData() + i, qMin(step, data.size() - i));
+        QCOMPARE(hash.result(), expectedResult);
+    }
+}
+
+void tst_QCryptographicHash::hashMany_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+
+    QTest::newRow("md5") << QCryptographicHash::Md5;
+    QTest::newRow("sha1") << QCryptographicHash::Sha1;
+    QTest::newRow("sha224") << QCryptographicHash::Sha224;
+    QTest::newRow("sha256") << QCryptographicHash::Sha256;
+    QTest::newRow("blake3") << QCryptographicHash::Blake3_256;
+}
+
+void tst_QCryptographicHash::hashMany()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+
+    QVERIFY(QCryptographicHash::hashMany({}, algorithm).isEmpty());
+
+    // more messages than the multi-buffer width, of differing lengths, so
+    // that lanes finish at different times
+    const QByteArray data = countingBytes(3000);
+    QList<QByteArrayView> messages;
+    for (int length : { 0, 1, 55, 56, 63, 64, 65, 119, 120, 128, 500, 3000, 17, 2999, 64, 0, 1000 })
+        messages.append(QByteArrayView(data.constData(), length));
+
+    const QByteArrayList results = QCryptographicHash::hashMany(messages, algorithm);
+    QCOMPARE(results.size(), messages.size());
+    for (int i = 0; i < messages.size(); ++i) {
+        QCOMPARE(results.at(i),
+                 QCryptographicHash::hash(messages.at(i).toByteArray(), algorithm));
+    }
+}
+
+void tst_QCryptographicHash::hashFile_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("start");
+
+    // large enough for BLAKE3 to hash in parallel
+    const int large = 5 * 1024 * 1024 + 123;
+    QTest::newRow("blake3_empty") << QCryptographicHash::Blake3_256 << 0 << 0;
+    QTest::newRow("blake3_small") << QCryptographicHash::Blake3_256 << 5000 << 0;
+    QTest::newRow("blake3_large") << QCryptographicHash::Blake3_256 << large << 0;
+    QTest::newRow("blake3_large_offset") << QCryptographicHash::Blake3_256 << large << 777;
+    QTest::newRow("sha256_large") << QCryptographicHash::Sha256 << large << 0;
+    QTest::newRow("blake2b_offset") << QCryptographicHash::Blake2b_512 << 100000 << 4096;
+}
+
+void tst_QCryptographicHash::hashFile()
+{
+    QFETCH(QCryptographicHash::Algorithm, algorithm);
+    QFETCH(int, size);
+    QFETCH(int, start);
+
+    const QByteArray data = countingBytes(size);
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), qint64(size));
+    QVERIFY(file.seek(start));
+
+    QCOMPARE(QCryptographicHash::hashFile(&file, algorithm),
+             QCryptographicHash::hash(data.mid(start), algorithm));
+    QVERIFY(file.atEnd());
+
+    file.close();
+    QVERIFY(QCryptographicHash::hashFile(&file, algorithm).isEmpty());
+}
+
 void tst_QCryptographicHash::files_data() {
     QTest::addColumn<QString>("filename");
     QTest::addColumn<QCryptographicHash::Algorithm>("algorithm");
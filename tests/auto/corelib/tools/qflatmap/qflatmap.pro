@@ -1,4 +1,4 @@
 CONFIG += testcase
 TARGET = tst_qflatmap
-QT = core-private testlib
+QT = testlib
 SOURCES = tst_qflatmap.cpp
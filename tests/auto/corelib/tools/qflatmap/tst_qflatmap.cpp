@@ -28,7 +28,7 @@
 
 #include <QtTest/QtTest>
 
-#include <private/qflatmap_p.h>
+#include <qflatmap.h>
 #include <qbytearray.h>
 #include <qstring.h>
 #include <qstringview.h>
@@ -36,6 +36,7 @@
 
 #include <algorithm>
 #include <list>
+#include <numeric>
 #include <tuple>
 
 class tst_QFlatMap : public QObject
@@ -50,6 +51,10 @@ private slots:
     void iterators();
     void statefulComparator();
     void transparency();
+    void heterogeneousLookup();
+    void bulkConstruction();
+    void rangeInsertion();
+    void flatSet();
     void viewIterators();
     void varLengthArray();
 };
@@ -388,6 +393,97 @@ void tst_QFlatMap::transparency()
     QCOMPARE(m.lower_bound(sv3).value(), "dree");
 }
 
+void tst_QFlatMap::heterogeneousLookup()
+{
+    using Map = QFlatMap<QString, int, QFlatMapStringLess>;
+    const Map m{ { "one", 1 }, { "two", 2 }, { "three", 3 } };
+
+    const QString numbers = "one two three four";
+    QVERIFY(m.contains(QStringView(numbers).left(3)));
+    QCOMPARE(m.value(QStringView(numbers).mid(4, 3)), 2);
+    QCOMPARE(m.find(QStringView(numbers).mid(8, 5)).value(), 3);
+    QVERIFY(!m.contains(QStringView(numbers).mid(14)));
+    QCOMPARE(m.find(QStringView(numbers).mid(14)), m.end());
+
+    QVERIFY(m.contains(QLatin1String("three")));
+    QCOMPARE(m.value(QLatin1String("one")), 1);
+    QCOMPARE(m.value(QLatin1String("four"), -1), -1);
+    QCOMPARE(m.lower_bound(QLatin1String("p")).key(), QString("three"));
+}
+
+void tst_QFlatMap::bulkConstruction()
+{
+    using Map = QFlatMap<int, int>;
+    QList<int> keys;
+    QList<int> values;
+    for (int i = 0; i < 1000; ++i) {
+        keys.append((i * 7919) % 500);
+        values.append(i);
+    }
+    const Map m(keys, values);
+    QCOMPARE(m.size(), Map::size_type(500));
+    QVERIFY(std::is_sorted(m.keys().begin(), m.keys().end()));
+    // the last occurrence of a key wins
+    for (int i = 500; i < 1000; ++i)
+        QCOMPARE(m.value((i * 7919) % 500), i);
+
+    // already ordered input is taken as is
+    QList<int> ordered(1000);
+    std::iota(ordered.begin(), ordered.end(), 0);
+    const Map m2(ordered, ordered);
+    QCOMPARE(m2.size(), Map::size_type(1000));
+    QCOMPARE(m2.keys(), ordered);
+}
+
+void tst_QFlatMap::rangeInsertion()
+{
+    using Map = QFlatMap<int, QByteArray>;
+    Map m{ { 1, "one" }, { 3, "three" }, { 5, "five" } };
+    const std::vector<Map::value_type> items = {
+        { 4, "four" }, { 0, "zero" }, { 3, "THREE" }, { 2, "two" }, { 4, "FOUR" }
+    };
+    m.insert(items.begin(), items.end());
+    QCOMPARE(m.size(), Map::size_type(6));
+    QCOMPARE(m.keys(), QList<int>({ 0, 1, 2, 3, 4, 5 }));
+    QCOMPARE(m.value(3), "THREE");
+    QCOMPARE(m.value(4), "FOUR");
+    QCOMPARE(m.value(5), "five");
+
+    m.insert(Qt::OrderedUniqueRange, items.begin() + 1, items.begin() + 2);
+    QCOMPARE(m.value(0), "zero");
+    QCOMPARE(m.size(), Map::size_type(6));
+}
+
+void tst_QFlatMap::flatSet()
+{
+    using Set = QFlatSet<QString, QFlatMapStringLess>;
+    Set s{ "to", "en", "tre", "en" };
+    QCOMPARE(s.size(), Set::size_type(3));
+    QCOMPARE(s.values(), QStringList({ "en", "to", "tre" }));
+    QVERIFY(s.contains(QLatin1String("to")));
+    QVERIFY(s.contains(QStringView(u"tre")));
+    QVERIFY(!s.contains(QLatin1String("fire")));
+
+    auto r = s.insert("fire");
+    QVERIFY(r.second);
+    QCOMPARE(*r.first, "fire");
+    r = s.insert("en");
+    QVERIFY(!r.second);
+    QCOMPARE(*r.first, "en");
+
+    const QStringList more = { "seks", "fem", "to" };
+    s.insert(more.begin(), more.end());
+    QCOMPARE(s.values(), QStringList({ "en", "fem", "fire", "seks", "to", "tre" }));
+
+    QVERIFY(s.remove("to"));
+    QVERIFY(!s.remove("to"));
+    QCOMPARE(s.size(), Set::size_type(5));
+    QCOMPARE(*s.erase(s.find(QLatin1String("fire"))), "seks");
+
+    const Set copy = s;
+    QCOMPARE(copy.values(), s.values());
+}
+
 void tst_QFlatMap::viewIterators()
 {
     using Map = QFlatMap<QByteArray, QByteArray>;
@@ -32,6 +32,7 @@
 #include <qmap.h>
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 class tst_QHash : public QObject
@@ -73,6 +74,7 @@ private slots:
     void emplace();
 
     void badHashFunction();
+    void controlBytes();
 };
 
 struct IdentityTracker {
@@ -1754,5 +1756,104 @@ void tst_QHash::badHashFunction()
 
 }
 
+// Keys that pile up on purpose: even ones start probing at the first bucket, odd
+// ones at the last one (and wrap around), and keys 16 apart share a control byte.
+struct ProbeKey {
+    int k;
+    ProbeKey(int i) : k(i) {}
+    bool operator==(const ProbeKey &other) const
+    {
+        return k == other.k;
+    }
+};
+
+size_t qHash(ProbeKey key, size_t)
+{
+    const size_t bucket = (key.k & 1) ? (~size_t(0) >> 7) : 0;
+    return bucket | (size_t(key.k & 15) << (std::numeric_limits<size_t>::digits - 7));
+}
+
+static bool matchesModel(const QHash<ProbeKey, int> &hash, const QMap<int, int> &model, int maxKey)
+{
+    if (hash.size() != model.size())
+        return false;
+    int visited = 0;
+    for (auto it = hash.cbegin(); it != hash.cend(); ++it, ++visited) {
+        if (model.value(it.key().k, -1) != it.value())
+            return false;
+    }
+    if (visited != model.size())
+        return false;
+    for (int i = 0; i < maxKey; ++i) {
+        const auto it = hash.constFind(i);
+        if (model.contains(i) ? (it == hash.cend() || it.value() != model.value(i)) : it != hash.cend())
+            return false;
+    }
+    return true;
+}
+
+void tst_QHash::controlBytes()
+{
+    // the two clusters span several groups of control bytes and spans, and
+    // meet where the odd one wraps around the end of the table
+    const int count = 300;
+    QHash<ProbeKey, int> hash;
+    QMap<int, int> model;
+    for (int i = 0; i < count; ++i) {
+        hash.insert(i, i);
+        model.insert(i, i);
+    }
+    QVERIFY(matchesModel(hash, model, 2 * count));
+
+    // erasing shifts the following entries and their control bytes back,
+    // possibly across a group or span boundary
+    for (int i = 0; i < count; i += 3) {
+        QVERIFY(hash.remove(i));
+        model.remove(i);
+    }
+    QVERIFY(matchesModel(hash, model, 2 * count));
+
+    for (int i = 0; i < count; i += 3) {
+        hash.insert(i, -i);
+        model.insert(i, -i);
+    }
+    QVERIFY(matchesModel(hash, model, 2 * count));
+
+    // empty whole groups in the middle of the clusters, then refill them
+    for (int i = 100; i < 140; ++i) {
+        QVERIFY(hash.remove(i));
+        model.remove(i);
+    }
+    QVERIFY(matchesModel(hash, model, 2 * count));
+    for (int i = count; i < count + 40; ++i) {
+        hash.insert(i, i);
+        model.insert(i, i);
+    }
+    QVERIFY(matchesModel(hash, model, 2 * count));
+
+    // rehashing recomputes the positions and carries the control bytes over
+    hash.reserve(4 * count);
+    QVERIFY(matchesModel(hash, model, 2 * count));
+    hash.squeeze();
+    QVERIFY(matchesModel(hash, model, 2 * count));
+
+    // so does detaching
+    QHash<ProbeKey, int> copy = hash;
+    copy.insert(2 * count, 0);
+    QVERIFY(matchesModel(hash, model, 2 * count + 1));
+    model.insert(2 * count, 0);
+    QVERIFY(matchesModel(copy, model, 2 * count + 1));
+
+    // erase everything through iterators, which shifts entries into the
+    // buckets being visited
+    auto it = copy.begin();
+    while (it != copy.end()) {
+        model.remove(it.key().k);
+        it = copy.erase(it);
+    }
+    QVERIFY(model.isEmpty());
+    QVERIFY(matchesModel(copy, model, 2 * count + 1));
+}
+
 QTEST_APPLESS_MAIN(tst_QHash)
 #include "tst_qhash.moc"
@@ -38,6 +38,8 @@ private slots:
     void result();
     void result_incremental_data();
     void result_incremental();
+    void differentKeys_data();
+    void differentKeys();
 };
 
 Q_DECLARE_METATYPE(QCryptographicHash::Algorithm)
@@ -76,6 +78,18 @@ void tst_QMessageAuthenticationCode::result_data()
                             << QByteArray("key")
                             << QByteArray("The quick brown fox jumps over the lazy dog")
                             << QByteArray::fromHex("f7bc83f430538424b13298e6aa6fb143ef4d59a14946175997479dbc2d1a3cd8");
+    QTest::newRow("blake3") << QCryptographicHash::Blake3_256
+                            << QByteArray("key1")
+                            << QByteArray("The quick brown fox jumps over the lazy dog")
+                            << QByteArray::fromHex("78a1ecdf82d661ef8b551036a3fb7930221c1e7ad4e343f18be3de5a8cc71b7f");
+    QTest::newRow("blake3-other-key") << QCryptographicHash::Blake3_256
+                                      << QByteArray("key2")
+                                      << QByteArray("The quick brown fox jumps over the lazy dog")
+                                      << QByteArray::fromHex("30507542fda7e74d4ebfba4f9cd4abcdf8068b5e0081cc433cf5221594af2903");
+    QTest::newRow("blake3-long-key") << QCryptographicHash::Blake3_256
+                                     << QByteArray(100, 'k')
+                                     << QByteArray("message")
+                                     << QByteArray::fromHex("695f381713419daf73cabf1ad7e96163df36025788978596d9605198181f3974");
 
     // Some from rfc-2104
     QTest::newRow("rfc-md5-1") << QCryptographicHash::Md5
@@ -134,5 +148,27 @@ void tst_QMessageAuthenticationCode::result_incremental()
     QCOMPARE(result, code);
 }
 
+void tst_QMessageAuthenticationCode::differentKeys_data()
+{
+    QTest::addColumn<QCryptographicHash::Algorithm>("algo");
+
+    const QMetaEnum algorithms = QMetaEnum::fromType<QCryptographicHash::Algorithm>();
+    for (int i = 0; i < algorithms.keyCount(); ++i)
+        QTest::newRow(algorithms.key(i)) << QCryptographicHash::Algorithm(algorithms.value(i));
+}
+
+// a MAC that ignores its key is just a hash
+void tst_QMessageAuthenticationCode::differentKeys()
+{
+    QFETCH(QCryptographicHash::Algorithm, algo);
+
+    const QByteArray message("The quick brown fox jumps over the lazy dog");
+    const QByteArray first = QMessageAuthenticationCode::hash(message, "key1", algo);
+    const QByteArray second = QMessageAuthenticationCode::hash(message, "key2", algo);
+    QCOMPARE(int(first.size()), QCryptographicHash::hashLength(algo));
+    QVERIFY(first != second);
+    QVERIFY(first != QCryptographicHash::hash(message, algo));
+}
+
 QTEST_MAIN(tst_QMessageAuthenticationCode)
 #include "tst_qmessageauthenticationcode.moc"
@@ -3,6 +3,7 @@ SUBDIRS=\
     collections \
     containerapisymmetry \
     qalgorithms \
+    qarenaallocator \
     qarraydata \
     qbitarray \
     qcache \
@@ -32,7 +32,10 @@
 #include <qcoreapplication.h>
 #include <qdatastream.h>
 #include <qhostaddress.h>
+#include <qdeadlinetimer.h>
 #include <qelapsedtimer.h>
+#include <qscopeguard.h>
+#include <qvarlengtharray.h>
 
 #ifdef Q_OS_UNIX
 #include <unistd.h>
@@ -64,6 +67,8 @@ private slots:
     void simpleConnectToIMAP();
     void udpLoopbackTest();
     void udpIPv6LoopbackTest();
+    void udpDatagramBatches_data();
+    void udpDatagramBatches();
     void broadcastTest();
     void serverTest();
     void udpLoopbackPerformance();
@@ -218,6 +223,89 @@ void tst_PlatformSocketEngine::udpLoopbackTest()
     QVERIFY(header.senderPort != 0);
 }
 
+//---------------------------------------------------------------------------
+void tst_PlatformSocketEngine::udpDatagramBatches_data()
+{
+    QTest::addColumn<bool>("batched");
+
+    // with recvmmsg()/sendmmsg() where the engine reimplements them
+    QTest::newRow("batched") << true;
+    QTest::newRow("one-by-one") << false;
+}
+
+void tst_PlatformSocketEngine::udpDatagramBatches()
+{
+    QFETCH(bool, batched);
+    enum { DatagramCount = 10, HopLimit = 9, TruncatedSize = 40 };
+
+    PLATFORMSOCKETENGINE receiver;
+    QVERIFY(receiver.initialize(QAbstractSocket::UdpSocket));
+    QVERIFY(receiver.bind(QHostAddress::LocalHost, 0));
+    PLATFORMSOCKETENGINE sender;
+    QVERIFY(sender.initialize(QAbstractSocket::UdpSocket));
+    QVERIFY(sender.bind(QHostAddress::LocalHost, 0));
+
+    const auto readDatagrams = [&](QList<QNetworkDatagramPrivate *> *datagrams,
+                                   qint64 maxCount, qint64 maxSize) {
+        return batched ? receiver.readDatagrams(datagrams, maxCount, maxSize,
+                                                QAbstractSocketEngine::WantAll)
+                       : receiver.QAbstractSocketEngine::readDatagrams(datagrams, maxCount, maxSize,
+                                                                       QAbstractSocketEngine::WantAll);
+    };
+
+    // the first datagram is read with readDatagram(), for comparison
+    QList<QNetworkDatagramPrivate> outgoing;
+    for (int i = 0; i <= DatagramCount; ++i) {
+        outgoing.append(QNetworkDatagramPrivate(QByteArray(20 * (i + 1), char('a' + i)),
+                                                QHostAddress::LocalHost, receiver.localPort()));
+        outgoing.last().header.hopLimit = HopLimit;
+    }
+    QVarLengthArray<const QNetworkDatagramPrivate *, 16> pointers;
+    for (const QNetworkDatagramPrivate &datagram : qAsConst(outgoing))
+        pointers.append(&datagram);
+    const qint64 sent = batched ? sender.writeDatagrams(pointers.constData(), pointers.size())
+                                : sender.QAbstractSocketEngine::writeDatagrams(pointers.constData(),
+                                                                               pointers.size());
+    QCOMPARE(sent, qint64(pointers.size()));
+
+    QVERIFY(receiver.waitForRead());
+    QIpPacketHeader reference;
+    QByteArray first(1000, Qt::Uninitialized);
+    QCOMPARE(receiver.readDatagram(first.data(), first.size(), &reference,
+                                   QAbstractSocketEngine::WantAll),
+             qint64(outgoing.first().data.size()));
+
+    // more than pending, the last ones truncated
+    QList<QNetworkDatagramPrivate *> received;
+    const auto cleanup = qScopeGuard([&received] { qDeleteAll(received); });
+    QCOMPARE(readDatagrams(&received, 3, -1), qint64(3));
+    QDeadlineTimer deadline(5000);
+    while (received.size() < DatagramCount && !deadline.hasExpired()) {
+        const qint64 count = readDatagrams(&received, 2 * DatagramCount, TruncatedSize);
+        QVERIFY(count >= 0);
+        if (received.size() < DatagramCount)
+            receiver.waitForRead(100);
+    }
+    QCOMPARE(received.size(), int(DatagramCount));
+    QCOMPARE(readDatagrams(&received, DatagramCount, -1), qint64(0));
+
+    for (int i = 0; i < DatagramCount; ++i) {
+        const QNetworkDatagramPrivate *datagram = received.at(i);
+        const QByteArray payload = outgoing.at(i + 1).data;
+        QCOMPARE(datagram->data, i < 3 ? payload : payload.left(TruncatedSize));
+        QCOMPARE(datagram->header.senderAddress, QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(datagram->header.senderPort, sender.localPort());
+        QCOMPARE(datagram->header.destinationAddress, reference.destinationAddress);
+        QCOMPARE(datagram->header.destinationPort, reference.destinationPort);
+        QCOMPARE(datagram->header.ifindex, reference.ifindex);
+        QCOMPARE(datagram->header.hopLimit, reference.hopLimit);
+#ifdef Q_OS_LINUX
+        QCOMPARE(datagram->header.destinationPort, receiver.localPort());
+        QCOMPARE(datagram->header.hopLimit, int(HopLimit));
+#endif
+    }
+}
+
 //---------------------------------------------------------------------------
 void tst_PlatformSocketEngine::udpIPv6LoopbackTest()
 {
@@ -99,6 +99,9 @@ private slots:
     void outOfProcessConnectedClientServerTest();
     void outOfProcessUnconnectedClientServerTest();
     void zeroLengthDatagram();
+    void receiveDatagrams_data();
+    void receiveDatagrams();
+    void writeDatagrams();
     void multicastTtlOption_data();
     void multicastTtlOption();
     void multicastLoopbackOption_data();
@@ -1253,6 +1256,138 @@ void tst_QUdpSocket::zeroLengthDatagram()
     QCOMPARE(receiver.readDatagram(&buf, 1), qint64(0));
 }
 
+// Receives datagrams with receiveDatagrams() until \a count have arrived or
+// the time runs out.
+static QList<QNetworkDatagram> collectDatagrams(QUdpSocket &socket, int count,
+                                                qsizetype maxCount, qint64 maxSize = -1)
+{
+    QList<QNetworkDatagram> result;
+    QDeadlineTimer deadline(5000);
+    while (result.size() < count) {
+        const QList<QNetworkDatagram> batch = socket.receiveDatagrams(maxCount, maxSize);
+        if (batch.size() > maxCount)
+            return QList<QNetworkDatagram>();
+        result += batch;
+        if (result.size() < count && (deadline.hasExpired() || !socket.waitForReadyRead(100)))
+            break;
+    }
+    return result;
+}
+
+void tst_QUdpSocket::receiveDatagrams_data()
+{
+    QTest::addColumn<int>("maxCount");
+    QTest::addColumn<int>("maxSize");
+
+    // on Linux, receiveDatagrams() reads them with recvmmsg(); see
+    // tst_PlatformSocketEngine for the one-by-one fallback
+    QTest::newRow("more-than-pending") << 64 << -1;
+    QTest::newRow("fewer-than-pending") << 2 << -1;
+    QTest::newRow("one-at-a-time") << 1 << -1;
+    QTest::newRow("truncated") << 64 << 150;
+}
+
+void tst_QUdpSocket::receiveDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    QFETCH(int, maxCount);
+    QFETCH(int, maxSize);
+    enum { DatagramCount = 5, HopLimit = 17 };
+
+    QUdpSocket receiver;
+    QVERIFY2(receiver.bind(QHostAddress::LocalHost, 0), qPrintable(receiver.errorString()));
+    QUdpSocket sender;
+    QVERIFY2(sender.bind(QHostAddress::LocalHost, 0), qPrintable(sender.errorString()));
+
+    QVERIFY(receiver.receiveDatagrams(maxCount).isEmpty());
+    QVERIFY(receiver.receiveDatagrams(0).isEmpty());
+
+    // the first datagram is read with receiveDatagram(), for comparison
+    QList<QByteArray> payloads;
+    for (int i = 0; i <= DatagramCount; ++i) {
+        payloads << QByteArray(100 * (i + 1), char('a' + i));
+        QNetworkDatagram datagram(payloads.last(), QHostAddress::LocalHost, receiver.localPort());
+        datagram.setHopLimit(HopLimit);
+        QCOMPARE(sender.writeDatagram(datagram), qint64(payloads.last().size()));
+    }
+
+    QVERIFY2(receiver.waitForReadyRead(5000), QtNetworkSettings::msgSocketError(receiver).constData());
+    const QNetworkDatagram reference = receiver.receiveDatagram();
+    QCOMPARE(reference.data(), payloads.takeFirst());
+
+    const QList<QNetworkDatagram> datagrams = collectDatagrams(receiver, DatagramCount,
+                                                                 maxCount, maxSize);
+    QCOMPARE(datagrams.size(), int(DatagramCount));
+    for (int i = 0; i < DatagramCount; ++i) {
+        const QNetworkDatagram &datagram = datagrams.at(i);
+        QVERIFY(datagram.isValid());
+        QCOMPARE(datagram.data(), maxSize < 0 ? payloads.at(i) : payloads.at(i).left(maxSize));
+        QCOMPARE(datagram.senderAddress(), QHostAddress(QHostAddress::LocalHost));
+        QCOMPARE(datagram.senderPort(), int(sender.localPort()));
+        QCOMPARE(datagram.destinationAddress(), reference.destinationAddress());
+        QCOMPARE(datagram.destinationPort(), reference.destinationPort());
+        QCOMPARE(datagram.interfaceIndex(), reference.interfaceIndex());
+        QCOMPARE(datagram.hopLimit(), reference.hopLimit());
+#ifdef Q_OS_LINUX
+        QCOMPARE(datagram.destinationPort(), int(receiver.localPort()));
+        QCOMPARE(datagram.hopLimit(), int(HopLimit));
+#endif
+    }
+
+    QVERIFY(!receiver.hasPendingDatagrams());
+    QVERIFY(receiver.receiveDatagrams(maxCount).isEmpty());
+}
+
+void tst_QUdpSocket::writeDatagrams()
+{
+    QFETCH_GLOBAL(bool, setProxy);
+    if (setProxy)
+        return;
+    enum { DatagramCount = 100 };
+
+    QUdpSocket receivers[2];
+    for (QUdpSocket &receiver : receivers)
+        QVERIFY2(receiver.bind(QHostAddress::LocalHost, 0), qPrintable(receiver.errorString()));
+    QUdpSocket sender;
+    QCOMPARE(sender.writeDatagrams(QList<QNetworkDatagram>()), qsizetype(0));
+
+    // alternating between the receivers, with a hop limit on every other pair
+    QList<QNetworkDatagram> datagrams;
+    qint64 totalSize = 0;
+    for (int i = 0; i < DatagramCount; ++i) {
+        QNetworkDatagram datagram(QByteArray::number(i).repeated(i % 7 + 1), QHostAddress::LocalHost,
+                                  receivers[i % 2].localPort());
+        if (i % 4 < 2)
+            datagram.setHopLimit(i + 1);
+        totalSize += datagram.data().size();
+        datagrams << datagram;
+    }
+
+    QSignalSpy bytesWrittenSpy(&sender, &QUdpSocket::bytesWritten);
+    QCOMPARE(sender.writeDatagrams(datagrams), qsizetype(DatagramCount));
+    QCOMPARE(bytesWrittenSpy.count(), 1);
+    QCOMPARE(bytesWrittenSpy.at(0).at(0).toLongLong(), totalSize);
+    QCOMPARE(sender.state(), QAbstractSocket::BoundState);
+
+    for (int r = 0; r < 2; ++r) {
+        const QList<QNetworkDatagram> received = collectDatagrams(receivers[r], DatagramCount / 2,
+                                                                    DatagramCount);
+        QCOMPARE(received.size(), DatagramCount / 2);
+        for (int j = 0; j < received.size(); ++j) {
+            const int i = 2 * j + r;
+            QCOMPARE(received.at(j).data(), datagrams.at(i).data());
+            QCOMPARE(received.at(j).senderPort(), int(sender.localPort()));
+#ifdef Q_OS_LINUX
+            QCOMPARE(received.at(j).destinationPort(), int(receivers[r].localPort()));
+            if (i % 4 < 2)
+                QCOMPARE(received.at(j).hopLimit(), i + 1);
+#endif
+        }
+    }
+}
+
 void tst_QUdpSocket::multicastTtlOption_data()
 {
     QTest::addColumn<QHostAddress>("bindAddress");
@@ -1,11 +1,15 @@
 TEMPLATE = subdirs
 SUBDIRS = \
+        qasyncfile \
+        qasynclogsink \
         qdir \
         qdiriterator \
         qfile \
+        qfilecopier \
         qfileinfo \
         qiodevice \
         qtemporaryfile \
         qtextstream
 
 qtConfig(process): SUBDIRS += qprocess
+qtConfig(settings): SUBDIRS += qsettings
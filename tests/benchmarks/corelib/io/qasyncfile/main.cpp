@@ -0,0 +1,177 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QAsyncFile>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThreadPool>
+
+#include <qtest.h>
+
+#include <memory>
+
+class tst_bench_QAsyncFile : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Method {
+        QFileOnThreadPool,
+        AsyncFileThreadPool,
+        AsyncFileDefault
+    };
+    Q_ENUM(Method)
+
+private slots:
+    void initTestCase();
+    void cleanup();
+
+    void smallFiles_data() { methods(); }
+    void smallFiles();
+    void largeFile_data() { methods(); }
+    void largeFile();
+
+private:
+    void methods();
+
+    QTemporaryDir dir;
+    QStringList smallFileNames;
+    QString largeFileName;
+};
+
+static const int SmallFileCount = 1000;
+static const int SmallFileSize = 4096;
+static const int LargeFileSize = 64 * 1024 * 1024;
+static const int ChunkSize = 1024 * 1024;
+
+void tst_bench_QAsyncFile::initTestCase()
+{
+    QVERIFY(dir.isValid());
+
+    const QByteArray small(SmallFileSize, 'x');
+    for (int i = 0; i < SmallFileCount; ++i) {
+        const QString name = dir.filePath(QString::number(i));
+        QFile file(name);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(small), qint64(small.size()));
+        smallFileNames.append(name);
+    }
+
+    largeFileName = dir.filePath(QStringLiteral("large"));
+    QFile file(largeFileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    const QByteArray chunk(ChunkSize, 'y');
+    for (int i = 0; i < LargeFileSize / ChunkSize; ++i)
+        QCOMPARE(file.write(chunk), qint64(chunk.size()));
+}
+
+void tst_bench_QAsyncFile::cleanup()
+{
+    qunsetenv("QT_NO_IO_URING");
+}
+
+void tst_bench_QAsyncFile::methods()
+{
+    QTest::addColumn<Method>("method");
+
+    QTest::newRow("QFile on QThreadPool") << QFileOnThreadPool;
+    QTest::newRow("QAsyncFile, thread pool") << AsyncFileThreadPool;
+    QTest::newRow("QAsyncFile, default") << AsyncFileDefault;
+}
+
+// reads many small files, all requests in flight at once
+void tst_bench_QAsyncFile::smallFiles()
+{
+    QFETCH(Method, method);
+    if (method == AsyncFileThreadPool)
+        qputenv("QT_NO_IO_URING", "1");
+
+    QList<QByteArray> contents(SmallFileCount);
+    QBENCHMARK {
+        if (method == QFileOnThreadPool) {
+            for (int i = 0; i < SmallFileCount; ++i) {
+                QThreadPool::globalInstance()->start([this, &contents, i] {
+                    QFile file(smallFileNames.at(i));
+                    if (file.open(QIODevice::ReadOnly))
+                        contents[i] = file.read(SmallFileSize);
+                });
+            }
+            QThreadPool::globalInstance()->waitForDone();
+        } else {
+            std::vector<std::unique_ptr<QAsyncFile>> files;
+            QList<QFuture<QByteArray>> reads;
+            files.reserve(SmallFileCount);
+            reads.reserve(SmallFileCount);
+            for (const QString &name : qAsConst(smallFileNames)) {
+                files.emplace_back(new QAsyncFile(name));
+                if (files.back()->open(QIODevice::ReadOnly))
+                    reads.append(files.back()->read(0, SmallFileSize));
+            }
+            for (int i = 0; i < reads.size(); ++i)
+                contents[i] = reads.at(i).result();
+        }
+    }
+    for (const QByteArray &content : qAsConst(contents))
+        QCOMPARE(content.size(), SmallFileSize);
+}
+
+// reads one large file in 1 MiB chunks
+void tst_bench_QAsyncFile::largeFile()
+{
+    QFETCH(Method, method);
+    if (method == AsyncFileThreadPool)
+        qputenv("QT_NO_IO_URING", "1");
+
+    qint64 total = 0;
+    QBENCHMARK {
+        total = 0;
+        if (method == QFileOnThreadPool) {
+            QThreadPool::globalInstance()->start([this, &total] {
+                QFile file(largeFileName);
+                if (!file.open(QIODevice::ReadOnly))
+                    return;
+                while (!file.atEnd())
+                    total += file.read(ChunkSize).size();
+            });
+            QThreadPool::globalInstance()->waitForDone();
+        } else {
+            QAsyncFile file(largeFileName);
+            QVERIFY(file.open(QIODevice::ReadOnly));
+            QList<QFuture<QByteArray>> reads;
+            for (qint64 offset = 0; offset < LargeFileSize; offset += ChunkSize)
+                reads.append(file.read(offset, ChunkSize));
+            for (const QFuture<QByteArray> &read : qAsConst(reads))
+                total += read.result().size();
+        }
+    }
+    QCOMPARE(total, qint64(LargeFileSize));
+}
+
+QTEST_MAIN(tst_bench_QAsyncFile)
+
+#include "main.moc"
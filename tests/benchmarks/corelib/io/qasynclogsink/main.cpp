@@ -0,0 +1,168 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QAsyncLogSink>
+#include <QLoggingCategory>
+#include <QMutex>
+#include <QTemporaryDir>
+#include <QThread>
+
+#include <qtest.h>
+
+#include <memory>
+
+Q_LOGGING_CATEGORY(lcBench, "qt.bench.asynclog")
+
+class tst_bench_QAsyncLogSink : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Method {
+        MessageHandler,
+        AsyncMessageHandler,
+        AsyncBinaryLog
+    };
+    Q_ENUM(Method)
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void printfMessages_data() { methods(); }
+    void printfMessages();
+    void streamedMessages_data() { methods(); }
+    void streamedMessages();
+
+private:
+    void methods();
+    template <typename Log>
+    void run(Log log);
+
+    QTemporaryDir dir;
+    QtMessageHandler oldHandler = nullptr;
+};
+
+static const int MessagesPerThread = 20000;
+
+// Stands in for the default message handler writing to a terminal: formats
+// the message and writes it out, one thread at a time.
+static QMutex outputMutex;
+static QByteArray output;
+
+static void formattingHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+{
+    const QByteArray line = qFormatLogMessage(type, context, message).toLocal8Bit();
+    const QMutexLocker locker(&outputMutex);
+    output += line;
+    output += '\n';
+    if (output.size() > 1024 * 1024)
+        output.truncate(0);
+}
+
+void tst_bench_QAsyncLogSink::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    oldHandler = qInstallMessageHandler(formattingHandler);
+}
+
+void tst_bench_QAsyncLogSink::cleanupTestCase()
+{
+    qInstallMessageHandler(oldHandler);
+}
+
+void tst_bench_QAsyncLogSink::methods()
+{
+    QTest::addColumn<Method>("method");
+    QTest::addColumn<int>("threadCount");
+
+    const int idealThreadCount = qMax(QThread::idealThreadCount(), 2);
+    for (int threadCount : { 1, idealThreadCount }) {
+        const QByteArray threads = " (" + QByteArray::number(threadCount) + " threads)";
+        QTest::newRow("message handler" + threads) << MessageHandler << threadCount;
+        QTest::newRow("async, message handler" + threads) << AsyncMessageHandler << threadCount;
+        QTest::newRow("async, binary log" + threads) << AsyncBinaryLog << threadCount;
+    }
+}
+
+// Emits MessagesPerThread messages on each of threadCount threads, and waits
+// until they have all been written.
+template <typename Log>
+void tst_bench_QAsyncLogSink::run(Log log)
+{
+    QFETCH(Method, method);
+    QFETCH(int, threadCount);
+
+    std::unique_ptr<QAsyncLogSink> sink;
+    if (method == AsyncMessageHandler)
+        sink.reset(new QAsyncLogSink);
+    else if (method == AsyncBinaryLog)
+        sink.reset(new QAsyncLogSink(dir.filePath("bench.qlog")));
+    if (sink) {
+        sink->setBufferSize(4 * 1024 * 1024);
+        QVERIFY(sink->install());
+    }
+
+    QBENCHMARK {
+        std::vector<std::unique_ptr<QThread>> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back(QThread::create([log] {
+                for (int i = 0; i < MessagesPerThread; ++i)
+                    log(i);
+            }));
+            threads.back()->start();
+        }
+        for (const auto &thread : threads)
+            thread->wait();
+        if (sink)
+            sink->flush();
+    }
+
+    if (sink) {
+        sink->uninstall();
+        QCOMPARE(sink->droppedMessageCount(), quint64(0));
+    }
+}
+
+void tst_bench_QAsyncLogSink::printfMessages()
+{
+    run([](int i) {
+        qCDebug(lcBench, "request %d took %.2f ms, status %s", i, i * 0.25, "ok");
+    });
+}
+
+void tst_bench_QAsyncLogSink::streamedMessages()
+{
+    run([](int i) {
+        qCDebug(lcBench) << "request" << i << "took" << i * 0.25 << "ms, status" << "ok";
+    });
+}
+
+QTEST_MAIN(tst_bench_QAsyncLogSink)
+
+#include "main.moc"
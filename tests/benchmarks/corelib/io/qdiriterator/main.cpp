@@ -58,6 +58,14 @@ private slots:
     void posix_data() { data(); }
     void diriterator();
     void diriterator_data() { data(); }
+    void diriteratorParallel();
+    void diriteratorParallel_data() { data(); }
+    void diriteratorBatches();
+    void diriteratorBatches_data() { data(); }
+    void diriteratorSizes();
+    void diriteratorSizes_data() { data(); }
+    void diriteratorSizesPrefetched();
+    void diriteratorSizesPrefetched_data() { data(); }
     void fsiterator();
     void fsiterator_data() { data(); }
     void stdRecursiveDirectoryIterator();
@@ -82,6 +90,11 @@ void tst_qdiriterator::data()
     QByteArray ba1 = ba + "/io";
     QTest::newRow(ba) << ba;
     //QTest::newRow(ba1) << ba1;
+
+    // e.g. a directory on a network file system, where ParallelScan matters most
+    const QByteArray extra = qgetenv("QDIRITERATOR_BENCH_DIR");
+    if (!extra.isEmpty())
+        QTest::newRow(extra) << extra;
 }
 
 #ifdef Q_OS_WIN
@@ -205,6 +218,86 @@ void tst_qdiriterator::diriterator()
     qDebug() << count;
 }
 
+void tst_qdiriterator::diriteratorParallel()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        int c = 0;
+
+        QDirIterator dir(dirpath, QDir::Files,
+            QDirIterator::Subdirectories | QDirIterator::ParallelScan);
+
+        while (dir.hasNext()) {
+            dir.next();
+            ++c;
+        }
+        count = c;
+    }
+    qDebug() << count;
+}
+
+void tst_qdiriterator::diriteratorBatches()
+{
+    QFETCH(QByteArray, dirpath);
+
+    int count = 0;
+
+    QBENCHMARK {
+        int c = 0;
+
+        QDirIterator dir(dirpath, QDir::Files,
+            QDirIterator::Subdirectories | QDirIterator::ParallelScan);
+
+        for (QFileInfoList batch = dir.nextBatch(); !batch.isEmpty(); batch = dir.nextBatch())
+            c += batch.size();
+        count = c;
+    }
+    qDebug() << count;
+}
+
+void tst_qdiriterator::diriteratorSizes()
+{
+    QFETCH(QByteArray, dirpath);
+
+    qint64 total = 0;
+
+    QBENCHMARK {
+        qint64 t = 0;
+
+        QDirIterator dir(dirpath, QDir::Files, QDirIterator::Subdirectories);
+        while (dir.hasNext()) {
+            dir.next();
+            t += dir.fileInfo().size();
+        }
+        total = t;
+    }
+    qDebug() << total;
+}
+
+void tst_qdiriterator::diriteratorSizesPrefetched()
+{
+    QFETCH(QByteArray, dirpath);
+
+    qint64 total = 0;
+
+    QBENCHMARK {
+        qint64 t = 0;
+
+        QDirIterator dir(dirpath, QDir::Files,
+            QDirIterator::Subdirectories | QDirIterator::ParallelScan
+            | QDirIterator::PrefetchMetaData);
+        for (QFileInfoList batch = dir.nextBatch(); !batch.isEmpty(); batch = dir.nextBatch()) {
+            for (const QFileInfo &info : qAsConst(batch))
+                t += info.size();
+        }
+        total = t;
+    }
+    qDebug() << total;
+}
+
 void tst_qdiriterator::fsiterator()
 {
     QFETCH(QByteArray, dirpath);
@@ -0,0 +1,169 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtTest/QtTest>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfilecopier.h>
+#include <qtemporarydir.h>
+
+class tst_bench_QFileCopier : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void copyFile_data();
+    void copyFile();
+    void copyTree_data();
+    void copyTree();
+
+private:
+    QString path(const QString &name) const { return dir.filePath(name); }
+
+    QTemporaryDir dir;
+    QString largeFile;
+    QString sparseFile;
+    QString tree;
+};
+
+enum {
+    LargeFileSize = 256 * 1024 * 1024,
+    SparseFileSize = 1024 * 1024 * 1024,
+    TreeFileCount = 2000,
+    TreeFileSize = 16 * 1024
+};
+
+void tst_bench_QFileCopier::initTestCase()
+{
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+
+    QByteArray block(1024 * 1024, Qt::Uninitialized);
+    for (int i = 0; i < block.size(); ++i)
+        block[i] = char(i * 7 + (i >> 10));
+
+    largeFile = path("large");
+    QFile large(largeFile);
+    QVERIFY(large.open(QIODevice::WriteOnly));
+    for (int written = 0; written < LargeFileSize; written += block.size())
+        QCOMPARE(large.write(block), qint64(block.size()));
+    large.close();
+
+    // a few megabytes of data scattered in a gigabyte of holes
+    sparseFile = path("sparse");
+    QFile sparse(sparseFile);
+    QVERIFY(sparse.open(QIODevice::WriteOnly));
+    QVERIFY(sparse.resize(SparseFileSize));
+    for (qint64 offset = 0; offset < SparseFileSize; offset += SparseFileSize / 8) {
+        QVERIFY(sparse.seek(offset));
+        QCOMPARE(sparse.write(block), qint64(block.size()));
+    }
+    sparse.close();
+
+    tree = path("tree");
+    QDir treeDir(tree);
+    for (int i = 0; i < TreeFileCount; ++i) {
+        const QString subdir = QString::number(i % 20);
+        QVERIFY(treeDir.mkpath(subdir));
+        QFile file(treeDir.filePath(subdir + QLatin1String("/file") + QString::number(i)));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(block.constData(), TreeFileSize), qint64(TreeFileSize));
+    }
+}
+
+void tst_bench_QFileCopier::copyFile_data()
+{
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<bool>("useCopier");
+
+    QTest::newRow("large:QFile::copy") << largeFile << false;
+    QTest::newRow("large:QFileCopier") << largeFile << true;
+    QTest::newRow("sparse:QFile::copy") << sparseFile << false;
+    QTest::newRow("sparse:QFileCopier") << sparseFile << true;
+}
+
+void tst_bench_QFileCopier::copyFile()
+{
+    QFETCH(QString, source);
+    QFETCH(bool, useCopier);
+    const QString destination = path("copy");
+
+    QBENCHMARK {
+        QFile::remove(destination);
+        if (useCopier) {
+            QFileCopier copier;
+            QVERIFY(copier.copy(source, destination));
+        } else {
+            QVERIFY(QFile::copy(source, destination));
+        }
+    }
+    QFile::remove(destination);
+}
+
+void tst_bench_QFileCopier::copyTree_data()
+{
+    QTest::addColumn<int>("threads");   // 0 for QFile::copy
+
+    QTest::newRow("QFile::copy") << 0;
+    QTest::newRow("QFileCopier:1") << 1;
+    QTest::newRow("QFileCopier:ideal") << QThread::idealThreadCount();
+}
+
+void tst_bench_QFileCopier::copyTree()
+{
+    QFETCH(int, threads);
+    const QString destination = path("treecopy");
+
+    QBENCHMARK {
+        QDir(destination).removeRecursively();
+        if (threads > 0) {
+            QFileCopier copier;
+            copier.setMaxThreadCount(threads);
+            QVERIFY(copier.copy(tree, destination));
+        } else {
+            const QDir source(tree);
+            const QDir target(destination);
+            QVERIFY(QDir().mkdir(destination));
+            const QStringList subdirs = source.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+            for (const QString &subdir : subdirs) {
+                QVERIFY(target.mkdir(subdir));
+                const QDir from(source.filePath(subdir));
+                const QDir to(target.filePath(subdir));
+                const QStringList names = from.entryList(QDir::Files);
+                for (const QString &name : names)
+                    QVERIFY(QFile::copy(from.filePath(name), to.filePath(name)));
+            }
+        }
+    }
+    QDir(destination).removeRecursively();
+}
+
+QTEST_MAIN(tst_bench_QFileCopier)
+
+#include "main.moc"
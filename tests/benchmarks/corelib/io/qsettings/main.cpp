@@ -0,0 +1,159 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the QtCore module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QDateTime>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include <qtest.h>
+
+class tst_bench_QSettings : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void open_data() { formats(); }
+    void open();
+    void readValues_data() { formats(); }
+    void readValues();
+    void updateAndSync_data() { formats(); }
+    void updateAndSync();
+    void childGroups_data() { formats(); }
+    void childGroups();
+
+private:
+    void formats();
+    QString fileName(QSettings::Format format) const;
+    void forceReload(QSettings::Format format);
+
+    QTemporaryDir dir;
+};
+
+static const int GroupCount = 500;
+static const int KeysPerGroup = 100;
+
+static QString keyName(int i)
+{
+    return QString::fromLatin1("group%1/key%2").arg(i % GroupCount).arg(i);
+}
+
+void tst_bench_QSettings::initTestCase()
+{
+    QVERIFY(dir.isValid());
+    for (QSettings::Format format : { QSettings::IniFormat, QSettings::BinaryFormat }) {
+        QSettings settings(fileName(format), format);
+        for (int i = 0; i < GroupCount * KeysPerGroup; ++i)
+            settings.setValue(keyName(i), QString::fromLatin1("value %1").arg(i));
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+    }
+}
+
+void tst_bench_QSettings::formats()
+{
+    QTest::addColumn<QSettings::Format>("format");
+
+    QTest::newRow("ini") << QSettings::IniFormat;
+    QTest::newRow("binary") << QSettings::BinaryFormat;
+}
+
+QString tst_bench_QSettings::fileName(QSettings::Format format) const
+{
+    return dir.filePath(format == QSettings::IniFormat ? "bench.ini" : "bench.qsettings");
+}
+
+// QSettings keeps parsed INI files around; make it read the file again
+void tst_bench_QSettings::forceReload(QSettings::Format format)
+{
+    QFile file(fileName(format));
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    static qint64 seconds = 0;
+    file.setFileTime(QDateTime::fromSecsSinceEpoch(1000000000 + ++seconds),
+                     QFileDevice::FileModificationTime);
+}
+
+void tst_bench_QSettings::open()
+{
+    QFETCH(QSettings::Format, format);
+
+    QBENCHMARK {
+        forceReload(format);
+        QSettings settings(fileName(format), format);
+        QCOMPARE(settings.value(keyName(4242)).toString(), QLatin1String("value 4242"));
+    }
+}
+
+void tst_bench_QSettings::readValues()
+{
+    QFETCH(QSettings::Format, format);
+
+    QSettings settings(fileName(format), format);
+    QRandomGenerator random(42);
+    QBENCHMARK {
+        for (int i = 0; i < 1000; ++i) {
+            const int key = random.bounded(GroupCount * KeysPerGroup);
+            if (!settings.contains(keyName(key)))
+                QFAIL("missing key");
+        }
+    }
+}
+
+void tst_bench_QSettings::updateAndSync()
+{
+    QFETCH(QSettings::Format, format);
+
+    QSettings settings(fileName(format), format);
+    QRandomGenerator random(42);
+    int round = 0;
+    QBENCHMARK {
+        for (int i = 0; i < 10; ++i)
+            settings.setValue(keyName(random.bounded(GroupCount * KeysPerGroup)), ++round);
+        settings.sync();
+    }
+    QCOMPARE(settings.status(), QSettings::NoError);
+}
+
+void tst_bench_QSettings::childGroups()
+{
+    QFETCH(QSettings::Format, format);
+
+    QSettings settings(fileName(format), format);
+    QBENCHMARK {
+        settings.beginGroup(QLatin1String("group123"));
+        QCOMPARE(settings.childKeys().size(), KeysPerGroup);
+        settings.endGroup();
+    }
+}
+
+QTEST_MAIN(tst_bench_QSettings)
+
+#include "main.moc"
@@ -27,19 +27,26 @@
 ****************************************************************************/
 
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QIODevice>
 #include <QString>
 #include <QBuffer>
+#include <QTemporaryFile>
 #include <qtest.h>
 
 class tst_qtextstream : public QObject
 {
     Q_OBJECT
 private slots:
+    void initTestCase();
     void writeSingleChar_data();
     void writeSingleChar();
+    void readLines_data();
+    void readLines();
 
 private:
+    QTemporaryFile logFile;
+    qsizetype logLines = 0;
 };
 
 enum Output { StringOutput, DeviceOutput };
@@ -48,6 +55,21 @@ Q_DECLARE_METATYPE(Output);
 enum Input { CharStarInput, QStringInput, CharInput, QCharInput };
 Q_DECLARE_METATYPE(Input);
 
+void tst_qtextstream::initTestCase()
+{
+    // about 20 MB of log-like lines of varying length
+    QVERIFY(logFile.open());
+    QByteArray line;
+    for (int i = 0; i < 200000; ++i) {
+        line = "2020-06-01T12:00:00.000 [worker-" + QByteArray::number(i % 16) + "] ";
+        line += QByteArray(20 + i % 150, char('a' + i % 26));
+        line += '\n';
+        QCOMPARE(logFile.write(line), line.size());
+    }
+    logLines = 200000;
+    QVERIFY(logFile.flush());
+}
+
 void tst_qtextstream::writeSingleChar_data()
 {
     QTest::addColumn<Output>("output");
@@ -115,6 +137,63 @@ void tst_qtextstream::writeSingleChar()
     QCOMPARE(result.left(10), QString("hhhhhhhhhh"));
 }
 
+enum LineReader { ReadLine, ReadLineInto, ReadLineViewString, ReadLineViewBytes };
+Q_DECLARE_METATYPE(LineReader);
+
+void tst_qtextstream::readLines_data()
+{
+    QTest::addColumn<LineReader>("reader");
+
+    QTest::newRow("readLine") << ReadLine;
+    QTest::newRow("readLineInto") << ReadLineInto;
+    QTest::newRow("readLineView-QStringView") << ReadLineViewString;
+    QTest::newRow("readLineView-QByteArrayView") << ReadLineViewBytes;
+}
+
+// reports lines per second, as QTest::Events
+void tst_qtextstream::readLines()
+{
+    QFETCH(LineReader, reader);
+
+    QFile file(logFile.fileName());
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QTextStream stream(&file);
+    stream.setMemoryMappingEnabled(true);
+
+    QString line;
+    QStringView view;
+    QByteArrayView bytes;
+    qint64 lines = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        QVERIFY(stream.seek(0));
+        qsizetype count = 0;
+        switch (reader) {
+        case ReadLine:
+            while (!(line = stream.readLine()).isNull())
+                ++count;
+            break;
+        case ReadLineInto:
+            while (stream.readLineInto(&line))
+                ++count;
+            break;
+        case ReadLineViewString:
+            while (stream.readLineView(&view))
+                ++count;
+            break;
+        case ReadLineViewBytes:
+            while (stream.readLineView(&bytes))
+                ++count;
+            break;
+        }
+        QCOMPARE(count, logLines);
+        lines += count;
+    } while (timer.elapsed() < 1000);
+
+    QTest::setBenchmarkResult(lines * 1e9 / timer.nsecsElapsed(), QTest::Events);
+}
+
 QTEST_MAIN(tst_qtextstream)
 
 #include "main.moc"
@@ -28,7 +28,9 @@
 
 #include <QtTest>
 #include <qjsondocument.h>
+#include <qjsonarray.h>
 #include <qjsonobject.h>
+#include <qjsonstreamparser.h>
 
 class BenchmarkQtJson: public QObject
 {
@@ -45,6 +47,12 @@ private Q_SLOTS:
     void parseNumbers();
     void parseJson();
     void parseJsonToVariant();
+    void parseJsonShapes_data();
+    void parseJsonShapes();
+    void parseJsonStreaming_data();
+    void parseJsonStreaming();
+    void parseRecordArray_data();
+    void parseRecordArray();
 
     void jsonObjectInsert();
     void variantMapInsert();
@@ -117,6 +125,123 @@ void BenchmarkQtJson::parseJsonToVariant()
     }
 }
 
+void BenchmarkQtJson::parseJsonShapes_data()
+{
+    QTest::addColumn<QByteArray>("json");
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    const QJsonDocument testDoc = QJsonDocument::fromJson(file.readAll());
+
+    QJsonArray prose;
+    QJsonArray escaped;
+    QJsonArray international;
+    for (int i = 0; i < 1000; ++i) {
+        prose.append(QStringLiteral("The quick brown fox jumps over the lazy dog, again and again, "
+                                    "until the dog finally gets up and leaves. %1").arg(i));
+        escaped.append(QStringLiteral("C:\\Users\\user%1\\Documents\t\"quoted\"\n").arg(i));
+        international.append(QStringLiteral("Größe %1: Съешь же ещё этих мягких булок, 狐狸").arg(i));
+    }
+
+    QTest::newRow("compact") << testDoc.toJson(QJsonDocument::Compact);
+    QTest::newRow("indented") << testDoc.toJson(QJsonDocument::Indented);
+    QTest::newRow("long-strings") << QJsonDocument(prose).toJson(QJsonDocument::Indented);
+    QTest::newRow("escaped-strings") << QJsonDocument(escaped).toJson(QJsonDocument::Indented);
+    QTest::newRow("non-ascii-strings") << QJsonDocument(international).toJson(QJsonDocument::Indented);
+}
+
+void BenchmarkQtJson::parseJsonShapes()
+{
+    QFETCH(QByteArray, json);
+
+    QBENCHMARK {
+        QJsonDocument doc = QJsonDocument::fromJson(json);
+        QVERIFY(!doc.isNull());
+    }
+}
+
+void BenchmarkQtJson::parseJsonStreaming_data()
+{
+    QTest::addColumn<int>("chunkSize");
+
+    QTest::newRow("whole") << 0;
+    QTest::newRow("4096") << 4096;
+    QTest::newRow("256") << 256;
+}
+
+void BenchmarkQtJson::parseJsonStreaming()
+{
+    QFETCH(int, chunkSize);
+
+    QString testFile = QFINDTESTDATA("test.json");
+    QVERIFY2(!testFile.isEmpty(), "cannot find test file test.json!");
+    QFile file(testFile);
+    file.open(QFile::ReadOnly);
+    QByteArray testJson = file.readAll();
+    if (!chunkSize)
+        chunkSize = testJson.size();
+
+    QJsonStreamHandler handler;
+    QBENCHMARK {
+        QJsonStreamParser parser(&handler);
+        for (qsizetype i = 0; i < testJson.size(); i += chunkSize)
+            parser.addData(QByteArrayView(testJson).sliced(i, qMin<qsizetype>(chunkSize, testJson.size() - i)));
+        QVERIFY(parser.finish());
+    }
+}
+
+void BenchmarkQtJson::parseRecordArray_data()
+{
+    QTest::addColumn<bool>("streaming");
+    QTest::addColumn<int>("records");
+
+    for (int records : { 1000, 100000 }) {
+        QTest::addRow("fromJson-%d", records) << false << records;
+        QTest::addRow("streaming-%d", records) << true << records;
+    }
+}
+
+void BenchmarkQtJson::parseRecordArray()
+{
+    QFETCH(bool, streaming);
+    QFETCH(int, records);
+
+    QByteArray json = "[";
+    for (int i = 0; i < records; ++i) {
+        if (i)
+            json += ',';
+        json += "{\"id\":" + QByteArray::number(i) + ",\"name\":\"record " + QByteArray::number(i)
+                + "\",\"score\":" + QByteArray::number(i * 0.25) + ",\"tags\":[\"a\",\"b\"]}";
+    }
+    json += ']';
+
+    class Summer : public QJsonStreamHandler
+    {
+    public:
+        void value(const QJsonValue &record) override { sum += record[QLatin1String("score")].toDouble(); }
+        double sum = 0;
+    };
+
+    // the streaming parser reads the document in 64 kB chunks, as it would
+    // arrive from a socket, and never holds more than one record
+    QBENCHMARK {
+        Summer summer;
+        if (streaming) {
+            QJsonStreamParser parser(&summer, QJsonStreamParser::MaterializeArrayElements);
+            for (qsizetype i = 0; i < json.size(); i += 65536)
+                parser.addData(QByteArrayView(json).sliced(i, qMin<qsizetype>(65536, json.size() - i)));
+            QVERIFY(parser.finish());
+        } else {
+            const QJsonArray array = QJsonDocument::fromJson(json).array();
+            for (const QJsonValue &record : array)
+                summer.value(record);
+        }
+        QVERIFY(summer.sum > 0);
+    }
+}
+
 void BenchmarkQtJson::jsonObjectInsert()
 {
     QJsonObject object;
@@ -30,6 +30,12 @@
 #include <qtest.h>
 #include <qtesteventloop.h>
 
+#ifdef Q_OS_UNIX
+#include <private/qcore_unix_p.h>
+#include <private/qeventdispatcher_unix_p.h>
+#include <sys/resource.h>
+#endif
+
 class PingPong : public QObject
 {
 public:
@@ -83,6 +89,66 @@ int EventTester::foo(int bar)
     return bar + 1;
 }
 
+#ifdef Q_OS_UNIX
+// Owns a set of idle pipes with read notifiers plus one pipe that is
+// written to from the benchmark thread; lives in its own event loop.
+class NotifierFarm : public QObject
+{
+    Q_OBJECT
+public:
+    void populate(int count);
+    void clear();
+    void ping();
+
+private:
+    void activePipeReadable();
+
+    QList<int> fds;
+    int activeFds[2] = { -1, -1 };
+    QSemaphore done;
+};
+
+void NotifierFarm::populate(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        int pipefds[2];
+        if (qt_safe_pipe(pipefds, O_NONBLOCK) == -1)
+            qFatal("NotifierFarm: cannot create pipe");
+        fds << pipefds[0] << pipefds[1];
+        new QSocketNotifier(pipefds[0], QSocketNotifier::Read, this);
+    }
+
+    if (qt_safe_pipe(activeFds, O_NONBLOCK) == -1)
+        qFatal("NotifierFarm: cannot create pipe");
+    auto notifier = new QSocketNotifier(activeFds[0], QSocketNotifier::Read, this);
+    connect(notifier, &QSocketNotifier::activated, this, &NotifierFarm::activePipeReadable);
+}
+
+void NotifierFarm::clear()
+{
+    qDeleteAll(findChildren<QSocketNotifier *>());
+    for (int fd : qAsConst(fds))
+        qt_safe_close(fd);
+    fds.clear();
+    qt_safe_close(activeFds[0]);
+    qt_safe_close(activeFds[1]);
+}
+
+void NotifierFarm::ping()
+{
+    char c = 0;
+    qt_safe_write(activeFds[1], &c, 1);
+    done.acquire();
+}
+
+void NotifierFarm::activePipeReadable()
+{
+    char c;
+    qt_safe_read(activeFds[0], &c, 1);
+    done.release();
+}
+#endif
+
 class EventsBench : public QObject
 {
     Q_OBJECT
@@ -96,10 +162,22 @@ private slots:
     void sendEvent();
     void postEvent_data();
     void postEvent();
+#ifdef Q_OS_UNIX
+    void socketNotifiers_data();
+    void socketNotifiers();
+#endif
 };
 
 void EventsBench::initTestCase()
 {
+#ifdef Q_OS_UNIX
+    // every idle notifier in socketNotifiers() costs two descriptors
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+#endif
 }
 
 void EventsBench::cleanupTestCase()
@@ -169,6 +247,52 @@ void EventsBench::postEvent()
     }
 }
 
+#ifdef Q_OS_UNIX
+void EventsBench::socketNotifiers_data()
+{
+    QTest::addColumn<bool>("useEpoll");
+    QTest::addColumn<int>("count");
+
+    for (int count : { 10, 100, 1000, 10000 }) {
+        QTest::addRow("poll, %d notifiers", count) << false << count;
+#if QT_CONFIG(epoll)
+        QTest::addRow("epoll, %d notifiers", count) << true << count;
+#endif
+    }
+}
+
+void EventsBench::socketNotifiers()
+{
+    QFETCH(bool, useEpoll);
+    QFETCH(int, count);
+
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && rlim_t(2 * count + 64) > limit.rlim_cur)
+        QSKIP("Not enough file descriptors available");
+
+    // the backend is picked when the dispatcher is created
+    qputenv("QT_EVENT_DISPATCHER_EPOLL", useEpoll ? "1" : "0");
+    QThread thread;
+    thread.setEventDispatcher(new QEventDispatcherUNIX);
+    qunsetenv("QT_EVENT_DISPATCHER_EPOLL");
+    thread.start();
+
+    NotifierFarm farm;
+    farm.moveToThread(&thread);
+    QMetaObject::invokeMethod(&farm, [&farm, count] { farm.populate(count); },
+                              Qt::BlockingQueuedConnection);
+
+    // one ready descriptor among count idle ones
+    QBENCHMARK {
+        farm.ping();
+    }
+
+    QMetaObject::invokeMethod(&farm, &NotifierFarm::clear, Qt::BlockingQueuedConnection);
+    thread.quit();
+    thread.wait();
+}
+#endif
+
 QTEST_MAIN(EventsBench)
 
 #include "main.moc"
@@ -27,8 +27,10 @@
 **
 ****************************************************************************/
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QIODevice>
 #include <QFile>
+#include <QRandomGenerator>
 #include <QString>
 
 #include <qtest.h>
@@ -48,6 +50,9 @@ private slots:
     void latin1Uppercasing_xlate_checked();
     void latin1Uppercasing_category();
     void latin1Uppercasing_bitcheck();
+
+    void parseCsv_data();
+    void parseCsv();
 };
 
 void tst_qbytearray::initTestCase()
@@ -259,6 +264,79 @@ void tst_qbytearray::latin1Uppercasing_bitcheck()
 }
 
 
+enum CsvContent { CsvIntegers, CsvDecimals, CsvScientific };
+enum CsvParser { ParseNumbers, SplitAndConvert };
+
+void tst_qbytearray::parseCsv_data()
+{
+    QTest::addColumn<int>("content");
+    QTest::addColumn<int>("parser");
+
+    QTest::newRow("integers-parseNumbers") << int(CsvIntegers) << int(ParseNumbers);
+    QTest::newRow("integers-split") << int(CsvIntegers) << int(SplitAndConvert);
+    QTest::newRow("decimals-parseNumbers") << int(CsvDecimals) << int(ParseNumbers);
+    QTest::newRow("decimals-split") << int(CsvDecimals) << int(SplitAndConvert);
+    QTest::newRow("scientific-parseNumbers") << int(CsvScientific) << int(ParseNumbers);
+    QTest::newRow("scientific-split") << int(CsvScientific) << int(SplitAndConvert);
+}
+
+// reports MB/s rather than time per iteration, so the rows compare directly
+void tst_qbytearray::parseCsv()
+{
+    QFETCH(int, content);
+    QFETCH(int, parser);
+
+    // 1000 lines of 16 columns
+    const int columns = 16;
+    QRandomGenerator rng(1234);
+    QByteArray csv;
+    for (int i = 0; i < 1000 * columns; ++i) {
+        switch (content) {
+        case CsvIntegers:
+            csv += QByteArray::number(qint64(rng.generate64() >> rng.bounded(64)));
+            break;
+        case CsvDecimals:
+            csv += QByteArray::number(rng.bounded(100000.0) - 50000, 'f', 3);
+            break;
+        case CsvScientific:
+            csv += QByteArray::number(rng.generateDouble() * 1e10, 'e', 15);
+            break;
+        }
+        csv += (i + 1) % columns ? ',' : '\n';
+    }
+    const QList<QByteArray> lines = csv.split('\n');
+
+    double doubles[columns];
+    qlonglong integers[columns];
+    qsizetype parsed = 0;
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        for (const QByteArray &line : lines) {
+            if (parser == ParseNumbers) {
+                parsed += content == CsvIntegers
+                        ? QByteArrayView(line).parseNumbers(integers, columns)
+                        : QByteArrayView(line).parseNumbers(doubles, columns);
+            } else {
+                for (const QByteArray &field : line.split(',')) {
+                    bool ok;
+                    if (content == CsvIntegers)
+                        integers[0] = field.toLongLong(&ok);
+                    else
+                        doubles[0] = field.toDouble(&ok);
+                    parsed += ok;
+                }
+            }
+        }
+        bytes += csv.size();
+    } while (timer.elapsed() < 500);
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    QCOMPARE(qint64(parsed), bytes / csv.size() * 1000 * columns);
+    QTest::setBenchmarkResult(bytes * 1e9 / elapsed, QTest::BytesPerSecond);
+}
+
 QTEST_MAIN(tst_qbytearray)
 
 #include "main.moc"
@@ -37,6 +37,14 @@ private Q_SLOTS:
     void toUpper_QLocale_1();
     void toUpper_QLocale_2();
     void toUpper_QString();
+    void number_qlonglong();
+    void number_double_data();
+    void number_double();
+    void toString_double_data() { number_double_data(); }
+    void toString_double();
+    void appendNumbers_qlonglong();
+    void appendNumbers_double_data() { number_double_data(); }
+    void appendNumbers_double();
 };
 
 static QString data()
@@ -65,6 +73,99 @@ void tst_QLocale::toUpper_QString()
     QBENCHMARK { LOOP(s.toUpper()) }
 }
 
+// numbers as found in a CSV export: a mix of magnitudes and digit counts
+static QList<double> doubles()
+{
+    QList<double> result;
+    double d = 0.000123;
+    for (int i = 0; i < 5000; ++i) {
+        result.append(d * (i % 7 ? 1 : -1));
+        d = d * 1.37 + 0.001;
+        if (d > 1e12)
+            d = 0.000123 + i;
+    }
+    return result;
+}
+
+static QList<qlonglong> integers()
+{
+    QList<qlonglong> result;
+    qlonglong n = 1;
+    for (int i = 0; i < 5000; ++i) {
+        result.append(i % 3 ? n : -n);
+        n = n * 7 + i;
+        if (n > Q_INT64_C(1000000000000000))
+            n = i;
+    }
+    return result;
+}
+
+void tst_QLocale::number_qlonglong()
+{
+    const QList<qlonglong> values = integers();
+    QBENCHMARK {
+        for (qlonglong n : values)
+            QString::number(n);
+    }
+}
+
+void tst_QLocale::number_double_data()
+{
+    QTest::addColumn<char>("format");
+    QTest::addColumn<int>("precision");
+
+    QTest::newRow("g, 6") << 'g' << 6;
+    QTest::newRow("g, shortest") << 'g' << int(QLocale::FloatingPointShortest);
+    QTest::newRow("f, 3") << 'f' << 3;
+    QTest::newRow("e, 10") << 'e' << 10;
+}
+
+void tst_QLocale::number_double()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QList<double> values = doubles();
+    QBENCHMARK {
+        for (double d : values)
+            QString::number(d, format, precision);
+    }
+}
+
+void tst_QLocale::toString_double()
+{
+    // a locale other than C takes the generic path
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QList<double> values = doubles();
+    const QLocale locale(QLocale::English, QLocale::UnitedKingdom);
+    QBENCHMARK {
+        for (double d : values)
+            locale.toString(d, format, precision);
+    }
+}
+
+void tst_QLocale::appendNumbers_qlonglong()
+{
+    const QList<qlonglong> values = integers();
+    QString result;
+    QBENCHMARK {
+        result.truncate(0); // keeps the capacity
+        result.appendNumbers(values.constData(), values.size(), u",");
+    }
+}
+
+void tst_QLocale::appendNumbers_double()
+{
+    QFETCH(char, format);
+    QFETCH(int, precision);
+    const QList<double> values = doubles();
+    QByteArray result;
+    QBENCHMARK {
+        result.truncate(0); // keeps the capacity
+        result.appendNumbers(values.constData(), values.size(), ",", format, precision);
+    }
+}
+
 QTEST_MAIN(tst_QLocale)
 
 #include "main.moc"
@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QRegularExpression>
+#include <QRandomGenerator>
+#include <QtTest>
+
+class tst_QRegularExpression : public QObject
+{
+    Q_OBJECT
+
+private:
+    void patterns_data();
+
+private slots:
+    void loopMatch_data() { patterns_data(); }
+    void loopMatch();
+    void setMatchingPatterns_data() { patterns_data(); }
+    void setMatchingPatterns();
+    void setFirstMatchingPattern_data() { patterns_data(); }
+    void setFirstMatchingPattern();
+    void construction_data() { patterns_data(); }
+    void construction();
+
+    // must run in this order: the second one enables the cache
+    void startupWithoutCache();
+    void startupWithCache();
+};
+
+static QString randomWord(QRandomGenerator &rng)
+{
+    QString word;
+    const int length = 4 + rng.bounded(7);
+    for (int j = 0; j < length; ++j)
+        word += QChar(u'a' + rng.bounded(26));
+    return word;
+}
+
+static QStringList makePatterns(int count)
+{
+    // classification rules, roughly like the ones of a log filter
+    QRandomGenerator rng(count);
+    QStringList patterns;
+    patterns.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        switch (i % 4) {
+        case 0:
+            patterns << QStringLiteral("\\b%1\\d+\\b").arg(randomWord(rng));
+            break;
+        case 1:
+            patterns << QStringLiteral("%1[-_]%2").arg(randomWord(rng), randomWord(rng));
+            break;
+        case 2:
+            patterns << QStringLiteral("(?i)error:\\s+%1").arg(randomWord(rng));
+            break;
+        case 3:
+            patterns << QStringLiteral("/%1/(?:\\w+/)*%2\\.html").arg(randomWord(rng), randomWord(rng));
+            break;
+        }
+    }
+    return patterns;
+}
+
+static QStringList makeLogLines()
+{
+    // 1000 lines of about 120 characters
+    QRandomGenerator rng(42);
+    static const char *const words[] = {
+        "connection", "from", "client", "accepted", "request", "GET", "/index.html",
+        "status", "200", "bytes", "sent", "in", "ms", "user", "session", "closed"
+    };
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i) {
+        QString line = QStringLiteral("2020-11-03T12:34:56.789Z [worker-%1] ").arg(i % 16);
+        while (line.size() < 120) {
+            line += QLatin1String(words[rng.bounded(int(std::size(words)))]);
+            line += u' ';
+        }
+        lines << line;
+    }
+    return lines;
+}
+
+void tst_QRegularExpression::patterns_data()
+{
+    QTest::addColumn<int>("patternCount");
+
+    for (int count : { 10, 200, 500 })
+        QTest::addRow("%d-patterns", count) << count;
+}
+
+void tst_QRegularExpression::loopMatch()
+{
+    QFETCH(int, patternCount);
+    const QStringList lines = makeLogLines();
+
+    QList<QRegularExpression> expressions;
+    for (const QString &pattern : makePatterns(patternCount)) {
+        expressions.append(QRegularExpression(pattern));
+        expressions.last().optimize();
+    }
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString &line : lines) {
+            for (const QRegularExpression &re : qAsConst(expressions)) {
+                if (re.match(line).hasMatch())
+                    ++found;
+            }
+        }
+    }
+    Q_UNUSED(found);
+}
+
+void tst_QRegularExpression::setMatchingPatterns()
+{
+    QFETCH(int, patternCount);
+    const QStringList lines = makeLogLines();
+    const QRegularExpressionSet set(makePatterns(patternCount));
+    QVERIFY(set.isValid());
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString &line : lines)
+            found += set.matchingPatterns(line).size();
+    }
+    Q_UNUSED(found);
+}
+
+void tst_QRegularExpression::setFirstMatchingPattern()
+{
+    QFETCH(int, patternCount);
+    const QStringList lines = makeLogLines();
+    const QRegularExpressionSet set(makePatterns(patternCount));
+    QVERIFY(set.isValid());
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString &line : lines) {
+            if (set.firstMatchingPattern(line) >= 0)
+                ++found;
+        }
+    }
+    Q_UNUSED(found);
+}
+
+void tst_QRegularExpression::construction()
+{
+    QFETCH(int, patternCount);
+    const QStringList patterns = makePatterns(patternCount);
+
+    QBENCHMARK {
+        QRegularExpressionSet set(patterns);
+        Q_UNUSED(set);
+    }
+}
+
+static QStringList makeStartupPatterns()
+{
+    // the patterns of a service, compiled on first use after a restart
+    QRandomGenerator rng(3000);
+    QStringList patterns;
+    for (int i = 0; i < 3000; ++i) {
+        patterns << QStringLiteral("^/api/v\\d+/%1/(?<id>[0-9a-f]{8})(?:/%2)?(?:\\?.*)?$")
+                    .arg(randomWord(rng), randomWord(rng));
+    }
+    return patterns;
+}
+
+static int compileAll(const QStringList &patterns)
+{
+    int valid = 0;
+    for (const QString &pattern : patterns) {
+        if (QRegularExpression(pattern).isValid())
+            ++valid;
+    }
+    return valid;
+}
+
+void tst_QRegularExpression::startupWithoutCache()
+{
+    const QStringList patterns = makeStartupPatterns();
+
+    int valid = 0;
+    QBENCHMARK {
+        valid = compileAll(patterns);
+    }
+    QCOMPARE(valid, patterns.size());
+}
+
+void tst_QRegularExpression::startupWithCache()
+{
+    const QStringList patterns = makeStartupPatterns();
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString fileName = dir.filePath(QStringLiteral("qregularexpression.cache"));
+
+    // a previous run of the application fills the cache
+    QRegularExpression::loadCompiledPatternCache(fileName);
+    QCOMPARE(compileAll(patterns), patterns.size());
+    QVERIFY(QRegularExpression::saveCompiledPatternCache(fileName));
+
+    int valid = 0;
+    QBENCHMARK {
+        QVERIFY(QRegularExpression::loadCompiledPatternCache(fileName));
+        valid = compileAll(patterns);
+    }
+    QCOMPARE(valid, patterns.size());
+}
+
+QTEST_MAIN(tst_QRegularExpression)
+
+#include "main.moc"
@@ -48,6 +48,17 @@ private slots:
     void toCaseFolded_data();
     void toCaseFolded();
 
+    void fromUtf8_data();
+    void fromUtf8();
+    void toUtf8_data() { fromUtf8_data(); }
+    void toUtf8();
+
+    void multiArg_chained();
+    void multiArg_strings();
+    void multiArg_appendArgs();
+    void multiArg_appendArgsReused();
+    void multiArg_appendArgsUtf8();
+
 private:
     void section_data_impl(bool includeRegExOnly = true);
     template <typename RX> void section_impl();
@@ -187,6 +198,119 @@ void tst_QString::toCaseFolded()
     }
 }
 
+void tst_QString::fromUtf8_data()
+{
+    QTest::addColumn<QString>("s");
+
+    const auto repeat = [](const QString &pattern, int length) {
+        QString result;
+        while (result.size() < length)
+            result += pattern;
+        return result;
+    };
+
+    const QString latin = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    const QString accented = QStringLiteral("Größere Übungen für Ärzte, élèves et señores. ");
+    const QString cyrillic = QStringLiteral("Съешь же ещё этих мягких французских булок. ");
+    const QString greek = QStringLiteral("Ξεσκεπάζω την ψυχοφθόρα βδελυγμία. ");
+    const QString cjk = QStringLiteral("敏捷的棕色狐狸跳过了懒狗。いろはにほへと。");
+    const QString deseret = QString::fromUcs4(U"\U00010428\U00010429 ");
+
+    QTest::newRow("ascii") << repeat(latin, 4096);
+    QTest::newRow("latin-accented") << repeat(accented, 4096);
+    QTest::newRow("cyrillic") << repeat(cyrillic, 4096);
+    QTest::newRow("greek") << repeat(greek, 4096);
+    QTest::newRow("cjk") << repeat(cjk, 4096);
+    QTest::newRow("mixed") << repeat(latin + cyrillic + cjk + accented, 4096);
+    QTest::newRow("mixed-with-supplementary") << repeat(latin + cjk + deseret, 4096);
+}
+
+void tst_QString::fromUtf8()
+{
+    QFETCH(QString, s);
+    const QByteArray utf8 = s.toUtf8();
+
+    QBENCHMARK {
+        QString result = QString::fromUtf8(utf8);
+        Q_UNUSED(result);
+    }
+}
+
+void tst_QString::toUtf8()
+{
+    QFETCH(QString, s);
+
+    QBENCHMARK {
+        QByteArray result = s.toUtf8();
+        Q_UNUSED(result);
+    }
+}
+
+// a typical log line: six arguments, strings and numbers mixed
+static const QString logFile = QStringLiteral("/var/log/application/session.log");
+static const QLatin1String logLevel("warning");
+enum { LogLines = 1000 };
+
+void tst_QString::multiArg_chained()
+{
+    QBENCHMARK {
+        for (int i = 0; i < LogLines; ++i) {
+            QString result = QStringLiteral("%1 [%2] %3: line %4 of %5 (%6)")
+                    .arg(i).arg(logLevel).arg(logFile).arg(i * 3).arg(int(LogLines)).arg(0.5 * i);
+            Q_UNUSED(result);
+        }
+    }
+}
+
+void tst_QString::multiArg_strings()
+{
+    // the multi-argument arg() only takes strings: convert the numbers first
+    QBENCHMARK {
+        for (int i = 0; i < LogLines; ++i) {
+            QString result = QStringLiteral("%1 [%2] %3: line %4 of %5 (%6)")
+                    .arg(QString::number(i), logLevel, logFile, QString::number(i * 3),
+                         QString::number(int(LogLines)), QString::number(0.5 * i));
+            Q_UNUSED(result);
+        }
+    }
+}
+
+void tst_QString::multiArg_appendArgs()
+{
+    QBENCHMARK {
+        for (int i = 0; i < LogLines; ++i) {
+            QString result;
+            result.appendArgs(u"%1 [%2] %3: line %4 of %5 (%6)",
+                              i, logLevel, logFile, i * 3, int(LogLines), 0.5 * i);
+            Q_UNUSED(result);
+        }
+    }
+}
+
+void tst_QString::multiArg_appendArgsReused()
+{
+    QString result;
+    QBENCHMARK {
+        for (int i = 0; i < LogLines; ++i) {
+            result.truncate(0); // keeps the capacity
+            result.appendArgs(u"%1 [%2] %3: line %4 of %5 (%6)",
+                              i, logLevel, logFile, i * 3, int(LogLines), 0.5 * i);
+        }
+    }
+}
+
+void tst_QString::multiArg_appendArgsUtf8()
+{
+    QByteArray result;
+    QBENCHMARK {
+        for (int i = 0; i < LogLines; ++i) {
+            result.truncate(0); // keeps the capacity
+            result.appendArgs(QLatin1String("%1 [%2] %3: line %4 of %5 (%6)"),
+                              i, logLevel, logFile, i * 3, int(LogLines), 0.5 * i);
+        }
+    }
+}
+
 QTEST_APPLESS_MAIN(tst_QString)
 
 #include "main.moc"
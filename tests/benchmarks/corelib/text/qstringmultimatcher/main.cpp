@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QStringMatcher>
+#include <QStringMultiMatcher>
+#include <QRandomGenerator>
+#include <QtTest>
+
+class tst_QStringMultiMatcher : public QObject
+{
+    Q_OBJECT
+
+private:
+    void keywords_data();
+
+private slots:
+    void loopStringMatcher_data() { keywords_data(); }
+    void loopStringMatcher();
+    void multiMatcher_data() { keywords_data(); }
+    void multiMatcher();
+    void multiMatcherUtf8_data() { keywords_data(); }
+    void multiMatcherUtf8();
+    void construction_data() { keywords_data(); }
+    void construction();
+};
+
+static QStringList makeKeywords(int count)
+{
+    // words of 4 to 12 lowercase letters, roughly like log keywords
+    QRandomGenerator rng(count);
+    QStringList keywords;
+    keywords.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        QString word;
+        const int length = 4 + rng.bounded(9);
+        for (int j = 0; j < length; ++j)
+            word += QChar(u'a' + rng.bounded(26));
+        keywords << word;
+    }
+    return keywords;
+}
+
+static QStringList makeLogLines(const QStringList &keywords)
+{
+    // 1000 lines of about 120 characters; one in ten contains a keyword
+    QRandomGenerator rng(42);
+    static const char *const words[] = {
+        "connection", "from", "client", "accepted", "request", "GET", "/index.html",
+        "status", "200", "bytes", "sent", "in", "ms", "user", "session", "closed"
+    };
+    QStringList lines;
+    for (int i = 0; i < 1000; ++i) {
+        QString line = QStringLiteral("2020-11-03T12:34:56.789Z [worker-%1] ").arg(i % 16);
+        while (line.size() < 120) {
+            line += QLatin1String(words[rng.bounded(int(std::size(words)))]);
+            line += u' ';
+        }
+        if (i % 10 == 0)
+            line += keywords.at(rng.bounded(int(keywords.size())));
+        lines << line;
+    }
+    return lines;
+}
+
+void tst_QStringMultiMatcher::keywords_data()
+{
+    QTest::addColumn<int>("keywordCount");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    for (int count : { 10, 100, 500 }) {
+        QTest::addRow("%d-keywords", count) << count << Qt::CaseSensitive;
+        QTest::addRow("%d-keywords-ci", count) << count << Qt::CaseInsensitive;
+    }
+}
+
+void tst_QStringMultiMatcher::loopStringMatcher()
+{
+    QFETCH(int, keywordCount);
+    QFETCH(Qt::CaseSensitivity, cs);
+    const QStringList keywords = makeKeywords(keywordCount);
+    const QStringList lines = makeLogLines(keywords);
+
+    QList<QStringMatcher> matchers;
+    for (const QString &keyword : keywords)
+        matchers.append(QStringMatcher(keyword, cs));
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString &line : lines) {
+            for (const QStringMatcher &matcher : qAsConst(matchers)) {
+                for (qsizetype pos = matcher.indexIn(line); pos >= 0;
+                     pos = matcher.indexIn(line, pos + 1))
+                    ++found;
+            }
+        }
+    }
+    QVERIFY(found >= 100);
+}
+
+void tst_QStringMultiMatcher::multiMatcher()
+{
+    QFETCH(int, keywordCount);
+    QFETCH(Qt::CaseSensitivity, cs);
+    const QStringList keywords = makeKeywords(keywordCount);
+    const QStringList lines = makeLogLines(keywords);
+    const QStringMultiMatcher matcher(keywords, cs);
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QString &line : lines)
+            found += matcher.findAll(line).size();
+    }
+    QVERIFY(found >= 100);
+}
+
+void tst_QStringMultiMatcher::multiMatcherUtf8()
+{
+    QFETCH(int, keywordCount);
+    QFETCH(Qt::CaseSensitivity, cs);
+    const QStringList keywords = makeKeywords(keywordCount);
+    QList<QByteArray> lines;
+    for (const QString &line : makeLogLines(keywords))
+        lines << line.toUtf8();
+    const QStringMultiMatcher matcher(keywords, cs);
+
+    qsizetype found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (const QByteArray &line : qAsConst(lines))
+            found += matcher.findAll(QByteArrayView(line)).size();
+    }
+    QVERIFY(found >= 100);
+}
+
+void tst_QStringMultiMatcher::construction()
+{
+    QFETCH(int, keywordCount);
+    QFETCH(Qt::CaseSensitivity, cs);
+    const QStringList keywords = makeKeywords(keywordCount);
+
+    QBENCHMARK {
+        QStringMultiMatcher matcher(keywords, cs);
+        Q_UNUSED(matcher);
+    }
+}
+
+QTEST_MAIN(tst_QStringMultiMatcher)
+
+#include "main.moc"
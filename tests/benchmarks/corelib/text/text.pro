@@ -3,7 +3,9 @@ SUBDIRS = \
         qbytearray \
         qchar \
         qlocale \
+        qregularexpression \
         qstringbuilder \
-        qstringlist
+        qstringlist \
+        qstringmultimatcher
 
 *g++*: SUBDIRS += qstring
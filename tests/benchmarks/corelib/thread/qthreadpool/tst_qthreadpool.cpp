@@ -40,6 +40,8 @@ public:
 private slots:
     void startRunnables();
     void activeThreadCount();
+    void fineGrainedTasks_data();
+    void fineGrainedTasks();
 };
 
 tst_QThreadPool::tst_QThreadPool()
@@ -75,5 +77,55 @@ void tst_QThreadPool::activeThreadCount()
     }
 }
 
+class FanOutRunnable : public QRunnable
+{
+public:
+    FanOutRunnable(QThreadPool *pool, int depth)
+        : pool(pool), depth(depth)
+    {}
+
+    void run() override
+    {
+        if (depth > 0) {
+            pool->start(new FanOutRunnable(pool, depth - 1));
+            pool->start(new FanOutRunnable(pool, depth - 1));
+        }
+    }
+
+private:
+    QThreadPool *pool;
+    int depth;
+};
+
+void tst_QThreadPool::fineGrainedTasks_data()
+{
+    QTest::addColumn<bool>("workStealing");
+    QTest::addColumn<int>("threadCount");
+
+    const int maxThreads = qMax(QThread::idealThreadCount(), 2);
+    for (int threads = 1; ; threads = qMin(threads * 2, maxThreads)) {
+        QTest::addRow("shared queue, %d threads", threads) << false << threads;
+        QTest::addRow("work stealing, %d threads", threads) << true << threads;
+        if (threads == maxThreads)
+            break;
+    }
+}
+
+void tst_QThreadPool::fineGrainedTasks()
+{
+    QFETCH(bool, workStealing);
+    QFETCH(int, threadCount);
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(threadCount);
+    threadPool.setWorkStealingEnabled(workStealing);
+
+    // 2^17 - 1 empty runnables, all but the first started from pool threads
+    QBENCHMARK {
+        threadPool.start(new FanOutRunnable(&threadPool, 16));
+        threadPool.waitForDone();
+    }
+}
+
 QTEST_MAIN(tst_QThreadPool)
 #include "tst_qthreadpool.moc"
@@ -26,9 +26,14 @@
 **
 ****************************************************************************/
 #include <QString>
+#include <QFlatMap>
 
 #include <qtest.h>
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+
 class tst_associative_containers : public QObject
 {
     Q_OBJECT
@@ -37,8 +42,38 @@ private slots:
     void insert();
     void lookup_data();
     void lookup();
+    void bulkConstruction_data();
+    void bulkConstruction();
+    void iterate_data();
+    void iterate();
+    void stringLookup_data();
+    void stringLookup();
 };
 
+enum ContainerType { Hash, Map, FlatMap };
+Q_DECLARE_METATYPE(ContainerType)
+
+static void addLargeSizeRows()
+{
+    QTest::addColumn<ContainerType>("type");
+    QTest::addColumn<int>("size");
+
+    for (int size : { 1000, 10000, 100000 }) {
+        const QByteArray sizeString = QByteArray::number(size);
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+        QTest::newRow(QByteArray("flatmap--" + sizeString).constData()) << FlatMap << size;
+    }
+}
+
+static QList<int> shuffledKeys(int size)
+{
+    QList<int> keys(size);
+    std::iota(keys.begin(), keys.end(), 0);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(size));
+    return keys;
+}
+
 template <typename T>
 void testInsert(int size)
 {
@@ -52,30 +87,34 @@ void testInsert(int size)
 
 void tst_associative_containers::insert_data()
 {
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<ContainerType>("type");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+        QTest::newRow(QByteArray("flatmap--" + sizeString).constData()) << FlatMap << size;
     }
 }
 
 void tst_associative_containers::insert()
 {
-    QFETCH(bool, useHash);
+    QFETCH(ContainerType, type);
     QFETCH(int, size);
 
-    QHash<int, int> testHash;
-    QMap<int, int> testMap;
-
-    if (useHash) {
+    switch (type) {
+    case Hash:
         testInsert<QHash<int, int> >(size);
-    } else {
+        break;
+    case Map:
         testInsert<QMap<int, int> >(size);
+        break;
+    case FlatMap:
+        testInsert<QFlatMap<int, int> >(size);
+        break;
     }
 }
 
@@ -84,15 +123,16 @@ void tst_associative_containers::lookup_data()
 //    setReportType(LineChartReport);
 //    setChartTitle("Time to call value(), with an increasing number of items in the container");
 
-    QTest::addColumn<bool>("useHash");
+    QTest::addColumn<ContainerType>("type");
     QTest::addColumn<int>("size");
 
     for (int size = 10; size < 20000; size += 100) {
 
         const QByteArray sizeString = QByteArray::number(size);
 
-        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << true << size;
-        QTest::newRow(QByteArray("map--" + sizeString).constData()) << false << size;
+        QTest::newRow(QByteArray("hash--" + sizeString).constData()) << Hash << size;
+        QTest::newRow(QByteArray("map--" + sizeString).constData()) << Map << size;
+        QTest::newRow(QByteArray("flatmap--" + sizeString).constData()) << FlatMap << size;
     }
 }
 
@@ -115,14 +155,160 @@ void testLookup(int size)
 
 void tst_associative_containers::lookup()
 {
-    QFETCH(bool, useHash);
+    QFETCH(ContainerType, type);
     QFETCH(int, size);
 
-    if (useHash) {
+    switch (type) {
+    case Hash:
         testLookup<QHash<int, int> >(size);
-    } else {
+        break;
+    case Map:
         testLookup<QMap<int, int> >(size);
+        break;
+    case FlatMap:
+        testLookup<QFlatMap<int, int> >(size);
+        break;
+    }
+}
+
+void tst_associative_containers::bulkConstruction_data()
+{
+    addLargeSizeRows();
+}
+
+void tst_associative_containers::bulkConstruction()
+{
+    QFETCH(ContainerType, type);
+    QFETCH(int, size);
+
+    const QList<int> keys = shuffledKeys(size);
+
+    switch (type) {
+    case Hash:
+        QBENCHMARK {
+            QHash<int, int> container;
+            container.reserve(size);
+            for (int key : keys)
+                container.insert(key, key);
+        }
+        break;
+    case Map:
+        QBENCHMARK {
+            QMap<int, int> container;
+            for (int key : keys)
+                container.insert(key, key);
+        }
+        break;
+    case FlatMap:
+        QBENCHMARK {
+            QFlatMap<int, int> container(keys, keys);
+        }
+        break;
+    }
+}
+
+template <typename T>
+void testIterate(const T &container)
+{
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (auto it = container.begin(), end = container.end(); it != end; ++it)
+            sum += it.value();
+    }
+    QVERIFY(sum > 0);
+}
+
+void tst_associative_containers::iterate_data()
+{
+    addLargeSizeRows();
+}
+
+void tst_associative_containers::iterate()
+{
+    QFETCH(ContainerType, type);
+    QFETCH(int, size);
+
+    const QList<int> keys = shuffledKeys(size);
+
+    switch (type) {
+    case Hash: {
+        QHash<int, int> container;
+        for (int key : keys)
+            container.insert(key, key);
+        testIterate(container);
+        break;
+    }
+    case Map: {
+        QMap<int, int> container;
+        for (int key : keys)
+            container.insert(key, key);
+        testIterate(container);
+        break;
+    }
+    case FlatMap:
+        testIterate(QFlatMap<int, int>(keys, keys));
+        break;
+    }
+}
+
+void tst_associative_containers::stringLookup_data()
+{
+    addLargeSizeRows();
+}
+
+void tst_associative_containers::stringLookup()
+{
+    QFETCH(ContainerType, type);
+    QFETCH(int, size);
+
+    QStringList keys;
+    keys.reserve(size);
+    for (int key : shuffledKeys(size))
+        keys.append(QLatin1String("/route/") + QString::number(key));
+
+    // look the keys up through views into one buffer, as a parser would
+    const QString buffer = keys.join(QLatin1Char(' '));
+    QList<QStringView> views;
+    views.reserve(size);
+    qsizetype pos = 0;
+    for (const QString &key : qAsConst(keys)) {
+        views.append(QStringView(buffer).mid(pos, key.size()));
+        pos += key.size() + 1;
+    }
+
+    int found = 0;
+    switch (type) {
+    case Hash: {
+        QHash<QString, int> container;
+        for (const QString &key : qAsConst(keys))
+            container.insert(key, 1);
+        QBENCHMARK {
+            for (QStringView view : qAsConst(views))
+                found += container.value(view.toString());
+        }
+        break;
+    }
+    case Map: {
+        QMap<QString, int> container;
+        for (const QString &key : qAsConst(keys))
+            container.insert(key, 1);
+        QBENCHMARK {
+            for (QStringView view : qAsConst(views))
+                found += container.value(view.toString());
+        }
+        break;
+    }
+    case FlatMap: {
+        QList<int> values(size, 1);
+        QFlatMap<QString, int, QFlatMapStringLess> container(keys, values);
+        QBENCHMARK {
+            for (QStringView view : qAsConst(views))
+                found += container.value(view);
+        }
+        break;
+    }
     }
+    QVERIFY(found > 0);
 }
 
 QTEST_MAIN(tst_associative_containers)
@@ -0,0 +1,119 @@
+/****************************************************************************
+**
+** Copyright (C) 2020 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <private/qarenaallocator_p.h>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include <qtest.h>
+
+class tst_QArenaAllocator : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void request_data();
+    void request();
+    void requestAllocations();
+
+private:
+    QByteArray rawRequest;
+};
+
+void tst_QArenaAllocator::initTestCase()
+{
+    rawRequest = "GET /api/v1/items?filter=active&sort=name HTTP/1.1\r\n";
+    for (int i = 0; i < 40; ++i) {
+        rawRequest += "X-Header-" + QByteArray::number(i) + ": value-"
+                + QByteArray::number(i * 7919) + "\r\n";
+    }
+    rawRequest += "\r\n";
+}
+
+// Simulates the short-lived objects of one request: the header lines are
+// split, decoded to QString, stored in a hash and used to build a response.
+static qsizetype processRequest(const QByteArray &raw)
+{
+    QHash<QString, QString> headers;
+    const QList<QByteArray> lines = raw.split('\n');
+    for (const QByteArray &line : lines) {
+        const qsizetype colon = line.indexOf(':');
+        if (colon < 0)
+            continue;
+        headers.insert(QString::fromLatin1(line.left(colon)).toLower(),
+                       QString::fromLatin1(line.mid(colon + 1).trimmed()));
+    }
+
+    QStringList response;
+    for (auto it = headers.cbegin(); it != headers.cend(); ++it)
+        response.append(it.key() + QLatin1String(" = ") + it.value());
+    return response.join(QLatin1Char('\n')).size();
+}
+
+void tst_QArenaAllocator::request_data()
+{
+    QTest::addColumn<bool>("useArena");
+    QTest::newRow("heap") << false;
+    QTest::newRow("arena") << true;
+}
+
+void tst_QArenaAllocator::request()
+{
+    QFETCH(bool, useArena);
+
+    qsizetype total = 0;
+    if (useArena) {
+        QBENCHMARK {
+            QArenaScope scope;
+            total += processRequest(rawRequest);
+        }
+    } else {
+        QBENCHMARK {
+            total += processRequest(rawRequest);
+        }
+    }
+    QVERIFY(total > 0);
+}
+
+void tst_QArenaAllocator::requestAllocations()
+{
+    // Every block taken from the arena would have been a malloc() call
+    // without it; the arena itself only allocates its chunks.
+    QArenaScope scope;
+    QVERIFY(processRequest(rawRequest) > 0);
+    qDebug("%lld array allocations per request, served from %lld arena chunks (%lld bytes)",
+           qlonglong(scope.blockCount()), qlonglong(scope.chunkCount()),
+           qlonglong(scope.bytesAllocated()));
+    QTest::setBenchmarkResult(qreal(scope.blockCount() - scope.chunkCount()), QTest::Events);
+}
+
+QTEST_MAIN(tst_QArenaAllocator)
+
+#include "main.moc"
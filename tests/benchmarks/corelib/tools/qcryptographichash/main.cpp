@@ -31,6 +31,7 @@
 #include <QFile>
 #include <QRandomGenerator>
 #include <QString>
+#include <QTemporaryFile>
 #include <QtTest>
 
 #include <time.h>
@@ -50,6 +51,12 @@ private Q_SLOTS:
     void addData();
     void addDataChunked_data() { hash_data(); }
     void addDataChunked();
+    void throughput_data();
+    void throughput();
+    void hashFile_data() { throughput_data(); }
+    void hashFile();
+    void hashMany_data();
+    void hashMany();
 };
 
 const int MaxCryptoAlgorithm = QCryptographicHash::Sha3_512;
@@ -88,6 +95,24 @@ const char *algoname(int i)
         return "keccak_384-";
     case QCryptographicHash::Keccak_512:
         return "keccak_512-";
+    case QCryptographicHash::Blake2b_160:
+        return "blake2b_160-";
+    case QCryptographicHash::Blake2b_256:
+        return "blake2b_256-";
+    case QCryptographicHash::Blake2b_384:
+        return "blake2b_384-";
+    case QCryptographicHash::Blake2b_512:
+        return "blake2b_512-";
+    case QCryptographicHash::Blake2s_128:
+        return "blake2s_128-";
+    case QCryptographicHash::Blake2s_160:
+        return "blake2s_160-";
+    case QCryptographicHash::Blake2s_224:
+        return "blake2s_224-";
+    case QCryptographicHash::Blake2s_256:
+        return "blake2s_256-";
+    case QCryptographicHash::Blake3_256:
+        return "blake3_256-";
     }
     Q_UNREACHABLE();
     return 0;
@@ -167,6 +192,117 @@ void tst_bench_QCryptographicHash::addDataChunked()
     }
 }
 
+void tst_bench_QCryptographicHash::throughput_data()
+{
+    QTest::addColumn<int>("algorithm");
+
+    const QCryptographicHash::Algorithm algorithms[] = {
+        QCryptographicHash::Md5,
+        QCryptographicHash::Sha1,
+        QCryptographicHash::Sha224,
+        QCryptographicHash::Sha256,
+        QCryptographicHash::Sha512,
+        QCryptographicHash::Sha3_256,
+        QCryptographicHash::Blake2b_512,
+        QCryptographicHash::Blake2s_256,
+        QCryptographicHash::Blake3_256,
+    };
+    for (QCryptographicHash::Algorithm algo : algorithms)
+        QTest::newRow(QByteArray(algoname(algo)).chopped(1)) << int(algo);
+}
+
+// hashes 64 MiB of memory and reports the rate
+void tst_bench_QCryptographicHash::throughput()
+{
+    QFETCH(int, algorithm);
+
+    QByteArray data;
+    for (int i = 0; i < 1024; ++i)
+        data += blockOfData;
+
+    const QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    QCryptographicHash hash(algo);
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        hash.reset();
+        hash.addData(data);
+        hash.result();
+        bytes += data.size();
+    } while (timer.elapsed() < 1000);
+    QTest::setBenchmarkResult(bytes * 1e9 / timer.nsecsElapsed(), QTest::BytesPerSecond);
+}
+
+// hashes a 256 MiB file through QCryptographicHash::hashFile(), which hashes
+// BLAKE3 on all cores
+void tst_bench_QCryptographicHash::hashFile()
+{
+    QFETCH(int, algorithm);
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    for (int i = 0; i < 4096; ++i)
+        QCOMPARE(file.write(blockOfData), qint64(MaxBlockSize));
+    QVERIFY(file.flush());
+
+    const QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        QVERIFY(file.seek(0));
+        QCOMPARE(QCryptographicHash::hashFile(&file, algo).size(),
+                 QCryptographicHash::hashLength(algo));
+        bytes += file.size();
+    } while (timer.elapsed() < 1000);
+    QTest::setBenchmarkResult(bytes * 1e9 / timer.nsecsElapsed(), QTest::BytesPerSecond);
+}
+
+void tst_bench_QCryptographicHash::hashMany_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("messageSize");
+    QTest::addColumn<bool>("batched");
+
+    for (QCryptographicHash::Algorithm algo : { QCryptographicHash::Sha1, QCryptographicHash::Sha256 }) {
+        const QByteArray name = QByteArray(algoname(algo)).chopped(1);
+        for (int size : { 64, 1024 }) {
+            QTest::addRow("%s-%d-loop", name.constData(), size) << int(algo) << size << false;
+            QTest::addRow("%s-%d-batched", name.constData(), size) << int(algo) << size << true;
+        }
+    }
+}
+
+// hashes 4096 independent messages, either one by one through hash() or
+// all at once through hashMany(), and reports the rate
+void tst_bench_QCryptographicHash::hashMany()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, messageSize);
+    QFETCH(bool, batched);
+
+    QList<QByteArrayView> messages;
+    for (int i = 0; i < 4096; ++i)
+        messages.append(QByteArrayView(blockOfData.constData() + i * 8, messageSize));
+
+    const QCryptographicHash::Algorithm algo = QCryptographicHash::Algorithm(algorithm);
+    qint64 bytes = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        if (batched) {
+            QCOMPARE(QCryptographicHash::hashMany(messages, algo).size(), messages.size());
+        } else {
+            for (QByteArrayView message : messages)
+                QCryptographicHash::hash(QByteArray::fromRawData(message.data(), message.size()),
+                                         algo);
+        }
+        bytes += qint64(messages.size()) * messageSize;
+    } while (timer.elapsed() < 1000);
+    QTest::setBenchmarkResult(bytes * 1e9 / timer.nsecsElapsed(), QTest::BytesPerSecond);
+}
+
 QTEST_APPLESS_MAIN(tst_bench_QCryptographicHash)
 
 #include "main.moc"
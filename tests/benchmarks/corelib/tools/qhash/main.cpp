@@ -52,6 +52,11 @@ private slots:
     void qhash_javaString_data() { data(); }
     void qhash_javaString() { qhash_template<JavaString>(); }
 
+    void lookup_current_data() { data(); }
+    void lookup_current() { lookup_template<QString>(); }
+    void lookupMiss_current_data() { data(); }
+    void lookupMiss_current() { lookupMiss_template<QString>(); }
+
     void hashing_current_data() { data(); }
     void hashing_current() { hashing_template<QString>(); }
     void hashing_qt50_data() { data(); }
@@ -65,6 +70,8 @@ private:
     void data();
     template <typename String> void qhash_template();
     template <typename String> void hashing_template();
+    template <typename String> void lookup_template();
+    template <typename String> void lookupMiss_template();
 
     QStringList smallFilePaths;
     QStringList uuids;
@@ -152,6 +159,45 @@ template <typename String> void tst_QHash::qhash_template()
     }
 }
 
+template <typename String> void tst_QHash::lookup_template()
+{
+    QFETCH(QStringList, items);
+    QHash<String, int> hash;
+
+    QList<String> realitems;
+    foreach (const QString &s, items)
+        realitems.append(s);
+    for (int i = 0, n = realitems.size(); i != n; ++i)
+        hash[realitems.at(i)] = i;
+
+    int sum = 0;
+    QBENCHMARK {
+        for (int i = 0, n = realitems.size(); i != n; ++i)
+            sum += hash.value(realitems.at(i));
+    }
+    QVERIFY(sum != -1);
+}
+
+template <typename String> void tst_QHash::lookupMiss_template()
+{
+    // half of the items are in the hash, look up the other half
+    QFETCH(QStringList, items);
+    QHash<String, int> hash;
+
+    QList<String> realitems;
+    foreach (const QString &s, items)
+        realitems.append(s);
+    for (int i = 0, n = realitems.size(); i < n; i += 2)
+        hash[realitems.at(i)] = i;
+
+    int found = 0;
+    QBENCHMARK {
+        for (int i = 1, n = realitems.size(); i < n; i += 2)
+            found += hash.contains(realitems.at(i));
+    }
+    QVERIFY(found >= 0);
+}
+
 template <typename String> void tst_QHash::hashing_template()
 {
     // just the hashing function
@@ -2,6 +2,7 @@ TEMPLATE = subdirs
 SUBDIRS = \
         containers-associative \
         containers-sequential \
+        qarenaallocator \
         qcontiguouscache \
         qcryptographichash \
         qlist \
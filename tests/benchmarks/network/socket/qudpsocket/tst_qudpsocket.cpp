@@ -41,6 +41,8 @@ public:
 private slots:
     void pendingDatagramSize_data();
     void pendingDatagramSize();
+    void loopbackThroughput_data();
+    void loopbackThroughput();
 };
 
 tst_QUdpSocket::tst_QUdpSocket()
@@ -76,5 +78,54 @@ void tst_QUdpSocket::pendingDatagramSize()
     }
 }
 
+void tst_QUdpSocket::loopbackThroughput_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<int>("batchSize");
+    for (int size : {64, 512, 1400}) {
+        for (int batchSize : {1, 8, 64})
+            QTest::addRow("%d bytes, batches of %d", size, batchSize) << size << batchSize;
+    }
+}
+
+void tst_QUdpSocket::loopbackThroughput()
+{
+    QFETCH(int, size);
+    QFETCH(int, batchSize);
+    // small enough to fit into the default receive buffer, so nothing is dropped
+    const int datagramCount = 64;
+
+    QUdpSocket receiver;
+    QVERIFY(receiver.bind(QHostAddress::LocalHost));
+    QUdpSocket sender;
+
+    QList<QNetworkDatagram> datagrams;
+    for (int i = 0; i < datagramCount; ++i)
+        datagrams.append(QNetworkDatagram(QByteArray(size, 'a'), QHostAddress::LocalHost,
+                                          receiver.localPort()));
+
+    QBENCHMARK {
+        // batch size 1 goes through the single-datagram API
+        for (int i = 0; i < datagramCount; i += batchSize) {
+            if (batchSize == 1)
+                QCOMPARE(sender.writeDatagram(datagrams.at(i)), qint64(size));
+            else
+                QCOMPARE(sender.writeDatagrams(datagrams.mid(i, batchSize)), batchSize);
+        }
+
+        int received = 0;
+        while (received < datagramCount) {
+            if (!receiver.hasPendingDatagrams())
+                QVERIFY2(receiver.waitForReadyRead(5000), "Datagrams were lost");
+            if (batchSize == 1) {
+                QCOMPARE(receiver.receiveDatagram(size).data().size(), size);
+                ++received;
+            } else {
+                received += receiver.receiveDatagrams(batchSize, size).size();
+            }
+        }
+    }
+}
+
 QTEST_MAIN(tst_QUdpSocket)
 #include "tst_qudpsocket.moc"